@@ -453,7 +453,15 @@ public:
     std::vector<double> ComputeDouble(const std::vector<double>& inputData);
     std::vector<float> ComputeFloat(const std::vector<float>& inputData);
 
+    // Compute a batch of inputs stored one after another with one call, for maps compiled with `emitBatchPredict`.
+    // Returns the outputs stored one after another.
+    std::vector<double> ComputeDoubleBatch(const std::vector<double>& inputData);
+    std::vector<float> ComputeFloatBatch(const std::vector<float>& inputData);
+
 private:
+    template <typename ElementType>
+    std::vector<ElementType> ComputeBatch(const std::vector<ElementType>& inputData);
+
     template <typename ElementType>
     ell::api::CallbackForwarder<ElementType, ElementType>& GetCallbackForwarder();
 
@@ -479,6 +487,8 @@ struct MapCompilerOptions
 {
     bool useBlas = true;
     bool profile = false;
+    std::string objectCacheDirectory = ""; // if non-empty, JIT-compiled code is cached here and reused by later processes
+    bool emitBatchPredict = false; // also compile a batch entry point, for CompiledMap::ComputeFloatBatch and ComputeDoubleBatch
 };
 
 //
@@ -487,6 +497,8 @@ struct MapCompilerOptions
 struct ModelOptimizerOptions
 {
     bool fuseLinearFunctionNodes = true;
+    bool foldLayerOperations = true;
+    bool fuseElementwiseOperations = true;
 };
 
 } // namespace ELL_API
@@ -789,7 +789,11 @@ CompiledMap Map::Compile(const std::string& targetDevice,
     settings.sinkFunctionName = sinkFunctionName;
     settings.compilerSettings.targetDevice.deviceName = targetDevice;
     settings.compilerSettings.useBlas = compilerSettings.useBlas;
+    settings.objectCacheDirectory = compilerSettings.objectCacheDirectory;
+    settings.emitBatchPredict = compilerSettings.emitBatchPredict;
     settings.optimizerSettings.fuseLinearFunctionNodes = optimizerSettings.fuseLinearFunctionNodes;
+    settings.optimizerSettings.foldLayerOperations = optimizerSettings.foldLayerOperations;
+    settings.optimizerSettings.fuseElementwiseOperations = optimizerSettings.fuseElementwiseOperations;
 
     ell::model::IRMapCompiler compiler(settings);
 
@@ -857,6 +861,35 @@ std::vector<float> CompiledMap::ComputeFloat(const std::vector<float>& inputData
     return {};
 }
 
+std::vector<double> CompiledMap::ComputeDoubleBatch(const std::vector<double>& inputData)
+{
+    return ComputeBatch(inputData);
+}
+
+std::vector<float> CompiledMap::ComputeFloatBatch(const std::vector<float>& inputData)
+{
+    return ComputeBatch(inputData);
+}
+
+template <typename ElementType>
+std::vector<ElementType> CompiledMap::ComputeBatch(const std::vector<ElementType>& inputData)
+{
+    if (_map == nullptr)
+    {
+        return {};
+    }
+
+    auto inputSize = _map->GetInputSize(0);
+    if (inputSize == 0 || inputData.size() % inputSize != 0)
+    {
+        throw ell::utilities::InputException(ell::utilities::InputExceptionErrors::sizeMismatch, "Batch input size must be a multiple of the map's input size");
+    }
+    auto count = inputData.size() / inputSize;
+    std::vector<ElementType> outputData(count * _map->GetOutputSize(0));
+    _map->ComputeBatch(count, inputData.data(), outputData.data());
+    return outputData;
+}
+
 void CompiledMap::WriteIR(const std::string& filePath)
 {
     if (_map != nullptr)
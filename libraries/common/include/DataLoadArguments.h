@@ -26,6 +26,9 @@ namespace common
         /// <summary> The number of elements in an input data vector. </summary>
         std::string dataDimension = "";
 
+        /// <summary> The filename for a binary cache of the parsed input data. </summary>
+        std::string dataCacheFilename = "";
+
         // not exposed on the command line
         size_t parsedDataDimension = 0;
     };
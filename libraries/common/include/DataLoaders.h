@@ -12,6 +12,7 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/ExampleIterator.h>
+#include <data/include/PackedDataset.h>
 
 #include <model/include/Map.h>
 
@@ -47,19 +48,32 @@ namespace common
     /// <returns> The data iterator. </returns>
     data::AutoSupervisedMultiClassExampleIterator GetAutoSupervisedMultiClassExampleIterator(std::istream& stream);
 
-    /// <summary> Gets an AutoSupervisedDataset dataset from data load arguments. </summary>
+    /// <summary> Gets an AutoSupervisedDataset dataset from an input stream, parsing it on several threads. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse with, or 0 for one per hardware thread. </param>
     ///
     /// <returns> The dataset. </returns>
-    data::AutoSupervisedDataset GetDataset(std::istream& stream);
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads = 0);
 
-    /// <summary> Gets a dataset from data load arguments. </summary>
+    /// <summary>
+    /// Gets a PackedDataset from data load arguments. The data is read from a binary dataset cache (either the input
+    /// data file itself, or an existing data cache file) when there is one, and is parsed otherwise. If a data cache
+    /// file is given but doesn't exist yet, the parsed dataset is written to it.
+    /// </summary>
+    ///
+    /// <param name="dataLoadArguments"> The data load arguments. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::PackedDataset GetDataset(const DataLoadArguments& dataLoadArguments);
+
+    /// <summary> Gets an AutoSupervisedMultiClassDataset dataset from an input stream, parsing it on several threads. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse with, or 0 for one per hardware thread. </param>
     ///
     /// <returns> The dataset. </returns>
-    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream);
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads = 0);
 
     /// <summary>
     /// Gets a new dataset by running an existing dataset through a map.
@@ -74,9 +88,23 @@ namespace common
     template <typename ExampleType, typename MapType>
     auto TransformDataset(data::Dataset<ExampleType>& input, const MapType& map);
 
+    /// <summary>
+    /// Gets a new packed dataset by running a packed dataset through a map. The examples are read in place, without
+    /// first being copied out of the packed dataset.
+    /// </summary>
+    ///
+    /// <typeparam name="MapType"> Map type. </typeparam>
+    /// <param name="input"> Input dataset. </param>
+    /// <param name="map"> Map to run input dataset on. </param>
+    ///
+    /// <returns> The transformed dataset. </returns>
+    template <typename MapType>
+    data::PackedDataset TransformDataset(const data::PackedDataset& input, const MapType& map);
+
     /// <summary>
     /// The map is first compiled, then a new dataset is returned
-    /// by running an existing dataset through the compiled map.
+    /// by running an existing dataset through the compiled map. The examples are passed
+    /// to the compiled batch predict function `batchSize` at a time.
     /// </summary>
     ///
     /// <typeparam name="ExampleType"> Example type. </typeparam>
@@ -84,10 +112,11 @@ namespace common
     /// <param name="input"> Input dataset. </param>
     /// <param name="map"> Map to run input dataset on. </param>
     /// <param name="useBlas"> Use BLAS in the emitted code to speed up linear algerbra operations. </param>
+    /// <param name="batchSize"> The number of examples computed by each call into the compiled map. </param>
     ///
     /// <returns> The transformed dataset. </returns>
     template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true);
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true, size_t batchSize = 64);
 } // namespace common
 } // namespace ell
 
@@ -100,6 +129,9 @@ namespace common
 
 #include <nodes/include/ClockNode.h> // for nodes::TimeTickType
 
+#include <algorithm>
+#include <vector>
+
 namespace ell
 {
 namespace common
@@ -125,12 +157,25 @@ namespace common
         });
     }
 
+    template <typename MapType>
+    data::PackedDataset TransformDataset(const data::PackedDataset& input, const MapType& map)
+    {
+        data::PackedDataset result;
+        for (size_t index = 0; index < input.NumExamples(); ++index)
+        {
+            auto transformedDataVector = map.template Compute<data::DoubleDataVector>(input.GetDataVector(index));
+            result.AddExample(data::Example<data::DoubleDataVector, data::WeightLabel>(std::move(transformedDataVector), input.GetMetadata(index)));
+        }
+        return result;
+    }
+
     namespace detail
     {
-        // Context used by callback functions
+        // Context used by callback functions: holds one input per predict call in a batch, handed out in order
         struct CallbackContext
         {
-            std::vector<double> inputValues;
+            std::vector<std::vector<double>> inputValues;
+            size_t nextInput = 0;
         };
     } // namespace detail
 
@@ -139,14 +184,16 @@ namespace common
     inline bool InputCallback_Double(void* context, double* input)
     {
         auto dataContext = static_cast<detail::CallbackContext*>(context);
-        std::copy(dataContext->inputValues.begin(), dataContext->inputValues.end(), input);
+        const auto& inputValues = dataContext->inputValues[dataContext->nextInput++];
+        std::copy(inputValues.begin(), inputValues.end(), input);
         return true;
     }
 
     inline bool InputCallback_Float(void* context, float* input)
     {
         auto dataContext = static_cast<detail::CallbackContext*>(context);
-        std::transform(dataContext->inputValues.begin(), dataContext->inputValues.end(), input, [](double val) { return static_cast<float>(val); });
+        const auto& inputValues = dataContext->inputValues[dataContext->nextInput++];
+        std::transform(inputValues.begin(), inputValues.end(), input, [](double val) { return static_cast<float>(val); });
         return true;
     }
     }
@@ -183,11 +230,51 @@ namespace common
         }
     } // namespace detail
 
+    namespace detail
+    {
+        // Runs the dataset through a compiled map with a source node, `batchSize` examples per call
+        template <typename OutputType, typename ExampleType>
+        data::Dataset<ExampleType> TransformDatasetInBatches(data::Dataset<ExampleType>& input, const model::IRCompiledMap& compiledMap, CallbackContext& dataContext, size_t batchSize)
+        {
+            // Compiled maps receive the current time as the parameter input, and values through the input callback
+            auto inputSize = compiledMap.GetInputSize(0);
+            auto outputSize = compiledMap.GetOutputSize(0);
+            std::vector<nodes::TimeTickType> times;
+            std::vector<OutputType> outputs;
+
+            data::Dataset<ExampleType> result;
+            auto numExamples = input.NumExamples();
+            for (size_t batchBegin = 0; batchBegin < numExamples; batchBegin += batchSize)
+            {
+                auto count = std::min(batchSize, numExamples - batchBegin);
+                dataContext.inputValues.resize(count);
+                dataContext.nextInput = 0;
+                for (size_t index = 0; index < count; ++index)
+                {
+                    dataContext.inputValues[index] = input[batchBegin + index].GetDataVector().ToArray();
+                }
+
+                times.assign(count * inputSize, 0 /*currentTime*/);
+                outputs.resize(count * outputSize);
+                compiledMap.ComputeBatch(count, times.data(), outputs.data());
+
+                for (size_t index = 0; index < count; ++index)
+                {
+                    std::vector<OutputType> exampleOutput(outputs.begin() + index * outputSize, outputs.begin() + (index + 1) * outputSize);
+                    auto outputIterator = data::MakeVectorIndexValueIterator<data::IterationPolicy::skipZeros>(exampleOutput);
+                    result.AddExample(ExampleType(typename ExampleType::DataVectorType(outputIterator), input[batchBegin + index].GetMetadata()));
+                }
+            }
+            return result;
+        }
+    } // namespace detail
+
     template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas)
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas, size_t batchSize)
     {
         ell::model::MapCompilerOptions settings;
         settings.compilerSettings.useBlas = useBlas;
+        settings.emitBatchPredict = true;
 
         detail::CallbackContext dataContext;
         model::IRMapCompiler compiler(settings);
@@ -195,17 +282,18 @@ namespace common
         auto module = compiler.GetModule().GetLLVMModule();
         auto compiledMap = compiler.Compile(map);
         compiledMap.SetContext(&dataContext);
-
-        // Unlike reference maps, compiled maps receive the current time as the parameter input and
-        // values through the input callback.
         detail::ResolveInputCallback(map, module, compiledMap.GetJitter());
 
-        return input.template Transform<ExampleType>([&compiledMap, &dataContext](const ExampleType& example) {
-            dataContext.inputValues = example.GetDataVector().ToArray();
-            compiledMap.SetInputValue(0, std::vector<nodes::TimeTickType>({ 0 /*currentTime*/ }));
-            auto transformedDataVector = compiledMap.template ComputeOutput<typename ExampleType::DataVectorType>(0);
-            return ExampleType(std::move(transformedDataVector), example.GetMetadata());
-        });
+        batchSize = std::max(batchSize, size_t{ 1 });
+        switch (compiledMap.GetOutput(0).GetPortType())
+        {
+        case model::Port::PortType::smallReal:
+            return detail::TransformDatasetInBatches<float>(input, compiledMap, dataContext, batchSize);
+        case model::Port::PortType::real:
+            return detail::TransformDatasetInBatches<double>(input, compiledMap, dataContext, batchSize);
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Compiled map output must be float or double");
+        }
     }
 } // namespace common
 } // namespace ell
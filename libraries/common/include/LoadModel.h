@@ -13,17 +13,22 @@
 #include <model/include/Map.h>
 #include <model/include/Model.h>
 
+#include <utility>
+
 namespace ell
 {
 namespace common
 {
-    /// <summary> Loads a model from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary>
+    /// Loads a model from a file, or creates a new one if given an empty filename. The file can be in
+    /// the JSON or the binary archive format, which is detected from its contents.
+    /// </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded model. </returns>
     model::Model LoadModel(const std::string& filename);
 
-    /// <summary> Saves a model to a file. </summary>
+    /// <summary> Saves a model to a file, in the binary archive format if the file has the .ellb extension, and as JSON otherwise. </summary>
     ///
     /// <param name="model"> The model. </param>
     /// <param name="filename"> The filename. </param>
@@ -45,7 +50,10 @@ namespace common
     /// <param name="context"> The `SerializationContext` </param>
     void RegisterMapTypes(utilities::SerializationContext& context);
 
-    /// <summary> Loads a map from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary>
+    /// Loads a map from a file, or creates a new one if given an empty filename. The file can be in
+    /// the JSON or the binary archive format, which is detected from its contents.
+    /// </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded map. </returns>
@@ -57,7 +65,7 @@ namespace common
     /// <returns> The loaded map. </returns>
     model::Map LoadMap(const MapLoadArguments& mapLoadArguments);
 
-    /// <summary> Saves a map to a file. </summary>
+    /// <summary> Saves a map to a file, in the binary archive format if the file has the .ellb extension, and as JSON otherwise. </summary>
     ///
     /// <param name="map"> The map. </param>
     /// <param name="filename"> The filename. </param>
@@ -83,15 +91,15 @@ namespace ell
 namespace common
 {
     // STYLE internal use only from implementation, so not declared in main part of header file
-    template <typename UnarchiverType>
-    model::Map LoadArchivedMap(std::istream& stream)
+    template <typename UnarchiverType, typename... UnarchiverArgs>
+    model::Map LoadArchivedMap(UnarchiverArgs&&... unarchiverArgs)
     {
         try
         {
             utilities::SerializationContext context;
             RegisterNodeTypes(context);
             RegisterMapTypes(context);
-            UnarchiverType unarchiver(stream, context);
+            UnarchiverType unarchiver(std::forward<UnarchiverArgs>(unarchiverArgs)..., context);
             model::Map map;
             unarchiver.Unarchive(map);
             return map;
@@ -30,23 +30,31 @@ namespace common
     struct MapCompilerArguments
     {
         using PreferredConvolutionMethod = model::PreferredConvolutionMethod;
+        using ForestCompilationMethod = model::ForestCompilationMethod;
 
         std::string compiledFunctionName; // defaults to output filename
         std::string compiledModuleName;
 
         // ELL codegen options
         bool profile = false;
+        bool trace = false;
         bool optimize = true;
         bool useBlas = false;
         bool fuseLinearOperations = true;
+        bool foldLayerOperations = true;
+        bool fuseElementwiseOperations = true;
         bool optimizeReorderDataNodes = true;
         bool enableVectorization = true;
         int vectorWidth = 4;
         bool parallelize = true;
         bool useThreadPool = true;
-        int maxThreads = 4;
+        int maxThreads = 0;
         bool debug = false;
-        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd
+        bool sharePortMemory = false;
+        bool reentrant = false;
+        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd, autotune
+        std::string convolutionTuningDatabase = "";
+        ForestCompilationMethod forestMethod = ForestCompilationMethod::refine; // known methods: refine, traversal, bitvector
         utilities::Optional<bool> positionIndependentCode = false; // for generating -fPIC object code
 
         // target machine options
@@ -35,6 +35,13 @@ namespace common
             "dd",
             "Number of elements to read from each data vector",
             "");
+
+        parser.AddOption(
+            dataCacheFilename,
+            "dataCacheFilename",
+            "dcf",
+            "Path to a binary cache of the parsed input data. If the file exists it is loaded instead of parsing the input data file, otherwise it is written after parsing",
+            "");
     }
 
     utilities::CommandLineParseResult ParsedDataLoadArguments::PostProcess(const utilities::CommandLineParser& parser)
@@ -8,16 +8,21 @@
 
 #include "DataLoaders.h"
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
 
 #include <data/include/Dataset.h>
 #include <data/include/SequentialLineIterator.h>
 
 #include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDatasetCache.h>
 #include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/PackedDataset.h>
+#include <data/include/ParallelDatasetParser.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 #include <data/include/WeightLabel.h>
 
+#include <cstdio>
 #include <memory>
 #include <stdexcept>
 
@@ -36,14 +41,67 @@ namespace common
         return GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream);
     }
 
-    data::AutoSupervisedDataset GetDataset(std::istream& stream)
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads)
     {
-        return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
+        return data::ParseDatasetInParallel<data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream, numThreads);
     }
 
-    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream)
+    data::PackedDataset GetDataset(const DataLoadArguments& dataLoadArguments)
     {
-        return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
+        const auto& inputFilename = dataLoadArguments.inputDataFilename;
+        if (data::BinaryDatasetCache::IsBinaryDatasetCache(inputFilename))
+        {
+            data::BinaryDatasetCache cache(inputFilename);
+            return data::PackedDataset(cache.GetExampleIterator());
+        }
+
+        // A cache is only used if it was written from the input file as it is now. One that is stale, from an older
+        // version, or otherwise unreadable is replaced.
+        const auto& cacheFilename = dataLoadArguments.dataCacheFilename;
+        if (!cacheFilename.empty() && data::BinaryDatasetCache::IsBinaryDatasetCache(cacheFilename))
+        {
+            try
+            {
+                data::BinaryDatasetCache cache(cacheFilename);
+                if (cache.IsCacheOf(inputFilename))
+                {
+                    return data::PackedDataset(cache.GetExampleIterator());
+                }
+            }
+            catch (const utilities::DataFormatException&)
+            {
+            }
+        }
+
+        auto stream = utilities::OpenIfstream(inputFilename);
+        auto dataset = GetDataset(stream);
+        if (!cacheFilename.empty())
+        {
+            // Written to a temporary file first, so an interrupted write doesn't leave a truncated cache behind
+            auto tempFilename = utilities::GetTemporaryFilePath(cacheFilename);
+            try
+            {
+                {
+                    auto cacheStream = utilities::OpenBinaryOfstream(tempFilename);
+                    data::BinaryDatasetCache::Write(dataset, cacheStream, inputFilename);
+                }
+                if (!utilities::ReplaceFile(tempFilename, cacheFilename))
+                {
+                    throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Couldn't write the dataset cache " + cacheFilename);
+                }
+            }
+            catch (...)
+            {
+                std::remove(tempFilename.c_str());
+                throw;
+            }
+        }
+        return data::PackedDataset(dataset.GetAnyDataset());
+    }
+
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads)
+    {
+        return data::ParseDatasetInParallel<data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream, numThreads);
     }
 } // namespace common
 } // namespace ell
@@ -55,6 +55,12 @@ namespace common
                          "st",
                          "Use the sorting trainer instead of the histogram trainer",
                          false);
+
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads to train with, or 0 for one per hardware thread",
+                         1);
     }
 } // namespace common
 } // namespace ell
@@ -39,12 +39,15 @@
 #include <nodes/include/LSTMNode.h>
 #include <nodes/include/LinearPredictorNode.h>
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
 #include <nodes/include/MatrixVectorProductNode.h>
 #include <nodes/include/MovingAverageNode.h>
 #include <nodes/include/MovingVarianceNode.h>
 #include <nodes/include/MultiplexerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorMultiplyNode.h>
 #include <nodes/include/RNNNode.h>
 #include <nodes/include/ReceptiveFieldMatrixNode.h>
 #include <nodes/include/ReorderDataNode.h>
@@ -69,8 +72,10 @@
 #include <predictors/neural/include/TanhActivation.h>
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MemoryMappedFile.h>
 
 #include <cstdint>
 
@@ -99,6 +104,9 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::ReLUActivationFunction<ElementType>>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::SigmoidActivationFunction<ElementType>>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearFunctionNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearActivationFunctionNode<ElementType, nodes::HardSigmoidActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearActivationFunctionNode<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearActivationFunctionNode<ElementType, nodes::ReLUActivationFunction<ElementType>>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BufferNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ConcatenationNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ConstantNode<ElementType>>();
@@ -118,9 +126,12 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::rowMajor>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::columnMajor>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MatrixMatrixMultiplyNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorMultiplyNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedMatrixVectorMultiplyNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::RNNNode<ElementType>>();
@@ -270,12 +281,12 @@ namespace common
         context.GetTypeFactory().AddType<model::Map, model::Map>();
     }
 
-    template <typename UnarchiverType>
-    model::Model LoadArchivedModel(std::istream& stream)
+    template <typename UnarchiverType, typename... UnarchiverArgs>
+    model::Model LoadArchivedModel(UnarchiverArgs&&... unarchiverArgs)
     {
         utilities::SerializationContext context;
         RegisterNodeTypes(context);
-        UnarchiverType unarchiver(stream, context);
+        UnarchiverType unarchiver(std::forward<UnarchiverArgs>(unarchiverArgs)..., context);
         model::Model model;
         unarchiver.Unarchive(model);
         return model;
@@ -288,6 +299,24 @@ namespace common
         archiver.Archive(obj);
     }
 
+    namespace
+    {
+        // files with the .ellb extension are saved in the binary archive format
+        bool IsBinaryArchiveFilename(const std::string& filename)
+        {
+            return utilities::GetFileExtension(filename, true) == "ellb";
+        }
+
+        // files are loaded according to their contents, whatever their extension
+        bool IsBinaryArchiveFile(const std::string& filename)
+        {
+            auto filestream = utilities::OpenBinaryIfstream(filename);
+            char header[16] = {};
+            filestream.read(header, sizeof(header));
+            return utilities::BinaryUnarchiver::IsBinaryArchive(header, static_cast<size_t>(filestream.gcount()));
+        }
+    } // namespace
+
     model::Model LoadModel(const std::string& filename)
     {
         if (!utilities::IsFileReadable(filename))
@@ -295,6 +324,12 @@ namespace common
             throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound);
         }
 
+        if (IsBinaryArchiveFile(filename))
+        {
+            utilities::MemoryMappedFile file(filename);
+            return LoadArchivedModel<utilities::BinaryUnarchiver>(file.GetData(), file.Size());
+        }
+
         auto filestream = utilities::OpenIfstream(filename);
         return LoadArchivedModel<utilities::JsonUnarchiver>(filestream);
     }
@@ -305,6 +340,14 @@ namespace common
         {
             throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable);
         }
+
+        if (IsBinaryArchiveFilename(filename))
+        {
+            auto filestream = utilities::OpenBinaryOfstream(filename);
+            SaveArchivedObject<utilities::BinaryArchiver>(model, filestream);
+            return;
+        }
+
         auto filestream = utilities::OpenOfstream(filename);
         SaveModel(model, filestream);
     }
@@ -392,6 +435,12 @@ namespace common
             throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound);
         }
 
+        if (IsBinaryArchiveFile(filename))
+        {
+            utilities::MemoryMappedFile file(filename);
+            return LoadArchivedMap<utilities::BinaryUnarchiver>(file.GetData(), file.Size());
+        }
+
         auto filestream = utilities::OpenIfstream(filename);
         return LoadArchivedMap<utilities::JsonUnarchiver>(filestream);
     }
@@ -402,6 +451,14 @@ namespace common
         {
             throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable);
         }
+
+        if (IsBinaryArchiveFilename(filename))
+        {
+            auto filestream = utilities::OpenBinaryOfstream(filename);
+            SaveArchivedObject<utilities::BinaryArchiver>(map, filestream);
+            return;
+        }
+
         auto filestream = utilities::OpenOfstream(filename);
         SaveMap(map, filestream);
     }
@@ -36,6 +36,13 @@ namespace common
             "Emit profiling code",
             false);
 
+        parser.AddOption(
+            trace,
+            "trace",
+            "",
+            "Emit code that records a trace of node, task and profile region execution times",
+            false);
+
         parser.AddOption(
             optimize,
             "optimize",
@@ -57,6 +64,20 @@ namespace common
             "Fuse sequences of linear operations with constant coefficients into a single operation",
             true);
 
+        parser.AddOption(
+            foldLayerOperations,
+            "foldLayerOps",
+            "",
+            "Fold scaling into convolutional and fully-connected weights, and fuse activations into the operation before them",
+            true);
+
+        parser.AddOption(
+            fuseElementwiseOperations,
+            "fuseElementwiseOps",
+            "",
+            "Compute chains of elementwise operations with the same memory layout in a single loop",
+            true);
+
         parser.AddOption(
             optimizeReorderDataNodes,
             "optimizeReorderDataNodes",
@@ -73,9 +94,27 @@ namespace common
               { "simple", PreferredConvolutionMethod::simple },
               { "diagonal", PreferredConvolutionMethod::diagonal },
               { "winograd", PreferredConvolutionMethod::winograd },
-              { "auto", PreferredConvolutionMethod::automatic } },
+              { "auto", PreferredConvolutionMethod::automatic },
+              { "autotune", PreferredConvolutionMethod::autotune } },
             "auto");
 
+        parser.AddOption(
+            convolutionTuningDatabase,
+            "convolutionTuningDatabase",
+            "",
+            "File to keep the measurements of convolutionMethod=autotune in, so later compiles for the same layer shapes and target reuse them",
+            "");
+
+        parser.AddOption(
+            forestMethod,
+            "forestMethod",
+            "",
+            "Set how forest predictors are compiled",
+            { { "refine", ForestCompilationMethod::refine },
+              { "traversal", ForestCompilationMethod::traversal },
+              { "bitvector", ForestCompilationMethod::bitvector } },
+            "refine");
+
         parser.AddOption(
             enableVectorization,
             "vectorize",
@@ -108,8 +147,8 @@ namespace common
             maxThreads,
             "threads",
             "th",
-            "Maximum num of parallel threads",
-            4);
+            "Maximum num of parallel threads (0 means one per hardware thread on the host)",
+            0);
 
         parser.AddOption(
             debug,
@@ -118,6 +157,20 @@ namespace common
             "Emit debug code",
             false);
 
+        parser.AddOption(
+            sharePortMemory,
+            "sharePortMemory",
+            "spm",
+            "Share storage between intermediate port variables whose lifetimes don't overlap",
+            false);
+
+        parser.AddOption(
+            reentrant,
+            "reentrant",
+            "",
+            "Keep all mutable model state in a caller-allocated state struct, so one module can run several independent streams",
+            false);
+
         parser.AddDocumentationString("");
         parser.AddDocumentationString("Target device options");
         parser.AddOption(
@@ -210,10 +263,17 @@ namespace common
         settings.compilerSettings.parallelize = parallelize;
         settings.compilerSettings.vectorWidth = vectorWidth;
         settings.optimizerSettings.fuseLinearFunctionNodes = fuseLinearOperations;
+        settings.optimizerSettings.foldLayerOperations = foldLayerOperations;
+        settings.optimizerSettings.fuseElementwiseOperations = fuseElementwiseOperations;
         settings.optimizerSettings.optimizeReorderDataNodes = optimizeReorderDataNodes;
         settings.optimizerSettings.preferredConvolutionMethod = convolutionMethod;
+        settings.optimizerSettings.convolutionTuningDatabase = convolutionTuningDatabase;
+        settings.sharePortMemory = sharePortMemory;
+        settings.reentrant = reentrant;
+        settings.forestMethod = forestMethod;
         settings.profile = profile;
         settings.compilerSettings.profile = profile;
+        settings.compilerSettings.trace = trace;
         settings.compilerSettings.positionIndependentCode = positionIndependentCode;
 
         if (target != "")
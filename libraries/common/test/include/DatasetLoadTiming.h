@@ -0,0 +1,17 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DatasetLoadTiming.h (common_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary> Times loading a sparse text dataset sequentially, in parallel with different numbers of threads, and from a binary dataset cache. </summary>
+///
+/// <param name="numExamples"> The number of examples in the dataset. </param>
+/// <param name="numNonZeros"> The number of nonzero entries in each example. </param>
+void TimeDatasetLoading(size_t numExamples, size_t numNonZeros);
@@ -8,5 +8,7 @@
 namespace ell
 {
 void TestLoadDataset(const std::string& examplePath);
+void TestLoadDatasetInParallel(const std::string& examplePath);
+void TestDatasetCache(const std::string& examplePath);
 void TestLoadMappedDataset(const std::string& examplePath);
 } // namespace ell
\ No newline at end of file
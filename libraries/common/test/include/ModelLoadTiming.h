@@ -0,0 +1,17 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ModelLoadTiming.h (common_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary> Times saving and loading a model with a large constant node, in the JSON and the binary archive formats. </summary>
+///
+/// <param name="numWeights"> The number of float weights in the constant node. </param>
+/// <param name="numRepetitions"> The number of times to load each file. </param>
+void TimeModelLoading(size_t numWeights, size_t numRepetitions);
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DatasetLoadTiming.cpp (common_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DatasetLoadTiming.h"
+
+#include <common/include/DataLoaders.h>
+
+#include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDatasetCache.h>
+#include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/ParallelDatasetParser.h>
+#include <data/include/WeightLabel.h>
+
+#include <utilities/include/Files.h>
+#include <utilities/include/MemoryMappedFile.h>
+#include <utilities/include/MillisecondTimer.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+// Writes a dataset of sparse examples in the text format, and returns the file size
+size_t WriteSparseDataset(const std::string& filename, size_t numExamples, size_t numNonZeros)
+{
+    const size_t numFeatures = 100000;
+    std::default_random_engine engine(1234);
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    std::normal_distribution<double> valueDistribution(0, 1);
+
+    {
+        auto stream = utilities::OpenOfstream(filename);
+        std::vector<size_t> features(numNonZeros);
+        for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+        {
+            std::generate(features.begin(), features.end(), [&]() { return featureDistribution(engine); });
+            std::sort(features.begin(), features.end());
+            features.erase(std::unique(features.begin(), features.end()), features.end());
+
+            stream << (exampleIndex % 2 == 0 ? "1" : "-1");
+            for (auto feature : features)
+            {
+                stream << '\t' << feature << ':' << valueDistribution(engine);
+            }
+            stream << '\n';
+            features.resize(numNonZeros);
+        }
+    }
+    return utilities::MemoryMappedFile(filename).Size();
+}
+
+void PrintTiming(const std::string& name, size_t numBytes, std::function<size_t()> load)
+{
+    utilities::MillisecondTimer timer;
+    auto numExamples = load();
+    auto milliseconds = std::max<int64_t>(timer.Elapsed(), 1);
+    std::cout << std::setw(24) << name
+              << std::setw(12) << milliseconds
+              << std::setw(12) << std::fixed << std::setprecision(1) << numBytes / (1024.0 * 1024.0) / (milliseconds / 1000.0)
+              << std::setw(12) << numExamples << std::endl;
+}
+} // namespace
+
+void TimeDatasetLoading(size_t numExamples, size_t numNonZeros)
+{
+    using DataVectorParserType = data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>;
+    const std::string textFilename = "timing_data.txt";
+    const std::string cacheFilename = "timing_data.elldata";
+
+    auto textSize = WriteSparseDataset(textFilename, numExamples, numNonZeros);
+    std::cout << "Sparse dataset with " << numExamples << " examples of " << numNonZeros << " nonzeros, "
+              << std::fixed << std::setprecision(1) << textSize / (1024.0 * 1024.0) << " MB of text" << std::endl;
+    std::cout << std::setw(24) << "method" << std::setw(12) << "ms" << std::setw(12) << "text MB/s" << std::setw(12) << "examples" << std::endl;
+
+    PrintTiming("sequential", textSize, [&]() {
+        auto stream = utilities::OpenIfstream(textFilename);
+        return data::MakeDataset(common::GetAutoSupervisedExampleIterator(stream)).NumExamples();
+    });
+
+    for (size_t numThreads : { 1, 2, 4, 8 })
+    {
+        PrintTiming("parallel, " + std::to_string(numThreads) + " threads", textSize, [&]() {
+            auto stream = utilities::OpenIfstream(textFilename);
+            return data::ParseDatasetInParallel<data::LabelParser, DataVectorParserType>(stream, numThreads).NumExamples();
+        });
+    }
+
+    {
+        auto stream = utilities::OpenIfstream(textFilename);
+        auto dataset = common::GetDataset(stream);
+        PrintTiming("write cache", textSize, [&]() {
+            auto cacheStream = utilities::OpenBinaryOfstream(cacheFilename);
+            data::BinaryDatasetCache::Write(dataset, cacheStream);
+            return dataset.NumExamples();
+        });
+    }
+
+    PrintTiming("load cache", textSize, [&]() {
+        data::BinaryDatasetCache cache(cacheFilename);
+        return data::MakeDataset(cache.GetExampleIterator()).NumExamples();
+    });
+}
@@ -10,11 +10,21 @@
 #include <common/include/LoadModel.h>
 #include <common/include/MapLoadArguments.h>
 
+#include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDatasetCache.h>
+#include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/PackedDataset.h>
+#include <data/include/ParallelDatasetParser.h>
+#include <data/include/WeightLabel.h>
+
 #include <testing/include/testing.h>
 
 #include <utilities/include/Files.h>
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <string>
 
 namespace ell
 {
@@ -25,6 +35,134 @@ void TestLoadDataset(const std::string& examplePath)
     auto dataset = common::GetDataset(stream);
 }
 
+namespace
+{
+    bool IsEqual(const data::AutoSupervisedDataset& a, const data::AutoSupervisedDataset& b)
+    {
+        if (a.NumExamples() != b.NumExamples())
+        {
+            return false;
+        }
+        for (size_t index = 0; index < a.NumExamples(); ++index)
+        {
+            const auto& exampleA = a[index];
+            const auto& exampleB = b[index];
+            if (exampleA.GetMetadata().weight != exampleB.GetMetadata().weight || exampleA.GetMetadata().label != exampleB.GetMetadata().label)
+            {
+                return false;
+            }
+            if (!testing::IsEqual(exampleA.GetDataVector().ToArray(), exampleB.GetDataVector().ToArray(), 0.0))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsEqual(const data::PackedDataset& a, const data::AutoSupervisedDataset& b)
+    {
+        if (a.NumExamples() != b.NumExamples())
+        {
+            return false;
+        }
+        for (size_t index = 0; index < a.NumExamples(); ++index)
+        {
+            const auto& exampleB = b[index];
+            if (a.GetMetadata(index).weight != exampleB.GetMetadata().weight || a.GetMetadata(index).label != exampleB.GetMetadata().label)
+            {
+                return false;
+            }
+            const auto& dataVectorB = exampleB.GetDataVector();
+            if (!testing::IsEqual(a.GetDataVector(index).ToArray(dataVectorB.PrefixLength()), dataVectorB.ToArray(), 0.0))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    data::AutoSupervisedDataset LoadDatasetSequentially(const std::string& filename)
+    {
+        auto stream = utilities::OpenIfstream(filename);
+        return data::MakeDataset(common::GetAutoSupervisedExampleIterator(stream));
+    }
+} // namespace
+
+void TestLoadDatasetInParallel(const std::string& examplePath)
+{
+    auto filename = utilities::JoinPaths(examplePath, { "data", "testData.txt" });
+    auto expectedDataset = LoadDatasetSequentially(filename);
+
+    // small chunks, so lines are split across chunks and threads
+    bool ok = expectedDataset.NumExamples() > 0;
+    for (size_t numThreads : { 1, 3, 8 })
+    {
+        auto stream = utilities::OpenIfstream(filename);
+        auto dataset = data::ParseDatasetInParallel<data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream, numThreads, 1000);
+        ok = ok && IsEqual(dataset, expectedDataset);
+    }
+    testing::ProcessTest("Testing parallel dataset parsing", ok);
+}
+
+void TestDatasetCache(const std::string& examplePath)
+{
+    // the cache is checked against its source, so the test works on a copy of the data it can change
+    common::DataLoadArguments args;
+    args.inputDataFilename = "testDataCacheSource.txt";
+    args.dataCacheFilename = "testData.elldata";
+    std::string firstLine;
+    {
+        auto source = utilities::OpenIfstream(utilities::JoinPaths(examplePath, { "data", "testData.txt" }));
+        auto copy = utilities::OpenOfstream(args.inputDataFilename);
+        copy << source.rdbuf();
+        auto stream = utilities::OpenIfstream(args.inputDataFilename);
+        std::getline(stream, firstLine);
+    }
+    auto expectedDataset = LoadDatasetSequentially(args.inputDataFilename);
+
+    // the first load parses the data and writes the cache, the second one reads the cache
+    if (utilities::IsFileReadable(args.dataCacheFilename))
+    {
+        std::remove(args.dataCacheFilename.c_str());
+    }
+    auto parsedDataset = common::GetDataset(args);
+    auto isCacheWritten = data::BinaryDatasetCache::IsBinaryDatasetCache(args.dataCacheFilename);
+    auto cachedDataset = common::GetDataset(args);
+    testing::ProcessTest("Testing dataset cache write", isCacheWritten && IsEqual(parsedDataset, expectedDataset));
+    testing::ProcessTest("Testing dataset cache load", IsEqual(cachedDataset, expectedDataset));
+
+    size_t numExamples = 0;
+    {
+        data::BinaryDatasetCache cache(args.dataCacheFilename);
+        auto iterator = cache.GetExampleIterator();
+        while (iterator.IsValid())
+        {
+            ++numExamples;
+            iterator.Next();
+        }
+        testing::ProcessTest("Testing dataset cache iteration", numExamples == expectedDataset.NumExamples() && cache.NumExamples() == numExamples);
+    }
+
+    // a change to the source makes the cache stale
+    {
+        std::ofstream source(args.inputDataFilename, std::ios::app);
+        source << firstLine << "\n";
+    }
+    auto changedDataset = common::GetDataset(args);
+    testing::ProcessTest("Testing dataset cache invalidation", changedDataset.NumExamples() == numExamples + 1 && IsEqual(changedDataset, LoadDatasetSequentially(args.inputDataFilename)));
+
+    // a truncated cache is replaced rather than read
+    {
+        auto cacheStream = utilities::OpenBinaryOfstream(args.dataCacheFilename);
+        cacheStream.write("ELLDATA", 8);
+    }
+    auto reparsedDataset = common::GetDataset(args);
+    testing::ProcessTest("Testing truncated dataset cache", reparsedDataset.NumExamples() == numExamples + 1 && data::BinaryDatasetCache(args.dataCacheFilename).IsCacheOf(args.inputDataFilename));
+
+    std::remove(args.dataCacheFilename.c_str());
+    std::remove(args.inputDataFilename.c_str());
+}
+
 void TestLoadMappedDataset(const std::string& examplePath)
 {
     common::MapLoadArguments args;
@@ -14,6 +14,8 @@
 #include <testing/include/testing.h>
 
 #include <iostream>
+#include <sstream>
+#include <string>
 
 namespace ell
 {
@@ -75,4 +77,22 @@ void TestSaveModels()
     auto newTree2 = common::LoadModel("tree_2." + ext);
     auto newTree3 = common::LoadModel("tree_3." + ext);
 }
+
+void TestSaveBinaryModels()
+{
+    for (std::string modelName : { "1", "2", "3", "tree_0", "tree_1", "tree_2", "tree_3" })
+    {
+        auto model = common::LoadTestModel("[" + modelName + "]");
+        auto filename = "model_" + modelName + ".ellb";
+        common::SaveModel(model, filename);
+        auto newModel = common::LoadModel(filename);
+
+        // the models should be identical once archived as JSON
+        std::stringstream modelStream;
+        std::stringstream newModelStream;
+        common::SaveModel(model, modelStream);
+        common::SaveModel(newModel, newModelStream);
+        testing::ProcessTest("Testing binary archive round trip of model " + modelName, modelStream.str() == newModelStream.str());
+    }
+}
 } // namespace ell
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ModelLoadTiming.cpp (common_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ModelLoadTiming.h"
+
+#include <common/include/LoadModel.h>
+
+#include <model/include/InputNode.h>
+#include <model/include/Model.h>
+#include <model/include/OutputNode.h>
+
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/ConstantNode.h>
+
+#include <utilities/include/MemoryMappedFile.h>
+#include <utilities/include/MillisecondTimer.h>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+// A model whose size is dominated by its weights, like a layer of a large neural network
+model::Model GetModelWithLargeConstant(size_t numWeights)
+{
+    std::default_random_engine engine(1234);
+    std::normal_distribution<float> normal(0, 1);
+    std::vector<float> weights(numWeights);
+    for (auto& weight : weights)
+    {
+        weight = normal(engine);
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(numWeights);
+    auto constantNode = model.AddNode<nodes::ConstantNode<float>>(weights);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<float>>(inputNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    model.AddNode<model::OutputNode<float>>(sumNode->output);
+    return model;
+}
+
+void TimeModelFormat(const model::Model& model, const std::string& filename, size_t numRepetitions)
+{
+    utilities::MillisecondTimer timer;
+    common::SaveModel(model, filename);
+    auto saveTime = timer.Elapsed();
+    auto fileSize = utilities::MemoryMappedFile(filename).Size();
+
+    timer.Reset();
+    size_t numNodes = 0;
+    for (size_t repetition = 0; repetition < numRepetitions; ++repetition)
+    {
+        numNodes += common::LoadModel(filename).Size();
+    }
+    auto loadTime = static_cast<double>(timer.Elapsed()) / numRepetitions;
+
+    std::cout << std::setw(12) << filename
+              << std::setw(12) << std::fixed << std::setprecision(1) << fileSize / (1024.0 * 1024.0)
+              << std::setw(12) << saveTime
+              << std::setw(12) << loadTime
+              << std::setw(8) << numNodes / numRepetitions << std::endl;
+}
+} // namespace
+
+void TimeModelLoading(size_t numWeights, size_t numRepetitions)
+{
+    auto model = GetModelWithLargeConstant(numWeights);
+
+    std::cout << "Model with " << numWeights << " float weights, loaded " << numRepetitions << " times" << std::endl;
+    std::cout << std::setw(12) << "file" << std::setw(12) << "MB" << std::setw(12) << "save ms" << std::setw(12) << "load ms" << std::setw(8) << "nodes" << std::endl;
+    TimeModelFormat(model, "timing.model", numRepetitions);
+    TimeModelFormat(model, "timing.ellb", numRepetitions);
+}
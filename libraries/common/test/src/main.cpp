@@ -37,11 +37,14 @@ int main(int argc, char* argv[])
         TestLoadSavedModels(examplePath);
 
         TestSaveModels();
+        TestSaveBinaryModels();
 
         TestLoadMapWithDefaultArgs(examplePath);
         TestLoadMapWithPorts(examplePath);
 
         TestLoadDataset(examplePath);
+        TestLoadDatasetInParallel(examplePath);
+        TestDatasetCache(examplePath);
         TestLoadMappedDataset(examplePath);
     }
     catch (const utilities::Exception& exception)
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (common_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DatasetLoadTiming.h"
+#include "ModelLoadTiming.h"
+
+#include <utilities/include/Exception.h>
+
+#include <iostream>
+#include <string>
+
+using namespace ell;
+
+/// Runs all timings
+///
+int main(int argc, char** argv)
+{
+    try
+    {
+        // 20M float weights is about the size of an 80 MB ImageNet-class model
+        size_t numWeights = argc > 1 ? std::stoull(argv[1]) : 20000000;
+        TimeModelLoading(numWeights, 3);
+
+        // 100 nonzeros per example is typical of sparse text data
+        size_t numExamples = argc > 2 ? std::stoull(argv[2]) : 200000;
+        TimeDatasetLoading(numExamples, 100);
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "ERROR, got ELL exception. Message: " << exception.GetMessage() << std::endl;
+        throw;
+    }
+
+    return 0;
+}
@@ -170,17 +170,18 @@ namespace data
 
     private:
         // helper function used by ctors to choose the type of data vector to use
-        void FindBestRepresentation(DefaultDataVectorType defaultDataVector);
+        template <typename SourceDataVectorType>
+        void FindBestRepresentation(SourceDataVectorType sourceDataVector);
 
-        template <typename DataVectorType, utilities::IsSame<DataVectorType, DefaultDataVectorType> Concept = true>
-        void SetInternal(DefaultDataVectorType defaultDataVector)
+        template <typename DataVectorType, typename SourceDataVectorType, utilities::IsSame<DataVectorType, SourceDataVectorType> Concept = true>
+        void SetInternal(SourceDataVectorType sourceDataVector)
         {
             // STYLE intentional deviation from project style due to compilation difficulties
-            _pInternal = std::make_unique<DefaultDataVectorType>(std::move(defaultDataVector));
+            _pInternal = std::make_unique<SourceDataVectorType>(std::move(sourceDataVector));
         }
 
-        template <typename DataVectorType, utilities::IsDifferent<DataVectorType, DefaultDataVectorType> Concept = true>
-        void SetInternal(DefaultDataVectorType defaultDataVector);
+        template <typename DataVectorType, typename SourceDataVectorType, utilities::IsDifferent<DataVectorType, SourceDataVectorType> Concept = true>
+        void SetInternal(SourceDataVectorType sourceDataVector);
 
         // members
         std::unique_ptr<IDataVector> _pInternal;
@@ -224,8 +225,9 @@ namespace data
     template <typename IndexValueIteratorType, IsIndexValueIterator<IndexValueIteratorType> Concept>
     AutoDataVectorBase<DefaultDataVectorType>::AutoDataVectorBase(IndexValueIteratorType indexValueIterator)
     {
-        DefaultDataVectorType defaultDataVector(std::move(indexValueIterator));
-        FindBestRepresentation(std::move(defaultDataVector));
+        // collect the values sparsely, so a long vector with few nonzeros (the common case when parsing) doesn't go through a dense buffer
+        SparseDoubleDataVector sparseDataVector(std::move(indexValueIterator));
+        FindBestRepresentation(std::move(sparseDataVector));
     }
 
     template <typename DefaultDataVectorType>
@@ -321,7 +323,8 @@ namespace data
     }
 
     template <typename DefaultDataVectorType>
-    void AutoDataVectorBase<DefaultDataVectorType>::FindBestRepresentation(DefaultDataVectorType defaultDataVector)
+    template <typename SourceDataVectorType>
+    void AutoDataVectorBase<DefaultDataVectorType>::FindBestRepresentation(SourceDataVectorType sourceDataVector)
     {
         size_t numNonZeros = 0;
         bool includesNonFloats = false;
@@ -329,7 +332,7 @@ namespace data
         bool includesNonBytes = false;
         bool includesNonBinary = false;
 
-        auto iter = GetIterator<DefaultDataVectorType, IterationPolicy::skipZeros>(defaultDataVector);
+        auto iter = GetIterator<SourceDataVectorType, IterationPolicy::skipZeros>(sourceDataVector);
         while (iter.IsValid())
         {
             double value = iter.Get().value;
@@ -344,23 +347,23 @@ namespace data
         }
 
         // dense
-        if (numNonZeros > SPARSE_THRESHOLD * defaultDataVector.PrefixLength())
+        if (numNonZeros > SPARSE_THRESHOLD * sourceDataVector.PrefixLength())
         {
             if (includesNonFloats)
             {
-                SetInternal<DoubleDataVector>(std::move(defaultDataVector));
+                SetInternal<DoubleDataVector>(std::move(sourceDataVector));
             }
             else if (includesNonShorts)
             {
-                SetInternal<FloatDataVector>(std::move(defaultDataVector));
+                SetInternal<FloatDataVector>(std::move(sourceDataVector));
             }
             else if (includesNonBytes)
             {
-                SetInternal<ShortDataVector>(std::move(defaultDataVector));
+                SetInternal<ShortDataVector>(std::move(sourceDataVector));
             }
             else
             {
-                SetInternal<ByteDataVector>(std::move(defaultDataVector));
+                SetInternal<ByteDataVector>(std::move(sourceDataVector));
             }
         }
 
@@ -369,32 +372,32 @@ namespace data
         {
             if (includesNonFloats)
             {
-                SetInternal<SparseDoubleDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseDoubleDataVector>(std::move(sourceDataVector));
             }
             else if (includesNonShorts)
             {
-                SetInternal<SparseFloatDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseFloatDataVector>(std::move(sourceDataVector));
             }
             else if (includesNonBytes)
             {
-                SetInternal<SparseShortDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseShortDataVector>(std::move(sourceDataVector));
             }
             else if (includesNonBinary)
             {
-                SetInternal<SparseByteDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseByteDataVector>(std::move(sourceDataVector));
             }
             else
             {
-                SetInternal<SparseBinaryDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseBinaryDataVector>(std::move(sourceDataVector));
             }
         }
     }
 
     template <typename DefaultDataVectorType>
-    template <typename DataVectorType, utilities::IsDifferent<DataVectorType, DefaultDataVectorType> Concept>
-    void AutoDataVectorBase<DefaultDataVectorType>::SetInternal(DefaultDataVectorType defaultDataVector)
+    template <typename DataVectorType, typename SourceDataVectorType, utilities::IsDifferent<DataVectorType, SourceDataVectorType> Concept>
+    void AutoDataVectorBase<DefaultDataVectorType>::SetInternal(SourceDataVectorType sourceDataVector)
     {
-        _pInternal = std::make_unique<DataVectorType>(GetIterator<DefaultDataVectorType, IterationPolicy::skipZeros>(defaultDataVector));
+        _pInternal = std::make_unique<DataVectorType>(GetIterator<SourceDataVectorType, IterationPolicy::skipZeros>(sourceDataVector));
     }
 
     template <typename IndexValueParsingIterator>
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetCache.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+
+#include <utilities/include/MemoryMappedFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// A parsed dataset stored in a binary, columnar file that is memory-mapped and read without parsing. After a header,
+    /// which records the path, size and modification time of the text file the dataset was parsed from, the file holds the
+    /// data vectors in compressed sparse row form (the offset of each example's entries, then the feature index and value
+    /// of each nonzero entry), followed by the weight and label of each example.
+    /// </summary>
+    class BinaryDatasetCache
+    {
+    public:
+        /// <summary> Maps a cache file into memory, and throws an exception if it isn't a valid cache. </summary>
+        ///
+        /// <param name="filename"> The path of the cache file. </param>
+        BinaryDatasetCache(const std::string& filename);
+
+        /// <summary> Writes a dataset to a stream in the cache format. </summary>
+        ///
+        /// <param name="dataset"> The dataset. </param>
+        /// <param name="stream"> The stream to write to, which should be opened in binary mode. </param>
+        /// <param name="sourceFilename"> The path of the file the dataset was parsed from, if any. </param>
+        static void Write(const AutoSupervisedDataset& dataset, std::ostream& stream, const std::string& sourceFilename = "");
+
+        /// <summary> Checks if a file is a dataset cache, by reading its header. </summary>
+        ///
+        /// <param name="filename"> The path of the file. </param>
+        ///
+        /// <returns> true if the file exists and starts with a dataset cache header. </returns>
+        static bool IsBinaryDatasetCache(const std::string& filename);
+
+        /// <summary> Checks if the cache was written from a file, and the file's size and modification time haven't changed since. </summary>
+        ///
+        /// <param name="sourceFilename"> The path of the file, as passed to `Write`. </param>
+        ///
+        /// <returns> true if the cache holds the current contents of the file. </returns>
+        bool IsCacheOf(const std::string& sourceFilename) const;
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Returns the total number of nonzero entries in the examples' data vectors. </summary>
+        ///
+        /// <returns> The number of nonzero entries. </returns>
+        size_t NumNonZeros() const { return _numNonZeros; }
+
+        /// <summary> Creates an example from its entries in the cache. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        AutoSupervisedExample GetExample(size_t index) const;
+
+        /// <summary> Gets an iterator over the examples, which creates each example as it is reached. The iterator refers to this cache, which must outlive it. </summary>
+        ///
+        /// <returns> The example iterator. </returns>
+        AutoSupervisedExampleIterator GetExampleIterator() const;
+
+    private:
+        utilities::MemoryMappedFile _file;
+        size_t _numExamples = 0;
+        size_t _numNonZeros = 0;
+        std::string _sourcePath;
+        uint64_t _sourceSize = 0;
+        int64_t _sourceModificationTime = 0;
+        const uint64_t* _exampleOffsets = nullptr;
+        const double* _weights = nullptr;
+        const double* _labels = nullptr;
+        const double* _values = nullptr;
+        const uint32_t* _indices = nullptr;
+    };
+} // namespace data
+} // namespace ell
@@ -41,7 +41,8 @@ namespace data
             SparseShortDataVector,
             SparseByteDataVector,
             SparseBinaryDataVector,
-            AutoDataVector
+            AutoDataVector,
+            PackedDataVector
         };
 
         virtual ~IDataVector() = default;
@@ -436,6 +437,7 @@ namespace data
 #pragma region implementation
 
 #include "../include/DenseDataVector.h"
+#include "../include/PackedDataVector.h"
 #include "../include/SparseBinaryDataVector.h"
 #include "../include/SparseDataVector.h"
 #include "../include/TransformingIndexValueIterator.h"
@@ -477,6 +479,9 @@ namespace data
         case Type::SparseBinaryDataVector:
             return lambda(static_cast<const SparseBinaryDataVector*>(this));
 
+        case Type::PackedDataVector:
+            return lambda(static_cast<const PackedDataVector*>(this));
+
         default:
             throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "attempted to cast unsupported data vector type");
         }
@@ -29,6 +29,9 @@ namespace data
     template <typename ExampleType>
     class Dataset;
 
+    // forward declaration of PackedDataset, which AnyDataset can also refer to
+    class PackedDataset;
+
     /// <summary> Polymorphic interface for datasets, enables dynamic_cast operations. </summary>
     struct DatasetBase
     {
@@ -315,7 +318,8 @@ namespace data
         // all Dataset types for which GetAnyDataset() is called must be listed below, in the variadic template argument.
         using Invoker = utilities::AbstractInvoker<DatasetBase,
                                                    Dataset<data::AutoSupervisedExample>,
-                                                   Dataset<data::DenseSupervisedExample>>;
+                                                   Dataset<data::DenseSupervisedExample>,
+                                                   PackedDataset>;
 
         return Invoker::Invoke<ExampleIterator<ExampleType>>(getExampleIterator, _pDataset);
     }
@@ -522,4 +526,7 @@ namespace data
 } // namespace data
 } // namespace ell
 
+// AnyDataset needs the definition of PackedDataset to iterate over one
+#include "PackedDataset.h"
+
 #pragma endregion implementation
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataVector.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DataVector.h"
+#include "IndexValue.h"
+#include "SparseDataVector.h"
+
+#ifndef PACKEDDATAVECTOR_H
+#define PACKEDDATAVECTOR_H
+
+#include <utilities/include/CompressedIntegerList.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// A read-only sparse data vector whose entries are stored elsewhere: the indices in a segment of a
+    /// CompressedIntegerList, and the values in a range of an array. PackedDataset returns these to refer to its
+    /// examples without copying them, so creating one doesn't allocate memory. A PackedDataVector is only valid while
+    /// the storage it refers to is unchanged.
+    /// </summary>
+    class PackedDataVector : public DataVectorBase<PackedDataVector>
+    {
+    public:
+        /// <summary> Constructs a data vector that refers to existing entries. </summary>
+        ///
+        /// <param name="indexIterator"> An iterator over the indices of the nonzero entries, in increasing order. </param>
+        /// <param name="valueIterator"> An iterator that points to the value of the first nonzero entry. </param>
+        /// <param name="prefixLength"> One plus the index of the last nonzero entry, or zero if there isn't one. </param>
+        PackedDataVector(const utilities::CompressedIntegerList::Iterator& indexIterator, std::vector<double>::const_iterator valueIterator, size_t prefixLength);
+
+        template <IterationPolicy policy>
+        using Iterator = SparseDataVectorIterator<policy, double, utilities::CompressedIntegerList>;
+
+        /// <summary> Returns an indexValue iterator that points to the beginning of the vector. </summary>
+        ///
+        /// <param name="size"> The size of the vector. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <IterationPolicy policy>
+        Iterator<policy> GetIterator(size_t size) const { return Iterator<policy>(_indexIterator, _valueIterator, size); }
+
+        /// <summary> Returns an indexValue iterator that points to the beginning of the vector. </summary>
+        ///
+        /// <returns> The iterator. </returns>
+        template <IterationPolicy policy>
+        Iterator<policy> GetIterator() const { return GetIterator<policy>(_prefixLength); }
+
+        /// <summary> Throws an exception, since the entries of a PackedDataVector can't be changed. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the element. </param>
+        /// <param name="value"> The value. </param>
+        void AppendElement(size_t index, double value) override;
+
+        /// <summary>
+        /// A data vector has infinite dimension and ends with a suffix of zeros. This function returns
+        /// the first index in this suffix. Equivalently, the returned value is one plus the index of the
+        /// last non-zero element.
+        /// </summary>
+        ///
+        /// <returns> The first index of the suffix of zeros at the end of this vector. </returns>
+        size_t PrefixLength() const override { return _prefixLength; }
+
+        /// <summary> Gets the data vector type. </summary>
+        ///
+        /// <returns> The data vector type. </returns>
+        IDataVector::Type GetType() const override { return IDataVector::Type::PackedDataVector; }
+
+    private:
+        utilities::CompressedIntegerList::Iterator _indexIterator;
+        std::vector<double>::const_iterator _valueIterator;
+        size_t _prefixLength;
+    };
+} // namespace data
+} // namespace ell
+
+#endif // PACKEDDATAVECTOR_H
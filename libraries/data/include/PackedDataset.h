@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataset.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AutoDataVector.h"
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "PackedDataVector.h"
+#include "SparseDataVector.h"
+#include "WeightLabel.h"
+
+#include <utilities/include/CompressedIntegerList.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> Permutes an array the way Dataset::RandomPermute permutes its examples, so that a prefix of it is uniformly distributed. </summary>
+    ///
+    /// <typeparam name="ElementType"> The array element type. </typeparam>
+    /// <param name="array"> [in,out] The array. </param>
+    /// <param name="rng"> [in,out] The random number generator. </param>
+    /// <param name="prefixSize"> Size of the prefix that should be uniformly distributed, zero to permute the entire array. </param>
+    template <typename ElementType>
+    void RandomPermute(std::vector<ElementType>& array, std::default_random_engine& rng, size_t prefixSize = 0);
+
+    /// <summary>
+    /// A dataset of supervised examples stored in compressed sparse row form: the feature indices of all the examples
+    /// are delta-encoded, one segment per example, in a single CompressedIntegerList, their values are stored in a single
+    /// array, and each example is located by its offsets into the two. Unlike Dataset, which holds a separately allocated
+    /// data vector for each example, the examples are packed into a few contiguous arrays and created as they are
+    /// iterated over, so the dataset uses less memory and iterating over it reads memory sequentially. Creating an
+    /// example still allocates its data vector, which the example owns, so each example an iterator returns costs one
+    /// allocation. GetDataVector doesn't allocate: it returns a data vector that refers to the packed entries.
+    /// </summary>
+    class PackedDataset : public DatasetBase
+    {
+    public:
+        /// <summary> Iterator class. </summary>
+        template <typename IteratorExampleType>
+        class PackedDatasetExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary></summary>
+            PackedDatasetExampleIterator(const PackedDataset& dataset, size_t fromIndex, size_t size);
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            ///
+            /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+            bool IsValid() const override { return _current < _end; }
+
+            /// <summary> Returns true, since the number of examples left is known. </summary>
+            ///
+            /// <returns> true. </returns>
+            bool HasSize() const override { return true; }
+
+            /// <summary> Returns the number of examples left in the iterator. </summary>
+            ///
+            /// <returns> The number of examples left. </returns>
+            size_t NumItemsLeft() const override { return _end - _current; }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override { ++_current; }
+
+            /// <summary> Creates the current example. </summary>
+            ///
+            /// <returns> The example. </returns>
+            IteratorExampleType Get() const override { return _dataset.template GetExample<IteratorExampleType>(_current); }
+
+        private:
+            const PackedDataset& _dataset;
+            size_t _current;
+            size_t _end;
+        };
+
+        PackedDataset();
+
+        PackedDataset(PackedDataset&&) = default;
+
+        PackedDataset(const PackedDataset&) = delete;
+
+        /// <summary> Constructs an instance of PackedDataset by packing the examples of an example iterator. </summary>
+        ///
+        /// <typeparam name="ExampleType"> Example type, whose metadata must be convertible to WeightLabel. </typeparam>
+        /// <param name="exampleIterator"> The example iterator. </param>
+        template <typename ExampleType>
+        PackedDataset(ExampleIterator<ExampleType> exampleIterator);
+
+        /// <summary> Constructs an instance of PackedDataset by packing the examples of an AnyDataset. </summary>
+        ///
+        /// <param name="anyDataset"> the AnyDataset. </param>
+        PackedDataset(const AnyDataset& anyDataset);
+
+        PackedDataset& operator=(PackedDataset&&) = default;
+
+        PackedDataset& operator=(const PackedDataset&) = delete;
+
+        /// <summary> Returns the number of examples in the data set. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _metadata.size(); }
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        ///
+        /// <returns> The maximal size of any example. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Returns the total number of nonzero entries in the examples' data vectors. </summary>
+        ///
+        /// <returns> The number of nonzero entries. </returns>
+        size_t NumNonZeros() const { return _values.size(); }
+
+        /// <summary> Returns the number of bytes used by the packed examples. </summary>
+        ///
+        /// <returns> The number of bytes. </returns>
+        size_t NumBytes() const;
+
+        /// <summary> Returns an example's data vector, which refers to the packed entries. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The data vector, which is valid until the dataset is changed. </returns>
+        PackedDataVector GetDataVector(size_t index) const;
+
+        /// <summary> Returns an example's metadata. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The metadata. </returns>
+        const WeightLabel& GetMetadata(size_t index) const { return _metadata[index]; }
+
+        /// <summary> Creates an example from its packed data, in a newly allocated data vector. </summary>
+        ///
+        /// <typeparam name="ExampleType"> The type of example to create. </typeparam>
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        template <typename ExampleType = AutoSupervisedExample>
+        ExampleType GetExample(size_t index) const;
+
+        /// <summary> Returns an iterator that creates the examples as it traverses them. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator, which refers to this dataset. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, size); }
+
+        /// <summary> Adds an example at the bottom of the dataset. </summary>
+        ///
+        /// <typeparam name="ExampleType"> Example type, whose metadata must be convertible to WeightLabel. </typeparam>
+        /// <param name="example"> The example. </param>
+        template <typename ExampleType>
+        void AddExample(const ExampleType& example);
+
+        /// <summary> Erases all of the examples in the dataset. </summary>
+        void Reset();
+
+        /// <summary> Permutes the examples so that a prefix of them is uniformly distributed. The packed arrays are
+        /// rewritten in the new order, so that iterating over the dataset still reads memory sequentially. Given the
+        /// same random number generator, the examples are permuted the same way as by Dataset::RandomPermute. </summary>
+        ///
+        /// <param name="rng"> [in,out] The random number generator. </param>
+        /// <param name="prefixSize"> Size of the prefix that should be uniformly distributed, zero to permute the entire data set. </param>
+        void RandomPermute(std::default_random_engine& rng, size_t prefixSize = 0);
+
+    private:
+        template <typename DataVectorType>
+        void AppendDataVector(const DataVectorType& dataVector);
+
+        template <typename DefaultDataVectorType>
+        void AppendDataVector(const AutoDataVectorBase<DefaultDataVectorType>& dataVector);
+
+        template <typename IndexValueIteratorType>
+        void AppendEntries(IndexValueIteratorType indexValueIterator);
+        size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+
+        utilities::CompressedIntegerList _indices;
+        std::vector<double> _values;
+        std::vector<size_t> _indexOffsets; // the byte offset of each example's segment of _indices, and the end of the last one
+        std::vector<size_t> _valueOffsets; // the offset of each example's entries in _values, and the end of the last one
+        std::vector<size_t> _prefixLengths;
+        std::vector<WeightLabel> _metadata;
+        size_t _numFeatures = 0;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace ell
+{
+namespace data
+{
+    template <typename ElementType>
+    void RandomPermute(std::vector<ElementType>& array, std::default_random_engine& rng, size_t prefixSize)
+    {
+        using std::swap;
+        if (prefixSize == 0 || prefixSize > array.size())
+        {
+            prefixSize = array.size();
+        }
+        for (size_t i = 0; i < prefixSize; ++i)
+        {
+            std::uniform_int_distribution<size_t> dist(i, array.size() - 1);
+            swap(array[i], array[dist(rng)]);
+        }
+    }
+
+    template <typename IteratorExampleType>
+    PackedDataset::PackedDatasetExampleIterator<IteratorExampleType>::PackedDatasetExampleIterator(const PackedDataset& dataset, size_t fromIndex, size_t size) :
+        _dataset(dataset),
+        _current(fromIndex),
+        _end(fromIndex + size)
+    {
+    }
+
+    template <typename ExampleType>
+    PackedDataset::PackedDataset(ExampleIterator<ExampleType> exampleIterator) :
+        PackedDataset()
+    {
+        while (exampleIterator.IsValid())
+        {
+            AddExample(exampleIterator.Get());
+            exampleIterator.Next();
+        }
+    }
+
+    template <typename ExampleType>
+    ExampleType PackedDataset::GetExample(size_t index) const
+    {
+        using DataVectorType = typename ExampleType::DataVectorType;
+        using MetadataType = typename ExampleType::MetadataType;
+
+        if (index >= NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index out of range");
+        }
+        return ExampleType(DataVectorType(GetDataVector(index).GetIterator<IterationPolicy::skipZeros>()), MetadataType(_metadata[index]));
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> PackedDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        return ExampleIterator<IteratorExampleType>(std::make_unique<PackedDatasetExampleIterator<IteratorExampleType>>(*this, fromIndex, size));
+    }
+
+    template <typename ExampleType>
+    void PackedDataset::AddExample(const ExampleType& example)
+    {
+        const auto& dataVector = example.GetDataVector();
+        AppendDataVector(dataVector);
+        _metadata.push_back(WeightLabel(example.GetMetadata()));
+        _numFeatures = std::max(_numFeatures, dataVector.PrefixLength());
+    }
+
+    template <typename DataVectorType>
+    void PackedDataset::AppendDataVector(const DataVectorType& dataVector)
+    {
+        AppendEntries(dataVector.template GetIterator<IterationPolicy::skipZeros>());
+    }
+
+    template <typename DefaultDataVectorType>
+    void PackedDataset::AppendDataVector(const AutoDataVectorBase<DefaultDataVectorType>& dataVector)
+    {
+        // the representation of an AutoDataVector is only known at runtime, so it has no iterator of its own
+        AppendDataVector(dataVector.template CopyAs<SparseDoubleDataVector>());
+    }
+
+    template <typename IndexValueIteratorType>
+    void PackedDataset::AppendEntries(IndexValueIteratorType indexValueIterator)
+    {
+        _indices.BeginSegment();
+        size_t prefixLength = 0;
+        while (indexValueIterator.IsValid())
+        {
+            auto entry = indexValueIterator.Get();
+            _indices.Append(entry.index);
+            _values.push_back(entry.value);
+            prefixLength = entry.index + 1;
+            indexValueIterator.Next();
+        }
+        _indexOffsets.push_back(_indices.NumBytes());
+        _valueOffsets.push_back(_values.size());
+        _prefixLengths.push_back(prefixLength);
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
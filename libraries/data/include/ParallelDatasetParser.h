@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelDatasetParser.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "TextLine.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Parses a dataset from a text stream with one example per line, like a SingleLineParsingExampleIterator, but on
+    /// several threads. The stream is read one chunk at a time, and the whole lines in each chunk are split into one
+    /// block per thread. For each line, a metadata parser is applied first and a datavector parser is applied second.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of threads to use, or 0 for one per hardware thread. </param>
+    /// <param name="chunkSize"> The number of bytes read from the stream at a time. </param>
+    ///
+    /// <returns> The dataset, with its examples in the same order as the lines of the stream. </returns>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    Dataset<ParserExample<DataVectorParserType, MetadataParserType>> ParseDatasetInParallel(std::istream& stream, size_t numThreads = 0, size_t chunkSize = 1 << 24);
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/ParallelFor.h>
+
+namespace ell
+{
+namespace data
+{
+    namespace ParallelDatasetParserImpl
+    {
+        // Returns the position of the first line that starts at or after `position`, or `end` if there's none before `end`
+        inline size_t FindLineBegin(const std::string& text, size_t position, size_t end)
+        {
+            if (position == 0)
+            {
+                return 0;
+            }
+            auto newline = text.find('\n', position - 1);
+            return newline == std::string::npos || newline >= end ? end : newline + 1;
+        }
+    } // namespace ParallelDatasetParserImpl
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    Dataset<ParserExample<DataVectorParserType, MetadataParserType>> ParseDatasetInParallel(std::istream& stream, size_t numThreads, size_t chunkSize)
+    {
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+        using ParallelDatasetParserImpl::FindLineBegin;
+
+        numThreads = utilities::GetNumThreads(numThreads);
+        chunkSize = std::max<size_t>(chunkSize, 1);
+
+        Dataset<ExampleType> dataset;
+        std::vector<std::vector<ExampleType>> blockExamples(numThreads);
+        std::vector<char> buffer(chunkSize);
+        std::string text;
+        bool isLastChunk = false;
+        while (!isLastChunk)
+        {
+            // append the next chunk to the partial line left over from the previous one
+            stream.read(buffer.data(), static_cast<std::streamsize>(chunkSize));
+            text.append(buffer.data(), static_cast<size_t>(stream.gcount()));
+            isLastChunk = !stream;
+
+            // parse the whole lines, keeping a partial line at the end of the chunk for the next one
+            auto end = isLastChunk ? text.size() : text.rfind('\n') + 1;
+            utilities::ParallelFor(numThreads, 0, end, [&](size_t blockIndex, size_t blockBegin, size_t blockEnd) {
+                MetadataParserType metadataParser;
+                DataVectorParserType dataVectorParser;
+                auto& examples = blockExamples[blockIndex];
+                examples.clear();
+
+                auto lineBegin = FindLineBegin(text, blockBegin, end);
+                auto blockLinesEnd = FindLineBegin(text, blockEnd, end);
+                while (lineBegin < blockLinesEnd)
+                {
+                    auto lineEnd = std::min(text.find('\n', lineBegin), blockLinesEnd);
+
+                    // skip lines that contain just whitespace or just a comment
+                    TextLine line(text.substr(lineBegin, lineEnd - lineBegin));
+                    line.TrimLeadingWhitespace();
+                    if (!line.IsEndOfContent())
+                    {
+                        auto metadata = metadataParser.Parse(line);
+                        auto dataVector = dataVectorParser.Parse(line);
+                        examples.emplace_back(std::move(dataVector), std::move(metadata));
+                    }
+                    lineBegin = lineEnd + 1;
+                }
+            });
+
+            for (auto& examples : blockExamples)
+            {
+                for (auto& example : examples)
+                {
+                    dataset.AddExample(std::move(example));
+                }
+                examples.clear();
+            }
+            text.erase(0, end);
+        }
+        return dataset;
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -31,6 +31,9 @@ namespace data
     template <IterationPolicy policy, typename ElementType, typename IndexListType>
     class SparseDataVectorIterator;
 
+    // forward declaration of PackedDataVector, which iterates over its entries with a SparseDataVectorIterator
+    class PackedDataVector;
+
     /// <summary> A read-only forward iterator that traverses the non-zero elements. </summary>
     template <typename ElementType, typename IndexListType>
     class SparseDataVectorIterator<IterationPolicy::skipZeros, ElementType, IndexListType> : public IIndexValueIterator
@@ -61,6 +64,7 @@ namespace data
         // private ctor, can only be called from SparseDataVector and the dense Iterator classes
         SparseDataVectorIterator(const IndexIteratorType& list_iterator, const ValueIteratorType& value_iterator, size_t size);
         friend SparseDataVector<ElementType, IndexListType>;
+        friend PackedDataVector;
 
         // members
         IndexIteratorType _indexIterator;
@@ -97,6 +101,7 @@ namespace data
         // private ctor that can only be called from the containing class
         SparseDataVectorIterator(const IndexIteratorType& list_iterator, const ValueIteratorType& value_iterator, size_t size);
         friend SparseDataVector<ElementType, IndexListType>;
+        friend PackedDataVector;
 
         IndexIteratorType _indexIterator;
         ValueIteratorType _valueIterator;
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetCache.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDatasetCache.h"
+#include "AutoDataVector.h"
+#include "IndexValue.h"
+#include "SparseDataVector.h"
+#include "WeightLabel.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        const char cacheMagic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+        const uint64_t cacheVersion = 2;
+
+        // The header is followed by the path of the source file, padded to a multiple of 8 bytes
+        struct CacheHeader
+        {
+            char magic[8];
+            uint64_t version;
+            uint64_t numExamples;
+            uint64_t numNonZeros;
+            uint64_t sourceSize;
+            int64_t sourceModificationTime;
+            uint64_t sourcePathSize;
+        };
+
+        size_t GetPaddedSize(size_t size)
+        {
+            return (size + 7) / 8 * 8;
+        }
+
+        template <typename ValueType>
+        void WriteArray(std::ostream& stream, const std::vector<ValueType>& values)
+        {
+            stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(ValueType)));
+        }
+
+        // An index-value iterator over one example's entries in the cache
+        class CacheIndexValueIterator : public IIndexValueIterator
+        {
+        public:
+            CacheIndexValueIterator(const uint32_t* indices, const double* values, size_t size) :
+                _indices(indices),
+                _values(values),
+                _size(size)
+            {
+            }
+
+            bool IsValid() const { return _current < _size; }
+
+            void Next() { ++_current; }
+
+            IndexValue Get() const { return IndexValue{ _indices[_current], _values[_current] }; }
+
+        private:
+            const uint32_t* _indices;
+            const double* _values;
+            size_t _size;
+            size_t _current = 0;
+        };
+
+        class BinaryDatasetCacheExampleIterator : public IExampleIterator<AutoSupervisedExample>
+        {
+        public:
+            BinaryDatasetCacheExampleIterator(const BinaryDatasetCache& cache) :
+                _cache(cache) {}
+
+            bool IsValid() const override { return _index < _cache.NumExamples(); }
+
+            bool HasSize() const override { return true; }
+
+            size_t NumItemsLeft() const override { return _cache.NumExamples() - _index; }
+
+            void Next() override { ++_index; }
+
+            AutoSupervisedExample Get() const override { return _cache.GetExample(_index); }
+
+        private:
+            const BinaryDatasetCache& _cache;
+            size_t _index = 0;
+        };
+    } // namespace
+
+    BinaryDatasetCache::BinaryDatasetCache(const std::string& filename) :
+        _file(filename)
+    {
+        CacheHeader header;
+        if (_file.Size() < sizeof(header))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "File is too small to be a dataset cache: " + filename);
+        }
+        std::memcpy(&header, _file.GetData(), sizeof(header));
+        if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Not a dataset cache, or a cache written by a different version: " + filename);
+        }
+
+        _numExamples = static_cast<size_t>(header.numExamples);
+        _numNonZeros = static_cast<size_t>(header.numNonZeros);
+        auto sourcePathSize = static_cast<size_t>(header.sourcePathSize);
+        if (sourcePathSize > _file.Size() - sizeof(header))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Dataset cache has the wrong size: " + filename);
+        }
+        _sourcePath.assign(_file.GetData() + sizeof(header), sourcePathSize);
+        _sourceSize = header.sourceSize;
+        _sourceModificationTime = header.sourceModificationTime;
+
+        auto headerSize = sizeof(header) + GetPaddedSize(sourcePathSize);
+        auto expectedSize = headerSize + (_numExamples + 1) * sizeof(uint64_t) + 2 * _numExamples * sizeof(double) + _numNonZeros * (sizeof(double) + sizeof(uint32_t));
+        if (_file.Size() != expectedSize)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Dataset cache has the wrong size: " + filename);
+        }
+
+        // each array's size is a multiple of 8 bytes, except the indices at the end, so all of them are aligned in the page-aligned mapping
+        auto data = _file.GetData() + headerSize;
+        _exampleOffsets = reinterpret_cast<const uint64_t*>(data);
+        _weights = reinterpret_cast<const double*>(_exampleOffsets + _numExamples + 1);
+        _labels = _weights + _numExamples;
+        _values = _labels + _numExamples;
+        _indices = reinterpret_cast<const uint32_t*>(_values + _numNonZeros);
+    }
+
+    void BinaryDatasetCache::Write(const AutoSupervisedDataset& dataset, std::ostream& stream, const std::string& sourceFilename)
+    {
+        auto numExamples = dataset.NumExamples();
+        std::vector<uint64_t> exampleOffsets = { 0 };
+        std::vector<double> weights;
+        std::vector<double> labels;
+        std::vector<double> values;
+        std::vector<uint32_t> indices;
+        exampleOffsets.reserve(numExamples + 1);
+        weights.reserve(numExamples);
+        labels.reserve(numExamples);
+
+        for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+        {
+            const auto& example = dataset[exampleIndex];
+            auto sparseVector = example.GetDataVector().CopyAs<SparseDoubleDataVector>();
+            auto iterator = sparseVector.GetIterator<IterationPolicy::skipZeros>();
+            while (iterator.IsValid())
+            {
+                auto entry = iterator.Get();
+                if (entry.index > std::numeric_limits<uint32_t>::max())
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Dataset cache only supports feature indices that fit in 32 bits");
+                }
+                indices.push_back(static_cast<uint32_t>(entry.index));
+                values.push_back(entry.value);
+                iterator.Next();
+            }
+            exampleOffsets.push_back(values.size());
+            weights.push_back(example.GetMetadata().weight);
+            labels.push_back(example.GetMetadata().label);
+        }
+
+        CacheHeader header;
+        std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        header.version = cacheVersion;
+        header.numExamples = numExamples;
+        header.numNonZeros = values.size();
+        header.sourceSize = sourceFilename.empty() ? 0 : utilities::GetFileSize(sourceFilename);
+        header.sourceModificationTime = sourceFilename.empty() ? 0 : utilities::GetFileModificationTime(sourceFilename);
+        header.sourcePathSize = sourceFilename.size();
+        std::vector<char> sourcePath(GetPaddedSize(sourceFilename.size()));
+        std::copy(sourceFilename.begin(), sourceFilename.end(), sourcePath.begin());
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteArray(stream, sourcePath);
+        WriteArray(stream, exampleOffsets);
+        WriteArray(stream, weights);
+        WriteArray(stream, labels);
+        WriteArray(stream, values);
+        WriteArray(stream, indices);
+        if (!stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Couldn't write the dataset cache");
+        }
+    }
+
+    bool BinaryDatasetCache::IsBinaryDatasetCache(const std::string& filename)
+    {
+        if (!utilities::IsFileReadable(filename))
+        {
+            return false;
+        }
+        auto stream = utilities::OpenBinaryIfstream(filename);
+        char magic[sizeof(cacheMagic)];
+        stream.read(magic, sizeof(magic));
+        return stream.gcount() == sizeof(magic) && std::memcmp(magic, cacheMagic, sizeof(magic)) == 0;
+    }
+
+    bool BinaryDatasetCache::IsCacheOf(const std::string& sourceFilename) const
+    {
+        return sourceFilename == _sourcePath && utilities::FileExists(sourceFilename) &&
+               utilities::GetFileSize(sourceFilename) == _sourceSize &&
+               utilities::GetFileModificationTime(sourceFilename) == _sourceModificationTime;
+    }
+
+    AutoSupervisedExample BinaryDatasetCache::GetExample(size_t index) const
+    {
+        if (index >= _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index out of range");
+        }
+        auto begin = static_cast<size_t>(_exampleOffsets[index]);
+        auto size = static_cast<size_t>(_exampleOffsets[index + 1]) - begin;
+        AutoDataVector dataVector(CacheIndexValueIterator(_indices + begin, _values + begin, size));
+        return AutoSupervisedExample(std::move(dataVector), WeightLabel{ _weights[index], _labels[index] });
+    }
+
+    AutoSupervisedExampleIterator BinaryDatasetCache::GetExampleIterator() const
+    {
+        return AutoSupervisedExampleIterator(std::make_unique<BinaryDatasetCacheExampleIterator>(*this));
+    }
+} // namespace data
+} // namespace ell
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataVector.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PackedDataVector.h"
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace data
+{
+    PackedDataVector::PackedDataVector(const utilities::CompressedIntegerList::Iterator& indexIterator, std::vector<double>::const_iterator valueIterator, size_t prefixLength) :
+        _indexIterator(indexIterator),
+        _valueIterator(valueIterator),
+        _prefixLength(prefixLength)
+    {
+    }
+
+    void PackedDataVector::AppendElement(size_t, double)
+    {
+        throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "A PackedDataVector is read-only");
+    }
+} // namespace data
+} // namespace ell
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataset.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PackedDataset.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace ell
+{
+namespace data
+{
+    PackedDataset::PackedDataset() :
+        _indexOffsets(1, 0),
+        _valueOffsets(1, 0)
+    {
+    }
+
+    PackedDataset::PackedDataset(const AnyDataset& anyDataset) :
+        PackedDataset(anyDataset.GetExampleIterator<Example<SparseDoubleDataVector, WeightLabel>>())
+    {
+    }
+
+    size_t PackedDataset::NumBytes() const
+    {
+        return _indices.NumBytes() + _values.size() * sizeof(double) + (_indexOffsets.size() + _valueOffsets.size() + _prefixLengths.size()) * sizeof(size_t) + _metadata.size() * sizeof(WeightLabel);
+    }
+
+    PackedDataVector PackedDataset::GetDataVector(size_t index) const
+    {
+        return PackedDataVector(_indices.GetIterator(_indexOffsets[index], _indexOffsets[index + 1]), _values.cbegin() + _valueOffsets[index], _prefixLengths[index]);
+    }
+
+    void PackedDataset::Reset()
+    {
+        _indices.Reset();
+        _values.clear();
+        _indexOffsets.assign(1, 0);
+        _valueOffsets.assign(1, 0);
+        _prefixLengths.clear();
+        _metadata.clear();
+        _numFeatures = 0;
+    }
+
+    void PackedDataset::RandomPermute(std::default_random_engine& rng, size_t prefixSize)
+    {
+        // draw the permutation the same way as Dataset::RandomPermute, by permuting an array of example indices
+        auto numExamples = NumExamples();
+        std::vector<size_t> permutation(numExamples);
+        std::iota(permutation.begin(), permutation.end(), 0);
+        data::RandomPermute(permutation, rng, prefixSize);
+
+        // then gather the examples into new arrays, in their permuted order
+        PackedDataset permuted;
+        permuted._values.reserve(_values.size());
+        permuted._indexOffsets.reserve(numExamples + 1);
+        permuted._valueOffsets.reserve(numExamples + 1);
+        permuted._prefixLengths.reserve(numExamples);
+        permuted._metadata.reserve(numExamples);
+        for (auto index : permutation)
+        {
+            permuted._indices.BeginSegment();
+            auto iterator = GetDataVector(index).GetIterator<IterationPolicy::skipZeros>();
+            while (iterator.IsValid())
+            {
+                auto entry = iterator.Get();
+                permuted._indices.Append(entry.index);
+                permuted._values.push_back(entry.value);
+                iterator.Next();
+            }
+            permuted._indexOffsets.push_back(permuted._indices.NumBytes());
+            permuted._valueOffsets.push_back(permuted._values.size());
+            permuted._prefixLengths.push_back(_prefixLengths[index]);
+            permuted._metadata.push_back(_metadata[index]);
+        }
+        permuted._numFeatures = _numFeatures;
+        *this = std::move(permuted);
+    }
+
+    size_t PackedDataset::CorrectRangeSize(size_t fromIndex, size_t size) const
+    {
+        if (size == 0 || fromIndex + size > NumExamples())
+        {
+            return NumExamples() - fromIndex;
+        }
+        return size;
+    }
+} // namespace data
+} // namespace ell
@@ -12,4 +12,5 @@ namespace ell
 {
 void DatasetCastingTests();
 void DatasetSerializationTests();
+void PackedDatasetTests();
 } // namespace ell
\ No newline at end of file
@@ -11,12 +11,14 @@
 #include <common/include/DataLoaders.h>
 
 #include <data/include/Dataset.h>
+#include <data/include/PackedDataset.h>
 
 #include <utilities/include/Files.h>
 #include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
 
+#include <random>
 #include <sstream>
 
 namespace ell
@@ -119,4 +121,56 @@ void DatasetSerializationTests()
     }
     testing::ProcessTest(utilities::FormatString("DatasetSerializationTest data %d errors", errors), errors == 0);
 }
+
+void PackedDatasetTests()
+{
+    data::Dataset<data::AutoSupervisedExample> dataset;
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 1, 0, 1, 0, 1, 0, 1 }, data::WeightLabel{ 1, 1 }));
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 2.5 }, data::WeightLabel{ 2, -1 }));
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 0.5, -0.25, 3 }, data::WeightLabel{ 1, 0.5 }));
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ data::IndexValue{ 100000, 1 }, data::IndexValue{ 100001, 1 } }, data::WeightLabel{ 0.5, 1 }));
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ data::IndexValue{ 0, 7 }, data::IndexValue{ 72, 8 } }, data::WeightLabel{ 1, 1 }));
+
+    data::PackedDataset packedDataset(dataset.GetAnyDataset());
+    testing::ProcessTest("PackedDatasetTest size", packedDataset.NumExamples() == dataset.NumExamples() && packedDataset.NumFeatures() == dataset.NumFeatures());
+    testing::ProcessTest("PackedDatasetTest nonzeros", packedDataset.NumNonZeros() == 12);
+
+    // the data vectors that refer to the packed entries should behave like the original ones
+    bool dataVectorsMatch = true;
+    math::RowVector<double> weights(100002);
+    weights.Generate([]() { return 0.5; });
+    for (size_t index = 0; index < dataset.NumExamples(); ++index)
+    {
+        const auto& dataVector = dataset[index].GetDataVector();
+        auto packedDataVector = packedDataset.GetDataVector(index);
+        dataVectorsMatch = dataVectorsMatch && testing::IsEqual(packedDataVector.ToArray(dataVector.PrefixLength()), dataVector.ToArray()) &&
+                           testing::IsEqual(packedDataVector.Dot(weights), dataVector.Dot(weights)) &&
+                           packedDataset.GetMetadata(index).label == dataset[index].GetMetadata().label;
+    }
+    testing::ProcessTest("PackedDatasetTest GetDataVector", dataVectorsMatch);
+
+    // examples read back through an AnyDataset, like a trainer reads them, should match the originals
+    std::stringstream ss1, ss2, ss3;
+    dataset.Print(ss1);
+    data::AutoSupervisedDataset unpackedDataset(packedDataset.GetAnyDataset());
+    unpackedDataset.Print(ss2);
+    testing::ProcessTest("PackedDatasetTest AnyDataset", ss1.str() == ss2.str());
+
+    data::DenseSupervisedDataset denseDataset(packedDataset.GetAnyDataset(1, 2));
+    data::DenseSupervisedDataset expectedDenseDataset(dataset.GetAnyDataset(1, 2));
+    denseDataset.Print(ss3);
+    std::stringstream ss4;
+    expectedDenseDataset.Print(ss4);
+    testing::ProcessTest("PackedDatasetTest AnyDataset range", ss3.str() == ss4.str());
+
+    // permuting with the same random number generator should give the same order as permuting the dataset
+    std::default_random_engine rng1(1234);
+    std::default_random_engine rng2(1234);
+    dataset.RandomPermute(rng1);
+    packedDataset.RandomPermute(rng2);
+    std::stringstream ss5, ss6;
+    dataset.Print(ss5);
+    data::AutoSupervisedDataset(packedDataset.GetAnyDataset()).Print(ss6);
+    testing::ProcessTest("PackedDatasetTest RandomPermute", ss5.str() == ss6.str());
+}
 } // namespace ell
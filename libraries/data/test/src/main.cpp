@@ -27,6 +27,7 @@ int main()
     ExampleCopyAsTests();
     DatasetCastingTests();
     DatasetSerializationTests();
+    PackedDatasetTests();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
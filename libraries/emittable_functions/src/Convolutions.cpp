@@ -10,8 +10,10 @@
 
 #include <value/include/ComputeContext.h>
 #include <value/include/EmitterContext.h>
+#include <value/include/LoopNest.h>
 #include <value/include/Tensor.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace ell
@@ -23,42 +25,59 @@ namespace emittable_functions
     void SimpleConvolve1D(Vector signal, Vector filter, Vector output)
     {
         For(output, [&](Scalar index) {
-            Scalar accum;
-            For(filter, [&](Scalar filterIndex) { accum += filter(filterIndex) * signal(index + filterIndex); });
-
-            output(index) = accum;
+            output(index) = Cast(0, output.GetType());
+            For(filter, [&](Scalar filterIndex) { output(index) += filter(filterIndex) * signal(index + filterIndex); });
         });
     }
 
-    // Depthwise Separable using For loop where input has been explicitly padded
+    // Depthwise Separable using a loop nest where input has been explicitly padded
     void SimpleDepthwiseSeparableConvolve2D(Tensor signal,
                                             Tensor filter,
                                             Scalar rowStride,
                                             Scalar columnStride,
                                             value::Tensor output)
     {
-        // Change to For once we have emittable For for 0 to Value
-        For(signal.Slice(0, 0, Slice::All), [&](auto depth) {
-            auto slicedInputMatrix = signal.Slice(Slice::All, Slice::All, depth);
-            auto slicedOutputMatrix = output.Slice(Slice::All, Slice::All, depth);
-            auto slicedFilterMatrix = filter.Slice(Slice::All, Slice::All, depth);
+        // Set the initial values to 0
+        For(output, [&](Scalar row, Scalar column, Scalar channel) {
+            output(row, column, channel) = Cast(0, output.Type());
+        });
 
-            For(output.Slice(Slice::All, 0, 0), [&](auto outRow) {
-                For(output.Slice(0, Slice::All, 0), [&](auto outColumn) {
-                    const auto inputRow = outRow * rowStride;
-                    const auto inputColumn = outColumn * columnStride;
+        const auto outputRows = static_cast<int>(output.Rows());
+        const auto outputColumns = static_cast<int>(output.Columns());
+        const auto channels = static_cast<int>(output.Channels());
+        const auto filterRows = static_cast<int>(filter.Rows());
+        const auto filterColumns = static_cast<int>(filter.Columns());
 
-                    // Set the initial value to 0
-                    slicedOutputMatrix(outRow, outColumn) = Cast(0, output.Type());
-                    // Accumulate along values
-                    For(filter.Slice(Slice::All, 0, 0), [&](auto filterRow) {
-                        auto filterVec = slicedFilterMatrix.Row(filterRow);
-                        auto inputVec = slicedInputMatrix.Row(inputRow + filterRow).SubVector(inputColumn, filter.Columns());
+        // The innermost loop runs over a block of whichever of the channels or the columns is contiguous in memory, so
+        // each block of outputs is accumulated in vector registers across the filter loops
+        const auto& order = output.GetValue().GetLayout().GetLogicalDimensionOrder();
+        const bool channelsInnermost = order[2] == 2;
 
-                        slicedOutputMatrix(outRow, outColumn) += Dot(inputVec, filterVec);
-                    });
-                });
-            });
+        LoopNest nest({ outputRows, outputColumns, channels, filterRows, filterColumns });
+        nest.Using({ signal.GetValue(), filter.GetValue(), output.GetValue(), rowStride.GetValue(), columnStride.GetValue() });
+        auto row = nest.GetDimensionLoop(0);
+        auto column = nest.GetDimensionLoop(1);
+        auto channel = nest.GetDimensionLoop(2);
+        auto filterRow = nest.GetDimensionLoop(3);
+        auto filterColumn = nest.GetDimensionLoop(4);
+        if (channelsInnermost)
+        {
+            auto channelInner = nest.Split(channel, std::min(channels, 8));
+            nest.Reorder({ row, column, channel, filterRow, filterColumn, channelInner });
+            nest.Vectorize(channelInner);
+        }
+        else
+        {
+            auto columnInner = nest.Split(column, std::min(outputColumns, 8));
+            nest.Reorder({ channel, row, column, filterRow, filterColumn, columnInner });
+            nest.Vectorize(columnInner);
+        }
+        nest.Unroll(filterColumn);
+        nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+            Tensor signal = values[0], filter = values[1], output = values[2];
+            Scalar rowStride = values[3], columnStride = values[4];
+            auto row = indices[0], column = indices[1], channel = indices[2], filterRow = indices[3], filterColumn = indices[4];
+            output(row, column, channel) += signal(row * rowStride + filterRow, column * columnStride + filterColumn, channel) * filter(filterRow, filterColumn, channel);
         });
     }
 } // namespace emittable_functions
@@ -19,6 +19,7 @@
 #include <testing/include/testing.h>
 
 #include <utilities/include/FunctionUtils.h>
+#include <utilities/include/MillisecondTimer.h>
 
 #include <value/include/ComputeContext.h>
 #include <value/include/LLVMContext.h>
@@ -30,6 +31,8 @@
 
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -40,6 +43,78 @@ using namespace ell::emittable_functions;
 
 namespace ell
 {
+namespace
+{
+    struct EmittedCodeSize
+    {
+        size_t numInstructions;
+        size_t objectCodeBytes;
+        int64_t milliseconds;
+    };
+
+    // Emits the functions defined by `define` into a new module, and measures the IR and object code they produce
+    EmittedCodeSize MeasureEmittedCode(const std::string& moduleName, std::function<void()> define)
+    {
+        IRModuleEmitter module(moduleName, CompilerOptions{});
+        std::stringstream objectCode;
+        MillisecondTimer timer;
+        {
+            LLVMContext context(module);
+            ContextGuard guard(context);
+
+            define();
+            module.WriteToStream(objectCode, ModuleOutputFormat::objectCode);
+        }
+        auto milliseconds = timer.Elapsed();
+
+        size_t numInstructions = 0;
+        for (const auto& function : *module.GetLLVMModule())
+        {
+            for (const auto& block : function)
+            {
+                numInstructions += block.size();
+            }
+        }
+        auto objectCodeBytes = objectCode.str().size();
+
+        std::cout << moduleName << ": " << numInstructions << " instructions, " << objectCodeBytes << " bytes of object code, "
+                  << milliseconds << " ms" << std::endl;
+        return { numInstructions, objectCodeBytes, milliseconds };
+    }
+
+    EmittedCodeSize MeasureDepthwiseSeparableConvolve2D(int channels, int rows, int columns, int filterSize)
+    {
+        auto name = "DepthwiseSeparableConvolve2D_" + std::to_string(channels) + "x" + std::to_string(rows) + "x" + std::to_string(columns);
+        return MeasureEmittedCode(name, [=] {
+            DimensionOrder order(ChannelMajorTensorOrder);
+            DeclareFunction(name)
+                .Parameters(Value(ValueType::Double, MemoryLayout({ channels, rows, columns }, order)),
+                            Value(ValueType::Double, MemoryLayout({ channels, filterSize, filterSize }, order)),
+                            Value(ValueType::Int32, ScalarLayout),
+                            Value(ValueType::Int32, ScalarLayout),
+                            Value(ValueType::Double, MemoryLayout({ channels, rows - filterSize + 1, columns - filterSize + 1 }, order)))
+                .Define(SimpleDepthwiseSeparableConvolve2D);
+        });
+    }
+
+    EmittedCodeSize MeasureScale(int channels, int rows, int columns, int unrollFactor)
+    {
+        auto name = "Scale_" + std::to_string(channels) + "x" + std::to_string(rows) + "x" + std::to_string(columns) + "_unroll" + std::to_string(unrollFactor);
+        return MeasureEmittedCode(name, [=] {
+            MemoryLayout layout({ channels, rows, columns }, DimensionOrder(ChannelMajorTensorOrder));
+            DeclareFunction(name)
+                .Parameters(Value(ValueType::Float, layout))
+                .Define([layout, unrollFactor](Tensor data) {
+                    GetContext().For(
+                        layout,
+                        [&](std::vector<Scalar> coordinates) {
+                            data(coordinates[0], coordinates[1], coordinates[2]) *= Scalar(2.0f);
+                        },
+                        unrollFactor);
+                });
+        });
+    }
+} // namespace
 
 void test_simpleDepthwiseSeparableConvolve2D()
 {
@@ -79,4 +154,28 @@ void test_simpleDepthwiseSeparableConvolve2D()
     InvokeForContext<TestLLVMContext>(PrintIR);
 }
 
+// Compares the code emitted for a small tensor with the code emitted for a much larger one. Both use a 3x3 filter and
+// have more output columns than the vectorized block (8), which doesn't divide them, so they get the same schedule.
+// Loops are emitted rather than unrolled, so the size of the code doesn't grow with the tensors.
+void test_convolutionCodeSize()
+{
+    auto small = MeasureDepthwiseSeparableConvolve2D(3, 12, 12, 3);
+    auto large = MeasureDepthwiseSeparableConvolve2D(3, 224, 224, 3);
+
+    // The input at 3x224x224 has about 350 times as many elements as at 3x12x12, so code emitted per element would grow
+    // about that much
+    std::cout << "DepthwiseSeparableConvolve2D code size, 3x224x224 relative to 3x12x12: "
+              << static_cast<double>(large.numInstructions) / small.numInstructions << "x instructions, "
+              << static_cast<double>(large.objectCodeBytes) / small.objectCodeBytes << "x object code (vs. "
+              << (3.0 * 224 * 224) / (3.0 * 12 * 12) << "x elements)" << std::endl;
+    testing::ProcessTest("Testing DepthwiseSeparableConvolve2D code size is independent of tensor size",
+                         large.numInstructions <= 2 * small.numInstructions);
+
+    auto notUnrolled = MeasureScale(3, 224, 224, 1);
+    auto unrolled = MeasureScale(3, 224, 224, 4);
+    std::cout << "Scale 3x224x224 code size, unrolled by 4 relative to not unrolled: "
+              << static_cast<double>(unrolled.numInstructions) / notUnrolled.numInstructions << "x instructions" << std::endl;
+    testing::ProcessTest("Testing For unroll factor", notUnrolled.numInstructions < unrolled.numInstructions && unrolled.numInstructions <= 4 * notUnrolled.numInstructions);
+}
+
 } // namespace ell
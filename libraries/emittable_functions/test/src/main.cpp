@@ -46,6 +46,8 @@ int main(int argc, char* argv[])
 
             test_simpleDepthwiseSeparableConvolve2D();
         }
+
+        test_convolutionCodeSize();
     }
     catch (const Exception& exception)
     {
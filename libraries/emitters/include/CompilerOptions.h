@@ -34,11 +34,13 @@ namespace emitters
         bool useBlas = true;
         BlasType blasType = BlasType::unknown;
         bool profile = false;
+        bool trace = false;
+        int traceBufferSize = 16384; // the number of events the trace ring buffer holds, rounded up to a power of two
         bool optimize = true;
         bool includeDiagnosticInfo = false;
         bool parallelize = false;
         bool useThreadPool = true;
-        int maxThreads = 4;
+        int maxThreads = 0; // 0 means one thread per hardware thread on the host
         bool useFastMath = true;
         bool debug = false;
         utilities::Optional<bool> positionIndependentCode;
@@ -12,6 +12,7 @@
 #include <utilities/include/Exception.h>
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
 
 #include <functional>
@@ -52,6 +53,13 @@ namespace emitters
         /// <param name="pModule"> The module to add. </param>
         void AddModule(std::unique_ptr<llvm::Module> pModule);
 
+        /// <summary>
+        /// Set a cache for the object code generated for the modules. Must be called before any code is JITted.
+        /// </summary>
+        ///
+        /// <param name="objectCache"> The object cache. </param>
+        void SetObjectCache(std::unique_ptr<llvm::ObjectCache> objectCache);
+
         /// <summary>
         /// Return the address of a named function, JITTing code as needed. Returns 0 if not found.
         /// </summary>
@@ -124,6 +132,7 @@ namespace emitters
         void PerformFinalization();
 
         std::unique_ptr<llvm::EngineBuilder> _pBuilder;
+        std::unique_ptr<llvm::ObjectCache> _objectCache;
         std::unique_ptr<llvm::ExecutionEngine> _pEngine;
     };
 } // namespace emitters
@@ -979,6 +979,9 @@ namespace emitters
         using TiledMultiDimForLoopBodyFunction = std::function<void(emitters::IRFunctionEmitter& function, std::vector<BlockInterval> intervals)>;
         using ParallelForLoopBodyFunction = IRParallelForLoopEmitter::BodyFunction;
 
+        /// <summary> Type alias for elementwise loop body lambdas, which compute an output value from a value of each input. </summary>
+        using ElementwiseLoopBodyFunction = std::function<LLVMValue(IRFunctionEmitter& function, std::vector<IRLocalScalar> values)>;
+
         /// <summary> Type alias for while-loop body lambda. </summary>
         using WhileLoopBodyFunction = std::function<void(IRFunctionEmitter& function)>;
 
@@ -1027,6 +1030,27 @@ namespace emitters
         /// <param name="body"> A function that emits the body of the loop. </param>
         void For(LLVMValue beginValue, LLVMValue endValue, LLVMValue increment, ForLoopBodyFunction body);
 
+        /// <summary>
+        /// Emits a loop that computes each element of an output array from the corresponding elements of some input arrays.
+        /// If the compiler options allow vector instructions, the loop processes as many elements at a time as fit in a vector
+        /// register of the target device, so the body is passed vectors of values and must return a vector. The elements
+        /// left over at the end are processed by a masked vector operation for floating-point arrays and by a scalar loop
+        /// for integer arrays. Arrays that are aligned to the vector size are accessed with aligned loads and stores.
+        /// </summary>
+        ///
+        /// <param name="count"> The number of elements to compute. </param>
+        /// <param name="inputs"> Pointers to the input arrays. </param>
+        /// <param name="output"> Pointer to the output array. </param>
+        /// <param name="body"> A function that emits the computation of output values from input values. </param>
+        void ElementwiseFor(int count, const std::vector<LLVMValue>& inputs, LLVMValue output, ElementwiseLoopBodyFunction body);
+
+        /// <summary> Returns the number of elements of a type that elementwise loops process at a time. </summary>
+        ///
+        /// <param name="elementType"> The element type. </param>
+        ///
+        /// <returns> The number of elements in a vector of the type, or 1 if vector instructions aren't allowed or the type can't be vectorized. </returns>
+        int GetVectorSize(LLVMType elementType);
+
         //
         // Extended for loops
         //
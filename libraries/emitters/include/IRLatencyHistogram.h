@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLatencyHistogram.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "LLVMUtilities.h"
+
+#include <cstdint>
+
+// External API for profiling functions
+extern "C" {
+
+/// <summary>
+/// A struct that holds a histogram of the latencies of a profiled piece of code, in profiler ticks.
+/// Bucket `b` holds the samples `t` with `t == b` for `b < 4`. Above that, each power of two is split into 4 buckets:
+/// bucket `b` holds the samples in the range `[(4 + b % 4) << (b / 4 - 1), (5 + b % 4) << (b / 4 - 1))`.
+/// </summary>
+struct LatencyHistogram
+{
+    int64_t count;
+    int64_t minTicks;
+    int64_t maxTicks;
+    int64_t buckets[248];
+};
+}
+
+namespace ell
+{
+namespace emitters
+{
+    // import LatencyHistogram into this namespace
+    using ::LatencyHistogram;
+
+    class IRFunctionEmitter;
+    class IRModuleEmitter;
+
+    /// <summary> The number of buckets in a `LatencyHistogram`, which is enough to hold any non-negative 64-bit sample. </summary>
+    constexpr int numLatencyHistogramBuckets = 248;
+
+    /// <summary> Gets the LLVM type of the `LatencyHistogram` struct, creating it and adding it to the module header if necessary. </summary>
+    ///
+    /// <param name="module"> The module. </param>
+    ///
+    /// <returns> The struct type. </returns>
+    llvm::StructType* GetLatencyHistogramType(IRModuleEmitter& module);
+
+    /// <summary> Emits code that adds a sample to a latency histogram. </summary>
+    ///
+    /// <param name="function"> The function to emit the code into. </param>
+    /// <param name="histogramPtr"> A pointer to the histogram. </param>
+    /// <param name="elapsedTicks"> The sample, as a 64-bit number of ticks. Negative samples are recorded as 0. </param>
+    void AddLatencyHistogramSample(IRFunctionEmitter& function, LLVMValue histogramPtr, LLVMValue elapsedTicks);
+
+    /// <summary> Emits code that clears a latency histogram. </summary>
+    ///
+    /// <param name="function"> The function to emit the code into. </param>
+    /// <param name="histogramPtr"> A pointer to the histogram. </param>
+    void ResetLatencyHistogram(IRFunctionEmitter& function, LLVMValue histogramPtr);
+
+    /// <summary>
+    /// Gets the smallest sample that falls into a bucket of a latency histogram. The profile tool's ProfileReport.cpp has
+    /// a copy of this, for the compiled profiler that doesn't link this library.
+    /// </summary>
+    ///
+    /// <param name="bucket"> The index of the bucket. </param>
+    ///
+    /// <returns> The smallest sample, in ticks. </returns>
+    int64_t GetLatencyHistogramBucketLowerBound(int bucket);
+} // namespace emitters
+} // namespace ell
@@ -177,6 +177,10 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> = true>
     IRLocalScalar operator>=(IRLocalScalar a, ValueType b);
 
+    /// <summary> Returns a literal with the same shape as a value: a scalar, or a vector with every element equal to the literal if the value is a vector. </summary>
+    template <typename ValueType, utilities::IsFundamental<ValueType> = true>
+    IRLocalScalar LiteralLike(IRLocalScalar a, ValueType value);
+
     // Common math functions
     IRLocalScalar Abs(IRLocalScalar a);
     IRLocalScalar Sqrt(IRLocalScalar a);
@@ -221,6 +225,19 @@ namespace emitters
             return { function, GetEmitter(function).Literal(value) };
         }
 
+        // Returns a literal to combine with another value, broadcast to a vector if the other value is one
+        template <typename ValueType>
+        IRLocalScalar ToIRLocalScalar(const IRLocalScalar& other, ValueType value)
+        {
+            auto& emitter = GetEmitter(other.function);
+            LLVMValue literal = emitter.Literal(value);
+            if (auto vectorType = llvm::dyn_cast<llvm::VectorType>(other.value->getType()))
+            {
+                literal = emitter.GetIRBuilder().CreateVectorSplat(vectorType->getNumElements(), literal);
+            }
+            return { other.function, literal };
+        }
+
         template <typename ValueType, utilities::IsSignedIntegral<ValueType> = true>
         ValueType GetConstantIntValue(llvm::ConstantInt* intValue)
         {
@@ -265,7 +282,7 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator+(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a + b;
     }
 
@@ -278,21 +295,21 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator-(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a - b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator-(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a - b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator*(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a * b;
     }
 
@@ -305,35 +322,35 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator/(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a / b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator/(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a / b;
     }
 
     template <typename ValueType, utilities::IsIntegral<ValueType> /* = true*/>
     IRLocalScalar operator%(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a % b;
     }
 
     template <typename ValueType, utilities::IsIntegral<ValueType> /* = true*/>
     IRLocalScalar operator%(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a % b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator==(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a == b;
     }
 
@@ -346,7 +363,7 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator!=(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a != b;
     }
 
@@ -359,59 +376,65 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator<(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a < b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator<(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a < b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator<=(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a <= b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator<=(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a <= b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator>(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a > b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator>(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a > b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator>=(ValueType value, IRLocalScalar b)
     {
-        auto a = detail::ToIRLocalScalar(b.function, value);
+        auto a = detail::ToIRLocalScalar(b, value);
         return a >= b;
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar operator>=(IRLocalScalar a, ValueType value)
     {
-        auto b = detail::ToIRLocalScalar(a.function, value);
+        auto b = detail::ToIRLocalScalar(a, value);
         return a >= b;
     }
 
+    template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
+    IRLocalScalar LiteralLike(IRLocalScalar a, ValueType value)
+    {
+        return detail::ToIRLocalScalar(a, value);
+    }
+
     //
     // Math functions
     //
@@ -439,7 +462,7 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar Min(ValueType value, IRLocalScalar b)
     {
-        return Min(detail::ToIRLocalScalar(b.function, value), b);
+        return Min(detail::ToIRLocalScalar(b, value), b);
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
@@ -451,7 +474,7 @@ namespace emitters
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
     IRLocalScalar Max(ValueType value, IRLocalScalar b)
     {
-        return Max(detail::ToIRLocalScalar(b.function, value), b);
+        return Max(detail::ToIRLocalScalar(b, value), b);
     }
 
     template <typename ValueType, utilities::IsFundamental<ValueType> /* = true*/>
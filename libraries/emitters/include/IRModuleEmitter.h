@@ -15,6 +15,7 @@
 #include "IRProfiler.h"
 #include "IRRuntime.h"
 #include "IRThreadPool.h"
+#include "IRTracer.h"
 #include "LLVMUtilities.h"
 #include "ModuleEmitter.h"
 #include "ScalarVariable.h"
@@ -89,6 +90,16 @@ namespace emitters
         /// <returns> Reference to the `IRProfiler` object for this module. </returns>
         IRProfiler& GetProfiler() { return _profiler; }
 
+        /// <summary> Gets a reference to the tracer. </summary>
+        ///
+        /// <returns> Reference to the `IRTracer` object for this module. </returns>
+        IRTracer& GetTracer() { return _tracer; }
+
+        /// <summary> Gets a reference to the thread pool. Tasks are normally started with `IRFunctionEmitter::StartTasks`, which only uses the thread pool in parallelized modules. </summary>
+        ///
+        /// <returns> Reference to the `IRThreadPool` object for this module. </returns>
+        IRThreadPool& GetThreadPool() { return _threadPool; }
+
         /// <summary> Gets a reference to the underlying IREmitter. </summary>
         ///
         /// <returns> Reference to the underlying IREmitter. </returns>
@@ -192,6 +203,15 @@ namespace emitters
         /// <summary> Ensure that the given variable is loaded into a register. </summary>
         LLVMValue LoadVariable(Variable& var);
 
+        /// <summary> Emits a global vector variable as a view into part of an existing global buffer, instead of as its own global array. </summary>
+        ///
+        /// <param name="var"> The global vector variable to emit. </param>
+        /// <param name="buffer"> The global buffer that holds the variable's storage. </param>
+        /// <param name="byteOffset"> The offset, in bytes, of the variable's storage within the buffer. </param>
+        ///
+        /// <returns> A pointer to the first element of the variable's storage. </returns>
+        LLVMValue EmitGlobalVectorView(Variable& var, llvm::GlobalVariable* buffer, size_t byteOffset);
+
         //
         // Variable and Constant creation
         //
@@ -710,9 +730,6 @@ namespace emitters
         // Note: to insert well-known metadata, prefer the "IncludeInXXX" metadata methods.
         void InsertFunctionMetadata(LLVMFunction function, const std::string& tag, const std::vector<std::string>& value = { "" });
 
-        // Get a reference to the thread pool
-        IRThreadPool& GetThreadPool() { return _threadPool; }
-
         // Actual code output implementations
         void WriteHeader(std::ostream& stream);
         void WriteToLLVMStream(llvm::raw_ostream& stream, ModuleOutputFormat format, MachineCodeOutputOptions options);
@@ -746,6 +763,7 @@ namespace emitters
         IRRuntime _runtime; // Manages emission of runtime functions
         IRThreadPool _threadPool; // A pool of worker threads -- gets initialized the first time it's used (?)
         IRProfiler _profiler;
+        IRTracer _tracer;
         std::unique_ptr<llvm::Module> _pModule; // The LLVM Module being emitted
 
         // Info to modify how code is written out
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+#include <memory>
+#include <string>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary>
+    /// An on-disk cache of the object code the execution engine generates for a module. When the engine
+    /// finds a cached object it loads it instead of running code generation.
+    /// </summary>
+    class IRObjectCache : public llvm::ObjectCache
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="directory"> The directory holding cached object files. It is created if it doesn't exist. </param>
+        /// <param name="key"> The key identifying the module's object, which must change whenever the generated code would. </param>
+        /// <param name="storeObjects"> Indicates if newly-compiled objects should be written to the cache. </param>
+        IRObjectCache(const std::string& directory, const std::string& key, bool storeObjects = true);
+
+        /// <summary> Gets the path of the cached object file for this cache's key. </summary>
+        ///
+        /// <returns> The path of the object file, which may not exist yet. </returns>
+        std::string GetObjectPath() const;
+
+        /// <summary> Indicates if an object is cached for this cache's key. </summary>
+        ///
+        /// <returns> `true` if the object file exists. </returns>
+        bool HasObject() const;
+
+        /// <summary> Called by the execution engine after it compiles a module. Writes the object to the cache. </summary>
+        ///
+        /// <param name="module"> The module that was compiled. </param>
+        /// <param name="object"> The compiled object code. </param>
+        void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+        /// <summary> Called by the execution engine before it compiles a module. </summary>
+        ///
+        /// <param name="module"> The module about to be compiled. </param>
+        ///
+        /// <returns> The cached object code, or `nullptr` if there isn't any. </returns>
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+    private:
+        std::string _directory;
+        std::string _key;
+        bool _storeObjects;
+    };
+} // namespace emitters
+} // namespace ell
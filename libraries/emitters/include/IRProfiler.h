@@ -9,6 +9,7 @@
 #pragma once
 
 #include "EmitterTypes.h"
+#include "IRLatencyHistogram.h"
 #include "IRLocalScalar.h"
 #include "LLVMUtilities.h"
 
@@ -24,6 +25,7 @@ struct ProfileRegionInfo
     int64_t count;
     double totalTime;
     const char* name;
+    LatencyHistogram latency;
 };
 }
 
@@ -41,6 +43,8 @@ namespace emitters
     /// <summary>
     /// A class representing a function-scoped region to profile.
     /// Emitted code within this region will have its total runtime measured, and the total number of times run tallied.
+    /// The latency of each run is also added to a histogram, in profiler ticks.
+    /// If the module is traced, each run is also recorded as a trace event, whether or not profiling is enabled.
     /// </summary>
     class IRProfileRegion
     {
@@ -65,11 +69,16 @@ namespace emitters
         IRLocalScalar GetIndex() const { return _index; }
         IRLocalScalar GetStartTime() const { return _startTime; }
         void SetStartTime(const IRLocalScalar& time) { _startTime = time; }
+        IRLocalScalar GetStartTicks() const { return _startTicks; }
+        void SetStartTicks(const IRLocalScalar& ticks) { _startTicks = ticks; }
 
         IRFunctionEmitter& _function;
         IRProfiler& _profiler;
+        std::string _name;
         IRLocalScalar _index;
         IRLocalScalar _startTime;
+        IRLocalScalar _startTicks;
+        LLVMValue _traceBeginTicks = nullptr;
     };
 
     /// <summary>
@@ -126,12 +135,18 @@ namespace emitters
         /// <returns> The name of the emitted "ResetRegionProfilingInfo" function. </returns>
         std::string GetResetRegionProfilingInfoFunctionName() const;
 
+        /// <summary> Get the name of the emitted "GetProfilerTicksPerMillisecond" function, for converting latencies to time. </summary>
+        ///
+        /// <returns> The name of the emitted "GetProfilerTicksPerMillisecond" function. </returns>
+        std::string GetGetProfilerTicksPerMillisecondFunctionName() const;
+
     private:
         friend IRProfileRegion;
 
         std::string GetNamespacePrefix() const;
         llvm::StructType* GetRegionType() const;
         IRLocalScalar GetCurrentTime(IRFunctionEmitter& function);
+        IRLocalScalar GetProfilerTicks(IRFunctionEmitter& function);
 
         // Actual implementations of the functions in IRProfileRegion
         void InitRegion(IRProfileRegion& region, const std::string& desiredName);
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRReentrantState.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IRModuleEmitter.h"
+#include "LLVMUtilities.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary> Describes the per-instance state struct of a reentrant module. </summary>
+    struct ReentrantStateInfo
+    {
+        /// <summary> The number of module globals moved into the state struct. </summary>
+        size_t numGlobals = 0;
+
+        /// <summary> The size, in bytes, of the state struct. </summary>
+        size_t size = 0;
+
+        /// <summary> The alignment, in bytes, the state struct must have. </summary>
+        size_t alignment = 1;
+    };
+
+    /// <summary>
+    /// Makes a compiled module reentrant by moving all of its mutable internal globals (node state, port buffers,
+    /// and the callback context) into an opaque, caller-allocated state struct. Every function that touches that
+    /// state gets an extra leading `int8_t* state` argument, and the predict function's first argument becomes the
+    /// state pointer. The following functions are added to the module's public interface:
+    ///
+    ///   * `int64_t <ns>_GetStateSize()`
+    ///   * `int64_t <ns>_GetStateAlignment()`
+    ///   * `void <ns>_InitState(int8_t* state)` --- sets the state to its initial values
+    ///   * `void <ns>_SetStateContext(int8_t* state, int8_t* context)` --- sets the context passed to callbacks
+    ///
+    /// This must be called after all functions in the module have been emitted.
+    /// </summary>
+    ///
+    /// <param name="module"> The module being emitted. </param>
+    /// <param name="predictFunction"> The module's predict function. Its first argument must be a byte pointer. </param>
+    ///
+    /// <returns> A description of the state struct. </returns>
+    ReentrantStateInfo EmitReentrantState(IRModuleEmitter& module, LLVMFunction predictFunction);
+
+    /// <summary>
+    /// Makes a compiled module reentrant, as above, for a module with several entry points that take the state as their
+    /// first argument (e.g., predict and batch predict). The first argument of each entry point becomes the state pointer.
+    /// </summary>
+    ///
+    /// <param name="module"> The module being emitted. </param>
+    /// <param name="entryFunctions"> The module's entry points, starting with the predict function. The first argument of each must be a byte pointer. </param>
+    ///
+    /// <returns> A description of the state struct. </returns>
+    ReentrantStateInfo EmitReentrantState(IRModuleEmitter& module, const std::vector<LLVMFunction>& entryFunctions);
+} // namespace emitters
+} // namespace ell
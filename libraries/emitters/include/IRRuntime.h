@@ -30,6 +30,28 @@ namespace emitters
         //
         LLVMValue GetCurrentTime(IRFunctionEmitter& function);
 
+        /// <summary> Indicates if the profiler's ticks come from the target's cycle counter. </summary>
+        ///
+        /// <returns> true if the target has a cycle counter that can be read from user code, false if the ticks are nanoseconds. </returns>
+        bool HasCycleCounter() const;
+
+        /// <summary> Emits code that reads the profiler's high-resolution counter. </summary>
+        ///
+        /// <param name="function"> The function to emit the code into. </param>
+        ///
+        /// <returns> A 64-bit integer containing the current tick count. This is the cycle counter on targets that have one,
+        /// and the time in nanoseconds from `clock_gettime` otherwise. </returns>
+        LLVMValue GetProfilerTicks(IRFunctionEmitter& function);
+
+        /// <summary>
+        /// Get the function that returns the number of profiler ticks per millisecond, emitting it into the module header
+        /// if necessary. On targets with a cycle counter the rate is measured against the clock each time the function is
+        /// called, which takes about 10 ms.
+        /// </summary>
+        ///
+        /// <returns> An LLVM function pointer to the function. </returns>
+        LLVMFunction GetProfilerTicksPerMillisecondFunction();
+
         //
         // Standard math functions
         //
@@ -183,6 +205,7 @@ namespace emitters
         LLVMFunction _dotProductFunctionFloat = nullptr;
         LLVMFunction _dotProductFunction = nullptr;
         LLVMFunction _getCurrentTimeFunction = nullptr;
+        LLVMFunction _getProfilerTicksPerMillisecondFunction = nullptr;
         LLVMFunction _stringCompareFunction = nullptr;
     };
 } // namespace emitters
@@ -127,7 +127,12 @@ namespace emitters
     // IRThreadPoolTaskQueue
     //
 
-    /// <summary> Class representing a queue of tasks to be scheduled and run. </summary>
+    /// <summary>
+    /// Class representing the queue of tasks to be scheduled and run. Each worker thread owns a contiguous range
+    /// of the current task array, packed into one 64-bit word, and takes tasks from the front of it with an atomic
+    /// compare-and-swap. A worker whose range is empty steals single tasks from the back of the others' ranges.
+    /// Idle workers spin for a while before parking on a condition variable, so the mutex is only used for parking.
+    /// </summary>
     class IRThreadPoolTaskQueue
     {
     public:
@@ -140,14 +145,26 @@ namespace emitters
         /// <returns> A task array object representing the running tasks. </param>
         IRThreadPoolTaskArray& StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments);
 
-        /// <summary> Pop a task off the task queue, waiting for one to become available if necessary. </summary>
+        /// <summary> Take a task from a worker's range, stealing from the other workers if it is empty. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="workerIndex"> The index of the worker taking the task, or the number of workers for the thread that started the tasks. </param>
         ///
-        /// <returns> The next task in the queue. </param>
-        IRThreadPoolTask PopNextTask(IRFunctionEmitter& function);
+        /// <returns> The task, or a null task if there are no tasks left to take. </param>
+        IRThreadPoolTask TakeTask(IRFunctionEmitter& function, LLVMValue workerIndex);
 
-        /// <summary> Wait for all tasks to finish. </summary>
+        /// <summary> Record that a task has finished, waking the thread waiting for the tasks if it was the last one. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        void FinishTask(IRFunctionEmitter& function);
+
+        /// <summary> Wait until new tasks are started or the pool shuts down, spinning before parking the thread. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="lastGeneration"> The task generation the worker last looked for tasks in. </param>
+        void WaitForTasks(IRFunctionEmitter& function, LLVMValue lastGeneration);
+
+        /// <summary> Wait for all tasks to finish, running unstarted tasks on the calling thread. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
         void WaitAll(IRFunctionEmitter& function);
@@ -160,27 +177,23 @@ namespace emitters
     private:
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
-        void Initialize(IRFunctionEmitter& function); // initializes the task array
+        void Initialize(IRFunctionEmitter& function, size_t numWorkers); // initializes the task array
         LLVMValue GetDataStruct() { return _queueData; }
-        LLVMValue DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module) const;
+        LLVMFunction GetTakeTaskFunction(IRModuleEmitter& module);
 
         // Accessors for fields
         LLVMValue GetQueueMutexPointer(IRFunctionEmitter& function);
         LLVMValue GetWorkAvailableConditionVariablePointer(IRFunctionEmitter& function);
         LLVMValue GetWorkFinishedConditionVariablePointer(IRFunctionEmitter& function);
-        LLVMValue GetUnscheduledCount(IRFunctionEmitter& function) const;
-        LLVMValue GetUnfinishedCount(IRFunctionEmitter& function) const;
+        LLVMValue GetFieldPointer(IRFunctionEmitter& function, int field) const;
+        LLVMValue GetRangePointer(IRFunctionEmitter& function, LLVMValue workerIndex) const;
+        LLVMValue GetGeneration(IRFunctionEmitter& function) const;
         void SetShutdownFlag(IRFunctionEmitter& function);
         LLVMValue GetShutdownFlag(IRFunctionEmitter& function) const;
-        void SetInitialCount(IRFunctionEmitter& function, LLVMValue newValue);
-        LLVMValue DecrementUnscheduledTasks(IRFunctionEmitter& function);
-        LLVMValue DecrementUnfinishedTasks(IRFunctionEmitter& function);
-        LLVMValue IsEmpty(IRFunctionEmitter& function) const;
         LLVMValue IsFinished(IRFunctionEmitter& function) const;
 
         bool IsInitialized() const;
-        void NotifyWaitingClients(IRFunctionEmitter& function);
         void LockQueueMutex(IRFunctionEmitter& function);
         void UnlockQueueMutex(IRFunctionEmitter& function);
         void ShutDown(IRFunctionEmitter& function);
@@ -190,11 +203,15 @@ namespace emitters
             queueMutex = 0,
             workAvailableCondVar,
             workFinishedCondVar,
-            unscheduledCount,
             unfinishedCount,
-            shutdownFlag
+            shutdownFlag,
+            generation, // incremented each time tasks are started, so idle workers know to look for them
+            numParked // the number of workers waiting on the work-available condition variable
         };
         LLVMValue _queueData = nullptr; // a struct with the above fields
+        llvm::GlobalVariable* _ranges = nullptr; // one packed [begin, end) task range per worker, each on its own cache line
+        LLVMFunction _takeTaskFunction = nullptr;
+        size_t _numWorkers = 0;
         IRThreadPoolTaskArray _tasks;
     };
 
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRTracer.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "LLVMUtilities.h"
+
+#include <cstdint>
+#include <string>
+
+// External API for tracing functions
+extern "C" {
+
+/// <summary> A struct that holds one event recorded by a traced module: a span of time spent running a piece of code. </summary>
+struct TraceEvent
+{
+    int64_t beginTicks;
+    int64_t endTicks;
+    int64_t threadId;
+    const char* name;
+    int32_t category;
+};
+}
+
+namespace ell
+{
+namespace emitters
+{
+    // import TraceEvent into this namespace
+    using ::TraceEvent;
+
+    class IRFunctionEmitter;
+    class IRModuleEmitter;
+
+    /// <summary> The kind of code a trace event covers, stored in the `category` field of `TraceEvent`. </summary>
+    enum class TraceEventCategory
+    {
+        node = 0,
+        task = 1,
+        region = 2
+    };
+
+    /// <summary>
+    /// A class that manages trace code generation. A traced module records a `TraceEvent` for every traced span of code it
+    /// runs into a ring buffer that is allocated when the module is compiled, so recording an event is a few stores and an
+    /// atomic increment. Once the buffer is full, new events overwrite the oldest ones. Timestamps are in profiler ticks.
+    /// </summary>
+    class IRTracer
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="module"> The `IRModuleEmitter` to compile the trace buffer into. </param>
+        /// <param name="enableTracing"> Indicates whether tracing should be enabled. </param>
+        /// <param name="bufferSize"> The number of events the trace buffer holds. It's rounded up to a power of two. </param>
+        IRTracer(IRModuleEmitter& module, bool enableTracing, int bufferSize);
+
+        /// <summary>
+        /// Emit the trace buffer and the functions to read it. Called by the IRModuleEmitter that owns this tracer.
+        /// </summary>
+        void Init();
+
+        /// <summary> Indicates whether tracing is enabled. </summary>
+        ///
+        /// <returns> `true` if the module records trace events. </returns>
+        bool IsEnabled() const { return _tracingEnabled; }
+
+        /// <summary> Get the number of events the trace buffer holds. </summary>
+        ///
+        /// <returns> The size of the trace buffer, in events. </returns>
+        int GetBufferSize() const { return _bufferSize; }
+
+        /// <summary> Emits code that starts timing a trace event. </summary>
+        ///
+        /// <param name="function"> The function to emit the code into. </param>
+        ///
+        /// <returns> The start time of the event, to pass to `EndEvent`, or null if tracing is disabled. </returns>
+        LLVMValue BeginEvent(IRFunctionEmitter& function);
+
+        /// <summary> Emits code that records a trace event that started at the time returned by `BeginEvent`. </summary>
+        ///
+        /// <param name="function"> The function to emit the code into. </param>
+        /// <param name="beginTicks"> The value returned by `BeginEvent`. </param>
+        /// <param name="name"> The name of the event. </param>
+        /// <param name="category"> The kind of code the event covers. </param>
+        void EndEvent(IRFunctionEmitter& function, LLVMValue beginTicks, const std::string& name, TraceEventCategory category);
+
+        /// <summary> Get the name of the emitted "GetTraceEvents" function. </summary>
+        ///
+        /// <returns> The name of the emitted "GetTraceEvents" function. </returns>
+        std::string GetGetTraceEventsFunctionName() const;
+
+        /// <summary> Get the name of the emitted "GetTraceBufferSize" function. </summary>
+        ///
+        /// <returns> The name of the emitted "GetTraceBufferSize" function. </returns>
+        std::string GetGetTraceBufferSizeFunctionName() const;
+
+        /// <summary> Get the name of the emitted "GetNumTraceEvents" function, which counts the events recorded, including overwritten ones. </summary>
+        ///
+        /// <returns> The name of the emitted "GetNumTraceEvents" function. </returns>
+        std::string GetGetNumTraceEventsFunctionName() const;
+
+        /// <summary> Get the name of the emitted "ResetTrace" function. </summary>
+        ///
+        /// <returns> The name of the emitted "ResetTrace" function. </returns>
+        std::string GetResetTraceFunctionName() const;
+
+    private:
+        std::string GetNamespacePrefix() const;
+        LLVMValue GetThreadId(IRFunctionEmitter& function);
+
+        void CreateStructTypes();
+        void CreateTraceData();
+        void EmitGetTraceEventsFunction();
+        void EmitGetTraceBufferSizeFunction();
+        void EmitGetNumTraceEventsFunction();
+        void EmitResetTraceFunction();
+
+        IRModuleEmitter* _module = nullptr;
+        bool _tracingEnabled = false;
+        int _bufferSize = 0;
+
+        llvm::StructType* _traceEventType = nullptr;
+        llvm::GlobalVariable* _traceEventsArray = nullptr;
+        llvm::GlobalVariable* _traceEventCount = nullptr;
+    };
+} // namespace emitters
+} // namespace ell
@@ -39,6 +39,15 @@ namespace emitters
     template <typename ValueType, utilities::IsFloatingPoint<ValueType> = true>
     LLVMValue FillVector(IRFunctionEmitter& function, llvm::VectorType* type, ValueType elementValue);
 
+    /// <summary> Create a vector filled with copies of a scalar value, with as many elements as another vector </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="value"> The scalar value to place in the vector elements </param>
+    /// <param name="like"> A value of the result's shape. If it is a scalar, the result is the value itself. </param>
+    ///
+    /// <returns> An LLVM vector with repeated entries of the value, or the value if `like` is a scalar </returns>
+    LLVMValue BroadcastLike(IRFunctionEmitter& function, LLVMValue value, LLVMValue like);
+
     /// <summary> Compute the sum of the entries in a vector </summary>
     ///
     /// Emits explicit vector code to compute the sum. Hopefully, the vecorizing optimizer will
@@ -72,6 +81,16 @@ namespace emitters
         return llvm::ConstantInt::get(type, elementValue, true);
     }
 
+    inline LLVMValue BroadcastLike(IRFunctionEmitter& function, LLVMValue value, LLVMValue like)
+    {
+        auto vectorType = llvm::dyn_cast<llvm::VectorType>(like->getType());
+        if (vectorType == nullptr)
+        {
+            return value;
+        }
+        return function.GetEmitter().GetIRBuilder().CreateVectorSplat(vectorType->getNumElements(), value);
+    }
+
     // Emit explicit vectorized code to compute the sum of all the elements in a vector.
     // Hopefully, the vecorizing optimizer will take care of this when vecorizing simple
     // loops to sum up values, but for other operations we may want to do it ourselves.
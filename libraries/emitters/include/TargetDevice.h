@@ -24,6 +24,7 @@ namespace emitters
         std::string cpu = "";
         std::string features = "";
         size_t numBits = 0;
+        size_t vectorBits = 0; // the width of the device's vector registers, or 0 if it isn't known
 
         /// <summary> Indicates if the target device is a Windows system </summary>
         bool IsWindows() const;
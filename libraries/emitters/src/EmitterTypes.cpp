@@ -189,6 +189,18 @@ namespace emitters
         return VariableType::BytePointer;
     }
 
+    template <>
+    VariableType GetVariableType<int8_t>()
+    {
+        return VariableType::Char8;
+    }
+
+    template <>
+    VariableType GetVariableType<int8_t*>()
+    {
+        return VariableType::Char8Pointer;
+    }
+
     template <>
     VariableType GetVariableType<uint8_t>()
     {
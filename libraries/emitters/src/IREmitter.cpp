@@ -287,41 +287,49 @@ namespace emitters
         auto inputType = pValue->getType();
         auto bitType = llvm::Type::getInt1Ty(_llvmContext);
 
+        // Vectors are cast elementwise, to a vector of the destination type
+        if (inputType->isVectorTy() && !destinationType->isVectorTy())
+        {
+            destinationType = llvm::VectorType::get(destinationType, inputType->getVectorNumElements());
+        }
+        auto inputElementType = inputType->getScalarType();
+        auto destinationElementType = destinationType->getScalarType();
+
         // Boolean
         if (destinationType == bitType)
         {
             return CastToConditionalBool(pValue);
         }
 
-        if (inputType == bitType)
+        if (inputElementType == bitType)
         {
-            if (destinationType->isIntegerTy())
+            if (destinationElementType->isIntegerTy())
             {
                 return CastInt(pValue, destinationType, false);
             }
-            else if (destinationType->isFloatingPointTy())
+            else if (destinationElementType->isFloatingPointTy())
             {
                 return CastIntToFloat(pValue, destinationType, false);
             }
         }
-        else if (inputType->isIntegerTy())
+        else if (inputElementType->isIntegerTy())
         {
-            if (destinationType->isIntegerTy())
+            if (destinationElementType->isIntegerTy())
             {
                 return CastInt(pValue, destinationType, true);
             }
-            else if (destinationType->isFloatingPointTy())
+            else if (destinationElementType->isFloatingPointTy())
             {
                 return CastIntToFloat(pValue, destinationType, true);
             }
         }
-        else if (inputType->isFloatingPointTy())
+        else if (inputElementType->isFloatingPointTy())
         {
-            if (destinationType->isIntegerTy())
+            if (destinationElementType->isIntegerTy())
             {
                 return CastFloatToInt(pValue, destinationType, true);
             }
-            else if (destinationType->isFloatingPointTy())
+            else if (destinationElementType->isFloatingPointTy())
             {
                 return CastFloat(pValue, destinationType);
             }
@@ -61,6 +61,15 @@ namespace emitters
         _pEngine->addModule(std::move(pModule));
     }
 
+    void IRExecutionEngine::SetObjectCache(std::unique_ptr<llvm::ObjectCache> objectCache)
+    {
+        if (_pEngine)
+        {
+            throw EmitterException(EmitterError::unexpected, "The object cache must be set before the execution engine is created");
+        }
+        _objectCache = std::move(objectCache);
+    }
+
     void IRExecutionEngine::PerformInitialization()
     {
         _pEngine->runStaticConstructorsDestructors(false);
@@ -127,6 +136,11 @@ namespace emitters
         {
             auto pEngine = _pBuilder->create();
             _pEngine.reset(pEngine);
+            if (_objectCache)
+            {
+                // MCJIT consults the cache when it finalizes a module, which happens no earlier than the static constructors run
+                _pEngine->setObjectCache(_objectCache.get());
+            }
             PerformInitialization();
         }
     }
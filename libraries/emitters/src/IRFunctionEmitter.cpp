@@ -22,6 +22,9 @@
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/raw_os_ostream.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace ell
 {
 namespace emitters
@@ -36,6 +39,77 @@ namespace emitters
     // Internal codes
     namespace
     {
+        // Returns a pointer to the first element of an array, given a pointer to the array or to its first element
+        LLVMValue GetElementPointer(IRFunctionEmitter& function, LLVMValue pointer)
+        {
+            auto pointedType = pointer->getType()->getPointerElementType();
+            if (pointedType->isArrayTy())
+            {
+                auto dereferencedPointer = function.GetEmitter().DereferenceGlobalPointer(pointer);
+                return function.CastPointer(dereferencedPointer, pointedType->getArrayElementType()->getPointerTo());
+            }
+            return pointer;
+        }
+
+        // Returns the alignment of vector loads and stores at multiples of the vector size from the start of an array: the
+        // vector size if the array is a global or stack variable aligned to it, and the element size otherwise
+        unsigned GetVectorAlignment(LLVMValue pointer, llvm::VectorType* vectorType)
+        {
+            const unsigned vectorBytes = vectorType->getBitWidth() / 8;
+            const unsigned elementBytes = vectorType->getScalarSizeInBits() / 8;
+            unsigned alignment = 0;
+            auto base = pointer->stripPointerCasts();
+            if (auto global = llvm::dyn_cast<llvm::GlobalVariable>(base))
+            {
+                alignment = global->getAlignment();
+            }
+            else if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(base))
+            {
+                alignment = alloca->getAlignment();
+            }
+            return (llvm::isPowerOf2_32(vectorBytes) && alignment >= vectorBytes && alignment % vectorBytes == 0) ? vectorBytes : elementBytes;
+        }
+
+        // An array accessed by an elementwise loop
+        struct ElementwiseArray
+        {
+            LLVMValue elementPointer;
+            llvm::VectorType* vectorType;
+            unsigned alignment;
+        };
+
+        ElementwiseArray GetElementwiseArray(IRFunctionEmitter& function, LLVMValue pointer, int vectorSize)
+        {
+            auto elementPointer = GetElementPointer(function, pointer);
+            auto vectorType = llvm::VectorType::get(elementPointer->getType()->getPointerElementType(), vectorSize);
+            return { elementPointer, vectorType, GetVectorAlignment(pointer, vectorType) };
+        }
+
+        LLVMValue LoadVector(IRFunctionEmitter& function, const ElementwiseArray& array, LLVMValue offset, llvm::Constant* mask)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto vectorPointer = function.CastPointer(function.PointerOffset(array.elementPointer, offset), array.vectorType->getPointerTo());
+            if (mask == nullptr)
+            {
+                return irBuilder.CreateAlignedLoad(vectorPointer, array.alignment);
+            }
+            return irBuilder.CreateMaskedLoad(vectorPointer, array.alignment, mask, llvm::Constant::getNullValue(array.vectorType));
+        }
+
+        void StoreVector(IRFunctionEmitter& function, const ElementwiseArray& array, LLVMValue offset, LLVMValue value, llvm::Constant* mask)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto vectorPointer = function.CastPointer(function.PointerOffset(array.elementPointer, offset), array.vectorType->getPointerTo());
+            if (mask == nullptr)
+            {
+                irBuilder.CreateAlignedStore(value, vectorPointer, array.alignment);
+            }
+            else
+            {
+                irBuilder.CreateMaskedStore(value, vectorPointer, array.alignment, mask);
+            }
+        }
+
         // Helper function for recursive function
         void MultiDimFor(IRFunctionEmitter& function, std::vector<IRFunctionEmitter::ConstLoopRange> ranges, std::vector<IRLocalScalar> prevIndices, IRFunctionEmitter::MultiDimForLoopBodyFunction body)
         {
@@ -1041,6 +1115,115 @@ namespace emitters
     // Extended for loops
     //
 
+    void IRFunctionEmitter::ElementwiseFor(int count, const std::vector<LLVMValue>& inputs, LLVMValue output, ElementwiseLoopBodyFunction body)
+    {
+        if (count < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "For loop count must be >= 0");
+        }
+
+        // A vector holds as many elements of the widest type as fit in a vector register
+        std::vector<LLVMValue> pointers(inputs);
+        pointers.push_back(output);
+        int vectorSize = std::numeric_limits<int>::max();
+        bool isFloatingPoint = true;
+        for (auto pointer : pointers)
+        {
+            auto elementType = GetElementPointer(*this, pointer)->getType()->getPointerElementType();
+            vectorSize = std::min(vectorSize, GetVectorSize(elementType));
+            isFloatingPoint = isFloatingPoint && elementType->isFloatingPointTy();
+        }
+
+        auto scalarLoop = [&](int begin, int end) {
+            if (begin >= end)
+            {
+                return;
+            }
+            std::vector<LLVMValue> inputPointers;
+            for (auto input : inputs)
+            {
+                inputPointers.push_back(GetElementPointer(*this, input));
+            }
+            auto outputPointer = GetElementPointer(*this, output);
+            For(begin, end, [&](IRFunctionEmitter& function, IRLocalScalar index) {
+                std::vector<IRLocalScalar> values;
+                for (auto pointer : inputPointers)
+                {
+                    values.push_back(function.LocalScalar(function.ValueAt(pointer, index)));
+                }
+                function.SetValueAt(outputPointer, index, body(function, values));
+            });
+        };
+
+        const int numVectors = vectorSize > 1 ? count / vectorSize : 0;
+        if (numVectors == 0)
+        {
+            scalarLoop(0, count);
+            return;
+        }
+
+        std::vector<ElementwiseArray> inputArrays;
+        for (auto input : inputs)
+        {
+            inputArrays.push_back(GetElementwiseArray(*this, input, vectorSize));
+        }
+        auto outputArray = GetElementwiseArray(*this, output, vectorSize);
+        For(numVectors, [&](IRFunctionEmitter& function, IRLocalScalar vectorIndex) {
+            auto offset = vectorIndex * vectorSize;
+            std::vector<IRLocalScalar> values;
+            for (const auto& array : inputArrays)
+            {
+                values.push_back(function.LocalScalar(LoadVector(function, array, offset, nullptr)));
+            }
+            StoreVector(function, outputArray, offset, body(function, values), nullptr);
+        });
+
+        // Compute the leftover elements with one masked vector operation, which only touches the elements that are in
+        // the arrays. Integer operations can trap on the masked-off values (e.g., division by zero), so they use a scalar loop.
+        const int remainderBegin = numVectors * vectorSize;
+        if (remainderBegin == count)
+        {
+            return;
+        }
+        if (!isFloatingPoint)
+        {
+            scalarLoop(remainderBegin, count);
+            return;
+        }
+
+        std::vector<llvm::Constant*> maskBits;
+        for (int index = 0; index < vectorSize; ++index)
+        {
+            maskBits.push_back(index < count - remainderBegin ? llvm::ConstantInt::getTrue(GetLLVMContext()) : llvm::ConstantInt::getFalse(GetLLVMContext()));
+        }
+        auto mask = llvm::ConstantVector::get(maskBits);
+        auto offset = Literal(remainderBegin);
+        std::vector<IRLocalScalar> values;
+        for (const auto& array : inputArrays)
+        {
+            values.push_back(LocalScalar(LoadVector(*this, array, offset, mask)));
+        }
+        StoreVector(*this, outputArray, offset, body(*this, values), mask);
+    }
+
+    int IRFunctionEmitter::GetVectorSize(LLVMType elementType)
+    {
+        const auto& options = GetModule().GetCompilerOptions();
+        const bool isVectorizable = (elementType->isFloatingPointTy() || elementType->isIntegerTy()) && !elementType->isIntegerTy(1);
+        if (!options.allowVectorInstructions || !isVectorizable)
+        {
+            return 1;
+        }
+
+        // Use the target's vector register width if it's known, and the vector width from the options otherwise
+        const auto vectorBits = options.targetDevice.vectorBits;
+        if (vectorBits > 0)
+        {
+            return std::max(static_cast<int>(vectorBits / elementType->getPrimitiveSizeInBits()), 1);
+        }
+        return std::max(options.vectorWidth, 1);
+    }
+
     void IRFunctionEmitter::For(const std::vector<ConstLoopRange>& ranges, MultiDimForLoopBodyFunction body)
     {
         emitters::MultiDimFor(*this, ranges, {}, body);
@@ -20,8 +20,10 @@
 #include <utilities/include/Debug.h>
 #include <utilities/include/StringUtil.h>
 
+#include <functional>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace ell
@@ -268,24 +270,44 @@ namespace emitters
                 {
                     auto typeNames = GetSingletonModuleTagValues(moduleEmitter, c_declareTypeInHeaderTagName);
 
-                    auto structTypes = pModule->getIdentifiedStructTypes();
-                    for (const auto& t : structTypes)
-                    {
-                        if (t->hasName() && (typeNames.cend() != typeNames.find(t->getName())))
+                    std::unordered_set<llvm::StructType*> writtenTypes;
+                    std::function<void(llvm::StructType*)> writeStructType = [&](llvm::StructType* t) {
+                        if (!t->hasName() || (typeNames.cend() == typeNames.find(t->getName())) || !writtenTypes.insert(t).second)
+                        {
+                            return;
+                        }
+
+                        // Structs used as fields must be defined first
+                        for (auto fieldType : t->elements())
+                        {
+                            while (fieldType->isArrayTy())
+                            {
+                                fieldType = fieldType->getArrayElementType();
+                            }
+                            if (fieldType->isStructTy())
+                            {
+                                writeStructType(llvm::cast<llvm::StructType>(fieldType));
+                            }
+                        }
+
+                        // Get struct field names
+                        auto tagName = GetStructFieldsTagName(t);
+                        std::vector<std::string> fieldNames;
+                        if (moduleEmitter.HasMetadata(tagName))
                         {
-                            // Get struct field names
-                            auto tagName = GetStructFieldsTagName(t);
-                            std::vector<std::string> fieldNames;
-                            if (moduleEmitter.HasMetadata(tagName))
+                            auto fieldNameMetadata = moduleEmitter.GetMetadata(tagName);
+                            if (!fieldNameMetadata.empty())
                             {
-                                auto fieldNameMetadata = moduleEmitter.GetMetadata(tagName);
-                                if (!fieldNameMetadata.empty())
-                                {
-                                    fieldNames = fieldNameMetadata[0];
-                                }
+                                fieldNames = fieldNameMetadata[0];
                             }
-                            WriteStructDefinition(os, t, fieldNames);
                         }
+                        WriteStructDefinition(os, t, fieldNames);
+                    };
+
+                    auto structTypes = pModule->getIdentifiedStructTypes();
+                    for (const auto& t : structTypes)
+                    {
+                        writeStructType(t);
                     }
                 }
             }
@@ -328,6 +350,7 @@ namespace emitters
         std::string predictMethodName;
         std::string predictReturnType;
         std::string predictReturnMember;
+        std::string predictContextArg = "this";
         std::vector<std::string> predictMethodArgs;
         std::vector<std::string> predictCallArgs;
         std::stringstream constructorInit;
@@ -488,11 +511,12 @@ namespace emitters
         for (auto arg = predictFunction->arg_begin(), end = predictFunction->arg_end(); arg != end; ++arg)
         {
             std::string argName = arg->getName();
-            if (argName == "context")
+            if (argName == "context" || argName == "state")
             {
                 // we really want void* on these puppies, but LLVM won't let us...(which is why the argType is int8_t*,
                 // and for our wrapper class, the context will be 'this' so the "C" callbacks can find this object.
-                info.predictCallArgs.push_back("this");
+                // Reentrant modules take the state buffer here instead, and the context is stored in the state.
+                info.predictCallArgs.push_back(info.predictContextArg);
             }
             else
             {
@@ -546,7 +570,7 @@ namespace emitters
             info.helperMethods << "    {\n";
             info.helperMethods << info.predictPreBody.str();
             info.helperMethods << "        double time = _timer.GetMilliseconds();\n";
-            info.helperMethods << "        " << info.predictFunctionName << "(this, &time, nullptr);\n";
+            info.helperMethods << "        " << info.predictFunctionName << "(" << info.predictContextArg << ", &time, nullptr);\n";
             info.helperMethods << info.predictPostBody.str();
             if (info.predictReturnType != "void")
             {
@@ -605,6 +629,21 @@ namespace emitters
 
         bool hasSourceNodes = !moduleCallbacks.sources.empty();
 
+        // Reentrant modules keep their state in a buffer owned by the wrapper
+        bool isReentrant = moduleEmitter.GetFunction(moduleName + "_GetStateSize") != nullptr;
+        if (isReentrant)
+        {
+            info.predictContextArg = "_state";
+            info.constructorInit << "        auto stateAlignment = static_cast<uintptr_t>(" << moduleName << "_GetStateAlignment());\n";
+            info.constructorInit << "        _stateBuffer.resize(" << moduleName << "_GetStateSize() + stateAlignment);\n";
+            info.constructorInit << "        auto stateAddress = reinterpret_cast<uintptr_t>(_stateBuffer.data());\n";
+            info.constructorInit << "        _state = reinterpret_cast<void*>((stateAddress + stateAlignment - 1) & ~(stateAlignment - 1));\n";
+            info.constructorInit << "        " << moduleName << "_InitState(_state);\n";
+            info.constructorInit << "        " << moduleName << "_SetStateContext(_state, this);\n";
+            info.memberDecls << "    std::vector<uint8_t> _stateBuffer;\n";
+            info.memberDecls << "    void* _state = nullptr;\n";
+        }
+
         if (!hasSourceNodes)
         {
             WriteSimplePredictMethod(predictFunction, info);
@@ -639,6 +678,7 @@ namespace emitters
         ReplaceDelimiter(predictWrapperCode, "CDECLS_IMPL", info.cdecls.str());
         ReplaceDelimiter(predictWrapperCode, "STEPPABLE", hasSourceNodes ? "true" : "false");
         ReplaceDelimiter(predictWrapperCode, "RESET_BODY", info.resetMethodBody.str());
+        ReplaceDelimiter(predictWrapperCode, "RESET_ARGS", isReentrant ? "_state" : "");
 
         os << predictWrapperCode;
     }
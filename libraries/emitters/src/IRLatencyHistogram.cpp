@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLatencyHistogram.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRLatencyHistogram.h"
+#include "IRFunctionEmitter.h"
+#include "IRLocalScalar.h"
+#include "IRModuleEmitter.h"
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        enum class LatencyHistogramFields
+        {
+            count = 0,
+            minTicks = 1,
+            maxTicks = 2,
+            buckets = 3
+        };
+
+        static_assert(sizeof(LatencyHistogram::buckets) / sizeof(int64_t) == numLatencyHistogramBuckets, "LatencyHistogram has the wrong number of buckets");
+
+        // The number of buckets each power of two is split into
+        const int64_t subBucketsPerOctave = 4;
+    } // namespace
+
+    llvm::StructType* GetLatencyHistogramType(IRModuleEmitter& module)
+    {
+        auto& context = module.GetLLVMContext();
+        auto int64Type = llvm::Type::getInt64Ty(context);
+        auto bucketsType = llvm::ArrayType::get(int64Type, numLatencyHistogramBuckets);
+
+        NamedLLVMTypeList fields = { { "count", int64Type }, { "minTicks", int64Type }, { "maxTicks", int64Type }, { "buckets", bucketsType } };
+        auto type = module.GetOrCreateStruct(module.GetModuleName() + "_LatencyHistogram", fields);
+        module.IncludeTypeInHeader(type->getName());
+        return type;
+    }
+
+    void AddLatencyHistogramSample(IRFunctionEmitter& function, LLVMValue histogramPtr, LLVMValue elapsedTicks)
+    {
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto countPtr = function.GetStructFieldPointer(histogramPtr, static_cast<size_t>(LatencyHistogramFields::count));
+        auto minPtr = function.GetStructFieldPointer(histogramPtr, static_cast<size_t>(LatencyHistogramFields::minTicks));
+        auto maxPtr = function.GetStructFieldPointer(histogramPtr, static_cast<size_t>(LatencyHistogramFields::maxTicks));
+        auto bucketsPtr = function.GetStructFieldPointer(histogramPtr, static_cast<size_t>(LatencyHistogramFields::buckets));
+
+        auto ticks = Max(function.LocalScalar(elapsedTicks), static_cast<int64_t>(0));
+        auto count = function.LocalScalar(function.Load(countPtr));
+        auto minTicks = function.LocalScalar(function.Load(minPtr));
+        auto maxTicks = function.LocalScalar(function.Load(maxPtr));
+
+        // The histogram starts out zeroed, so the first sample sets the minimum
+        function.Store(minPtr, function.Select(count == static_cast<int64_t>(0), ticks, Min(minTicks, ticks)));
+        function.Store(maxPtr, Max(maxTicks, ticks));
+        function.Store(countPtr, count + static_cast<int64_t>(1));
+
+        // Find the bucket from the position of the sample's most significant bit and the 2 bits below it
+        auto ctlz = function.GetModule().GetIntrinsic(llvm::Intrinsic::ctlz, { VariableType::Int64 });
+        auto clampedTicks = Max(ticks, subBucketsPerOctave);
+        auto msb = static_cast<int64_t>(63) - function.LocalScalar(function.Call(ctlz, { clampedTicks, irBuilder.getFalse() }));
+        auto subBucket = function.LocalScalar(function.Operator(TypedOperator::logicalShiftRight, clampedTicks, msb - static_cast<int64_t>(2))) & function.LocalScalar(subBucketsPerOctave - 1);
+        auto logBucket = subBucketsPerOctave * (msb - static_cast<int64_t>(1)) + subBucket;
+        auto bucket = function.Select(ticks < subBucketsPerOctave, ticks, logBucket);
+
+        auto bucketPtr = irBuilder.CreateInBoundsGEP(bucketsPtr, { function.Literal(0), bucket });
+        function.OperationAndUpdate(bucketPtr, TypedOperator::add, function.Literal<int64_t>(1));
+    }
+
+    void ResetLatencyHistogram(IRFunctionEmitter& function, LLVMValue histogramPtr)
+    {
+        function.StoreZero(histogramPtr);
+    }
+
+    int64_t GetLatencyHistogramBucketLowerBound(int bucket)
+    {
+        if (bucket < 0 || bucket >= numLatencyHistogramBuckets)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Latency histogram bucket out of range");
+        }
+
+        if (bucket < subBucketsPerOctave)
+        {
+            return bucket;
+        }
+        return (subBucketsPerOctave + bucket % subBucketsPerOctave) << (bucket / subBucketsPerOctave - 1);
+    }
+} // namespace emitters
+} // namespace ell
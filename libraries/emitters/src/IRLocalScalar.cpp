@@ -15,6 +15,7 @@
 #include <llvm/IR/Value.h>
 
 #include <functional>
+#include <vector>
 
 namespace ell
 {
@@ -31,6 +32,67 @@ namespace emitters
     } // namespace detail
     using namespace detail;
 
+    namespace
+    {
+        // Approximates exp(x) for a vector of floats or doubles with a polynomial, since the exp intrinsic would otherwise
+        // be split into a call to the scalar C library function for each element. The range reduction is the one used by
+        // the Cephes library: exp(x) = 2^n * exp(r), where n = floor(x / ln(2) + 1/2) and |r| <= ln(2) / 2.
+        IRLocalScalar VectorExp(IRLocalScalar x)
+        {
+            auto& function = x.function;
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto vectorType = llvm::cast<llvm::VectorType>(x.value->getType());
+            const bool isFloat = vectorType->getElementType()->isFloatTy();
+            auto constant = [&x, isFloat](double value) { return isFloat ? ToIRLocalScalar(x, static_cast<float>(value)) : ToIRLocalScalar(x, value); };
+
+            // clamp x so that 2^n is a normal number
+            const double maxInput = isFloat ? 88.3762626647949 : 708.0;
+            x = Max(Min(x, constant(maxInput)), constant(-maxInput));
+
+            // n = floor(x * log2(e) + 1/2), where the floor is computed by truncating and then correcting negative values
+            auto fx = x * constant(1.44269504088896341) + constant(0.5);
+            auto intType = llvm::VectorType::get(irBuilder.getIntNTy(isFloat ? 32 : 64), vectorType->getNumElements());
+            IRLocalScalar truncated(function, irBuilder.CreateSIToFP(irBuilder.CreateFPToSI(fx, intType), vectorType));
+            IRLocalScalar n(function, function.Select(truncated > fx, truncated - constant(1.0), truncated));
+
+            // r = x - n * ln(2), with ln(2) split into two parts so that the first product is exact
+            auto r = x - n * constant(isFloat ? 0.693359375 : 6.93145751953125E-1) - n * constant(isFloat ? -2.12194440e-4 : 1.42860682030941723212E-6);
+
+            // exp(r) ~= 1 + r + r^2 * p(r)
+            std::vector<double> coefficients;
+            if (isFloat)
+            {
+                coefficients = { 1.9875691500E-4, 1.3981999507E-3, 8.3334519073E-3, 4.1665795894E-2, 1.6666665459E-1, 5.0000001201E-1 };
+            }
+            else
+            {
+                // the Taylor series, whose error is less than r^12 / 12! on the reduced range
+                for (int k = 11; k >= 2; --k)
+                {
+                    double coefficient = 1.0;
+                    for (int j = 2; j <= k; ++j)
+                    {
+                        coefficient /= j;
+                    }
+                    coefficients.push_back(coefficient);
+                }
+            }
+            auto p = constant(coefficients[0]);
+            for (size_t index = 1; index < coefficients.size(); ++index)
+            {
+                p = p * r + constant(coefficients[index]);
+            }
+            auto y = p * r * r + r + constant(1.0);
+
+            // 2^n, constructed by writing n + bias into the exponent bits
+            auto exponent = irBuilder.CreateFPToSI(n, intType);
+            exponent = irBuilder.CreateAdd(exponent, llvm::ConstantInt::get(intType, isFloat ? 127 : 1023));
+            exponent = irBuilder.CreateShl(exponent, llvm::ConstantInt::get(intType, isFloat ? 23 : 52));
+            IRLocalScalar pow2n(function, irBuilder.CreateBitCast(exponent, vectorType));
+            return y * pow2n;
+        }
+    } // namespace
+
     bool IRLocalScalar::IsConstantInt() const
     {
         return llvm::isa<llvm::ConstantInt>(this->value);
@@ -417,6 +479,11 @@ namespace emitters
 
     IRLocalScalar Exp(IRLocalScalar a)
     {
+        if (a.value->getType()->isVectorTy())
+        {
+            return VectorExp(a);
+        }
+
         auto f = a.function.GetModule().GetRuntime().GetExpFunction((a.value)->getType());
         return { a.function, a.function.Call(f, { a }) };
     }
@@ -19,6 +19,7 @@
 #include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 
+#include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/AsmParser/Parser.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
@@ -33,6 +34,8 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 
+#include <thread>
+
 namespace ell
 {
 namespace emitters
@@ -43,6 +46,7 @@ namespace emitters
     namespace
     {
         static const size_t c_defaultNumBits = 64;
+        static const int c_defaultMaxThreads = 4; // used when the target's thread count isn't known
 
         // Triples
         std::string c_macTriple = "x86_64-apple-macosx10.12.0"; // alternate: "x86_64-apple-darwin16.0.0"
@@ -67,6 +71,75 @@ namespace emitters
         std::string c_armDataLayout = "e-m:e-p:32:32-i64:64-v128:64:128-a:0:32-n32-S64";
         std::string c_arm64DataLayout = "e-m:e-i64:64-i128:128-n32:64-S128"; // DragonBoard
         std::string c_iosDataLayout = "e-m:o-i64:64-i128:128-n32:64-S128";
+
+        bool HasFeature(const std::string& features, const std::string& feature)
+        {
+            return ("," + features + ",").find(",+" + feature + ",") != std::string::npos;
+        }
+
+        // Returns the width of the widest vector registers on the host, or 0 if it isn't known
+        size_t GetHostVectorBits()
+        {
+            llvm::StringMap<bool> hostFeatures;
+            if (!llvm::sys::getHostCPUFeatures(hostFeatures))
+            {
+                return 0;
+            }
+            if (hostFeatures.lookup("avx512f"))
+            {
+                return 512;
+            }
+            if (hostFeatures.lookup("avx"))
+            {
+                return 256;
+            }
+            if (hostFeatures.lookup("sse2") || hostFeatures.lookup("neon"))
+            {
+                return 128;
+            }
+            return 0;
+        }
+
+        // Returns the width of the widest vector registers on a target device, or 0 if it isn't known
+        size_t GetVectorBits(const TargetDevice& targetDevice)
+        {
+            if (targetDevice.deviceName == "" || targetDevice.deviceName == "host")
+            {
+                if (auto hostVectorBits = GetHostVectorBits())
+                {
+                    return hostVectorBits;
+                }
+            }
+
+            const auto& features = targetDevice.features;
+            if (HasFeature(features, "avx512f"))
+            {
+                return 512;
+            }
+            if (HasFeature(features, "avx") || HasFeature(features, "avx2"))
+            {
+                return 256;
+            }
+            if (HasFeature(features, "sse2") || HasFeature(features, "neon"))
+            {
+                return 128;
+            }
+
+            // Otherwise, use the baseline vector extension of the architecture
+            llvm::Triple triple(targetDevice.triple);
+            switch (triple.getArch())
+            {
+            case llvm::Triple::x86_64:
+            case llvm::Triple::aarch64:
+                return 128;
+            case llvm::Triple::arm:
+            case llvm::Triple::armeb:
+                // armv7 application processors have NEON, while armv6 and the microcontrollers have no vector unit
+                return triple.getSubArch() == llvm::Triple::ARMSubArch_v7 && llvm::StringRef(targetDevice.cpu).startswith("cortex-a") ? 128 : 0;
+            default:
+                return 0;
+            }
+        }
     } // namespace
 
     //
@@ -78,7 +151,8 @@ namespace emitters
         _emitter(*_llvmContext),
         _runtime(*this),
         _threadPool(*this),
-        _profiler(*this, parameters.profile)
+        _profiler(*this, parameters.profile),
+        _tracer(*this, parameters.trace, parameters.traceBufferSize)
     {
         InitializeLLVM();
         InitializeGlobalPassRegistry();
@@ -92,6 +166,7 @@ namespace emitters
         }
 
         _profiler.Init();
+        _tracer.Init();
     }
 
     void IRModuleEmitter::SetCompilerOptions(const CompilerOptions& parameters)
@@ -240,6 +315,19 @@ namespace emitters
                 parameters.targetDevice.features = "+armv7e-m,+v7,soft-float";
             }
         }
+
+        // A thread count of 0 means one thread per hardware thread, which we only know when compiling for the host
+        if (parameters.maxThreads <= 0)
+        {
+            const bool isHost = parameters.targetDevice.deviceName == "" || parameters.targetDevice.deviceName == "host";
+            const auto numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+            parameters.maxThreads = (isHost && numHardwareThreads > 0) ? numHardwareThreads : c_defaultMaxThreads;
+        }
+
+        if (parameters.targetDevice.vectorBits == 0)
+        {
+            parameters.targetDevice.vectorBits = GetVectorBits(parameters.targetDevice);
+        }
     }
 
     //
@@ -533,6 +621,25 @@ namespace emitters
         return pVal;
     }
 
+    LLVMValue IRModuleEmitter::EmitGlobalVectorView(Variable& var, llvm::GlobalVariable* buffer, size_t byteOffset)
+    {
+        if (!var.IsVector() || !var.IsGlobal())
+        {
+            throw EmitterException(EmitterError::variableScopeNotSupported, "Only global vector variables can be emitted as a view into a buffer");
+        }
+
+        AllocateVariable(var);
+
+        // Use constant expressions, so the view can be used from any function in the module
+        auto bytePointerType = _emitter.Type(VariableType::BytePointer);
+        auto bytePointer = llvm::ConstantExpr::getBitCast(buffer, bytePointerType);
+        auto offset = llvm::ConstantInt::get(_emitter.Type(VariableType::Int64), byteOffset);
+        auto elementPointer = llvm::ConstantExpr::getGetElementPtr(_emitter.Type(VariableType::Byte), bytePointer, offset);
+        LLVMValue pVal = llvm::ConstantExpr::getBitCast(elementPointer, _emitter.PointerType(var.Type()));
+        _globals.Add(var.EmittedName(), pVal);
+        return pVal;
+    }
+
     //
     // Variable and Constant creation
     //
@@ -582,6 +689,18 @@ namespace emitters
         global->setConstant(isConst);
         global->setExternallyInitialized(false);
         global->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+
+        // Align arrays to the width of the target's vector registers, so vectorized loops over them can use aligned loads and stores
+        const auto& options = GetCompilerOptions();
+        if (options.allowVectorInstructions && pType->isArrayTy())
+        {
+            auto elementBytes = pType->getArrayElementType()->getPrimitiveSizeInBits() / 8;
+            auto vectorBytes = options.targetDevice.vectorBits > 0 ? options.targetDevice.vectorBits / 8 : options.vectorWidth * elementBytes;
+            if (vectorBytes > 0 && llvm::isPowerOf2_64(vectorBytes))
+            {
+                global->setAlignment(static_cast<unsigned>(vectorBytes));
+            }
+        }
         assert(llvm::isa<llvm::GlobalVariable>(global));
         return llvm::cast<llvm::GlobalVariable>(global);
     }
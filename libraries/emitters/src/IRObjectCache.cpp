@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRObjectCache.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace ell
+{
+namespace emitters
+{
+    IRObjectCache::IRObjectCache(const std::string& directory, const std::string& key, bool storeObjects) :
+        _directory(directory),
+        _key(key),
+        _storeObjects(storeObjects)
+    {
+    }
+
+    std::string IRObjectCache::GetObjectPath() const
+    {
+        return utilities::JoinPaths(_directory, _key + ".o");
+    }
+
+    bool IRObjectCache::HasObject() const
+    {
+        return utilities::FileExists(GetObjectPath());
+    }
+
+    void IRObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object)
+    {
+        if (!_storeObjects)
+        {
+            return;
+        }
+
+        // Other processes may be compiling or loading the same map, so the object goes to a file of our own first and is
+        // then moved over the cache entry in one step. A failure to write the cache isn't an error: the compiled code is still used.
+        try
+        {
+            utilities::EnsureDirectoryExists(_directory);
+            auto objectPath = GetObjectPath();
+            auto tempPath = utilities::GetTemporaryFilePath(objectPath);
+            bool written = false;
+            {
+                auto stream = utilities::OpenBinaryOfstream(tempPath);
+                stream.write(object.getBufferStart(), object.getBufferSize());
+                written = static_cast<bool>(stream);
+            }
+            if (!written || !utilities::ReplaceFile(tempPath, objectPath))
+            {
+                std::remove(tempPath.c_str());
+            }
+        }
+        catch (const utilities::Exception&)
+        {
+        }
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IRObjectCache::getObject(const llvm::Module* module)
+    {
+        auto buffer = llvm::MemoryBuffer::getFile(GetObjectPath());
+        if (!buffer)
+        {
+            return nullptr;
+        }
+        return std::move(buffer.get());
+    }
+} // namespace emitters
+} // namespace ell
@@ -9,8 +9,10 @@
 #include "IRProfiler.h"
 #include "EmitterException.h"
 #include "IRFunctionEmitter.h"
+#include "IRLatencyHistogram.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRTracer.h"
 #include "LLVMUtilities.h"
 
 #include <utilities/include/UniqueId.h>
@@ -31,7 +33,8 @@ namespace emitters
         {
             count = 0,
             totalTime = 1,
-            name = 2
+            name = 2,
+            latency = 3
         };
     }
 
@@ -55,8 +58,10 @@ namespace emitters
     IRProfileRegion::IRProfileRegion(IRFunctionEmitter& function, const std::string& name) :
         _function(function),
         _profiler(function.GetModule().GetProfiler()),
+        _name(name),
         _index(function.LocalScalar()),
-        _startTime(function.LocalScalar())
+        _startTime(function.LocalScalar()),
+        _startTicks(function.LocalScalar())
     {
         _index = _profiler.CreateRegion(_function);
         _profiler.InitRegion(*this, name);
@@ -66,18 +71,23 @@ namespace emitters
     IRProfileRegion::IRProfileRegion(IRFunctionEmitter& function, IRProfiler& profiler, const std::string& name, IRLocalScalar index) :
         _function(function),
         _profiler(profiler),
+        _name(name),
         _index(index),
-        _startTime(function.LocalScalar())
+        _startTime(function.LocalScalar()),
+        _startTicks(function.LocalScalar())
     {
     }
 
     void IRProfileRegion::Enter()
     {
         _profiler.EnterRegion(*this);
+        _traceBeginTicks = _function.GetModule().GetTracer().BeginEvent(_function);
     }
 
     void IRProfileRegion::Exit()
     {
+        _function.GetModule().GetTracer().EndEvent(_function, _traceBeginTicks, _name, TraceEventCategory::region);
+        _traceBeginTicks = nullptr;
         _profiler.ExitRegion(*this);
     }
 
@@ -123,6 +133,11 @@ namespace emitters
         return GetNamespacePrefix() + "_ResetRegionProfilingInfo";
     }
 
+    std::string IRProfiler::GetGetProfilerTicksPerMillisecondFunctionName() const
+    {
+        return GetNamespacePrefix() + "_GetProfilerTicksPerMillisecond";
+    }
+
     std::string IRProfiler::GetNamespacePrefix() const
     {
         return _module->GetModuleName();
@@ -139,6 +154,12 @@ namespace emitters
         return function.LocalScalar(time);
     }
 
+    IRLocalScalar IRProfiler::GetProfilerTicks(IRFunctionEmitter& function)
+    {
+        auto ticks = function.GetModule().GetRuntime().GetProfilerTicks(function);
+        return function.LocalScalar(ticks);
+    }
+
     void IRProfiler::InitRegion(IRProfileRegion& region, const std::string& desiredName)
     {
         if (!_profilingEnabled)
@@ -165,6 +186,7 @@ namespace emitters
         // Get the time
         auto startTime = GetCurrentTime(function);
         region.SetStartTime(startTime);
+        region.SetStartTicks(GetProfilerTicks(function));
 
         // Increment visit count
         auto regionPtr = GetRegionPointer(function, region.GetIndex());
@@ -187,8 +209,14 @@ namespace emitters
         auto storedTime = function.LocalArray(timePtr);
         storedTime[0] = storedTime[0] + newTime;
 
+        // Add the latency to the histogram
+        auto elapsedTicks = GetProfilerTicks(function) - region.GetStartTicks();
+        auto latencyPtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::latency));
+        AddLatencyHistogramSample(function, latencyPtr, elapsedTicks);
+
         // reset start time to "unassigned"
         region.SetStartTime(function.LocalScalar());
+        region.SetStartTicks(function.LocalScalar());
     }
 
     void IRProfiler::ResetRegionCounts(IRFunctionEmitter& function, const IRLocalScalar& regionIndex)
@@ -200,8 +228,10 @@ namespace emitters
         auto regionPtr = GetRegionPointer(function, regionIndex);
         auto countPtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::count));
         auto timePtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::totalTime));
+        auto latencyPtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::latency));
         function.StoreZero(countPtr);
         function.StoreZero(timePtr);
+        ResetLatencyHistogram(function, latencyPtr);
     }
 
     std::string IRProfiler::GetUniqueRegionName(const std::string& desiredName) const
@@ -237,9 +267,10 @@ namespace emitters
         auto int64Type = llvm::Type::getInt64Ty(context);
         auto doubleType = llvm::Type::getDoubleTy(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto latencyHistogramType = GetLatencyHistogramType(*_module);
 
         // ProfileRegionInfo struct fields
-        emitters::NamedLLVMTypeList infoFields = { { "count", int64Type }, { "totalTime", doubleType }, { "name", int8PtrType } };
+        emitters::NamedLLVMTypeList infoFields = { { "count", int64Type }, { "totalTime", doubleType }, { "name", int8PtrType }, { "latency", latencyHistogramType } };
         _profileRegionType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_ProfileRegionInfo", infoFields);
         _module->IncludeTypeInHeader(_profileRegionType->getName());
     }
@@ -255,6 +286,7 @@ namespace emitters
         EmitGetNumRegionsFunction();
         EmitGetRegionProfilingInfoFunction();
         EmitResetRegionProfilingInfoFunction();
+        _module->GetRuntime().GetProfilerTicksPerMillisecondFunction();
     }
 
     void IRProfiler::CreateRegionData()
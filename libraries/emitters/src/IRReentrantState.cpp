@@ -0,0 +1,393 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRReentrantState.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRReentrantState.h"
+#include "EmitterException.h"
+#include "IRFunctionEmitter.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        bool IsStateGlobal(const llvm::GlobalVariable& global)
+        {
+            return global.hasInitializer() && !global.isConstant() && global.hasLocalLinkage() && !global.isThreadLocal();
+        }
+
+        // Replaces the constant expressions (casts, GEPs, ...) that use `value` with equivalent instructions,
+        // so that every use that's left is either an instruction or a constant initializer.
+        void ExpandConstantExpressionUsers(llvm::Constant* value)
+        {
+            std::set<llvm::User*> users(value->user_begin(), value->user_end());
+            for (auto user : users)
+            {
+                auto expression = llvm::dyn_cast<llvm::ConstantExpr>(user);
+                if (expression == nullptr)
+                {
+                    continue;
+                }
+
+                ExpandConstantExpressionUsers(expression);
+                std::set<llvm::User*> expressionUsers(expression->user_begin(), expression->user_end());
+                for (auto expressionUser : expressionUsers)
+                {
+                    auto instruction = llvm::dyn_cast<llvm::Instruction>(expressionUser);
+                    if (instruction == nullptr)
+                    {
+                        continue;
+                    }
+
+                    if (auto phi = llvm::dyn_cast<llvm::PHINode>(instruction))
+                    {
+                        // The replacement has to be computed in the incoming block, not in front of the phi
+                        for (unsigned index = 0; index < phi->getNumIncomingValues(); ++index)
+                        {
+                            if (phi->getIncomingValue(index) == expression)
+                            {
+                                auto newInstruction = expression->getAsInstruction();
+                                newInstruction->insertBefore(phi->getIncomingBlock(index)->getTerminator());
+                                phi->setIncomingValue(index, newInstruction);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        auto newInstruction = expression->getAsInstruction();
+                        newInstruction->insertBefore(instruction);
+                        instruction->replaceUsesOfWith(expression, newInstruction);
+                    }
+                }
+            }
+            value->removeDeadConstantUsers();
+        }
+
+        // Creates a copy of `function` with an extra leading `state` argument, and moves the body over to it.
+        // The copy takes over the name, attributes, and metadata (e.g., header declaration tags) of the original.
+        LLVMFunction AddStateArgument(LLVMFunction function, LLVMType stateType)
+        {
+            auto functionType = function->getFunctionType();
+            std::vector<LLVMType> argTypes = { stateType };
+            argTypes.insert(argTypes.end(), functionType->param_begin(), functionType->param_end());
+            auto newFunctionType = llvm::FunctionType::get(functionType->getReturnType(), argTypes, functionType->isVarArg());
+
+            auto newFunction = llvm::Function::Create(newFunctionType, function->getLinkage(), "", function->getParent());
+            newFunction->setCallingConv(function->getCallingConv());
+
+            // The parameter attributes move over by one to make room for the state argument
+            auto attributes = function->getAttributes();
+            std::vector<llvm::AttributeSet> argAttributes = { llvm::AttributeSet() };
+            for (unsigned index = 0; index < functionType->getNumParams(); ++index)
+            {
+                argAttributes.push_back(attributes.getParamAttributes(index));
+            }
+            newFunction->setAttributes(llvm::AttributeList::get(function->getContext(), attributes.getFnAttributes(), attributes.getRetAttributes(), argAttributes));
+
+            llvm::SmallVector<std::pair<unsigned, llvm::MDNode*>, 4> metadata;
+            function->getAllMetadata(metadata);
+            for (const auto& entry : metadata)
+            {
+                newFunction->setMetadata(entry.first, entry.second);
+            }
+
+            newFunction->getBasicBlockList().splice(newFunction->begin(), function->getBasicBlockList());
+            auto newArg = newFunction->arg_begin();
+            newArg->setName("state");
+            ++newArg;
+            for (auto& arg : function->args())
+            {
+                newArg->takeName(&arg);
+                arg.replaceAllUsesWith(&*newArg);
+                ++newArg;
+            }
+            newFunction->takeName(function);
+            return newFunction;
+        }
+
+        // Keeps the declaration used for writing the header in sync with a function that got a state argument
+        void AddStateArgumentToDeclaration(IRModuleEmitter& module, llvm::Function& function)
+        {
+            std::string name = function.getName();
+            auto& declaration = module.GetFunctionDeclaration(name);
+            NamedVariableTypeList args = { { "state", VariableType::VoidPointer } };
+            const auto& oldArgs = declaration.GetArguments();
+            if (oldArgs.size() + 1 == function.arg_size())
+            {
+                args.insert(args.end(), oldArgs.begin(), oldArgs.end());
+            }
+
+            auto comments = declaration.GetComments();
+            declaration = FunctionDeclaration(name, declaration.GetReturnType(), args);
+            declaration.GetComments() = comments;
+        }
+    } // namespace
+
+    ReentrantStateInfo EmitReentrantState(IRModuleEmitter& module, LLVMFunction predictFunction)
+    {
+        return EmitReentrantState(module, std::vector<LLVMFunction>{ predictFunction });
+    }
+
+    ReentrantStateInfo EmitReentrantState(IRModuleEmitter& module, const std::vector<LLVMFunction>& entryFunctions)
+    {
+        auto& context = module.GetLLVMContext();
+        auto pModule = module.GetLLVMModule();
+        const auto& dataLayout = module.GetTargetDataLayout();
+        auto bytePointerType = llvm::Type::getInt8PtrTy(context);
+        auto prefix = module.GetModuleName();
+
+        if (entryFunctions.empty())
+        {
+            throw EmitterException(EmitterError::badFunctionDefinition, "Reentrant module must have a predict function");
+        }
+        for (auto function : entryFunctions)
+        {
+            if (function == nullptr || function->arg_empty() || function->arg_begin()->getType() != bytePointerType)
+            {
+                throw EmitterException(EmitterError::badFunctionDefinition, "Entry functions must take a byte pointer as their first argument");
+            }
+        }
+
+        // The entry points normally save their context argument in a global, so callbacks can pass it along.
+        // In a reentrant module that argument is the state pointer, and the context is set with <ns>_SetStateContext instead.
+        auto contextGlobal = pModule->getNamedGlobal(prefix + "_context");
+        if (contextGlobal == nullptr)
+        {
+            contextGlobal = module.GlobalPointer(prefix + "_context", VariableType::Byte);
+        }
+
+        std::set<LLVMValue> entryStates;
+        for (auto function : entryFunctions)
+        {
+            auto state = &*function->arg_begin();
+            state->setName("state");
+            entryStates.insert(state);
+        }
+
+        std::vector<llvm::User*> contextUsers(contextGlobal->user_begin(), contextGlobal->user_end());
+        for (auto user : contextUsers)
+        {
+            auto store = llvm::dyn_cast<llvm::StoreInst>(user);
+            if (store != nullptr && entryStates.count(store->getValueOperand()) != 0)
+            {
+                store->eraseFromParent();
+            }
+        }
+
+        // Collect the mutable globals, with the callback context first
+        std::vector<llvm::GlobalVariable*> stateGlobals = { contextGlobal };
+        for (auto& global : pModule->globals())
+        {
+            if (&global != contextGlobal && IsStateGlobal(global))
+            {
+                stateGlobals.push_back(&global);
+            }
+        }
+
+        // Lay out the state struct
+        ReentrantStateInfo info;
+        std::unordered_map<llvm::GlobalVariable*, uint64_t> offsets;
+        uint64_t offset = 0;
+        for (auto global : stateGlobals)
+        {
+            auto type = global->getValueType();
+            uint64_t alignment = std::max<uint64_t>(global->getAlignment(), dataLayout.getPrefTypeAlignment(type));
+            offset = llvm::alignTo(offset, alignment);
+            offsets[global] = offset;
+            offset += dataLayout.getTypeAllocSize(type);
+            info.alignment = std::max<size_t>(info.alignment, alignment);
+        }
+        info.size = llvm::alignTo(offset, info.alignment);
+        info.numGlobals = stateGlobals.size();
+
+        for (auto global : stateGlobals)
+        {
+            ExpandConstantExpressionUsers(global);
+            for (auto user : global->users())
+            {
+                if (!llvm::isa<llvm::Instruction>(user))
+                {
+                    throw EmitterException(EmitterError::notSupported, "Global '" + global->getName().str() + "' is used in a constant initializer, so it can't be moved into the state struct");
+                }
+            }
+        }
+
+        // Find every function that uses the state, directly or through the functions it calls.
+        // The public reset function always takes the state, even if no node has anything to reset.
+        std::set<LLVMFunction> stateFunctions(entryFunctions.begin(), entryFunctions.end());
+        std::vector<LLVMFunction> worklist;
+        if (auto resetFunction = module.GetFunction(prefix + "_Reset"))
+        {
+            stateFunctions.insert(resetFunction);
+            worklist.push_back(resetFunction);
+        }
+        for (auto global : stateGlobals)
+        {
+            for (auto user : global->users())
+            {
+                auto function = llvm::cast<llvm::Instruction>(user)->getFunction();
+                if (stateFunctions.insert(function).second)
+                {
+                    worklist.push_back(function);
+                }
+            }
+        }
+
+        while (!worklist.empty())
+        {
+            auto function = worklist.back();
+            worklist.pop_back();
+
+            function->removeDeadConstantUsers();
+            for (auto user : function->users())
+            {
+                auto call = llvm::dyn_cast<llvm::CallInst>(user);
+                if (call == nullptr || call->getCalledFunction() != function)
+                {
+                    throw EmitterException(EmitterError::notSupported, "Function '" + function->getName().str() + "' uses model state, but its address is taken");
+                }
+
+                auto caller = call->getFunction();
+                if (stateFunctions.insert(caller).second)
+                {
+                    worklist.push_back(caller);
+                }
+            }
+        }
+
+        // Save the initial values of the globals that don't start out as zero
+        std::vector<std::pair<uint64_t, llvm::GlobalVariable*>> initialValues;
+        for (auto global : stateGlobals)
+        {
+            auto initializer = global->getInitializer();
+            if (!initializer->isNullValue())
+            {
+                auto initialValue = new llvm::GlobalVariable(*pModule, global->getValueType(), true, llvm::GlobalValue::PrivateLinkage, initializer, global->getName() + "_initial");
+                initialValues.emplace_back(offsets[global], initialValue);
+            }
+        }
+
+        // Give every function that uses the state (other than the entry points, which already have it) a leading state argument.
+        // Visit them in module order, so the output doesn't depend on pointer values.
+        std::vector<LLVMFunction> oldFunctions;
+        for (auto& function : pModule->functions())
+        {
+            if (std::find(entryFunctions.begin(), entryFunctions.end(), &function) == entryFunctions.end() && stateFunctions.count(&function) != 0)
+            {
+                oldFunctions.push_back(&function);
+            }
+        }
+
+        std::vector<std::pair<LLVMFunction, LLVMFunction>> replacements;
+        for (auto function : oldFunctions)
+        {
+            replacements.emplace_back(function, AddStateArgument(function, bytePointerType));
+            AddStateArgumentToDeclaration(module, *replacements.back().second);
+        }
+
+        for (const auto& replacement : replacements)
+        {
+            auto oldFunction = replacement.first;
+            auto newFunction = replacement.second;
+            std::vector<llvm::User*> users(oldFunction->user_begin(), oldFunction->user_end());
+            for (auto user : users)
+            {
+                // Each caller now has the state as its first argument, so pass it along
+                auto call = llvm::cast<llvm::CallInst>(user);
+                std::vector<LLVMValue> args = { &*call->getFunction()->arg_begin() };
+                args.insert(args.end(), call->arg_begin(), call->arg_end());
+                auto newCall = llvm::CallInst::Create(newFunction, args, "", call);
+                newCall->setCallingConv(call->getCallingConv());
+                newCall->setDebugLoc(call->getDebugLoc());
+                newCall->takeName(call);
+                call->replaceAllUsesWith(newCall);
+                call->eraseFromParent();
+            }
+            oldFunction->eraseFromParent();
+        }
+
+        // Replace each global with a pointer into the state struct, computed once at the top of each function that uses it
+        std::map<std::pair<LLVMFunction, llvm::GlobalVariable*>, LLVMValue> statePointers;
+        for (auto global : stateGlobals)
+        {
+            std::vector<llvm::User*> users(global->user_begin(), global->user_end());
+            for (auto user : users)
+            {
+                auto instruction = llvm::cast<llvm::Instruction>(user);
+                auto function = instruction->getFunction();
+                auto& pointer = statePointers[{ function, global }];
+                if (pointer == nullptr)
+                {
+                    llvm::IRBuilder<> builder(&*function->getEntryBlock().getFirstInsertionPt());
+                    auto bytePointer = builder.CreateInBoundsGEP(&*function->arg_begin(), builder.getInt64(offsets[global]));
+                    pointer = builder.CreatePointerCast(bytePointer, global->getType(), global->getName());
+                }
+                instruction->replaceUsesOfWith(global, pointer);
+            }
+            global->eraseFromParent();
+        }
+
+        //
+        // Emit the state API
+        //
+        auto getSizeFunction = module.BeginFunction(prefix + "_GetStateSize", VariableType::Int64);
+        getSizeFunction.IncludeInHeader();
+        getSizeFunction.Return(getSizeFunction.Literal(static_cast<int64_t>(info.size)));
+        module.EndFunction();
+
+        auto getAlignmentFunction = module.BeginFunction(prefix + "_GetStateAlignment", VariableType::Int64);
+        getAlignmentFunction.IncludeInHeader();
+        getAlignmentFunction.Return(getAlignmentFunction.Literal(static_cast<int64_t>(info.alignment)));
+        module.EndFunction();
+
+        const NamedVariableTypeList initArgs = { { "state", VariableType::VoidPointer } };
+        auto initFunction = module.BeginFunction(prefix + "_InitState", VariableType::Void, initArgs);
+        initFunction.IncludeInHeader();
+        {
+            auto state = initFunction.GetFunctionArgument("state");
+            initFunction.MemorySet<uint8_t>(state, 0, initFunction.Literal(static_cast<uint8_t>(0)), static_cast<int>(info.size));
+            for (const auto& initialValue : initialValues)
+            {
+                auto source = initFunction.CastPointer(initialValue.second, VariableType::BytePointer);
+                auto size = dataLayout.getTypeAllocSize(initialValue.second->getValueType());
+                initFunction.MemoryCopy<uint8_t>(source, 0, state, static_cast<int>(initialValue.first), static_cast<int>(size));
+            }
+        }
+        module.EndFunction();
+
+        const NamedVariableTypeList setContextArgs = { { "state", VariableType::VoidPointer }, { "context", VariableType::VoidPointer } };
+        auto setContextFunction = module.BeginFunction(prefix + "_SetStateContext", VariableType::Void, setContextArgs);
+        setContextFunction.IncludeInHeader();
+        {
+            // The context is always at the start of the state struct
+            auto state = setContextFunction.GetFunctionArgument("state");
+            auto contextPointer = setContextFunction.CastPointer(state, bytePointerType->getPointerTo());
+            setContextFunction.Store(contextPointer, setContextFunction.GetFunctionArgument("context"));
+        }
+        module.EndFunction();
+
+        return info;
+    }
+} // namespace emitters
+} // namespace ell
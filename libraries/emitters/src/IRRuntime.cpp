@@ -10,9 +10,15 @@
 #include "IRFunctionEmitter.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
 
 #include <utilities/include/Unused.h>
 
+#include <llvm/ADT/Triple.h>
+
+#include <algorithm>
+#include <vector>
+
 namespace ell
 {
 namespace emitters
@@ -22,99 +28,383 @@ namespace emitters
         //
         // Native implementations of matrix operation functions (as opposed to calling out to BLAS)
         //
+        const int CblasNoTrans = 111;
+        const int CblasTrans = 112;
+
+        // The native GEMM follows the usual blocked structure: an mc x kc block of op(A) and a kc x nc panel
+        // of op(B) are packed into contiguous, aligned buffers, and a micro-kernel accumulates an mr x nr
+        // tile of C in registers. The buffers are sized so that the packed block of A stays in L1 and the packed
+        // panel of B stays in L2 on typical targets.
+        struct GEMMBlocking
+        {
+            int mr;
+            int nr;
+            int kc;
+            int mc;
+            int nc;
+        };
+
+        GEMMBlocking GetGEMMBlocking(const CompilerOptions& options)
+        {
+            const int nr = options.allowVectorInstructions ? std::max(options.vectorWidth, 1) : 4;
+            const int nc = ((64 + nr - 1) / nr) * nr;
+            return { 4, nr, 64, 32, nc };
+        }
+
+        const unsigned packedBufferAlignment = 64;
+
+        llvm::AllocaInst* PackedBuffer(IRFunctionEmitter& function, VariableType type, int size)
+        {
+            auto buffer = function.Variable(type, size);
+            buffer->setAlignment(packedBufferAlignment);
+            return buffer;
+        }
+
+        int RoundUpToAlignment(int bytes)
+        {
+            return ((bytes + packedBufferAlignment - 1) / packedBufferAlignment) * packedBufferAlignment;
+        }
+
+        // The packed blocks of A and B are tens of kilobytes, too much for the small stacks of embedded targets and
+        // thread pool workers. Usually they're module globals. A parallelized module can run GEMM on several threads
+        // at once, though, so there each call allocates its own buffers on the heap, and frees them with `FreePackedBuffers`.
+        struct PackedBuffers
+        {
+            LLVMValue A;
+            LLVMValue B;
+            LLVMValue heapAllocation = nullptr;
+        };
+
+        PackedBuffers AllocatePackedBuffers(IRModuleEmitter& module, IRFunctionEmitter& function, const std::string& functionName, VariableType type, int sizeA, int sizeB)
+        {
+            auto pointerType = GetPointerType(type);
+            if (!module.GetCompilerOptions().parallelize)
+            {
+                auto globalA = module.GlobalArray(type, functionName + "_packedA", sizeA);
+                auto globalB = module.GlobalArray(type, functionName + "_packedB", sizeB);
+                globalA->setAlignment(packedBufferAlignment);
+                globalB->setAlignment(packedBufferAlignment);
+                return { function.CastPointer(globalA, pointerType), function.CastPointer(globalB, pointerType) };
+            }
+
+            // malloc doesn't promise 64-byte alignment, so allocate extra space and align the start by hand
+            const int elementBytes = type == VariableType::Float ? sizeof(float) : sizeof(double);
+            const int offsetB = RoundUpToAlignment(sizeA * elementBytes);
+            const int totalBytes = offsetB + RoundUpToAlignment(sizeB * elementBytes) + packedBufferAlignment;
+            auto allocation = function.Malloc(VariableType::BytePointer, totalBytes);
+            auto address = function.LocalScalar(function.CastPointerToInt(allocation, VariableType::Int64));
+            auto alignedAddress = (address + static_cast<int64_t>(packedBufferAlignment - 1)) & function.LocalScalar(~static_cast<int64_t>(packedBufferAlignment - 1));
+            auto aligned = function.CastIntToPointer(alignedAddress, VariableType::BytePointer);
+            return { function.CastPointer(aligned, pointerType), function.CastPointer(function.PointerOffset(aligned, offsetB), pointerType), allocation };
+        }
+
+        void FreePackedBuffers(IRFunctionEmitter& function, const PackedBuffers& buffers)
+        {
+            if (buffers.heapAllocation != nullptr)
+            {
+                function.Free(buffers.heapAllocation);
+            }
+        }
+
+        // C = beta * C. If beta is zero, C is cleared instead, so (as with BLAS) its previous contents are ignored.
         template <typename ValueType>
-        LLVMFunction EmitGEMVFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
+        void EmitScaleMatrix(IRFunctionEmitter& function, IRLocalScalar m, IRLocalScalar n, IRLocalScalar beta, IRLocalArray C, IRLocalScalar ldc)
+        {
+            function.If(beta == static_cast<ValueType>(0), [=](IRFunctionEmitter& function) {
+                function.For(m, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    function.For(n, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                        C[i * ldc + j] = function.Literal<ValueType>(0);
+                    });
+                });
+            }).ElseIf(beta != static_cast<ValueType>(1), [=](IRFunctionEmitter& function) {
+                function.For(m, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    function.For(n, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                        auto cOffset = i * ldc + j;
+                        C[cOffset] = beta * C[cOffset];
+                    });
+                });
+            });
+        }
+
+        // Packs the kb x nb block of op(B) at (pc, jc) into panels of nr columns: Bp[jr * kb + p * nr + jj] = op(B)[pc + p, jc + jr + jj].
+        // Columns past the edge of the block are zero-padded, so the micro-kernel never needs bounds checks.
+        template <typename ValueType>
+        void EmitPackB(IRFunctionEmitter& function, bool transposeB, const GEMMBlocking& blocking, IRLocalArray B, IRLocalScalar ldb, IRLocalScalar pc, IRLocalScalar jc, IRLocalScalar kb, IRLocalScalar nb, IRLocalArray Bp)
         {
+            const int nr = blocking.nr;
+            function.For(function.LocalScalar<int>(0), nb, function.LocalScalar<int>(nr), [=](IRFunctionEmitter& function, IRLocalScalar jr) {
+                function.For(kb, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    auto row = pc + p;
+                    for (int jj = 0; jj < nr; ++jj)
+                    {
+                        // Clamp the column so the load stays in bounds, and zero out the padding
+                        auto column = jr + jj;
+                        auto clampedColumn = jc + Min(column, nb - 1);
+                        IRLocalScalar value = transposeB ? B[clampedColumn * ldb + row] : B[row * ldb + clampedColumn];
+                        Bp[jr * kb + p * nr + jj] = function.Select(column < nb, value, function.Literal<ValueType>(0));
+                    }
+                });
+            });
+        }
+
+        // Packs the mb x kb block of alpha * op(A) at (ic, pc) into panels of mr rows: Ap[ir * kb + p * mr + ii] = alpha * op(A)[ic + ir + ii, pc + p].
+        // Rows past the edge of the block are zero-padded.
+        template <typename ValueType>
+        void EmitPackA(IRFunctionEmitter& function, bool transposeA, const GEMMBlocking& blocking, IRLocalScalar alpha, IRLocalArray A, IRLocalScalar lda, IRLocalScalar ic, IRLocalScalar pc, IRLocalScalar mb, IRLocalScalar kb, IRLocalArray Ap)
+        {
+            const int mr = blocking.mr;
+            function.For(function.LocalScalar<int>(0), mb, function.LocalScalar<int>(mr), [=](IRFunctionEmitter& function, IRLocalScalar ir) {
+                function.For(kb, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    auto column = pc + p;
+                    for (int ii = 0; ii < mr; ++ii)
+                    {
+                        auto row = ir + ii;
+                        auto clampedRow = ic + Min(row, mb - 1);
+                        IRLocalScalar value = transposeA ? A[column * lda + clampedRow] : A[clampedRow * lda + column];
+                        Ap[ir * kb + p * mr + ii] = function.Select(row < mb, alpha * value, function.Literal<ValueType>(0));
+                    }
+                });
+            });
+        }
+
+        // Multiplies an mr x kb panel of packed A by a kb x nr panel of packed B, and writes the mr x nr result to `tile`
+        template <typename ValueType>
+        void EmitMicroKernel(IRFunctionEmitter& function, const GEMMBlocking& blocking, llvm::VectorType* vectorType, IRLocalScalar kb, IRLocalArray aPanel, LLVMValue bPanel, LLVMValue tile)
+        {
+            const int mr = blocking.mr;
+            const int nr = blocking.nr;
+            const auto add = emitters::GetAddForValueType<ValueType>();
+            const auto multiply = emitters::GetMultiplyForValueType<ValueType>();
+            if (vectorType != nullptr)
+            {
+                // One row of the tile per vector register: broadcast an element of A and multiply it by a row of packed B
+                auto vectorPointerType = vectorType->getPointerTo();
+                auto bVectors = function.CastPointer(bPanel, vectorPointerType);
+                std::vector<LLVMValue> accumulators;
+                for (int ii = 0; ii < mr; ++ii)
+                {
+                    auto accumulator = function.Variable(vectorType, "gemmAccum");
+                    function.Store(accumulator, emitters::FillVector<ValueType>(function, vectorType, 0));
+                    accumulators.push_back(accumulator);
+                }
+
+                function.For(kb, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                    auto bValue = function.ValueAt(bVectors, p);
+                    for (int ii = 0; ii < mr; ++ii)
+                    {
+                        IRLocalScalar aElement = aPanel[p * mr + ii];
+                        auto aValue = irBuilder.CreateVectorSplat(nr, aElement);
+                        auto product = function.Operator(multiply, aValue, bValue);
+                        function.Store(accumulators[ii], function.Operator(add, function.Load(accumulators[ii]), product));
+                    }
+                });
+
+                auto tileVectors = function.CastPointer(tile, vectorPointerType);
+                for (int ii = 0; ii < mr; ++ii)
+                {
+                    function.SetValueAt(tileVectors, ii, function.Load(accumulators[ii]));
+                }
+            }
+            else
+            {
+                std::vector<LLVMValue> accumulators;
+                for (int index = 0; index < mr * nr; ++index)
+                {
+                    auto accumulator = function.Variable(emitters::GetVariableType<ValueType>(), "gemmAccum");
+                    function.StoreZero(accumulator);
+                    accumulators.push_back(accumulator);
+                }
+
+                auto bValues = function.LocalArray(bPanel);
+                function.For(kb, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    std::vector<IRLocalScalar> bRow;
+                    for (int jj = 0; jj < nr; ++jj)
+                    {
+                        bRow.push_back(bValues[p * nr + jj]);
+                    }
+                    for (int ii = 0; ii < mr; ++ii)
+                    {
+                        IRLocalScalar aValue = aPanel[p * mr + ii];
+                        for (int jj = 0; jj < nr; ++jj)
+                        {
+                            auto accumulator = accumulators[ii * nr + jj];
+                            function.Store(accumulator, function.Operator(add, function.Load(accumulator), aValue * bRow[jj]));
+                        }
+                    }
+                });
+
+                for (int index = 0; index < mr * nr; ++index)
+                {
+                    function.SetValueAt(tile, index, function.Load(accumulators[index]));
+                }
+            }
+        }
+
+        // Emits C += op(A) * op(B) (with alpha already folded into packed A), specialized for the given transpositions
+        template <typename ValueType>
+        void EmitBlockedGEMM(IRFunctionEmitter& function, bool transposeA, bool transposeB, const GEMMBlocking& blocking, llvm::VectorType* vectorType, IRLocalScalar m, IRLocalScalar n, IRLocalScalar k, IRLocalScalar alpha, IRLocalArray A, IRLocalScalar lda, IRLocalArray B, IRLocalScalar ldb, IRLocalArray C, IRLocalScalar ldc, IRLocalArray Ap, IRLocalArray Bp, LLVMValue tile)
+        {
+            auto zero = function.LocalScalar<int>(0);
+            function.For(zero, n, function.LocalScalar<int>(blocking.nc), [=](IRFunctionEmitter& function, IRLocalScalar jc) {
+                auto nb = Min(n - jc, blocking.nc);
+                function.For(zero, k, function.LocalScalar<int>(blocking.kc), [=](IRFunctionEmitter& function, IRLocalScalar pc) {
+                    auto kb = Min(k - pc, blocking.kc);
+                    EmitPackB<ValueType>(function, transposeB, blocking, B, ldb, pc, jc, kb, nb, Bp);
+
+                    function.For(zero, m, function.LocalScalar<int>(blocking.mc), [=](IRFunctionEmitter& function, IRLocalScalar ic) {
+                        auto mb = Min(m - ic, blocking.mc);
+                        EmitPackA<ValueType>(function, transposeA, blocking, alpha, A, lda, ic, pc, mb, kb, Ap);
+
+                        function.For(zero, nb, function.LocalScalar<int>(blocking.nr), [=](IRFunctionEmitter& function, IRLocalScalar jr) {
+                            function.For(zero, mb, function.LocalScalar<int>(blocking.mr), [=](IRFunctionEmitter& function, IRLocalScalar ir) {
+                                auto aPanel = function.LocalArray(function.PointerOffset(Ap, ir * kb));
+                                auto bPanel = function.PointerOffset(Bp, jr * kb);
+                                EmitMicroKernel<ValueType>(function, blocking, vectorType, kb, aPanel, bPanel, tile);
+
+                                // Accumulate the valid part of the tile into C
+                                auto tileValues = function.LocalArray(tile);
+                                auto cTile = function.LocalArray(function.PointerOffset(C, (ic + ir) * ldc + jc + jr));
+                                auto rows = Min(mb - ir, blocking.mr);
+                                auto columns = Min(nb - jr, blocking.nr);
+                                function.For(rows, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                                    function.For(columns, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                                        auto cOffset = i * ldc + j;
+                                        cTile[cOffset] = cTile[cOffset] + tileValues[i * blocking.nr + j];
+                                    });
+                                });
+                            });
+                        });
+                    });
+                });
+            });
+        }
+
+        template <typename ValueType>
+        LLVMFunction EmitGEMMFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
+        {
+            const auto blocking = GetGEMMBlocking(module.GetCompilerOptions());
+            const auto valueType = emitters::GetVariableType<ValueType>();
+
             auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
             auto arguments = function.Arguments().begin();
             auto order = &(*arguments++);
-            auto transpose = &(*arguments++);
+            auto transposeA = function.LocalScalar(&(*arguments++)) == CblasTrans;
+            auto transposeB = function.LocalScalar(&(*arguments++)) == CblasTrans;
             auto m = function.LocalScalar(&(*arguments++));
             auto n = function.LocalScalar(&(*arguments++));
+            auto k = function.LocalScalar(&(*arguments++));
             auto alpha = function.LocalScalar(&(*arguments++));
             auto A = function.LocalArray(&(*arguments++));
             auto lda = function.LocalScalar(&(*arguments++));
-            auto x = function.LocalArray(&(*arguments++));
-            auto incx = function.LocalScalar(&(*arguments++));
+            auto B = function.LocalArray(&(*arguments++));
+            auto ldb = function.LocalScalar(&(*arguments++));
             auto beta = function.LocalScalar(&(*arguments++));
-            auto y = function.LocalArray(&(*arguments++));
-            auto incy = function.LocalScalar(&(*arguments++));
-            UNUSED(order, transpose, alpha, beta);
-
-            LLVMValue accum = function.Variable(emitters::GetVariableType<ValueType>(), "accum");
-
-            function.For(m, [A, x, y, incx, incy, lda, n, accum](IRFunctionEmitter& function, auto rowIndex) {
-                function.StoreZero(accum);
-                function.For(n, [rowIndex, A, x, incx, lda, accum](IRFunctionEmitter& function, auto columnIndex) {
-                    auto aIndex = (rowIndex * lda) + columnIndex;
-                    auto xIndex = columnIndex * incx;
-                    auto aVal = A[aIndex];
-                    auto xVal = x[xIndex];
-                    auto aTimesX = aVal * xVal;
-                    function.Store(accum, function.Load(accum) + aTimesX);
-                });
-
-                auto yIndex = rowIndex * incy;
-                y[yIndex] = function.Load(accum);
+            auto C = function.LocalArray(&(*arguments++));
+            auto ldc = function.LocalScalar(&(*arguments++));
+            UNUSED(order);
+
+            auto packedBuffers = AllocatePackedBuffers(module, function, functionName, valueType, blocking.mc * blocking.kc, blocking.kc * blocking.nc);
+            auto Ap = function.LocalArray(packedBuffers.A);
+            auto Bp = function.LocalArray(packedBuffers.B);
+            LLVMValue tile = PackedBuffer(function, valueType, blocking.mr * blocking.nr);
+            llvm::VectorType* vectorType = module.GetCompilerOptions().allowVectorInstructions ? function.GetEmitter().VectorType(valueType, blocking.nr) : nullptr;
+
+            EmitScaleMatrix<ValueType>(function, m, n, beta, C, ldc);
+
+            // Dispatch once on the transpose flags, so the packing loops are specialized for each combination
+            auto emitProduct = [=](IRFunctionEmitter& function, bool transA, bool transB) {
+                EmitBlockedGEMM<ValueType>(function, transA, transB, blocking, vectorType, m, n, k, alpha, A, lda, B, ldb, C, ldc, Ap, Bp, tile);
+            };
+            function.If(transposeA, [=](IRFunctionEmitter& function) {
+                function.If(transposeB, [=](IRFunctionEmitter& function) { emitProduct(function, true, true); }).Else([=](IRFunctionEmitter& function) { emitProduct(function, true, false); });
+            }).Else([=](IRFunctionEmitter& function) {
+                function.If(transposeB, [=](IRFunctionEmitter& function) { emitProduct(function, false, true); }).Else([=](IRFunctionEmitter& function) { emitProduct(function, false, false); });
             });
 
+            FreePackedBuffers(function, packedBuffers);
             function.Return(function.Literal<int>(0));
             module.EndFunction();
             return function.GetFunction();
         }
 
         template <typename ValueType>
-        LLVMFunction EmitGEMMFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
+        LLVMFunction EmitGEMVFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
         {
-            const auto CblasNoTrans = 111;
-            const auto CblasTrans = 112;
+            // The number of rows of A processed together, so each element of x is loaded once per block
+            const int rowBlockSize = 4;
 
             auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
             auto arguments = function.Arguments().begin();
             auto order = &(*arguments++);
-            auto transposeA = function.LocalScalar(&(*arguments++)) == CblasTrans;
-            auto transposeB = function.LocalScalar(&(*arguments++)) == CblasTrans;
+            auto transpose = function.LocalScalar(&(*arguments++)) == CblasTrans;
             auto m = function.LocalScalar(&(*arguments++));
             auto n = function.LocalScalar(&(*arguments++));
-            auto k = function.LocalScalar(&(*arguments++));
             auto alpha = function.LocalScalar(&(*arguments++));
             auto A = function.LocalArray(&(*arguments++));
             auto lda = function.LocalScalar(&(*arguments++));
-            auto B = function.LocalArray(&(*arguments++));
-            auto ldb = function.LocalScalar(&(*arguments++));
+            auto x = function.LocalArray(&(*arguments++));
+            auto incx = function.LocalScalar(&(*arguments++));
             auto beta = function.LocalScalar(&(*arguments++));
-            auto C = function.LocalArray(&(*arguments++));
-            auto ldc = function.LocalScalar(&(*arguments++));
-            UNUSED(CblasNoTrans, order, alpha, beta);
-
-            // C = A x B, A: mxk, B: kxn, C: mxn
-            // A': kxm, B': nxk
-
-            // Loop orders:
-            // A*B:   i, k, j
-            // A'*B:  k, i, j
-            // A*B':  i, j, k
-            // A'*B': k, j, i (?)
-
-            // Clear output
-            auto count = ldc * m;
-            function.MemorySet<ValueType>(C, function.Literal<int>(0), function.Literal<uint8_t>(0), count);
-
-            // Accumulate partial values into output
-            function.For(m, [A, B, C, lda, ldb, ldc, transposeA, transposeB, n, k](IRFunctionEmitter& function, auto i) {
-                function.For(k, [i, A, B, C, lda, ldb, ldc, transposeA, transposeB, n](IRFunctionEmitter& function, auto k) {
-                    function.For(n, [i, k, A, B, C, lda, ldb, ldc, transposeA, transposeB](IRFunctionEmitter& function, auto j) {
-                        auto aOffset = function.LocalScalar(function.Select(transposeA, (k * lda) + i, (i * lda) + k));
-                        auto bOffset = function.LocalScalar(function.Select(transposeB, (j * ldb) + k, (k * ldb) + j));
-                        auto cOffset = (i * ldc) + j;
-
-                        // accumulate product in C[i, j]
-                        C[cOffset] = C[cOffset] + (A[aOffset] * B[bOffset]);
+            auto y = function.LocalArray(&(*arguments++));
+            auto incy = function.LocalScalar(&(*arguments++));
+            UNUSED(order);
+
+            std::vector<LLVMValue> accumulators;
+            for (int index = 0; index < rowBlockSize; ++index)
+            {
+                accumulators.push_back(function.Variable(emitters::GetVariableType<ValueType>(), "gemvAccum"));
+            }
+
+            // y = alpha * A * x + beta * y, computing `numRows` consecutive rows starting at `row`
+            auto emitRows = [=](IRFunctionEmitter& function, IRLocalScalar row, int numRows) {
+                for (int r = 0; r < numRows; ++r)
+                {
+                    function.StoreZero(accumulators[r]);
+                }
+                function.For(n, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                    IRLocalScalar xValue = x[j * incx];
+                    for (int r = 0; r < numRows; ++r)
+                    {
+                        auto sum = function.LocalScalar(function.Load(accumulators[r]));
+                        IRLocalScalar aValue = A[(row + r) * lda + j];
+                        function.Store(accumulators[r], sum + aValue * xValue);
+                    }
+                });
+                for (int r = 0; r < numRows; ++r)
+                {
+                    auto yOffset = (row + r) * incy;
+                    IRLocalScalar yValue = y[yOffset];
+                    auto scaledY = function.Select(beta == static_cast<ValueType>(0), function.Literal<ValueType>(0), beta * yValue);
+                    y[yOffset] = alpha * function.LocalScalar(function.Load(accumulators[r])) + scaledY;
+                }
+            };
+
+            function.If(transpose, [=](IRFunctionEmitter& function) {
+                // y = alpha * A' * x + beta * y: scale y, then accumulate one (contiguous) row of A at a time
+                function.For(n, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                    IRLocalScalar yValue = y[j * incy];
+                    y[j * incy] = function.Select(beta == static_cast<ValueType>(0), function.Literal<ValueType>(0), beta * yValue);
+                });
+                function.For(m, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    IRLocalScalar xValue = x[i * incx];
+                    auto scale = alpha * xValue;
+                    function.For(n, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                        auto yOffset = j * incy;
+                        y[yOffset] = y[yOffset] + scale * A[i * lda + j];
                     });
                 });
+            }).Else([=](IRFunctionEmitter& function) {
+                auto blockedRows = (m / rowBlockSize) * rowBlockSize;
+                function.For(function.LocalScalar<int>(0), blockedRows, function.LocalScalar<int>(rowBlockSize), [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    emitRows(function, i, rowBlockSize);
+                });
+                function.For(blockedRows, m, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    emitRows(function, i, 1);
+                });
             });
-            function.Return(function.Literal<int>(0));
 
+            function.Return(function.Literal<int>(0));
             module.EndFunction();
             return function.GetFunction();
         }
@@ -129,6 +419,7 @@ namespace emitters
     static const std::string& dotProductFloatName = "DotProductFloat";
     static const std::string& dotProductIntName = "DotProductInt";
     static const std::string& getTimeFunctionName = "GetTime";
+    static const std::string& getProfilerTicksPerMillisecondFunctionName = "GetProfilerTicksPerMillisecond";
 
     IRRuntime::IRRuntime(IRModuleEmitter& module) :
         _module(module),
@@ -313,6 +604,63 @@ namespace emitters
         return time;
     }
 
+    bool IRRuntime::HasCycleCounter() const
+    {
+        // Other architectures either have no cycle counter, or only allow reading it from privileged code by default
+        auto arch = llvm::Triple(_module.GetCompilerOptions().targetDevice.triple).getArch();
+        return arch == llvm::Triple::x86 || arch == llvm::Triple::x86_64;
+    }
+
+    LLVMValue IRRuntime::GetProfilerTicks(IRFunctionEmitter& function)
+    {
+        if (HasCycleCounter())
+        {
+            auto readCycleCounter = _module.GetIntrinsic(llvm::Intrinsic::readcyclecounter, std::initializer_list<LLVMType>{});
+            return function.Call(readCycleCounter, {});
+        }
+
+        // Otherwise, use nanoseconds from the millisecond timer
+        auto time = function.LocalScalar(GetCurrentTime(function));
+        return function.CastValue(time * 1000000.0, VariableType::Int64);
+    }
+
+    LLVMFunction IRRuntime::GetProfilerTicksPerMillisecondFunction()
+    {
+        if (_getProfilerTicksPerMillisecondFunction == nullptr)
+        {
+            const double calibrationTime = 10.0; // in milliseconds
+
+            auto functionName = GetNamespacePrefix() + "_" + getProfilerTicksPerMillisecondFunctionName;
+            auto function = _module.BeginFunction(functionName, VariableType::Double);
+            function.IncludeInHeader();
+            if (HasCycleCounter())
+            {
+                // Count the cycles that pass while spinning on the clock for the calibration time
+                auto startTime = function.LocalScalar(GetCurrentTime(function));
+                auto startTicks = function.LocalScalar(GetProfilerTicks(function));
+                auto endTimeVar = function.Variable(VariableType::Double, "endTime");
+                function.Store(endTimeVar, startTime);
+                auto isCalibrating = [startTime, endTimeVar, calibrationTime](IRFunctionEmitter& function) -> LLVMValue {
+                    return (function.LocalScalar(function.Load(endTimeVar)) - startTime) < calibrationTime;
+                };
+                function.While(isCalibrating, [this, endTimeVar](IRFunctionEmitter& function) {
+                    function.Store(endTimeVar, GetCurrentTime(function));
+                });
+                auto endTicks = function.LocalScalar(GetProfilerTicks(function));
+                auto elapsedTicks = function.LocalScalar(function.CastValue(endTicks - startTicks, VariableType::Double));
+                auto elapsedTime = function.LocalScalar(function.Load(endTimeVar)) - startTime;
+                function.Return(elapsedTicks / elapsedTime);
+            }
+            else
+            {
+                function.Return(function.Literal(1000000.0));
+            }
+            _module.EndFunction();
+            _getProfilerTicksPerMillisecondFunction = function.GetFunction();
+        }
+        return _getProfilerTicksPerMillisecondFunction;
+    }
+
     LLVMFunction IRRuntime::GetCurrentTimeFunction()
     {
         if (_getCurrentTimeFunction == nullptr)
@@ -50,7 +50,11 @@ namespace emitters
                 );
                 // clang-format on
 
-                auto resetFunctionName = _moduleName + "_Reset";
+                // A reentrant module's state belongs to the wrapper, so `reset` resets the wrapper that `predict` uses.
+                // A new wrapper starts from a freshly initialized state, so there is nothing to reset before the first call.
+                std::string resetBody = _isReentrant ?
+                                            "    if _model_wrapper is not None:\n        _model_wrapper.Reset()" :
+                                            "    " + _moduleName + "_Reset()";
                 std::string predictMethodName = TrimPrefix(_functionName, _moduleName + "_");
                 predictMethodName[0] = ::toupper(predictMethodName[0]); // pascal case
 
@@ -62,7 +66,7 @@ namespace emitters
                 ReplaceDelimiter(predictPythonCode, "WRAPPER_CLASS", className);
                 ReplaceDelimiter(predictPythonCode, "PREDICT_METHOD", predictMethodName);
                 ReplaceDelimiter(predictPythonCode, "INPUT_VECTOR_TYPE", inputVectorType);
-                ReplaceDelimiter(predictPythonCode, "RESET_FUNCTION", resetFunctionName);
+                ReplaceDelimiter(predictPythonCode, "RESET_BODY", resetBody);
 
                 os << "%pythoncode %{\n"
                    << predictPythonCode
@@ -77,6 +81,7 @@ namespace emitters
                 ModuleCallbackDefinitions moduleCallbacks(callbacks);
 
                 _functionName = _function->getName();
+                _isReentrant = moduleEmitter.GetFunction(_moduleName + "_GetStateSize") != nullptr;
 
                 if (moduleCallbacks.sources.empty())
                 {
@@ -115,6 +120,7 @@ namespace emitters
             std::string _functionName;
             std::string _inputType;
             bool _inputIsScalar;
+            bool _isReentrant;
             LLVMFunction _function;
         };
 
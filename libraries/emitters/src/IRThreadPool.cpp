@@ -23,6 +23,60 @@ namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // Each worker's task range is padded out to a cache line, so workers taking tasks don't contend for one
+        const int c_rangeStride = 8; // in int64 elements
+
+        // The number of times an idle thread yields before it parks on a condition variable
+        const int c_spinCount = 100;
+
+        int GetAlignment(LLVMValue pointer)
+        {
+            return static_cast<int>(pointer->getType()->getPointerElementType()->getPrimitiveSizeInBits() / 8);
+        }
+
+        LLVMValue AtomicLoad(IRFunctionEmitter& function, LLVMValue pointer)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto load = irBuilder.CreateLoad(pointer);
+            load->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+            load->setAlignment(GetAlignment(pointer));
+            return load;
+        }
+
+        void AtomicStore(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue value)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto store = irBuilder.CreateStore(value, pointer);
+            store->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+            store->setAlignment(GetAlignment(pointer));
+        }
+
+        // Returns the value before the addition
+        LLVMValue AtomicAdd(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue value)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, pointer, value, llvm::AtomicOrdering::SequentiallyConsistent);
+        }
+
+        // Returns true if the value was exchanged
+        LLVMValue CompareExchange(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue expected, LLVMValue desired)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto result = irBuilder.CreateAtomicCmpXchg(pointer, expected, desired, llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+            return irBuilder.CreateExtractValue(result, 1);
+        }
+
+        void Yield(IRFunctionEmitter& function)
+        {
+            auto& module = function.GetModule();
+            auto int32Type = llvm::Type::getInt32Ty(module.GetLLVMContext());
+            auto yieldFunction = module.DeclareFunction("sched_yield", llvm::FunctionType::get(int32Type, false));
+            function.Call(yieldFunction, {});
+        }
+    } // namespace
+
     //
     // IRThreadPool
     //
@@ -58,13 +112,14 @@ namespace emitters
             auto notInited = initThreadPoolFunction.LogicalNot(initThreadPoolFunction.Load(isInitedVar));
             initThreadPoolFunction.If(notInited, [this, int8PtrType, &isInitedVar](auto& initThreadPoolFunction) {
                 initThreadPoolFunction.Store(isInitedVar, initThreadPoolFunction.TrueBit());
-                _taskQueue.Initialize(initThreadPoolFunction);
+                _taskQueue.Initialize(initThreadPoolFunction, _maxThreads);
 
                 auto workerThreadFunction = this->GetWorkerThreadFunction(); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
                 llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
                 initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](auto& initThreadPoolFunction, LLVMValue index) {
+                    // Each worker gets its index as its argument
                     auto threadPtr = initThreadPoolFunction.PointerOffset(_threads, index);
-                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(_taskQueue.GetDataStruct(), int8PtrType));
+                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastIntToPointer(index, int8PtrType));
                 });
             });
         }
@@ -115,31 +170,28 @@ namespace emitters
         auto& context = _module.GetLLVMContext();
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
 
         auto workerThreadFunction = _module.BeginFunction("WorkerThreadFunction", int8PtrType, { int8PtrType });
         {
+            auto workerIndex = workerThreadFunction.CastPointerToInt(&(*workerThreadFunction.Arguments().begin()), int32Type);
             auto notDoneVar = workerThreadFunction.Variable(boolType, "notDone");
             workerThreadFunction.Store(notDoneVar, workerThreadFunction.TrueBit());
-            workerThreadFunction.While(notDoneVar, [this, notDoneVar](IRFunctionEmitter& workerThreadFunction) {
-                auto task = _taskQueue.PopNextTask(workerThreadFunction);
-                // check for a poison "null" task, indicating we should break out of the loop and terminate the thread
+            workerThreadFunction.While(notDoneVar, [this, notDoneVar, workerIndex](IRFunctionEmitter& workerThreadFunction) {
+                // Read the generation before looking for tasks, so tasks started while we look aren't missed
+                auto generation = _taskQueue.GetGeneration(workerThreadFunction);
+                auto task = _taskQueue.TakeTask(workerThreadFunction, workerIndex);
                 workerThreadFunction.If(
-                                        workerThreadFunction.Operator(TypedOperator::logicalOr, task.IsNull(workerThreadFunction), _taskQueue.GetShutdownFlag(workerThreadFunction)),
-                                        [notDoneVar](auto& workerThreadFunction) {
-                                            workerThreadFunction.Store(notDoneVar, workerThreadFunction.FalseBit());
+                                        workerThreadFunction.LogicalNot(task.IsNull(workerThreadFunction)),
+                                        [this, &task](IRFunctionEmitter& workerThreadFunction) {
+                                            task.Run(workerThreadFunction);
+                                            _taskQueue.FinishTask(workerThreadFunction);
                                         })
-                    .Else([this, &task](IRFunctionEmitter& workerThreadFunction) {
-                        task.Run(workerThreadFunction);
-
-                        // Decrement count of unfinished tasks
-                        _taskQueue.LockQueueMutex(workerThreadFunction);
-                        auto unfinishedCount = _taskQueue.DecrementUnfinishedTasks(workerThreadFunction);
-                        _taskQueue.UnlockQueueMutex(workerThreadFunction);
-
-                        // if zero, signal client cond var
-                        workerThreadFunction.If(workerThreadFunction.Comparison(TypedComparison::equals, unfinishedCount, workerThreadFunction.Literal<int>(0)), [this](auto& workerThreadFunction) {
-                            _taskQueue.NotifyWaitingClients(workerThreadFunction);
-                        });
+                    .ElseIf(_taskQueue.GetShutdownFlag(workerThreadFunction), [notDoneVar](IRFunctionEmitter& workerThreadFunction) {
+                        workerThreadFunction.Store(notDoneVar, workerThreadFunction.FalseBit());
+                    })
+                    .Else([this, generation](IRFunctionEmitter& workerThreadFunction) {
+                        _taskQueue.WaitForTasks(workerThreadFunction, generation);
                     });
             });
 
@@ -164,29 +216,30 @@ namespace emitters
         // Note: we can't initialize ourselves here, for ordering reasons.
     }
 
-    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function)
+    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function, size_t numWorkers)
     {
         if (_queueData != nullptr)
         {
             throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Error: initializing thread pool task queue more than once");
         }
         auto& module = function.GetModule();
+        _numWorkers = numWorkers;
 
         // Get types
         auto& context = module.GetLLVMContext();
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto int64Type = llvm::Type::getInt64Ty(context);
         auto taskQueueDataType = GetTaskQueueDataType(module);
 
-        // Allocate a data struct
+        // Allocate a data struct and the workers' task ranges, which start out empty
         _queueData = module.Global(taskQueueDataType, "taskQueueData");
+        _ranges = module.GlobalArray("taskRanges", int64Type, numWorkers * c_rangeStride);
+        _ranges->setAlignment(c_rangeStride * 8);
 
         // Get pointers to the fields
-        auto queueMutex = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::queueMutex));
-        auto workAvailableCondVar = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workAvailableCondVar));
-        auto workFinishedCondVar = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workFinishedCondVar));
-        auto count = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
-        auto unfinishedCount = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        auto shutdownFlag = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::shutdownFlag));
+        auto queueMutex = GetQueueMutexPointer(function);
+        auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
+        auto workFinishedCondVar = GetWorkFinishedConditionVariablePointer(function);
 
         // Initialize the fields
         llvm::ConstantPointerNull* nullAttr = function.NullPointer(int8PtrType);
@@ -194,11 +247,13 @@ namespace emitters
         errCode = function.PthreadCondInit(workAvailableCondVar, nullAttr);
         errCode = function.PthreadCondInit(workFinishedCondVar, nullAttr);
         UNUSED(errCode);
-        function.Store(count, function.Literal<int>(0));
-        function.Store(unfinishedCount, function.Literal<int>(0));
-        function.Store(shutdownFlag, function.FalseBit());
+        for (auto field : { Fields::unfinishedCount, Fields::shutdownFlag, Fields::generation, Fields::numParked })
+        {
+            function.Store(GetFieldPointer(function, static_cast<int>(field)), function.Literal<int>(0));
+        }
 
         _tasks.Initialize(function);
+        _takeTaskFunction = GetTakeTaskFunction(module);
     }
 
     IRThreadPoolTaskArray& IRThreadPoolTaskQueue::StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments)
@@ -208,48 +263,160 @@ namespace emitters
         // TODO: assert we're idle (until we can handle multiple task arrays to be active)
 
         const auto numTasks = arguments.size();
-
-        LockQueueMutex(function);
         _tasks.SetTasks(function, taskFunction, arguments);
-        SetInitialCount(function, function.Literal<int>(numTasks));
-        function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
-        UnlockQueueMutex(function);
+        AtomicStore(function, GetFieldPointer(function, static_cast<int>(Fields::unfinishedCount)), function.Literal<int>(numTasks));
+
+        // Give each worker a contiguous range of tasks, packed as (end << 32) | begin
+        for (size_t workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+        {
+            auto begin = static_cast<int64_t>(workerIndex * numTasks / _numWorkers);
+            auto end = static_cast<int64_t>((workerIndex + 1) * numTasks / _numWorkers);
+            AtomicStore(function, GetRangePointer(function, function.Literal<int>(workerIndex)), function.Literal<int64_t>((end << 32) | begin));
+        }
+
+        // Publish the tasks, and wake the workers if any are parked
+        AtomicAdd(function, GetFieldPointer(function, static_cast<int>(Fields::generation)), function.Literal<int>(1));
+        auto numParked = AtomicLoad(function, GetFieldPointer(function, static_cast<int>(Fields::numParked)));
+        function.If(function.Comparison(TypedComparison::notEquals, numParked, function.Literal<int>(0)), [this](auto& function) {
+            this->LockQueueMutex(function); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+            function.PthreadCondBroadcast(this->GetWorkAvailableConditionVariablePointer(function));
+            this->UnlockQueueMutex(function);
+        });
         return GetTaskArray();
     }
 
-    void IRThreadPoolTaskQueue::NotifyWaitingClients(IRFunctionEmitter& function)
-    {
-        function.PthreadCondBroadcast(GetWorkFinishedConditionVariablePointer(function));
+    LLVMFunction IRThreadPoolTaskQueue::GetTakeTaskFunction(IRModuleEmitter& module)
+    {
+        // This is the code we are generating:
+        //
+        // int ThreadPoolTakeTask(int workerIndex)
+        // {
+        //     int result = -1;
+        //     for (int i = 0; i < numWorkers && result < 0; ++i)
+        //     {
+        //         int victim = (workerIndex + i) % numWorkers;
+        //         bool isOwnRange = victim == workerIndex;
+        //         bool retry = true;
+        //         while (retry)
+        //         {
+        //             int64_t range = atomic_load(&ranges[victim * stride]);
+        //             int begin = (int)range, end = (int)(range >> 32);
+        //             retry = begin < end;
+        //             if (retry && compare_exchange(&ranges[victim * stride], range, isOwnRange ? range + 1 : range - (1 << 32)))
+        //             {
+        //                 result = isOwnRange ? begin : end - 1;
+        //                 retry = false;
+        //             }
+        //         }
+        //     }
+        //     return result;
+        // }
+        auto& context = module.GetLLVMContext();
+        auto& irBuilder = module.GetIREmitter().GetIRBuilder();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        auto numWorkers = static_cast<int>(_numWorkers);
+
+        auto function = module.BeginFunction("ThreadPoolTakeTask", int32Type, std::vector<LLVMType>{ int32Type });
+        {
+            auto workerIndex = &(*function.Arguments().begin());
+            auto resultVar = function.Variable(int32Type, "result");
+            auto victimOffsetVar = function.Variable(int32Type, "victimOffset");
+            auto retryVar = function.Variable(boolType, "retry");
+            function.Store(resultVar, function.Literal<int>(-1));
+            function.Store(victimOffsetVar, function.Literal<int>(0));
+
+            auto keepLooking = [=](IRFunctionEmitter& function) {
+                auto haveNoTask = function.Comparison(TypedComparison::lessThan, function.Load(resultVar), function.Literal<int>(0));
+                auto haveVictims = function.Comparison(TypedComparison::lessThan, function.Load(victimOffsetVar), function.Literal<int>(numWorkers));
+                return function.Operator(TypedOperator::logicalAnd, haveNoTask, haveVictims);
+            };
+            function.While(keepLooking, [=, &irBuilder](IRFunctionEmitter& function) {
+                auto victimOffset = function.Load(victimOffsetVar);
+                auto victim = function.Operator(TypedOperator::moduloSigned, function.Operator(TypedOperator::add, workerIndex, victimOffset), function.Literal<int>(numWorkers));
+                auto isOwnRange = function.Comparison(TypedComparison::equals, victim, workerIndex);
+                auto rangePtr = this->GetRangePointer(function, victim);
+
+                function.Store(retryVar, function.TrueBit());
+                function.While(retryVar, [=, &irBuilder](IRFunctionEmitter& function) {
+                    auto range = AtomicLoad(function, rangePtr);
+                    auto begin = irBuilder.CreateTrunc(range, int32Type);
+                    auto end = irBuilder.CreateTrunc(irBuilder.CreateLShr(range, 32), int32Type);
+                    auto isNotEmpty = function.Comparison(TypedComparison::lessThan, begin, end);
+                    function.Store(retryVar, isNotEmpty);
+                    function.If(isNotEmpty, [=, &irBuilder](IRFunctionEmitter& function) {
+                        // The owner takes from the front of its range, and thieves take from the back
+                        auto takeFront = irBuilder.CreateAdd(range, function.Literal<int64_t>(1));
+                        auto takeBack = irBuilder.CreateSub(range, function.Literal<int64_t>(int64_t{ 1 } << 32));
+                        auto newRange = function.Select(isOwnRange, takeFront, takeBack);
+                        function.If(CompareExchange(function, rangePtr, range, newRange), [=, &irBuilder](IRFunctionEmitter& function) {
+                            auto lastTask = irBuilder.CreateSub(end, function.Literal<int>(1));
+                            function.Store(resultVar, function.Select(isOwnRange, begin, lastTask));
+                            function.Store(retryVar, function.FalseBit());
+                        });
+                    });
+                });
+                function.Store(victimOffsetVar, function.Operator(TypedOperator::add, victimOffset, function.Literal<int>(1)));
+            });
+            function.Return(function.Load(resultVar));
+        }
+        module.EndFunction();
+        return function.GetFunction();
     }
 
-    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextTask(IRFunctionEmitter& function)
+    IRThreadPoolTask IRThreadPoolTaskQueue::TakeTask(IRFunctionEmitter& function, LLVMValue workerIndex)
     {
         assert(IsInitialized());
 
-        auto& module = function.GetModule();
-        auto& context = module.GetLLVMContext();
-        auto boolType = llvm::Type::getInt1Ty(context);
-
-        auto isEmptyVar = function.Variable(boolType, "isEmpty");
-        auto queueMutex = GetQueueMutexPointer(function);
-        auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
-
-        LockQueueMutex(function);
-        function.Store(isEmptyVar, function.Operator(TypedOperator::logicalAnd, IsEmpty(function), function.Operator(UnaryOperationType::logicalNot, GetShutdownFlag(function))));
-        function.While(isEmptyVar, [=](auto& function) {
-            // Wait on the condition variable
-            function.PthreadCondWait(workAvailableCondVar, queueMutex);
+        // Get task from task array --- passing in a negative number (which is what happens if there were no tasks left) returns a null task
+        auto taskIndex = function.Call(_takeTaskFunction, { workerIndex });
+        return _tasks.GetTask(function, taskIndex);
+    }
 
-            // update while loop exit condition
-            function.Store(isEmptyVar, function.Operator(TypedOperator::logicalAnd, this->IsEmpty(function), function.Operator(UnaryOperationType::logicalNot, this->GetShutdownFlag(function))));
+    void IRThreadPoolTaskQueue::FinishTask(IRFunctionEmitter& function)
+    {
+        auto previousCount = AtomicAdd(function, GetFieldPointer(function, static_cast<int>(Fields::unfinishedCount)), function.Literal<int>(-1));
+        function.If(function.Comparison(TypedComparison::equals, previousCount, function.Literal<int>(1)), [this](auto& function) {
+            // Broadcasting with the mutex held means a waiting thread can't miss it between checking the count and waiting
+            this->LockQueueMutex(function); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+            function.PthreadCondBroadcast(this->GetWorkFinishedConditionVariablePointer(function));
+            this->UnlockQueueMutex(function);
         });
+    }
 
-        // At loop exit, mutex is locked. Now decrement _count, unlock mutex, and return task at index _count
-        auto newCount = DecrementUnscheduledTasks(function);
-        UnlockQueueMutex(function);
+    void IRThreadPoolTaskQueue::WaitForTasks(IRFunctionEmitter& function, LLVMValue lastGeneration)
+    {
+        auto& context = function.GetLLVMContext();
+        auto int32Type = llvm::Type::getInt32Ty(context);
 
-        // Get task from task array --- passing in a negative number (which is what happens if the array was empty) returns a null task
-        return _tasks.GetTask(function, newCount);
+        auto isSameGeneration = [this, lastGeneration](IRFunctionEmitter& function) {
+            return function.Comparison(TypedComparison::equals, this->GetGeneration(function), lastGeneration);
+        };
+
+        // Spin for a while first, since tasks usually come in quick succession
+        auto spinCountVar = function.Variable(int32Type, "spinCount");
+        function.Store(spinCountVar, function.Literal<int>(0));
+        function.While([=](IRFunctionEmitter& function) {
+            auto isSpinning = function.Comparison(TypedComparison::lessThan, function.Load(spinCountVar), function.Literal<int>(c_spinCount));
+            return function.Operator(TypedOperator::logicalAnd, isSpinning, isSameGeneration(function));
+        },
+                       [=](IRFunctionEmitter& function) {
+                           Yield(function);
+                           function.Store(spinCountVar, function.Operator(TypedOperator::add, function.Load(spinCountVar), function.Literal<int>(1)));
+                       });
+
+        // Then park. The parked count is raised before the generation is checked, and StartTasks raises the generation
+        // before it checks the parked count, so either we see the new generation or StartTasks sees us and wakes us.
+        function.If(isSameGeneration(function), [this, isSameGeneration](IRFunctionEmitter& function) {
+            auto numParkedPtr = this->GetFieldPointer(function, static_cast<int>(Fields::numParked));
+            this->LockQueueMutex(function);
+            AtomicAdd(function, numParkedPtr, function.Literal<int>(1));
+            function.While(isSameGeneration, [this](IRFunctionEmitter& function) {
+                function.PthreadCondWait(this->GetWorkAvailableConditionVariablePointer(function), this->GetQueueMutexPointer(function));
+            });
+            AtomicAdd(function, numParkedPtr, function.Literal<int>(-1));
+            this->UnlockQueueMutex(function);
+        });
     }
 
     bool IRThreadPoolTaskQueue::IsInitialized() const
@@ -257,16 +424,11 @@ namespace emitters
         return _queueData != nullptr;
     }
 
-    LLVMValue IRThreadPoolTaskQueue::IsEmpty(IRFunctionEmitter& function) const
-    {
-        assert(IsInitialized());
-        return function.Comparison(TypedComparison::equals, GetUnscheduledCount(function), function.Literal<int>(0));
-    }
-
     LLVMValue IRThreadPoolTaskQueue::IsFinished(IRFunctionEmitter& function) const
     {
         assert(IsInitialized());
-        return function.Comparison(TypedComparison::equals, GetUnfinishedCount(function), function.Literal<int>(0));
+        auto unfinishedCount = AtomicLoad(function, GetFieldPointer(function, static_cast<int>(Fields::unfinishedCount)));
+        return function.Comparison(TypedComparison::equals, unfinishedCount, function.Literal<int>(0));
     }
 
     void IRThreadPoolTaskQueue::ShutDown(IRFunctionEmitter& function)
@@ -274,8 +436,11 @@ namespace emitters
         SetShutdownFlag(function);
 
         // Now wake up the threads so they see it is time to shutdown.
+        AtomicAdd(function, GetFieldPointer(function, static_cast<int>(Fields::generation)), function.Literal<int>(1));
+        LockQueueMutex(function);
         function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
-        // Now PopNextTask will emit null tasks
+        UnlockQueueMutex(function);
+        // Now TakeTask will return null tasks
     }
 
     void IRThreadPoolTaskQueue::WaitAll(IRFunctionEmitter& function)
@@ -283,17 +448,40 @@ namespace emitters
         auto& module = function.GetModule();
         auto& context = module.GetLLVMContext();
         auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        // Help out: run tasks no worker has taken yet on this thread. It has no range of its own, so it only steals.
+        auto foundTaskVar = function.Variable(boolType, "foundTask");
+        function.Store(foundTaskVar, function.TrueBit());
+        function.While(foundTaskVar, [this, foundTaskVar](IRFunctionEmitter& function) {
+            auto task = this->TakeTask(function, function.Literal<int>(static_cast<int>(_numWorkers)));
+            auto foundTask = function.LogicalNot(task.IsNull(function));
+            function.Store(foundTaskVar, foundTask);
+            function.If(foundTask, [this, &task](IRFunctionEmitter& function) {
+                task.Run(function);
+                this->FinishTask(function);
+            });
+        });
+
+        // Spin while the workers finish their last tasks, then wait for the last one to signal
+        auto spinCountVar = function.Variable(int32Type, "spinCount");
+        function.Store(spinCountVar, function.Literal<int>(0));
+        function.While([=](IRFunctionEmitter& function) {
+            auto isSpinning = function.Comparison(TypedComparison::lessThan, function.Load(spinCountVar), function.Literal<int>(c_spinCount));
+            return function.Operator(TypedOperator::logicalAnd, isSpinning, function.LogicalNot(this->IsFinished(function)));
+        },
+                       [=](IRFunctionEmitter& function) {
+                           Yield(function);
+                           function.Store(spinCountVar, function.Operator(TypedOperator::add, function.Load(spinCountVar), function.Literal<int>(1)));
+                       });
 
-        auto isNotDoneVar = function.Variable(boolType, "isNotDone");
         auto mutex = GetQueueMutexPointer(function);
         auto workFinishedCondVar = GetWorkFinishedConditionVariablePointer(function);
-
         LockQueueMutex(function);
-        function.Store(isNotDoneVar, function.Operator(UnaryOperationType::logicalNot, IsFinished(function)));
-        function.While(isNotDoneVar, [=](auto& function) {
-            function.PthreadCondWait(workFinishedCondVar, mutex);
-            function.Store(isNotDoneVar, function.Operator(UnaryOperationType::logicalNot, this->IsFinished(function))); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
-        });
+        function.While([this](IRFunctionEmitter& function) { return function.LogicalNot(this->IsFinished(function)); },
+                       [=](IRFunctionEmitter& function) {
+                           function.PthreadCondWait(workFinishedCondVar, mutex);
+                       });
         UnlockQueueMutex(function);
     }
 
@@ -302,89 +490,53 @@ namespace emitters
         auto& context = module.GetLLVMContext();
         auto mutexType = module.GetRuntime().GetPosixEmitter().GetPthreadMutexType();
         auto conditionVarType = module.GetRuntime().GetPosixEmitter().GetPthreadCondType();
-        auto boolType = llvm::Type::getInt1Ty(context);
         auto int32Type = llvm::Type::getInt32Ty(context);
 
-        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, boolType };
+        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, int32Type, int32Type };
         return module.GetAnonymousStructType(fieldTypes);
     }
 
-    LLVMValue IRThreadPoolTaskQueue::GetQueueMutexPointer(IRFunctionEmitter& function)
-    {
-        assert(IsInitialized());
-        return function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::queueMutex));
-    }
-
-    LLVMValue IRThreadPoolTaskQueue::GetWorkAvailableConditionVariablePointer(IRFunctionEmitter& function)
-    {
-        assert(IsInitialized());
-        return function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workAvailableCondVar));
-    }
-
-    LLVMValue IRThreadPoolTaskQueue::GetWorkFinishedConditionVariablePointer(IRFunctionEmitter& function)
-    {
-        assert(IsInitialized());
-        return function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workFinishedCondVar));
-    }
-
-    LLVMValue IRThreadPoolTaskQueue::GetUnscheduledCount(IRFunctionEmitter& function) const
+    LLVMValue IRThreadPoolTaskQueue::GetFieldPointer(IRFunctionEmitter& function, int field) const
     {
         assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
-        return function.Load(fieldPtr);
+        return function.GetStructFieldPointer(_queueData, field);
     }
 
-    LLVMValue IRThreadPoolTaskQueue::GetUnfinishedCount(IRFunctionEmitter& function) const
+    LLVMValue IRThreadPoolTaskQueue::GetRangePointer(IRFunctionEmitter& function, LLVMValue workerIndex) const
     {
         assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        return function.Load(fieldPtr);
+        return function.PointerOffset(_ranges, function.Operator(TypedOperator::multiply, workerIndex, function.Literal<int>(c_rangeStride)));
     }
 
-    void IRThreadPoolTaskQueue::SetInitialCount(IRFunctionEmitter& function, LLVMValue numTasks)
+    LLVMValue IRThreadPoolTaskQueue::GetQueueMutexPointer(IRFunctionEmitter& function)
     {
-        assert(IsInitialized());
-        function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount)), numTasks);
-        function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount)), numTasks);
+        return GetFieldPointer(function, static_cast<int>(Fields::queueMutex));
     }
 
-    LLVMValue IRThreadPoolTaskQueue::DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr)
+    LLVMValue IRThreadPoolTaskQueue::GetWorkAvailableConditionVariablePointer(IRFunctionEmitter& function)
     {
-        auto count = function.Load(fieldPtr);
-        auto newCount = function.Operator(TypedOperator::subtract, count, function.Literal<int>(1));
-        auto isNotZero = function.Comparison(TypedComparison::notEquals, count, function.Literal<int>(0));
-        function.If(isNotZero, [=](auto& function) {
-            function.Store(fieldPtr, newCount);
-        });
-        return newCount;
+        return GetFieldPointer(function, static_cast<int>(Fields::workAvailableCondVar));
     }
 
-    LLVMValue IRThreadPoolTaskQueue::DecrementUnscheduledTasks(IRFunctionEmitter& function)
+    LLVMValue IRThreadPoolTaskQueue::GetWorkFinishedConditionVariablePointer(IRFunctionEmitter& function)
     {
-        assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
-        return DecrementCountField(function, fieldPtr);
+        return GetFieldPointer(function, static_cast<int>(Fields::workFinishedCondVar));
     }
 
-    LLVMValue IRThreadPoolTaskQueue::DecrementUnfinishedTasks(IRFunctionEmitter& function)
+    LLVMValue IRThreadPoolTaskQueue::GetGeneration(IRFunctionEmitter& function) const
     {
-        assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        return DecrementCountField(function, fieldPtr);
+        return AtomicLoad(function, GetFieldPointer(function, static_cast<int>(Fields::generation)));
     }
 
     LLVMValue IRThreadPoolTaskQueue::GetShutdownFlag(IRFunctionEmitter& function) const
     {
-        assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::shutdownFlag));
-        return function.Load(fieldPtr);
+        auto shutdownFlag = AtomicLoad(function, GetFieldPointer(function, static_cast<int>(Fields::shutdownFlag)));
+        return function.Comparison(TypedComparison::notEquals, shutdownFlag, function.Literal<int>(0));
     }
 
     void IRThreadPoolTaskQueue::SetShutdownFlag(IRFunctionEmitter& function)
     {
-        assert(IsInitialized());
-        auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::shutdownFlag));
-        function.Store(fieldPtr, function.TrueBit());
+        AtomicStore(function, GetFieldPointer(function, static_cast<int>(Fields::shutdownFlag)), function.Literal<int>(1));
     }
 
     void IRThreadPoolTaskQueue::LockQueueMutex(IRFunctionEmitter& function)
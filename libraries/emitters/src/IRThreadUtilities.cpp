@@ -55,7 +55,10 @@ namespace emitters
                 taskFunctionArgs.push_back(taskWrapperFunction.Load(fieldPtr));
             }
 
+            auto& tracer = module.GetTracer();
+            auto traceBeginTicks = tracer.BeginEvent(taskWrapperFunction);
             auto functionResult = taskWrapperFunction.Call(taskFunction, taskFunctionArgs);
+            tracer.EndEvent(taskWrapperFunction, traceBeginTicks, taskFunctionName, TraceEventCategory::task);
             if (functionResult->getType()->isSized())
             {
                 auto resultCast = taskWrapperFunction.BitCast(functionResult, int8PtrType);
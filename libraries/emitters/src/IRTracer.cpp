@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRTracer.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRTracer.h"
+#include "EmitterException.h"
+#include "IRFunctionEmitter.h"
+#include "IRLocalScalar.h"
+#include "IRModuleEmitter.h"
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        enum class TraceEventFields
+        {
+            beginTicks = 0,
+            endTicks = 1,
+            threadId = 2,
+            name = 3,
+            category = 4
+        };
+
+        int RoundUpToPowerOfTwo(int value)
+        {
+            int result = 1;
+            while (result < value)
+            {
+                result *= 2;
+            }
+            return result;
+        }
+    } // namespace
+
+    IRTracer::IRTracer(IRModuleEmitter& module, bool enableTracing, int bufferSize) :
+        _module(&module),
+        _tracingEnabled(enableTracing)
+    {
+        if (_tracingEnabled && bufferSize < 1)
+        {
+            throw EmitterException(EmitterError::badFunctionArguments, "Trace buffer must hold at least one event");
+        }
+
+        // A power-of-two size lets the event index wrap around with a mask
+        _bufferSize = RoundUpToPowerOfTwo(bufferSize);
+    }
+
+    void IRTracer::Init() // Called by IRModuleEmitter
+    {
+        if (!_tracingEnabled)
+            return;
+
+        assert(_module != nullptr);
+
+        CreateStructTypes();
+        CreateTraceData();
+        EmitGetTraceEventsFunction();
+        EmitGetTraceBufferSizeFunction();
+        EmitGetNumTraceEventsFunction();
+        EmitResetTraceFunction();
+        _module->GetRuntime().GetProfilerTicksPerMillisecondFunction();
+    }
+
+    std::string IRTracer::GetGetTraceEventsFunctionName() const
+    {
+        return GetNamespacePrefix() + "_GetTraceEvents";
+    }
+
+    std::string IRTracer::GetGetTraceBufferSizeFunctionName() const
+    {
+        return GetNamespacePrefix() + "_GetTraceBufferSize";
+    }
+
+    std::string IRTracer::GetGetNumTraceEventsFunctionName() const
+    {
+        return GetNamespacePrefix() + "_GetNumTraceEvents";
+    }
+
+    std::string IRTracer::GetResetTraceFunctionName() const
+    {
+        return GetNamespacePrefix() + "_ResetTrace";
+    }
+
+    std::string IRTracer::GetNamespacePrefix() const
+    {
+        return _module->GetModuleName();
+    }
+
+    LLVMValue IRTracer::BeginEvent(IRFunctionEmitter& function)
+    {
+        if (!_tracingEnabled)
+            return nullptr;
+
+        return _module->GetRuntime().GetProfilerTicks(function);
+    }
+
+    void IRTracer::EndEvent(IRFunctionEmitter& function, LLVMValue beginTicks, const std::string& name, TraceEventCategory category)
+    {
+        if (!_tracingEnabled)
+            return;
+
+        assert(beginTicks != nullptr);
+        auto endTicks = _module->GetRuntime().GetProfilerTicks(function);
+
+        // Claim the next slot. Only the counter is shared between threads, so the increment doesn't need to order any other memory
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto eventIndex = irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, _traceEventCount, function.Literal<int64_t>(1), llvm::AtomicOrdering::Monotonic);
+        auto slot = function.LocalScalar(eventIndex) & function.LocalScalar<int64_t>(_bufferSize - 1);
+
+        auto events = function.CastPointer(_traceEventsArray, _traceEventType->getPointerTo());
+        auto eventPtr = function.PointerOffset(events, slot);
+        function.Store(function.GetStructFieldPointer(eventPtr, static_cast<size_t>(TraceEventFields::beginTicks)), beginTicks);
+        function.Store(function.GetStructFieldPointer(eventPtr, static_cast<size_t>(TraceEventFields::endTicks)), endTicks);
+        function.Store(function.GetStructFieldPointer(eventPtr, static_cast<size_t>(TraceEventFields::threadId)), GetThreadId(function));
+        function.Store(function.GetStructFieldPointer(eventPtr, static_cast<size_t>(TraceEventFields::name)), function.Literal(name));
+        function.Store(function.GetStructFieldPointer(eventPtr, static_cast<size_t>(TraceEventFields::category)), function.Literal(static_cast<int>(category)));
+    }
+
+    LLVMValue IRTracer::GetThreadId(IRFunctionEmitter& function)
+    {
+        // Code only runs on more than one thread when the module is parallelized
+        auto& posixRuntime = _module->GetRuntime().GetPosixEmitter();
+        if (_module->GetCompilerOptions().parallelize && posixRuntime.IsPthreadsAvailable())
+        {
+            return function.CastValue(function.PthreadSelf(), VariableType::Int64);
+        }
+        return function.Literal<int64_t>(0);
+    }
+
+    void IRTracer::CreateStructTypes()
+    {
+        auto& context = _module->GetLLVMContext();
+        auto int64Type = llvm::Type::getInt64Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+
+        NamedLLVMTypeList fields = { { "beginTicks", int64Type }, { "endTicks", int64Type }, { "threadId", int64Type }, { "name", int8PtrType }, { "category", int32Type } };
+        _traceEventType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_TraceEvent", fields);
+        _module->IncludeTypeInHeader(_traceEventType->getName());
+    }
+
+    void IRTracer::CreateTraceData()
+    {
+        _traceEventsArray = _module->GlobalArray(GetNamespacePrefix() + "_TraceEventsArray", _traceEventType, _bufferSize);
+        _traceEventCount = _module->Global(VariableType::Int64, GetNamespacePrefix() + "_TraceEventCount");
+    }
+
+    void IRTracer::EmitGetTraceEventsFunction()
+    {
+        auto function = _module->BeginFunction(GetGetTraceEventsFunctionName(), _traceEventType->getPointerTo());
+        function.IncludeInHeader();
+        function.Return(function.CastPointer(_traceEventsArray, _traceEventType->getPointerTo()));
+        _module->EndFunction();
+    }
+
+    void IRTracer::EmitGetTraceBufferSizeFunction()
+    {
+        auto function = _module->BeginFunction(GetGetTraceBufferSizeFunctionName(), VariableType::Int32);
+        function.IncludeInHeader();
+        function.Return(function.Literal(_bufferSize));
+        _module->EndFunction();
+    }
+
+    void IRTracer::EmitGetNumTraceEventsFunction()
+    {
+        auto function = _module->BeginFunction(GetGetNumTraceEventsFunctionName(), VariableType::Int64);
+        function.IncludeInHeader();
+        function.Return(function.Load(_traceEventCount));
+        _module->EndFunction();
+    }
+
+    void IRTracer::EmitResetTraceFunction()
+    {
+        auto function = _module->BeginFunction(GetResetTraceFunctionName(), VariableType::Void);
+        function.IncludeInHeader();
+        function.IncludeInSwigInterface();
+        function.Store(_traceEventCount, function.Literal<int64_t>(0));
+        _module->EndFunction();
+    }
+} // namespace emitters
+} // namespace ell
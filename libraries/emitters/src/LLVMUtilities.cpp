@@ -32,6 +32,8 @@ namespace emitters
 
     emitters::TypedOperator GetOperator(LLVMType type, BinaryOperationType operation)
     {
+        // vectors use the same operators as their elements
+        type = type->getScalarType();
         if (type->isIntegerTy())
         {
             return GetIntegerOperator(operation);
@@ -46,6 +48,7 @@ namespace emitters
 
     emitters::TypedComparison GetComparison(LLVMType type, BinaryPredicateType comparison)
     {
+        type = type->getScalarType();
         if (type->isIntegerTy())
         {
             return GetIntegerComparison(comparison);
@@ -10,3 +10,5 @@
 void TestIRAddFunction();
 void TestCompilableIRFunction();
 void TestStringCompareFunction();
+void TestNativeGEMMFunction(bool vectorize);
+void TestNativeGEMVFunction();
@@ -8,3 +8,5 @@
 #pragma once
 
 void TestProfileRegion();
+void TestLatencyHistogramBuckets();
+void TestTraceEvents();
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GEMMTiming.cpp (emitters_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GEMMTiming.h"
+
+#include <emitters/include/CompilerOptions.h>
+#include <emitters/include/IRExecutionEngine.h>
+#include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRRuntime.h>
+
+#include <math/include/BlasWrapper.h>
+#include <math/include/Matrix.h>
+
+#include <utilities/include/MillisecondTimer.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+
+namespace
+{
+const int CblasRowMajor = 101;
+const int CblasNoTrans = 111;
+const int CblasTrans = 112;
+
+// Minimum time, in milliseconds, to spend running each configuration
+const int minimumTime = 250;
+
+using GEMMFunction = void(bool transposeA, bool transposeB, int m, int n, int k, const float* A, const float* B, float* C);
+
+double GetGFlops(int m, int n, int k, std::function<GEMMFunction> gemm, bool transposeA, bool transposeB)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto random = [&engine, &distribution]() { return distribution(engine); };
+    std::vector<float> A(m * k);
+    std::vector<float> B(k * n);
+    std::vector<float> C(m * n);
+    std::generate(A.begin(), A.end(), random);
+    std::generate(B.begin(), B.end(), random);
+
+    // Warm up
+    gemm(transposeA, transposeB, m, n, k, A.data(), B.data(), C.data());
+
+    int numIterations = 0;
+    utilities::MillisecondTimer timer;
+    while (timer.Elapsed() < minimumTime)
+    {
+        gemm(transposeA, transposeB, m, n, k, A.data(), B.data(), C.data());
+        ++numIterations;
+    }
+    auto seconds = timer.Elapsed() / 1000.0;
+    return (2.0 * m * n * k * numIterations) / (seconds * 1.0e9);
+}
+
+std::function<GEMMFunction> GetNativeGEMM(IRExecutionEngine& executionEngine, const std::string& name)
+{
+    auto gemm = executionEngine.GetFunction<int(int, int, int, int, int, int, float, const float*, int, const float*, int, float, float*, int)>(name);
+    return [gemm](bool transposeA, bool transposeB, int m, int n, int k, const float* A, const float* B, float* C) {
+        gemm(CblasRowMajor, transposeA ? CblasTrans : CblasNoTrans, transposeB ? CblasTrans : CblasNoTrans, m, n, k, 1.0f, A, transposeA ? m : k, B, transposeB ? k : n, 0.0f, C, n);
+    };
+}
+} // namespace
+
+void TimeGEMM()
+{
+    // Compile both the scalar and the vectorized versions of the native GEMM function
+    CompilerOptions scalarOptions;
+    IRModuleEmitter scalarModule("ScalarGEMMTiming", scalarOptions);
+    std::string scalarName = scalarModule.GetRuntime().GetGEMMFunction<float>(false)->getName();
+    IRExecutionEngine scalarEngine(std::move(scalarModule));
+    auto scalarGEMM = GetNativeGEMM(scalarEngine, scalarName);
+
+    CompilerOptions vectorOptions;
+    vectorOptions.allowVectorInstructions = true;
+    vectorOptions.vectorWidth = 8;
+    IRModuleEmitter vectorModule("VectorGEMMTiming", vectorOptions);
+    std::string vectorName = vectorModule.GetRuntime().GetGEMMFunction<float>(false)->getName();
+    IRExecutionEngine vectorEngine(std::move(vectorModule));
+    auto vectorGEMM = GetNativeGEMM(vectorEngine, vectorName);
+
+#if USE_BLAS
+    // Compare against a single BLAS thread, since the native function is single-threaded
+    math::Blas::SetNumThreads(1);
+    std::function<GEMMFunction> blasGEMM = [](bool transposeA, bool transposeB, int m, int n, int k, const float* A, const float* B, float* C) {
+        auto transpose = [](bool t) { return t ? math::MatrixTranspose::transpose : math::MatrixTranspose::noTranspose; };
+        math::Blas::Gemm(math::MatrixLayout::rowMajor, transpose(transposeA), transpose(transposeB), m, n, k, 1.0f, A, transposeA ? m : k, B, transposeB ? k : n, 0.0f, C, n);
+    };
+#endif
+
+    std::cout << "Single-precision GEMM, GFLOP/s" << std::endl;
+    std::cout << std::setw(6) << "size" << std::setw(8) << "op" << std::setw(10) << "scalar" << std::setw(10) << "vector";
+#if USE_BLAS
+    std::cout << std::setw(10) << "BLAS";
+#endif
+    std::cout << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (int size : { 64, 128, 256, 512 })
+    {
+        for (auto transposeA : { false, true })
+        {
+            for (auto transposeB : { false, true })
+            {
+                std::string op = std::string(transposeA ? "T" : "N") + (transposeB ? "T" : "N");
+                std::cout << std::setw(6) << size << std::setw(8) << op;
+                std::cout << std::setw(10) << GetGFlops(size, size, size, scalarGEMM, transposeA, transposeB);
+                std::cout << std::setw(10) << GetGFlops(size, size, size, vectorGEMM, transposeA, transposeB);
+#if USE_BLAS
+                std::cout << std::setw(10) << GetGFlops(size, size, size, blasGEMM, transposeA, transposeB);
+#endif
+                std::cout << std::endl;
+            }
+        }
+    }
+}
@@ -24,7 +24,9 @@
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <string>
+#include <vector>
 
 using namespace ell;
 using namespace ell::emitters;
@@ -142,4 +144,118 @@ void TestStringCompareFunction()
     testing::ProcessTest("Testing string comparison function",
                          testing::IsEqual(u, 0) && testing::IsEqual(v, 0) && testing::IsEqual(x, 0) && testing::IsEqual(y, 0) &&
                              testing::IsEqual(z, 1));
-}
\ No newline at end of file
+}
+namespace
+{
+const int CblasRowMajor = 101;
+const int CblasNoTrans = 111;
+const int CblasTrans = 112;
+
+std::vector<double> GetRandomVector(size_t size, std::default_random_engine& engine)
+{
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<double> result(size);
+    for (auto& value : result)
+    {
+        value = distribution(engine);
+    }
+    return result;
+}
+} // namespace
+
+void TestNativeGEMMFunction(bool vectorize)
+{
+    CompilerOptions options;
+    options.allowVectorInstructions = vectorize;
+    IRModuleEmitter module("NativeGEMMModule", options);
+
+    std::string name = module.GetRuntime().GetGEMMFunction<double>(false)->getName();
+    IRExecutionEngine executionEngine(std::move(module));
+    auto gemm = executionEngine.GetFunction<int(int, int, int, int, int, int, double, const double*, int, const double*, int, double, double*, int)>(name);
+
+    // Sizes that aren't multiples of any of the block sizes, with k spanning several blocks
+    const int m = 37;
+    const int n = 70;
+    const int k = 150;
+    const double alpha = 0.5;
+    const double beta = -2.0;
+    std::default_random_engine engine(123);
+    bool ok = true;
+    for (auto transposeA : { false, true })
+    {
+        for (auto transposeB : { false, true })
+        {
+            const int lda = (transposeA ? m : k) + 1;
+            const int ldb = (transposeB ? k : n) + 3;
+            const int ldc = n + 2;
+            auto A = GetRandomVector((transposeA ? k : m) * lda, engine);
+            auto B = GetRandomVector((transposeB ? n : k) * ldb, engine);
+            auto C = GetRandomVector(m * ldc, engine);
+
+            auto expected = C;
+            for (int i = 0; i < m; ++i)
+            {
+                for (int j = 0; j < n; ++j)
+                {
+                    double sum = 0;
+                    for (int p = 0; p < k; ++p)
+                    {
+                        auto a = transposeA ? A[p * lda + i] : A[i * lda + p];
+                        auto b = transposeB ? B[j * ldb + p] : B[p * ldb + j];
+                        sum += a * b;
+                    }
+                    expected[i * ldc + j] = alpha * sum + beta * C[i * ldc + j];
+                }
+            }
+
+            gemm(CblasRowMajor, transposeA ? CblasTrans : CblasNoTrans, transposeB ? CblasTrans : CblasNoTrans, m, n, k, alpha, A.data(), lda, B.data(), ldb, beta, C.data(), ldc);
+            ok = ok && testing::IsEqual(C, expected, 1e-10);
+        }
+    }
+    testing::ProcessTest(std::string("Testing native GEMM function") + (vectorize ? " (vectorized)" : ""), ok);
+}
+
+void TestNativeGEMVFunction()
+{
+    CompilerOptions options;
+    IRModuleEmitter module("NativeGEMVModule", options);
+
+    std::string name = module.GetRuntime().GetGEMVFunction<double>(false)->getName();
+    IRExecutionEngine executionEngine(std::move(module));
+    auto gemv = executionEngine.GetFunction<int(int, int, int, int, double, const double*, int, const double*, int, double, double*, int)>(name);
+
+    const int m = 23;
+    const int n = 17;
+    const int lda = n + 1;
+    const int incx = 2;
+    const int incy = 3;
+    const double alpha = 1.5;
+    std::default_random_engine engine(456);
+    bool ok = true;
+    for (auto transpose : { false, true })
+    {
+        for (auto beta : { 0.0, 1.0, -0.5 })
+        {
+            const int xSize = transpose ? m : n;
+            const int ySize = transpose ? n : m;
+            auto A = GetRandomVector(m * lda, engine);
+            auto x = GetRandomVector(xSize * incx, engine);
+            auto y = GetRandomVector(ySize * incy, engine);
+
+            auto expected = y;
+            for (int i = 0; i < ySize; ++i)
+            {
+                double sum = 0;
+                for (int j = 0; j < xSize; ++j)
+                {
+                    sum += (transpose ? A[j * lda + i] : A[i * lda + j]) * x[j * incx];
+                }
+                expected[i * incy] = alpha * sum + (beta == 0 ? 0 : beta * y[i * incy]);
+            }
+
+            gemv(CblasRowMajor, transpose ? CblasTrans : CblasNoTrans, m, n, alpha, A.data(), lda, x.data(), incx, beta, y.data(), incy);
+            ok = ok && testing::IsEqual(y, expected, 1e-10);
+        }
+    }
+    testing::ProcessTest("Testing native GEMV function", ok);
+}
@@ -14,14 +14,17 @@
 #include <emitters/include/IREmitter.h>
 #include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLatencyHistogram.h>
 #include <emitters/include/IRModuleEmitter.h>
 #include <emitters/include/IRProfiler.h>
+#include <emitters/include/IRTracer.h>
 #include <emitters/include/Variable.h>
 
 #include <testing/include/testing.h>
 
 #include <utilities/include/Unused.h>
 
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -140,6 +143,17 @@ void TestProfileRegion()
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r1->count, 5));
     testing::ProcessTest("Testing profile regions", r0->totalTime > r1->totalTime);
 
+    // Check the latency histograms got a sample for each time the regions were executed
+    auto getNumSamples = [](const LatencyHistogram& histogram) {
+        return std::accumulate(std::begin(histogram.buckets), std::end(histogram.buckets), static_cast<int64_t>(0));
+    };
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(r0->latency.count, static_cast<int64_t>(10)));
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(r1->latency.count, static_cast<int64_t>(5)));
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(getNumSamples(r0->latency), r0->latency.count));
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(getNumSamples(r1->latency), r1->latency.count));
+    testing::ProcessTest("Testing profile region latency", r0->latency.minTicks <= r0->latency.maxTicks);
+    testing::ProcessTest("Testing profile region latency", r0->latency.maxTicks > r1->latency.minTicks);
+
     // Now reset profiler info and verify count and time are zero
     auto resetProfileResultsFunction = (VoidFunctionType)executionEngine.ResolveFunctionAddress(resetRegionsFunctionName);
     resetProfileResultsFunction();
@@ -150,4 +164,82 @@ void TestProfileRegion()
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r0->totalTime, 0.0));
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r1->count, 0));
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r1->totalTime, 0.0));
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(r0->latency.count, static_cast<int64_t>(0)));
+    testing::ProcessTest("Testing profile region latency", testing::IsEqual(getNumSamples(r0->latency), static_cast<int64_t>(0)));
+}
+
+void TestLatencyHistogramBuckets()
+{
+    // Every bucket starts after the previous one, and the last one can hold the largest 64-bit value
+    bool increasing = true;
+    for (int bucket = 1; bucket < numLatencyHistogramBuckets; ++bucket)
+    {
+        increasing = increasing && GetLatencyHistogramBucketLowerBound(bucket) > GetLatencyHistogramBucketLowerBound(bucket - 1);
+    }
+    testing::ProcessTest("Testing latency histogram buckets", increasing);
+    testing::ProcessTest("Testing latency histogram buckets", testing::IsEqual(GetLatencyHistogramBucketLowerBound(4), static_cast<int64_t>(4)));
+    testing::ProcessTest("Testing latency histogram buckets", testing::IsEqual(GetLatencyHistogramBucketLowerBound(9), static_cast<int64_t>(10)));
+    testing::ProcessTest("Testing latency histogram buckets", testing::IsEqual(GetLatencyHistogramBucketLowerBound(numLatencyHistogramBuckets - 1), static_cast<int64_t>(7) << 60));
+}
+
+void TestTraceEvents()
+{
+    CompilerOptions options;
+    options.optimize = false;
+    options.trace = true;
+    options.traceBufferSize = 3;
+    std::string moduleName = "TraceEvents";
+    IRModuleEmitter module(moduleName, options);
+
+    std::string functionName = "TestTraceEvents";
+    NamedVariableTypeList args;
+    args.push_back({ "x", VariableType::Double });
+    auto function = module.BeginFunction(functionName, VariableType::Double, args);
+    {
+        auto x = function.LocalScalar(function.GetFunctionArgument("x"));
+
+        // Profile regions are traced even when profiling is disabled
+        IRProfileRegion region(function, "TraceRegion");
+        region.Enter();
+        auto result = 5.0 * x;
+        region.Exit();
+        function.Return(result);
+    }
+    module.EndFunction();
+
+    auto& tracer = module.GetTracer();
+    testing::ProcessTest("Testing trace buffer size", testing::IsEqual(tracer.GetBufferSize(), 4));
+    auto getEventsFunctionName = tracer.GetGetTraceEventsFunctionName();
+    auto getNumEventsFunctionName = tracer.GetGetNumTraceEventsFunctionName();
+    auto resetFunctionName = tracer.GetResetTraceFunctionName();
+
+    IRExecutionEngine executionEngine(std::move(module));
+
+    using UnaryScalarDoubleFunctionType = double (*)(double);
+    auto compiledFunction = (UnaryScalarDoubleFunctionType)executionEngine.ResolveFunctionAddress(functionName);
+    auto getEvents = (TraceEvent * (*)()) executionEngine.ResolveFunctionAddress(getEventsFunctionName);
+    auto getNumEvents = (int64_t(*)()) executionEngine.ResolveFunctionAddress(getNumEventsFunctionName);
+    auto reset = (void (*)())executionEngine.ResolveFunctionAddress(resetFunctionName);
+
+    // Run the function more times than the buffer holds, so it wraps around
+    for (int index = 0; index < 6; ++index)
+    {
+        compiledFunction(static_cast<double>(index));
+    }
+    testing::ProcessTest("Testing trace event count", testing::IsEqual(getNumEvents(), static_cast<int64_t>(6)));
+
+    auto events = getEvents();
+    bool eventsOk = true;
+    for (int index = 0; index < 4; ++index)
+    {
+        const auto& event = events[index];
+        eventsOk = eventsOk && std::string(event.name) == "TraceRegion" && event.category == static_cast<int32_t>(TraceEventCategory::region) && event.endTicks >= event.beginTicks && event.threadId == 0;
+    }
+    testing::ProcessTest("Testing trace events", eventsOk);
+
+    // The 5th and 6th events overwrote the 1st and 2nd
+    testing::ProcessTest("Testing trace ring buffer", events[0].beginTicks >= events[3].endTicks && events[1].beginTicks >= events[0].endTicks);
+
+    reset();
+    testing::ProcessTest("Testing trace reset", testing::IsEqual(getNumEvents(), static_cast<int64_t>(0)));
 }
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPoolTiming.cpp (emitters_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPoolTiming.h"
+
+#include <emitters/include/CompilerOptions.h>
+#include <emitters/include/IRAsyncTask.h>
+#include <emitters/include/IRExecutionEngine.h>
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRModuleEmitter.h>
+
+#include <utilities/include/MillisecondTimer.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+
+namespace
+{
+// Minimum time, in milliseconds, to spend running each configuration
+const int minimumTime = 250;
+
+const std::string dispatchFunctionName = "DispatchTasks";
+
+using DispatchFunction = void (*)(int* data, int work);
+
+// Compiles a function that runs `numTasks` tasks and waits for them. Task `i` does `(i % 4 + 1) * work` iterations
+// of busywork, so the tasks are unevenly sized.
+std::unique_ptr<IRExecutionEngine> CompileDispatchFunction(int numTasks, int numThreads, bool useThreadPool)
+{
+    CompilerOptions options;
+    options.optimize = false; // keep the busywork loops from being folded away
+    options.targetDevice.deviceName = "host";
+    options.parallelize = true;
+    options.useThreadPool = useThreadPool;
+    options.maxThreads = numThreads;
+    IRModuleEmitter module("ThreadPoolTiming", options);
+
+    auto& context = module.GetLLVMContext();
+    LLVMType int32Type = llvm::Type::getInt32Ty(context);
+    LLVMType int32PtrType = int32Type->getPointerTo();
+
+    auto taskFunction = module.BeginFunction("TimingTaskFunction", int32Type, { int32PtrType, int32Type, int32Type });
+    {
+        auto arguments = taskFunction.Arguments().begin();
+        auto data = taskFunction.LocalArray(&(*arguments++));
+        auto index = taskFunction.LocalScalar(&(*arguments++));
+        auto work = taskFunction.LocalScalar(&(*arguments++));
+
+        auto numIterations = ((index % 4) + 1) * work;
+        taskFunction.For(numIterations, [data, index](IRFunctionEmitter& taskFunction, auto i) {
+            data[index] = data[index] + i;
+        });
+        taskFunction.Return(taskFunction.Literal<int>(0));
+    }
+    module.EndFunction();
+
+    auto dispatchFunction = module.BeginFunction(dispatchFunctionName, llvm::Type::getVoidTy(context), std::vector<LLVMType>{ int32PtrType, int32Type });
+    {
+        auto arguments = dispatchFunction.Arguments().begin();
+        auto data = &(*arguments++);
+        auto work = &(*arguments++);
+
+        std::vector<std::vector<LLVMValue>> taskArgs;
+        for (int index = 0; index < numTasks; ++index)
+        {
+            taskArgs.push_back({ data, dispatchFunction.Literal<int>(index), work });
+        }
+        auto tasks = dispatchFunction.StartTasks(taskFunction, taskArgs);
+        tasks.WaitAll(dispatchFunction);
+    }
+    module.EndFunction();
+
+    return std::make_unique<IRExecutionEngine>(std::move(module));
+}
+
+// Returns the average time, in microseconds, of one dispatch-and-wait
+double GetDispatchTime(int numTasks, int numThreads, bool useThreadPool, int work)
+{
+    auto executionEngine = CompileDispatchFunction(numTasks, numThreads, useThreadPool);
+    auto dispatch = (DispatchFunction)executionEngine->ResolveFunctionAddress(dispatchFunctionName);
+    std::vector<int> data(numTasks);
+
+    // Warm up (this also starts the pool's threads)
+    dispatch(data.data(), work);
+
+    int numIterations = 0;
+    utilities::MillisecondTimer timer;
+    while (timer.Elapsed() < minimumTime)
+    {
+        dispatch(data.data(), work);
+        ++numIterations;
+    }
+    return (1000.0 * timer.Elapsed()) / numIterations;
+}
+} // namespace
+
+void TimeThreadPool()
+{
+    const int numHardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < numHardwareThreads; numThreads *= 2)
+    {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(numHardwareThreads);
+
+    // Latency: as many empty tasks as threads, so the time is all in starting tasks, waking workers and waiting
+    std::cout << "Thread pool dispatch latency, microseconds per dispatch of empty tasks" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "pool" << std::setw(12) << "async" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (auto numThreads : threadCounts)
+    {
+        std::cout << std::setw(8) << numThreads;
+        std::cout << std::setw(12) << GetDispatchTime(numThreads, numThreads, true, 0);
+        std::cout << std::setw(12) << GetDispatchTime(numThreads, numThreads, false, 0);
+        std::cout << std::endl;
+    }
+
+    // Throughput: many small, uneven tasks, so idle workers have to steal to keep busy
+    const int numTasks = 256;
+    std::cout << "Thread pool throughput, thousands of uneven tasks per second (" << numTasks << " tasks per dispatch)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "work" << std::setw(12) << "pool" << std::setw(12) << "async" << std::endl;
+    for (auto numThreads : threadCounts)
+    {
+        for (int work : { 100, 10000 })
+        {
+            std::cout << std::setw(8) << numThreads << std::setw(8) << work;
+            std::cout << std::setw(12) << 1000.0 * numTasks / GetDispatchTime(numTasks, numThreads, true, work);
+            std::cout << std::setw(12) << 1000.0 * numTasks / GetDispatchTime(numTasks, numThreads, false, work);
+            std::cout << std::endl;
+        }
+    }
+}
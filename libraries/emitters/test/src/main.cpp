@@ -57,6 +57,9 @@ void TestIRFunction()
 {
     TestIRAddFunction();
     TestCompilableIRFunction();
+    TestNativeGEMMFunction(false);
+    TestNativeGEMMFunction(true);
+    TestNativeGEMVFunction();
 }
 
 void TestAsyncEmitter()
@@ -92,6 +95,8 @@ void TestPosixEmitter()
 void TestProfiler()
 {
     TestProfileRegion();
+    TestLatencyHistogramBuckets();
+    TestTraceEvents();
 }
 
 void TestStdlibEmitter()
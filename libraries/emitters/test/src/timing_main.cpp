@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (emitters_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GEMMTiming.h"
+#include "ThreadPoolTiming.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Unused.h>
+
+#include <iostream>
+
+using namespace ell;
+
+/// Runs all timings
+///
+int main(int argc, char** argv)
+{
+    UNUSED(argc);
+    UNUSED(argv);
+    try
+    {
+        TimeGEMM();
+        TimeThreadPool();
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "ERROR, got ELL exception. Message: " << exception.GetMessage() << std::endl;
+        throw;
+    }
+
+    return 0;
+}
@@ -38,6 +38,20 @@ namespace model
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         bool IsCompilable(const MapCompiler* compiler) const override { return true; }
 
+        /// <summary> Indicates if the node can be compiled into the map's batch predict function with `CompileNodeBatch`. </summary>
+        ///
+        /// <param name="compiler"> The compiler that compiled the node into the map's predict function </param>
+        bool CanCompileNodeBatch(IRMapCompiler& compiler) const;
+
+        /// <summary>
+        /// Compiles the node into the map's batch predict function, which computes each node for all the inputs of a batch
+        /// before moving on to the next one. Must be called after the node was compiled into the predict function.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The compiler to use when compiling the node </param>
+        /// <param name="function"> The batch predict function </param>
+        void CompileNodeBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+
     protected:
         CompilableNode(const std::vector<InputPortBase*>& inputs, const std::vector<OutputPortBase*>& outputs) :
             Node(inputs, outputs) {}
@@ -50,6 +64,12 @@ namespace model
         // Virtual functions to optionally change how the node is compiled
         //
 
+        // Emits code that computes the node for all the inputs of a batch at once, for nodes with a cheaper batched form
+        // than computing each input in turn (e.g., a matrix-vector product that becomes a matrix-matrix product). The
+        // buffers holding the ports' values come from `IRMapCompiler::GetBatchPortBuffer`. The default implementation
+        // emits nothing and returns false, in which case the node's function is called once for each input.
+        virtual bool CompileBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+
         // Returns true if the compiler should try to inline the node. The default implementation is
         // a heuristic based on the complexity of the input ports.
         // Subclasses should override if they need different behavior.
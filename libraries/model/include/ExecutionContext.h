@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ExecutionContext.h (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Node;
+    class OutputPortBase;
+
+    /// <summary>
+    /// Holds the values computed by one evaluation of a model (the output of each port, and the values of its input nodes)
+    /// apart from the model itself. While an execution context is current on a thread, `Model::ComputeOutput` and
+    /// `Map::Compute` on that thread read and write the context instead of the model, so several threads can evaluate
+    /// one shared model at once, each with its own context.
+    /// </summary>
+    ///
+    /// Nodes that need scratch space to compute (such as neural network layers) keep it in the context too, through
+    /// `GetNodeState`. Nodes that keep state between evaluations (those that return false from `Node::IsComputeReentrant`,
+    /// such as nodes keeping a history of past inputs) still keep it in the model, so each of them belongs to the first
+    /// context that computes it, until that context is cleared or destroyed, and computing it in any other context throws.
+    class ExecutionContext
+    {
+    public:
+        ExecutionContext() = default;
+        ExecutionContext(const ExecutionContext&) = delete;
+        ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+        /// <summary> Destructor. Releases the nodes this context has claimed. </summary>
+        ~ExecutionContext();
+
+        /// <summary> Makes an execution context current on this thread for the lifetime of this object. </summary>
+        class Scope
+        {
+        public:
+            /// <summary> Constructor </summary>
+            ///
+            /// <param name="context"> The context to make current. </param>
+            Scope(ExecutionContext& context);
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            /// <summary> Destructor. Restores the context that was current before. </summary>
+            ~Scope();
+
+        private:
+            ExecutionContext* _previous;
+        };
+
+        /// <summary> Gets the execution context current on this thread. </summary>
+        ///
+        /// <returns> The current context, or nullptr if computed values are kept in the model. </returns>
+        static ExecutionContext* GetCurrent();
+
+        /// <summary> Gets the buffer holding the output of a port in this context, creating an empty one if necessary. </summary>
+        ///
+        /// <param name="port"> The port. </param>
+        template <typename ValueType>
+        std::vector<ValueType>& GetPortValues(const OutputPortBase& port);
+
+        /// <summary> Gets the values held for a node in this context (e.g., the values given to an input node), creating empty ones if necessary. </summary>
+        ///
+        /// <param name="node"> The node. </param>
+        template <typename ValueType>
+        std::vector<ValueType>& GetNodeValues(const Node& node);
+
+        /// <summary> Gets the working state a node keeps in this context (e.g., its scratch space), creating it if necessary. </summary>
+        ///
+        /// <param name="node"> The node. </param>
+        /// <param name="create"> A function returning the initial state, called the first time the node asks for it in this context. </param>
+        template <typename StateType, typename CreateFunction>
+        StateType& GetNodeState(const Node& node, CreateFunction&& create);
+
+        /// <summary>
+        /// Claims a node that keeps state between evaluations for this context. Throws a `LogicException` if another
+        /// context has already claimed it, since their evaluations would share (and corrupt) its state.
+        /// </summary>
+        ///
+        /// <param name="node"> The node. </param>
+        void ClaimNode(const Node& node);
+
+        /// <summary> Discards all the values held in this context, and releases the nodes it has claimed. </summary>
+        void Clear();
+
+    private:
+        struct StateBase
+        {
+            virtual ~StateBase() = default;
+        };
+
+        template <typename StateType>
+        struct State : StateBase
+        {
+            State(StateType value) :
+                value(std::move(value)) {}
+            StateType value;
+        };
+
+        template <typename StateType, typename KeyType, typename CreateFunction>
+        static StateType& GetState(std::unordered_map<const KeyType*, std::unique_ptr<StateBase>>& map, const KeyType* key, CreateFunction&& create);
+
+        void ReleaseNodes();
+
+        std::unordered_map<const OutputPortBase*, std::unique_ptr<StateBase>> _portValues;
+        std::unordered_map<const Node*, std::unique_ptr<StateBase>> _nodeStates;
+        std::unordered_set<const Node*> _claimedNodes;
+    };
+} // namespace model
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace model
+{
+    template <typename StateType, typename KeyType, typename CreateFunction>
+    StateType& ExecutionContext::GetState(std::unordered_map<const KeyType*, std::unique_ptr<StateBase>>& map, const KeyType* key, CreateFunction&& create)
+    {
+        auto& entry = map[key];
+        if (!entry)
+        {
+            entry = std::make_unique<State<StateType>>(create());
+        }
+        return static_cast<State<StateType>&>(*entry).value;
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType>& ExecutionContext::GetPortValues(const OutputPortBase& port)
+    {
+        return GetState<std::vector<ValueType>>(_portValues, &port, [] { return std::vector<ValueType>(); });
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType>& ExecutionContext::GetNodeValues(const Node& node)
+    {
+        return GetNodeState<std::vector<ValueType>>(node, [] { return std::vector<ValueType>(); });
+    }
+
+    template <typename StateType, typename CreateFunction>
+    StateType& ExecutionContext::GetNodeState(const Node& node, CreateFunction&& create)
+    {
+        return GetState<StateType>(_nodeStates, &node, std::forward<CreateFunction>(create));
+    }
+} // namespace model
+} // namespace ell
+
+#pragma endregion implementation
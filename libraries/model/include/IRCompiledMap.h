@@ -113,6 +113,9 @@ namespace model
         /// <summary> Get a pointer to the performance counters struct for the whole model. </summary>
         PerformanceCounters* GetModelPerformanceCounters();
 
+        /// <summary> Get a pointer to the latency histogram for the whole model. </summary>
+        LatencyHistogram* GetModelLatencyHistogram();
+
         /// <summary> Print a summary of the performance for the model. </summary>
         void PrintModelProfilingInfo();
 
@@ -132,6 +135,16 @@ namespace model
         /// <param name="nodeIndex"> the index of the node. </param>
         PerformanceCounters* GetNodePerformanceCounters(int nodeIndex);
 
+        /// <summary> Get a pointer to the latency histogram for a node. </summary>
+        ///
+        /// <param name="nodeIndex"> the index of the node. </param>
+        LatencyHistogram* GetNodeLatencyHistogram(int nodeIndex);
+
+        /// <summary> Get a pointer to the hardware counter totals for a node. The map must have been compiled with the `profileHardwareCounters` option. </summary>
+        ///
+        /// <param name="nodeIndex"> the index of the node. </param>
+        HardwareCounters* GetNodeHardwareCounters(int nodeIndex);
+
         /// <summary> Print a summary of the performance for the nodes. </summary>
         void PrintNodeProfilingInfo();
 
@@ -151,6 +164,16 @@ namespace model
         /// <param name="nodeIndex"> the index of the node type. </param>
         PerformanceCounters* GetNodeTypePerformanceCounters(int nodeIndex);
 
+        /// <summary> Get a pointer to the aggregated latency histogram for a node type. </summary>
+        ///
+        /// <param name="nodeIndex"> the index of the node type. </param>
+        LatencyHistogram* GetNodeTypeLatencyHistogram(int nodeIndex);
+
+        /// <summary> Get a pointer to the aggregated hardware counter totals for a node type. The map must have been compiled with the `profileHardwareCounters` option. </summary>
+        ///
+        /// <param name="nodeIndex"> the index of the node type. </param>
+        HardwareCounters* GetNodeTypeHardwareCounters(int nodeIndex);
+
         /// <summary> Get a pointer to the named global array. </summary>
         ///
         /// <param name="name"> name of the global. </param>
@@ -178,6 +201,29 @@ namespace model
         /// <summary> Reset the performance summary for the model to zero. </summary>
         void ResetRegionProfilingInfo();
 
+        /// <summary> Get the number of profiler ticks per millisecond, the unit of the latency histograms. </summary>
+        ///
+        /// <remarks> On targets that count cycles, this measures the rate, which takes about 10 ms. </remarks>
+        double GetProfilerTicksPerMillisecond();
+
+        //
+        // Tracing support
+        //
+
+        /// <summary> Get a pointer to the trace buffer, which holds `GetTraceBufferSize()` events. The map must have been compiled with the `trace` option. </summary>
+        ///
+        /// <remarks> Event `i` is stored at index `i % GetTraceBufferSize()`, so once the buffer is full, new events overwrite the oldest ones. </remarks>
+        emitters::TraceEvent* GetTraceEvents();
+
+        /// <summary> Get the number of events the trace buffer holds. </summary>
+        int GetTraceBufferSize();
+
+        /// <summary> Get the number of events recorded since the trace was last reset, including the ones that have been overwritten. </summary>
+        int64_t GetNumTraceEvents();
+
+        /// <summary> Clear the trace buffer. </summary>
+        void ResetTrace();
+
         //
         // Just-in-time compilation functions
         //
@@ -185,12 +231,35 @@ namespace model
         /// <summary> Force jitting to finish so you can time execution without jit cost. </summary>
         void FinishJitting() const;
 
+        /// <summary>
+        /// Computes the outputs for a batch of inputs with one call into the compiled `<mapFunctionName>_batch` function.
+        /// The map must have been compiled with the `emitBatchPredict` option.
+        /// </summary>
+        ///
+        /// <typeparam name="InputType"> The map's input element type. </typeparam>
+        /// <typeparam name="OutputType"> The map's output element type. </typeparam>
+        /// <param name="count"> The number of inputs in the batch. </param>
+        /// <param name="inputs"> The inputs, stored consecutively: `count` times the map's input size. </param>
+        /// <param name="outputs"> The buffer receiving the outputs, stored consecutively: `count` times the map's output size. </param>
+        template <typename InputType, typename OutputType>
+        void ComputeBatch(size_t count, const InputType* inputs, OutputType* outputs) const;
+
         /// <summary> Set a context object to use in the predict call </summary>
-        void SetContext(void* context) { _context = context; }
+        void SetContext(void* context);
 
         /// <summary> Get the context object to use in the predict call </summary>
         void* GetContext() const { return _context; }
 
+        /// <summary> Get the key of this map's object code in the object cache, for maps compiled with an `objectCacheDirectory` </summary>
+        ///
+        /// <returns> The key, or an empty string if object caching is disabled </returns>
+        const std::string& GetObjectCacheKey() const { return _objectCacheKey; }
+
+        /// <summary> Get the per-instance state buffer passed to the predict call, for maps compiled with the `reentrant` option </summary>
+        ///
+        /// <returns> A pointer to the state buffer, or `nullptr` if the map isn't reentrant </returns>
+        void* GetState() const;
+
     protected:
         void WriteCode(const std::string& filePath, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
         void WriteCode(std::ostream& stream, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
@@ -213,6 +282,8 @@ namespace model
         IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule);
 
         void EnsureExecutionEngine() const;
+        void EnsureState() const;
+        void* GetPredictContext() const;
         void SetComputeFunction() const;
         template <typename InputType>
         void SetComputeFunctionForInputType() const;
@@ -225,8 +296,17 @@ namespace model
 
         mutable std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
         bool _verifyJittedModule = false;
+
+        // The key of this map's object code in the object cache (see `MapCompilerOptions::objectCacheDirectory`), if caching is enabled.
+        // The module isn't optimized when the object is expected to be found, so a fresh compilation of it isn't stored.
+        std::string _objectCacheKey;
+        bool _storeCompiledObject = true;
         void* _context = nullptr;
 
+        // The state buffer for reentrant maps, aligned to the module's requirements
+        mutable std::unique_ptr<uint8_t[]> _stateStorage;
+        mutable void* _state = nullptr;
+
         template <typename T>
         using Vector = std::vector<std::conditional_t<std::is_same_v<bool, T>, Boolean, T>>;
 
@@ -313,6 +393,25 @@ namespace model
         }
     }
 
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::ComputeBatch(size_t count, const InputType* inputs, OutputType* outputs) const
+    {
+        if (!_compilerOptions.emitBatchPredict)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Map wasn't compiled with a batch predict function");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        FinishJitting();
+        auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName + "_batch");
+        auto fn = reinterpret_cast<void (*)(void*, int32_t, const InputType*, OutputType*)>(functionPointer);
+        fn(GetPredictContext(), static_cast<int32_t>(count), inputs, outputs);
+    }
+
     template <typename ElementType>
     ElementType* IRCompiledMap::GetGlobalValuePointer(const std::string& name)
     {
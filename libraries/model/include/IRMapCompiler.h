@@ -14,15 +14,18 @@
 #include "Node.h"
 #include "NodeMap.h"
 #include "OutputPort.h"
+#include "PortMemoryPlanner.h"
 
 #include <model/optimizer/include/ModelOptimizer.h>
 
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRReentrantState.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <utilities/include/Logger.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace ell
@@ -63,6 +66,11 @@ namespace model
         /// <summary> Get the optimizer used by this compiler. </summary>
         ModelOptimizer& GetOptimizer() { return _optimizer; }
 
+        /// <summary> Gets a report of the memory saved by sharing port variable storage (see `MapCompilerOptions::sharePortMemory`). </summary>
+        ///
+        /// <returns> The report for the most recently compiled map. </returns>
+        const PortMemoryReport& GetPortMemoryReport() const { return _portMemoryPlanner.GetReport(); }
+
         //
         // Routines useful to Node implementers
         //
@@ -152,7 +160,44 @@ namespace model
         /// <returns> The generated name. </returns>
         std::string GetGlobalName(const Node& node, const std::string& baseName) const;
 
+        /// <summary>
+        /// Gets the number of inputs the batch predict function computes one node at a time (see `MapCompilerOptions::batchTileSize`).
+        /// Only meaningful while the batch predict function is being emitted (see `CompilableNode::CompileBatch`).
+        /// </summary>
+        ///
+        /// <returns> The number of inputs in each tile of the batch. </returns>
+        int GetBatchSize() const { return _batchSize; }
+
+        /// <summary> Indicates if a port has a value for each input of the batch, or a single value shared by all of them. </summary>
+        ///
+        /// <param name="port"> The port to check. </param>
+        /// <returns> `true` if the port has a value for each input of the batch. </returns>
+        bool IsBatchedPort(const OutputPortBase& port) const;
+
+        /// <summary> Indicates if the port referenced by an input port has a value for each input of the batch. </summary>
+        ///
+        /// <param name="port"> The input port to check. </param>
+        /// <returns> `true` if the referenced port has a value for each input of the batch. </returns>
+        bool IsBatchedPort(const InputPortBase& port) const;
+
+        /// <summary>
+        /// Gets the buffer holding a port's values in the batch predict function. The values a batched port has for
+        /// consecutive inputs of the batch are `port.Size()` elements apart.
+        /// </summary>
+        ///
+        /// <param name="port"> The port. </param>
+        /// <returns> A pointer to the port's values. </returns>
+        emitters::LLVMValue GetBatchPortBuffer(const OutputPortBase& port) const;
+
+        /// <summary> Gets the buffer holding the values of the port referenced by an input port in the batch predict function. </summary>
+        ///
+        /// <param name="port"> The input port. </param>
+        /// <returns> A pointer to the referenced port's values. </returns>
+        emitters::LLVMValue GetBatchPortBuffer(const InputPortBase& port) const;
+
     protected:
+        using MapCompiler::AllocatePortVariable;
+        emitters::Variable* AllocatePortVariable(const OutputPortBase& port) override;
         void OnBeginCompileModel(const Model& model) override;
         void OnEndCompileModel(const Model& model) override;
         void OnBeginCompileNode(const Node& node) override;
@@ -173,6 +218,10 @@ namespace model
         const Node* GetUniqueParent(const Node& node);
         bool TryMergeNodeIntoRegion(emitters::IRBlockRegion* pDestination, const Node& src);
 
+        bool IsSharingPortMemory() const;
+        llvm::GlobalVariable* GetSharedPortMemoryPlaceholder();
+        void EmitSharedPortMemory();
+
         void EmitGetInputSizeFunction(const Map& map);
         void EmitGetOutputSizeFunction(const Map& map);
         void EmitGetSinkOutputSizeFunction(const Map& map);
@@ -188,8 +237,28 @@ namespace model
         void EmitGetMetadataFunction(const Map& map);
         void EmitStringConditionals(emitters::IRFunctionEmitter& fn, std::vector<std::pair<std::string, std::string>> keyValuePairs);
 
+        emitters::LLVMFunction EmitBatchPredictFunction(const Map& map, const std::string& functionName, bool isPublic);
+        bool CanSplitBatchPredict(const Map& map);
+        void EmitParallelBatchPredictFunction(const Map& map, emitters::LLVMFunction batchFunction, const emitters::ReentrantStateInfo& stateInfo);
+
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        // storage shared by port variables with non-overlapping lifetimes
+        PortMemoryPlanner _portMemoryPlanner;
+        llvm::GlobalVariable* _sharedPortMemoryPlaceholder = nullptr;
+
+        // start times of the trace events for the nodes being compiled
+        std::vector<emitters::LLVMValue> _nodeTraceBeginTicks;
+
+        // the buffers holding the port values in the batch predict function being emitted
+        struct BatchPortBuffer
+        {
+            emitters::LLVMValue values;
+            bool isBatched;
+        };
+        int _batchSize = 1;
+        std::unordered_map<const OutputPortBase*, BatchPortBuffer> _batchPortBuffers;
     };
 } // namespace model
 } // namespace ell
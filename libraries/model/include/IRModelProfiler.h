@@ -12,6 +12,7 @@
 #include "Node.h"
 
 #include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLatencyHistogram.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <map>
@@ -33,6 +34,16 @@ struct PerformanceCounters
     int count;
     double totalTime;
 };
+
+/// <summary> A struct that holds the totals of the hardware performance counters read while a node ran. </summary>
+struct HardwareCounters
+{
+    int64_t cycles;
+    int64_t instructions;
+    int64_t l1DataCacheMisses;
+    int64_t lastLevelCacheMisses;
+    int64_t branchMisses;
+};
 }
 
 namespace ell
@@ -45,11 +56,16 @@ namespace emitters
 
 namespace model
 {
-    // import NodeInfo and PerformanceCounters into our namespace
+    // import NodeInfo, PerformanceCounters, HardwareCounters and LatencyHistogram into our namespace
+    using ::HardwareCounters;
+    using ::LatencyHistogram;
     using ::NodeInfo;
     using ::PerformanceCounters;
     class Model;
 
+    /// <summary> The number of fields in a `HardwareCounters` struct. </summary>
+    constexpr int numHardwareCounters = 5;
+
     /// <summary> A utility class that emits IR to populate NodeInfo structs. </summary>
     class NodeInfoEmitter
     {
@@ -70,7 +86,10 @@ namespace model
         llvm::StructType* _nodeInfoType = nullptr;
     };
 
-    /// <summary> A utility class that emits IR to populate PerformanceCounters structs. </summary>
+    /// <summary>
+    /// A utility class that emits IR to populate PerformanceCounters structs, and the LatencyHistogram and optional
+    /// HardwareCounters kept alongside them.
+    /// </summary>
     class PerformanceCountersEmitter
     {
     public:
@@ -81,18 +100,23 @@ namespace model
         friend class ModelProfiler;
         friend class NodePerformanceEmitter;
 
-        PerformanceCountersEmitter(emitters::IRModuleEmitter& module, emitters::LLVMValue performanceCountersPtr, llvm::StructType* performanceCountersType);
+        // hardwareCountersPtr and the hardware counter values passed to Start and End are null if hardware counters aren't profiled
+        PerformanceCountersEmitter(emitters::IRModuleEmitter& module, emitters::LLVMValue performanceCountersPtr, llvm::StructType* performanceCountersType, emitters::LLVMValue latencyHistogramPtr, emitters::LLVMValue hardwareCountersPtr);
         void Init(emitters::IRFunctionEmitter& function);
-        void Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime);
-        void End(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime);
+        void Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime, emitters::LLVMValue startTicks, emitters::LLVMValue startHardwareCounters);
+        void End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime, emitters::LLVMValue endTicks, emitters::LLVMValue endHardwareCounters);
         void Reset(emitters::IRFunctionEmitter& function);
 
         emitters::IRModuleEmitter* _module = nullptr;
         emitters::LLVMValue _performanceCountersPtr = nullptr;
         llvm::StructType* _performanceCountersType = nullptr;
+        emitters::LLVMValue _latencyHistogramPtr = nullptr;
+        emitters::LLVMValue _hardwareCountersPtr = nullptr;
 
-        // Temporary value used during processing
+        // Temporary values used during processing
         emitters::LLVMValue _startTime = nullptr;
+        emitters::LLVMValue _startTicks = nullptr;
+        emitters::LLVMValue _startHardwareCounters = nullptr;
     };
 
     /// <summary> A utility class that holds a NodeInfoEmitter and a PerformanceCounterEmitter. </summary>
@@ -104,13 +128,13 @@ namespace model
 
     private:
         void Init(emitters::IRFunctionEmitter& function);
-        void Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime);
-        void End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime);
+        void Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime, emitters::LLVMValue startTicks, emitters::LLVMValue startHardwareCounters);
+        void End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime, emitters::LLVMValue endTicks, emitters::LLVMValue endHardwareCounters);
         void Reset(emitters::IRFunctionEmitter& function);
 
         friend class ModelProfiler;
 
-        NodePerformanceEmitter(emitters::IRModuleEmitter& module, const Node* node, emitters::LLVMValue nodeInfoPtr, emitters::LLVMValue NodePerformanceEmitterPtr, llvm::StructType* nodeInfoType, llvm::StructType* NodePerformanceEmitterType);
+        NodePerformanceEmitter(emitters::IRModuleEmitter& module, const Node* node, emitters::LLVMValue nodeInfoPtr, emitters::LLVMValue NodePerformanceEmitterPtr, llvm::StructType* nodeInfoType, llvm::StructType* NodePerformanceEmitterType, emitters::LLVMValue latencyHistogramPtr, emitters::LLVMValue hardwareCountersPtr);
 
         // emitters for info and perf counters
         NodeInfoEmitter _nodeInfoEmitter;
@@ -129,13 +153,28 @@ namespace model
         /// <param name="module"> The `IRModuleEmitter` to compile the model profiling information into. </param>
         /// <param name="model"> The model to profile </param>
         /// <param name="enableProfiling"> Indicates whether profiling should be enabled for this model. </param>
-        ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling);
+        /// <param name="profileHardwareCounters">
+        /// Indicates whether to also total the hardware performance counters for each node. The counters are read by calling
+        /// `void <moduleName>_ReadHardwareCounters(int64_t* counters)`, which the host must provide. It fills in the
+        /// fields of a `HardwareCounters` struct, in order.
+        /// </param>
+        ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling, bool profileHardwareCounters);
 
         /// <summary> Indicates if profiling is enabled. </summary>
         ///
         /// <returns> true if profiling is enabled, false if disabled. </returns>
         bool IsProfilingEnabled() const { return _profilingEnabled; }
 
+        /// <summary> Indicates if hardware performance counters are profiled. </summary>
+        ///
+        /// <returns> true if hardware performance counters are profiled. </returns>
+        bool IsProfilingHardwareCounters() const { return _profileHardwareCounters; }
+
+        /// <summary> Get the name of the function the emitted code calls to read the hardware performance counters. </summary>
+        ///
+        /// <returns> The name of the "ReadHardwareCounters" function. </returns>
+        std::string GetReadHardwareCountersFunctionName() const;
+
         /// <summary> Emit static initialization code to allocate and initialize info and perf counter data. </summary>
         void EmitInitialization();
 
@@ -185,35 +224,52 @@ namespace model
         void EmitGetNumNodeTypesFunction();
 
         void EmitGetModelPerformanceCountersFunction();
+        void EmitGetModelLatencyHistogramFunction();
         void EmitPrintModelProfilingInfoFunction();
         void EmitResetModelProfilingInfoFunction();
 
         void EmitGetNodeInfoFunction();
         void EmitGetNodePerformanceCountersFunction();
+        void EmitGetNodeLatencyHistogramFunction();
         void EmitPrintNodeProfilingInfoFunction();
         void EmitResetNodeProfilingInfoFunction();
 
         void EmitGetNodeTypeInfoFunction();
         void EmitGetNodeTypePerformanceCountersFunction();
+        void EmitGetNodeTypeLatencyHistogramFunction();
         void EmitPrintNodeTypeProfilingInfoFunction();
         void EmitResetNodeTypeProfilingInfoFunction();
 
+        void EmitGetNodeHardwareCountersFunction();
+        void EmitGetNodeTypeHardwareCountersFunction();
+
+        emitters::LLVMValue EmitGetElementOrNull(emitters::IRFunctionEmitter& function, llvm::GlobalVariable* array, emitters::LLVMValue index, int numElements);
         emitters::LLVMValue CallGetCurrentTime(emitters::IRFunctionEmitter& function);
+        emitters::LLVMValue CallGetProfilerTicks(emitters::IRFunctionEmitter& function);
+        emitters::LLVMValue CallReadHardwareCounters(emitters::IRFunctionEmitter& function);
 
         emitters::IRModuleEmitter* _module = nullptr;
         Model* _model = nullptr;
         bool _profilingEnabled = false;
+        bool _profileHardwareCounters = false;
 
         llvm::StructType* _nodeInfoType = nullptr;
         llvm::StructType* _performanceCountersType = nullptr;
+        llvm::StructType* _latencyHistogramType = nullptr;
+        llvm::StructType* _hardwareCountersType = nullptr;
 
         llvm::GlobalVariable* _modelPerformanceCountersArray = nullptr;
+        llvm::GlobalVariable* _modelLatencyHistogramArray = nullptr;
 
         llvm::GlobalVariable* _nodeInfoArray = nullptr;
         llvm::GlobalVariable* _nodePerformanceCountersArray = nullptr;
+        llvm::GlobalVariable* _nodeLatencyHistogramArray = nullptr;
+        llvm::GlobalVariable* _nodeHardwareCountersArray = nullptr;
 
         llvm::GlobalVariable* _nodeTypeInfoArray = nullptr;
         llvm::GlobalVariable* _nodeTypePerformanceCountersArray = nullptr;
+        llvm::GlobalVariable* _nodeTypeLatencyHistogramArray = nullptr;
+        llvm::GlobalVariable* _nodeTypeHardwareCountersArray = nullptr;
 
         // Performance counter emitters for model
         PerformanceCountersEmitter _modelPerformanceCounters;
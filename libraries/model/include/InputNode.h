@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ExecutionContext.h"
 #include "InputNodeBase.h"
 #include "InputPort.h"
 #include "OutputPort.h"
@@ -85,6 +86,10 @@ namespace model
     private:
         void Copy(ModelTransformer& transformer) const override;
 
+        // Returns the input values in the current execution context, or the ones stored in the node if there isn't one
+        std::vector<ValueType>& GetInputValues();
+        const std::vector<ValueType>& GetInputValues() const;
+
         std::vector<ValueType> _inputValues;
         OutputPort<ValueType> _output;
     };
@@ -147,13 +152,27 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
                                             ell::utilities::FormatString("InputNode output size %zu doesn't match input size %zu", _output.Size(), inputValues.size()));
         }
-        _inputValues = inputValues;
+        GetInputValues() = std::move(inputValues);
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType>& InputNode<ValueType>::GetInputValues()
+    {
+        auto context = ExecutionContext::GetCurrent();
+        return context == nullptr ? _inputValues : context->GetNodeValues<ValueType>(*this);
+    }
+
+    template <typename ValueType>
+    const std::vector<ValueType>& InputNode<ValueType>::GetInputValues() const
+    {
+        auto context = ExecutionContext::GetCurrent();
+        return context == nullptr ? _inputValues : context->GetNodeValues<ValueType>(*this);
     }
 
     template <typename ValueType>
     void InputNode<ValueType>::Compute() const
     {
-        _output.SetOutput(_inputValues);
+        _output.SetOutput(GetInputValues());
     }
 
     template <typename ValueType>
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ExecutionContext.h"
 #include "InputNode.h"
 #include "Node.h"
 #include "PortElements.h"
@@ -96,6 +97,15 @@ namespace model
         template <typename OutputVectorType, typename InputVectorType, data::IsDataVector<OutputVectorType> OutputConcept = true, data::IsDataVector<InputVectorType> InputConcept = true>
         OutputVectorType Compute(const InputVectorType& inputValues) const;
 
+        /// <summary> Computes the map's output from input values, keeping the values computed in an execution context rather than
+        /// in the map. Several threads can compute one map at once this way, each with its own context. </summary>
+        ///
+        /// <param name="inputValues"> The input to the map </param>
+        /// <param name="context"> The execution context to compute in </param>
+        /// <returns> A vector of output values </returns>
+        template <typename OutputType, typename InputType, utilities::IsFundamental<OutputType> OutputConcept = 1, utilities::IsFundamental<InputType> InputConcept = 1>
+        std::vector<OutputType> Compute(const std::vector<InputType>& inputValues, ExecutionContext& context) const;
+
         /// <summary> Reset the state of the model </summary>
         void Reset();
 
@@ -495,6 +505,13 @@ namespace model
         return ComputeOutput<OutputVectorType>(GetOutput(0));
     }
 
+    template <typename OutputType, typename InputType, utilities::IsFundamental<OutputType>, utilities::IsFundamental<InputType>>
+    std::vector<OutputType> Map::Compute(const std::vector<InputType>& inputValues, ExecutionContext& context) const
+    {
+        ExecutionContext::Scope scope(context);
+        return Compute<OutputType>(inputValues);
+    }
+
     //
     // SetInput
     //
@@ -86,7 +86,7 @@ namespace model
         /// Create a variable to store computed output for the given output port. The variable
         /// will be emitted lazily.
         /// </summary>
-        emitters::Variable* AllocatePortVariable(const OutputPortBase& port);
+        virtual emitters::Variable* AllocatePortVariable(const OutputPortBase& port);
         emitters::Variable* GetOrAllocatePortVariable(const OutputPortBase& port);
 
         template <typename ValueType>
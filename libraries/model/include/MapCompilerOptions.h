@@ -22,6 +22,14 @@ namespace model
     class Model;
     class Node;
 
+    /// <summary> How forest predictors are compiled. </summary>
+    enum class ForestCompilationMethod
+    {
+        refine, // refine the forest into a graph of split, multiplexer and sum nodes, which evaluates every split of every tree
+        traversal, // walk one root-to-leaf path per tree, over the forest encoded as constant arrays
+        bitvector // QuickScorer-style bitvector evaluation (for binary trees with at most 64 leaves; falls back to `traversal` otherwise)
+    };
+
     struct MapCompilerOptions
     {
         // map-specific compiler settings
@@ -29,9 +37,16 @@ namespace model
         std::string mapFunctionName = "predict";
         bool inlineNodes = false;
         bool profile = false;
+        bool profileHardwareCounters = false; // with `profile`, also total hardware counters per node by calling `<moduleName>_ReadHardwareCounters`, which the host provides
         std::string sourceFunctionName;
         std::string sinkFunctionName;
         bool verifyJittedModule = false;
+        bool sharePortMemory = false; // place port variables whose lifetimes don't overlap in one shared buffer
+        bool reentrant = false; // move all mutable state into a per-instance state struct passed to predict (with `parallelize`, only the batch predict function uses several threads)
+        ForestCompilationMethod forestMethod = ForestCompilationMethod::refine;
+        bool emitBatchPredict = false; // also emit `<mapFunctionName>_batch(context, count, inputs, outputs)`, which computes predict over consecutive samples
+        int batchTileSize = 8; // with `emitBatchPredict`, the number of samples the batch function computes one node at a time (matrix products become GEMMs); 1 just calls predict for each sample
+        std::string objectCacheDirectory; // if non-empty, cache JIT-compiled object code here, keyed by the map, these options, the target and the ELL and LLVM builds
 
         // optimizations
         ModelOptimizerOptions optimizerSettings;
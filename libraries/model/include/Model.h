@@ -380,6 +380,7 @@ namespace model
         Node::NodeId GetUniqueId(const Node::NodeId& desiredId);
         static Node::NodeId GetNextId(Node::NodeId id);
         const IDToNodeMap& GetNodeMap() const;
+        static void ComputeNode(const Node& node);
 
         template <typename Visitor>
         void VisitIteratedNodes(NodeIterator& iter, Visitor&& visitor) const;
@@ -506,8 +507,7 @@ namespace model
     template <typename ValueType>
     std::vector<ValueType> Model::ComputeOutput(const OutputPort<ValueType>& outputPort) const
     {
-        auto compute = [](const Node& node) { node.Compute(); };
-        VisitSubmodel({ &outputPort }, compute);
+        VisitSubmodel({ &outputPort }, ComputeNode);
         return outputPort.GetOutput();
     }
 
@@ -522,9 +522,7 @@ namespace model
         }
 
         auto ports = std::vector<const OutputPortBase*>(usedPorts.begin(), usedPorts.end());
-        VisitSubmodel(ports, [](const Node& node) {
-            node.Compute();
-        });
+        VisitSubmodel(ports, ComputeNode);
 
         // Now construct the output
         auto numElements = elements.Size();
@@ -169,6 +169,11 @@ namespace model
         /// <summary> Resets any state on the node, if any </summary>
         virtual void Reset() {}
 
+        /// <summary> Indicates if several threads can compute this node at once, each with its own `ExecutionContext`. Nodes whose
+        /// `Compute` keeps state in their own members between evaluations return false, and can only be computed in one
+        /// context at a time (see `ExecutionContext::ClaimNode`). Scratch space belongs in `ExecutionContext::GetNodeState`. </summary>
+        virtual bool IsComputeReentrant() const { return true; }
+
         /// <summary> Get this object's metadata object. </summary>
         ///
         /// <returns> A reference to the PropertyBag containing the metadata for this object. </returns>
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ExecutionContext.h"
 #include "Port.h"
 #include "PortMemoryLayout.h"
 
@@ -143,7 +144,7 @@ namespace model
         /// <summary> Returns the cached output from this port </summary>
         ///
         /// <returns> The cached output from this port </returns>
-        const std::vector<ValueType>& GetOutput() const { return _cachedOutput; }
+        const std::vector<ValueType>& GetOutput() const { return GetValues(); }
 
         /// <summary> Returns one element of the cached output from this port </summary>
         ///
@@ -200,6 +201,9 @@ namespace model
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
+        // Returns the port's values in the current execution context, or the ones cached in the port if there isn't one
+        std::vector<ValueType>& GetValues() const;
+
         mutable std::vector<ValueType> _cachedOutput;
     };
 } // namespace model
@@ -226,24 +230,32 @@ namespace model
     {
     }
 
+    template <typename ValueType>
+    std::vector<ValueType>& OutputPort<ValueType>::GetValues() const
+    {
+        auto context = ExecutionContext::GetCurrent();
+        return context == nullptr ? _cachedOutput : context->GetPortValues<ValueType>(*this);
+    }
+
     template <typename ValueType>
     ValueType OutputPort<ValueType>::GetOutput(size_t index) const
     {
-        return _cachedOutput[index];
+        return GetValues()[index];
     }
 
     template <typename ValueType>
     std::vector<double> OutputPort<ValueType>::GetDoubleOutput() const
     {
-        std::vector<double> result(_cachedOutput.size());
-        std::copy(_cachedOutput.begin(), _cachedOutput.end(), result.begin());
+        const auto& values = GetValues();
+        std::vector<double> result(values.size());
+        std::copy(values.begin(), values.end(), result.begin());
         return result;
     }
 
     template <typename ValueType>
     double OutputPort<ValueType>::GetDoubleOutput(size_t index) const
     {
-        return static_cast<double>(_cachedOutput[index]);
+        return static_cast<double>(GetValues()[index]);
     }
 
     template <typename ValueType>
@@ -264,7 +276,7 @@ namespace model
     template <typename It>
     void OutputPort<ValueType>::SetOutput(It begin, It end) const
     {
-        _cachedOutput.assign(begin, end);
+        GetValues().assign(begin, end);
     }
 
     template <typename ValueType>
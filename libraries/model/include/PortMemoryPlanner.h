@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortMemoryPlanner.h (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    class Variable;
+}
+
+namespace model
+{
+    class Model;
+    class Node;
+    class OutputPortBase;
+
+    /// <summary> Summary of the memory saved by sharing storage between port variables. </summary>
+    struct PortMemoryReport
+    {
+        /// <summary> The number of port variables placed in the shared buffer. </summary>
+        size_t numSharedPorts = 0;
+
+        /// <summary> The number of bytes the shared ports would occupy if each had its own buffer. </summary>
+        size_t naiveSize = 0;
+
+        /// <summary> The number of bytes the shared buffer actually needs (the peak of live port memory). </summary>
+        size_t peakSize = 0;
+    };
+
+    /// <summary> Prints a one-line summary of a `PortMemoryReport`. </summary>
+    std::ostream& operator<<(std::ostream& stream, const PortMemoryReport& report);
+
+    /// <summary>
+    /// Assigns offsets in a single shared buffer to the variables backing output ports, so that ports
+    /// whose lifetimes don't overlap reuse the same memory. A port is live from the node that produces it
+    /// until the last node (in compilation order) that reads it.
+    /// </summary>
+    class PortMemoryPlanner
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="alignment"> The alignment, in bytes, of every block placed in the shared buffer. </param>
+        PortMemoryPlanner(size_t alignment = 64);
+
+        /// <summary> Computes the lifetime of every output port in the model, and resets any previous allocations. </summary>
+        ///
+        /// <param name="model"> The model being compiled. Nodes are numbered in the order `Model::Visit` produces them. </param>
+        void Reset(const Model& model);
+
+        /// <summary> Indicates if a port's variable may be placed in the shared buffer. </summary>
+        ///
+        /// <param name="port"> The port to check. </param>
+        /// <returns> `true` if the port has a known lifetime and has no padding that must be preserved between calls. </returns>
+        bool CanSharePort(const OutputPortBase& port) const;
+
+        /// <summary> Notifies the planner that the compiler is beginning to emit code for a node. </summary>
+        ///
+        /// <param name="node"> The node being compiled. </param>
+        void BeginNode(const Node& node);
+
+        /// <summary>
+        /// Notifies the planner that the compiler has finished emitting code for a node. Blocks that aren't
+        /// read by any later node are released, so their memory can be reused.
+        /// </summary>
+        ///
+        /// <param name="node"> The node that was compiled. </param>
+        /// <param name="outputVariables"> The variables bound to the node's output ports, in the same order as `node.GetOutputPorts()`. </param>
+        void EndNode(const Node& node, const std::vector<const emitters::Variable*>& outputVariables);
+
+        /// <summary> Reserves a block in the shared buffer for a port's variable. </summary>
+        ///
+        /// <param name="port"> The port being allocated. </param>
+        /// <param name="variable"> The variable that will be bound to the port. </param>
+        /// <param name="size"> The size, in bytes, of the variable. </param>
+        /// <returns> The offset, in bytes, of the block in the shared buffer. </returns>
+        size_t Allocate(const OutputPortBase& port, const emitters::Variable& variable, size_t size);
+
+        /// <summary> Gets the size, in bytes, the shared buffer needs to be. </summary>
+        size_t GetBufferSize() const { return _report.peakSize; }
+
+        /// <summary> Gets the alignment, in bytes, of the blocks in the shared buffer. </summary>
+        size_t GetAlignment() const { return _alignment; }
+
+        /// <summary> Gets a report of the memory used by the shared ports. </summary>
+        const PortMemoryReport& GetReport() const { return _report; }
+
+    private:
+        struct Block
+        {
+            size_t offset;
+            size_t size;
+            int lastUse;
+        };
+
+        int GetLastUse(const OutputPortBase& port) const;
+        size_t FindFreeOffset(size_t size) const;
+        size_t Align(size_t size) const;
+
+        size_t _alignment;
+        int _currentNodeIndex = -1;
+        std::unordered_map<const Node*, int> _nodeIndices;
+        std::unordered_map<const OutputPortBase*, int> _lastUse;
+        std::unordered_map<const emitters::Variable*, Block> _liveBlocks;
+        PortMemoryReport _report;
+    };
+} // namespace model
+} // namespace ell
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <string>
+
 namespace ell
 {
 namespace model
@@ -25,16 +27,20 @@ namespace model
         diagonal,
         simple,
         winograd,
-        unrolled
+        unrolled,
+        autotune // time every compatible method on the target and use the fastest
     };
 
     struct ModelOptimizerOptions
     {
         // individual optimization settings
         bool fuseLinearFunctionNodes = true;
+        bool foldLayerOperations = true;
+        bool fuseElementwiseOperations = true;
         bool optimizeReorderDataNodes = true;
 
         PreferredConvolutionMethod preferredConvolutionMethod = PreferredConvolutionMethod::automatic;
+        std::string convolutionTuningDatabase; // if non-empty, the file `autotune` keeps its measurements in, keyed by layer shape and target
 
         // phase
         OptimizerPhase phase = OptimizerPhase::optimize;
@@ -100,6 +100,55 @@ namespace model
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
     }
 
+    bool CompilableNode::CanCompileNodeBatch(IRMapCompiler& compiler) const
+    {
+        // The batch function calls the node's function, so inlined nodes (which don't have one) can't be part of it,
+        // and neither can nodes whose function takes more than their ports
+        if (ShouldCompileInline() || compiler.GetMapCompilerOptions().inlineNodes)
+        {
+            return false;
+        }
+
+        auto function = compiler.GetModule().GetFunction(GetCompiledFunctionName());
+        return function != nullptr && function->arg_size() == GetInputPorts().size() + GetOutputPorts().size();
+    }
+
+    void CompilableNode::CompileNodeBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if (CompileBatch(compiler, function))
+        {
+            Log() << "Compiled batched form of node " << DiagnosticString(*this) << EOL;
+            return;
+        }
+
+        // Nodes whose outputs are the same for every input of the batch are only computed once
+        auto isBatchedPort = [&compiler](auto port) { return compiler.IsBatchedPort(*port); };
+        const auto& inputs = GetInputPorts();
+        const auto& outputs = GetOutputPorts();
+        const bool isBatched = std::any_of(inputs.begin(), inputs.end(), isBatchedPort) || std::any_of(outputs.begin(), outputs.end(), isBatchedPort);
+
+        auto nodeFunction = compiler.GetModule().GetFunction(GetCompiledFunctionName());
+        function.For(isBatched ? compiler.GetBatchSize() : 1, [&compiler, &inputs, &outputs, nodeFunction](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index) {
+            std::vector<emitters::LLVMValue> args;
+            for (auto port : inputs)
+            {
+                auto buffer = compiler.GetBatchPortBuffer(*port);
+                args.push_back(compiler.IsBatchedPort(*port) ? function.PointerOffset(buffer, index * static_cast<int>(port->GetReferencedPort().Size())) : buffer);
+            }
+            for (auto port : outputs)
+            {
+                auto buffer = compiler.GetBatchPortBuffer(*port);
+                args.push_back(compiler.IsBatchedPort(*port) ? function.PointerOffset(buffer, index * static_cast<int>(port->Size())) : buffer);
+            }
+            function.Call(nodeFunction, args);
+        });
+    }
+
+    bool CompilableNode::CompileBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        return false;
+    }
+
     bool CompilableNode::ShouldCompileInline() const
     {
         return false;
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ExecutionContext.cpp (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ExecutionContext.h"
+#include "Node.h"
+
+#include <utilities/include/Exception.h>
+
+#include <mutex>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        thread_local ExecutionContext* currentContext = nullptr;
+
+        // The context that has claimed each node that keeps state between evaluations
+        std::mutex nodeClaimsMutex;
+        std::unordered_map<const Node*, const ExecutionContext*> nodeClaims;
+    } // namespace
+
+    ExecutionContext::~ExecutionContext()
+    {
+        ReleaseNodes();
+    }
+
+    ExecutionContext::Scope::Scope(ExecutionContext& context) :
+        _previous(currentContext)
+    {
+        currentContext = &context;
+    }
+
+    ExecutionContext::Scope::~Scope()
+    {
+        currentContext = _previous;
+    }
+
+    ExecutionContext* ExecutionContext::GetCurrent()
+    {
+        return currentContext;
+    }
+
+    void ExecutionContext::ClaimNode(const Node& node)
+    {
+        // Only the first evaluation in this context needs to look at the shared claims
+        if (_claimedNodes.count(&node) != 0)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(nodeClaimsMutex);
+            auto& claim = nodeClaims[&node];
+            if (claim != nullptr && claim != this)
+            {
+                throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Node " + node.GetId().ToString() + " keeps state between evaluations and is already being evaluated in another execution context");
+            }
+            claim = this;
+        }
+        _claimedNodes.insert(&node);
+    }
+
+    void ExecutionContext::Clear()
+    {
+        _portValues.clear();
+        _nodeStates.clear();
+        ReleaseNodes();
+    }
+
+    void ExecutionContext::ReleaseNodes()
+    {
+        if (_claimedNodes.empty())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(nodeClaimsMutex);
+        for (auto node : _claimedNodes)
+        {
+            nodeClaims.erase(node);
+        }
+        _claimedNodes.clear();
+    }
+} // namespace model
+} // namespace ell
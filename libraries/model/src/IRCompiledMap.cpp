@@ -14,6 +14,7 @@
 #include "Port.h"
 
 #include <emitters/include/EmitterException.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/IROptimizer.h>
 
 #include <utilities/include/Exception.h>
@@ -35,8 +36,14 @@ namespace model
         _module(std::move(other._module)),
         _executionEngine(std::move(other._executionEngine)),
         _verifyJittedModule(other._verifyJittedModule),
+        _objectCacheKey(std::move(other._objectCacheKey)),
+        _storeCompiledObject(other._storeCompiledObject),
+        _context(other._context),
+        _stateStorage(std::move(other._stateStorage)),
+        _state(other._state),
         _computeFunctionDefined(false)
     {
+        other._state = nullptr;
     }
 
     // private constructor:
@@ -66,15 +73,69 @@ namespace model
         {
             auto moduleClone = std::unique_ptr<llvm::Module>(llvm::CloneModule(_module->GetLLVMModule()));
             _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            if (!_objectCacheKey.empty())
+            {
+                _executionEngine->SetObjectCache(std::make_unique<emitters::IRObjectCache>(_compilerOptions.objectCacheDirectory, _objectCacheKey, _storeCompiledObject));
+            }
         }
     }
 
     void IRCompiledMap::FinishJitting() const
     {
         EnsureExecutionEngine();
+        EnsureState();
         SetComputeFunction();
     }
 
+    void IRCompiledMap::EnsureState() const
+    {
+        if (!_compilerOptions.reentrant || _state != nullptr)
+        {
+            return;
+        }
+
+        auto getStateSize = reinterpret_cast<int64_t (*)()>(_executionEngine->ResolveFunctionAddress(_moduleName + "_GetStateSize"));
+        auto getStateAlignment = reinterpret_cast<int64_t (*)()>(_executionEngine->ResolveFunctionAddress(_moduleName + "_GetStateAlignment"));
+        auto initState = reinterpret_cast<void (*)(void*)>(_executionEngine->ResolveFunctionAddress(_moduleName + "_InitState"));
+        auto setStateContext = reinterpret_cast<void (*)(void*, void*)>(_executionEngine->ResolveFunctionAddress(_moduleName + "_SetStateContext"));
+
+        auto size = static_cast<size_t>(getStateSize());
+        auto alignment = static_cast<size_t>(getStateAlignment());
+        _stateStorage = std::make_unique<uint8_t[]>(size + alignment);
+        auto address = reinterpret_cast<uintptr_t>(_stateStorage.get());
+        _state = reinterpret_cast<void*>((address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+        initState(_state);
+        setStateContext(_state, _context);
+    }
+
+    void IRCompiledMap::SetContext(void* context)
+    {
+        _context = context;
+        if (_state != nullptr)
+        {
+            auto setStateContext = reinterpret_cast<void (*)(void*, void*)>(_executionEngine->ResolveFunctionAddress(_moduleName + "_SetStateContext"));
+            setStateContext(_state, _context);
+        }
+    }
+
+    void* IRCompiledMap::GetState() const
+    {
+        if (!_compilerOptions.reentrant)
+        {
+            return nullptr;
+        }
+
+        EnsureExecutionEngine();
+        EnsureState();
+        return _state;
+    }
+
+    // For reentrant maps, the first argument to predict is the state buffer; otherwise it's the context
+    void* IRCompiledMap::GetPredictContext() const
+    {
+        return _compilerOptions.reentrant ? _state : GetContext();
+    }
+
     void IRCompiledMap::SetComputeFunction() const
     {
         switch (GetInput(0)->GetOutputPort().GetType())
@@ -118,7 +179,7 @@ namespace model
             temp[index] = static_cast<bool>(inputValues[index]);
         }
 
-        std::get<ComputeFunction<bool>>(_computeInputFunction)(GetContext(), (bool*)temp.data());
+        std::get<ComputeFunction<bool>>(_computeInputFunction)(GetPredictContext(), (bool*)temp.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<int>* node, const std::vector<int>& inputValues) const
@@ -130,7 +191,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<int>>(_computeInputFunction)(GetContext(), inputValues.data());
+        std::get<ComputeFunction<int>>(_computeInputFunction)(GetPredictContext(), inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<int64_t>* node, const std::vector<int64_t>& inputValues) const
@@ -142,7 +203,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<int64_t>>(_computeInputFunction)(GetContext(), inputValues.data());
+        std::get<ComputeFunction<int64_t>>(_computeInputFunction)(GetPredictContext(), inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<float>* node, const std::vector<float>& inputValues) const
@@ -154,7 +215,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<float>>(_computeInputFunction)(GetContext(), inputValues.data());
+        std::get<ComputeFunction<float>>(_computeInputFunction)(GetPredictContext(), inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<double>* node, const std::vector<double>& inputValues) const
@@ -169,7 +230,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::nullReference);
         }
 
-        std::get<ComputeFunction<double>>(_computeInputFunction)(GetContext(), inputValues.data());
+        std::get<ComputeFunction<double>>(_computeInputFunction)(GetPredictContext(), inputValues.data());
     }
 
     std::vector<bool> IRCompiledMap::ComputeBoolOutput(const model::PortElementsBase& outputs) const
@@ -291,6 +352,13 @@ namespace model
         return fn();
     }
 
+    LatencyHistogram* IRCompiledMap::GetModelLatencyHistogram()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<LatencyHistogram* (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetModelLatencyHistogram"));
+        return fn();
+    }
+
     void IRCompiledMap::ResetModelProfilingInfo()
     {
         auto& jitter = GetJitter();
@@ -333,6 +401,20 @@ namespace model
         return fn(nodeIndex);
     }
 
+    LatencyHistogram* IRCompiledMap::GetNodeLatencyHistogram(int nodeIndex)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<LatencyHistogram* (*)(int)>(jitter.GetFunctionAddress(_moduleName + "_GetNodeLatencyHistogram"));
+        return fn(nodeIndex);
+    }
+
+    HardwareCounters* IRCompiledMap::GetNodeHardwareCounters(int nodeIndex)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<HardwareCounters* (*)(int)>(jitter.GetFunctionAddress(_moduleName + "_GetNodeHardwareCounters"));
+        return fn(nodeIndex);
+    }
+
     void IRCompiledMap::PrintNodeTypeProfilingInfo()
     {
         auto& jitter = GetJitter();
@@ -368,6 +450,20 @@ namespace model
         return fn(nodeIndex);
     }
 
+    LatencyHistogram* IRCompiledMap::GetNodeTypeLatencyHistogram(int nodeIndex)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<LatencyHistogram* (*)(int)>(jitter.GetFunctionAddress(_moduleName + "_GetNodeTypeLatencyHistogram"));
+        return fn(nodeIndex);
+    }
+
+    HardwareCounters* IRCompiledMap::GetNodeTypeHardwareCounters(int nodeIndex)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<HardwareCounters* (*)(int)>(jitter.GetFunctionAddress(_moduleName + "_GetNodeTypeHardwareCounters"));
+        return fn(nodeIndex);
+    }
+
     //
     // Low-level region profiling support
     //
@@ -391,5 +487,43 @@ namespace model
         auto fn = reinterpret_cast<void (*)()>(jitter.GetFunctionAddress(_moduleName + "_ResetRegionProfilingInfo"));
         fn();
     }
+
+    double IRCompiledMap::GetProfilerTicksPerMillisecond()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<double (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetProfilerTicksPerMillisecond"));
+        return fn();
+    }
+
+    //
+    // Tracing support
+    //
+    emitters::TraceEvent* IRCompiledMap::GetTraceEvents()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<TraceEvent* (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetTraceEvents"));
+        return fn();
+    }
+
+    int IRCompiledMap::GetTraceBufferSize()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<int (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetTraceBufferSize"));
+        return fn();
+    }
+
+    int64_t IRCompiledMap::GetNumTraceEvents()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<int64_t (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetNumTraceEvents"));
+        return fn();
+    }
+
+    void IRCompiledMap::ResetTrace()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<void (*)()>(jitter.GetFunctionAddress(_moduleName + "_ResetTrace"));
+        fn();
+    }
 } // namespace model
 } // namespace ell
@@ -10,22 +10,40 @@
 #include "CompilableNode.h"
 #include "CompilableNodeUtilities.h"
 #include "IRModelProfiler.h"
+#include "InputNodeBase.h"
 #include "Model.h"
 #include "OutputNode.h"
+#include "OutputNodeBase.h"
 
 #include <model/optimizer/include/ModelOptimizer.h>
 #include <model/optimizer/include/OptimizationPassRegistry.h>
 
 #include <emitters/include/EmitterException.h>
 #include <emitters/include/IRMetadata.h>
+#include <emitters/include/IRObjectCache.h>
+#include <emitters/include/IRReentrantState.h>
 #include <emitters/include/LLVMUtilities.h>
 #include <emitters/include/Variable.h>
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/Hash.h>
+#include <utilities/include/JsonArchiver.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/StringUtil.h>
 
+#include <llvm/Config/llvm-config.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 #include <tuple>
 
+// Set by the build to the ELL commit (see libraries/model/CMakeLists.txt)
+#ifndef ELL_BUILD_ID
+#define ELL_BUILD_ID "unknown"
+#endif
+
 namespace ell
 {
 namespace model
@@ -36,6 +54,262 @@ namespace model
         {
             return (node.GetRuntimeTypeName().find("ConvolutionalLayerNode") == 0);
         }
+
+        // The convolution methods picked from a tuning database depend on what it contains, not on where it is
+        std::string ReadTuningDatabase(const std::string& filename)
+        {
+            if (filename.empty() || !utilities::FileExists(filename))
+            {
+                return "";
+            }
+            auto stream = utilities::OpenIfstream(filename);
+            std::stringstream contents;
+            contents << stream.rdbuf();
+            return contents.str();
+        }
+
+        // The object cache key must change whenever the generated code could: it hashes the archived map (before
+        // refinement), every option that affects code generation, the target, and the ELL build and LLVM version that generate it
+        std::string GetObjectCacheKey(const Map& map, const MapCompilerOptions& options, const emitters::CompilerOptions& compilerOptions)
+        {
+            std::stringstream archivedMap;
+            utilities::JsonArchiver archiver(archivedMap);
+            archiver << map;
+
+            size_t hash = 0;
+            utilities::HashCombine(hash, archivedMap.str());
+            utilities::HashCombine(hash, std::string(LLVM_VERSION_STRING));
+            utilities::HashCombine(hash, std::string(ELL_BUILD_ID));
+
+            utilities::HashCombine(hash, options.moduleName);
+            utilities::HashCombine(hash, options.mapFunctionName);
+            utilities::HashCombine(hash, options.inlineNodes);
+            utilities::HashCombine(hash, options.profile);
+            utilities::HashCombine(hash, options.profileHardwareCounters);
+            utilities::HashCombine(hash, options.sourceFunctionName);
+            utilities::HashCombine(hash, options.sinkFunctionName);
+            utilities::HashCombine(hash, options.sharePortMemory);
+            utilities::HashCombine(hash, options.reentrant);
+            utilities::HashCombine(hash, options.forestMethod);
+            utilities::HashCombine(hash, options.emitBatchPredict);
+            utilities::HashCombine(hash, options.batchTileSize);
+            utilities::HashCombine(hash, options.compilerSettings.parallelize); // the module of a reentrant map isn't parallelized (see `GetModuleCompilerOptions`)
+            // `verifyJittedModule` and `objectCacheDirectory` don't change the code, so they are left out
+
+            const auto& optimizerOptions = options.optimizerSettings;
+            utilities::HashCombine(hash, optimizerOptions.fuseLinearFunctionNodes);
+            utilities::HashCombine(hash, optimizerOptions.foldLayerOperations);
+            utilities::HashCombine(hash, optimizerOptions.fuseElementwiseOperations);
+            utilities::HashCombine(hash, optimizerOptions.optimizeReorderDataNodes);
+            utilities::HashCombine(hash, optimizerOptions.preferredConvolutionMethod);
+            utilities::HashCombine(hash, ReadTuningDatabase(optimizerOptions.convolutionTuningDatabase));
+            utilities::HashCombine(hash, optimizerOptions.phase);
+
+            // the emitter's options, which have the target device filled in
+            utilities::HashCombine(hash, compilerOptions.unrollLoops);
+            utilities::HashCombine(hash, compilerOptions.inlineOperators);
+            utilities::HashCombine(hash, compilerOptions.allowVectorInstructions);
+            utilities::HashCombine(hash, compilerOptions.vectorWidth);
+            utilities::HashCombine(hash, compilerOptions.useBlas);
+            utilities::HashCombine(hash, compilerOptions.blasType);
+            utilities::HashCombine(hash, compilerOptions.profile);
+            utilities::HashCombine(hash, compilerOptions.trace);
+            utilities::HashCombine(hash, compilerOptions.traceBufferSize);
+            utilities::HashCombine(hash, compilerOptions.optimize);
+            utilities::HashCombine(hash, compilerOptions.includeDiagnosticInfo);
+            utilities::HashCombine(hash, compilerOptions.parallelize);
+            utilities::HashCombine(hash, compilerOptions.useThreadPool);
+            utilities::HashCombine(hash, compilerOptions.maxThreads);
+            utilities::HashCombine(hash, compilerOptions.useFastMath);
+            utilities::HashCombine(hash, compilerOptions.debug);
+            utilities::HashCombine(hash, compilerOptions.positionIndependentCode.HasValue() ? static_cast<int>(compilerOptions.positionIndependentCode.GetValue()) : -1);
+
+            const auto& targetDevice = compilerOptions.targetDevice;
+            utilities::HashCombine(hash, targetDevice.triple);
+            utilities::HashCombine(hash, targetDevice.architecture);
+            utilities::HashCombine(hash, targetDevice.dataLayout);
+            utilities::HashCombine(hash, targetDevice.cpu);
+            utilities::HashCombine(hash, targetDevice.features);
+            utilities::HashCombine(hash, targetDevice.numBits);
+            utilities::HashCombine(hash, targetDevice.vectorBits);
+
+            std::stringstream key;
+            key << options.moduleName << "_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+            return key.str();
+        }
+
+        // Thread pool tasks are shared by the whole module, so they can't be made per-instance, and the nodes of a
+        // reentrant map run on the calling thread. Parallelizing a reentrant map only splits the inputs of the batch
+        // predict function between threads (see `IRMapCompiler::EmitParallelBatchPredictFunction`).
+        emitters::CompilerOptions GetModuleCompilerOptions(const MapCompilerOptions& settings)
+        {
+            auto options = settings.compilerSettings;
+            options.parallelize = options.parallelize && !settings.reentrant;
+            return options;
+        }
+
+        // Where the batch predict function keeps the values of a port
+        struct BatchPortPlan
+        {
+            enum class Storage
+            {
+                inputs, // the batch function's `inputs` argument
+                outputs, // the batch function's `outputs` argument
+                constant, // the port's literal variable
+                buffer // the tile buffer
+            };
+            Storage storage;
+            bool isBatched;
+            size_t offset; // the offset, in bytes, of the port's values in the tile buffer
+        };
+
+        enum class BatchNodeAction
+        {
+            none, // the node's values are the function's inputs or constants
+            copyToOutputs,
+            compile
+        };
+
+        struct BatchPlan
+        {
+            std::vector<std::pair<const Node*, BatchNodeAction>> nodes; // in the order they're compiled
+            std::unordered_map<const OutputPortBase*, BatchPortPlan> ports;
+            std::vector<const OutputPortBase*> paddedPorts; // ports whose padding is copied into the tile buffer up front
+            size_t bufferSize = 0;
+            size_t alignment = 1;
+        };
+
+        size_t GetPortSizeInBytes(IRMapCompiler& compiler, const OutputPortBase& port)
+        {
+            auto& module = compiler.GetModule();
+            auto elementType = module.GetIREmitter().Type(PortTypeToVariableType(port.GetType()));
+            return port.Size() * module.GetTargetDataLayout().getTypeAllocSize(elementType);
+        }
+
+        // Decides where the batch predict function keeps each port's values for a tile of `batchSize` inputs. A port has
+        // a value for each input if it depends on the map's input or on a node that keeps state between inputs, and a
+        // single value otherwise. The ports share a tile buffer the same way port variables share memory in predict.
+        // Returns false if the batch function can't compute the map one node at a time.
+        bool PlanBatchPorts(IRMapCompiler& compiler, const Map& map, int batchSize, BatchPlan& plan)
+        {
+            const auto mapOutput = map.GetOutput(0);
+            if (map.GetNumInputs() != 1 || map.GetNumOutputs() != 1 || mapOutput.NumRanges() != 1)
+            {
+                return false;
+            }
+
+            const auto& outputRange = mapOutput.GetRanges()[0];
+            const auto mapOutputPort = outputRange.ReferencedPort();
+            if (outputRange.GetStartIndex() != 0 || outputRange.Size() != mapOutputPort->Size())
+            {
+                return false;
+            }
+
+            const auto& model = map.GetModel();
+            PortMemoryPlanner planner;
+            planner.Reset(model);
+            plan.alignment = planner.GetAlignment();
+            auto align = [&plan](size_t size) { return (size + plan.alignment - 1) & ~(plan.alignment - 1); };
+            size_t paddedPortsSize = 0;
+            bool isSupported = true;
+            model.Visit([&](const Node& node) {
+                if (!isSupported)
+                {
+                    return;
+                }
+
+                bool hasBatchedInput = false;
+                for (auto input : node.GetInputPorts())
+                {
+                    auto it = plan.ports.find(&input->GetReferencedPort());
+                    if (it == plan.ports.end())
+                    {
+                        isSupported = false;
+                        return;
+                    }
+                    hasBatchedInput = hasBatchedInput || it->second.isBatched;
+                }
+
+                const auto& outputs = node.GetOutputPorts();
+                auto isLiteralPort = [&compiler](const OutputPortBase* output) {
+                    auto pVar = compiler.GetVariableForPort(*output);
+                    return pVar != nullptr && pVar->IsLiteral();
+                };
+
+                if (auto inputNode = dynamic_cast<const InputNodeBase*>(&node))
+                {
+                    isSupported = inputNode == map.GetInput(0);
+                    plan.ports[&inputNode->GetOutputPort()] = { BatchPortPlan::Storage::inputs, true, 0 };
+                    plan.nodes.emplace_back(&node, BatchNodeAction::none);
+                }
+                else if (auto outputNode = dynamic_cast<const OutputNodeBase*>(&node))
+                {
+                    isSupported = &outputNode->GetOutputPort() == mapOutputPort;
+                    plan.ports[&outputNode->GetOutputPort()] = { BatchPortPlan::Storage::outputs, true, 0 };
+                    plan.nodes.emplace_back(&node, BatchNodeAction::copyToOutputs);
+                }
+                else if (node.GetInputPorts().empty() && !outputs.empty() && std::all_of(outputs.begin(), outputs.end(), isLiteralPort))
+                {
+                    for (auto output : outputs)
+                    {
+                        plan.ports[output] = { BatchPortPlan::Storage::constant, false, 0 };
+                    }
+                    plan.nodes.emplace_back(&node, BatchNodeAction::none);
+                }
+                else
+                {
+                    auto compilableNode = dynamic_cast<const CompilableNode*>(&node);
+                    if (compilableNode == nullptr || !compilableNode->CanCompileNodeBatch(compiler))
+                    {
+                        isSupported = false;
+                        return;
+                    }
+
+                    const bool isBatched = hasBatchedInput || !node.IsComputeReentrant();
+                    std::vector<const emitters::Variable*> outputVariables;
+                    planner.BeginNode(node);
+                    for (auto output : outputs)
+                    {
+                        auto pVar = compiler.GetVariableForPort(*output);
+                        if (pVar == nullptr)
+                        {
+                            isSupported = false;
+                            return;
+                        }
+
+                        auto size = GetPortSizeInBytes(compiler, *output) * (isBatched ? batchSize : 1);
+                        if (planner.CanSharePort(*output))
+                        {
+                            plan.ports[output] = { BatchPortPlan::Storage::buffer, isBatched, planner.Allocate(*output, *pVar, size) };
+                        }
+                        else
+                        {
+                            // Padded ports go after the shared part of the buffer, once its size is known
+                            plan.ports[output] = { BatchPortPlan::Storage::buffer, isBatched, paddedPortsSize };
+                            plan.paddedPorts.push_back(output);
+                            paddedPortsSize += align(size);
+                        }
+                        outputVariables.push_back(pVar);
+                    }
+                    planner.EndNode(node, outputVariables);
+                    plan.nodes.emplace_back(&node, BatchNodeAction::compile);
+                }
+            });
+
+            auto outputPlan = plan.ports.find(mapOutputPort);
+            if (!isSupported || outputPlan == plan.ports.end() || outputPlan->second.storage != BatchPortPlan::Storage::outputs)
+            {
+                return false;
+            }
+
+            const auto sharedSize = align(planner.GetBufferSize());
+            for (auto port : plan.paddedPorts)
+            {
+                plan.ports[port].offset += sharedSize;
+            }
+            plan.bufferSize = sharedSize + paddedPortsSize;
+            return true;
+        }
     } // namespace
 
     using namespace logging;
@@ -47,7 +321,7 @@ namespace model
 
     IRMapCompiler::IRMapCompiler(const MapCompilerOptions& settings) :
         MapCompiler(settings),
-        _moduleEmitter(settings.moduleName, settings.compilerSettings),
+        _moduleEmitter(settings.moduleName, GetModuleCompilerOptions(settings)),
         _profiler(),
         _optimizer(settings)
     {
@@ -96,6 +370,32 @@ namespace model
         return GetNamespacePrefix() + "_" + baseName + "_" + node.GetId().ToString();
     }
 
+    bool IRMapCompiler::IsBatchedPort(const OutputPortBase& port) const
+    {
+        auto it = _batchPortBuffers.find(&port);
+        return it != _batchPortBuffers.end() && it->second.isBatched;
+    }
+
+    bool IRMapCompiler::IsBatchedPort(const InputPortBase& port) const
+    {
+        return IsBatchedPort(port.GetReferencedPort());
+    }
+
+    emitters::LLVMValue IRMapCompiler::GetBatchPortBuffer(const OutputPortBase& port) const
+    {
+        auto it = _batchPortBuffers.find(&port);
+        if (it == _batchPortBuffers.end())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Port '" + port.GetName() + "' has no buffer in the batch predict function");
+        }
+        return it->second.values;
+    }
+
+    emitters::LLVMValue IRMapCompiler::GetBatchPortBuffer(const InputPortBase& port) const
+    {
+        return GetBatchPortBuffer(port.GetReferencedPort());
+    }
+
     std::string IRMapCompiler::GetPredictFunctionName() const
     {
         return GetMapCompilerOptions().mapFunctionName;
@@ -124,6 +424,26 @@ namespace model
 
         EnsureValidMap(map);
 
+        // If the object code for this map is already cached, the execution engine loads it instead of
+        // generating code, so there's no need to optimize the IR
+        std::string objectCacheKey;
+        bool haveCachedObject = false;
+        if (!GetMapCompilerOptions().objectCacheDirectory.empty())
+        {
+            objectCacheKey = GetObjectCacheKey(map, GetMapCompilerOptions(), GetCompilerOptions());
+            haveCachedObject = emitters::IRObjectCache(GetMapCompilerOptions().objectCacheDirectory, objectCacheKey).HasObject();
+            Log() << "Object cache key " << objectCacheKey << (haveCachedObject ? " found" : " not found") << EOL;
+        }
+
+        if (GetMapCompilerOptions().reentrant)
+        {
+            // Profiling counters are shared by the whole module, so they can't be made per-instance
+            if (GetMapCompilerOptions().profile)
+            {
+                throw emitters::EmitterException(emitters::EmitterError::notSupported, "Reentrant compilation doesn't support profiling");
+            }
+        }
+
         //
         // Temporary special-purpose code to allow the "SetConvolutionMethod" optimization pass to work.
         // When refinement is an integrated part of optimization, then this special-case code will disappear.
@@ -154,7 +474,12 @@ namespace model
             Log() << "Enabling profiling in emitted IR" << EOL;
             GetModule().AddPreprocessorDefinition(GetNamespacePrefix() + "_PROFILING", "1");
         }
-        _profiler = { GetModule(), map.GetModel(), GetMapCompilerOptions().profile };
+        if (GetCompilerOptions().trace)
+        {
+            Log() << "Enabling tracing in emitted IR" << EOL;
+            GetModule().AddPreprocessorDefinition(GetNamespacePrefix() + "_TRACING", "1");
+        }
+        _profiler = { GetModule(), map.GetModel(), GetMapCompilerOptions().profile, GetMapCompilerOptions().profileHardwareCounters };
         _profiler.EmitInitialization();
 
         // Now we have the refined map, compile it
@@ -167,9 +492,37 @@ namespace model
         // Finish any profiling stuff we need to do and emit functions
         _profiler.EmitModelProfilerFunctions();
 
+        // Emitted before the reentrant transform, so the batch function takes the state as its first argument, as predict does
+        emitters::LLVMFunction batchFunction = nullptr;
+        const bool splitBatch = GetMapCompilerOptions().emitBatchPredict && CanSplitBatchPredict(map);
+        if (GetMapCompilerOptions().emitBatchPredict)
+        {
+            Log() << "Emitting batch predict function..." << EOL;
+            auto batchFunctionName = GetPredictFunctionName() + (splitBatch ? "_batchSequential" : "_batch");
+            batchFunction = EmitBatchPredictFunction(map, batchFunctionName, !splitBatch);
+        }
+
+        if (GetMapCompilerOptions().reentrant)
+        {
+            Log() << "Moving mutable state into the per-instance state struct..." << EOL;
+            std::vector<emitters::LLVMFunction> entryFunctions = { GetModule().GetFunction(GetPredictFunctionName()) };
+            if (batchFunction != nullptr)
+            {
+                entryFunctions.push_back(batchFunction);
+            }
+            auto stateInfo = emitters::EmitReentrantState(GetModule(), entryFunctions);
+            Log() << "State struct: " << stateInfo.numGlobals << " globals, " << stateInfo.size << " bytes" << EOL;
+
+            if (splitBatch)
+            {
+                Log() << "Emitting parallel batch predict function..." << EOL;
+                EmitParallelBatchPredictFunction(map, batchFunction, stateInfo);
+            }
+        }
+
         auto module = std::make_unique<emitters::IRModuleEmitter>(std::move(_moduleEmitter));
 
-        if (GetMapCompilerOptions().compilerSettings.optimize)
+        if (GetMapCompilerOptions().compilerSettings.optimize && !haveCachedObject)
         {
             // Save callback declarations in case they get optimized away
             std::vector<std::tuple<std::string, llvm::FunctionType*, std::vector<std::string>>> savedCallbacks;
@@ -192,7 +545,10 @@ namespace model
             }
         }
 
-        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), std::move(module), GetMapCompilerOptions().verifyJittedModule);
+        IRCompiledMap compiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), std::move(module), GetMapCompilerOptions().verifyJittedModule);
+        compiledMap._objectCacheKey = objectCacheKey;
+        compiledMap._storeCompiledObject = !haveCachedObject;
+        return compiledMap;
     }
 
     void IRMapCompiler::EmitModelAPIFunctions(const Map& map)
@@ -555,6 +911,279 @@ namespace model
         _moduleEmitter.EndFunction();
     }
 
+    emitters::LLVMFunction IRMapCompiler::EmitBatchPredictFunction(const Map& map, const std::string& functionName, bool isPublic)
+    {
+        // This is the code we are generating, for tiles of T inputs:
+        //
+        // void predict_batch(void* context, int count, const InputType* inputs, OutputType* outputs)
+        // {
+        //     int numTiles = count / T;
+        //     if (numTiles > 0)
+        //     {
+        //         char* buffer = <malloc'd tile buffer, aligned>;
+        //         <copy the padding of padded ports into their T slots in the buffer>
+        //         for (int tile = 0; tile < numTiles; ++tile)
+        //         {
+        //             <compute each node for the T inputs of the tile>
+        //         }
+        //         free(buffer);
+        //     }
+        //     for (int i = numTiles * T; i < count; ++i)
+        //     {
+        //         predict(context, inputs + i * inputSize, outputs + i * outputSize);
+        //     }
+        // }
+        //
+        // Computing a node for all the inputs of a tile before moving on to the next node lets nodes with a batched form
+        // use it (e.g., a matrix-vector product becomes a matrix-matrix product). This gives the same results as calling
+        // predict for each input in turn, even for nodes that keep state between inputs, since those still see the inputs in order.
+        auto predictFunction = _moduleEmitter.GetFunction(GetPredictFunctionName());
+        const auto& predictArguments = _moduleEmitter.GetFunctionDeclaration(GetPredictFunctionName()).GetArguments();
+        if (predictArguments.size() != 3)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Batch predict requires a map with a single input and output");
+        }
+
+        const int tileSize = GetMapCompilerOptions().batchTileSize;
+        BatchPlan plan;
+        const bool useTiles = tileSize > 1 && PlanBatchPorts(*this, map, tileSize, plan);
+        Log() << "Batch predict " << (useTiles ? "computes tiles of " + std::to_string(tileSize) + " inputs one node at a time" : "calls predict for each input") << EOL;
+
+        const emitters::NamedVariableTypeList parameters = { predictArguments[0],
+                                                             { "count", emitters::VariableType::Int32 },
+                                                             { "inputs", predictArguments[1].second },
+                                                             { "outputs", predictArguments[2].second } };
+        auto& function = _moduleEmitter.BeginFunction(functionName, emitters::VariableType::Void, parameters);
+        if (isPublic)
+        {
+            function.IncludeInHeader();
+            _moduleEmitter.GetFunctionDeclaration(functionName).GetComments() = {
+                std::string("Runs ") + GetPredictFunctionName() + " on `count` consecutive inputs, writing consecutive outputs",
+                std::string("Input size: ") + std::to_string(map.GetInputSize(0)),
+                std::string("Output size: ") + std::to_string(map.GetOutputSize(0))
+            };
+        }
+
+        auto arguments = function.Arguments().begin();
+        emitters::LLVMValue predictContext = &(*arguments++);
+        emitters::LLVMValue count = &(*arguments++);
+        emitters::LLVMValue inputs = &(*arguments++);
+        emitters::LLVMValue outputs = &(*arguments++);
+        auto inputSize = static_cast<int>(map.GetInputSize(0));
+        auto outputSize = static_cast<int>(map.GetOutputSize(0));
+
+        auto numTiles = function.LocalScalar(function.Literal<int>(0));
+        if (useTiles)
+        {
+            // Callbacks get the context from the module's global, which predict normally sets
+            if (auto contextGlobal = _moduleEmitter.GetLLVMModule()->getNamedGlobal(_moduleEmitter.GetModuleName() + "_context"))
+            {
+                function.Store(contextGlobal, predictContext);
+            }
+
+            numTiles = function.LocalScalar(count) / tileSize;
+            function.If(numTiles > 0, [&](emitters::IRFunctionEmitter& function) {
+                // malloc doesn't promise the alignment the port buffers want, so allocate extra space and align the start by hand
+                const auto alignment = static_cast<int64_t>(plan.alignment);
+                auto allocation = function.Malloc(emitters::VariableType::BytePointer, static_cast<int64_t>(plan.bufferSize) + alignment);
+                auto address = function.LocalScalar(function.CastPointerToInt(allocation, emitters::VariableType::Int64));
+                auto alignedAddress = (address + (alignment - 1)) & function.LocalScalar(~(alignment - 1));
+                auto buffer = function.CastIntToPointer(alignedAddress, emitters::VariableType::BytePointer);
+
+                // Padding keeps the values it has in predict's port variables, and nodes never write it
+                for (auto port : plan.paddedPorts)
+                {
+                    const auto& portPlan = plan.ports[port];
+                    auto source = function.CastPointer(_moduleEmitter.EnsureEmitted(*GetVariableForPort(*port)), emitters::VariableType::BytePointer);
+                    const auto size = static_cast<int>(GetPortSizeInBytes(*this, *port));
+                    for (int index = 0; index < (portPlan.isBatched ? tileSize : 1); ++index)
+                    {
+                        function.MemoryCopy<uint8_t>(source, 0, buffer, static_cast<int>(portPlan.offset) + index * size, size);
+                    }
+                }
+
+                _batchSize = tileSize;
+                function.For(numTiles, [&](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar tile) {
+                    _batchPortBuffers.clear();
+                    for (const auto& entry : plan.nodes)
+                    {
+                        for (auto port : entry.first->GetOutputPorts())
+                        {
+                            const auto& portPlan = plan.ports[port];
+                            emitters::LLVMValue values = nullptr;
+                            switch (portPlan.storage)
+                            {
+                            case BatchPortPlan::Storage::inputs:
+                                values = function.PointerOffset(inputs, tile * (tileSize * inputSize));
+                                break;
+                            case BatchPortPlan::Storage::outputs:
+                                values = function.PointerOffset(outputs, tile * (tileSize * outputSize));
+                                break;
+                            case BatchPortPlan::Storage::constant:
+                                values = function.PointerOffset(_moduleEmitter.EnsureEmitted(*GetVariableForPort(*port)), 0);
+                                break;
+                            case BatchPortPlan::Storage::buffer:
+                                auto pointerType = emitters::GetPointerType(PortTypeToVariableType(port->GetType()));
+                                values = function.CastPointer(function.PointerOffset(buffer, static_cast<int>(portPlan.offset)), pointerType);
+                                break;
+                            }
+                            _batchPortBuffers[port] = { values, portPlan.isBatched };
+                        }
+
+                        if (entry.second == BatchNodeAction::copyToOutputs)
+                        {
+                            auto outputNode = static_cast<const OutputNodeBase*>(entry.first);
+                            const auto& input = outputNode->GetInputPort();
+                            auto source = function.CastPointer(GetBatchPortBuffer(input), emitters::VariableType::BytePointer);
+                            auto destination = function.CastPointer(GetBatchPortBuffer(outputNode->GetOutputPort()), emitters::VariableType::BytePointer);
+                            const auto size = static_cast<int>(GetPortSizeInBytes(*this, outputNode->GetOutputPort()));
+                            const bool isBatchedInput = IsBatchedPort(input);
+                            function.For(tileSize, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index) {
+                                auto sourceOffset = isBatchedInput ? index * size : function.LocalScalar(function.Literal<int>(0));
+                                function.MemoryCopy<uint8_t>(source, sourceOffset, destination, index * size, function.Literal<int>(size));
+                            });
+                        }
+                        else if (entry.second == BatchNodeAction::compile)
+                        {
+                            auto compilableNode = const_cast<CompilableNode*>(static_cast<const CompilableNode*>(entry.first));
+                            Log() << "Compiling node " << DiagnosticString(*entry.first) << " into batch predict" << EOL;
+                            compilableNode->CompileNodeBatch(*this, function);
+                        }
+                    }
+                });
+                _batchPortBuffers.clear();
+                _batchSize = 1;
+
+                function.Free(allocation);
+            });
+        }
+
+        function.For(numTiles * tileSize, count, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
+            auto input = function.PointerOffset(inputs, i * inputSize);
+            auto output = function.PointerOffset(outputs, i * outputSize);
+            function.Call(predictFunction, { predictContext, input, output });
+        });
+        _moduleEmitter.EndFunction();
+        return function.GetFunction();
+    }
+
+    bool IRMapCompiler::CanSplitBatchPredict(const Map& map)
+    {
+        // Each thread gets its own copy of the state, so splitting a batch is only possible for maps whose nodes
+        // don't carry state from one input to the next. Callbacks are left out, since the host may not expect
+        // them to be called from several threads at once.
+        const auto& options = GetMapCompilerOptions();
+        const auto& compilerOptions = GetCompilerOptions();
+        if (!options.reentrant || !options.compilerSettings.parallelize || !compilerOptions.useThreadPool || compilerOptions.targetDevice.IsWindows() || compilerOptions.maxThreads < 2 ||
+            !emitters::GetFunctionsWithTag(GetModule(), emitters::c_callbackFunctionTagName).empty())
+        {
+            return false;
+        }
+
+        bool isComputeReentrant = true;
+        map.GetModel().Visit([&isComputeReentrant](const Node& node) {
+            isComputeReentrant = isComputeReentrant && node.IsComputeReentrant();
+        });
+        return isComputeReentrant;
+    }
+
+    void IRMapCompiler::EmitParallelBatchPredictFunction(const Map& map, emitters::LLVMFunction batchFunction, const emitters::ReentrantStateInfo& stateInfo)
+    {
+        // This is the code we are generating, for tiles of T inputs and N threads:
+        //
+        // void predict_batch(void* state, int count, const InputType* inputs, OutputType* outputs)
+        // {
+        //     if (count <= T || exchange(&threadsBusy, 1) != 0)
+        //     {
+        //         predict_batchSequential(state, count, inputs, outputs);
+        //         return;
+        //     }
+        //     int numTasks = min(N, ceil(count / T));
+        //     int taskSize = T * ceil(ceil(count / numTasks) / T);
+        //     <copy the state once for each task but the first>
+        //     <run predict_batchSequential on each task's part of the batch, in the thread pool>
+        //     <free the copies of the state>
+        //     threadsBusy = 0;
+        // }
+        //
+        // The thread pool runs one array of tasks at a time, so a batch started while another one is running (with
+        // a different state) runs on the calling thread instead.
+        const auto& predictArguments = _moduleEmitter.GetFunctionDeclaration(GetPredictFunctionName()).GetArguments();
+        const emitters::NamedVariableTypeList parameters = { predictArguments[0],
+                                                             { "count", emitters::VariableType::Int32 },
+                                                             { "inputs", predictArguments[1].second },
+                                                             { "outputs", predictArguments[2].second } };
+        auto functionName = GetPredictFunctionName() + "_batch";
+        auto& function = _moduleEmitter.BeginFunction(functionName, emitters::VariableType::Void, parameters);
+        function.IncludeInHeader();
+        _moduleEmitter.GetFunctionDeclaration(functionName).GetComments() = {
+            std::string("Runs ") + GetPredictFunctionName() + " on `count` consecutive inputs, writing consecutive outputs, on several threads",
+            std::string("Input size: ") + std::to_string(map.GetInputSize(0)),
+            std::string("Output size: ") + std::to_string(map.GetOutputSize(0))
+        };
+
+        auto arguments = function.Arguments().begin();
+        emitters::LLVMValue state = &(*arguments++);
+        auto count = function.LocalScalar(&(*arguments++));
+        emitters::LLVMValue inputs = &(*arguments++);
+        emitters::LLVMValue outputs = &(*arguments++);
+        const int tileSize = std::max(GetMapCompilerOptions().batchTileSize, 1);
+        const int maxThreads = GetCompilerOptions().maxThreads;
+        auto inputSize = static_cast<int>(map.GetInputSize(0));
+        auto outputSize = static_cast<int>(map.GetOutputSize(0));
+
+        auto threadsBusy = _moduleEmitter.Global<int>(GetNamespacePrefix() + "_batchThreadsBusy", 0);
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto runSequentially = count <= tileSize;
+        function.If(runSequentially, [&](emitters::IRFunctionEmitter& function) {
+            function.Call(batchFunction, { state, count, inputs, outputs });
+        })
+            .Else([&](emitters::IRFunctionEmitter& function) {
+                auto wasBusy = function.LocalScalar(irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Xchg, threadsBusy, function.Literal<int>(1), llvm::AtomicOrdering::SequentiallyConsistent));
+                function.If(wasBusy != 0, [&](emitters::IRFunctionEmitter& function) {
+                            function.Call(batchFunction, { state, count, inputs, outputs });
+                        })
+                    .Else([&](emitters::IRFunctionEmitter& function) {
+                        auto numTiles = (count + (tileSize - 1)) / tileSize;
+                        auto numTasks = emitters::Min(numTiles, maxThreads);
+                        auto taskSize = ((count + numTasks - 1) / numTasks + (tileSize - 1)) / tileSize * tileSize;
+
+                        // The first task uses the caller's state, and the others get copies of it
+                        const auto stateAlignment = static_cast<int64_t>(stateInfo.alignment);
+                        const auto stateSize = static_cast<int>((stateInfo.size + stateInfo.alignment - 1) / stateInfo.alignment * stateInfo.alignment);
+                        auto numCopies = numTasks - 1;
+                        auto allocationSize = function.LocalScalar(function.CastValue<int64_t>(numCopies * stateSize)) + stateAlignment;
+                        auto allocation = function.Malloc(function.GetEmitter().Type(emitters::VariableType::BytePointer), allocationSize);
+                        auto address = function.LocalScalar(function.CastPointerToInt(allocation, emitters::VariableType::Int64));
+                        auto alignedAddress = (address + (stateAlignment - 1)) & function.LocalScalar(~(stateAlignment - 1));
+                        auto copies = function.CastIntToPointer(alignedAddress, emitters::VariableType::BytePointer);
+                        function.For(numCopies, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index) {
+                            function.MemoryCopy<uint8_t>(state, function.Literal<int>(0), copies, index * stateSize, function.Literal<int>(stateSize));
+                        });
+
+                        // Tasks past `numTasks` get no inputs
+                        std::vector<std::vector<emitters::LLVMValue>> taskArgs;
+                        for (int taskIndex = 0; taskIndex < maxThreads; ++taskIndex)
+                        {
+                            auto begin = emitters::Min(taskSize * taskIndex, count);
+                            auto end = emitters::Min(begin + taskSize, count);
+                            emitters::LLVMValue taskState = state;
+                            if (taskIndex > 0)
+                            {
+                                auto copy = function.PointerOffset(copies, (taskIndex - 1) * stateSize);
+                                taskState = function.Select(numTasks > taskIndex, copy, state);
+                            }
+                            taskArgs.push_back({ taskState, end - begin, function.PointerOffset(inputs, begin * inputSize), function.PointerOffset(outputs, begin * outputSize) });
+                        }
+                        _moduleEmitter.GetThreadPool().AddTasks(function, batchFunction, taskArgs).WaitAll(function);
+
+                        function.Free(allocation);
+                        irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Xchg, threadsBusy, function.Literal<int>(0), llvm::AtomicOrdering::SequentiallyConsistent);
+                    });
+            });
+        _moduleEmitter.EndFunction();
+    }
+
     void IRMapCompiler::EmitStringConditionals(emitters::IRFunctionEmitter& fn, std::vector<std::pair<std::string, std::string>> keyValuePairs)
     {
         // This is the type of code we are trying to generate for the GetInputSize and GetOutputSize functions:
@@ -649,8 +1278,66 @@ namespace model
         return GetModule().EnsureEmitted(*pVar);
     }
 
+    emitters::Variable* IRMapCompiler::AllocatePortVariable(const OutputPortBase& port)
+    {
+        // Only ports in the top-level predict function have lifetimes the planner knows about
+        if (!IsSharingPortMemory() || _nodeRegions.size() != 1 || !_portMemoryPlanner.CanSharePort(port))
+        {
+            return MapCompiler::AllocatePortVariable(port);
+        }
+
+        assert(port.Size() != 0);
+        auto& module = GetModule();
+        emitters::VariableType varType = PortTypeToVariableType(port.GetType());
+        auto pVar = module.Variables().AddVectorVariable(emitters::VariableScope::global, varType, port.Size());
+        auto elementSize = module.GetTargetDataLayout().getTypeAllocSize(module.GetIREmitter().Type(varType));
+        auto offset = _portMemoryPlanner.Allocate(port, *pVar, port.Size() * elementSize);
+        module.EmitGlobalVectorView(*pVar, GetSharedPortMemoryPlaceholder(), offset);
+        SetVariableForPort(port, pVar);
+
+        Log() << "Placed port " << port.GetName() << " of node " << DiagnosticString(*port.GetNode()) << " at offset " << offset << " of shared port memory" << EOL;
+        return pVar;
+    }
+
+    bool IRMapCompiler::IsSharingPortMemory() const
+    {
+        return GetMapCompilerOptions().sharePortMemory;
+    }
+
+    llvm::GlobalVariable* IRMapCompiler::GetSharedPortMemoryPlaceholder()
+    {
+        // The size of the buffer isn't known until all the nodes have been compiled, so port variables
+        // refer to a placeholder that gets replaced by the real buffer in `EmitSharedPortMemory`
+        if (_sharedPortMemoryPlaceholder == nullptr)
+        {
+            _sharedPortMemoryPlaceholder = GetModule().GlobalArray(emitters::VariableType::Byte, GetNamespacePrefix() + "_SharedPortMemoryPlaceholder", 0);
+        }
+        return _sharedPortMemoryPlaceholder;
+    }
+
+    void IRMapCompiler::EmitSharedPortMemory()
+    {
+        if (_sharedPortMemoryPlaceholder == nullptr)
+        {
+            return;
+        }
+
+        auto buffer = GetModule().GlobalArray(emitters::VariableType::Byte, GetNamespacePrefix() + "_SharedPortMemory", _portMemoryPlanner.GetBufferSize());
+        buffer->setAlignment(static_cast<unsigned>(_portMemoryPlanner.GetAlignment()));
+        _sharedPortMemoryPlaceholder->replaceAllUsesWith(llvm::ConstantExpr::getBitCast(buffer, _sharedPortMemoryPlaceholder->getType()));
+        _sharedPortMemoryPlaceholder->eraseFromParent();
+        _sharedPortMemoryPlaceholder = nullptr;
+
+        Log() << _portMemoryPlanner.GetReport() << EOL;
+    }
+
     void IRMapCompiler::OnBeginCompileModel(const Model& model)
     {
+        if (IsSharingPortMemory())
+        {
+            _portMemoryPlanner.Reset(model);
+        }
+
         auto& currentFunction = GetModule().GetCurrentFunction();
         if (currentFunction.GetCurrentRegion() == nullptr) // TODO: put this check in GetCurrentFunction()
         {
@@ -669,6 +1356,8 @@ namespace model
     {
         auto& currentFunction = GetModule().GetCurrentFunction();
         _profiler.EndModel(currentFunction);
+
+        EmitSharedPortMemory();
     }
 
     void IRMapCompiler::OnBeginCompileNode(const Node& node)
@@ -682,6 +1371,12 @@ namespace model
 
         _profiler.InitNode(currentFunction, node);
         _profiler.StartNode(currentFunction, node);
+        _nodeTraceBeginTicks.push_back(GetModule().GetTracer().BeginEvent(currentFunction));
+
+        if (IsSharingPortMemory())
+        {
+            _portMemoryPlanner.BeginNode(node);
+        }
     }
 
     void IRMapCompiler::OnEndCompileNode(const Node& node)
@@ -689,8 +1384,23 @@ namespace model
         auto& currentFunction = GetModule().GetCurrentFunction();
         assert(currentFunction.GetCurrentRegion() != nullptr);
 
+        assert(!_nodeTraceBeginTicks.empty());
+        auto traceName = node.GetRuntimeTypeName() + "_" + to_string(node.GetId());
+        GetModule().GetTracer().EndEvent(currentFunction, _nodeTraceBeginTicks.back(), traceName, emitters::TraceEventCategory::node);
+        _nodeTraceBeginTicks.pop_back();
+
         _profiler.EndNode(currentFunction, node);
 
+        if (IsSharingPortMemory())
+        {
+            std::vector<const emitters::Variable*> outputVariables;
+            for (auto output : node.GetOutputPorts())
+            {
+                outputVariables.push_back(GetVariableForPort(*output));
+            }
+            _portMemoryPlanner.EndNode(node, outputVariables);
+        }
+
         auto pCurBlock = currentFunction.GetCurrentBlock();
         if (pCurBlock != currentFunction.GetCurrentRegion()->End())
         {
@@ -814,6 +1524,14 @@ namespace model
     {
         auto& currentFunction = GetModule().GetCurrentFunction();
 
+        // Merging moves a node's code ahead of nodes compiled before it, which would break the port lifetimes
+        // used to share port memory
+        if (IsSharingPortMemory())
+        {
+            Log() << "Not merging code for node " << DiagnosticString(src) << " because port memory is shared" << EOL;
+            return false;
+        }
+
         Log() << "Trying to merge emitted code for node " << DiagnosticString(src) << " with existing code region in " << currentFunction.GetFunctionName() << EOL;
 
         emitters::IRBlockRegion* pSrcRegion = GetCurrentNodeBlocks().Get(src);
@@ -10,6 +10,7 @@
 #include "Model.h"
 
 #include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLatencyHistogram.h>
 #include <emitters/include/IRMetadata.h>
 #include <emitters/include/IRModuleEmitter.h>
 #include <emitters/include/LLVMUtilities.h>
@@ -64,10 +65,12 @@ namespace model
     //
     // PerformanceCountersEmitter
     //
-    PerformanceCountersEmitter::PerformanceCountersEmitter(emitters::IRModuleEmitter& module, emitters::LLVMValue performanceCountersPtr, llvm::StructType* performanceCountersType) :
+    PerformanceCountersEmitter::PerformanceCountersEmitter(emitters::IRModuleEmitter& module, emitters::LLVMValue performanceCountersPtr, llvm::StructType* performanceCountersType, emitters::LLVMValue latencyHistogramPtr, emitters::LLVMValue hardwareCountersPtr) :
         _module(&module),
         _performanceCountersPtr(performanceCountersPtr),
-        _performanceCountersType(performanceCountersType)
+        _performanceCountersType(performanceCountersType),
+        _latencyHistogramPtr(latencyHistogramPtr),
+        _hardwareCountersPtr(hardwareCountersPtr)
     {
     }
 
@@ -75,7 +78,7 @@ namespace model
     {
     }
 
-    void PerformanceCountersEmitter::Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime)
+    void PerformanceCountersEmitter::Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime, emitters::LLVMValue startTicks, emitters::LLVMValue startHardwareCounters)
     {
         assert(_performanceCountersPtr != nullptr);
 
@@ -83,13 +86,15 @@ namespace model
         auto& irBuilder = emitter.GetIRBuilder();
 
         _startTime = startTime;
+        _startTicks = startTicks;
+        _startHardwareCounters = startHardwareCounters;
 
         // Increment node entry counter
         auto countPtr = irBuilder.CreateInBoundsGEP(_performanceCountersType, _performanceCountersPtr, { emitter.Literal(0), emitter.Literal(0) });
         function.OperationAndUpdate(countPtr, emitters::TypedOperator::add, function.Literal<int64_t>(1));
     }
 
-    void PerformanceCountersEmitter::End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime)
+    void PerformanceCountersEmitter::End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime, emitters::LLVMValue endTicks, emitters::LLVMValue endHardwareCounters)
     {
         assert(_performanceCountersPtr != nullptr);
 
@@ -100,6 +105,22 @@ namespace model
         auto elapsedTime = function.Operator(emitters::TypedOperator::subtractFloat, endTime, _startTime);
         auto totalTimePtr = irBuilder.CreateInBoundsGEP(_performanceCountersPtr, { emitter.Literal(0), emitter.Literal(1) }, "accumTime");
         function.OperationAndUpdate(totalTimePtr, emitters::TypedOperator::addFloat, elapsedTime);
+
+        // Add the elapsed ticks to the latency histogram
+        auto elapsedTicks = function.Operator(emitters::TypedOperator::subtract, endTicks, _startTicks);
+        emitters::AddLatencyHistogramSample(function, _latencyHistogramPtr, elapsedTicks);
+
+        // Add the change in each hardware counter to its total
+        if (_hardwareCountersPtr != nullptr)
+        {
+            assert(_startHardwareCounters != nullptr && endHardwareCounters != nullptr);
+            for (int index = 0; index < numHardwareCounters; ++index)
+            {
+                auto counterPtr = irBuilder.CreateInBoundsGEP(_hardwareCountersPtr, { emitter.Literal(0), emitter.Literal(index) });
+                auto delta = function.Operator(emitters::TypedOperator::subtract, function.ValueAt(endHardwareCounters, index), function.ValueAt(_startHardwareCounters, index));
+                function.OperationAndUpdate(counterPtr, emitters::TypedOperator::add, delta);
+            }
+        }
     }
 
     void PerformanceCountersEmitter::Reset(emitters::IRFunctionEmitter& function)
@@ -114,14 +135,19 @@ namespace model
         auto totalTimePtr = irBuilder.CreateInBoundsGEP(_performanceCountersPtr, { emitter.Literal(0), emitter.Literal(1) });
         function.StoreZero(countPtr);
         function.StoreZero(totalTimePtr);
+        emitters::ResetLatencyHistogram(function, _latencyHistogramPtr);
+        if (_hardwareCountersPtr != nullptr)
+        {
+            function.StoreZero(_hardwareCountersPtr);
+        }
     }
 
     //
     // NodePerformanceEmitter
     //
-    NodePerformanceEmitter::NodePerformanceEmitter(emitters::IRModuleEmitter& module, const Node* node, emitters::LLVMValue nodeInfoPtr, emitters::LLVMValue performanceCountersPtr, llvm::StructType* nodeInfoType, llvm::StructType* performanceCountersType) :
+    NodePerformanceEmitter::NodePerformanceEmitter(emitters::IRModuleEmitter& module, const Node* node, emitters::LLVMValue nodeInfoPtr, emitters::LLVMValue performanceCountersPtr, llvm::StructType* nodeInfoType, llvm::StructType* performanceCountersType, emitters::LLVMValue latencyHistogramPtr, emitters::LLVMValue hardwareCountersPtr) :
         _nodeInfoEmitter(module, node, nodeInfoPtr, nodeInfoType),
-        _performanceCountersEmitter(module, performanceCountersPtr, performanceCountersType)
+        _performanceCountersEmitter(module, performanceCountersPtr, performanceCountersType, latencyHistogramPtr, hardwareCountersPtr)
     {
     }
 
@@ -131,14 +157,14 @@ namespace model
         _performanceCountersEmitter.Init(function);
     }
 
-    void NodePerformanceEmitter::Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime)
+    void NodePerformanceEmitter::Start(emitters::IRFunctionEmitter& function, emitters::LLVMValue startTime, emitters::LLVMValue startTicks, emitters::LLVMValue startHardwareCounters)
     {
-        _performanceCountersEmitter.Start(function, startTime);
+        _performanceCountersEmitter.Start(function, startTime, startTicks, startHardwareCounters);
     }
 
-    void NodePerformanceEmitter::End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime)
+    void NodePerformanceEmitter::End(emitters::IRFunctionEmitter& function, emitters::LLVMValue endTime, emitters::LLVMValue endTicks, emitters::LLVMValue endHardwareCounters)
     {
-        _performanceCountersEmitter.End(function, endTime);
+        _performanceCountersEmitter.End(function, endTime, endTicks, endHardwareCounters);
     }
 
     void NodePerformanceEmitter::Reset(emitters::IRFunctionEmitter& function)
@@ -159,10 +185,11 @@ namespace model
         // Emit functions
     }
 
-    ModelProfiler::ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling) :
+    ModelProfiler::ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling, bool profileHardwareCounters) :
         _module(&module),
         _model(&model),
         _profilingEnabled(enableProfiling),
+        _profileHardwareCounters(enableProfiling && profileHardwareCounters),
         _nodeInfoType(nullptr),
         _performanceCountersType(nullptr)
     {
@@ -179,6 +206,10 @@ namespace model
             _module->DeclarePrintf();
             CreateStructTypes();
             AllocateNodeData();
+            if (_profileHardwareCounters)
+            {
+                _module->DeclareFunction(GetReadHardwareCountersFunctionName(), emitters::VariableType::Void, emitters::VariableTypeList{ emitters::VariableType::Int64Pointer });
+            }
         }
     }
 
@@ -198,6 +229,15 @@ namespace model
         emitters::NamedLLVMTypeList countersFields = { { "count", int64Type }, { "totalTime", doubleType } };
         _performanceCountersType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_PerformanceCounters", countersFields);
         _module->IncludeTypeInHeader(_performanceCountersType->getName());
+
+        _latencyHistogramType = emitters::GetLatencyHistogramType(*_module);
+
+        if (_profileHardwareCounters)
+        {
+            emitters::NamedLLVMTypeList hardwareCountersFields = { { "cycles", int64Type }, { "instructions", int64Type }, { "l1DataCacheMisses", int64Type }, { "lastLevelCacheMisses", int64Type }, { "branchMisses", int64Type } };
+            _hardwareCountersType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_HardwareCounters", hardwareCountersFields);
+            _module->IncludeTypeInHeader(_hardwareCountersType->getName());
+        }
     }
 
     void ModelProfiler::StartModel(emitters::IRFunctionEmitter& function)
@@ -208,15 +248,17 @@ namespace model
         }
 
         auto startTime = CallGetCurrentTime(function);
+        auto startTicks = CallGetProfilerTicks(function);
         auto& emitter = _module->GetIREmitter();
         auto& irBuilder = emitter.GetIRBuilder();
 
         assert(_modelPerformanceCountersArray != nullptr);
         auto modelPerformanceCountersPtr = irBuilder.CreateInBoundsGEP(_modelPerformanceCountersArray, { emitter.Literal(0), emitter.Literal(0) });
-        _modelPerformanceCounters = { *_module, modelPerformanceCountersPtr, _performanceCountersType };
+        auto modelLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_modelLatencyHistogramArray, { emitter.Literal(0), emitter.Literal(0) });
+        _modelPerformanceCounters = { *_module, modelPerformanceCountersPtr, _performanceCountersType, modelLatencyHistogramPtr, nullptr };
 
         _modelPerformanceCounters.Init(function);
-        _modelPerformanceCounters.Start(function, startTime);
+        _modelPerformanceCounters.Start(function, startTime, startTicks, nullptr);
     }
 
     void ModelProfiler::EndModel(emitters::IRFunctionEmitter& function)
@@ -226,8 +268,9 @@ namespace model
             return;
         }
 
+        auto endTicks = CallGetProfilerTicks(function);
         auto endTime = CallGetCurrentTime(function);
-        _modelPerformanceCounters.End(function, endTime);
+        _modelPerformanceCounters.End(function, endTime, endTicks, nullptr);
     }
 
     void ModelProfiler::InitNode(emitters::IRFunctionEmitter& function, const Node& node)
@@ -252,9 +295,14 @@ namespace model
         auto& performanceCounters = GetPerformanceCountersForNode(node);
         auto& typePerformanceCounters = GetTypePerformanceCountersForNode(node);
 
+        // The hardware counters are read outside the timed window, so reading them doesn't add to the node's time. The
+        // counter window does include the two timestamp calls, which biases each node's counts up by their few cycles
+        // and instructions.
+        auto startHardwareCounters = CallReadHardwareCounters(function);
         auto startTime = CallGetCurrentTime(function);
-        performanceCounters.Start(function, startTime);
-        typePerformanceCounters.Start(function, startTime);
+        auto startTicks = CallGetProfilerTicks(function);
+        performanceCounters.Start(function, startTime, startTicks, startHardwareCounters);
+        typePerformanceCounters.Start(function, startTime, startTicks, startHardwareCounters);
     }
 
     void ModelProfiler::EndNode(emitters::IRFunctionEmitter& function, const Node& node)
@@ -266,9 +314,11 @@ namespace model
         auto& performanceCounters = GetPerformanceCountersForNode(node);
         auto& typePerformanceCounters = GetTypePerformanceCountersForNode(node);
 
+        auto endTicks = CallGetProfilerTicks(function);
         auto endTime = CallGetCurrentTime(function);
-        performanceCounters.End(function, endTime);
-        typePerformanceCounters.End(function, endTime);
+        auto endHardwareCounters = CallReadHardwareCounters(function);
+        performanceCounters.End(function, endTime, endTicks, endHardwareCounters);
+        typePerformanceCounters.End(function, endTime, endTicks, endHardwareCounters);
     }
 
     void ModelProfiler::EmitModelProfilerFunctions()
@@ -282,33 +332,56 @@ namespace model
         assert(_model != nullptr);
 
         EmitGetModelPerformanceCountersFunction();
+        EmitGetModelLatencyHistogramFunction();
         EmitPrintModelProfilingInfoFunction();
         EmitResetModelProfilingInfoFunction();
 
         // EmitGetNumNodesFunction();
         EmitGetNodeInfoFunction();
         EmitGetNodePerformanceCountersFunction();
+        EmitGetNodeLatencyHistogramFunction();
         EmitPrintNodeProfilingInfoFunction();
         EmitResetNodeProfilingInfoFunction();
 
         EmitGetNumNodeTypesFunction();
         EmitGetNodeTypeInfoFunction();
         EmitGetNodeTypePerformanceCountersFunction();
+        EmitGetNodeTypeLatencyHistogramFunction();
         EmitPrintNodeTypeProfilingInfoFunction();
         EmitResetNodeTypeProfilingInfoFunction();
+
+        if (_profileHardwareCounters)
+        {
+            EmitGetNodeHardwareCountersFunction();
+            EmitGetNodeTypeHardwareCountersFunction();
+        }
+
+        // The latency histograms are in profiler ticks, so make sure the conversion function is available
+        _module->GetRuntime().GetProfilerTicksPerMillisecondFunction();
     }
 
     void ModelProfiler::AllocateNodeData()
     {
         _modelPerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_ModelPerformanceCountersArray", _performanceCountersType, 2);
+        _modelLatencyHistogramArray = _module->GlobalArray(GetNamespacePrefix() + "_ModelLatencyHistogramArray", _latencyHistogramType, 1);
 
         int numNodes = _model->Size();
         _nodeInfoArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeInfoArray", _nodeInfoType, numNodes);
         _nodePerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodePerformanceCountersArray", _performanceCountersType, numNodes);
+        _nodeLatencyHistogramArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeLatencyHistogramArray", _latencyHistogramType, numNodes);
+        if (_profileHardwareCounters)
+        {
+            _nodeHardwareCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeHardwareCountersArray", _hardwareCountersType, numNodes);
+        }
 
         // Note: We're grossly overallocating global array for types
         _nodeTypeInfoArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypeInfoArray", _nodeInfoType, numNodes);
         _nodeTypePerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypePerformanceCountersArray", _performanceCountersType, numNodes);
+        _nodeTypeLatencyHistogramArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypeLatencyHistogramArray", _latencyHistogramType, numNodes);
+        if (_profileHardwareCounters)
+        {
+            _nodeTypeHardwareCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypeHardwareCountersArray", _hardwareCountersType, numNodes);
+        }
     }
 
     std::string ModelProfiler::GetNamespacePrefix() const
@@ -316,6 +389,11 @@ namespace model
         return _module->GetModuleName();
     }
 
+    std::string ModelProfiler::GetReadHardwareCountersFunctionName() const
+    {
+        return GetNamespacePrefix() + "_ReadHardwareCounters";
+    }
+
     void ModelProfiler::EmitGetModelPerformanceCountersFunction()
     {
         auto& emitter = _module->GetIREmitter();
@@ -329,6 +407,19 @@ namespace model
         _module->EndFunction();
     }
 
+    void ModelProfiler::EmitGetModelLatencyHistogramFunction()
+    {
+        auto& emitter = _module->GetIREmitter();
+        auto& irBuilder = emitter.GetIRBuilder();
+
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetModelLatencyHistogram", _latencyHistogramType->getPointerTo());
+        function.IncludeInHeader();
+
+        auto latencyHistogramPtr = irBuilder.CreateInBoundsGEP(_modelLatencyHistogramArray, { function.Literal(0), function.Literal(0) });
+        function.Return(latencyHistogramPtr);
+        _module->EndFunction();
+    }
+
     void ModelProfiler::EmitGetNumNodeTypesFunction()
     {
         auto& context = _module->GetLLVMContext();
@@ -393,6 +484,20 @@ namespace model
         _module->EndFunction();
     }
 
+    void ModelProfiler::EmitGetNodeLatencyHistogramFunction()
+    {
+        const emitters::NamedVariableTypeList parameters = { { "nodeIndex", emitters::VariableType::Int32 } };
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetNodeLatencyHistogram", _latencyHistogramType->getPointerTo(), parameters);
+        function.IncludeInHeader();
+
+        auto args = function.Arguments();
+        auto nodeIndex = &(*args.begin());
+        int numNodes = _nodePerformanceCounters.size();
+        auto nodeLatencyHistogramPtr = EmitGetElementOrNull(function, _nodeLatencyHistogramArray, nodeIndex, numNodes);
+        function.Return(nodeLatencyHistogramPtr);
+        _module->EndFunction();
+    }
+
     // TODO: return nullptr if out of bounds (this is device-side code, and we may not be able to throw exceptions)
     void ModelProfiler::EmitGetNodeTypePerformanceCountersFunction()
     {
@@ -410,6 +515,49 @@ namespace model
         _module->EndFunction();
     }
 
+    void ModelProfiler::EmitGetNodeTypeLatencyHistogramFunction()
+    {
+        const emitters::NamedVariableTypeList parameters = { { "nodeIndex", emitters::VariableType::Int32 } };
+
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetNodeTypeLatencyHistogram", _latencyHistogramType->getPointerTo(), parameters);
+        function.IncludeInHeader();
+
+        auto args = function.Arguments();
+        auto nodeIndex = &(*args.begin());
+        int numNodes = _nodeTypePerformanceCounters.size();
+        auto nodeLatencyHistogramPtr = EmitGetElementOrNull(function, _nodeTypeLatencyHistogramArray, nodeIndex, numNodes);
+        function.Return(nodeLatencyHistogramPtr);
+        _module->EndFunction();
+    }
+
+    void ModelProfiler::EmitGetNodeHardwareCountersFunction()
+    {
+        const emitters::NamedVariableTypeList parameters = { { "nodeIndex", emitters::VariableType::Int32 } };
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetNodeHardwareCounters", _hardwareCountersType->getPointerTo(), parameters);
+        function.IncludeInHeader();
+
+        auto args = function.Arguments();
+        auto nodeIndex = &(*args.begin());
+        int numNodes = _nodePerformanceCounters.size();
+        auto nodeHardwareCountersPtr = EmitGetElementOrNull(function, _nodeHardwareCountersArray, nodeIndex, numNodes);
+        function.Return(nodeHardwareCountersPtr);
+        _module->EndFunction();
+    }
+
+    void ModelProfiler::EmitGetNodeTypeHardwareCountersFunction()
+    {
+        const emitters::NamedVariableTypeList parameters = { { "nodeIndex", emitters::VariableType::Int32 } };
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetNodeTypeHardwareCounters", _hardwareCountersType->getPointerTo(), parameters);
+        function.IncludeInHeader();
+
+        auto args = function.Arguments();
+        auto nodeIndex = &(*args.begin());
+        int numNodes = _nodeTypePerformanceCounters.size();
+        auto nodeHardwareCountersPtr = EmitGetElementOrNull(function, _nodeTypeHardwareCountersArray, nodeIndex, numNodes);
+        function.Return(nodeHardwareCountersPtr);
+        _module->EndFunction();
+    }
+
     void ModelProfiler::EmitPrintModelProfilingInfoFunction()
     {
         auto& emitter = _module->GetIREmitter();
@@ -445,6 +593,9 @@ namespace model
         function.StoreZero(countPtr);
         function.StoreZero(totalTimePtr);
 
+        auto modelLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_modelLatencyHistogramArray, { function.Literal(0), function.Literal(0) });
+        emitters::ResetLatencyHistogram(function, modelLatencyHistogramPtr);
+
         _module->EndFunction();
     }
 
@@ -513,11 +664,17 @@ namespace model
 
         function.For(numEmittedNodes, [&irBuilder, this](emitters::IRFunctionEmitter& function, emitters::LLVMValue nodeIndex) {
             auto nodePerformanceCountersPtr = irBuilder.CreateInBoundsGEP(_nodePerformanceCountersArray, { function.Literal(0), nodeIndex });
+            auto nodeLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_nodeLatencyHistogramArray, { function.Literal(0), nodeIndex });
 
             auto countPtr = irBuilder.CreateInBoundsGEP(nodePerformanceCountersPtr, { function.Literal(0), function.Literal(0) });
             auto totalTimePtr = irBuilder.CreateInBoundsGEP(nodePerformanceCountersPtr, { function.Literal(0), function.Literal(1) });
             function.StoreZero(countPtr);
             function.StoreZero(totalTimePtr);
+            emitters::ResetLatencyHistogram(function, nodeLatencyHistogramPtr);
+            if (_profileHardwareCounters)
+            {
+                function.StoreZero(irBuilder.CreateInBoundsGEP(_nodeHardwareCountersArray, { function.Literal(0), nodeIndex }));
+            }
         });
 
         _module->EndFunction();
@@ -536,11 +693,17 @@ namespace model
 
         function.For(numEmittedNodes, [&irBuilder, this](emitters::IRFunctionEmitter& function, emitters::LLVMValue nodeIndex) {
             auto nodePerformanceCountersPtr = irBuilder.CreateInBoundsGEP(_nodeTypePerformanceCountersArray, { function.Literal(0), nodeIndex });
+            auto nodeLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_nodeTypeLatencyHistogramArray, { function.Literal(0), nodeIndex });
 
             auto countPtr = irBuilder.CreateInBoundsGEP(nodePerformanceCountersPtr, { function.Literal(0), function.Literal(0) });
             auto totalTimePtr = irBuilder.CreateInBoundsGEP(nodePerformanceCountersPtr, { function.Literal(0), function.Literal(1) });
             function.StoreZero(countPtr);
             function.StoreZero(totalTimePtr);
+            emitters::ResetLatencyHistogram(function, nodeLatencyHistogramPtr);
+            if (_profileHardwareCounters)
+            {
+                function.StoreZero(irBuilder.CreateInBoundsGEP(_nodeTypeHardwareCountersArray, { function.Literal(0), nodeIndex }));
+            }
         });
 
         _module->EndFunction();
@@ -558,8 +721,10 @@ namespace model
 
             auto nodeInfoPtr = irBuilder.CreateInBoundsGEP(_nodeInfoArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
             auto nodePerformanceCountersPtr = irBuilder.CreateInBoundsGEP(_nodePerformanceCountersArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
+            auto nodeLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_nodeLatencyHistogramArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
+            auto nodeHardwareCountersPtr = _profileHardwareCounters ? irBuilder.CreateInBoundsGEP(_nodeHardwareCountersArray, { emitter.Literal(0), emitter.Literal(nodeIndex) }) : nullptr;
 
-            NodePerformanceEmitter performanceCounters(*_module, &node, nodeInfoPtr, nodePerformanceCountersPtr, _nodeInfoType, _performanceCountersType);
+            NodePerformanceEmitter performanceCounters(*_module, &node, nodeInfoPtr, nodePerformanceCountersPtr, _nodeInfoType, _performanceCountersType, nodeLatencyHistogramPtr, nodeHardwareCountersPtr);
             _nodePerformanceCounters[&node] = performanceCounters;
         }
 
@@ -579,8 +744,10 @@ namespace model
 
             auto nodeTypeInfoPtr = irBuilder.CreateInBoundsGEP(_nodeTypeInfoArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
             auto nodeTypePerformanceCountersPtr = irBuilder.CreateInBoundsGEP(_nodeTypePerformanceCountersArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
+            auto nodeTypeLatencyHistogramPtr = irBuilder.CreateInBoundsGEP(_nodeTypeLatencyHistogramArray, { emitter.Literal(0), emitter.Literal(nodeIndex) });
+            auto nodeTypeHardwareCountersPtr = _profileHardwareCounters ? irBuilder.CreateInBoundsGEP(_nodeTypeHardwareCountersArray, { emitter.Literal(0), emitter.Literal(nodeIndex) }) : nullptr;
 
-            NodePerformanceEmitter performanceCounters(*_module, &node, nodeTypeInfoPtr, nodeTypePerformanceCountersPtr, _nodeInfoType, _performanceCountersType);
+            NodePerformanceEmitter performanceCounters(*_module, &node, nodeTypeInfoPtr, nodeTypePerformanceCountersPtr, _nodeInfoType, _performanceCountersType, nodeTypeLatencyHistogramPtr, nodeTypeHardwareCountersPtr);
             _nodeTypePerformanceCounters[nodeType] = performanceCounters;
         }
 
@@ -592,5 +759,34 @@ namespace model
         auto time = _module->GetRuntime().GetCurrentTime(function);
         return time;
     }
+
+    emitters::LLVMValue ModelProfiler::CallGetProfilerTicks(emitters::IRFunctionEmitter& function)
+    {
+        auto ticks = _module->GetRuntime().GetProfilerTicks(function);
+        return ticks;
+    }
+
+    emitters::LLVMValue ModelProfiler::EmitGetElementOrNull(emitters::IRFunctionEmitter& function, llvm::GlobalVariable* array, emitters::LLVMValue index, int numElements)
+    {
+        // This is device-side code, which may not be able to throw, so an out-of-bounds index returns null instead.
+        // The unsigned comparison also rejects negative indices.
+        auto& irBuilder = _module->GetIREmitter().GetIRBuilder();
+        auto elementPtr = irBuilder.CreateInBoundsGEP(array, { function.Literal(0), index });
+        auto isInBounds = irBuilder.CreateICmpULT(index, function.Literal(numElements));
+        auto nullPtr = function.NullPointer(llvm::cast<llvm::PointerType>(elementPtr->getType()));
+        return function.Select(isInBounds, elementPtr, nullPtr);
+    }
+
+    emitters::LLVMValue ModelProfiler::CallReadHardwareCounters(emitters::IRFunctionEmitter& function)
+    {
+        if (!_profileHardwareCounters)
+        {
+            return nullptr;
+        }
+
+        auto counters = function.Variable(emitters::VariableType::Int64, numHardwareCounters);
+        function.Call(GetReadHardwareCountersFunctionName(), { counters });
+        return counters;
+    }
 } // namespace model
 } // namespace ell
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Model.h"
+#include "ExecutionContext.h"
 #include "InputPort.h"
 #include "Node.h"
 #include "Port.h"
@@ -301,6 +302,17 @@ namespace model
         return _data->idToNodeMap;
     }
 
+    void Model::ComputeNode(const Node& node)
+    {
+        // A node that keeps state between evaluations belongs to the first execution context that computes it
+        auto context = ExecutionContext::GetCurrent();
+        if (context != nullptr && !node.IsComputeReentrant())
+        {
+            context->ClaimNode(node);
+        }
+        node.Compute();
+    }
+
     const OutputPortBase& Model::SimplifyOutputs(const PortElementsBase& elements)
     {
         const auto numRanges = elements.NumRanges();
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortMemoryPlanner.cpp (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PortMemoryPlanner.h"
+#include "InputPort.h"
+#include "Model.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace ell
+{
+namespace model
+{
+    std::ostream& operator<<(std::ostream& stream, const PortMemoryReport& report)
+    {
+        stream << "Shared port memory: " << report.numSharedPorts << " ports, " << report.peakSize << " bytes (" << report.naiveSize << " bytes unshared)";
+        return stream;
+    }
+
+    PortMemoryPlanner::PortMemoryPlanner(size_t alignment) :
+        _alignment(alignment)
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port memory alignment must be a power of 2");
+        }
+    }
+
+    void PortMemoryPlanner::Reset(const Model& model)
+    {
+        _currentNodeIndex = -1;
+        _nodeIndices.clear();
+        _lastUse.clear();
+        _liveBlocks.clear();
+        _report = {};
+
+        int index = 0;
+        model.Visit([this, &index](const Node& node) {
+            _nodeIndices[&node] = index;
+
+            // A port is live at least until the end of the node that produces it
+            for (auto output : node.GetOutputPorts())
+            {
+                _lastUse[output] = index;
+            }
+
+            for (auto input : node.GetInputPorts())
+            {
+                auto& lastUse = _lastUse[&input->GetReferencedPort()];
+                lastUse = std::max(lastUse, index);
+            }
+            ++index;
+        });
+    }
+
+    bool PortMemoryPlanner::CanSharePort(const OutputPortBase& port) const
+    {
+        // Padding must keep its initial value from one call to the next, so padded ports get their own storage
+        return _lastUse.find(&port) != _lastUse.end() && !port.GetMemoryLayout().HasPadding();
+    }
+
+    void PortMemoryPlanner::BeginNode(const Node& node)
+    {
+        auto it = _nodeIndices.find(&node);
+        _currentNodeIndex = it == _nodeIndices.end() ? -1 : it->second;
+    }
+
+    void PortMemoryPlanner::EndNode(const Node& node, const std::vector<const emitters::Variable*>& outputVariables)
+    {
+        if (_currentNodeIndex < 0)
+        {
+            return;
+        }
+
+        // Some nodes (e.g., a type cast to the same type) reuse their input's variable for their output.
+        // The block backing that variable has to stay live as long as the output port is being read.
+        const auto& outputs = node.GetOutputPorts();
+        for (size_t index = 0; index < outputs.size() && index < outputVariables.size(); ++index)
+        {
+            auto block = _liveBlocks.find(outputVariables[index]);
+            if (block != _liveBlocks.end())
+            {
+                block->second.lastUse = std::max(block->second.lastUse, GetLastUse(*outputs[index]));
+            }
+        }
+
+        for (auto it = _liveBlocks.begin(); it != _liveBlocks.end();)
+        {
+            if (it->second.lastUse <= _currentNodeIndex)
+            {
+                it = _liveBlocks.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        _currentNodeIndex = -1;
+    }
+
+    size_t PortMemoryPlanner::Allocate(const OutputPortBase& port, const emitters::Variable& variable, size_t size)
+    {
+        if (_currentNodeIndex < 0)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Port memory can only be allocated while compiling a node");
+        }
+
+        auto alignedSize = Align(size);
+        auto offset = FindFreeOffset(alignedSize);
+        _liveBlocks[&variable] = { offset, alignedSize, std::max(GetLastUse(port), _currentNodeIndex) };
+
+        ++_report.numSharedPorts;
+        _report.naiveSize += alignedSize;
+        _report.peakSize = std::max(_report.peakSize, offset + alignedSize);
+        return offset;
+    }
+
+    int PortMemoryPlanner::GetLastUse(const OutputPortBase& port) const
+    {
+        auto it = _lastUse.find(&port);
+        return it == _lastUse.end() ? std::numeric_limits<int>::max() : it->second;
+    }
+
+    size_t PortMemoryPlanner::FindFreeOffset(size_t size) const
+    {
+        std::vector<Block> blocks;
+        blocks.reserve(_liveBlocks.size());
+        for (const auto& entry : _liveBlocks)
+        {
+            blocks.push_back(entry.second);
+        }
+        std::sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) { return a.offset < b.offset; });
+
+        // Best fit: the smallest gap between live blocks that can hold the new block
+        size_t bestOffset = 0;
+        size_t bestGap = std::numeric_limits<size_t>::max();
+        size_t end = 0;
+        for (const auto& block : blocks)
+        {
+            if (block.offset >= end + size)
+            {
+                auto gap = block.offset - end;
+                if (gap < bestGap)
+                {
+                    bestGap = gap;
+                    bestOffset = end;
+                }
+            }
+            end = std::max(end, block.offset + block.size);
+        }
+
+        if (bestGap != std::numeric_limits<size_t>::max())
+        {
+            return bestOffset;
+        }
+
+        // Otherwise, place it after the last live block (growing the buffer if necessary)
+        return end;
+    }
+
+    size_t PortMemoryPlanner::Align(size_t size) const
+    {
+        return (size + _alignment - 1) & ~(_alignment - 1);
+    }
+} // namespace model
+} // namespace ell
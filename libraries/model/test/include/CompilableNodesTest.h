@@ -40,9 +40,11 @@ void TestCompilableScalarSumNode();
 void TestCompilableSumNode();
 void TestCompilableUnaryOperationNode();
 void TestCompilableUnaryOperation_square_Node();
+void TestCompilableVectorizedUnaryOperationNode();
 void TestL2NormSquaredNodeCompiled();
 void TestMatrixVectorProductNodeCompile();
 void TestCompilableBinaryOperationNode();
+void TestCompilableVectorizedBinaryOperationNode();
 void TestCompilableBinaryOperationNode2();
 void TestCompilableScalarBinaryPredicateNode();
 void TestCompilableBinaryPredicateNode();
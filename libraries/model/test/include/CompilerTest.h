@@ -38,6 +38,12 @@ void TestSum(bool expanded, bool optimize = false);
 void TestAccumulator(bool expanded);
 void TestDelay();
 void TestSqrt();
+void TestSharedPortMemory();
+void TestReentrantMap();
+void TestObjectCache();
+void TestBatchPredict(bool reentrant);
+void TestBatchPredictMatrixProducts(bool reentrant, bool parallelize);
+void TestCompiledForest(ell::model::ForestCompilationMethod method, int maxDepth);
 void TestBinaryPredicate(bool expanded);
 void TestMultiplexer();
 void TestSlidingAverage();
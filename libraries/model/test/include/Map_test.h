@@ -13,3 +13,7 @@ void TestMapComputeDataVector();
 void TestMapRefine();
 void TestMapSerialization();
 void TestMapClockNode();
+void TestMapComputeConcurrently();
+void TestMapComputeLayerConcurrently();
+void TestMapComputeStatefulNodeInTwoContexts();
+void TestMapComputeThroughput();
@@ -9,3 +9,4 @@
 #pragma once
 
 void TestPerformanceCounters();
+void TestHardwareCounters();
@@ -366,6 +366,23 @@ void TestCompilableUnaryOperation_square_Node()
     VerifyCompiledOutput(map, compiledMap, signal, "UnaryOperationNode_square");
 }
 
+void TestCompilableVectorizedUnaryOperationNode()
+{
+    // 11 elements, so the loop computes some full vectors and then the leftover elements
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(11);
+    auto testNode = model.AddNode<nodes::UnaryOperationNode<float>>(inputNode->output, emitters::UnaryOperationType::tanh);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // compare output
+    std::vector<std::vector<float>> signal = { { -5, -2, -1, -0.5f, -0.1f, 0, 0.1f, 0.5f, 1, 2, 5 }, { 3, -3, 0.25f, -0.25f, 0.75f, -0.75f, 1.5f, -1.5f, 4, -4, 0.01f } };
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized UnaryOperationNode");
+}
+
 void TestL2NormSquaredNodeCompiled()
 {
     model::Model model;
@@ -422,6 +439,23 @@ void TestCompilableBinaryOperationNode()
     VerifyCompiledOutput(map, compiledMap, signal, "BinaryOperationNode");
 }
 
+void TestCompilableVectorizedBinaryOperationNode()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(11);
+    auto constantNode = model.AddNode<nodes::ConstantNode<float>>(std::vector<float>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 });
+    auto testNode = model.AddNode<nodes::BinaryOperationNode<float>>(inputNode->output, constantNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // compare output
+    std::vector<std::vector<float>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }, { 7, 4, 2, 5, 2, 1, 3, 4, 5, 1, 0 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized BinaryOperationNode");
+}
+
 void TestCompilableBinaryOperationNode2()
 {
     model::Model model;
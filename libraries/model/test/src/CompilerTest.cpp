@@ -25,6 +25,8 @@
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
 #include <nodes/include/LinearPredictorNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
 #include <nodes/include/MatrixVectorProductNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
 #include <nodes/include/SinkNode.h>
@@ -37,18 +39,22 @@
 #include <emitters/include/IREmitter.h>
 #include <emitters/include/IRFunctionEmitter.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/ScalarVariable.h>
 #include <emitters/include/VectorVariable.h>
 
 #include <predictors/include/LinearPredictor.h>
 #include <predictors/include/ProtoNNPredictor.h>
 
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 
 #include <testing/include/testing.h>
 
+#include <cstdio>
 #include <iostream>
 #include <ostream>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -512,6 +518,298 @@ void TestSqrt()
     PrintIR(compiledMap);
 }
 
+void TestSharedPortMemory()
+{
+    const int size = 64;
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(size);
+    auto a = mb.Add<double>(input1->output, input1->output);
+    auto b = mb.Multiply<double>(a->output, a->output);
+    auto c = mb.Sqrt<double>(b->output);
+    auto d = mb.Add<double>(c->output, input1->output);
+    auto e = mb.Multiply<double>(d->output, d->output);
+    auto outputNode = mb.Outputs<double>(e->output);
+
+    model::MapCompilerOptions settings;
+    settings.sharePortMemory = true;
+    model::IRMapCompiler compiler(settings);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+
+    const auto& report = compiler.GetPortMemoryReport();
+    testing::ProcessTest("Testing shared port memory uses less memory than separate buffers", report.numSharedPorts > 0 && report.peakSize < report.naiveSize);
+
+    std::vector<std::vector<double>> signal;
+    for (int i = 0; i < 4; ++i)
+    {
+        signal.push_back(GetRandomVector<double>(size, 0.0, 10.0));
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "shared port memory map");
+}
+
+void TestReentrantMap()
+{
+    const int size = 4;
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(size);
+    auto accumulator = mb.Accumulate<double>(input1->output);
+    auto delay = mb.Delay<double>(accumulator->output, 2);
+    auto outputNode = mb.Outputs<double>(delay->output);
+
+    model::MapCompilerOptions settings;
+    settings.reentrant = true;
+    model::IRMapCompiler compiler(settings);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<double>> signal;
+    for (int i = 0; i < 6; ++i)
+    {
+        signal.push_back(GetRandomVector<double>(size, 0.0, 10.0));
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "reentrant map");
+
+    // Run two streams through separate state buffers, first one at a time and then interleaved
+    auto& jitter = compiledMap.GetJitter();
+    auto predict = reinterpret_cast<void (*)(void*, const double*, double*)>(jitter.ResolveFunctionAddress(settings.mapFunctionName));
+    auto getStateSize = reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress("ELL_GetStateSize"));
+    auto getStateAlignment = reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress("ELL_GetStateAlignment"));
+    auto initState = reinterpret_cast<void (*)(void*)>(jitter.ResolveFunctionAddress("ELL_InitState"));
+
+    auto stateSize = static_cast<size_t>(getStateSize());
+    auto stateAlignment = static_cast<size_t>(getStateAlignment());
+    std::vector<uint8_t> buffer1(stateSize + stateAlignment);
+    std::vector<uint8_t> buffer2(stateSize + stateAlignment);
+    auto alignState = [stateAlignment](std::vector<uint8_t>& buffer) {
+        auto address = reinterpret_cast<uintptr_t>(buffer.data());
+        return reinterpret_cast<void*>((address + stateAlignment - 1) & ~(stateAlignment - 1));
+    };
+    auto state1 = alignState(buffer1);
+    auto state2 = alignState(buffer2);
+
+    std::vector<std::vector<double>> reversedSignal(signal.rbegin(), signal.rend());
+    auto runStream = [&](void* state, const std::vector<std::vector<double>>& stream) {
+        std::vector<std::vector<double>> outputs;
+        initState(state);
+        for (const auto& input : stream)
+        {
+            std::vector<double> output(size);
+            predict(state, input.data(), output.data());
+            outputs.push_back(output);
+        }
+        return outputs;
+    };
+    auto expected1 = runStream(state1, signal);
+    auto expected2 = runStream(state2, reversedSignal);
+
+    initState(state1);
+    initState(state2);
+    bool ok = true;
+    for (size_t index = 0; index < signal.size(); ++index)
+    {
+        std::vector<double> output1(size);
+        std::vector<double> output2(size);
+        predict(state1, signal[index].data(), output1.data());
+        predict(state2, reversedSignal[index].data(), output2.data());
+        ok = ok && testing::IsEqual(output1, expected1[index]) && testing::IsEqual(output2, expected2[index]);
+    }
+    testing::ProcessTest("Testing reentrant map with interleaved streams", stateSize > 0 && ok);
+}
+
+void TestBatchPredict(bool reentrant)
+{
+    const int size = 4;
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(size);
+    auto product = mb.Multiply<double>(input1->output, input1->output);
+    auto accumulator = mb.Accumulate<double>(product->output);
+    auto outputNode = mb.Outputs<double>(accumulator->output);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.emitBatchPredict = true;
+    settings.batchTileSize = 4;
+    settings.reentrant = reentrant;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // Each node runs the samples of a tile in order, so the accumulator sees the same sequence as the reference map.
+    // The last sample doesn't fill a tile, so predict computes it.
+    const size_t batchSize = 21;
+    std::vector<double> inputs;
+    std::vector<double> expected;
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        auto input = GetRandomVector<double>(size, 0.0, 10.0);
+        auto output = map.Compute<double>(input);
+        inputs.insert(inputs.end(), input.begin(), input.end());
+        expected.insert(expected.end(), output.begin(), output.end());
+    }
+
+    std::vector<double> outputs(batchSize * size);
+    compiledMap.ComputeBatch(batchSize, inputs.data(), outputs.data());
+    testing::ProcessTest(std::string("Testing batch predict") + (reentrant ? " (reentrant)" : ""), testing::IsEqual(outputs, expected, 1e-8));
+}
+
+void TestBatchPredictMatrixProducts(bool reentrant, bool parallelize)
+{
+    // An unrolled convolution (filters times a receptive field matrix, with a transposed output), a fully-connected
+    // layer and a product with a batched left-hand matrix, which all compute a whole tile with one GEMM
+    const int m = 3;
+    const int n = 4;
+    const int k = 5;
+    const int p = 8;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(k * n);
+    auto filters = model.AddNode<nodes::ConstantNode<double>>(GetRandomVector<double>(m * k, -1.0, 1.0));
+    auto convolution = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(filters->output, m, n, k, k, false, inputNode->output, n, false, m, true);
+    auto weights = model.AddNode<nodes::ConstantNode<double>>(GetRandomVector<double>(p * n * m, -1.0, 1.0));
+    auto fullyConnected = model.AddNode<nodes::MatrixVectorMultiplyNode<double>>(weights->output, p, n * m, n * m, convolution->output);
+    auto projection = model.AddNode<nodes::ConstantNode<double>>(GetRandomVector<double>((p / 2) * 3, -1.0, 1.0));
+    auto product = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(fullyConnected->output, 2, 3, p / 2, p / 2, false, projection->output, 3, false, 3, false);
+    auto outputNode = model.AddNode<model::OutputNode<double>>(product->output);
+    model::Map map{ model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.emitBatchPredict = true;
+    settings.batchTileSize = 4;
+    settings.reentrant = reentrant;
+    settings.compilerSettings.parallelize = parallelize;
+    settings.compilerSettings.maxThreads = 3;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // With 3 threads, the first two get 2 tiles each, and the last one gets the 2 samples that predict computes
+    const size_t batchSize = 18;
+    const size_t outputSize = map.GetOutput(0).Size();
+    std::vector<double> inputs;
+    std::vector<double> expected;
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        auto input = GetRandomVector<double>(k * n, -1.0, 1.0);
+        auto output = map.Compute<double>(input);
+        inputs.insert(inputs.end(), input.begin(), input.end());
+        expected.insert(expected.end(), output.begin(), output.end());
+    }
+
+    std::vector<double> outputs(batchSize * outputSize);
+    compiledMap.ComputeBatch(batchSize, inputs.data(), outputs.data());
+    std::string suffix = reentrant ? (parallelize ? " (reentrant, parallel)" : " (reentrant)") : "";
+    testing::ProcessTest("Testing batch predict with matrix products" + suffix, testing::IsEqual(outputs, expected, 1e-8));
+}
+
+void TestObjectCache()
+{
+    const int size = 4;
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(size);
+    auto accumulator = mb.Accumulate<double>(input1->output);
+    auto outputNode = mb.Outputs<double>(accumulator->output);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.objectCacheDirectory = utilities::JoinPaths(utilities::GetWorkingDirectory(), "object_cache_test");
+
+    std::vector<std::vector<double>> signal;
+    for (int i = 0; i < 4; ++i)
+    {
+        signal.push_back(GetRandomVector<double>(size, 0.0, 10.0));
+    }
+
+    // Start from an empty cache entry: the next compilation generates code and stores the object, and the one after loads it
+    auto objectPath = emitters::IRObjectCache(settings.objectCacheDirectory, model::IRMapCompiler(settings).Compile(map).GetObjectCacheKey()).GetObjectPath();
+    std::remove(objectPath.c_str());
+    {
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "object cache miss");
+    }
+    testing::ProcessTest("Testing object cache stores compiled object", utilities::FileExists(objectPath));
+
+    {
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "object cache hit");
+    }
+    std::remove(objectPath.c_str());
+}
+
+namespace
+{
+void AddRandomSplit(predictors::SimpleForestPredictor& forest, const predictors::SimpleForestPredictor::SplittableNodeId& nodeId, size_t numFeatures, int depth, std::default_random_engine& engine)
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    std::uniform_real_distribution<double> valueDistribution(-1.0, 1.0);
+    std::bernoulli_distribution splitDistribution(0.7);
+
+    auto feature = featureDistribution(engine);
+    auto threshold = valueDistribution(engine);
+    auto nodeIndex = forest.Split(SplitAction{ nodeId, SplitRule{ feature, threshold }, EdgePredictorVector{ valueDistribution(engine), valueDistribution(engine) } });
+    for (size_t position = 0; position < 2; ++position)
+    {
+        if (depth > 1 && splitDistribution(engine))
+        {
+            AddRandomSplit(forest, forest.GetChildId(nodeIndex, position), numFeatures, depth - 1, engine);
+        }
+    }
+}
+
+std::string GetForestMethodName(model::ForestCompilationMethod method)
+{
+    switch (method)
+    {
+    case model::ForestCompilationMethod::refine:
+        return "refine";
+    case model::ForestCompilationMethod::traversal:
+        return "traversal";
+    case model::ForestCompilationMethod::bitvector:
+        return "bitvector";
+    }
+    return "";
+}
+} // namespace
+
+void TestCompiledForest(model::ForestCompilationMethod method, int maxDepth)
+{
+    const size_t numFeatures = 5;
+    const int numTrees = 12;
+    std::default_random_engine engine(1234);
+    predictors::SimpleForestPredictor forest;
+    for (int treeIndex = 0; treeIndex < numTrees; ++treeIndex)
+    {
+        AddRandomSplit(forest, forest.GetNewRootId(), numFeatures, maxDepth, engine);
+    }
+    forest.AddToBias(0.25);
+
+    std::vector<std::vector<double>> signal;
+    for (int i = 0; i < 20; ++i)
+    {
+        signal.push_back(GetRandomVector<double>(numFeatures, -1.0, 1.0));
+    }
+
+    model::MapCompilerOptions settings;
+    settings.forestMethod = method;
+    auto methodName = GetForestMethodName(method);
+
+    // Compile one map per output port, so each port is checked (and the unused ones are left unreferenced)
+    for (std::string portName : { "output", "treeOutputs", "edgeIndicatorVector" })
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<double>>(numFeatures);
+        auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+        const auto& outputPort = *forestNode->GetOutputPort(portName);
+        model::Map map{ model, { { "input", inputNode } }, { { "output", model::PortElementsBase(outputPort) } } };
+
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "forest " + portName, " (" + methodName + ", depth " + std::to_string(maxDepth) + ")");
+    }
+}
+
 void TestBinaryPredicate(bool expanded)
 {
     std::vector<double> data = { 5 };
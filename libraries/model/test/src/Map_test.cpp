@@ -14,27 +14,39 @@
 
 #include <data/include/DenseDataVector.h>
 
+#include <model/include/ExecutionContext.h>
 #include <model/include/InputNode.h>
 #include <model/include/Map.h>
 #include <model/include/Model.h>
 #include <model/include/OutputNode.h>
 #include <model/include/PortElements.h>
 
+#include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/ClockNode.h>
+#include <nodes/include/ConstantNode.h>
 #include <nodes/include/ExtremalValueNode.h>
 #include <nodes/include/MovingAverageNode.h>
+#include <nodes/include/ScalingLayerNode.h>
 #include <nodes/include/SinkNode.h>
 #include <nodes/include/SourceNode.h>
+#include <nodes/include/SumNode.h>
+
+#include <predictors/neural/include/ScalingLayer.h>
 
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MillisecondTimer.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <thread>
 #include <tuple>
+#include <vector>
 
 using namespace ell;
 
@@ -216,3 +228,190 @@ void TestMapClockNode()
     std::vector<nodes::TimeTickType> expectedLagValues = { lagThreshold, lagThreshold * 20 };
     testing::ProcessTest("Testing lag callbacks", testing::IsEqual(lagValues, expectedLagValues));
 }
+
+namespace
+{
+// Returns a map computing the dot product of its input with a constant vector of weights
+model::Map GetWeightedSumMap(const std::vector<double>& weights)
+{
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(weights.size());
+    auto weightsNode = model.AddNode<nodes::ConstantNode<double>>(weights);
+    auto product = model.AddNode<nodes::BinaryOperationNode<double>>(in->output, weightsNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto sum = model.AddNode<nodes::SumNode<double>>(product->output);
+    return model::Map(model, { { "input", in } }, { { "output", sum->output } });
+}
+
+std::vector<double> GetWeightedSumInput(size_t size, int index)
+{
+    std::vector<double> input(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        input[i] = static_cast<double>(index % 17) - static_cast<double>(i % 5);
+    }
+    return input;
+}
+
+double GetWeightedSum(const std::vector<double>& weights, const std::vector<double>& input)
+{
+    double result = 0;
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        result += weights[i] * input[i];
+    }
+    return result;
+}
+} // namespace
+
+void TestMapComputeConcurrently()
+{
+    const size_t size = 16;
+    const int numThreads = 4;
+    const int numIterations = 200;
+    std::vector<double> weights(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        weights[i] = 0.5 * i - 2.0;
+    }
+    auto map = GetWeightedSumMap(weights);
+
+    // compute once in the map itself, so we can check the concurrent evaluations leave its values alone
+    auto mapInput = GetWeightedSumInput(size, 3);
+    auto mapOutput = map.Compute<double>(mapInput);
+
+    std::atomic<int> numErrors(0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            model::ExecutionContext context;
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                auto input = GetWeightedSumInput(size, threadIndex * numIterations + iteration);
+                auto output = map.Compute<double>(input, context);
+                if (output.size() != 1 || !testing::IsEqual(output[0], GetWeightedSum(weights, input)))
+                {
+                    ++numErrors;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing concurrent Map::Compute with execution contexts", numErrors == 0);
+    testing::ProcessTest("Testing execution contexts leave the map's values alone", testing::IsEqual(map.ComputeOutput<double>(0), mapOutput) && testing::IsEqual(mapOutput[0], GetWeightedSum(weights, mapInput)));
+}
+
+void TestMapComputeLayerConcurrently()
+{
+    using namespace predictors::neural;
+    using LayerParameters = Layer<double>::LayerParameters;
+    const size_t size = 16;
+    const int numThreads = 4;
+    const int numIterations = 200;
+
+    // The layer's output tensor is scratch space, which each context must have its own copy of
+    Layer<double>::TensorType layerInput(1, 1, size);
+    Layer<double>::VectorType scales(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        scales[i] = 0.5 * i - 2.0;
+    }
+    ScalingLayer<double> layer(LayerParameters{ layerInput, NoPadding(), { 1, 1, size }, NoPadding() }, scales);
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(size);
+    auto scaling = model.AddNode<nodes::ScalingLayerNode<double>>(in->output, layer);
+    auto sum = model.AddNode<nodes::SumNode<double>>(scaling->output);
+    model::Map map(model, { { "input", in } }, { { "output", sum->output } });
+    auto weights = scales.ToArray();
+
+    std::atomic<int> numErrors(0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            model::ExecutionContext context;
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                auto input = GetWeightedSumInput(size, threadIndex * numIterations + iteration);
+                auto output = map.Compute<double>(input, context);
+                if (output.size() != 1 || !testing::IsEqual(output[0], GetWeightedSum(weights, input)))
+                {
+                    ++numErrors;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing concurrent Map::Compute of a neural network layer with execution contexts", numErrors == 0);
+}
+
+void TestMapComputeStatefulNodeInTwoContexts()
+{
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(1);
+    auto average = model.AddNode<nodes::MovingAverageNode<double>>(in->output, 4);
+    model::Map map(model, { { "input", in } }, { { "output", average->output } });
+
+    // The moving average's window is kept in the node, so it belongs to the first context that computes it
+    model::ExecutionContext firstContext;
+    map.Compute<double>(std::vector<double>{ 1.0 }, firstContext);
+    auto computeInSecondContext = [&map]() {
+        model::ExecutionContext secondContext;
+        try
+        {
+            map.Compute<double>(std::vector<double>{ 2.0 }, secondContext);
+        }
+        catch (const utilities::LogicException&)
+        {
+            return false;
+        }
+        return true;
+    };
+    testing::ProcessTest("Testing a stateful node can't be computed in a second execution context", !computeInSecondContext());
+
+    map.Compute<double>(std::vector<double>{ 1.0 }, firstContext);
+    firstContext.Clear();
+    testing::ProcessTest("Testing a stateful node is released when its execution context is cleared", computeInSecondContext());
+}
+
+void TestMapComputeThroughput()
+{
+    const size_t size = 256;
+    const int numEvaluations = 4000;
+    std::vector<double> weights(size, 0.25);
+    auto map = GetWeightedSumMap(weights);
+    auto input = GetWeightedSumInput(size, 1);
+
+    std::cout << "Map::Compute throughput with one execution context per thread (" << numEvaluations << " evaluations)" << std::endl;
+    std::cout << std::setw(10) << "threads" << std::setw(20) << "evaluations/sec" << std::endl;
+    for (int numThreads : { 1, 2, 4, 8 })
+    {
+        utilities::MillisecondTimer timer;
+        std::vector<std::thread> threads;
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            auto count = numEvaluations / numThreads + (threadIndex < numEvaluations % numThreads ? 1 : 0);
+            threads.emplace_back([&map, &input, count]() {
+                model::ExecutionContext context;
+                for (int iteration = 0; iteration < count; ++iteration)
+                {
+                    map.Compute<double>(input, context);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto elapsed = std::max<int64_t>(timer.Elapsed(), 1);
+        std::cout << std::setw(10) << numThreads << std::setw(20) << static_cast<int64_t>(numEvaluations * 1000.0 / elapsed) << std::endl;
+    }
+}
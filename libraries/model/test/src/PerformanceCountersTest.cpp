@@ -28,12 +28,28 @@
 
 #include <utilities/include/RandomEngines.h>
 
+#include <cstdint>
 #include <iostream>
 #include <ostream>
 #include <string>
 
 using namespace ell;
 
+namespace
+{
+// Stands in for the hardware counters: counter i goes up by i + 1 between consecutive reads
+int64_t numHardwareCounterReads = 0;
+
+void ReadFakeHardwareCounters(int64_t* counters)
+{
+    ++numHardwareCounterReads;
+    for (int index = 0; index < model::numHardwareCounters; ++index)
+    {
+        counters[index] = numHardwareCounterReads * (index + 1);
+    }
+}
+} // namespace
+
 std::vector<double> GenerateMatrixValues(size_t m, size_t n)
 {
     auto rnd = utilities::GetRandomEngine("123");
@@ -133,3 +149,58 @@ void TestPerformanceCounters()
         testing::ProcessTest("ModelProfiler GetNodePerformanceCounters", nodeStats->count == numIter);
     }
 }
+
+void TestHardwareCounters()
+{
+    model::Model model;
+    int m = 20;
+    int k = 50;
+    int n = 30;
+    int numIter = 4;
+
+    auto inputNode = model.AddNode<model::InputNode<double>>(m * k);
+    auto matrix2Node = model.AddNode<nodes::ConstantNode<double>>(GenerateMatrixValues(k, n));
+    auto matrixMultNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(inputNode->output, m, n, k, k, matrix2Node->output, n, n);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", matrixMultNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.profile = true;
+    settings.profileHardwareCounters = true;
+    model::IRMapCompiler compiler(settings);
+
+    // Grab a pointer to the module before compiling transfers its ownership to the compiled map
+    auto module = compiler.GetModule().GetLLVMModule();
+    auto compiledMap = compiler.Compile(map);
+    auto readCountersFunction = module->getFunction(settings.moduleName + "_ReadHardwareCounters");
+    testing::ProcessTest("ModelProfiler declares ReadHardwareCounters", readCountersFunction != nullptr);
+    if (readCountersFunction == nullptr)
+    {
+        return;
+    }
+    compiledMap.GetJitter().DefineFunction(readCountersFunction, reinterpret_cast<uintptr_t>(&ReadFakeHardwareCounters));
+
+    auto input = GenerateMatrixValues(m, k);
+    for (int iter = 0; iter < numIter; ++iter)
+    {
+        compiledMap.SetInputValue(0, input);
+        auto compiledResult = compiledMap.ComputeOutput<double>(0);
+    }
+
+    // Each node reads the counters as it starts and ends, so it sees each counter go up by one step per run
+    bool countersOk = true;
+    auto numNodes = compiledMap.GetNumProfiledNodes();
+    for (int nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+    {
+        auto counters = compiledMap.GetNodeHardwareCounters(nodeIndex);
+        countersOk = countersOk && counters->cycles == numIter && counters->instructions == 2 * numIter && counters->l1DataCacheMisses == 3 * numIter && counters->lastLevelCacheMisses == 4 * numIter && counters->branchMisses == 5 * numIter;
+    }
+    testing::ProcessTest("ModelProfiler GetNodeHardwareCounters", countersOk);
+
+    compiledMap.ResetNodeProfilingInfo();
+    bool resetOk = true;
+    for (int nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+    {
+        resetOk = resetOk && compiledMap.GetNodeHardwareCounters(nodeIndex)->cycles == 0;
+    }
+    testing::ProcessTest("ModelProfiler ResetNodeProfilingInfo resets hardware counters", resetOk);
+}
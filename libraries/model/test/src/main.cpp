@@ -54,6 +54,10 @@ int main()
         TestMapRefine();
         TestMapSerialization();
         TestMapClockNode();
+        TestMapComputeConcurrently();
+        TestMapComputeLayerConcurrently();
+        TestMapComputeStatefulNodeInTwoContexts();
+        TestMapComputeThroughput();
 
         TestCustomRefine();
 
@@ -53,6 +53,18 @@ void TestIRCompiler()
     TestAccumulator(true);
     TestDelay();
     TestSqrt();
+    TestSharedPortMemory();
+    TestReentrantMap();
+    TestObjectCache();
+    TestBatchPredict(false);
+    TestBatchPredict(true);
+    TestBatchPredictMatrixProducts(false, false);
+    TestBatchPredictMatrixProducts(true, false);
+    TestBatchPredictMatrixProducts(true, true);
+    TestCompiledForest(model::ForestCompilationMethod::refine, 3);
+    TestCompiledForest(model::ForestCompilationMethod::traversal, 5);
+    TestCompiledForest(model::ForestCompilationMethod::bitvector, 5);
+    TestCompiledForest(model::ForestCompilationMethod::bitvector, 8); // some trees have more than 64 leaves, so this falls back to traversal
     TestBinaryPredicate(false);
     TestSlidingAverage();
     TestDotProductOutput();
@@ -98,7 +110,9 @@ void TestIRCompiler()
     TestCompilableScalarSumNode();
     TestCompilableSumNode();
     TestCompilableUnaryOperationNode();
+    TestCompilableVectorizedUnaryOperationNode();
     TestCompilableBinaryOperationNode();
+    TestCompilableVectorizedBinaryOperationNode();
     TestCompilableBinaryOperationNode2();
     TestCompilableScalarBinaryPredicateNode();
     TestCompilableBinaryPredicateNode();
@@ -120,6 +134,7 @@ void TestIRCompiler()
     TestCompilableFFTNode();
 
     TestPerformanceCounters();
+    TestHardwareCounters();
     TestCompilableDotProductNode2<float>(3); // uses IR
     TestCompilableDotProductNode2<double>(3); // uses IR
     TestCompilableDotProductNode2<float>(4); // uses IR
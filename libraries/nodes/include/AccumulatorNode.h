@@ -56,6 +56,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the accumulator
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
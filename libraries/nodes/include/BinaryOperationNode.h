@@ -100,6 +100,15 @@ namespace nodes
         /// <returns> The operation </returns>
         emitters::BinaryOperationType GetOperation() const { return _operation; }
 
+        /// <summary> Gets the layout of the left-hand input. </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout1() const { return _inputLayout1; }
+
+        /// <summary> Gets the layout of the right-hand input. </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout2() const { return _inputLayout2; }
+
+        /// <summary> Gets the layout of the output. </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -451,8 +460,9 @@ namespace nodes
         emitters::LLVMValue pResult = compiler.EnsurePortEmitted(output);
 
         auto count = input1.Size();
-        function.VectorOperator(emitters::GetOperator<ValueType>(GetOperation()), count, pInput1, pInput2, [&pResult, &function](emitters::LLVMValue i, emitters::LLVMValue pValue) {
-            function.SetValueAt(pResult, i, pValue);
+        auto op = emitters::GetOperator<ValueType>(GetOperation());
+        function.ElementwiseFor(static_cast<int>(count), { pInput1, pInput2 }, pResult, [op](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> values) {
+            return function.Operator(op, values[0], values[1]);
         });
     }
 
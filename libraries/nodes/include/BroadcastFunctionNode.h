@@ -217,6 +217,49 @@ namespace nodes
         bool CanUseVectorTypes() const { return true; }
     };
 
+    //
+    // A linear function followed by a unary activation function: y = f(x*a + b). Used to fuse an activation
+    // into the loop of the linear operation before it.
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    class BroadcastLinearActivationFunction : public BroadcastTernaryFunction<ValueType>
+    {
+    public:
+        BroadcastLinearActivationFunction() = default;
+        BroadcastLinearActivationFunction(const BroadcastLinearActivationFunction&) = default;
+
+        /// <summary> Constructor specifying the activation function. </summary>
+        ///
+        /// <param name="activation"> The activation function to apply to the result of the linear function. </param>
+        BroadcastLinearActivationFunction(ActivationFunctionType activation) :
+            _activation(activation) {}
+
+        /// <summary> Computes the function (on the host machine) </summary>
+        ///
+        /// <param name="x"> The primary value </param>
+        /// <param name="a"> The first secondary value </param>
+        /// <param name="b"> The second secondary value </param>
+        /// <returns> The value the function f(ax + b) </returns>
+        ValueType Compute(ValueType x, ValueType a, ValueType b) const override;
+        using BroadcastTernaryFunction<ValueType>::Compute;
+
+        /// <summary> Emits IR to compute a value </summary>
+        ///
+        /// <param name="x"> The primary value </param>
+        /// <param name="a"> The first secondary value, or null if there is no scale </param>
+        /// <param name="b"> The second secondary value, or null if there is no bias </param>
+        /// <returns> The value the function f(ax + b) </returns>
+        emitters::LLVMValue Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue x, emitters::LLVMValue a, emitters::LLVMValue b) const override;
+        using BroadcastTernaryFunction<ValueType>::Compile;
+
+        /// <summary> Gets the activation function </summary>
+        const ActivationFunctionType& GetActivationFunction() const { return _activation; }
+
+    private:
+        BroadcastLinearFunction<ValueType> _linear;
+        ActivationFunctionType _activation;
+    };
+
     //
     // Base class for broadcast nodes
     //
@@ -266,6 +309,7 @@ namespace nodes
         virtual const model::OutputPort<ValueType>& GetOutput() const = 0;
         bool IsSecondaryInputPresent(int index) const;
         FunctionType GetFunction() const { return _function; }
+        void SetFunction(FunctionType function) { _function = function; }
 
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -335,9 +379,10 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
 
-    protected:
+        /// <summary> Gets the function this node applies. </summary>
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
 
+    protected:
         utilities::ArchiveVersion GetArchiveVersion() const override;
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -546,6 +591,46 @@ namespace nodes
     private:
         void Copy(model::ModelTransformer& transformer) const override;
     };
+
+    //
+    // Special case of BroadcastTernaryFunctionNode, using a linear function followed by an activation function
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    class BroadcastLinearActivationFunctionNode : public BroadcastTernaryFunctionNode<ValueType, BroadcastLinearActivationFunction<ValueType, ActivationFunctionType>>
+    {
+    public:
+        using FunctionType = BroadcastLinearActivationFunction<ValueType, ActivationFunctionType>;
+        using BroadcastTernaryFunctionNode<ValueType, FunctionType>::primaryInput;
+        using BroadcastTernaryFunctionNode<ValueType, FunctionType>::secondaryInput1;
+        using BroadcastTernaryFunctionNode<ValueType, FunctionType>::secondaryInput2;
+        using BroadcastTernaryFunctionNode<ValueType, FunctionType>::output;
+
+        /// <summary></summary>
+        BroadcastLinearActivationFunctionNode();
+
+        /// <summary></summary>
+        BroadcastLinearActivationFunctionNode(const model::OutputPort<ValueType>& primaryInput, const model::PortMemoryLayout& inputLayout, const model::OutputPort<ValueType>& scaleInput, const model::OutputPort<ValueType>& biasInput, size_t secondaryInputDimension, const model::PortMemoryLayout& outputLayout, ActivationFunctionType activation, ValueType padding = 0);
+
+        /// <summary> Gets the activation function applied after the linear function. </summary>
+        ActivationFunctionType GetActivationFunction() const { return this->GetFunction().GetActivationFunction(); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, ActivationFunctionType>("BroadcastLinearActivationFunctionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+    };
 } // namespace nodes
 } // namespace ell
 
@@ -632,6 +717,22 @@ namespace nodes
         }
     }
 
+    //
+    // BroadcastLinearActivationFunction
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    ValueType BroadcastLinearActivationFunction<ValueType, ActivationFunctionType>::Compute(ValueType x, ValueType scale, ValueType bias) const
+    {
+        return _activation.Compute(_linear.Compute(x, scale, bias));
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    emitters::LLVMValue BroadcastLinearActivationFunction<ValueType, ActivationFunctionType>::Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue x, emitters::LLVMValue scale, emitters::LLVMValue bias) const
+    {
+        auto linearValue = (scale == nullptr && bias == nullptr) ? x : _linear.Compile(function, x, scale, bias);
+        return _activation.Compile(function, linearValue);
+    }
+
     //
     // BroadcastFunctionNode
     //
@@ -831,6 +932,58 @@ namespace nodes
         const auto broadcastDimension = GetBroadcastDimension();
         const auto numSecondaryInputs = NumSecondaryInputs();
 
+        // The innermost dimension is contiguous in memory, so when vector instructions are allowed it's computed by an
+        // elementwise loop over a row of the input and output. The secondary values are broadcast to vectors, unless this
+        // is the broadcast dimension, in which case they're loaded from the secondary inputs along with the primary values.
+        auto valueType = function.GetEmitter().Type(emitters::GetVariableType<ValueType>());
+        if (dimension == numDimensions - 1 && begin.IsConstantInt() && end.IsConstantInt() && function.GetVectorSize(valueType) > 1)
+        {
+            const auto beginIndex = begin.GetIntValue<int>();
+            const auto count = end.GetIntValue<int>() - beginIndex;
+            auto inputRowOffset = function.LocalScalar<int>(beginIndex + inputOffset[dimension]);
+            auto outputRowOffset = function.LocalScalar<int>(beginIndex + outputOffset[dimension]);
+            if (dimension != 0)
+            {
+                inputRowOffset = inputRowOffset + (prevInputDimensionOffset * inputStride[dimension]);
+                outputRowOffset = outputRowOffset + (prevOutputDimensionOffset * outputStride[dimension]);
+            }
+
+            std::vector<emitters::LLVMValue> rowInputs = { function.PointerOffset(primaryInput, inputRowOffset) };
+            if (dimension == broadcastDimension)
+            {
+                for (int index = 0; index < numSecondaryInputs; ++index)
+                {
+                    if (this->IsSecondaryInputPresent(index))
+                    {
+                        rowInputs.push_back(function.PointerOffset(secondaryInputs[index], beginIndex));
+                    }
+                }
+            }
+
+            auto rowOutput = function.PointerOffset(output, outputRowOffset);
+            function.ElementwiseFor(count, rowInputs, rowOutput, [dimension, broadcastDimension, numSecondaryInputs, &secondaryValues, this](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> values) {
+                std::vector<emitters::LLVMValue> elementSecondaryValues;
+                size_t nextValueIndex = 1;
+                for (int index = 0; index < numSecondaryInputs; ++index)
+                {
+                    if (!this->IsSecondaryInputPresent(index))
+                    {
+                        elementSecondaryValues.push_back(nullptr);
+                    }
+                    else if (dimension == broadcastDimension)
+                    {
+                        elementSecondaryValues.push_back(values[nextValueIndex++]);
+                    }
+                    else
+                    {
+                        elementSecondaryValues.push_back(emitters::BroadcastLike(function, secondaryValues[index], values[0]));
+                    }
+                }
+                return this->GetFunction().Compile(function, values[0], elementSecondaryValues);
+            });
+            return;
+        }
+
         function.For(begin, end, [dimension, numDimensions, inputSize, inputOffset, inputStride, outputOffset, outputStride, broadcastDimension, numSecondaryInputs, prevInputDimensionOffset, prevOutputDimensionOffset, primaryInput, secondaryInputs, output, &secondaryValues, &compiler, this](emitters::IRFunctionEmitter& function, auto loopIndex) {
             // Calculate the offset within this dimension = (loopIndex + offset[dimension])
             auto thisInputDimensionInternalOffset = loopIndex + inputOffset[dimension];
@@ -1313,6 +1466,53 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    //
+    // BroadcastLinearActivationFunctionNode
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>::BroadcastLinearActivationFunctionNode() :
+        BroadcastTernaryFunctionNode<ValueType, FunctionType>()
+    {
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>::BroadcastLinearActivationFunctionNode(const model::OutputPort<ValueType>& primaryInput, const model::PortMemoryLayout& inputLayout, const model::OutputPort<ValueType>& scaleInput, const model::OutputPort<ValueType>& biasInput, size_t dimension, const model::PortMemoryLayout& outputLayout, ActivationFunctionType activation, ValueType paddingValue) :
+        BroadcastTernaryFunctionNode<ValueType, FunctionType>(primaryInput, inputLayout, scaleInput, biasInput, dimension, outputLayout, FunctionType{ activation }, paddingValue)
+    {
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    void BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        BroadcastTernaryFunctionNode<ValueType, FunctionType>::WriteToArchive(archiver);
+        GetActivationFunction().WriteToArchive(archiver);
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    void BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        BroadcastTernaryFunctionNode<ValueType, FunctionType>::ReadFromArchive(archiver);
+        ActivationFunctionType activation;
+        activation.ReadFromArchive(archiver);
+        this->SetFunction(FunctionType{ activation });
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    void BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& primaryInputElements = transformer.GetCorrespondingInputs(primaryInput);
+        const auto& scaleInputElements = transformer.GetCorrespondingInputs(secondaryInput1);
+        const auto& biasInputElements = transformer.GetCorrespondingInputs(secondaryInput2);
+        auto newNode = transformer.AddNode<BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>>(primaryInputElements,
+                                                                                                                     this->GetInputMemoryLayout(),
+                                                                                                                     scaleInputElements,
+                                                                                                                     biasInputElements,
+                                                                                                                     this->GetBroadcastDimension(),
+                                                                                                                     this->GetOutputMemoryLayout(),
+                                                                                                                     GetActivationFunction(),
+                                                                                                                     this->GetOutputPadding());
+        transformer.MapNodeOutput(output, newNode->output);
+    }
 } // namespace nodes
 } // namespace ell
 
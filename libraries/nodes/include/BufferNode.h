@@ -19,6 +19,7 @@
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/TypeName.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,11 @@ namespace ell
 namespace nodes
 {
     /// <summary> A node that buffers the input and allows access to the buffer. </summary>
+    ///
+    /// The samples are kept in a ring buffer of the window size, so each new input is written once instead of shifting the
+    /// whole window. The output port is a contiguous array that downstream nodes read directly, so each step unwraps the
+    /// ring into it with two copies (from the oldest sample to the end of the ring, then from its start), and its cost is
+    /// still proportional to the window size.
     template <typename ValueType>
     class BufferNode : public model::CompilableNode
     {
@@ -55,6 +61,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the sample buffer
+
         /// <summary> Return the window size </summary>
         ///
         /// <returns> The window size </returns>
@@ -77,7 +86,8 @@ namespace nodes
         model::OutputPort<ValueType> _output;
 
         // Buffer
-        mutable std::vector<ValueType> _samples;
+        mutable std::vector<ValueType> _samples; // ring buffer of size windowSize
+        mutable size_t _head = 0; // index of the oldest sample in the window
         size_t _windowSize;
     };
 } // namespace nodes
@@ -111,23 +121,19 @@ namespace nodes
     template <typename ValueType>
     void BufferNode<ValueType>::Compute() const
     {
-        auto inputSize = input.Size();
-        if (inputSize > _samples.size())
-        {
-            inputSize = _samples.size();
-        }
-        auto offset = _samples.size() - inputSize;
-        if (offset > 0)
-        {
-            // Copy samples forward to make room for new samples
-            std::copy_n(_samples.begin() + offset, inputSize, _samples.begin());
-        }
-        // Copy input samples to tail
+        auto inputSize = std::min(input.Size(), _windowSize);
+
+        // Overwrite the oldest samples, wrapping around at the end of the ring buffer
         for (size_t index = 0; index < inputSize; ++index)
         {
-            _samples[index + offset] = _input[index];
+            _samples[(_head + index) % _windowSize] = _input[index];
         }
-        _output.SetOutput(_samples);
+        _head = _windowSize == 0 ? 0 : (_head + inputSize) % _windowSize;
+
+        // The window starts at the new head and wraps around
+        std::vector<ValueType> window(_samples.begin() + _head, _samples.end());
+        window.insert(window.end(), _samples.begin(), _samples.begin() + _head);
+        _output.SetOutput(window);
     };
 
     template <typename ValueType>
@@ -141,24 +147,36 @@ namespace nodes
     template <typename ValueType>
     void BufferNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        int inputSize = input.Size();
-        size_t windowSize = this->GetWindowSize();
-        auto offset = windowSize - inputSize;
+        const int windowSize = static_cast<int>(this->GetWindowSize());
+        const int inputSize = std::min(static_cast<int>(input.Size()), windowSize);
+        if (windowSize == 0)
+        {
+            return;
+        }
+        auto& module = function.GetModule();
 
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
-        auto bufferVar = function.GetModule().Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
-        function.GetModule().AllocateVariable(*bufferVar);
-        emitters::LLVMValue buffer = function.GetModule().EnsureEmitted(*bufferVar);
-
-        // Copy samples forward to make room for new samples
-        function.MemoryMove<ValueType>(buffer, offset, 0, inputSize);
-
-        // Copy input samples to tail
-        function.MemoryCopy<ValueType>(pInput, 0, buffer, offset, inputSize);
-
-        // Copy to output
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
-        function.MemoryCopy<ValueType>(buffer, 0, pOutput, 0, windowSize);
+        auto bufferVar = module.Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
+        module.AllocateVariable(*bufferVar);
+        emitters::LLVMValue buffer = module.EnsureEmitted(*bufferVar);
+        emitters::LLVMValue pHead = module.EnsureEmitted(*module.Variables().AddVariable<emitters::InitializedScalarVariable<int>>(emitters::VariableScope::global, 0));
+
+        // Overwrite the oldest samples: first up to the end of the ring buffer, then the rest from its start
+        auto head = function.LocalScalar(function.Load(pHead));
+        auto firstCount = emitters::Min(function.LocalScalar(windowSize) - head, inputSize);
+        auto secondCount = inputSize - firstCount;
+        auto zero = function.LocalScalar(0);
+        function.MemoryCopy<ValueType>(pInput, zero, buffer, head, firstCount);
+        function.MemoryCopy<ValueType>(pInput, firstCount, buffer, zero, secondCount);
+
+        auto newHead = (head + inputSize) % windowSize;
+        function.Store(pHead, newHead);
+
+        // Unwrap the window, which starts at the new head, into the output: the samples up to the end of the ring buffer, then those before the head
+        auto tailCount = function.LocalScalar(windowSize) - newHead;
+        function.MemoryCopy<ValueType>(buffer, newHead, pOutput, zero, tailCount);
+        function.MemoryCopy<ValueType>(buffer, zero, pOutput, tailCount, newHead);
     }
 
     template <typename ValueType>
@@ -176,7 +194,8 @@ namespace nodes
         archiver[defaultInputPortName] >> _input;
         archiver["windowSize"] >> _windowSize;
 
-        _samples.resize(_windowSize);
+        _samples.assign(_windowSize, ValueType{});
+        _head = 0;
         _output.SetSize(_windowSize);
     }
 } // namespace nodes
@@ -51,6 +51,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the last interval time
+
         /// <summary> Sets the interval for this node. </summary>
         ///
         /// <param name="interval"> The interval to set. </param>
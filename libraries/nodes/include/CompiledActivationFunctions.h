@@ -20,6 +20,7 @@
 #include <predictors/neural/include/SigmoidActivation.h>
 #include <predictors/neural/include/TanhActivation.h>
 
+#include <utilities/include/Archiver.h>
 #include <utilities/include/TypeName.h>
 
 namespace ell
@@ -32,6 +33,16 @@ namespace nodes
     template <typename ValueType>
     class ActivationFunction : public BroadcastUnaryFunction<ValueType>
     {
+    public:
+        /// <summary> Writes the parameters of the activation function, if it has any, to an archive. </summary>
+        ///
+        /// <param name="archiver"> The archiver. </param>
+        virtual void WriteToArchive(utilities::Archiver& archiver) const {}
+
+        /// <summary> Reads the parameters of the activation function, if it has any, from an archive. </summary>
+        ///
+        /// <param name="archiver"> The unarchiver. </param>
+        virtual void ReadFromArchive(utilities::Unarchiver& archiver) {}
     };
 
     template <typename ValueType>
@@ -98,6 +109,16 @@ namespace nodes
         /// <returns> The leaky factor </returns>
         ValueType GetLeakyFactor() const { return _leakyFactor; }
 
+        /// <summary> Writes the leaky factor to an archive. </summary>
+        ///
+        /// <param name="archiver"> The archiver. </param>
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+
+        /// <summary> Reads the leaky factor from an archive. </summary>
+        ///
+        /// <param name="archiver"> The unarchiver. </param>
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompiledForest.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/LLVMUtilities.h>
+
+#include <predictors/include/ForestPredictor.h>
+
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> The port variables a compiled forest reads and writes. </summary>
+    struct CompiledForestPorts
+    {
+        /// <summary> The input vector (of doubles). </summary>
+        emitters::LLVMValue input = nullptr;
+
+        /// <summary> The forest output: the sum of the tree outputs and the bias. </summary>
+        emitters::LLVMValue output = nullptr;
+
+        /// <summary> The output of each tree. </summary>
+        emitters::LLVMValue treeOutputs = nullptr;
+
+        /// <summary> The edge indicator vector. If null, the edge indicators aren't computed. </summary>
+        emitters::LLVMValue edgeIndicatorVector = nullptr;
+    };
+
+    /// <summary>
+    /// Emits code that evaluates a forest by walking one root-to-leaf path per tree. The forest is stored
+    /// as constant arrays (struct-of-arrays): the split feature, threshold and first outgoing edge of each
+    /// interior node, and the target node and value of each edge.
+    /// </summary>
+    ///
+    /// <param name="forest"> The forest to compile. </param>
+    /// <param name="namePrefix"> A prefix that makes the names of the emitted constant arrays unique. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="ports"> The port variables to read from and write to. </param>
+    void CompileForestTraversal(const predictors::SimpleForestPredictor& forest, const std::string& namePrefix, emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports);
+
+    /// <summary> Indicates if a forest can be compiled with `CompileForestBitvector`: every split must be binary, and no tree may have more than 64 leaves. </summary>
+    ///
+    /// <param name="forest"> The forest to check. </param>
+    bool CanCompileForestBitvector(const predictors::SimpleForestPredictor& forest);
+
+    /// <summary>
+    /// Emits code that evaluates a forest with the QuickScorer algorithm: each tree keeps a 64-bit mask of
+    /// the leaves that can still be reached, and the split conditions are visited feature by feature, in
+    /// order of increasing threshold, clearing the leaves cut off by each split that goes right. The exit leaf
+    /// of each tree is the lowest bit remaining in its mask. Only the splits that go right are visited,
+    /// and there is no branching on the structure of the trees.
+    /// </summary>
+    ///
+    /// <param name="forest"> The forest to compile. `CanCompileForestBitvector(forest)` must be true. </param>
+    /// <param name="namePrefix"> A prefix that makes the names of the emitted constant arrays unique. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="ports"> The port variables to read from and write to. </param>
+    void CompileForestBitvector(const predictors::SimpleForestPredictor& forest, const std::string& namePrefix, emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports);
+} // namespace nodes
+} // namespace ell
@@ -59,6 +59,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the distance table and current time
+
         /// <summary></summary>
         std::vector<std::vector<ValueType>> GetPrototype() const { return _prototype; }
 
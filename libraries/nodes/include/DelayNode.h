@@ -29,6 +29,8 @@ namespace ell
 namespace nodes
 {
     /// <summary> A node that returns a delayed sample of the input. </summary>
+    ///
+    /// The delay line is a ring buffer: each step reads and replaces the oldest sample in place, rather than shifting the whole line.
     template <typename ValueType>
     class DelayNode : public model::CompilableNode
     {
@@ -58,6 +60,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the sample history
+
         /// <summary>Return the window size</summary>
         size_t GetWindowSize() const { return _windowSize; }
 
@@ -79,6 +84,7 @@ namespace nodes
 
         // Buffer
         mutable std::vector<std::vector<ValueType>> _samples;
+        mutable size_t _head = 0; // index of the oldest sample
         size_t _windowSize;
     };
 } // namespace nodes
@@ -116,10 +122,16 @@ namespace nodes
     template <typename ValueType>
     void DelayNode<ValueType>::Compute() const
     {
-        auto lastBufferedSample = _samples[0];
-        _samples.push_back(_input.GetValue());
-        _samples.erase(_samples.begin());
-        _output.SetOutput(lastBufferedSample);
+        if (_samples.empty())
+        {
+            _output.SetOutput(_input.GetValue());
+            return;
+        }
+
+        auto& oldestSample = _samples[_head];
+        _output.SetOutput(oldestSample);
+        oldestSample = _input.GetValue();
+        _head = (_head + 1) % _samples.size();
     };
 
     template <typename ValueType>
@@ -138,20 +150,31 @@ namespace nodes
         size_t sampleSize = output.Size();
         size_t windowSize = this->GetWindowSize();
         size_t bufferSize = sampleSize * windowSize;
+        emitters::LLVMValue inputBuffer = compiler.EnsurePortEmitted(input);
+        if (windowSize == 0)
+        {
+            function.MemoryCopy<ValueType>(inputBuffer, result, static_cast<int>(sampleSize));
+            return;
+        }
 
         //
         // Delay nodes are always long lived - either globals or heap. Currently, we use globals
         // Each sample chunk is of size == sampleSize. The number of chunks we hold onto == windowSize
-        // We need two buffers - one for the entire lot, one for the "last" chunk forwarded to the next operator
-        //
-        emitters::Variable* delayLineVar = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, bufferSize);
-        emitters::LLVMValue delayLine = function.GetModule().EnsureEmitted(*delayLineVar);
-
+        // The delay line is a ring buffer of chunks, with a global index of the oldest chunk
         //
-        // We implement a delay as a Shift Register
-        //
-        emitters::LLVMValue inputBuffer = compiler.EnsurePortEmitted(input);
-        function.ShiftAndUpdate<ValueType>(delayLine, bufferSize, sampleSize, inputBuffer, result);
+        auto& module = function.GetModule();
+        emitters::Variable* delayLineVar = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, bufferSize);
+        emitters::LLVMValue delayLine = module.EnsureEmitted(*delayLineVar);
+        emitters::LLVMValue pHead = module.EnsureEmitted(*module.Variables().AddVariable<emitters::InitializedScalarVariable<int>>(emitters::VariableScope::global, 0));
+
+        // Forward the oldest chunk, replace it with the input, and advance the index
+        auto head = function.LocalScalar(function.Load(pHead));
+        auto offset = head * static_cast<int>(sampleSize);
+        auto zero = function.LocalScalar(0);
+        auto count = function.LocalScalar(static_cast<int>(sampleSize));
+        function.MemoryCopy<ValueType>(delayLine, offset, result, zero, count);
+        function.MemoryCopy<ValueType>(inputBuffer, zero, delayLine, offset, count);
+        function.Store(pHead, (head + 1) % static_cast<int>(windowSize));
     }
 
     template <typename ValueType>
@@ -176,6 +199,7 @@ namespace nodes
         {
             _samples.push_back(std::vector<ValueType>(dimension));
         }
+        _head = 0;
         _output.SetSize(dimension);
     }
 } // namespace nodes
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "BinaryOperationNode.h"
+#include "CompiledForest.h"
 #include "ConstantNode.h"
 #include "DemultiplexerNode.h"
 #include "ForestPredictorNode.h"
@@ -16,6 +17,9 @@
 #include "SingleElementThresholdNode.h"
 #include "SumNode.h"
 
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/MapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
@@ -25,18 +29,23 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
 {
 namespace nodes
 {
-    /// <summary> Implements a forest node, which wraps the forest predictor. </summary>
+    /// <summary>
+    /// Implements a forest node, which wraps the forest predictor. By default the node is refined into a graph of
+    /// split, multiplexer and sum nodes. Forests with threshold splits and constant edge predictors can instead be
+    /// compiled directly, as selected by `MapCompilerOptions::forestMethod`.
+    /// </summary>
     ///
     /// <typeparam name="SplitRuleType"> The split rule type. </typeparam>
     /// <typeparam name="EdgePredictorType"> The edge predictor type. </typeparam>
     template <typename SplitRuleType, typename EdgePredictorType>
-    class ForestPredictorNode : public model::Node
+    class ForestPredictorNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -73,14 +82,20 @@ namespace nodes
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Indicates if this node is able to compile itself to code. </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override;
+
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
 
+        static constexpr bool IsSimpleForest = std::is_same<SplitRuleType, predictors::SingleElementThresholdPredictor>::value && std::is_same<EdgePredictorType, predictors::ConstantPredictor>::value;
+
         // Input
         model::InputPort<double> _input;
 
@@ -106,7 +121,7 @@ namespace nodes
 {
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode(const model::OutputPort<double>& input, const predictors::ForestPredictor<SplitRuleType, EdgePredictorType>& forest) :
-        Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
         _treeOutputs(this, treeOutputsPortName, forest.NumTrees()),
@@ -117,7 +132,7 @@ namespace nodes
 
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode() :
-        Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
         _treeOutputs(this, treeOutputsPortName, 0),
@@ -128,7 +143,7 @@ namespace nodes
     template <typename SplitRuleType, typename EdgePredictorType>
     void ForestPredictorNode<SplitRuleType, EdgePredictorType>::WriteToArchive(utilities::Archiver& archiver) const
     {
-        Node::WriteToArchive(archiver);
+        model::CompilableNode::WriteToArchive(archiver);
         archiver[defaultInputPortName] << _input;
         archiver["forest"] << _forest;
     }
@@ -136,7 +151,7 @@ namespace nodes
     template <typename SplitRuleType, typename EdgePredictorType>
     void ForestPredictorNode<SplitRuleType, EdgePredictorType>::ReadFromArchive(utilities::Unarchiver& archiver)
     {
-        Node::ReadFromArchive(archiver);
+        model::CompilableNode::ReadFromArchive(archiver);
         archiver[defaultInputPortName] >> _input;
         archiver["forest"] >> _forest;
 
@@ -258,6 +273,45 @@ namespace nodes
         return true;
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType>
+    bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::IsCompilable(const model::MapCompiler* compiler) const
+    {
+        return IsSimpleForest && compiler != nullptr && compiler->GetMapCompilerOptions().forestMethod != model::ForestCompilationMethod::refine;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if constexpr (IsSimpleForest)
+        {
+            CompiledForestPorts ports;
+            ports.input = compiler.EnsurePortEmitted(input);
+            ports.output = compiler.EnsurePortEmitted(output);
+            ports.treeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+
+            // Only fill in the edge indicator vector if something reads it
+            auto pEdgeIndicatorVector = compiler.EnsurePortEmitted(edgeIndicatorVector);
+            if (edgeIndicatorVector.IsReferenced())
+            {
+                ports.edgeIndicatorVector = pEdgeIndicatorVector;
+            }
+
+            auto namePrefix = "forest_" + GetInternalStateIdentifier();
+            if (compiler.GetMapCompilerOptions().forestMethod == model::ForestCompilationMethod::bitvector && CanCompileForestBitvector(_forest))
+            {
+                CompileForestBitvector(_forest, namePrefix, function, ports);
+            }
+            else
+            {
+                CompileForestTraversal(_forest, namePrefix, function, ports);
+            }
+        }
+        else
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Only forests with threshold splits and constant edge predictors can be compiled directly");
+        }
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compute() const
     {
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedElementwiseNode.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> The kinds of operation in the chain computed by a FusedElementwiseNode. </summary>
+    enum class ElementwiseStageType
+    {
+        unaryOperation,
+        binaryOperation,
+        linearFunction
+    };
+
+    /// <summary> One operation in the chain computed by a FusedElementwiseNode, applied to the value computed by the operations before it. </summary>
+    struct ElementwiseStage
+    {
+        ElementwiseStageType type = ElementwiseStageType::unaryOperation;
+        emitters::UnaryOperationType unaryOperation = emitters::UnaryOperationType::none;
+        emitters::BinaryOperationType binaryOperation = emitters::BinaryOperationType::none;
+        bool isRightOperand = false; // for a binary operation, true if the chain's value is its right-hand operand
+        int secondaryInput1 = -1; // the index of a binary operation's other operand, or of a linear function's scale (-1 if it has none)
+        int secondaryInput2 = -1; // the index of a linear function's bias (-1 if it has none)
+    };
+
+    /// <summary>
+    /// A node that computes a chain of elementwise operations (unary and binary operations and broadcast linear functions)
+    /// in a single loop, and converts the result to the output type. It replaces a chain of nodes that each read and write
+    /// a whole tensor, so the intermediate values stay in registers. The inputs must all have the same memory layout, without
+    /// padding. The operands of binary operations are secondary inputs of the same size as the input, and the scales and
+    /// biases of linear functions are secondary inputs with one entry per index of the broadcast dimension.
+    /// </summary>
+    template <typename ValueType, typename OutputValueType = ValueType>
+    class FusedElementwiseNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<OutputValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FusedElementwiseNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The input to the first operation of the chain. </param>
+        /// <param name="secondaryInputs"> The other operands of the operations. </param>
+        /// <param name="stages"> The operations, in the order they're applied. </param>
+        /// <param name="broadcastSize"> The number of indices of the dimension linear function coefficients are broadcast along. </param>
+        /// <param name="broadcastStride"> The distance in memory between consecutive indices of the broadcast dimension. </param>
+        /// <param name="outputLayout"> The layout of the output. </param>
+        FusedElementwiseNode(const model::OutputPort<ValueType>& input,
+                             const std::vector<const model::OutputPort<ValueType>*>& secondaryInputs,
+                             std::vector<ElementwiseStage> stages,
+                             int broadcastSize,
+                             int broadcastStride,
+                             const model::PortMemoryLayout& outputLayout);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, OutputValueType>("FusedElementwiseNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Gets the operations, in the order they're applied. </summary>
+        const std::vector<ElementwiseStage>& GetStages() const { return _stages; }
+
+        /// <summary> Gets the number of secondary inputs. </summary>
+        size_t NumSecondaryInputs() const { return _secondaryInputs.size(); }
+
+        /// <summary> Gets a secondary input. </summary>
+        ///
+        /// <param name="index"> The index of the secondary input. </param>
+        const model::InputPort<ValueType>& GetSecondaryInput(size_t index) const { return *_secondaryInputs[index]; }
+
+        /// <summary> Gets the number of indices of the dimension linear function coefficients are broadcast along. </summary>
+        int GetBroadcastSize() const { return _broadcastSize; }
+
+        /// <summary> Gets the distance in memory between consecutive indices of the broadcast dimension. </summary>
+        int GetBroadcastStride() const { return _broadcastStride; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        }
+
+        void ReadFromArchive(utilities::Unarchiver& archiver) override
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        }
+        bool HasState() const override { return true; } // stored state: operations, broadcast size and stride
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        bool IsCoefficientInput(int index) const;
+        emitters::LLVMValue EmitStages(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar value, const std::vector<emitters::IRLocalScalar>& secondaryValues) const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+        std::vector<std::unique_ptr<model::InputPort<ValueType>>> _secondaryInputs;
+
+        // Output
+        model::OutputPort<OutputValueType> _output;
+
+        std::vector<ElementwiseStage> _stages;
+        int _broadcastSize = 1;
+        int _broadcastStride = 1;
+    };
+} // namespace nodes
+} // namespace ell
@@ -63,9 +63,19 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the number of rows in the matrix (and entries in the output). </summary>
+        size_t NumRows() const { return _m; }
+
+        /// <summary> Gets the number of columns in the matrix (and entries in the input vector). </summary>
+        size_t NumColumns() const { return _n; }
+
+        /// <summary> Gets the distance between the starts of consecutive rows of the matrix. </summary>
+        size_t GetMatrixStride() const { return _lda; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        bool CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // stored state: m, n, lda, incx
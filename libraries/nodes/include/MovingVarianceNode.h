@@ -52,6 +52,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the sample window and running sums
+
     protected:
         void Compute() const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <model/include/CompilableNode.h>
+#include <model/include/ExecutionContext.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
@@ -302,12 +303,26 @@ namespace nodes
     template <typename DerivedType, typename LayerType, typename ValueType>
     void NeuralNetworkLayerNode<DerivedType, LayerType, ValueType>::Compute() const
     {
-        auto inputVector = _input.GetValue();
-        auto inputTensor = typename LayerType::ConstTensorReferenceType{ inputVector.data(), _inputTensor.GetShape() };
-        _inputTensor.CopyFrom(inputTensor);
-        _layer.Compute();
-        const auto& outputTensor = _layer.GetOutput();
-        _output.SetOutput(outputTensor.ToArray());
+        // The layer holds its input reference, output tensor and scratch space, so each execution context computes with its own
+        // copy of it (weights included), made the first time the context computes this node
+        auto context = model::ExecutionContext::GetCurrent();
+        auto& layer = context == nullptr ? _layer : context->GetNodeState<LayerType>(*this, [this] { return _layer; });
+
+        // Have the layer read its input in place from the output of the node before it, rather than copying it into `_inputTensor`
+        const auto& inputValues = _input.GetReferencedPort().GetOutput();
+        if (inputValues.size() != _inputTensor.Size())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState);
+        }
+        layer.GetLayerParameters().input = typename LayerType::ConstTensorReferenceType{ inputValues.data(), _inputTensor.GetShape() };
+        layer.Compute();
+
+        // Point the layer back at its own tensor, so it never refers to another node's storage outside of `Compute`
+        layer.GetLayerParameters().input = _inputTensor;
+
+        // The layer's output tensor is contiguous, so copy it straight into the port's existing buffer
+        const auto& outputTensor = layer.GetOutput();
+        _output.SetOutput(outputTensor.GetConstDataPointer(), outputTensor.GetConstDataPointer() + outputTensor.Size());
     }
 
     template <typename LayerType>
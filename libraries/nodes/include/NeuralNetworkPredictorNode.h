@@ -87,6 +87,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute uses the predictor's layer buffers
+
         /// <summary> Options to control how the network is compiled into nodes </summary>
         struct NetworkCompileOptions
         {
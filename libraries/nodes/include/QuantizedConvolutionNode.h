@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "QuantizedOperations.h"
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A node that convolves its input with constant int8 filters, quantizing the input to int8 and accumulating in int32.
+    /// The input is in row-major order and includes its padding, and the filters are applied at every position of the
+    /// padded input where they fit, as `SimpleConvolutionNode` does. Filter `f` represents the real values
+    /// `weights[f, i] * weightScales[f]`, and an input `x` is quantized to `round(x / inputScale)`, clamped to [-127, 127].
+    /// The output is in row-major order without padding. </summary>
+    template <typename ValueType>
+    class QuantizedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data, in row-major order. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data, in row-major order without padding. </param>
+        /// <param name="filterSize"> The filter width. </param>
+        /// <param name="stride"> The output stride. </param>
+        /// <param name="weights"> The quantized filters, one per row, each in (row, column, channel) order. </param>
+        /// <param name="weightScales"> The real value of one quantization step in each filter. </param>
+        /// <param name="inputScale"> The real value of one quantization step of the input. </param>
+        QuantizedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                 const model::PortMemoryLayout& inputMemoryLayout,
+                                 const model::PortMemoryLayout& outputMemoryLayout,
+                                 int filterSize,
+                                 int stride,
+                                 std::vector<int8_t> weights,
+                                 std::vector<ValueType> weightScales,
+                                 ValueType inputScale);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
+        ///
+        /// <param name="order"> The memory layout order for all the input ports </summary>
+        /// <returns> If the node can accept the input memory layout order, true, else false </returns>
+        bool CanAcceptInputLayout(const utilities::DimensionOrder& order) const override
+        {
+            return GetInputMemoryLayout().GetLogicalDimensionOrder() == order;
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Gets the quantized filters, one per row, each in (row, column, channel) order. </summary>
+        const std::vector<int8_t>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the real value of one quantization step in each filter. </summary>
+        const std::vector<ValueType>& GetWeightScales() const { return _weightScales; }
+
+        /// <summary> Gets the real value of one quantization step of the input. </summary>
+        ValueType GetInputScale() const { return _inputScale; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, scales, convolutional parameters and memory layout
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Validate() const;
+        int GetNumFilters() const;
+        int GetFilterVolume() const;
+        std::vector<ValueType> GetOutputScales() const;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+        int _filterSize = 0;
+        int _stride = 1;
+        std::vector<int8_t> _weights;
+        std::vector<ValueType> _weightScales;
+        ValueType _inputScale = 1;
+    };
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixVectorMultiplyNode.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "QuantizedOperations.h"
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A node that multiplies a constant int8 matrix with a vector, quantizing the vector to int8 and accumulating in int32.
+    /// Row `i` of the matrix represents the real values `weights[i, j] * weightScales[i]`, and an input `x` is quantized to
+    /// `round(x / inputScale)`, clamped to [-127, 127]. The output is the accumulated product scaled back to real values. </summary>
+    template <typename ValueType>
+    class QuantizedMatrixVectorMultiplyNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedMatrixVectorMultiplyNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The vector to multiply. </param>
+        /// <param name="m"> The number of rows in the matrix. </param>
+        /// <param name="n"> The number of columns in the matrix. </param>
+        /// <param name="weights"> The quantized matrix, in row-major order. </param>
+        /// <param name="weightScales"> The real value of one quantization step in each row of the matrix. </param>
+        /// <param name="inputScale"> The real value of one quantization step of the input. </param>
+        QuantizedMatrixVectorMultiplyNode(const model::OutputPort<ValueType>& input, size_t m, size_t n, std::vector<int8_t> weights, std::vector<ValueType> weightScales, ValueType inputScale);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedMatrixVectorMultiplyNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Gets the number of rows in the matrix (and entries in the output). </summary>
+        size_t NumRows() const { return _m; }
+
+        /// <summary> Gets the number of columns in the matrix (and entries in the input vector). </summary>
+        size_t NumColumns() const { return _n; }
+
+        /// <summary> Gets the quantized matrix, in row-major order. </summary>
+        const std::vector<int8_t>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the real value of one quantization step in each row of the matrix. </summary>
+        const std::vector<ValueType>& GetWeightScales() const { return _weightScales; }
+
+        /// <summary> Gets the real value of one quantization step of the input. </summary>
+        ValueType GetInputScale() const { return _inputScale; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, scales, m, n
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        std::vector<ValueType> GetOutputScales() const;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        // Matrix is MxN, vector is of length N
+        size_t _m = 0;
+        size_t _n = 0;
+        std::vector<int8_t> _weights;
+        std::vector<ValueType> _weightScales;
+        ValueType _inputScale = 1;
+    };
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedOperations.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    //
+    // Helpers shared by the int8 quantized nodes. A real value `x` is quantized with a scale `s` to `round(x / s)`,
+    // clamped to [-maxQuantizedValue, maxQuantizedValue], so that the value 0 is exact and the range is symmetric.
+    //
+
+    /// <summary> The largest magnitude of a quantized value. </summary>
+    constexpr int maxQuantizedValue = 127;
+
+    /// <summary> Quantizes a value, rounding half up, the way `EmitQuantizeValue` does. </summary>
+    ///
+    /// <param name="x"> The value to quantize. </param>
+    /// <param name="inverseScale"> The reciprocal of the real value of one quantization step. </param>
+    ///
+    /// <returns> The quantized value. </returns>
+    template <typename ValueType>
+    int QuantizeValue(ValueType x, ValueType inverseScale);
+
+    /// <summary> Emits code to quantize a value, rounding half up. </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The value to quantize. </param>
+    /// <param name="inverseScale"> The reciprocal of the real value of one quantization step. </param>
+    ///
+    /// <returns> The quantized value, as an int8. </returns>
+    template <typename ValueType>
+    emitters::LLVMValue EmitQuantizeValue(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar x, ValueType inverseScale);
+
+    /// <summary>
+    /// Returns the number of int8 products `EmitInt8DotProduct` accumulates at a time: as many as there are int32
+    /// accumulators in a vector register, or 1 if vector instructions aren't allowed.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    ///
+    /// <returns> The vector size, which is 1 or a power of 2. </returns>
+    int GetInt8DotProductVectorSize(emitters::IRFunctionEmitter& function);
+
+    /// <summary> Rounds a size up to a multiple of a vector size. </summary>
+    inline int GetPaddedSize(int size, int vectorSize) { return ((size + vectorSize - 1) / vectorSize) * vectorSize; }
+
+    /// <summary> Copies a row-major int8 matrix into one whose rows are padded with zeros to a larger size. </summary>
+    ///
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="numRows"> The number of rows in the matrix. </param>
+    /// <param name="numColumns"> The number of columns in the matrix. </param>
+    /// <param name="paddedNumColumns"> The number of columns, including the padding, in the result. </param>
+    ///
+    /// <returns> The padded matrix, in row-major order. </returns>
+    std::vector<int8_t> PadRows(const std::vector<int8_t>& matrix, size_t numRows, size_t numColumns, size_t paddedNumColumns);
+
+    /// <summary>
+    /// Emits the dot product of two int8 arrays, accumulated in int32. With a vector size greater than 1, each step loads
+    /// that many values from each array, widens them to int32 and accumulates their products in a vector, which is
+    /// summed at the end. The arrays don't have to be aligned.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="pLeft"> Pointer to the first array. </param>
+    /// <param name="pRight"> Pointer to the second array. </param>
+    /// <param name="size"> The number of values in each array, which must be a multiple of `vectorSize`. </param>
+    /// <param name="vectorSize"> The value returned by `GetInt8DotProductVectorSize`. </param>
+    ///
+    /// <returns> The dot product, as an int32. </returns>
+    emitters::LLVMValue EmitInt8DotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue pLeft, emitters::LLVMValue pRight, int size, int vectorSize);
+} // namespace nodes
+} // namespace ell
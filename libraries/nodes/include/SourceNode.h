@@ -83,6 +83,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if several threads can compute this node at once. </summary>
+        bool IsComputeReentrant() const override { return false; } // Compute updates the buffered sample
+
         /// <summary> Interpolates the buffered sample to match the new time. </summary>
         ///
         /// <param name="originalTime"> Original time for the buffered sample. </param>
@@ -143,10 +143,8 @@ namespace nodes
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
         emitters::LLVMValue pResult = compiler.EnsurePortEmitted(output);
 
-        function.For(count, [pInput, pResult](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
-            emitters::LLVMValue inputValue = function.ValueAt(pInput, i);
-            emitters::LLVMValue castElement = function.CastValue<OutputValueType>(inputValue);
-            function.SetValueAt(pResult, i, castElement);
+        function.ElementwiseFor(static_cast<int>(count), { pInput }, pResult, [](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> values) {
+            return function.CastValue<OutputValueType>(values[0]);
         });
     }
 
@@ -18,6 +18,7 @@
 #include <model/include/PortElements.h>
 
 #include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLocalScalar.h>
 
 #include <utilities/include/TypeName.h>
 
@@ -75,6 +76,7 @@ namespace nodes
         void Copy(model::ModelTransformer& transformer) const override;
 
         emitters::LLVMFunction GetOperator(emitters::IRFunctionEmitter& function) const;
+        emitters::LLVMValue EmitOperation(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar value) const;
         void CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
 
@@ -339,13 +341,47 @@ namespace nodes
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
         emitters::LLVMValue pResult = compiler.EnsurePortEmitted(output);
 
-        function.For(count, [pInput, pResult, this](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
-            emitters::LLVMValue inputValue = function.ValueAt(pInput, i);
-            emitters::LLVMValue pOpResult = function.Call(GetOperator(function), { inputValue });
-            function.SetValueAt(pResult, i, pOpResult);
+        if (GetOperation() == emitters::UnaryOperationType::logicalNot)
+        {
+            function.For(count, [pInput, pResult, this](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+                emitters::LLVMValue inputValue = function.ValueAt(pInput, i);
+                emitters::LLVMValue pOpResult = function.Call(GetOperator(function), { inputValue });
+                function.SetValueAt(pResult, i, pOpResult);
+            });
+            return;
+        }
+
+        function.ElementwiseFor(static_cast<int>(count), { pInput }, pResult, [this](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> values) {
+            return EmitOperation(function, values[0]);
         });
     }
 
+    template <typename ValueType>
+    emitters::LLVMValue UnaryOperationNode<ValueType>::EmitOperation(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar value) const
+    {
+        if (!value.value->getType()->isVectorTy())
+        {
+            return function.Call(GetOperator(function), { value });
+        }
+
+        // The runtime functions are scalar, so vectors use the math functions of IRLocalScalar, which accept them
+        switch (this->GetOperation())
+        {
+        case emitters::UnaryOperationType::sqrt:
+            return emitters::Sqrt(value);
+        case emitters::UnaryOperationType::exp:
+            return emitters::Exp(value);
+        case emitters::UnaryOperationType::log:
+            return emitters::Log(value);
+        case emitters::UnaryOperationType::square:
+            return value * value;
+        case emitters::UnaryOperationType::tanh:
+            return emitters::Tanh<ValueType>(value);
+        default:
+            throw emitters::EmitterException(emitters::EmitterError::unaryOperationNotSupported);
+        }
+    }
+
     template <typename ValueType>
     void UnaryOperationNode<ValueType>::CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
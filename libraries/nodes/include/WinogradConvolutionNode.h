@@ -111,6 +111,13 @@ namespace nodes
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         bool IsCompilable(const model::MapCompiler* compiler) const override { return false; }
 
+        /// <summary> Gets the filter order the node uses when none is specified. </summary>
+        ///
+        /// <param name="filterWeights"> The weights for the convolutional filters. </param>
+        ///
+        /// <returns> The order to process filter data in. </returns>
+        static FilterOrder GetDefaultFilterOrder(const ConstTensorReferenceType& filterWeights);
+
     protected:
         void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
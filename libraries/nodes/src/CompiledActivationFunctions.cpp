@@ -70,8 +70,8 @@ namespace nodes
         // y = clip (scale*x + bias) to [0,1]
         //   = scale * (clip x to [a, b]) + bias, where scale*a+bias = 0, scale*b+bias = 1; so, a = -bias/scale, b = (1-bias)/scale
         auto x = function.LocalScalar(xValue);
-        const auto zero = function.Literal(ValueType{ 0 });
-        const auto one = function.Literal(static_cast<ValueType>(1));
+        const auto zero = emitters::LiteralLike(x, ValueType{ 0 });
+        const auto one = emitters::LiteralLike(x, static_cast<ValueType>(1));
         constexpr auto scale = static_cast<ValueType>(0.2);
         constexpr auto bias = static_cast<ValueType>(0.5);
         constexpr auto lowBound = -bias / scale;
@@ -95,7 +95,7 @@ namespace nodes
     emitters::LLVMValue ReLUActivationFunction<ValueType>::Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue xValue) const
     {
         auto x = function.LocalScalar(xValue);
-        auto zero = function.LocalScalar<ValueType>(0);
+        auto zero = emitters::LiteralLike(x, ValueType{ 0 });
         auto result = function.Select(x >= zero, x, zero);
         return result;
     }
@@ -113,11 +113,23 @@ namespace nodes
     emitters::LLVMValue LeakyReLUActivationFunction<ValueType>::Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue xValue) const
     {
         auto x = function.LocalScalar(xValue);
-        auto zero = function.LocalScalar<ValueType>(0.0);
-        auto result = function.Select(x >= zero, x, x * function.LocalScalar(GetLeakyFactor()));
+        auto zero = emitters::LiteralLike(x, ValueType{ 0 });
+        auto result = function.Select(x >= zero, x, x * GetLeakyFactor());
         return result;
     }
 
+    template <typename ValueType>
+    void LeakyReLUActivationFunction<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["leakyFactor"] << _leakyFactor;
+    }
+
+    template <typename ValueType>
+    void LeakyReLUActivationFunction<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["leakyFactor"] >> _leakyFactor;
+    }
+
     //
     // Sigmoid activation function
     //
@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompiledForest.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompiledForest.h"
+
+#include <emitters/include/IRModuleEmitter.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        using InteriorNode = predictors::SimpleForestPredictor::InteriorNode;
+
+        const int maxBitvectorLeaves = 64;
+
+        // Sums the tree outputs into the forest output, and clears the edge indicator vector, before the trees are evaluated
+        emitters::LLVMValue BeginForest(const predictors::SimpleForestPredictor& forest, emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports)
+        {
+            auto sum = function.Variable(emitters::VariableType::Double, "forestSum");
+            function.Store(sum, function.Literal<double>(forest.GetBias()));
+            if (ports.edgeIndicatorVector != nullptr && forest.NumEdges() > 0)
+            {
+                function.MemorySet<bool>(ports.edgeIndicatorVector, 0, function.Literal<uint8_t>(0), static_cast<int>(forest.NumEdges()));
+            }
+            return sum;
+        }
+
+        void EndForest(emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports, emitters::LLVMValue sum)
+        {
+            function.SetValueAt(ports.output, 0, function.Load(sum));
+        }
+
+        // The leaves of a binary tree, numbered left to right (edge 0 before edge 1), and the range of leaves below edge 0 of each interior node
+        struct TreeLeaves
+        {
+            std::vector<double> values; // the sum of the edge values along the path to each leaf
+            std::vector<std::vector<int>> paths; // the edges along the path to each leaf
+        };
+
+        struct BitvectorSplit
+        {
+            int feature;
+            double threshold;
+            int tree;
+            int64_t mask;
+        };
+
+        void VisitTree(const std::vector<InteriorNode>& interiorNodes, size_t nodeIndex, int treeIndex, double pathValue, std::vector<int>& path, TreeLeaves& leaves, std::vector<BitvectorSplit>& splits)
+        {
+            const auto& node = interiorNodes[nodeIndex];
+            const auto& edges = node.GetOutgoingEdges();
+            uint64_t leftLeaves = 0;
+            for (size_t position = 0; position < edges.size(); ++position)
+            {
+                const auto& edge = edges[position];
+                auto value = pathValue + edge.GetPredictor().GetValue();
+                auto firstLeaf = leaves.values.size();
+
+                path.push_back(static_cast<int>(node.GetFirstEdgeIndex() + position));
+                if (edge.IsTargetInterior())
+                {
+                    VisitTree(interiorNodes, edge.GetTargetNodeIndex(), treeIndex, value, path, leaves, splits);
+                }
+                else
+                {
+                    leaves.values.push_back(value);
+                    leaves.paths.push_back(path);
+                }
+                path.pop_back();
+
+                if (position == 0)
+                {
+                    for (auto leaf = firstLeaf; leaf < leaves.values.size() && leaf < maxBitvectorLeaves; ++leaf)
+                    {
+                        leftLeaves |= uint64_t{ 1 } << leaf;
+                    }
+                }
+            }
+
+            // If the split goes right (to edge 1), none of the leaves below edge 0 can be reached
+            const auto& splitRule = node.GetSplitRule();
+            splits.push_back({ static_cast<int>(splitRule.GetElementIndex()), splitRule.GetThreshold(), treeIndex, static_cast<int64_t>(~leftLeaves) });
+        }
+
+        size_t CountLeaves(const std::vector<InteriorNode>& interiorNodes, size_t nodeIndex)
+        {
+            size_t count = 0;
+            for (const auto& edge : interiorNodes[nodeIndex].GetOutgoingEdges())
+            {
+                count += edge.IsTargetInterior() ? CountLeaves(interiorNodes, edge.GetTargetNodeIndex()) : 1;
+            }
+            return count;
+        }
+    } // namespace
+
+    void CompileForestTraversal(const predictors::SimpleForestPredictor& forest, const std::string& namePrefix, emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports)
+    {
+        auto& module = function.GetModule();
+        const auto& interiorNodes = forest.GetInteriorNodes();
+
+        // Encode the forest as a struct of arrays. A target of -1 means the edge leads to a leaf.
+        std::vector<int> features;
+        std::vector<double> thresholds;
+        std::vector<int> firstEdges;
+        std::vector<int> edgeTargets;
+        std::vector<double> edgeValues;
+        for (const auto& node : interiorNodes)
+        {
+            features.push_back(static_cast<int>(node.GetSplitRule().GetElementIndex()));
+            thresholds.push_back(node.GetSplitRule().GetThreshold());
+            firstEdges.push_back(static_cast<int>(node.GetFirstEdgeIndex()));
+            for (const auto& edge : node.GetOutgoingEdges())
+            {
+                edgeTargets.push_back(edge.IsTargetInterior() ? static_cast<int>(edge.GetTargetNodeIndex()) : -1);
+                edgeValues.push_back(edge.GetPredictor().GetValue());
+            }
+        }
+        std::vector<int> roots(forest.GetRootIndices().begin(), forest.GetRootIndices().end());
+
+        auto sum = BeginForest(forest, function, ports);
+        if (!roots.empty())
+        {
+            auto featuresVar = module.ConstantArray(namePrefix + "_features", features);
+            auto thresholdsVar = module.ConstantArray(namePrefix + "_thresholds", thresholds);
+            auto firstEdgesVar = module.ConstantArray(namePrefix + "_firstEdges", firstEdges);
+            auto edgeTargetsVar = module.ConstantArray(namePrefix + "_edgeTargets", edgeTargets);
+            auto edgeValuesVar = module.ConstantArray(namePrefix + "_edgeValues", edgeValues);
+            auto rootsVar = module.ConstantArray(namePrefix + "_roots", roots);
+            auto nodeVar = function.Variable(emitters::VariableType::Int32, "forestNode");
+            auto treeSumVar = function.Variable(emitters::VariableType::Double, "treeSum");
+
+            function.For(static_cast<int>(roots.size()), [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar treeIndex) {
+                function.Store(nodeVar, function.ValueAt(rootsVar, treeIndex));
+                function.StoreZero(treeSumVar);
+                function.While([nodeVar](emitters::IRFunctionEmitter& function) { return function.LocalScalar(function.Load(nodeVar)) >= 0; },
+                               [=](emitters::IRFunctionEmitter& function) {
+                                   auto node = function.LocalScalar(function.Load(nodeVar));
+                                   auto feature = function.LocalScalar(function.ValueAt(featuresVar, node));
+                                   auto value = function.LocalScalar(function.ValueAt(ports.input, feature));
+                                   auto threshold = function.LocalScalar(function.ValueAt(thresholdsVar, node));
+
+                                   // The split rule selects edge 1 if the feature value is greater than the threshold, and edge 0 otherwise
+                                   auto position = function.Select(value > threshold, function.Literal<int>(1), function.Literal<int>(0));
+                                   auto edge = function.LocalScalar(function.ValueAt(firstEdgesVar, node)) + position;
+
+                                   auto edgeValue = function.LocalScalar(function.ValueAt(edgeValuesVar, edge));
+                                   function.Store(treeSumVar, function.LocalScalar(function.Load(treeSumVar)) + edgeValue);
+                                   if (ports.edgeIndicatorVector != nullptr)
+                                   {
+                                       function.SetValueAt(ports.edgeIndicatorVector, edge, function.Literal(true));
+                                   }
+                                   function.Store(nodeVar, function.ValueAt(edgeTargetsVar, edge));
+                               });
+
+                auto treeSum = function.LocalScalar(function.Load(treeSumVar));
+                function.SetValueAt(ports.treeOutputs, treeIndex, treeSum);
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + treeSum);
+            });
+        }
+        EndForest(function, ports, sum);
+    }
+
+    bool CanCompileForestBitvector(const predictors::SimpleForestPredictor& forest)
+    {
+        const auto& interiorNodes = forest.GetInteriorNodes();
+        for (const auto& node : interiorNodes)
+        {
+            if (node.GetOutgoingEdges().size() != 2)
+            {
+                return false;
+            }
+        }
+
+        for (auto root : forest.GetRootIndices())
+        {
+            if (CountLeaves(interiorNodes, root) > maxBitvectorLeaves)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CompileForestBitvector(const predictors::SimpleForestPredictor& forest, const std::string& namePrefix, emitters::IRFunctionEmitter& function, const CompiledForestPorts& ports)
+    {
+        if (!CanCompileForestBitvector(forest))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Bitvector forest evaluation requires binary splits and at most 64 leaves per tree");
+        }
+
+        auto& module = function.GetModule();
+        const auto& interiorNodes = forest.GetInteriorNodes();
+        const auto& roots = forest.GetRootIndices();
+        const int numTrees = static_cast<int>(roots.size());
+
+        // Number the leaves of each tree, and compute the mask of every split
+        std::vector<BitvectorSplit> splits;
+        std::vector<int> leafOffsets;
+        std::vector<double> leafValues;
+        std::vector<int> pathOffsets;
+        std::vector<int> pathEdges;
+        for (int treeIndex = 0; treeIndex < numTrees; ++treeIndex)
+        {
+            TreeLeaves leaves;
+            std::vector<int> path;
+            VisitTree(interiorNodes, roots[treeIndex], treeIndex, 0.0, path, leaves, splits);
+
+            leafOffsets.push_back(static_cast<int>(leafValues.size()));
+            leafValues.insert(leafValues.end(), leaves.values.begin(), leaves.values.end());
+            for (const auto& leafPath : leaves.paths)
+            {
+                pathOffsets.push_back(static_cast<int>(pathEdges.size()));
+                pathEdges.insert(pathEdges.end(), leafPath.begin(), leafPath.end());
+            }
+        }
+        pathOffsets.push_back(static_cast<int>(pathEdges.size()));
+
+        // Group the splits by feature, in order of increasing threshold. Each group ends with a sentinel
+        // whose threshold no value exceeds, so the scan over a group needs no bounds check.
+        std::sort(splits.begin(), splits.end(), [](const BitvectorSplit& a, const BitvectorSplit& b) { return std::tie(a.feature, a.threshold) < std::tie(b.feature, b.threshold); });
+        std::vector<int> groupFeatures;
+        std::vector<int> groupOffsets;
+        std::vector<double> splitThresholds;
+        std::vector<int> splitTrees;
+        std::vector<int64_t> splitMasks;
+        for (size_t index = 0; index < splits.size(); ++index)
+        {
+            const auto& split = splits[index];
+            if (index == 0 || split.feature != splits[index - 1].feature)
+            {
+                groupFeatures.push_back(split.feature);
+                groupOffsets.push_back(static_cast<int>(splitThresholds.size()));
+            }
+            splitThresholds.push_back(split.threshold);
+            splitTrees.push_back(split.tree);
+            splitMasks.push_back(split.mask);
+            if (index + 1 == splits.size() || splits[index + 1].feature != split.feature)
+            {
+                splitThresholds.push_back(std::numeric_limits<double>::infinity());
+                splitTrees.push_back(0);
+                splitMasks.push_back(-1);
+            }
+        }
+
+        auto sum = BeginForest(forest, function, ports);
+        if (numTrees > 0)
+        {
+            auto groupFeaturesVar = module.ConstantArray(namePrefix + "_groupFeatures", groupFeatures);
+            auto groupOffsetsVar = module.ConstantArray(namePrefix + "_groupOffsets", groupOffsets);
+            auto thresholdsVar = module.ConstantArray(namePrefix + "_thresholds", splitThresholds);
+            auto treesVar = module.ConstantArray(namePrefix + "_splitTrees", splitTrees);
+            auto masksVar = module.ConstantArray(namePrefix + "_splitMasks", splitMasks);
+            auto leafOffsetsVar = module.ConstantArray(namePrefix + "_leafOffsets", leafOffsets);
+            auto leafValuesVar = module.ConstantArray(namePrefix + "_leafValues", leafValues);
+
+            // All leaves are reachable until a split says otherwise
+            auto treeMasks = function.Variable(emitters::VariableType::Int64, numTrees);
+            function.MemorySet<int64_t>(treeMasks, 0, function.Literal<uint8_t>(0xFF), numTrees);
+
+            auto splitIndexVar = function.Variable(emitters::VariableType::Int32, "splitIndex");
+            function.For(static_cast<int>(groupFeatures.size()), [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar group) {
+                auto value = function.LocalScalar(function.ValueAt(ports.input, function.ValueAt(groupFeaturesVar, group)));
+                function.Store(splitIndexVar, function.ValueAt(groupOffsetsVar, group));
+                function.While([=](emitters::IRFunctionEmitter& function) {
+                    auto splitIndex = function.LocalScalar(function.Load(splitIndexVar));
+                    return value > function.LocalScalar(function.ValueAt(thresholdsVar, splitIndex));
+                },
+                               [=](emitters::IRFunctionEmitter& function) {
+                                   auto splitIndex = function.LocalScalar(function.Load(splitIndexVar));
+                                   auto treeMask = function.PointerOffset(treeMasks, function.ValueAt(treesVar, splitIndex));
+                                   auto mask = function.LocalScalar(function.ValueAt(masksVar, splitIndex));
+                                   function.Store(treeMask, function.LocalScalar(function.Load(treeMask)) & mask);
+                                   function.Store(splitIndexVar, splitIndex + 1);
+                               });
+            });
+
+            auto cttz = module.GetIntrinsic(llvm::Intrinsic::cttz, { emitters::VariableType::Int64 });
+            emitters::LLVMValue pathOffsetsVar = nullptr;
+            emitters::LLVMValue pathEdgesVar = nullptr;
+            if (ports.edgeIndicatorVector != nullptr)
+            {
+                pathOffsetsVar = module.ConstantArray(namePrefix + "_pathOffsets", pathOffsets);
+                pathEdgesVar = module.ConstantArray(namePrefix + "_pathEdges", pathEdges);
+            }
+            function.For(numTrees, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar treeIndex) {
+                // The exit leaf is the leftmost leaf that's still reachable
+                auto treeMask = function.ValueAt(treeMasks, treeIndex);
+                auto leaf = function.LocalScalar(function.CastValue<int>(function.Call(cttz, { treeMask, function.FalseBit() })));
+                auto leafIndex = function.LocalScalar(function.ValueAt(leafOffsetsVar, treeIndex)) + leaf;
+                auto treeSum = function.LocalScalar(function.ValueAt(leafValuesVar, leafIndex));
+                function.SetValueAt(ports.treeOutputs, treeIndex, treeSum);
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + treeSum);
+
+                if (ports.edgeIndicatorVector != nullptr)
+                {
+                    auto pathBegin = function.ValueAt(pathOffsetsVar, leafIndex);
+                    auto pathEnd = function.ValueAt(pathOffsetsVar, leafIndex + 1);
+                    function.For(pathBegin, pathEnd, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar pathIndex) {
+                        function.SetValueAt(ports.edgeIndicatorVector, function.ValueAt(pathEdgesVar, pathIndex), function.Literal(true));
+                    });
+                }
+            });
+        }
+        EndForest(function, ports, sum);
+    }
+} // namespace nodes
+} // namespace ell
@@ -76,8 +76,17 @@ namespace nodes
         break;
         case ConvolutionMethod::winograd:
         {
-            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
-            convOutput = convNode->output;
+            if (convParams.winogradTileSize == 0)
+            {
+                auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
+                convOutput = convNode->output;
+            }
+            else
+            {
+                auto filterOrder = WinogradConvolutionNode<ValueType>::GetDefaultFilterOrder(weights);
+                auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride, static_cast<int>(convParams.winogradTileSize), filterOrder);
+                convOutput = convNode->output;
+            }
         }
         break;
         default:
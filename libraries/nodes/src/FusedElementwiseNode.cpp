@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedElementwiseNode.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FusedElementwiseNode.h"
+
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <cmath>
+#include <type_traits>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        template <typename ValueType>
+        ValueType ComputeUnaryOperation(emitters::UnaryOperationType operation, ValueType x)
+        {
+            switch (operation)
+            {
+            case emitters::UnaryOperationType::sqrt:
+                return std::sqrt(x);
+            case emitters::UnaryOperationType::exp:
+                return std::exp(x);
+            case emitters::UnaryOperationType::log:
+                return std::log(x);
+            case emitters::UnaryOperationType::square:
+                return x * x;
+            case emitters::UnaryOperationType::tanh:
+                return std::tanh(x);
+            default:
+                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Unsupported unary operation in fused elementwise node");
+            }
+        }
+
+        template <typename ValueType>
+        ValueType ComputeBinaryOperation(emitters::BinaryOperationType operation, ValueType a, ValueType b)
+        {
+            switch (operation)
+            {
+            case emitters::BinaryOperationType::add:
+                return a + b;
+            case emitters::BinaryOperationType::subtract:
+                return a - b;
+            case emitters::BinaryOperationType::coordinatewiseMultiply:
+                return a * b;
+            case emitters::BinaryOperationType::coordinatewiseDivide:
+                return a / b;
+            default:
+                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Unsupported binary operation in fused elementwise node");
+            }
+        }
+
+        template <typename ValueType>
+        emitters::IRLocalScalar EmitUnaryOperation(emitters::UnaryOperationType operation, emitters::IRLocalScalar x)
+        {
+            switch (operation)
+            {
+            case emitters::UnaryOperationType::sqrt:
+                return emitters::Sqrt(x);
+            case emitters::UnaryOperationType::exp:
+                return emitters::Exp(x);
+            case emitters::UnaryOperationType::log:
+                return emitters::Log(x);
+            case emitters::UnaryOperationType::square:
+                return x * x;
+            case emitters::UnaryOperationType::tanh:
+                return emitters::Tanh<ValueType>(x);
+            default:
+                throw emitters::EmitterException(emitters::EmitterError::unaryOperationNotSupported);
+            }
+        }
+
+        emitters::IRLocalScalar EmitBinaryOperation(emitters::BinaryOperationType operation, emitters::IRLocalScalar a, emitters::IRLocalScalar b)
+        {
+            switch (operation)
+            {
+            case emitters::BinaryOperationType::add:
+                return a + b;
+            case emitters::BinaryOperationType::subtract:
+                return a - b;
+            case emitters::BinaryOperationType::coordinatewiseMultiply:
+                return a * b;
+            case emitters::BinaryOperationType::coordinatewiseDivide:
+                return a / b;
+            default:
+                throw emitters::EmitterException(emitters::EmitterError::binaryOperationTypeNotSupported);
+            }
+        }
+    } // namespace
+
+    template <typename ValueType, typename OutputValueType>
+    FusedElementwiseNode<ValueType, OutputValueType>::FusedElementwiseNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    FusedElementwiseNode<ValueType, OutputValueType>::FusedElementwiseNode(const model::OutputPort<ValueType>& input,
+                                                                           const std::vector<const model::OutputPort<ValueType>*>& secondaryInputs,
+                                                                           std::vector<ElementwiseStage> stages,
+                                                                           int broadcastSize,
+                                                                           int broadcastStride,
+                                                                           const model::PortMemoryLayout& outputLayout) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputLayout),
+        _stages(std::move(stages)),
+        _broadcastSize(broadcastSize),
+        _broadcastStride(broadcastStride)
+    {
+        const auto size = _input.Size();
+        if (static_cast<size_t>(outputLayout.GetMemorySize()) != size)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input and output sizes must match");
+        }
+
+        if (_broadcastSize <= 0 || _broadcastStride <= 0 || size % (static_cast<size_t>(_broadcastSize) * _broadcastStride) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The broadcast dimension must evenly divide the input");
+        }
+
+        // Add 1 input port per secondary input
+        int index = 0;
+        for (auto secondaryInput : secondaryInputs)
+        {
+            auto portName = std::string("secondaryInput_") + std::to_string(index);
+            _secondaryInputs.emplace_back(std::make_unique<model::InputPort<ValueType>>(this, *secondaryInput, portName));
+            AddInputPort(_secondaryInputs.back().get());
+            ++index;
+        }
+
+        const int numSecondaryInputs = static_cast<int>(_secondaryInputs.size());
+        for (const auto& stage : _stages)
+        {
+            if (stage.secondaryInput1 >= numSecondaryInputs || stage.secondaryInput2 >= numSecondaryInputs || (stage.type == ElementwiseStageType::binaryOperation && stage.secondaryInput1 < 0))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Operation refers to a missing secondary input");
+            }
+        }
+
+        for (index = 0; index < numSecondaryInputs; ++index)
+        {
+            auto expectedSize = IsCoefficientInput(index) ? static_cast<size_t>(_broadcastSize) : size;
+            if (_secondaryInputs[index]->Size() != expectedSize)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Secondary input has the wrong size");
+            }
+        }
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    bool FusedElementwiseNode<ValueType, OutputValueType>::IsCoefficientInput(int index) const
+    {
+        for (const auto& stage : _stages)
+        {
+            if (stage.type == ElementwiseStageType::linearFunction && (stage.secondaryInput1 == index || stage.secondaryInput2 == index))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    void FusedElementwiseNode<ValueType, OutputValueType>::Compute() const
+    {
+        const auto size = _input.Size();
+        auto inputValues = _input.GetValue();
+        std::vector<std::vector<ValueType>> secondaryValues;
+        for (const auto& secondaryInput : _secondaryInputs)
+        {
+            secondaryValues.push_back(secondaryInput->GetValue());
+        }
+
+        std::vector<OutputValueType> outputValues(size);
+        for (size_t index = 0; index < size; ++index)
+        {
+            // the secondary inputs of binary operations are indexed like the input, and linear function coefficients by the broadcast dimension
+            const auto coefficientIndex = (index / _broadcastStride) % _broadcastSize;
+            auto value = inputValues[index];
+            for (const auto& stage : _stages)
+            {
+                switch (stage.type)
+                {
+                case ElementwiseStageType::unaryOperation:
+                    value = ComputeUnaryOperation(stage.unaryOperation, value);
+                    break;
+                case ElementwiseStageType::binaryOperation:
+                {
+                    auto operand = secondaryValues[stage.secondaryInput1][index];
+                    value = stage.isRightOperand ? ComputeBinaryOperation(stage.binaryOperation, operand, value) : ComputeBinaryOperation(stage.binaryOperation, value, operand);
+                    break;
+                }
+                case ElementwiseStageType::linearFunction:
+                    if (stage.secondaryInput1 >= 0)
+                    {
+                        value = secondaryValues[stage.secondaryInput1][coefficientIndex] * value;
+                    }
+                    if (stage.secondaryInput2 >= 0)
+                    {
+                        value = value + secondaryValues[stage.secondaryInput2][coefficientIndex];
+                    }
+                    break;
+                }
+            }
+            outputValues[index] = static_cast<OutputValueType>(value);
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    void FusedElementwiseNode<ValueType, OutputValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        std::vector<const model::OutputPort<ValueType>*> newSecondaryInputs;
+        for (const auto& secondaryInput : _secondaryInputs)
+        {
+            newSecondaryInputs.push_back(&transformer.GetCorrespondingInputs(*secondaryInput));
+        }
+        auto newNode = transformer.AddNode<FusedElementwiseNode<ValueType, OutputValueType>>(newInput, newSecondaryInputs, _stages, _broadcastSize, _broadcastStride, _output.GetMemoryLayout());
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    emitters::LLVMValue FusedElementwiseNode<ValueType, OutputValueType>::EmitStages(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar value, const std::vector<emitters::IRLocalScalar>& secondaryValues) const
+    {
+        for (const auto& stage : _stages)
+        {
+            switch (stage.type)
+            {
+            case ElementwiseStageType::unaryOperation:
+                value = EmitUnaryOperation<ValueType>(stage.unaryOperation, value);
+                break;
+            case ElementwiseStageType::binaryOperation:
+            {
+                const auto& operand = secondaryValues[stage.secondaryInput1];
+                value = stage.isRightOperand ? EmitBinaryOperation(stage.binaryOperation, operand, value) : EmitBinaryOperation(stage.binaryOperation, value, operand);
+                break;
+            }
+            case ElementwiseStageType::linearFunction:
+                if (stage.secondaryInput1 >= 0)
+                {
+                    value = secondaryValues[stage.secondaryInput1] * value;
+                }
+                if (stage.secondaryInput2 >= 0)
+                {
+                    value = value + secondaryValues[stage.secondaryInput2];
+                }
+                break;
+            }
+        }
+
+        if (std::is_same<ValueType, OutputValueType>::value)
+        {
+            return value;
+        }
+        return function.CastValue<OutputValueType>(value);
+    }
+
+    template <typename ValueType, typename OutputValueType>
+    void FusedElementwiseNode<ValueType, OutputValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // Only the input, the secondary inputs and the output are emitted as arrays; the values between the operations never leave registers
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        std::vector<emitters::LLVMValue> secondaryInputs;
+        std::vector<bool> isCoefficientInput;
+        bool hasCoefficients = false;
+        for (int index = 0; index < static_cast<int>(_secondaryInputs.size()); ++index)
+        {
+            secondaryInputs.push_back(compiler.EnsurePortEmitted(*_secondaryInputs[index]));
+            isCoefficientInput.push_back(IsCoefficientInput(index));
+            hasCoefficients = hasCoefficients || isCoefficientInput.back();
+        }
+
+        // Linear function coefficients are constant along rows of `broadcastStride` elements. If that's 1, a row is
+        // one index of the dimension before the broadcast dimension, and the coefficients are loaded along with the values.
+        const int size = static_cast<int>(_input.Size());
+        const bool coefficientsAreRows = _broadcastStride == 1;
+        const int rowSize = hasCoefficients ? (coefficientsAreRows ? _broadcastSize : _broadcastStride) : size;
+        const int numRows = size / rowSize;
+        const int broadcastSize = _broadcastSize;
+
+        auto emitRow = [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue rowOffset, std::vector<emitters::LLVMValue> broadcastValues) {
+            auto offset = [&function, rowOffset](emitters::LLVMValue pointer) { return rowOffset == nullptr ? pointer : function.PointerOffset(pointer, rowOffset); };
+            std::vector<emitters::LLVMValue> rowInputs = { offset(pInput) };
+            for (size_t index = 0; index < secondaryInputs.size(); ++index)
+            {
+                if (!isCoefficientInput[index])
+                {
+                    rowInputs.push_back(offset(secondaryInputs[index]));
+                }
+                else if (coefficientsAreRows)
+                {
+                    rowInputs.push_back(secondaryInputs[index]);
+                }
+            }
+
+            function.ElementwiseFor(rowSize, rowInputs, offset(pOutput), [=](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> values) {
+                std::vector<emitters::IRLocalScalar> secondaryValues;
+                size_t nextValueIndex = 1;
+                for (size_t index = 0; index < secondaryInputs.size(); ++index)
+                {
+                    if (!isCoefficientInput[index] || coefficientsAreRows)
+                    {
+                        secondaryValues.push_back(values[nextValueIndex++]);
+                    }
+                    else
+                    {
+                        secondaryValues.push_back(function.LocalScalar(emitters::BroadcastLike(function, broadcastValues[index], values[0])));
+                    }
+                }
+                return EmitStages(function, values[0], secondaryValues);
+            });
+        };
+
+        if (!hasCoefficients || (coefficientsAreRows && numRows == 1))
+        {
+            emitRow(function, nullptr, {});
+            return;
+        }
+
+        function.For(numRows, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar row) {
+            std::vector<emitters::LLVMValue> broadcastValues(secondaryInputs.size(), nullptr);
+            if (!coefficientsAreRows)
+            {
+                auto coefficientIndex = row % broadcastSize;
+                for (size_t index = 0; index < secondaryInputs.size(); ++index)
+                {
+                    if (isCoefficientInput[index])
+                    {
+                        broadcastValues[index] = function.ValueAt(secondaryInputs[index], coefficientIndex);
+                    }
+                }
+            }
+            emitRow(function, row * rowSize, broadcastValues);
+        });
+    }
+
+    // Explicitly instantiate versions
+    template class FusedElementwiseNode<float, float>;
+    template class FusedElementwiseNode<float, double>;
+    template class FusedElementwiseNode<double, float>;
+    template class FusedElementwiseNode<double, double>;
+} // namespace nodes
+} // namespace ell
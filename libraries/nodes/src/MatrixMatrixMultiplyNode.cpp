@@ -248,6 +248,48 @@ namespace nodes
         }
     }
 
+    template <typename ValueType>
+    bool MatrixMatrixMultiplyNode<ValueType>::CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        const bool isBatched1 = compiler.IsBatchedPort(input1);
+        const bool isBatched2 = compiler.IsBatchedPort(input2);
+        const int batchSize = compiler.GetBatchSize();
+        auto pInput1 = compiler.GetBatchPortBuffer(input1);
+        auto pInput2 = compiler.GetBatchPortBuffer(input2);
+        auto pOutput = compiler.GetBatchPortBuffer(output);
+        const auto stride1 = static_cast<int>(input1.GetReferencedPort().Size());
+        const auto stride2 = static_cast<int>(input2.GetReferencedPort().Size());
+        const auto outputStride = static_cast<int>(output.Size());
+
+        if (!isBatched1 && isBatched2 && _transposeOutput && !_transpose2 && outputStride == _n * _ldc)
+        {
+            // This is the product an unrolled convolution computes, with the weights on the left and each input's receptive
+            // field matrix (k x n) on the right. The (transposed) outputs of consecutive inputs are consecutive row blocks of
+            // (B_0 B_1 ...)' * A', so the receptive field matrices are gathered side by side into one k x (batchSize * n) matrix.
+            const int gatheredColumns = batchSize * _n;
+            auto pGathered = function.Malloc(emitters::GetPointerType(emitters::GetVariableType<ValueType>()), static_cast<int64_t>(_k) * gatheredColumns * sizeof(ValueType));
+            const int n = _n;
+            const int ldb = _ldb;
+            function.For(_k, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar row) {
+                function.For(batchSize, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index) {
+                    function.MemoryCopy<ValueType>(pInput2, index * stride2 + row * ldb, pGathered, row * gatheredColumns + index * n, function.Literal<int>(n));
+                });
+            });
+            function.CallGEMM<ValueType>(true, !_transpose1, gatheredColumns, _m, _k, pGathered, gatheredColumns, pInput1, _lda, pOutput, _ldc);
+            function.Free(pGathered);
+            return true;
+        }
+
+        if (isBatched1 && !isBatched2 && !_transposeOutput && !_transpose1 && stride1 == _m * _lda && outputStride == _m * _ldc)
+        {
+            // The left-hand matrices of consecutive inputs are consecutive row blocks of one (batchSize * m) x k matrix
+            function.CallGEMM<ValueType>(false, _transpose2, batchSize * _m, _n, _k, pInput1, _lda, pInput2, _ldb, pOutput, _ldc);
+            return true;
+        }
+
+        return false;
+    }
+
     template <typename ValueType>
     ell::utilities::ArchiveVersion MatrixMatrixMultiplyNode<ValueType>::GetArchiveVersion() const
     {
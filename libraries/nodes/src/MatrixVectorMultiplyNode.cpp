@@ -87,6 +87,25 @@ namespace nodes
         function.CallGEMV<ValueType>((int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
     }
 
+    template <typename ValueType>
+    bool MatrixVectorMultiplyNode<ValueType>::CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // With one matrix for the whole batch, the matrix-vector products become one matrix-matrix product,
+        // with a row for each input: outputs = inputs * matrix'
+        if (compiler.IsBatchedPort(inputMatrix) || !compiler.IsBatchedPort(inputVector) || _incx != 1)
+        {
+            return false;
+        }
+
+        auto pInputMatrix = compiler.GetBatchPortBuffer(inputMatrix);
+        auto pInputVectors = compiler.GetBatchPortBuffer(inputVector);
+        auto pOutputs = compiler.GetBatchPortBuffer(output);
+        const auto inputStride = static_cast<int>(inputVector.GetReferencedPort().Size());
+        const auto outputStride = static_cast<int>(output.Size());
+        function.CallGEMM<ValueType>(false, true, compiler.GetBatchSize(), (int)_m, (int)_n, pInputVectors, inputStride, pInputMatrix, (int)_lda, pOutputs, outputStride);
+        return true;
+    }
+
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
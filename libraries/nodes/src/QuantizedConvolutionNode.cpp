@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedConvolutionNode.h"
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    QuantizedConvolutionNode<ValueType>::QuantizedConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedConvolutionNode<ValueType>::QuantizedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                                  const model::PortMemoryLayout& inputMemoryLayout,
+                                                                  const model::PortMemoryLayout& outputMemoryLayout,
+                                                                  int filterSize,
+                                                                  int stride,
+                                                                  std::vector<int8_t> weights,
+                                                                  std::vector<ValueType> weightScales,
+                                                                  ValueType inputScale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputMemoryLayout),
+        _inputMemoryLayout(inputMemoryLayout),
+        _filterSize(filterSize),
+        _stride(stride),
+        _weights(std::move(weights)),
+        _weightScales(std::move(weightScales)),
+        _inputScale(inputScale)
+    {
+        Validate();
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Validate() const
+    {
+        const auto& inputLayout = _inputMemoryLayout;
+        const auto outputLayout = GetOutputMemoryLayout();
+        if (inputLayout.NumDimensions() != 3 || outputLayout.NumDimensions() != 3 || !inputLayout.IsCanonicalOrder() || !outputLayout.IsCanonicalOrder())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Memory layouts must be 3-dimensional and in row-major order");
+        }
+
+        // Channels are contiguous, so each row of a receptive field is a single run of memory
+        if (inputLayout.GetOffset(2) != 0 || inputLayout.GetActiveSize(2) != inputLayout.GetExtent(2) || outputLayout.HasPadding())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input channels and output must not be padded");
+        }
+
+        if (_input.Size() != inputLayout.GetMemorySize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Input size must match the input memory layout");
+        }
+
+        if (_filterSize <= 0 || _stride <= 0 ||
+            (outputLayout.GetActiveSize(0) - 1) * _stride + _filterSize > inputLayout.GetExtent(0) ||
+            (outputLayout.GetActiveSize(1) - 1) * _stride + _filterSize > inputLayout.GetExtent(1))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Filters must fit in the input at every output position");
+        }
+
+        const auto numFilters = static_cast<size_t>(GetNumFilters());
+        if (_weights.size() != numFilters * GetFilterVolume() || _weightScales.size() != numFilters)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Weight sizes must match the filter dimensions");
+        }
+
+        if (!(_inputScale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    int QuantizedConvolutionNode<ValueType>::GetNumFilters() const
+    {
+        return GetOutputMemoryLayout().GetActiveSize(2);
+    }
+
+    template <typename ValueType>
+    int QuantizedConvolutionNode<ValueType>::GetFilterVolume() const
+    {
+        return _filterSize * _filterSize * _inputMemoryLayout.GetExtent(2);
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> QuantizedConvolutionNode<ValueType>::GetOutputScales() const
+    {
+        std::vector<ValueType> outputScales(_weightScales.size());
+        std::transform(_weightScales.begin(), _weightScales.end(), outputScales.begin(), [this](ValueType scale) { return scale * _inputScale; });
+        return outputScales;
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Compute() const
+    {
+        auto inputValues = input.GetValue();
+        const auto inverseInputScale = 1 / _inputScale;
+        std::vector<int> quantizedInput(inputValues.size());
+        std::transform(inputValues.begin(), inputValues.end(), quantizedInput.begin(), [inverseInputScale](ValueType x) { return QuantizeValue(x, inverseInputScale); });
+
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int outputRows = outputLayout.GetActiveSize(0);
+        const int outputColumns = outputLayout.GetActiveSize(1);
+        const int numFilters = GetNumFilters();
+        const int inputColumns = _inputMemoryLayout.GetExtent(1);
+        const int numChannels = _inputMemoryLayout.GetExtent(2);
+        const int filterVolume = GetFilterVolume();
+        auto outputScales = GetOutputScales();
+        std::vector<ValueType> outputValues(outputLayout.GetMemorySize());
+        for (int outputRow = 0; outputRow < outputRows; ++outputRow)
+        {
+            for (int outputColumn = 0; outputColumn < outputColumns; ++outputColumn)
+            {
+                for (int filter = 0; filter < numFilters; ++filter)
+                {
+                    int32_t accumulator = 0;
+                    for (int filterRow = 0; filterRow < _filterSize; ++filterRow)
+                    {
+                        const auto inputOffset = ((outputRow * _stride + filterRow) * inputColumns + outputColumn * _stride) * numChannels;
+                        const auto weightsOffset = filter * filterVolume + filterRow * _filterSize * numChannels;
+                        for (int index = 0; index < _filterSize * numChannels; ++index)
+                        {
+                            accumulator += static_cast<int32_t>(_weights[weightsOffset + index]) * quantizedInput[inputOffset + index];
+                        }
+                    }
+                    outputValues[(outputRow * outputColumns + outputColumn) * numFilters + filter] = static_cast<ValueType>(accumulator) * outputScales[filter];
+                }
+            }
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterSize, _stride, _weights, _weightScales, _inputScale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int outputRows = outputLayout.GetActiveSize(0);
+        const int outputColumns = outputLayout.GetActiveSize(1);
+        const int numFilters = GetNumFilters();
+        const int inputColumns = _inputMemoryLayout.GetExtent(1);
+        const int numChannels = _inputMemoryLayout.GetExtent(2);
+        const int filterRowSize = _filterSize * numChannels;
+        const int filterVolume = GetFilterVolume();
+        const int inputSize = static_cast<int>(_inputMemoryLayout.GetMemorySize());
+        const int filterSize = _filterSize;
+        const int stride = _stride;
+
+        // Each receptive field is gathered into a buffer padded to a whole number of vectors, and the filters are
+        // padded to match, so every output is a single vectorized dot product
+        const int vectorSize = GetInt8DotProductVectorSize(function);
+        const int paddedFilterVolume = GetPaddedSize(filterVolume, vectorSize);
+
+        auto& module = function.GetModule();
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto weights = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), PadRows(_weights, numFilters, filterVolume, paddedFilterVolume));
+        auto outputScales = function.LocalArray(module.ConstantArray(compiler.GetGlobalName(*this, "outputScales"), GetOutputScales()));
+        auto pQuantizedInput = module.GlobalArray<int8_t>(GetInternalStateIdentifier() + "_quantizedInput", inputSize);
+        auto pReceptiveField = function.Variable(emitters::GetVariableType<int8_t>(), paddedFilterVolume);
+
+        // Quantize the whole input, including its padding, once
+        const auto inverseInputScale = 1 / _inputScale;
+        auto quantizedInput = function.LocalArray(pQuantizedInput);
+        function.For(inputSize, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto index = function.LocalScalar(i);
+            quantizedInput[index] = EmitQuantizeValue(function, input[index], inverseInputScale);
+        });
+        if (paddedFilterVolume > filterVolume)
+        {
+            function.MemorySet<int8_t>(pReceptiveField, filterVolume, function.Literal<uint8_t>(0), paddedFilterVolume - filterVolume);
+        }
+
+        function.For(outputRows, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto outputRow = function.LocalScalar(i);
+            function.For(outputColumns, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+                auto outputColumn = function.LocalScalar(j);
+
+                // The filters are typically small, so we unroll the copy of each row of the receptive field
+                for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                {
+                    auto inputOffset = ((outputRow * stride + filterRow) * inputColumns + outputColumn * stride) * numChannels;
+                    function.MemoryCopy<int8_t>(pQuantizedInput, inputOffset, pReceptiveField, function.Literal(filterRow * filterRowSize), function.Literal(filterRowSize));
+                }
+
+                auto outputOffset = (outputRow * outputColumns + outputColumn) * numFilters;
+                function.For(numFilters, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue k) {
+                    auto filter = function.LocalScalar(k);
+                    auto pFilter = function.PointerOffset(weights, filter * paddedFilterVolume);
+                    auto accumulator = EmitInt8DotProduct(function, pFilter, pReceptiveField, paddedFilterVolume, vectorSize);
+                    emitters::IRLocalScalar outputScale = outputScales[filter];
+                    output[outputOffset + filter] = function.LocalScalar(function.CastValue<ValueType>(accumulator)) * outputScale;
+                });
+            });
+        });
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << GetOutputMemoryLayout();
+        archiver["filterSize"] << _filterSize;
+        archiver["stride"] << _stride;
+        archiver["weights"] << _weights;
+        archiver["weightScales"] << _weightScales;
+        archiver["inputScale"] << _inputScale;
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        model::PortMemoryLayout outputMemoryLayout;
+        archiver["outputLayout"] >> outputMemoryLayout;
+        _output.SetMemoryLayout(outputMemoryLayout);
+        archiver["filterSize"] >> _filterSize;
+        archiver["stride"] >> _stride;
+        archiver["weights"] >> _weights;
+        archiver["weightScales"] >> _weightScales;
+        archiver["inputScale"] >> _inputScale;
+    }
+
+    // Explicitly instantiate versions
+    template class QuantizedConvolutionNode<float>;
+    template class QuantizedConvolutionNode<double>;
+} // namespace nodes
+} // namespace ell
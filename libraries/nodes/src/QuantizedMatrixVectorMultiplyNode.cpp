@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixVectorMultiplyNode.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedMatrixVectorMultiplyNode.h"
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    QuantizedMatrixVectorMultiplyNode<ValueType>::QuantizedMatrixVectorMultiplyNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixVectorMultiplyNode<ValueType>::QuantizedMatrixVectorMultiplyNode(const model::OutputPort<ValueType>& input, size_t m, size_t n, std::vector<int8_t> weights, std::vector<ValueType> weightScales, ValueType inputScale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, m),
+        _m(m),
+        _n(n),
+        _weights(std::move(weights)),
+        _weightScales(std::move(weightScales)),
+        _inputScale(inputScale)
+    {
+        if (input.Size() != n)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input sizes must match");
+        }
+
+        if (_weights.size() != m * n || _weightScales.size() != m)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Weight sizes must match the matrix dimensions");
+        }
+
+        if (!(_inputScale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> QuantizedMatrixVectorMultiplyNode<ValueType>::GetOutputScales() const
+    {
+        std::vector<ValueType> outputScales(_m);
+        std::transform(_weightScales.begin(), _weightScales.end(), outputScales.begin(), [this](ValueType scale) { return scale * _inputScale; });
+        return outputScales;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorMultiplyNode<ValueType>::Compute() const
+    {
+        auto inputValues = input.GetValue();
+        const auto inverseInputScale = 1 / _inputScale;
+        std::vector<int> quantizedInput(_n);
+        for (size_t column = 0; column < _n; ++column)
+        {
+            quantizedInput[column] = QuantizeValue(inputValues[column], inverseInputScale);
+        }
+
+        auto outputScales = GetOutputScales();
+        std::vector<ValueType> outputValues(_m);
+        for (size_t row = 0; row < _m; ++row)
+        {
+            int32_t accumulator = 0;
+            for (size_t column = 0; column < _n; ++column)
+            {
+                accumulator += static_cast<int32_t>(_weights[row * _n + column]) * quantizedInput[column];
+            }
+            outputValues[row] = static_cast<ValueType>(accumulator) * outputScales[row];
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorMultiplyNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedMatrixVectorMultiplyNode<ValueType>>(newInput, _m, _n, _weights, _weightScales, _inputScale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // Pad the rows of the matrix and the quantized input with zeros to a whole number of vectors, so each row's
+        // dot product is a single vectorized loop
+        const int numColumns = static_cast<int>(_n);
+        const int vectorSize = GetInt8DotProductVectorSize(function);
+        const int paddedNumColumns = GetPaddedSize(numColumns, vectorSize);
+
+        auto& module = function.GetModule();
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto weights = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), PadRows(_weights, _m, _n, paddedNumColumns));
+        auto outputScales = function.LocalArray(module.ConstantArray(compiler.GetGlobalName(*this, "outputScales"), GetOutputScales()));
+        auto pQuantizedInput = function.Variable(emitters::GetVariableType<int8_t>(), paddedNumColumns);
+        auto quantizedInput = function.LocalArray(pQuantizedInput);
+
+        const auto inverseInputScale = 1 / _inputScale;
+        function.For(numColumns, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto column = function.LocalScalar(i);
+            quantizedInput[column] = EmitQuantizeValue(function, input[column], inverseInputScale);
+        });
+        if (paddedNumColumns > numColumns)
+        {
+            function.MemorySet<int8_t>(pQuantizedInput, numColumns, function.Literal<uint8_t>(0), paddedNumColumns - numColumns);
+        }
+
+        // Accumulate each row's products in 32 bits, then scale back to real values
+        function.For(static_cast<int>(_m), [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto row = function.LocalScalar(i);
+            auto pRow = function.PointerOffset(weights, row * paddedNumColumns);
+            auto accumulator = EmitInt8DotProduct(function, pRow, pQuantizedInput, paddedNumColumns, vectorSize);
+            emitters::IRLocalScalar outputScale = outputScales[row];
+            output[row] = function.LocalScalar(function.CastValue<ValueType>(accumulator)) * outputScale;
+        });
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["m"] << _m;
+        archiver["n"] << _n;
+        archiver["weights"] << _weights;
+        archiver["weightScales"] << _weightScales;
+        archiver["inputScale"] << _inputScale;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorMultiplyNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["m"] >> _m;
+        archiver["n"] >> _n;
+        archiver["weights"] >> _weights;
+        archiver["weightScales"] >> _weightScales;
+        archiver["inputScale"] >> _inputScale;
+    }
+
+    // Explicitly instantiate versions
+    template class QuantizedMatrixVectorMultiplyNode<float>;
+    template class QuantizedMatrixVectorMultiplyNode<double>;
+} // namespace nodes
+} // namespace ell
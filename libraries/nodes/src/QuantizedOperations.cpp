@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedOperations.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedOperations.h"
+
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    // Rounds half up. Clamping first keeps the value positive after the offset, so truncating to int rounds it
+    // the same way the compiled code does.
+    template <typename ValueType>
+    int QuantizeValue(ValueType x, ValueType inverseScale)
+    {
+        const auto maxValue = static_cast<ValueType>(maxQuantizedValue);
+        auto clamped = std::min(std::max(x * inverseScale, -maxValue), maxValue);
+        return static_cast<int>(clamped + (maxValue + static_cast<ValueType>(0.5))) - maxQuantizedValue;
+    }
+
+    template <typename ValueType>
+    emitters::LLVMValue EmitQuantizeValue(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar x, ValueType inverseScale)
+    {
+        const auto maxValue = static_cast<ValueType>(maxQuantizedValue);
+        auto clamped = emitters::Min(emitters::Max(x * inverseScale, -maxValue), maxValue);
+        auto rounded = function.LocalScalar(function.CastValue<int>(clamped + (maxValue + static_cast<ValueType>(0.5)))) - maxQuantizedValue;
+        return function.CastValue<int8_t>(rounded);
+    }
+
+    int GetInt8DotProductVectorSize(emitters::IRFunctionEmitter& function)
+    {
+        auto vectorSize = function.GetVectorSize(function.GetEmitter().Type(emitters::VariableType::Int32));
+
+        // The accumulators are summed by halving, which needs a power of 2
+        return (vectorSize & (vectorSize - 1)) == 0 ? vectorSize : 1;
+    }
+
+    std::vector<int8_t> PadRows(const std::vector<int8_t>& matrix, size_t numRows, size_t numColumns, size_t paddedNumColumns)
+    {
+        std::vector<int8_t> result(numRows * paddedNumColumns, 0);
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            std::copy_n(matrix.begin() + row * numColumns, numColumns, result.begin() + row * paddedNumColumns);
+        }
+        return result;
+    }
+
+    emitters::LLVMValue EmitInt8DotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue pLeft, emitters::LLVMValue pRight, int size, int vectorSize)
+    {
+        auto& emitter = function.GetEmitter();
+        if (vectorSize <= 1)
+        {
+            auto left = function.LocalArray(pLeft);
+            auto right = function.LocalArray(pRight);
+            auto accumulator = function.Variable(emitters::VariableType::Int32, "accumulator");
+            function.StoreZero(accumulator);
+            function.For(size, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+                auto index = function.LocalScalar(i);
+                emitters::IRLocalScalar leftValue = left[index];
+                emitters::IRLocalScalar rightValue = right[index];
+                auto product = function.LocalScalar(function.CastValue<int>(leftValue)) * function.LocalScalar(function.CastValue<int>(rightValue));
+                function.Store(accumulator, function.LocalScalar(function.Load(accumulator)) + product);
+            });
+            return function.Load(accumulator);
+        }
+
+        // Each step widens `vectorSize` int8 values from each array to int32 and adds their products to a vector of
+        // accumulators. The loads don't assume any alignment, since rows start at arbitrary offsets.
+        auto int8VectorType = emitter.VectorType(emitters::VariableType::Char8, vectorSize);
+        auto int32VectorType = emitter.VectorType(emitters::VariableType::Int32, vectorSize);
+        auto pLeftVector = function.CastPointer(pLeft, int8VectorType->getPointerTo());
+        auto pRightVector = function.CastPointer(pRight, int8VectorType->getPointerTo());
+        auto accumulator = function.Variable(int32VectorType, "accumulator");
+        function.Store(accumulator, emitters::FillVector<int>(function, int32VectorType, 0));
+        function.For(size / vectorSize, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto left = irBuilder.CreateSExt(irBuilder.CreateAlignedLoad(function.PointerOffset(pLeftVector, i), 1), int32VectorType);
+            auto right = irBuilder.CreateSExt(irBuilder.CreateAlignedLoad(function.PointerOffset(pRightVector, i), 1), int32VectorType);
+            function.Store(accumulator, irBuilder.CreateAdd(function.Load(accumulator), irBuilder.CreateMul(left, right)));
+        });
+        return emitters::HorizontalVectorSum<int>(function, function.Load(accumulator));
+    }
+
+    // Explicitly instantiate versions
+    template int QuantizeValue<float>(float x, float inverseScale);
+    template int QuantizeValue<double>(double x, double inverseScale);
+    template emitters::LLVMValue EmitQuantizeValue<float>(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar x, float inverseScale);
+    template emitters::LLVMValue EmitQuantizeValue<double>(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar x, double inverseScale);
+} // namespace nodes
+} // namespace ell
@@ -1060,6 +1060,14 @@ namespace nodes
     {
     }
 
+    template <typename ValueType>
+    typename WinogradConvolutionNode<ValueType>::FilterOrder WinogradConvolutionNode<ValueType>::GetDefaultFilterOrder(const ConstTensorReferenceType& filterWeights)
+    {
+        const int numFilterChannels = static_cast<int>(filterWeights.NumChannels());
+        const int filtersFirstThreshold = 4; // empirically determined
+        return (numFilterChannels <= filtersFirstThreshold) ? FilterOrder::filtersFirst : FilterOrder::tilesFirst;
+    }
+
     template <typename ValueType>
     WinogradConvolutionNode<ValueType>::WinogradConvolutionNode(const WinogradConvolutionNode<ValueType>& other, const model::OutputPort<ValueType>& input) :
         CompilableNode({ &_input }, { &_output }),
@@ -1086,13 +1094,9 @@ namespace nodes
         _inputMemoryLayout(inputMemoryLayout),
         _stride(stride)
     {
-        using FilterOrder = typename WinogradConvolutionNode<ValueType>::FilterOrder;
-
         _tileSize = 2;
         const int numFilters = outputMemoryLayout.GetLogicalDimensionActiveSize(2);
-        const int numFilterChannels = static_cast<int>(filterWeights.NumChannels());
-        const int filtersFirstThreshold = 4; // empirically determined
-        _order = (numFilterChannels <= filtersFirstThreshold) ? FilterOrder::filtersFirst : FilterOrder::tilesFirst;
+        _order = GetDefaultFilterOrder(filterWeights);
 
         _filterSize = filterWeights.NumColumns();
         if (filterWeights.NumRows() != static_cast<size_t>(_filterSize * numFilters))
@@ -415,6 +415,47 @@ static void TestBufferNode()
     }
 }
 
+// Tests a buffer whose window isn't a multiple of the input size, so its ring buffer wraps at a different place each step
+template <typename ValueType>
+static void TestBufferNodeWrapAround()
+{
+    const ValueType epsilon = static_cast<ValueType>(1e-7);
+    const size_t inputSize = 5;
+    const size_t windowSize = 12;
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(inputSize);
+    auto outputNode = model.AddNode<nodes::BufferNode<ValueType>>(inputNode->output, windowSize);
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = false;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<ValueType> history(windowSize, 0);
+    bool computeOk = true;
+    bool compileOk = true;
+    for (int index = 0; index < 10; ++index)
+    {
+        std::vector<ValueType> input(inputSize);
+        std::iota(input.begin(), input.end(), static_cast<ValueType>(inputSize * index + 1));
+        history.insert(history.end(), input.begin(), input.end());
+        std::vector<ValueType> expected(history.end() - windowSize, history.end());
+
+        map.SetInputValue(0, input);
+        auto computedResult = map.ComputeOutput<ValueType>(0);
+
+        compiledMap.SetInputValue(0, input);
+        auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+
+        computeOk = computeOk && testing::IsEqual(computedResult, expected, epsilon);
+        compileOk = compileOk && testing::IsEqual(compiledResult, expected, epsilon);
+    }
+    testing::ProcessTest("Testing BufferNode compute with wrap-around", computeOk);
+    testing::ProcessTest("Testing BufferNode compile with wrap-around", compileOk);
+}
+
 template <typename ValueType>
 static void TestConvolutionNodeCompile(dsp::ConvolutionMethodOption convolutionMethod)
 {
@@ -1136,6 +1177,8 @@ void TestDSPNodes(const std::string& path)
     TestMelFilterBankNode<double>();
 
     TestBufferNode<float>();
+    TestBufferNodeWrapAround<float>();
+    TestBufferNodeWrapAround<double>();
 
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::simple);
     // TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::diagonal); // ERROR: diagonal test currently broken
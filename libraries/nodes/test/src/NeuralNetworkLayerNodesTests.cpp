@@ -696,6 +696,47 @@ static void TestSoftmaxLayerNode()
     testing::ProcessTest("Testing SoftmaxLayerNode compute", testing::IsEqual(modelOutput, output.ToArray()));
 }
 
+// Layer nodes read their input in place from the node before them, so check a chain still tracks changing inputs
+static void TestChainedLayerNodes()
+{
+    using ElementType = double;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using VectorType = typename BiasLayer<ElementType>::VectorType;
+
+    TensorType input(2, 2, 2);
+    input(0, 0, 0) = 1.0;
+    input(0, 1, 0) = -2.0;
+    input(1, 0, 1) = 3.0;
+    input(1, 1, 1) = -4.0;
+
+    LayerParameters activationParameters{ input, NoPadding(), { 2, 2, 2 }, NoPadding() };
+    ActivationLayer<ElementType> activationLayer(activationParameters, new ReLUActivation<ElementType>());
+    LayerParameters biasParameters{ activationLayer.GetOutput(), NoPadding(), { 4, 4, 2 }, ZeroPadding(1) };
+    BiasLayer<ElementType> biasLayer(biasParameters, VectorType({ 5, 10 }));
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(inputNode->output, activationLayer);
+    auto biasNode = model.AddNode<nodes::BiasLayerNode<ElementType>>(activationNode->output, biasLayer);
+
+    bool ok = true;
+    for (auto sign : { 1.0, -1.0 })
+    {
+        TensorType signedInput(2, 2, 2);
+        signedInput.CopyFrom(input);
+        signedInput.Transform([sign](ElementType x) { return sign * x; });
+        activationLayer.GetLayerParameters().input = signedInput;
+        activationLayer.Compute();
+        biasLayer.Compute();
+
+        inputNode->SetInput(signedInput.ToArray());
+        auto modelOutput = model.ComputeOutput(biasNode->output);
+        ok = ok && testing::IsEqual(modelOutput, biasLayer.GetOutput().ToArray());
+    }
+    testing::ProcessTest("Testing chained layer nodes compute", ok);
+}
+
 void TestNeuralNetworkLayerNodes()
 {
     // Neural nets
@@ -709,6 +750,7 @@ void TestNeuralNetworkLayerNodes()
     TestPoolingLayerNode();
     TestScalingLayerNode();
     TestSoftmaxLayerNode();
+    TestChainedLayerNodes();
 
     TestArchiveNeuralNetworkPredictorNode();
     TestArchiveNeuralNetworkLayerNodes();
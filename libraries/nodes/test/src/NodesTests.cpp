@@ -13,6 +13,7 @@
 #include <nodes/include/BatchNormalizationLayerNode.h>
 #include <nodes/include/BiasLayerNode.h>
 #include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/BroadcastFunctionNode.h>
 #include <nodes/include/BufferNode.h>
 #include <nodes/include/ClockNode.h>
 #include <nodes/include/ConcatenationNode.h>
@@ -40,11 +41,15 @@
 #include <math/include/Tensor.h>
 #include <math/include/TensorOperations.h>
 
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
+#include <model/include/Map.h>
 #include <model/include/Model.h>
 #include <model/include/Node.h>
 #include <model/include/OutputNode.h>
 
+#include <model_testing/include/ModelTestUtilities.h>
+
 #include <predictors/include/LinearPredictor.h>
 #include <predictors/include/NeuralNetworkPredictor.h>
 #include <predictors/include/ProtoNNPredictor.h>
@@ -114,36 +119,6 @@ std::ostream& operator<<(std::ostream& os, const std::vector<ValueType>& vec)
     os << "]";
     return os;
 }
-
-template <typename ValueType>
-class Uniform
-{
-public:
-    Uniform(ValueType minVal, ValueType maxVal, std::string seed = "123") :
-        _rng(utilities::GetRandomEngine(seed)),
-        _range(static_cast<double>(_rng.max() - _rng.min())),
-        _minOutput(minVal),
-        _outputRange(maxVal - minVal) {}
-
-    ValueType operator()()
-    {
-        double uniform = static_cast<double>(_rng()) / _range;
-        return static_cast<ValueType>((uniform * _outputRange) + _minOutput);
-    }
-
-private:
-    std::default_random_engine _rng;
-    double _range;
-    ValueType _minOutput;
-    ValueType _outputRange;
-};
-
-template <typename ElementType>
-void FillRandomVector(std::vector<ElementType>& vector, ElementType min = -1, ElementType max = 1)
-{
-    Uniform<ElementType> rand(min, max);
-    std::generate(vector.begin(), vector.end(), rand);
-}
 } // namespace
 
 //
@@ -905,6 +880,76 @@ static void TestConcatenationNodeCompute()
     testing::ProcessTest("TestConcatenationNodeCompute", testing::IsEqual(result, expected));
 }
 
+//
+// Compile tests
+//
+
+// These compile with vector instructions allowed, so the nodes' elementwise loops process a vector of elements per
+// iteration. The innermost sizes are 11, which isn't a multiple of any vector width, so the loops also finish leftover
+// elements.
+static model::IRCompiledMap CompileVectorized(model::Map& map)
+{
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::IRMapCompiler compiler(settings);
+    return compiler.Compile(map);
+}
+
+static void TestVectorizedBroadcastFunctionNodeCompile(size_t broadcastDimension)
+{
+    // The innermost dimension is vectorized: its secondary values are loaded along with the input when it's the
+    // broadcast dimension, and broadcast to a vector otherwise
+    model::MemoryShape shape{ 2, 3, 11 };
+    model::PortMemoryLayout layout(shape);
+    auto numSecondaryValues = static_cast<size_t>(shape[broadcastDimension]);
+    std::vector<float> scale(numSecondaryValues);
+    std::vector<float> bias(numSecondaryValues);
+    FillRandomVector(scale);
+    FillRandomVector(bias);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(shape);
+    auto scaleNode = model.AddNode<nodes::ConstantNode<float>>(scale);
+    auto biasNode = model.AddNode<nodes::ConstantNode<float>>(bias);
+    auto testNode = model.AddNode<nodes::BroadcastLinearFunctionNode<float>>(inputNode->output, layout, scaleNode->output, biasNode->output, broadcastDimension, layout);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    auto compiledMap = CompileVectorized(map);
+
+    std::vector<std::vector<float>> signal(2, std::vector<float>(layout.GetMemorySize()));
+    for (auto& input : signal)
+    {
+        FillRandomVector(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized BroadcastLinearFunctionNode", "broadcast dimension " + std::to_string(broadcastDimension));
+}
+
+static void TestVectorizedTypeCastNodeCompile()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<int>>(11);
+    auto testNode = model.AddNode<nodes::TypeCastNode<int, float>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    auto compiledMap = CompileVectorized(map);
+
+    std::vector<std::vector<int>> signal = { { -5, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5 }, { 1000000, -1000000, 7, -7, 12, -12, 255, -256, 65535, 1, 0 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized TypeCastNode");
+}
+
+static void TestVectorizedIntegerBinaryOperationNodeCompile()
+{
+    // Integer division can trap in the masked-off lanes of a partial vector, so the leftover elements are computed one
+    // at a time
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<int>>(11);
+    auto divisorNode = model.AddNode<nodes::ConstantNode<int>>(std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 });
+    auto testNode = model.AddNode<nodes::BinaryOperationNode<int>>(inputNode->output, divisorNode->output, emitters::BinaryOperationType::coordinatewiseDivide);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    auto compiledMap = CompileVectorized(map);
+
+    std::vector<std::vector<int>> signal = { { 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100 }, { -7, 9, -20, 33, 41, -60, 70, 81, -95, 100, 121 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized integer BinaryOperationNode");
+}
+
 //
 // Main driver function to call all the tests
 //
@@ -942,4 +987,12 @@ void TestNodes()
     TestEuclideanDistanceNodeRefine();
     TestProtoNNPredictorNode();
     TestSquaredEuclideanDistanceNodeRefine();
+
+    //
+    // Compile tests
+    //
+    TestVectorizedBroadcastFunctionNodeCompile(1);
+    TestVectorizedBroadcastFunctionNodeCompile(2);
+    TestVectorizedTypeCastNodeCompile();
+    TestVectorizedIntegerBinaryOperationNodeCompile();
 }
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/TargetDevice.h>
+
+#include <predictors/neural/include/ConvolutionalLayer.h>
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The convolution method measured to be fastest for a layer shape on a target. </summary>
+    struct ConvolutionTuningResult
+    {
+        predictors::neural::ConvolutionMethod method = predictors::neural::ConvolutionMethod::automatic;
+        size_t winogradTileSize = 0;
+        double milliseconds = 0;
+    };
+
+    /// <summary> Gets the name a convolution method has in a tuning database (e.g., "winograd"). </summary>
+    ///
+    /// <param name="method"> The convolution method. </param>
+    std::string GetConvolutionMethodName(predictors::neural::ConvolutionMethod method);
+
+    /// <summary> A table of convolution autotuning results, keyed by layer shape and target device, that can be kept in a file. </summary>
+    ///
+    /// The file is plain text with one tab-separated entry per line: target, shape, method, Winograd tile size and time in milliseconds.
+    /// Lines starting with '#' are comments.
+    class ConvolutionTuningDatabase
+    {
+    public:
+        /// <summary> Reads the entries in a file into this database. A missing file adds nothing. </summary>
+        ///
+        /// <param name="filename"> The file to read. </param>
+        void Load(const std::string& filename);
+
+        /// <summary> Writes this database to a file, replacing its contents. </summary>
+        ///
+        /// <param name="filename"> The file to write. </param>
+        void Save(const std::string& filename) const;
+
+        /// <summary> Reads entries from a stream into this database. </summary>
+        ///
+        /// <param name="stream"> The stream to read from. </param>
+        void Read(std::istream& stream);
+
+        /// <summary> Writes this database to a stream. </summary>
+        ///
+        /// <param name="stream"> The stream to write to. </param>
+        void Write(std::ostream& stream) const;
+
+        /// <summary> Looks up the result for a layer shape on a target. </summary>
+        ///
+        /// <param name="targetKey"> The target, as returned by `GetTargetKey`. </param>
+        /// <param name="shapeKey"> The layer shape, as returned by `GetShapeKey`. </param>
+        ///
+        /// <returns> A pointer to the result, or nullptr if there isn't one. </returns>
+        const ConvolutionTuningResult* Find(const std::string& targetKey, const std::string& shapeKey) const;
+
+        /// <summary> Adds or replaces the result for a layer shape on a target. </summary>
+        ///
+        /// <param name="targetKey"> The target, as returned by `GetTargetKey`. </param>
+        /// <param name="shapeKey"> The layer shape, as returned by `GetShapeKey`. </param>
+        /// <param name="result"> The result to record. </param>
+        void Set(const std::string& targetKey, const std::string& shapeKey, const ConvolutionTuningResult& result);
+
+        /// <summary> Returns the number of entries in the database. </summary>
+        size_t Size() const { return _entries.size(); }
+
+        /// <summary> Gets the key identifying a target device: its triple, CPU and features. </summary>
+        ///
+        /// <param name="targetDevice"> The target device, with its properties filled in. </param>
+        static std::string GetTargetKey(const emitters::TargetDevice& targetDevice);
+
+        /// <summary> Gets the key identifying the shape of a convolutional layer: everything but its weights. </summary>
+        ///
+        /// <param name="layer"> The layer. </param>
+        template <typename ValueType>
+        static std::string GetShapeKey(const predictors::neural::ConvolutionalLayer<ValueType>& layer);
+
+    private:
+        std::map<std::pair<std::string, std::string>, ConvolutionTuningResult> _entries;
+    };
+} // namespace passes
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/TypeName.h>
+
+#include <sstream>
+
+namespace ell
+{
+namespace passes
+{
+    template <typename ValueType>
+    std::string ConvolutionTuningDatabase::GetShapeKey(const predictors::neural::ConvolutionalLayer<ValueType>& layer)
+    {
+        const auto& layerParameters = layer.GetLayerParameters();
+        const auto& convolutionalParameters = layer.GetConvolutionalParameters();
+        const auto& input = layerParameters.input;
+        const auto& weights = layer.GetWeights();
+
+        // e.g. "float_in34x34x16p1_out32x32x32p0_k3_s1"
+        std::stringstream key;
+        key << utilities::TypeName<ValueType>::GetName()
+            << "_in" << input.NumRows() << "x" << input.NumColumns() << "x" << input.NumChannels() << "p" << layerParameters.inputPaddingParameters.paddingSize
+            << "_out" << layerParameters.outputShape.NumRows() << "x" << layerParameters.outputShape.NumColumns() << "x" << layerParameters.outputShape.NumChannels() << "p" << layerParameters.outputPaddingParameters.paddingSize
+            << "_k" << convolutionalParameters.receptiveField << "_s" << convolutionalParameters.stride;
+        if (weights.NumChannels() == 1 && input.NumChannels() != 1)
+        {
+            key << "_dw";
+        }
+        return key.str();
+    }
+} // namespace passes
+} // namespace ell
+
+#pragma endregion implementation
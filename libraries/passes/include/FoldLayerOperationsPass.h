@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FoldLayerOperationsPass.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Model.h>
+
+#include <model/optimizer/include/ModelOptimizer.h>
+#include <model/optimizer/include/OptimizationPass.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that removes elementwise passes over layer outputs. The scale of a `BroadcastLinearFunctionNode`
+    /// (e.g., a refined batch normalization or scaling layer) is folded into the weights of the convolutional or fully-connected
+    /// layer that produces its input, and ReLU, leaky ReLU and hard sigmoid (`0.2x + 0.5` clamped to [0, 1]) activations are
+    /// computed in the loop of the linear function before them, as a `BroadcastLinearActivationFunctionNode`. Other clamping
+    /// activations aren't fused.
+    /// </summary>
+    class FoldLayerOperationsPass : public model::NodeLocalOptimizationPass
+    {
+    public:
+        /// <summary> Fold a linear function or activation node into its predecessor if possible. </summary>
+        ///
+        /// <param name="node"> The current node being visited. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseElementwiseOperationsPass.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Model.h>
+
+#include <model/optimizer/include/ModelOptimizer.h>
+#include <model/optimizer/include/OptimizationPass.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that computes chains of elementwise nodes in a single loop. A `UnaryOperationNode`,
+    /// `BinaryOperationNode`, `BroadcastLinearFunctionNode` or `TypeCastNode` whose input is computed by another of these
+    /// nodes (and used by nothing else) is fused with it into a `FusedElementwiseNode`, so the tensor between them is
+    /// never written to memory. The nodes must have the same memory layout, without padding.
+    /// </summary>
+    class FuseElementwiseOperationsPass : public model::NodeLocalOptimizationPass
+    {
+    public:
+        /// <summary> Fuse an elementwise node with the elementwise node before it if possible. </summary>
+        ///
+        /// <param name="node"> The current node being visited. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Map.h>
+
+#include <utilities/include/UniqueId.h>
+
+#include <map>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The largest magnitude seen on the input of each quantizable node, keyed by node id. </summary>
+    using ActivationRanges = std::map<utilities::UniqueId, double>;
+
+    /// <summary>
+    /// Collects the ranges of the activations fed into the quantizable nodes of a map (matrix-vector multiplies with a constant
+    /// matrix, as refined fully-connected layers are, and convolutional layers) while a representative dataset is run through it.
+    /// </summary>
+    ///
+    /// Typical use is to refine the map, then call `Update` after each call to `Map::Compute`, and pass the resulting ranges
+    /// to a `QuantizationPass` that optimizes the same map.
+    class QuantizationCalibrator
+    {
+    public:
+        /// <summary> Records the activations of the map's most recent `Compute` call. </summary>
+        ///
+        /// <param name="map"> The map that was just computed. </param>
+        void Update(const model::Map& map);
+
+        /// <summary> Returns the number of examples recorded. </summary>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Gets the ranges recorded so far. </summary>
+        const ActivationRanges& GetActivationRanges() const { return _ranges; }
+
+    private:
+        template <typename ValueType>
+        void UpdateNodes(const model::Model& model);
+
+        ActivationRanges _ranges;
+        size_t _numExamples = 0;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationPass.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "QuantizationCalibrator.h"
+
+#include <model/include/Model.h>
+
+#include <model/optimizer/include/ModelOptimizer.h>
+#include <model/optimizer/include/OptimizationPass.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that replaces each matrix-vector multiply with a constant matrix by a
+    /// `QuantizedMatrixVectorMultiplyNode`, which stores the matrix as int8 with one scale per row and quantizes its input
+    /// using the range collected for it by a `QuantizationCalibrator`. Convolutional layers are replaced the same way by a
+    /// `QuantizedConvolutionNode`, with one scale per filter. Nodes without a recorded range are left in floating point.
+    /// </summary>
+    ///
+    /// This pass isn't in the standard registry: it needs calibration data, so it is added to an optimizer explicitly.
+    class QuantizationPass : public model::NodeLocalOptimizationPass
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="ranges"> The activation ranges of the nodes of the model to be optimized. </param>
+        QuantizationPass(ActivationRanges ranges);
+
+        /// <summary> Quantize a node if possible. </summary>
+        ///
+        /// <param name="node"> The current node being visited. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+    private:
+        ActivationRanges _ranges;
+    };
+} // namespace passes
+} // namespace ell
@@ -19,11 +19,12 @@ namespace ell
 {
 namespace passes
 {
-    /// <summary> An optimization pass that fuses sequential `BroadcastLinearFunctionNode`s into one. </summary>
+    /// <summary> An optimization pass that sets the method `ConvolutionalLayerNode`s are compiled with, either to the preferred
+    /// method or, with `PreferredConvolutionMethod::autotune`, to the one measured to be fastest for the layer's shape. </summary>
     class SetConvolutionMethodPass : public model::NodeLocalOptimizationPass
     {
     public:
-        /// <summary> Combine a linear function node with its predecessor if possible. </summary>
+        /// <summary> Set the convolution method of a convolutional layer node. </summary>
         ///
         /// <param name="node"> The current node being visited. </param>
         /// <param name="transformer"> The transformer object operating on the model. </param>
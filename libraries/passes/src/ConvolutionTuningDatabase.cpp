@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvolutionTuningDatabase.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        using predictors::neural::ConvolutionMethod;
+
+        const std::map<ConvolutionMethod, std::string> methodNames = {
+            { ConvolutionMethod::automatic, "auto" },
+            { ConvolutionMethod::diagonal, "diagonal" },
+            { ConvolutionMethod::simple, "simple" },
+            { ConvolutionMethod::winograd, "winograd" },
+            { ConvolutionMethod::unrolled, "unrolled" }
+        };
+
+        ConvolutionMethod GetMethod(const std::string& name)
+        {
+            for (const auto& entry : methodNames)
+            {
+                if (entry.second == name)
+                {
+                    return entry.first;
+                }
+            }
+            throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Unknown convolution method '" + name + "' in tuning database");
+        }
+    } // namespace
+
+    std::string GetConvolutionMethodName(ConvolutionMethod method)
+    {
+        return methodNames.at(method);
+    }
+
+    void ConvolutionTuningDatabase::Load(const std::string& filename)
+    {
+        if (!utilities::FileExists(filename))
+        {
+            return;
+        }
+        auto stream = utilities::OpenIfstream(filename);
+        Read(stream);
+    }
+
+    void ConvolutionTuningDatabase::Save(const std::string& filename) const
+    {
+        // Replace the whole file at once, so a compile that loads the database while the tuner saves it reads either
+        // the old entries or the new ones
+        auto tempFilename = utilities::GetTemporaryFilePath(filename);
+        bool written = false;
+        {
+            auto stream = utilities::OpenOfstream(tempFilename);
+            Write(stream);
+            written = static_cast<bool>(stream);
+        }
+        if (!written || !utilities::ReplaceFile(tempFilename, filename))
+        {
+            std::remove(tempFilename.c_str());
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Unable to write " + filename);
+        }
+    }
+
+    void ConvolutionTuningDatabase::Read(std::istream& stream)
+    {
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::vector<std::string> fields;
+            std::string::size_type start = 0;
+            std::string::size_type end;
+            while ((end = line.find('\t', start)) != std::string::npos)
+            {
+                fields.push_back(line.substr(start, end - start));
+                start = end + 1;
+            }
+            fields.push_back(line.substr(start));
+
+            if (fields.size() != 5)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Malformed convolution tuning database entry: " + line);
+            }
+
+            ConvolutionTuningResult result;
+            result.method = GetMethod(fields[2]);
+            try
+            {
+                result.winogradTileSize = std::stoul(fields[3]);
+                result.milliseconds = std::stod(fields[4]);
+            }
+            catch (const std::logic_error&)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Malformed convolution tuning database entry: " + line);
+            }
+            Set(fields[0], fields[1], result);
+        }
+    }
+
+    void ConvolutionTuningDatabase::Write(std::ostream& stream) const
+    {
+        stream << "# ELL convolution tuning database\n";
+        stream << "# target\tshape\tmethod\twinogradTileSize\tmilliseconds\n";
+        for (const auto& entry : _entries)
+        {
+            const auto& result = entry.second;
+            stream << entry.first.first << '\t' << entry.first.second << '\t' << GetConvolutionMethodName(result.method) << '\t' << result.winogradTileSize << '\t' << result.milliseconds << '\n';
+        }
+    }
+
+    const ConvolutionTuningResult* ConvolutionTuningDatabase::Find(const std::string& targetKey, const std::string& shapeKey) const
+    {
+        auto iter = _entries.find({ targetKey, shapeKey });
+        return iter == _entries.end() ? nullptr : &iter->second;
+    }
+
+    void ConvolutionTuningDatabase::Set(const std::string& targetKey, const std::string& shapeKey, const ConvolutionTuningResult& result)
+    {
+        _entries[{ targetKey, shapeKey }] = result;
+    }
+
+    std::string ConvolutionTuningDatabase::GetTargetKey(const emitters::TargetDevice& targetDevice)
+    {
+        auto key = targetDevice.triple + "/" + targetDevice.cpu;
+        if (!targetDevice.features.empty())
+        {
+            key += "/" + targetDevice.features;
+        }
+        return key;
+    }
+} // namespace passes
+} // namespace ell
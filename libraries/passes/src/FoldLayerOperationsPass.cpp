@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FoldLayerOperationsPass.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FoldLayerOperationsPass.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <model/optimizer/include/OptimizationPassRegistry.h>
+
+#include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/CompiledActivationFunctions.h>
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+
+#include <predictors/neural/include/ConvolutionalLayer.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    //
+    // Implementation
+    //
+    namespace
+    {
+        const size_t channelDimension = 2;
+
+        //
+        // Functions
+        //
+        template <typename ValueType>
+        bool IsConstantOrEmpty(const model::InputPort<ValueType>& input)
+        {
+            return input.Size() == 0 || dynamic_cast<const nodes::ConstantNode<ValueType>*>(input.GetReferencedPort().GetNode()) != nullptr;
+        }
+
+        template <typename ValueType>
+        std::vector<ValueType> GetConstantValues(const model::InputPort<ValueType>& input)
+        {
+            if (input.Size() == 0)
+            {
+                return {};
+            }
+            return dynamic_cast<const nodes::ConstantNode<ValueType>&>(*input.GetReferencedPort().GetNode()).GetValues();
+        }
+
+        template <typename ValueType>
+        bool HasConstantCoefficients(const nodes::BroadcastLinearFunctionNode<ValueType>& node)
+        {
+            return IsConstantOrEmpty(node.secondaryInput1) && IsConstantOrEmpty(node.secondaryInput2);
+        }
+
+        // The number of bytes an elementwise pass reads and writes
+        template <typename ValueType>
+        size_t GetElementwiseMemoryTraffic(const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout)
+        {
+            return (inputLayout.GetMemorySize() + outputLayout.GetMemorySize()) * sizeof(ValueType);
+        }
+
+        // Returns the output of a new convolutional layer node with each filter's weights multiplied by its scale, or nullptr if it can't be done
+        template <typename ValueType>
+        const model::OutputPort<ValueType>* FoldScaleIntoConvolution(const nodes::ConvolutionalLayerNode<ValueType>& convolutionNode, const nodes::BroadcastLinearFunctionNode<ValueType>& linearNode, const std::vector<ValueType>& scale, model::ModelTransformer& transformer)
+        {
+            if (linearNode.GetBroadcastDimension() != channelDimension || linearNode.GetInputMemoryLayout() != convolutionNode.GetOutputMemoryLayout())
+            {
+                return nullptr;
+            }
+
+            // Filter `f` is stored in rows [f * receptiveField, (f + 1) * receptiveField) of the weights tensor (for both regular and depthwise-separable convolutions)
+            const auto& layer = convolutionNode.GetLayer();
+            auto weights = layer.GetWeights();
+            const auto receptiveField = layer.GetConvolutionalParameters().receptiveField;
+            if (weights.NumRows() != scale.size() * receptiveField)
+            {
+                return nullptr;
+            }
+
+            for (size_t filter = 0; filter < scale.size(); ++filter)
+            {
+                for (size_t row = filter * receptiveField; row < (filter + 1) * receptiveField; ++row)
+                {
+                    for (size_t column = 0; column < weights.NumColumns(); ++column)
+                    {
+                        for (size_t channel = 0; channel < weights.NumChannels(); ++channel)
+                        {
+                            weights(row, column, channel) *= scale[filter];
+                        }
+                    }
+                }
+            }
+
+            predictors::neural::ConvolutionalLayer<ValueType> newLayer = { layer.GetLayerParameters(), layer.GetConvolutionalParameters(), weights };
+            const auto& newInput = transformer.GetCorrespondingInputs(convolutionNode.input);
+            auto newNode = transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer);
+            return &newNode->output;
+        }
+
+        // Returns the output of a new matrix-vector multiply node with each row of its (constant) matrix multiplied by its scale, or nullptr if it can't be done
+        template <typename ValueType>
+        const model::OutputPort<ValueType>* FoldScaleIntoMatrixVectorMultiply(const nodes::MatrixVectorMultiplyNode<ValueType>& multiplyNode, const nodes::BroadcastLinearFunctionNode<ValueType>& linearNode, const std::vector<ValueType>& scale, model::ModelTransformer& transformer)
+        {
+            // The scale must line up with the output vector: no padding, and all of it along the broadcast dimension
+            const auto numRows = multiplyNode.NumRows();
+            const auto& inputLayout = linearNode.GetInputMemoryLayout();
+            if (scale.size() != numRows || inputLayout.GetMemorySize() != numRows || static_cast<size_t>(inputLayout.GetActiveSize(linearNode.GetBroadcastDimension())) != numRows)
+            {
+                return nullptr;
+            }
+
+            if (!IsConstantOrEmpty(multiplyNode.inputMatrix) || multiplyNode.inputMatrix.Size() == 0)
+            {
+                return nullptr;
+            }
+
+            auto matrix = GetConstantValues(multiplyNode.inputMatrix);
+            const auto numColumns = multiplyNode.NumColumns();
+            const auto stride = multiplyNode.GetMatrixStride();
+            if (numRows > 0 && matrix.size() < (numRows - 1) * stride + numColumns)
+            {
+                return nullptr;
+            }
+
+            for (size_t row = 0; row < numRows; ++row)
+            {
+                for (size_t column = 0; column < numColumns; ++column)
+                {
+                    matrix[row * stride + column] *= scale[row];
+                }
+            }
+
+            auto matrixNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(matrix);
+            const auto& newInput = transformer.GetCorrespondingInputs(multiplyNode.inputVector);
+            auto newNode = transformer.AddNode<nodes::MatrixVectorMultiplyNode<ValueType>>(matrixNode->output, numRows, numColumns, stride, newInput);
+            return &newNode->output;
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes
+        template <typename ValueType>
+        bool TryFoldScaleIntoLayer(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node);
+            if (linearNode == nullptr || linearNode->secondaryInput1.Size() == 0 || !HasConstantCoefficients(*linearNode))
+            {
+                return false;
+            }
+
+            // Changing the layer's weights changes its output, so nothing else may be using it
+            const auto& sourceNode = *linearNode->primaryInput.GetReferencedPort().GetNode();
+            if (sourceNode.GetDependentNodes().size() != 1)
+            {
+                return false;
+            }
+
+            auto scale = GetConstantValues(linearNode->secondaryInput1);
+            const model::OutputPort<ValueType>* newSourceOutput = nullptr;
+            if (auto convolutionNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&sourceNode))
+            {
+                newSourceOutput = FoldScaleIntoConvolution(*convolutionNode, *linearNode, scale, transformer);
+            }
+            else if (auto multiplyNode = dynamic_cast<const nodes::MatrixVectorMultiplyNode<ValueType>*>(&sourceNode))
+            {
+                newSourceOutput = FoldScaleIntoMatrixVectorMultiply(*multiplyNode, *linearNode, scale, transformer);
+            }
+
+            if (newSourceOutput == nullptr)
+            {
+                return false;
+            }
+
+            const auto& inputLayout = linearNode->GetInputMemoryLayout();
+            auto outputLayout = linearNode->GetOutputMemoryLayout();
+            auto bias = GetConstantValues(linearNode->secondaryInput2);
+            if (bias.empty() && inputLayout == outputLayout)
+            {
+                // Nothing is left for the linear function to do
+                transformer.MapNodeOutput(linearNode->output, *newSourceOutput);
+                Log() << "Folded BroadcastLinearFunctionNode [id = " << linearNode->GetId().ToString() << "] into " << sourceNode.GetRuntimeTypeName()
+                      << " [id = " << sourceNode.GetId().ToString() << "], removing " << GetElementwiseMemoryTraffic<ValueType>(inputLayout, outputLayout) << " bytes of memory traffic" << EOL;
+                return true;
+            }
+
+            // Keep the bias (and any change of padding) in a linear function node, which a following activation can still be fused into
+            if (bias.empty())
+            {
+                bias.resize(scale.size());
+            }
+            auto scaleNode = transformer.AddNode<nodes::ConstantNode<ValueType>>();
+            auto biasNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(bias);
+            auto newNode = transformer.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(*newSourceOutput,
+                                                                                              inputLayout,
+                                                                                              scaleNode->output,
+                                                                                              biasNode->output,
+                                                                                              linearNode->GetBroadcastDimension(),
+                                                                                              outputLayout);
+            transformer.MapNodeOutput(linearNode->output, newNode->output);
+            Log() << "Folded the scale of BroadcastLinearFunctionNode [id = " << linearNode->GetId().ToString() << "] into " << sourceNode.GetRuntimeTypeName()
+                  << " [id = " << sourceNode.GetId().ToString() << "], removing a multiply per element" << EOL;
+            return true;
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other activation functions and ValueTypes
+        template <typename ValueType, typename ActivationFunctionType>
+        bool TryFuseActivation(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            auto activationNode = dynamic_cast<const nodes::BroadcastUnaryFunctionNode<ValueType, ActivationFunctionType>*>(&node);
+            if (activationNode == nullptr)
+            {
+                return false;
+            }
+
+            // The linear function's output is computed in place of the activation's, so nothing else may be using it
+            const auto& sourceNode = *activationNode->primaryInput.GetReferencedPort().GetNode();
+            if (sourceNode.GetDependentNodes().size() != 1)
+            {
+                return false;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(activationNode->primaryInput);
+            auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(newInput.GetNode());
+            if (linearNode == nullptr || !HasConstantCoefficients(*linearNode) || linearNode->GetOutputMemoryLayout() != activationNode->GetInputMemoryLayout())
+            {
+                return false;
+            }
+
+            auto scaleNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(GetConstantValues(linearNode->secondaryInput1));
+            auto biasNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(GetConstantValues(linearNode->secondaryInput2));
+            auto newNode = transformer.AddNode<nodes::BroadcastLinearActivationFunctionNode<ValueType, ActivationFunctionType>>(linearNode->primaryInput.GetReferencedPort(),
+                                                                                                                               linearNode->GetInputMemoryLayout(),
+                                                                                                                               scaleNode->output,
+                                                                                                                               biasNode->output,
+                                                                                                                               linearNode->GetBroadcastDimension(),
+                                                                                                                               activationNode->GetOutputMemoryLayout(),
+                                                                                                                               activationNode->GetFunction());
+            transformer.MapNodeOutput(activationNode->output, newNode->output);
+            Log() << "Fused " << ActivationFunctionType::GetTypeName() << " [id = " << activationNode->GetId().ToString() << "] into BroadcastLinearFunctionNode [id = "
+                  << sourceNode.GetId().ToString() << "], removing " << GetElementwiseMemoryTraffic<ValueType>(activationNode->GetInputMemoryLayout(), activationNode->GetOutputMemoryLayout()) << " bytes of memory traffic" << EOL;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryFoldLayerOperations(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            return TryFoldScaleIntoLayer<ValueType>(node, transformer) ||
+                   TryFuseActivation<ValueType, nodes::ReLUActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivation<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivation<ValueType, nodes::HardSigmoidActivationFunction<ValueType>>(node, transformer);
+        }
+
+        void FoldLayerOperations(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            if (TryFoldLayerOperations<float>(node, transformer))
+            {
+                return;
+            }
+            if (TryFoldLayerOperations<double>(node, transformer))
+            {
+                return;
+            }
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // FoldLayerOperationsPass methods
+    //
+    void FoldLayerOperationsPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        FoldLayerOperations(node, context.GetTransformer());
+    }
+
+    void FoldLayerOperationsPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "FoldLayerOperationsPass",
+            [](const model::ModelOptimizerOptions& settings) { return settings.phase == model::OptimizerPhase::optimize && settings.foldLayerOperations; },
+            []() { return std::make_unique<FoldLayerOperationsPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseElementwiseOperationsPass.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FuseElementwiseOperationsPass.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <model/optimizer/include/OptimizationPassRegistry.h>
+
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/FusedElementwiseNode.h>
+#include <nodes/include/TypeCastNode.h>
+#include <nodes/include/UnaryOperationNode.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    //
+    // Implementation
+    //
+    namespace
+    {
+        // The arguments of a FusedElementwiseNode
+        template <typename ValueType>
+        struct ElementwiseChain
+        {
+            const model::OutputPort<ValueType>* input = nullptr;
+            std::vector<const model::OutputPort<ValueType>*> secondaryInputs;
+            std::vector<nodes::ElementwiseStage> stages;
+            int broadcastSize = 1;
+            int broadcastStride = 1;
+        };
+
+        // Returns the port an input port of a node is connected to, in the model the chain is being built in
+        template <typename ValueType>
+        using PortMapper = std::function<const model::OutputPort<ValueType>&(const model::InputPort<ValueType>&)>;
+
+        //
+        // Functions
+        //
+        bool IsFusableUnaryOperation(emitters::UnaryOperationType operation)
+        {
+            switch (operation)
+            {
+            case emitters::UnaryOperationType::sqrt:
+            case emitters::UnaryOperationType::exp:
+            case emitters::UnaryOperationType::log:
+            case emitters::UnaryOperationType::square:
+            case emitters::UnaryOperationType::tanh:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool IsFusableBinaryOperation(emitters::BinaryOperationType operation)
+        {
+            switch (operation)
+            {
+            case emitters::BinaryOperationType::add:
+            case emitters::BinaryOperationType::subtract:
+            case emitters::BinaryOperationType::coordinatewiseMultiply:
+            case emitters::BinaryOperationType::coordinatewiseDivide:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool HasLinearFunction(const std::vector<nodes::ElementwiseStage>& stages)
+        {
+            return std::any_of(stages.begin(), stages.end(), [](const nodes::ElementwiseStage& stage) { return stage.type == nodes::ElementwiseStageType::linearFunction; });
+        }
+
+        template <typename ValueType>
+        int AddSecondaryInput(ElementwiseChain<ValueType>& chain, const model::OutputPort<ValueType>& port)
+        {
+            chain.secondaryInputs.push_back(&port);
+            return static_cast<int>(chain.secondaryInputs.size()) - 1;
+        }
+
+        // Returns the input of an elementwise node that a chain continues through, or nullptr if it isn't an elementwise node
+        template <typename ValueType>
+        const model::InputPort<ValueType>* GetChainInput(const model::Node& node)
+        {
+            if (auto unaryNode = dynamic_cast<const nodes::UnaryOperationNode<ValueType>*>(&node))
+            {
+                return &unaryNode->input;
+            }
+            if (auto binaryNode = dynamic_cast<const nodes::BinaryOperationNode<ValueType>*>(&node))
+            {
+                return &binaryNode->input1;
+            }
+            if (auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node))
+            {
+                return &linearNode->primaryInput;
+            }
+            return nullptr;
+        }
+
+        // Appends the operation of an elementwise node to a chain whose value is the node's input `chainInput`, or returns false if
+        // it can't be computed elementwise on the chain's memory. A type cast only changes the output type, so it adds no operation.
+        template <typename ValueType>
+        bool AppendStage(const model::Node& node, const model::InputPort<ValueType>& chainInput, const PortMapper<ValueType>& getPort, ElementwiseChain<ValueType>& chain)
+        {
+            const auto size = chainInput.Size();
+            nodes::ElementwiseStage stage;
+            if (auto unaryNode = dynamic_cast<const nodes::UnaryOperationNode<ValueType>*>(&node))
+            {
+                if (!IsFusableUnaryOperation(unaryNode->GetOperation()))
+                {
+                    return false;
+                }
+                stage.type = nodes::ElementwiseStageType::unaryOperation;
+                stage.unaryOperation = unaryNode->GetOperation();
+            }
+            else if (auto binaryNode = dynamic_cast<const nodes::BinaryOperationNode<ValueType>*>(&node))
+            {
+                // Both inputs and the output must be laid out the same way, so the operands are at the same offset in memory
+                auto layout = binaryNode->GetOutputMemoryLayout();
+                if (!IsFusableBinaryOperation(binaryNode->GetOperation()) || layout.HasPadding() || layout.GetMemorySize() != size ||
+                    binaryNode->GetInputMemoryLayout1() != layout || binaryNode->GetInputMemoryLayout2() != layout)
+                {
+                    return false;
+                }
+
+                // The other operand must be computed outside of the chain
+                stage.isRightOperand = &chainInput == &binaryNode->input2;
+                const auto& operand = stage.isRightOperand ? binaryNode->input1 : binaryNode->input2;
+                if (operand.Size() != size || operand.GetReferencedPort().GetNode() == chainInput.GetReferencedPort().GetNode())
+                {
+                    return false;
+                }
+                stage.type = nodes::ElementwiseStageType::binaryOperation;
+                stage.binaryOperation = binaryNode->GetOperation();
+                stage.secondaryInput1 = AddSecondaryInput(chain, getPort(operand));
+            }
+            else if (auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node))
+            {
+                const auto& layout = linearNode->GetInputMemoryLayout();
+                if (layout != linearNode->GetOutputMemoryLayout() || layout.HasPadding() || layout.GetMemorySize() != size)
+                {
+                    return false;
+                }
+
+                // The coefficients are indexed by the broadcast dimension, which every linear function in the chain must share
+                const auto broadcastDimension = static_cast<int>(linearNode->GetBroadcastDimension());
+                auto broadcastSize = layout.GetExtent(broadcastDimension);
+                auto broadcastStride = 1;
+                for (int dimension = broadcastDimension + 1; dimension < layout.NumDimensions(); ++dimension)
+                {
+                    broadcastStride *= layout.GetExtent(dimension);
+                }
+                if (HasLinearFunction(chain.stages) && (broadcastSize != chain.broadcastSize || broadcastStride != chain.broadcastStride))
+                {
+                    return false;
+                }
+                chain.broadcastSize = broadcastSize;
+                chain.broadcastStride = broadcastStride;
+
+                stage.type = nodes::ElementwiseStageType::linearFunction;
+                if (linearNode->secondaryInput1.Size() != 0)
+                {
+                    stage.secondaryInput1 = AddSecondaryInput(chain, getPort(linearNode->secondaryInput1));
+                }
+                if (linearNode->secondaryInput2.Size() != 0)
+                {
+                    stage.secondaryInput2 = AddSecondaryInput(chain, getPort(linearNode->secondaryInput2));
+                }
+            }
+            else
+            {
+                return dynamic_cast<const nodes::TypeCastNode<ValueType, float>*>(&node) != nullptr || dynamic_cast<const nodes::TypeCastNode<ValueType, double>*>(&node) != nullptr;
+            }
+
+            chain.stages.push_back(stage);
+            return true;
+        }
+
+        // Gets the chain computed by a node of the new model, or returns false if it isn't an elementwise node
+        template <typename ValueType>
+        bool GetChain(const model::Node& node, ElementwiseChain<ValueType>& chain)
+        {
+            if (auto fusedNode = dynamic_cast<const nodes::FusedElementwiseNode<ValueType>*>(&node))
+            {
+                chain.input = &fusedNode->input.GetReferencedPort();
+                for (size_t index = 0; index < fusedNode->NumSecondaryInputs(); ++index)
+                {
+                    chain.secondaryInputs.push_back(&fusedNode->GetSecondaryInput(index).GetReferencedPort());
+                }
+                chain.stages = fusedNode->GetStages();
+                chain.broadcastSize = fusedNode->GetBroadcastSize();
+                chain.broadcastStride = fusedNode->GetBroadcastStride();
+                return true;
+            }
+
+            auto chainInput = GetChainInput<ValueType>(node);
+            if (chainInput == nullptr)
+            {
+                return false;
+            }
+            chain.input = &chainInput->GetReferencedPort();
+            return AppendStage<ValueType>(node, *chainInput, [](const model::InputPort<ValueType>& port) -> const model::OutputPort<ValueType>& { return port.GetReferencedPort(); }, chain);
+        }
+
+        // returns 'true' if we fused `node` with the node computing its input `chainInput`, else 'false'
+        template <typename ValueType, typename OutputValueType>
+        bool TryFuseWithSource(const model::Node& node, const model::InputPort<ValueType>& chainInput, const model::OutputPort<OutputValueType>& output, model::ModelTransformer& transformer)
+        {
+            // The source's output is only computed in registers by the fused node, so nothing else may be using it
+            const auto& sourceNode = *chainInput.GetReferencedPort().GetNode();
+            if (sourceNode.GetDependentNodes().size() != 1)
+            {
+                return false;
+            }
+
+            ElementwiseChain<ValueType> chain;
+            const auto& newSourceOutput = transformer.GetCorrespondingInputs(chainInput);
+            if (!GetChain(*newSourceOutput.GetNode(), chain))
+            {
+                return false;
+            }
+
+            if (!AppendStage<ValueType>(node, chainInput, [&transformer](const model::InputPort<ValueType>& port) -> const model::OutputPort<ValueType>& { return transformer.GetCorrespondingInputs(port); }, chain))
+            {
+                return false;
+            }
+
+            auto newNode = transformer.AddNode<nodes::FusedElementwiseNode<ValueType, OutputValueType>>(*chain.input, chain.secondaryInputs, chain.stages, chain.broadcastSize, chain.broadcastStride, output.GetMemoryLayout());
+            transformer.MapNodeOutput(output, newNode->output);
+            Log() << "Fused " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "] into the loop of " << sourceNode.GetRuntimeTypeName()
+                  << " [id = " << sourceNode.GetId().ToString() << "], removing " << 2 * chainInput.Size() * sizeof(ValueType) << " bytes of memory traffic" << EOL;
+            return true;
+        }
+
+        template <typename ValueType, typename OutputValueType>
+        bool TryFuseTypeCast(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            auto castNode = dynamic_cast<const nodes::TypeCastNode<ValueType, OutputValueType>*>(&node);
+            return castNode != nullptr && TryFuseWithSource(node, castNode->input, castNode->output, transformer);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes
+        template <typename ValueType>
+        bool TryFuseElementwiseOperations(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            if (auto unaryNode = dynamic_cast<const nodes::UnaryOperationNode<ValueType>*>(&node))
+            {
+                return TryFuseWithSource(node, unaryNode->input, unaryNode->output, transformer);
+            }
+            if (auto binaryNode = dynamic_cast<const nodes::BinaryOperationNode<ValueType>*>(&node))
+            {
+                return TryFuseWithSource(node, binaryNode->input1, binaryNode->output, transformer) ||
+                       TryFuseWithSource(node, binaryNode->input2, binaryNode->output, transformer);
+            }
+            if (auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node))
+            {
+                return TryFuseWithSource(node, linearNode->primaryInput, linearNode->output, transformer);
+            }
+            return TryFuseTypeCast<ValueType, float>(node, transformer) || TryFuseTypeCast<ValueType, double>(node, transformer);
+        }
+
+        void FuseElementwiseOperations(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            if (TryFuseElementwiseOperations<float>(node, transformer))
+            {
+                return;
+            }
+            if (TryFuseElementwiseOperations<double>(node, transformer))
+            {
+                return;
+            }
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // FuseElementwiseOperationsPass methods
+    //
+    void FuseElementwiseOperationsPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        FuseElementwiseOperations(node, context.GetTransformer());
+    }
+
+    void FuseElementwiseOperationsPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "FuseElementwiseOperationsPass",
+            [](const model::ModelOptimizerOptions& settings) { return settings.phase == model::OptimizerPhase::optimize && settings.fuseElementwiseOperations; },
+            []() { return std::make_unique<FuseElementwiseOperationsPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+} // namespace passes
+} // namespace ell
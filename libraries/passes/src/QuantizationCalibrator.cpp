@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizationCalibrator.h"
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace passes
+{
+    template <typename ValueType>
+    void QuantizationCalibrator::UpdateNodes(const model::Model& model)
+    {
+        for (auto node : model.GetNodesByType<nodes::MatrixVectorMultiplyNode<ValueType>>())
+        {
+            if (dynamic_cast<const nodes::ConstantNode<ValueType>*>(node->inputMatrix.GetReferencedPort().GetNode()) == nullptr)
+            {
+                continue;
+            }
+
+            auto& range = _ranges[node->GetId()];
+            for (auto value : node->inputVector.GetValue())
+            {
+                range = std::max(range, std::abs(static_cast<double>(value)));
+            }
+        }
+
+        for (auto node : model.GetNodesByType<nodes::ConvolutionalLayerNode<ValueType>>())
+        {
+            auto& range = _ranges[node->GetId()];
+            for (auto value : node->input.GetValue())
+            {
+                range = std::max(range, std::abs(static_cast<double>(value)));
+            }
+        }
+    }
+
+    void QuantizationCalibrator::Update(const model::Map& map)
+    {
+        const auto& model = map.GetModel();
+        UpdateNodes<float>(model);
+        UpdateNodes<double>(model);
+        ++_numExamples;
+    }
+} // namespace passes
+} // namespace ell
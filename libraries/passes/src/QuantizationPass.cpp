@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationPass.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizationPass.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorMultiplyNode.h>
+#include <nodes/include/ReorderDataNode.h>
+
+#include <utilities/include/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    //
+    // Implementation
+    //
+    namespace
+    {
+        // Symmetric quantization, with a scale per row of the matrix
+        template <typename ValueType>
+        void QuantizeRows(const std::vector<ValueType>& matrix, size_t numRows, size_t numColumns, std::vector<int8_t>& weights, std::vector<ValueType>& weightScales)
+        {
+            const auto maxValue = static_cast<double>(nodes::maxQuantizedValue);
+            weights.resize(matrix.size());
+            weightScales.resize(numRows);
+            for (size_t row = 0; row < numRows; ++row)
+            {
+                auto rowBegin = matrix.begin() + row * numColumns;
+                double rowMax = 0;
+                std::for_each(rowBegin, rowBegin + numColumns, [&rowMax](ValueType value) { rowMax = std::max(rowMax, std::abs(static_cast<double>(value))); });
+                const double scale = rowMax > 0 ? rowMax / maxValue : 1.0;
+                for (size_t column = 0; column < numColumns; ++column)
+                {
+                    auto quantizedValue = std::round(static_cast<double>(matrix[row * numColumns + column]) / scale);
+                    weights[row * numColumns + column] = static_cast<int8_t>(std::min(std::max(quantizedValue, -maxValue), maxValue));
+                }
+                weightScales[row] = static_cast<ValueType>(scale);
+            }
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeMatrixVectorMultiply(const model::Node& node, const ActivationRanges& ranges, model::ModelTransformer& transformer)
+        {
+            auto multiplyNode = dynamic_cast<const nodes::MatrixVectorMultiplyNode<ValueType>*>(&node);
+            if (multiplyNode == nullptr)
+            {
+                return false;
+            }
+
+            auto matrixNode = dynamic_cast<const nodes::ConstantNode<ValueType>*>(multiplyNode->inputMatrix.GetReferencedPort().GetNode());
+            auto rangeIter = ranges.find(node.GetId());
+            const auto numRows = multiplyNode->NumRows();
+            const auto numColumns = multiplyNode->NumColumns();
+            if (matrixNode == nullptr || rangeIter == ranges.end() || !(rangeIter->second > 0) || multiplyNode->GetMatrixStride() != numColumns || matrixNode->GetValues().size() != numRows * numColumns)
+            {
+                return false;
+            }
+
+            const auto& matrix = matrixNode->GetValues();
+            std::vector<int8_t> weights;
+            std::vector<ValueType> weightScales;
+            QuantizeRows(matrix, numRows, numColumns, weights, weightScales);
+            const auto inputScale = static_cast<ValueType>(rangeIter->second / nodes::maxQuantizedValue);
+
+            const auto& newInput = transformer.GetCorrespondingInputs(multiplyNode->inputVector);
+            auto newNode = transformer.AddNode<nodes::QuantizedMatrixVectorMultiplyNode<ValueType>>(newInput, numRows, numColumns, std::move(weights), std::move(weightScales), inputScale);
+            transformer.MapNodeOutput(multiplyNode->output, newNode->output);
+            Log() << "Quantized MatrixVectorMultiplyNode [id = " << node.GetId().ToString() << "] to int8, shrinking its weights from "
+                  << matrix.size() * sizeof(ValueType) << " to " << matrix.size() + numRows * sizeof(ValueType) << " bytes" << EOL;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeConvolutionalLayer(const model::Node& node, const ActivationRanges& ranges, model::ModelTransformer& transformer)
+        {
+            auto convNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (convNode == nullptr)
+            {
+                return false;
+            }
+
+            // The quantized node works in row-major order, so reorder the input and output around it, as the
+            // floating-point convolutions do
+            const auto& originalInputLayout = convNode->GetInputMemoryLayout();
+            const auto originalOutputLayout = convNode->GetOutputMemoryLayout();
+            const auto convInputLayout = originalInputLayout.ReorderedCopy({ utilities::RowMajorTensorOrder });
+            const auto outputRows = originalOutputLayout.GetLogicalDimensionActiveSize(0);
+            const auto outputColumns = originalOutputLayout.GetLogicalDimensionActiveSize(1);
+            const auto numFilters = originalOutputLayout.GetLogicalDimensionActiveSize(2);
+            const model::PortMemoryLayout convOutputLayout(model::MemoryShape{ outputRows, outputColumns, numFilters });
+
+            // Depthwise-separable convolutions and layouts that `QuantizedConvolutionNode` can't read are left in floating point
+            const auto& filterWeights = convNode->GetLayer().GetWeights();
+            const auto filterSize = static_cast<int>(filterWeights.NumColumns());
+            const auto stride = static_cast<int>(convNode->GetLayer().GetConvolutionalParameters().stride);
+            const auto numChannels = convInputLayout.GetExtent(2);
+            auto rangeIter = ranges.find(node.GetId());
+            if (rangeIter == ranges.end() || !(rangeIter->second > 0) ||
+                convInputLayout.GetOffset(2) != 0 || convInputLayout.GetActiveSize(2) != numChannels || static_cast<int>(filterWeights.NumChannels()) != numChannels ||
+                static_cast<int>(filterWeights.NumRows()) != numFilters * filterSize ||
+                (outputRows - 1) * stride + filterSize > convInputLayout.GetExtent(0) || (outputColumns - 1) * stride + filterSize > convInputLayout.GetExtent(1))
+            {
+                return false;
+            }
+
+            // Each filter is `filterSize` rows of the weights tensor, which in (row, column, channel) order is a row of this matrix
+            const auto filterVolume = static_cast<size_t>(filterSize * filterSize * numChannels);
+            const auto matrix = filterWeights.ReferenceAsMatrix().ToArray();
+            std::vector<int8_t> weights;
+            std::vector<ValueType> weightScales;
+            QuantizeRows(matrix, numFilters, filterVolume, weights, weightScales);
+            const auto inputScale = static_cast<ValueType>(rangeIter->second / nodes::maxQuantizedValue);
+
+            const auto& newInput = transformer.GetCorrespondingInputs(convNode->input);
+            auto preConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(newInput, originalInputLayout, convInputLayout);
+            auto quantizedNode = transformer.AddNode<nodes::QuantizedConvolutionNode<ValueType>>(preConvReorderNode->output, convInputLayout, convOutputLayout, filterSize, stride, std::move(weights), std::move(weightScales), inputScale);
+            auto postConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(quantizedNode->output, convOutputLayout, originalOutputLayout);
+            transformer.MapNodeOutput(convNode->output, postConvReorderNode->output);
+            Log() << "Quantized ConvolutionalLayerNode [id = " << node.GetId().ToString() << "] to int8, shrinking its weights from "
+                  << matrix.size() * sizeof(ValueType) << " to " << matrix.size() + numFilters * sizeof(ValueType) << " bytes" << EOL;
+            return true;
+        }
+
+        void Quantize(const model::Node& node, const ActivationRanges& ranges, model::ModelTransformer& transformer)
+        {
+            if (TryQuantizeMatrixVectorMultiply<float>(node, ranges, transformer))
+            {
+                return;
+            }
+            if (TryQuantizeMatrixVectorMultiply<double>(node, ranges, transformer))
+            {
+                return;
+            }
+            if (TryQuantizeConvolutionalLayer<float>(node, ranges, transformer))
+            {
+                return;
+            }
+            if (TryQuantizeConvolutionalLayer<double>(node, ranges, transformer))
+            {
+                return;
+            }
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // QuantizationPass methods
+    //
+    QuantizationPass::QuantizationPass(ActivationRanges ranges) :
+        _ranges(std::move(ranges))
+    {
+    }
+
+    void QuantizationPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        Quantize(node, _ranges, context.GetTransformer());
+    }
+} // namespace passes
+} // namespace ell
@@ -7,7 +7,11 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SetConvolutionMethodPass.h"
+#include "ConvolutionTuningDatabase.h"
 
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
 #include <model/include/ModelTransformer.h>
 
 #include <model/optimizer/include/OptimizationPassRegistry.h>
@@ -17,13 +21,25 @@
 #include <predictors/neural/include/ConvolutionalLayer.h>
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 namespace ell
 {
 namespace passes
 {
+    using namespace utilities::logging;
+
     namespace
     {
+        // The number of timed runs of each candidate convolution; the fastest is used
+        const int numTimingRuns = 10;
+
         predictors::neural::ConvolutionMethod GetConvolutionMethod(model::PreferredConvolutionMethod preferredMethod)
         {
             switch (preferredMethod)
@@ -57,6 +73,226 @@ namespace passes
             return true;
         }
 
+        bool IsHostTarget(const emitters::TargetDevice& targetDevice)
+        {
+            return targetDevice.deviceName == "host" || (targetDevice.deviceName.empty() && targetDevice.triple.empty());
+        }
+
+        // Every compatible method, with each Winograd tile size. The simple method comes first, so its output can serve as the reference.
+        std::vector<predictors::neural::ConvolutionalParameters> GetCandidateParameters(const predictors::neural::ConvolutionalParameters& convolutionalParameters)
+        {
+            using predictors::neural::ConvolutionMethod;
+
+            std::vector<predictors::neural::ConvolutionalParameters> candidates;
+            for (auto method : { ConvolutionMethod::simple, ConvolutionMethod::unrolled, ConvolutionMethod::diagonal, ConvolutionMethod::winograd })
+            {
+                auto candidate = convolutionalParameters;
+                candidate.method = method;
+                candidate.winogradTileSize = 0;
+                if (!IsMethodCompatible(method, candidate))
+                {
+                    continue;
+                }
+
+                if (method == ConvolutionMethod::winograd)
+                {
+                    for (size_t tileSize : { 2, 4 })
+                    {
+                        candidate.winogradTileSize = tileSize;
+                        candidates.push_back(candidate);
+                    }
+                }
+                else
+                {
+                    candidates.push_back(candidate);
+                }
+            }
+            return candidates;
+        }
+
+        // The options to compile a single candidate layer with: the layer's own method, and nothing written to disk
+        model::MapCompilerOptions GetCandidateCompilerOptions(const model::MapCompilerOptions& settings)
+        {
+            auto candidateSettings = settings;
+            candidateSettings.moduleName = "ConvolutionAutotune";
+            candidateSettings.optimizerSettings.preferredConvolutionMethod = model::PreferredConvolutionMethod::automatic;
+            candidateSettings.objectCacheDirectory.clear();
+            candidateSettings.profile = false;
+            candidateSettings.compilerSettings.profile = false;
+            candidateSettings.emitBatchPredict = false;
+            return candidateSettings;
+        }
+
+        template <typename ValueType>
+        bool IsCloseTo(const std::vector<ValueType>& a, const std::vector<ValueType>& b)
+        {
+            const ValueType tolerance = static_cast<ValueType>(1e-3);
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t index = 0; index < a.size(); ++index)
+            {
+                if (std::abs(a[index] - b[index]) > tolerance * (1 + std::abs(a[index])))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Compiles a map evaluating just `layer`, runs it on `input` and returns the fastest of several runs, in milliseconds
+        template <typename ValueType>
+        double TimeConvolution(const predictors::neural::ConvolutionalLayer<ValueType>& layer, const model::MapCompilerOptions& settings, const std::vector<ValueType>& input, std::vector<ValueType>& output)
+        {
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<ValueType>>(input.size());
+            auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, layer);
+            model::Map map(model, { { "input", inputNode } }, { { "output", convolutionNode->output } });
+
+            model::IRMapCompiler compiler(settings);
+            auto compiledMap = compiler.Compile(map);
+            compiledMap.SetInputValue(0, input);
+            output = compiledMap.ComputeOutput<ValueType>(0); // the first run includes JIT compilation, so isn't timed
+
+            double fastestTime = std::numeric_limits<double>::max();
+            for (int run = 0; run < numTimingRuns; ++run)
+            {
+                auto start = std::chrono::steady_clock::now();
+                compiledMap.ComputeOutput<ValueType>(0);
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                fastestTime = std::min(fastestTime, elapsed.count());
+            }
+            return fastestTime;
+        }
+
+        // Times every compatible method for `layer` on the host, returning 'false' if none of them work
+        template <typename ValueType>
+        bool MeasureConvolutionMethods(const predictors::neural::ConvolutionalLayer<ValueType>& layer, const model::MapCompilerOptions& settings, ConvolutionTuningResult& result)
+        {
+            const auto& inputTensor = layer.GetLayerParameters().input;
+            std::vector<ValueType> input(inputTensor.NumRows() * inputTensor.NumColumns() * inputTensor.NumChannels());
+            for (size_t index = 0; index < input.size(); ++index)
+            {
+                input[index] = static_cast<ValueType>(index % 17) / 8 - 1;
+            }
+
+            std::vector<ValueType> referenceOutput;
+            result.milliseconds = std::numeric_limits<double>::max();
+            for (const auto& candidate : GetCandidateParameters(layer.GetConvolutionalParameters()))
+            {
+                auto name = GetConvolutionMethodName(candidate.method) + (candidate.winogradTileSize != 0 ? " (tile size " + std::to_string(candidate.winogradTileSize) + ")" : "");
+                std::vector<ValueType> output;
+                double time = 0;
+                try
+                {
+                    predictors::neural::ConvolutionalLayer<ValueType> candidateLayer = { layer.GetLayerParameters(), candidate, layer.GetWeights() };
+                    time = TimeConvolution(candidateLayer, settings, input, output);
+                }
+                catch (const std::exception& exception)
+                {
+                    Log() << "  " << name << ": failed (" << exception.what() << ")" << EOL;
+                    continue;
+                }
+
+                if (referenceOutput.empty())
+                {
+                    referenceOutput = output;
+                }
+                else if (!IsCloseTo(referenceOutput, output))
+                {
+                    Log() << "  " << name << ": wrong result" << EOL;
+                    continue;
+                }
+
+                Log() << "  " << name << ": " << time << " ms" << EOL;
+                if (time < result.milliseconds)
+                {
+                    result.method = candidate.method;
+                    result.winogradTileSize = candidate.winogradTileSize;
+                    result.milliseconds = time;
+                }
+            }
+            return !referenceOutput.empty();
+        }
+
+        // Finds the fastest method for `layer` in the tuning database, or measures it if it's not there.
+        // Returns 'false' if there's no result and the target can't be measured.
+        template <typename ValueType>
+        bool GetTunedConvolutionMethod(const predictors::neural::ConvolutionalLayer<ValueType>& layer, const model::MapCompilerOptions& settings, ConvolutionTuningResult& result)
+        {
+            auto candidateSettings = GetCandidateCompilerOptions(settings);
+            const auto& databaseFilename = settings.optimizerSettings.convolutionTuningDatabase;
+
+            // The compiler fills in the target device's properties
+            auto targetKey = ConvolutionTuningDatabase::GetTargetKey(model::IRMapCompiler(candidateSettings).GetCompilerOptions().targetDevice);
+            auto shapeKey = ConvolutionTuningDatabase::GetShapeKey(layer);
+
+            ConvolutionTuningDatabase database;
+            if (!databaseFilename.empty())
+            {
+                database.Load(databaseFilename);
+            }
+            if (auto entry = database.Find(targetKey, shapeKey))
+            {
+                result = *entry;
+                Log() << "Using tuned convolution method " << GetConvolutionMethodName(result.method) << " for " << shapeKey << " on " << targetKey << EOL;
+                return true;
+            }
+
+            // Only code compiled for the host can be run
+            if (!IsHostTarget(settings.compilerSettings.targetDevice))
+            {
+                Log() << "No tuned convolution method for " << shapeKey << " on " << targetKey << "; keeping the layer's method" << EOL;
+                return false;
+            }
+
+            Log() << "Tuning convolution method for " << shapeKey << " on " << targetKey << EOL;
+            if (!MeasureConvolutionMethods(layer, candidateSettings, result))
+            {
+                return false;
+            }
+            Log() << "Fastest convolution method: " << GetConvolutionMethodName(result.method) << EOL;
+
+            if (!databaseFilename.empty())
+            {
+                // Reload first, to keep results another compile may have added in the meantime
+                ConvolutionTuningDatabase updatedDatabase;
+                updatedDatabase.Load(databaseFilename);
+                updatedDatabase.Set(targetKey, shapeKey, result);
+                updatedDatabase.Save(databaseFilename);
+            }
+            return true;
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryAutotuneConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, const model::MapCompilerOptions& settings)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& layer = thisNode->GetLayer();
+            ConvolutionTuningResult result;
+            if (!GetTunedConvolutionMethod(layer, settings, result))
+            {
+                return false;
+            }
+
+            auto convolutionalParameters = layer.GetConvolutionalParameters();
+            convolutionalParameters.method = result.method;
+            convolutionalParameters.winogradTileSize = result.winogradTileSize;
+            predictors::neural::ConvolutionalLayer<ValueType> newLayer = { layer.GetLayerParameters(), convolutionalParameters, layer.GetWeights() };
+
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            auto newNode = transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer);
+            transformer.MapNodeOutput(thisNode->output, newNode->output);
+            return true;
+        }
+
         // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
         template <typename ValueType>
         bool TrySetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
@@ -87,9 +323,21 @@ namespace passes
             return true;
         }
 
-        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
+        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, const model::MapCompilerOptions& settings)
         {
-            if (preferredMethod != model::PreferredConvolutionMethod::automatic)
+            auto preferredMethod = settings.optimizerSettings.preferredConvolutionMethod;
+            if (preferredMethod == model::PreferredConvolutionMethod::autotune)
+            {
+                if (TryAutotuneConvolutionMethod<float>(node, transformer, settings))
+                {
+                    return;
+                }
+                if (TryAutotuneConvolutionMethod<double>(node, transformer, settings))
+                {
+                    return;
+                }
+            }
+            else if (preferredMethod != model::PreferredConvolutionMethod::automatic)
             {
                 if (TrySetConvolutionMethod<float>(node, transformer, preferredMethod))
                 {
@@ -110,8 +358,7 @@ namespace passes
     //
     void SetConvolutionMethodPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
     {
-        auto preferredMethod = settings.optimizerSettings.preferredConvolutionMethod;
-        SetConvolutionMethod(node, context.GetTransformer(), preferredMethod);
+        SetConvolutionMethod(node, context.GetTransformer(), settings);
     }
 
     void SetConvolutionMethodPass::AddToRegistry()
@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "FoldLayerOperationsPass.h"
+#include "FuseElementwiseOperationsPass.h"
 #include "FuseLinearOperationsPass.h"
 #include "OptimizeReorderDataNodes.h"
 #include "SetConvolutionMethodPass.h"
@@ -26,6 +28,8 @@ namespace passes
     {
         SetConvolutionMethodPass::AddToRegistry();
         FuseLinearOperationsPass::AddToRegistry();
+        FoldLayerOperationsPass::AddToRegistry();
+        FuseElementwiseOperationsPass::AddToRegistry();
         OptimizeReorderDataNodes::AddToRegistry();
     }
 } // namespace passes
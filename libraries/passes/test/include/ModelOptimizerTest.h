@@ -9,6 +9,10 @@
 #pragma once
 
 void TestFuseLinearOpsPasses();
+void TestFoldLayerOperationsPass();
+void TestFuseElementwiseOperationsPass();
+void TestConvolutionAutotune();
+void TestQuantizationPass();
 
 void TestOptimizeReorderDataNodes1();
 void TestOptimizeReorderDataNodes2();
@@ -8,6 +8,8 @@
 
 // #include "ModelTestUtilities.h"
 
+#include <common/include/LoadModel.h> // for RegisterNodeTypes
+
 #include <model/optimizer/include/ModelOptimizer.h>
 
 #include <model/include/IRMapCompiler.h>
@@ -16,18 +18,40 @@
 #include <model/include/MapCompilerOptions.h>
 #include <model/include/PortMemoryLayout.h>
 
+#include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/CompiledActivationFunctions.h>
 #include <nodes/include/ConstantNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FusedElementwiseNode.h>
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorMultiplyNode.h>
 #include <nodes/include/ReorderDataNode.h>
+#include <nodes/include/TypeCastNode.h>
+#include <nodes/include/UnaryOperationNode.h>
 
+#include <passes/include/ConvolutionTuningDatabase.h>
+#include <passes/include/FoldLayerOperationsPass.h>
+#include <passes/include/FuseElementwiseOperationsPass.h>
 #include <passes/include/FuseLinearOperationsPass.h>
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/QuantizationPass.h>
 #include <passes/include/StandardPasses.h>
 
+#include <predictors/neural/include/ConvolutionalLayer.h>
+
 #include <testing/include/testing.h>
 
+#include <utilities/include/Files.h>
+#include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MillisecondTimer.h>
+
 #include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 
 // set to 1 to print models
 #define PRINT_MODELS 0
@@ -109,6 +133,408 @@ model::Map GenerateTestModel(const model::PortMemoryLayout& inputLayout, const m
     return map;
 }
 
+// Adds a linear function with a scale and bias per channel after `input`
+template <typename ValueType>
+const model::OutputPort<ValueType>& AddScaleAndBias(model::Model& model, const model::OutputPort<ValueType>& input, const model::PortMemoryLayout& layout)
+{
+    auto numChannels = layout.GetActiveSize(2);
+    std::vector<ValueType> scaleValues(numChannels);
+    std::vector<ValueType> biasValues(numChannels);
+    std::generate(scaleValues.begin(), scaleValues.end(), Increment<ValueType>(0.5, 0.25));
+    std::generate(biasValues.begin(), biasValues.end(), Increment<ValueType>(-1, 0.5));
+    auto scaleNode = model.AddNode<nodes::ConstantNode<ValueType>>(scaleValues);
+    auto biasNode = model.AddNode<nodes::ConstantNode<ValueType>>(biasValues);
+    auto linearNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(input, layout, scaleNode->output, biasNode->output, 2, layout);
+    return linearNode->output;
+}
+
+// matrix-vector multiply -> scale and bias -> ReLU
+template <typename ValueType>
+model::Map GenerateFullyConnectedTestModel(int numInputs, int numOutputs)
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(numInputs);
+    std::vector<ValueType> weights(numInputs * numOutputs);
+    std::generate(weights.begin(), weights.end(), Increment<ValueType>(-2, 0.25));
+    auto weightsNode = model.AddNode<nodes::ConstantNode<ValueType>>(weights);
+    auto multiplyNode = model.AddNode<nodes::MatrixVectorMultiplyNode<ValueType>>(weightsNode->output, numOutputs, numInputs, numInputs, inputNode->output);
+
+    model::PortMemoryLayout layout({ 1, 1, numOutputs });
+    const auto& linearOutput = AddScaleAndBias(model, multiplyNode->output, layout);
+    auto activationNode = model.AddNode<nodes::BroadcastUnaryFunctionNode<ValueType, nodes::ReLUActivationFunction<ValueType>>>(linearOutput, layout, layout);
+    return model::Map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+}
+
+// convolution -> scale and bias -> leaky ReLU
+template <typename ValueType>
+model::Map GenerateConvolutionalTestModel(size_t numRows, size_t numColumns, size_t numChannels, size_t numFilters)
+{
+    using namespace predictors::neural;
+    using LayerParameters = typename Layer<ValueType>::LayerParameters;
+    using TensorType = typename Layer<ValueType>::TensorType;
+
+    const size_t receptiveField = 3;
+    const size_t padding = 1;
+    TensorType input(numRows + 2 * padding, numColumns + 2 * padding, numChannels);
+    LayerParameters parameters{ input, ZeroPadding(padding), { numRows, numColumns, numFilters }, NoPadding() };
+    ConvolutionalParameters convolutionalParameters{ receptiveField, 1, ConvolutionMethod::simple, 1 };
+    TensorType weights(numFilters * receptiveField, receptiveField, numChannels);
+    weights.Generate(Increment<ValueType>(-1, 0.125));
+    ConvolutionalLayer<ValueType> layer(parameters, convolutionalParameters, weights);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(input.Size());
+    auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, layer);
+
+    auto layout = convolutionNode->GetOutputMemoryLayout();
+    const auto& linearOutput = AddScaleAndBias(model, convolutionNode->output, layout);
+    auto activationNode = model.AddNode<nodes::BroadcastUnaryFunctionNode<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>>(linearOutput, layout, layout, nodes::LeakyReLUActivationFunction<ValueType>(static_cast<ValueType>(0.1)));
+    return model::Map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+}
+
+template <typename ValueType>
+void TestFoldLayerOperationsPass(const model::Map& map, const std::string& name)
+{
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-3, 0.5));
+
+    // Evaluate it pre-optimization
+    model::Map referenceMap(map);
+    referenceMap.SetInputValue("input", testInput);
+    auto referenceOutput = referenceMap.ComputeOutput<ValueType>("output");
+
+    // Initialize pass registry
+    passes::AddStandardPassesToRegistry();
+
+    // Optimize it: the scale is folded into the weights, and the bias and activation are computed in one node
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::FoldLayerOperationsPass>());
+    model::Map optimizedMap(map);
+    optimizedMap.Optimize(optimizer);
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    auto oldSize = map.GetModel().Size();
+    auto newSize = optimizedMap.GetModel().Size();
+    testing::ProcessTest("Testing folded layer ops count " + name, newSize == oldSize - 1);
+
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing folded layer ops result " + name, testing::IsEqual(referenceOutput, optimizedOutput, static_cast<ValueType>(1e-4)));
+
+    // The fused node must survive being saved and loaded, e.g. by `compile --outputCompiledMap`
+    std::stringstream archivedMap;
+    utilities::JsonArchiver archiver(archivedMap);
+    archiver << optimizedMap;
+    utilities::SerializationContext context;
+    common::RegisterNodeTypes(context);
+    common::RegisterMapTypes(context);
+    utilities::JsonUnarchiver unarchiver(archivedMap, context);
+    model::Map loadedMap;
+    unarchiver >> loadedMap;
+    loadedMap.SetInputValue("input", testInput);
+    auto loadedOutput = loadedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing folded layer ops archive " + name, testing::IsEqual(referenceOutput, loadedOutput, static_cast<ValueType>(1e-4)));
+
+    // Now test the compiled codepath
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled folded layer ops result " + name, testing::IsEqual(referenceOutput, compiledOutput, static_cast<ValueType>(1e-4)));
+}
+
+// scale and bias -> exp -> multiply -> cast to double
+template <typename ValueType>
+model::Map GenerateElementwiseTestModel(const model::PortMemoryLayout& layout, size_t broadcastDimension)
+{
+    auto size = layout.GetMemorySize();
+    auto numCoefficients = layout.GetActiveSize(broadcastDimension);
+    std::vector<ValueType> scaleValues(numCoefficients);
+    std::vector<ValueType> biasValues(numCoefficients);
+    std::vector<ValueType> weights(size);
+    std::generate(scaleValues.begin(), scaleValues.end(), Increment<ValueType>(0.5, 0.25));
+    std::generate(biasValues.begin(), biasValues.end(), Increment<ValueType>(-1, 0.5));
+    std::generate(weights.begin(), weights.end(), Increment<ValueType>(-1, 0.125));
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(size);
+    auto scaleNode = model.AddNode<nodes::ConstantNode<ValueType>>(scaleValues);
+    auto biasNode = model.AddNode<nodes::ConstantNode<ValueType>>(biasValues);
+    auto linearNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(inputNode->output, layout, scaleNode->output, biasNode->output, broadcastDimension, layout);
+    auto expNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(linearNode->output, emitters::UnaryOperationType::exp);
+    auto weightsNode = model.AddNode<nodes::ConstantNode<ValueType>>(weights);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(weightsNode->output, expNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto castNode = model.AddNode<nodes::TypeCastNode<ValueType, double>>(multiplyNode->output);
+    return model::Map(model, { { "input", inputNode } }, { { "output", castNode->output } });
+}
+
+// The number of bytes the nodes that compute something read from and write to their ports on each evaluation
+size_t GetComputedPortBytes(const model::Model& model)
+{
+    auto getPortBytes = [](const model::Port& port, size_t size) -> size_t {
+        switch (port.GetType())
+        {
+        case model::Port::PortType::smallReal:
+        case model::Port::PortType::integer:
+            return 4 * size;
+        case model::Port::PortType::real:
+        case model::Port::PortType::bigInt:
+            return 8 * size;
+        default:
+            return size;
+        }
+    };
+
+    size_t bytes = 0;
+    model.Visit([&](const model::Node& node) {
+        auto typeName = node.GetRuntimeTypeName();
+        if (typeName.find("InputNode") == 0 || typeName.find("ConstantNode") == 0 || typeName.find("OutputNode") == 0)
+        {
+            return;
+        }
+        for (auto input : node.GetInputPorts())
+        {
+            bytes += getPortBytes(*input, input->Size());
+        }
+        for (auto output : node.GetOutputPorts())
+        {
+            bytes += getPortBytes(*output, output->Size());
+        }
+    });
+    return bytes;
+}
+
+template <typename ValueType>
+void TestFuseElementwiseOperationsPass(const model::Map& map, const std::string& name, const model::MapCompilerOptions& settings = {})
+{
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-1, 0.0625));
+
+    // Evaluate it pre-optimization
+    model::Map referenceMap(map);
+    referenceMap.SetInputValue("input", testInput);
+    auto referenceOutput = referenceMap.ComputeOutput<double>("output");
+
+    // Initialize pass registry
+    passes::AddStandardPassesToRegistry();
+
+    // Optimize it: the linear function, exp, multiply and cast are computed by one node
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::FuseElementwiseOperationsPass>());
+    model::Map optimizedMap(map);
+    optimizedMap.Optimize(optimizer);
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto oldSize = map.GetModel().Size();
+    auto newSize = optimizedModel.Size();
+    testing::ProcessTest("Testing fused elementwise ops count " + name, newSize == oldSize - 3 && optimizedModel.GetNodesByType<nodes::FusedElementwiseNode<ValueType, double>>().size() == 1);
+
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<double>("output");
+    testing::ProcessTest("Testing fused elementwise ops result " + name, testing::IsEqual(referenceOutput, optimizedOutput, 1e-4));
+
+    // Now test the compiled codepath
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<double>("output");
+    testing::ProcessTest("Testing compiled fused elementwise ops count " + name, compiledMap.GetModel().GetNodesByType<nodes::FusedElementwiseNode<ValueType, double>>().size() == 1);
+    testing::ProcessTest("Testing compiled fused elementwise ops result " + name, testing::IsEqual(referenceOutput, compiledOutput, 1e-4));
+}
+
+// Compiles the elementwise chain with and without fusion, and prints the bytes its nodes move and the time each evaluation
+// takes. Only the byte counts are checked, since the timings depend on the machine.
+template <typename ValueType>
+void MeasureFuseElementwiseOperationsPass(const model::Map& map, const std::string& name)
+{
+    const int numIterations = 200;
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-1, static_cast<ValueType>(1.0 / testInput.size())));
+
+    struct Measurement
+    {
+        size_t bytes;
+        double milliseconds;
+    };
+    auto measure = [&](bool fuseElementwiseOperations) {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.allowVectorInstructions = true;
+        settings.optimizerSettings.fuseElementwiseOperations = fuseElementwiseOperations;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        // The first evaluation is left out of the timing
+        compiledMap.SetInputValue("input", testInput);
+        compiledMap.ComputeOutput<double>("output");
+        utilities::MillisecondTimer timer;
+        for (int iteration = 0; iteration < numIterations; ++iteration)
+        {
+            compiledMap.SetInputValue("input", testInput);
+            compiledMap.ComputeOutput<double>("output");
+        }
+        auto milliseconds = static_cast<double>(timer.Elapsed()) / numIterations;
+        return Measurement{ GetComputedPortBytes(compiledMap.GetModel()), milliseconds };
+    };
+
+    auto unfused = measure(false);
+    auto fused = measure(true);
+    std::cout << "Elementwise chain " << name << ", " << map.GetInputSize() << " elements:" << std::endl;
+    std::cout << "  unfused: " << unfused.bytes << " bytes through node ports, " << unfused.milliseconds << " ms per evaluation" << std::endl;
+    std::cout << "  fused:   " << fused.bytes << " bytes through node ports, " << fused.milliseconds << " ms per evaluation" << std::endl;
+    std::cout << "  fused relative to unfused: " << static_cast<double>(fused.bytes) / unfused.bytes << "x bytes, "
+              << (unfused.milliseconds > 0 ? fused.milliseconds / unfused.milliseconds : 0.0) << "x time" << std::endl;
+    testing::ProcessTest("Testing fused elementwise ops move fewer bytes " + name, fused.bytes < unfused.bytes);
+}
+
+// Calibrates a map on a few inputs spanning about [-1, 1] and quantizes it
+template <typename ValueType>
+model::Map CalibrateAndQuantize(const model::Map& map)
+{
+    const auto inputSize = map.GetInputSize();
+    model::Map calibrationMap(map);
+    passes::QuantizationCalibrator calibrator;
+    for (int example = 0; example < 4; ++example)
+    {
+        std::vector<ValueType> calibrationInput(inputSize);
+        std::generate(calibrationInput.begin(), calibrationInput.end(), Increment<ValueType>(static_cast<ValueType>(-1 + 0.05 * example), static_cast<ValueType>(2.0 / inputSize)));
+        calibrationMap.SetInputValue("input", calibrationInput);
+        calibrationMap.ComputeOutput<ValueType>("output");
+        calibrator.Update(calibrationMap);
+    }
+
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::QuantizationPass>(calibrator.GetActivationRanges()));
+    model::Map quantizedMap(map);
+    quantizedMap.Optimize(optimizer);
+    return quantizedMap;
+}
+
+// Returns the number of bytes of weights in the quantized nodes of a model, before and after quantization
+template <typename ValueType>
+std::pair<size_t, size_t> GetQuantizedWeightSizes(const model::Model& model)
+{
+    size_t floatSize = 0;
+    size_t quantizedSize = 0;
+    for (auto node : model.GetNodesByType<nodes::QuantizedConvolutionNode<ValueType>>())
+    {
+        floatSize += node->GetWeights().size() * sizeof(ValueType);
+        quantizedSize += node->GetWeights().size() + node->GetWeightScales().size() * sizeof(ValueType);
+    }
+    for (auto node : model.GetNodesByType<nodes::QuantizedMatrixVectorMultiplyNode<ValueType>>())
+    {
+        floatSize += node->GetWeights().size() * sizeof(ValueType);
+        quantizedSize += node->GetWeights().size() + node->GetWeightScales().size() * sizeof(ValueType);
+    }
+    return { floatSize, quantizedSize };
+}
+
+// The quantized nodes must survive being saved and loaded, and compile to the same integer arithmetic as `Compute`,
+// with and without vector instructions
+template <typename ValueType>
+void TestCompiledQuantizedMap(const model::Map& quantizedMap, const std::vector<ValueType>& testInput, const std::string& name)
+{
+    model::Map map(quantizedMap);
+    map.SetInputValue("input", testInput);
+    auto quantizedOutput = map.ComputeOutput<ValueType>("output");
+
+    std::stringstream archivedMap;
+    utilities::JsonArchiver archiver(archivedMap);
+    archiver << map;
+    utilities::SerializationContext context;
+    common::RegisterNodeTypes(context);
+    common::RegisterMapTypes(context);
+    utilities::JsonUnarchiver unarchiver(archivedMap, context);
+    model::Map loadedMap;
+    unarchiver >> loadedMap;
+    loadedMap.SetInputValue("input", testInput);
+    auto loadedOutput = loadedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing quantized map archive " + name, testing::IsEqual(quantizedOutput, loadedOutput, static_cast<ValueType>(1e-4)));
+
+    // 128- and 256-bit registers hold 4 and 8 int32 accumulators
+    passes::AddStandardPassesToRegistry();
+    for (size_t vectorBits : { 0, 128, 256 })
+    {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.allowVectorInstructions = vectorBits > 0;
+        settings.compilerSettings.targetDevice.vectorBits = vectorBits;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        compiledMap.SetInputValue("input", testInput);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+        auto vectorName = vectorBits > 0 ? " (" + std::to_string(vectorBits) + "-bit vectors)" : std::string(" (scalar)");
+        testing::ProcessTest("Testing compiled quantized result " + name + vectorName, testing::IsEqual(quantizedOutput, compiledOutput, static_cast<ValueType>(1e-4)));
+    }
+}
+
+template <typename ValueType>
+void TestQuantizeConvolutionalLayer(const model::Map& map, const std::string& name)
+{
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-1, static_cast<ValueType>(2.0 / testInput.size())));
+    model::Map referenceMap(map);
+    referenceMap.SetInputValue("input", testInput);
+    auto referenceOutput = referenceMap.ComputeOutput<ValueType>("output");
+
+    // The convolution becomes a quantized convolution between reorders into and out of row-major order
+    model::Map quantizedMap = CalibrateAndQuantize<ValueType>(map);
+#if PRINT_MODELS
+    PrintMap(quantizedMap);
+#endif
+    const auto& quantizedModel = quantizedMap.GetModel();
+    testing::ProcessTest("Testing quantized convolution node count " + name, quantizedModel.GetNodesByType<nodes::QuantizedConvolutionNode<ValueType>>().size() == 1 && quantizedModel.GetNodesByType<nodes::ConvolutionalLayerNode<ValueType>>().empty());
+
+    quantizedMap.SetInputValue("input", testInput);
+    auto quantizedOutput = quantizedMap.ComputeOutput<ValueType>("output");
+    auto maxOutput = *std::max_element(referenceOutput.begin(), referenceOutput.end());
+    testing::ProcessTest("Testing quantized convolution result " + name, testing::IsEqual(referenceOutput, quantizedOutput, static_cast<ValueType>(0.02 * maxOutput)));
+
+    TestCompiledQuantizedMap<ValueType>(quantizedMap, testInput, name);
+}
+
+// Times the compiled floating-point and quantized maps
+template <typename ValueType>
+void MeasureQuantizationPass(const model::Map& map, const std::string& name)
+{
+    const int numIterations = 50;
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-1, static_cast<ValueType>(2.0 / testInput.size())));
+
+    auto measure = [&](const model::Map& measuredMap) {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.allowVectorInstructions = true;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(measuredMap);
+
+        // The first evaluation is left out of the timing
+        compiledMap.SetInputValue("input", testInput);
+        compiledMap.ComputeOutput<ValueType>("output");
+        utilities::MillisecondTimer timer;
+        for (int iteration = 0; iteration < numIterations; ++iteration)
+        {
+            compiledMap.SetInputValue("input", testInput);
+            compiledMap.ComputeOutput<ValueType>("output");
+        }
+        return static_cast<double>(timer.Elapsed()) / numIterations;
+    };
+
+    model::Map quantizedMap = CalibrateAndQuantize<ValueType>(map);
+    auto weightSizes = GetQuantizedWeightSizes<ValueType>(quantizedMap.GetModel());
+    auto floatMilliseconds = measure(map);
+    auto quantizedMilliseconds = measure(quantizedMap);
+    std::cout << "Quantization " << name << ":" << std::endl;
+    std::cout << "  float:     " << weightSizes.first << " bytes of weights, " << floatMilliseconds << " ms per evaluation" << std::endl;
+    std::cout << "  quantized: " << weightSizes.second << " bytes of weights, " << quantizedMilliseconds << " ms per evaluation" << std::endl;
+    std::cout << "  speedup: " << (quantizedMilliseconds > 0 ? floatMilliseconds / quantizedMilliseconds : 0.0) << "x" << std::endl;
+    testing::ProcessTest("Testing quantized weights are smaller " + name, weightSizes.second < weightSizes.first);
+}
+
 //
 // Tests
 //
@@ -400,3 +826,143 @@ void TestOptimizeReorderDataNodes4()
 
     testing::ProcessTest("Testing compiled model optimizer", oldSize == 9 && newSize == 4);
 }
+
+void TestFoldLayerOperationsPass()
+{
+    TestFoldLayerOperationsPass<float>(GenerateFullyConnectedTestModel<float>(5, 4), "(fully-connected)");
+    TestFoldLayerOperationsPass<double>(GenerateConvolutionalTestModel<double>(3, 4, 2, 3), "(convolutional)");
+}
+
+void TestFuseElementwiseOperationsPass()
+{
+    model::PortMemoryLayout layout({ 2, 3, 5 });
+    TestFuseElementwiseOperationsPass<float>(GenerateElementwiseTestModel<float>(layout, 2), "(innermost broadcast dimension)");
+    TestFuseElementwiseOperationsPass<double>(GenerateElementwiseTestModel<double>(layout, 1), "(outer broadcast dimension)");
+
+    // Rows of 13 elements, which no vector width divides, so the vectorized loops have a remainder
+    model::MapCompilerOptions vectorizedSettings;
+    vectorizedSettings.compilerSettings.allowVectorInstructions = true;
+    model::PortMemoryLayout oddLayout({ 2, 3, 13 });
+    TestFuseElementwiseOperationsPass<float>(GenerateElementwiseTestModel<float>(oddLayout, 2), "(vectorized, innermost broadcast dimension)", vectorizedSettings);
+    TestFuseElementwiseOperationsPass<double>(GenerateElementwiseTestModel<double>(oddLayout, 1), "(vectorized, outer broadcast dimension)", vectorizedSettings);
+
+    // A 64x64x16 feature map, about the size of a spectrogram block in the audio feature pipelines
+    MeasureFuseElementwiseOperationsPass<float>(GenerateElementwiseTestModel<float>(model::PortMemoryLayout({ 64, 64, 16 }), 2), "(64x64x16)");
+}
+
+void TestConvolutionAutotune()
+{
+    using ValueType = float;
+    auto map = GenerateConvolutionalTestModel<ValueType>(4, 5, 3, 4);
+
+    std::vector<ValueType> testInput(map.GetInputSize());
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-3, 0.25));
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    auto databaseFilename = utilities::JoinPaths(utilities::GetWorkingDirectory(), "convolution_tuning_test.txt");
+    std::remove(databaseFilename.c_str());
+
+    // Initialize pass registry
+    passes::AddStandardPassesToRegistry();
+
+    model::MapCompilerOptions settings;
+    settings.optimizerSettings.preferredConvolutionMethod = model::PreferredConvolutionMethod::autotune;
+    settings.optimizerSettings.convolutionTuningDatabase = databaseFilename;
+    {
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        compiledMap.SetInputValue("input", testInput);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+        testing::ProcessTest("Testing autotuned convolution result", testing::IsEqual(referenceOutput, compiledOutput, static_cast<ValueType>(1e-4)));
+    }
+
+    passes::ConvolutionTuningDatabase database;
+    database.Load(databaseFilename);
+    testing::ProcessTest("Testing convolution tuning database entry count", database.Size() == 1);
+
+    // Mark the stored result, and check a second compile uses it rather than measuring again
+    auto targetKey = passes::ConvolutionTuningDatabase::GetTargetKey(model::IRMapCompiler(settings).GetCompilerOptions().targetDevice);
+    auto shapeKey = passes::ConvolutionTuningDatabase::GetShapeKey(map.GetModel().GetNodesByType<nodes::ConvolutionalLayerNode<ValueType>>()[0]->GetLayer());
+    auto entry = database.Find(targetKey, shapeKey);
+    testing::ProcessTest("Testing convolution tuning database key", entry != nullptr);
+    if (entry != nullptr)
+    {
+        auto markedEntry = *entry;
+        markedEntry.milliseconds = -1;
+        database.Set(targetKey, shapeKey, markedEntry);
+        database.Save(databaseFilename);
+
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        compiledMap.SetInputValue("input", testInput);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+        testing::ProcessTest("Testing stored autotuned convolution result", testing::IsEqual(referenceOutput, compiledOutput, static_cast<ValueType>(1e-4)));
+
+        passes::ConvolutionTuningDatabase reloadedDatabase;
+        reloadedDatabase.Load(databaseFilename);
+        entry = reloadedDatabase.Find(targetKey, shapeKey);
+        testing::ProcessTest("Testing convolution tuning database reuse", entry != nullptr && entry->milliseconds == -1);
+    }
+
+    // Round-trip the database through a stream
+    std::stringstream stream;
+    database.Write(stream);
+    passes::ConvolutionTuningDatabase readDatabase;
+    readDatabase.Read(stream);
+    auto readEntry = readDatabase.Find(targetKey, shapeKey);
+    testing::ProcessTest("Testing convolution tuning database serialization", readDatabase.Size() == 1 && readEntry != nullptr && readEntry->method == database.Find(targetKey, shapeKey)->method);
+}
+
+void TestQuantizationPass()
+{
+    using ValueType = float;
+    const int numInputs = 16;
+    const int numOutputs = 8;
+    auto map = GenerateFullyConnectedTestModel<ValueType>(numInputs, numOutputs);
+
+    // Calibrate on a few inputs spanning [-3, 3]
+    passes::QuantizationCalibrator calibrator;
+    for (int example = 0; example < 4; ++example)
+    {
+        std::vector<ValueType> calibrationInput(numInputs);
+        std::generate(calibrationInput.begin(), calibrationInput.end(), Increment<ValueType>(static_cast<ValueType>(-3 + 0.125 * example), 0.375));
+        map.SetInputValue("input", calibrationInput);
+        map.ComputeOutput<ValueType>("output");
+        calibrator.Update(map);
+    }
+    const auto& ranges = calibrator.GetActivationRanges();
+    testing::ProcessTest("Testing quantization calibration", calibrator.NumExamples() == 4 && ranges.size() == 1 && ranges.begin()->second == 3);
+
+    std::vector<ValueType> testInput(numInputs);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-2.5, 0.3125));
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    // The matrix-vector multiply and its constant matrix become one quantized node
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::QuantizationPass>(ranges));
+    model::Map quantizedMap(map);
+    quantizedMap.Optimize(optimizer);
+#if PRINT_MODELS
+    PrintMap(quantizedMap);
+#endif
+
+    const auto& quantizedModel = quantizedMap.GetModel();
+    testing::ProcessTest("Testing quantized node count", quantizedModel.Size() == map.GetModel().Size() - 1 && quantizedModel.GetNodesByType<nodes::QuantizedMatrixVectorMultiplyNode<ValueType>>().size() == 1);
+
+    quantizedMap.SetInputValue("input", testInput);
+    auto quantizedOutput = quantizedMap.ComputeOutput<ValueType>("output");
+    auto maxOutput = *std::max_element(referenceOutput.begin(), referenceOutput.end());
+    testing::ProcessTest("Testing quantized result", testing::IsEqual(referenceOutput, quantizedOutput, static_cast<ValueType>(0.02 * maxOutput)));
+
+    TestCompiledQuantizedMap<ValueType>(quantizedMap, testInput, "(fully-connected)");
+
+    // 3 channels make 27 weights per filter, which no vector size divides
+    TestQuantizeConvolutionalLayer<float>(GenerateConvolutionalTestModel<float>(6, 5, 3, 4), "(convolutional)");
+    TestQuantizeConvolutionalLayer<double>(GenerateConvolutionalTestModel<double>(4, 4, 8, 3), "(convolutional, double)");
+
+    // A 32x32x16 feature map through 32 filters, about the size of an early layer in the image classifiers
+    MeasureQuantizationPass<float>(GenerateConvolutionalTestModel<float>(32, 32, 16, 32), "(32x32x16, 32 filters)");
+}
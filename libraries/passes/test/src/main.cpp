@@ -25,6 +25,10 @@ int main()
     try
     {
         TestFuseLinearOpsPasses();
+        TestFoldLayerOperationsPass();
+        TestFuseElementwiseOperationsPass();
+        TestConvolutionAutotune();
+        TestQuantizationPass();
 
         TestOptimizeReorderDataNodes1();
         TestOptimizeReorderDataNodes2();
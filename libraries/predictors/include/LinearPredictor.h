@@ -96,6 +96,14 @@ namespace predictors
         /// <returns> The prediction. </returns>
         ElementType Predict(const DataVectorType& dataVector) const;
 
+        /// <summary> Returns the output of the predictor for a given example, stored in any type of data vector. </summary>
+        ///
+        /// <param name="example"> The data vector. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        template <typename OtherDataVectorType, data::IsDataVector<OtherDataVectorType> Concept = true>
+        ElementType Predict(const OtherDataVectorType& dataVector) const;
+
         /// <summary> Returns a vector of dataVector elements weighted by the predictor weights. </summary>
         ///
         /// <param name="example"> The data vector. </param>
@@ -190,6 +198,13 @@ namespace predictors
         return _w * dataVector + _b;
     }
 
+    template <typename ElementType>
+    template <typename OtherDataVectorType, data::IsDataVector<OtherDataVectorType> Concept>
+    ElementType LinearPredictor<ElementType>::Predict(const OtherDataVectorType& dataVector) const
+    {
+        return _w * dataVector + _b;
+    }
+
     template <typename ElementType>
     auto LinearPredictor<ElementType>::GetWeightedElements(const DataVectorType& dataVector) const -> DataVectorType
     {
@@ -48,6 +48,9 @@ namespace predictors
 
             /// <summary> Number of filters to batch at a time when using the Diagonal method. </summary>
             size_t numFiltersAtATime;
+
+            /// <summary> Output tile size when compiling with the Winograd method, or 0 to use the default. Chosen at compile time, so it isn't archived. </summary>
+            size_t winogradTileSize = 0;
         };
 
         /// <summary> A layer in a neural network that implements a fully connected layer, meaning all nodes in this layer are connected to all
@@ -16,10 +16,13 @@
 #include <predictors/include/ForestPredictor.h>
 
 #include <utilities/include/OutputStreamImpostor.h>
+#include <utilities/include/ParallelFor.h>
 
+#include <algorithm>
 #include <iostream> // For std::cout in VERBOSE_MODE
 #include <memory>
 #include <queue>
+#include <vector>
 
 namespace ell
 {
@@ -32,6 +35,7 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+        size_t numThreads = 1; // 0 means one thread per hardware thread
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -170,6 +174,10 @@ namespace trainers
         // performs an epoch of splits
         void PerformSplits(size_t maxSplits);
 
+        // finds the best split rule at each child of a node that was just split. The default implementation calls
+        // GetBestSplitRuleAtNode() on the children concurrently, so it must be safe to call on disjoint ranges
+        virtual std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex);
+
         // runs the booster and sets the weak weight and weak labels
         Sums SetWeakWeightsLabels();
 
@@ -194,6 +202,7 @@ namespace trainers
         // user defined parameters
         BoosterType _booster;
         ForestTrainerParameters _parameters;
+        size_t _numThreads;
 
         // the forest being grown
         PredictorType _forest;
@@ -220,6 +229,7 @@ namespace trainers
     ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ForestTrainer(const BoosterType& booster, const ForestTrainerParameters& parameters) :
         _booster(booster),
         _parameters(parameters),
+        _numThreads(utilities::GetNumThreads(parameters.numThreads)),
         _forest()
     {
     }
@@ -373,17 +383,40 @@ namespace trainers
             }
 
             // queue new split candidates
-            for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
+            for (auto& childSplitCandidate : GetBestSplitRulesAtChildren(splitCandidate, interiorNodeIndex))
             {
-                auto splitCandidate = GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
-                if (splitCandidate.gain > _parameters.minSplitGain)
+                if (childSplitCandidate.gain > _parameters.minSplitGain)
                 {
-                    _queue.push(std::move(splitCandidate));
+                    _queue.push(std::move(childSplitCandidate));
                 }
             }
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        const auto& stats = parent.stats;
+        const auto& ranges = parent.ranges;
+        auto numChildren = parent.splitRule.NumOutputs();
+
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < numChildren; ++i)
+        {
+            childSplitCandidates.emplace_back(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
+        }
+
+        // the children occupy disjoint ranges of the dataset, so they can be processed in parallel
+        utilities::ParallelFor(std::min(_numThreads, numChildren), 0, numChildren, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto& candidate = childSplitCandidates[i];
+                candidate = GetBestSplitRuleAtNode(candidate.nodeId, ranges.GetChildRange(i), stats.GetChildSums(i));
+            }
+        });
+        return childSplitCandidates;
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SortNodeDataset(Range range, const SplitRuleType& splitRule)
     {
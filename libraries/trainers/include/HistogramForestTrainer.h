@@ -14,8 +14,10 @@
 #include <predictors/include/ConstantPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <map>
 #include <random>
-#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -29,7 +31,12 @@ namespace trainers
         size_t candidatesPerInput;
     };
 
-    /// <summary> A histogram trainer for binary decision forests with threshold split rules and constant outputs. </summary>
+    /// <summary>
+    /// A histogram trainer for binary decision forests with threshold split rules and constant outputs. The candidate
+    /// thresholds are chosen once per tree and bin each feature's values. The split search at a node reads the node's
+    /// histograms, which are built on several threads (one block of features each). After a split, only the smaller
+    /// child's histograms are built, and the larger child's are the parent's minus the smaller child's.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> The loss function type. </typeparam>
     /// <typeparam name="BoosterType"> The booster type. </typeparam>
@@ -56,19 +63,31 @@ namespace trainers
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_parameters;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_numThreads;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_forest;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        struct EvaluateSplitRuleResult
+        // the examples in a node whose feature value falls between two consecutive candidate thresholds
+        struct HistogramBin
         {
-            Sums sums0;
-            size_t size0;
+            Sums sums;
+            size_t size = 0;
         };
 
+        // one histogram per feature, with one bin per candidate threshold plus one for values above all of them
+        using Histograms = std::vector<std::vector<HistogramBin>>;
+
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
         std::vector<SplitRuleType> CallThresholdFinder(Range range);
-        std::tuple<Sums, size_t> EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const;
+        void SetCandidateThresholds(Range range);
+        Histograms BuildHistograms(Range range) const;
+        Histograms SubtractHistograms(const Histograms& histograms, const Histograms& other) const;
+        SplitCandidate GetBestSplitCandidate(SplittableNodeId nodeId, Range range, Sums sums, const Histograms& histograms) const;
+        void StoreHistograms(const SplitCandidate& splitCandidate, Histograms histograms);
 
         // member variables
         LossFunctionType _lossFunction;
@@ -76,6 +95,12 @@ namespace trainers
         std::default_random_engine _random;
         size_t _thresholdFinderSampleSize;
         size_t _candidatesPerInput;
+
+        // the sorted candidate thresholds of each feature, chosen at the root of each tree
+        std::vector<std::vector<double>> _thresholds;
+
+        // the histograms of the queued split candidates, keyed by (first index, size) of their range
+        std::map<std::pair<size_t, size_t>, Histograms> _histograms;
     };
 
     /// <summary> Makes a simple forest trainer. </summary>
@@ -92,8 +117,11 @@ namespace trainers
 
 #pragma region implementation
 
+#include <utilities/include/ParallelFor.h>
 #include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace trainers
@@ -112,31 +140,50 @@ namespace trainers
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
     {
-        SplitCandidate bestSplitCandidate(nodeId, range, sums);
-
-        auto splitRuleCandidates = CallThresholdFinder(range);
-
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
+        // the root of a new tree: choose the candidate thresholds for the whole tree
+        if (range.firstIndex == 0 && range.size == _dataset.NumExamples())
         {
-            Sums sums0;
-            size_t size0;
+            SetCandidateThresholds(range);
+            _histograms.clear();
+        }
 
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
+        auto histograms = BuildHistograms(range);
+        auto bestSplitCandidate = GetBestSplitCandidate(nodeId, range, sums, histograms);
+        StoreHistograms(bestSplitCandidate, std::move(histograms));
+        return bestSplitCandidate;
+    }
 
-            Sums sums1 = sums - sums0;
-            double gain = CalculateGain(sums, sums0, sums1);
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        const auto& stats = parent.stats;
+        const auto& ranges = parent.ranges;
+        auto parentRange = ranges.GetTotalRange();
+        auto parentHistograms = _histograms.find({ parentRange.firstIndex, parentRange.size });
 
-            // find gain maximizer
-            if (gain > bestSplitCandidate.gain)
+        std::vector<SplitCandidate> childSplitCandidates;
+        if (parentHistograms == _histograms.end() || parent.splitRule.NumOutputs() != 2)
+        {
+            for (size_t i = 0; i < parent.splitRule.NumOutputs(); ++i)
             {
-                bestSplitCandidate.gain = gain;
-                bestSplitCandidate.splitRule = splitRuleCandidate;
-                bestSplitCandidate.ranges.SplitChildRange(0, size0);
-                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                childSplitCandidates.push_back(GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i)));
             }
+            return childSplitCandidates;
         }
 
-        return bestSplitCandidate;
+        // build the smaller child's histograms, and get the larger child's by subtraction
+        size_t smallChild = ranges.GetChildRange(0).size <= ranges.GetChildRange(1).size ? 0 : 1;
+        std::vector<Histograms> childHistograms(2);
+        childHistograms[smallChild] = BuildHistograms(ranges.GetChildRange(smallChild));
+        childHistograms[1 - smallChild] = SubtractHistograms(parentHistograms->second, childHistograms[smallChild]);
+        _histograms.erase(parentHistograms);
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitCandidate(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i), childHistograms[i]));
+            StoreHistograms(childSplitCandidates.back(), std::move(childHistograms[i]));
+        }
+        return childSplitCandidates;
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
@@ -172,26 +219,133 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const -> std::tuple<Sums, size_t>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SetCandidateThresholds(Range range)
     {
-        Sums sums0;
-        size_t size0 = 0;
+        _thresholds.clear();
+        for (const auto& splitRule : CallThresholdFinder(range))
+        {
+            auto inputIndex = splitRule.GetElementIndex();
+            if (_thresholds.size() <= inputIndex)
+            {
+                _thresholds.resize(inputIndex + 1);
+            }
+            _thresholds[inputIndex].push_back(splitRule.GetThreshold());
+        }
 
-        auto exampleIterator = _dataset.GetExampleIterator(range.firstIndex, range.size);
-        while (exampleIterator.IsValid())
+        for (auto& thresholds : _thresholds)
         {
-            const auto& example = exampleIterator.Get();
-            auto prediction = splitRule.Predict(example.GetDataVector());
-            if (prediction == 0)
+            std::sort(thresholds.begin(), thresholds.end());
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::BuildHistograms(Range range) const -> Histograms
+    {
+        auto numFeatures = _thresholds.size();
+        Histograms histograms(numFeatures);
+
+        // each thread bins a block of features, reading the examples in order
+        utilities::ParallelFor(std::min(_numThreads, std::max<size_t>(numFeatures, 1)), 0, numFeatures, [&](size_t, size_t beginFeature, size_t endFeature) {
+            for (size_t inputIndex = beginFeature; inputIndex < endFeature; ++inputIndex)
+            {
+                histograms[inputIndex].resize(_thresholds[inputIndex].size() + 1);
+            }
+
+            for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
             {
-                sums0.Increment(example.GetMetadata().weak);
-                ++size0;
+                const auto& example = _dataset[rowIndex];
+                const auto& dataVector = example.GetDataVector();
+                const auto& weightLabel = example.GetMetadata().weak;
+                for (size_t inputIndex = beginFeature; inputIndex < endFeature; ++inputIndex)
+                {
+                    // an example goes to child 0 of the split rule with threshold t iff its value is <= t
+                    const auto& thresholds = _thresholds[inputIndex];
+                    auto binIndex = std::lower_bound(thresholds.begin(), thresholds.end(), dataVector[inputIndex]) - thresholds.begin();
+                    auto& bin = histograms[inputIndex][binIndex];
+                    bin.sums.Increment(weightLabel);
+                    ++bin.size;
+                }
+            }
+        });
+
+        return histograms;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SubtractHistograms(const Histograms& histograms, const Histograms& other) const -> Histograms
+    {
+        Histograms result(histograms.size());
+        for (size_t inputIndex = 0; inputIndex < histograms.size(); ++inputIndex)
+        {
+            const auto& bins = histograms[inputIndex];
+            const auto& otherBins = other[inputIndex];
+            auto& resultBins = result[inputIndex];
+            resultBins.resize(bins.size());
+            for (size_t binIndex = 0; binIndex < bins.size(); ++binIndex)
+            {
+                resultBins[binIndex].sums = bins[binIndex].sums - otherBins[binIndex].sums;
+                resultBins[binIndex].size = bins[binIndex].size - otherBins[binIndex].size;
             }
-            exampleIterator.Next();
         }
+        return result;
+    }
 
-        return std::make_tuple(sums0, size0);
-    };
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitCandidate(SplittableNodeId nodeId, Range range, Sums sums, const Histograms& histograms) const -> SplitCandidate
+    {
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        size_t bestSize0 = 0;
+
+        for (size_t inputIndex = 0; inputIndex < histograms.size(); ++inputIndex)
+        {
+            const auto& thresholds = _thresholds[inputIndex];
+            const auto& bins = histograms[inputIndex];
+
+            // the examples that go to child 0 of a split rule are those in the bins up to and including the threshold's
+            Sums sums0;
+            size_t size0 = 0;
+            for (size_t thresholdIndex = 0; thresholdIndex < thresholds.size(); ++thresholdIndex)
+            {
+                sums0.sumWeights += bins[thresholdIndex].sums.sumWeights;
+                sums0.sumWeightedLabels += bins[thresholdIndex].sums.sumWeightedLabels;
+                size0 += bins[thresholdIndex].size;
+                if (size0 == 0 || size0 == range.size)
+                {
+                    continue;
+                }
+
+                Sums sums1 = sums - sums0;
+                double gain = CalculateGain(sums, sums0, sums1);
+
+                // find gain maximizer
+                if (gain > bestSplitCandidate.gain)
+                {
+                    bestSplitCandidate.gain = gain;
+                    bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, thresholds[thresholdIndex] };
+                    bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                    bestSize0 = size0;
+                }
+            }
+        }
+
+        // split the range only once, since each call to SplitChildRange adds another child
+        if (bestSplitCandidate.gain > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+        }
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::StoreHistograms(const SplitCandidate& splitCandidate, Histograms histograms)
+    {
+        // only nodes that will be queued can be split later
+        if (splitCandidate.gain > _parameters.minSplitGain)
+        {
+            auto range = splitCandidate.ranges.GetTotalRange();
+            _histograms[{ range.firstIndex, range.size }] = std::move(histograms);
+        }
+    }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters)
@@ -26,7 +26,7 @@ namespace trainers
     {
     public:
         /// <summary></summary>
-        static void GetDatasetAsMatrix(const data::AutoSupervisedDataset& anyDataset, math::MatrixReference<double, math::MatrixLayout::columnMajor> X, math::MatrixReference<double, math::MatrixLayout::columnMajor> Y);
+        static void GetDatasetAsMatrix(const data::AnyDataset& anyDataset, math::MatrixReference<double, math::MatrixLayout::columnMajor> X, math::MatrixReference<double, math::MatrixLayout::columnMajor> Y);
 
         /// <summary></summary>
         template <typename math::MatrixLayout Layout>
@@ -52,21 +52,18 @@ namespace ell
 {
 namespace trainers
 {
-    void ProtoNNTrainerUtils::GetDatasetAsMatrix(const data::AutoSupervisedDataset& anyDataset, math::MatrixReference<double, math::MatrixLayout::columnMajor> X, math::MatrixReference<double, math::MatrixLayout::columnMajor> Y)
+    void ProtoNNTrainerUtils::GetDatasetAsMatrix(const data::AnyDataset& anyDataset, math::MatrixReference<double, math::MatrixLayout::columnMajor> X, math::MatrixReference<double, math::MatrixLayout::columnMajor> Y)
     {
-        auto exampleIterator = anyDataset.GetExampleIterator();
+        auto exampleIterator = anyDataset.GetExampleIterator<data::AutoSupervisedExample>();
         int colIdx = 0;
         while (exampleIterator.IsValid())
         {
             // get the Next example
             const auto& example = exampleIterator.Get();
             double label = example.GetMetadata().label;
-            const auto& dataVector = example.GetDataVector().ToArray();
 
-            for (size_t j = 0; j < dataVector.size(); j++)
-            {
-                X(j, colIdx) = dataVector[j];
-            }
+            // the columns of X start out zero, so adding the example writes just its nonzeros
+            example.GetDataVector().AddTo(X.GetColumn(colIdx).Transpose());
 
             for (size_t i = 0; i < Y.NumRows(); i++)
             {
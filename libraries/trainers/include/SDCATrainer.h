@@ -14,10 +14,12 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
+#include <data/include/PackedDataset.h>
 
 #include <math/include/Vector.h>
 
 #include <random>
+#include <vector>
 
 namespace ell
 {
@@ -31,6 +33,7 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+        size_t numThreads = 1; // 0 means one thread per hardware thread
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -41,7 +44,11 @@ namespace trainers
         size_t numEpochsPerformed = 0;
     };
 
-    /// <summary> Implements the stochastic dual coordinate ascent linear trainer. </summary>
+    /// <summary>
+    /// Implements the stochastic dual coordinate ascent linear trainer. When `numThreads` is greater than 1, each epoch
+    /// partitions the examples among the threads, and each thread runs SDCA on its own block against a private copy
+    /// of the model. The updates are then summed, which is the CoCoA+ scheme of https://arxiv.org/abs/1502.03508.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
@@ -77,11 +84,6 @@ namespace trainers
     private:
         struct TrainerMetadata
         {
-            TrainerMetadata(const data::WeightLabel& weightLabel);
-
-            // weight and label
-            data::WeightLabel weightLabel;
-
             // precomputed squared 2 norm of the data vector
             double norm2Squared = 0;
 
@@ -89,20 +91,33 @@ namespace trainers
             double dualVariable = 0;
         };
 
-        using DataVectorType = typename predictors::LinearPredictor<double>::DataVectorType;
-        using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
+        // the private state of one block in a parallel epoch
+        struct BlockState
+        {
+            math::ColumnVector<double> v;
+            double d = 0;
+            predictors::LinearPredictor<double> predictor;
+            math::ColumnVector<double> deltaV;
+            double deltaD = 0;
+        };
 
-        void Step(TrainerExampleType& x);
+        void Step(size_t index);
+        void ParallelEpoch();
+        void BlockStep(size_t index, BlockState& state, double sigma);
         void ComputeObjectives();
-        void ResizeTo(const data::AutoDataVector& x);
+        void ResizeTo(const data::PackedDataVector& x);
 
         LossFunctionType _lossFunction;
         RegularizerType _regularizer;
         SDCATrainerParameters _parameters;
         std::default_random_engine _random;
+        size_t _numThreads;
         double _inverseScaledRegularization;
 
-        data::Dataset<TrainerExampleType> _dataset;
+        // the metadata of each example of the dataset, and the order in which the examples are visited
+        data::PackedDataset _dataset;
+        std::vector<TrainerMetadata> _metadata;
+        std::vector<size_t> _order;
 
         predictors::LinearPredictor<double> _predictor;
         SDCAPredictorInfo _predictorInfo;
@@ -132,8 +147,12 @@ namespace trainers
 
 #include <data/include/DataVectorOperations.h>
 
+#include <utilities/include/ParallelFor.h>
 #include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace ell
 {
 namespace trainers
@@ -142,7 +161,8 @@ namespace trainers
     SDCATrainer<LossFunctionType, RegularizerType>::SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters) :
         _lossFunction(lossFunction),
         _regularizer(regularizer),
-        _parameters(parameters)
+        _parameters(parameters),
+        _numThreads(utilities::GetNumThreads(parameters.numThreads))
     {
         _random = utilities::GetRandomEngine(parameters.randomSeedString);
     }
@@ -152,8 +172,11 @@ namespace trainers
     {
         DEBUG_THROW(_v.Norm0() != 0, utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "can only call SetDataset before updates"));
 
-        _dataset = data::Dataset<TrainerExampleType>(anyDataset);
+        _dataset = data::PackedDataset(anyDataset);
         auto numExamples = _dataset.NumExamples();
+        _metadata.assign(numExamples, TrainerMetadata{});
+        _order.resize(numExamples);
+        std::iota(_order.begin(), _order.end(), 0);
         _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
 
         _predictorInfo.primalObjective = 0;
@@ -162,10 +185,9 @@ namespace trainers
         // precompute the norm of each example
         for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
         {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().norm2Squared = example.GetDataVector().Norm2Squared();
+            _metadata[rowIndex].norm2Squared = _dataset.GetDataVector(rowIndex).Norm2Squared();
 
-            auto label = example.GetMetadata().weightLabel.label;
+            auto label = _dataset.GetMetadata(rowIndex).label;
             _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
         }
     }
@@ -175,13 +197,20 @@ namespace trainers
     {
         if (_parameters.permute)
         {
-            _dataset.RandomPermute(_random);
+            data::RandomPermute(_order, _random);
         }
 
         // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        if (_numThreads > 1 && _dataset.NumExamples() > 1)
+        {
+            ParallelEpoch();
+        }
+        else
         {
-            Step(_dataset[i]);
+            for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+            {
+                Step(_order[i]);
+            }
         }
 
         // Finish
@@ -189,26 +218,22 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename RegularizerType>
-    SDCATrainer<LossFunctionType, RegularizerType>::TrainerMetadata::TrainerMetadata(const data::WeightLabel& original) :
-        weightLabel(original)
-    {}
-
-    template <typename LossFunctionType, typename RegularizerType>
-    void SDCATrainer<LossFunctionType, RegularizerType>::Step(TrainerExampleType& example)
+    void SDCATrainer<LossFunctionType, RegularizerType>::Step(size_t index)
     {
-        const auto& dataVector = example.GetDataVector();
+        auto dataVector = _dataset.GetDataVector(index);
         ResizeTo(dataVector);
 
-        auto weightLabel = example.GetMetadata().weightLabel;
-        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
+        auto& metadata = _metadata[index];
+        auto label = _dataset.GetMetadata(index).label;
+        auto norm2Squared = metadata.norm2Squared + 1; // add one because of bias term
         auto lipschitz = norm2Squared * _inverseScaledRegularization;
-        auto dual = example.GetMetadata().dualVariable;
+        auto dual = metadata.dualVariable;
 
         if (lipschitz > 0)
         {
             auto prediction = _predictor.Predict(dataVector);
 
-            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, label);
             auto dualDiff = newDual - dual;
 
             if (dualDiff != 0)
@@ -216,7 +241,73 @@ namespace trainers
                 _v.Transpose() += (-dualDiff * _inverseScaledRegularization) * dataVector;
                 _d += (-dualDiff * _inverseScaledRegularization);
                 _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
-                example.GetMetadata().dualVariable = newDual;
+                metadata.dualVariable = newDual;
+            }
+        }
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelEpoch()
+    {
+        auto numExamples = _dataset.NumExamples();
+        for (size_t i = 0; i < numExamples; ++i)
+        {
+            ResizeTo(_dataset.GetDataVector(i));
+        }
+
+        // with the CoCoA+ "adding" aggregation, each block's subproblem is made sigma = numBlocks times more conservative
+        auto numBlocks = std::min(_numThreads, numExamples);
+        double sigma = static_cast<double>(numBlocks);
+        std::vector<BlockState> blocks(numBlocks);
+        utilities::ParallelFor(numBlocks, 0, numExamples, [&](size_t blockIndex, size_t begin, size_t end) {
+            auto& state = blocks[blockIndex];
+            state.v = _v;
+            state.d = _d;
+            state.predictor = _predictor;
+            state.deltaV.Resize(_v.Size());
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                BlockStep(_order[i], state, sigma);
+            }
+        });
+
+        for (const auto& state : blocks)
+        {
+            _v += state.deltaV;
+            _d += state.deltaD;
+        }
+        _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::BlockStep(size_t index, BlockState& state, double sigma)
+    {
+        auto dataVector = _dataset.GetDataVector(index);
+
+        auto& metadata = _metadata[index];
+        auto label = _dataset.GetMetadata(index).label;
+        auto norm2Squared = metadata.norm2Squared + 1; // add one because of bias term
+        auto lipschitz = sigma * norm2Squared * _inverseScaledRegularization;
+        auto dual = metadata.dualVariable;
+
+        if (lipschitz > 0)
+        {
+            auto prediction = state.predictor.Predict(dataVector);
+
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, label);
+            auto dualDiff = newDual - dual;
+
+            if (dualDiff != 0)
+            {
+                // the block's model sees its own updates scaled by sigma, the global model gets them unscaled
+                auto scaledDiff = -dualDiff * _inverseScaledRegularization;
+                state.deltaV.Transpose() += scaledDiff * dataVector;
+                state.deltaD += scaledDiff;
+                state.v.Transpose() += (sigma * scaledDiff) * dataVector;
+                state.d += sigma * scaledDiff;
+                _regularizer.ConjugateGradient(state.v, state.d, state.predictor.GetWeights(), state.predictor.GetBias());
+                metadata.dualVariable = newDual;
             }
         }
     }
@@ -231,10 +322,9 @@ namespace trainers
 
         for (size_t i = 0; i < _dataset.NumExamples(); ++i)
         {
-            const auto& example = _dataset.GetExample(i);
-            auto label = example.GetMetadata().weightLabel.label;
-            auto prediction = _predictor.Predict(example.GetDataVector());
-            auto dualVariable = example.GetMetadata().dualVariable;
+            auto label = _dataset.GetMetadata(i).label;
+            auto prediction = _predictor.Predict(_dataset.GetDataVector(i));
+            auto dualVariable = _metadata[i].dualVariable;
 
             _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
             _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
@@ -245,7 +335,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename RegularizerType>
-    void SDCATrainer<LossFunctionType, RegularizerType>::ResizeTo(const data::AutoDataVector& x)
+    void SDCATrainer<LossFunctionType, RegularizerType>::ResizeTo(const data::PackedDataVector& x)
     {
         auto xSize = x.PrefixLength();
         if (xSize > _predictor.Size())
@@ -14,11 +14,13 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
+#include <data/include/PackedDataset.h>
 
 #include <cstddef>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace ell
 {
@@ -29,11 +31,14 @@ namespace trainers
     {
         double regularization;
         std::string randomSeedString;
+        size_t numThreads = 1; // 0 means one thread per hardware thread
     };
 
     /// <summary>
     /// Implements the averaged stochastic gradient descent algorithm on an L2 regularized empirical
     /// loss. This class must be have a derived class that implements DoFirstStep(), DoNextStep(), and CalculatePredictors().
+    /// A derived class whose steps only touch the nonzero coordinates of the example can also override DoNextSteps()
+    /// to process an epoch on several threads.
     /// </summary>
     class SGDTrainerBase : public ITrainer<predictors::LinearPredictor<double>>
     {
@@ -55,13 +60,23 @@ namespace trainers
 
     protected:
         // Instances of the base class cannot be created directly
-        SGDTrainerBase(std::string randomSeedString);
-        virtual void DoFirstStep(const data::AutoDataVector& x, double y, double weight) = 0;
-        virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
+        SGDTrainerBase(std::string randomSeedString, size_t numThreads = 1);
+        virtual void DoFirstStep(const data::PackedDataVector& x, double y, double weight) = 0;
+        virtual void DoNextStep(const data::PackedDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
-        data::AutoSupervisedDataset _dataset;
+        // Calls DoNextStep() on the examples of the (permuted) dataset, starting at fromIndex
+        virtual void DoNextSteps(size_t fromIndex);
+
+        // Get the data vector and metadata of an example of the (permuted) dataset
+        data::PackedDataVector GetDataVector(size_t index) const { return _dataset.GetDataVector(_order[index]); }
+        const data::WeightLabel& GetMetadata(size_t index) const { return _dataset.GetMetadata(_order[index]); }
+
+        // The examples are permuted by permuting the order in which they're visited, rather than by moving their entries
+        data::PackedDataset _dataset;
+        std::vector<size_t> _order;
         std::default_random_engine _random;
+        size_t _numThreads;
         bool _firstIteration = true;
     };
 
@@ -95,8 +110,8 @@ namespace trainers
         const PredictorType& GetAveragedPredictor() const override { return _averagedPredictor; }
 
     protected:
-        void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
-        void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoFirstStep(const data::PackedDataVector& x, double y, double weight) override;
+        void DoNextStep(const data::PackedDataVector& x, double y, double weight) override;
 
     private:
         LossFunctionType _lossFunction;
@@ -106,14 +121,17 @@ namespace trainers
         PredictorType _lastPredictor;
         PredictorType _averagedPredictor;
 
-        void ResizeTo(const data::AutoDataVector& x);
+        void ResizeTo(const data::PackedDataVector& x);
     };
 
     //
     // SparseDataSGDTrainer - Sparse Data Stochastic Gradient Descent
     //
 
-    /// <summary> Implements the steps of Sparse Data Stochastic Gradient Descent. </summary>
+    /// <summary>
+    /// Implements the steps of Sparse Data Stochastic Gradient Descent. When `numThreads` is greater than 1, each epoch
+    /// is split among the threads, which update the shared state without locks (Hogwild, https://arxiv.org/abs/1106.5730).
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     template <typename LossFunctionType>
@@ -139,8 +157,9 @@ namespace trainers
         const PredictorType& GetAveragedPredictor() const override;
 
     protected:
-        void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
-        void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoFirstStep(const data::PackedDataVector& x, double y, double weight) override;
+        void DoNextStep(const data::PackedDataVector& x, double y, double weight) override;
+        void DoNextSteps(size_t fromIndex) override;
 
     private:
         LossFunctionType _lossFunction;
@@ -158,14 +177,17 @@ namespace trainers
         mutable PredictorType _lastPredictor;
         mutable PredictorType _averagedPredictor;
 
-        void ResizeTo(const data::AutoDataVector& x);
+        void ResizeTo(const data::PackedDataVector& x);
     };
 
     //
     // SparseDataCenteredSGDTrainer - Sparse Data Centered Stochastic Gradient Descent
     //
 
-    /// <summary> Implements the steps of Sparse Data Centered Stochastic Gradient Descent. </summary>
+    /// <summary>
+    /// Implements the steps of Sparse Data Centered Stochastic Gradient Descent. Like SparseDataSGDTrainer, it uses
+    /// lock-free parallel updates when `numThreads` is greater than 1.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     template <typename LossFunctionType>
@@ -192,8 +214,9 @@ namespace trainers
         const PredictorType& GetAveragedPredictor() const override;
 
     protected:
-        void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
-        void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoFirstStep(const data::PackedDataVector& x, double y, double weight) override;
+        void DoNextStep(const data::PackedDataVector& x, double y, double weight) override;
+        void DoNextSteps(size_t fromIndex) override;
 
     private:
         LossFunctionType _lossFunction;
@@ -218,7 +241,7 @@ namespace trainers
         mutable PredictorType _lastPredictor;
         mutable PredictorType _averagedPredictor;
 
-        void ResizeTo(const data::AutoDataVector& x);
+        void ResizeTo(const data::PackedDataVector& x);
     };
 
     //
@@ -268,12 +291,33 @@ namespace trainers
 
 #include <math/include/VectorOperations.h>
 
+#include <utilities/include/ParallelFor.h>
+
+#include <atomic>
+#include <vector>
+
 namespace ell
 {
 namespace trainers
 {
     // the code in this file follows the notation and pseudocode in https://arxiv.org/abs/1612.09147
 
+    namespace SGDTrainerImpl
+    {
+        // Returns the harmonic numbers H(t), H(t+1), ..., H(t+numSteps), given h = H(t)
+        inline std::vector<double> GetHarmonicNumbers(double t, double h, size_t numSteps)
+        {
+            std::vector<double> harmonicNumbers(numSteps + 1);
+            harmonicNumbers[0] = h;
+            for (size_t step = 1; step <= numSteps; ++step)
+            {
+                h += 1.0 / (t + step);
+                harmonicNumbers[step] = h;
+            }
+            return harmonicNumbers;
+        }
+    } // namespace SGDTrainerImpl
+
     //
     // SGDTrainer
     //
@@ -287,13 +331,13 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    void SGDTrainer<LossFunctionType>::DoFirstStep(const data::AutoDataVector& x, double y, double weight)
+    void SGDTrainer<LossFunctionType>::DoFirstStep(const data::PackedDataVector& x, double y, double weight)
     {
         DoNextStep(x, y, weight);
     }
 
     template <typename LossFunctionType>
-    void SGDTrainer<LossFunctionType>::DoNextStep(const data::AutoDataVector& x, double y, double weight)
+    void SGDTrainer<LossFunctionType>::DoNextStep(const data::PackedDataVector& x, double y, double weight)
     {
         ResizeTo(x);
         ++_t;
@@ -331,7 +375,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    void SGDTrainer<LossFunctionType>::ResizeTo(const data::AutoDataVector& x)
+    void SGDTrainer<LossFunctionType>::ResizeTo(const data::PackedDataVector& x)
     {
         auto xSize = x.PrefixLength();
         if (xSize > _lastPredictor.Size())
@@ -347,14 +391,14 @@ namespace trainers
 
     template <typename LossFunctionType>
     SparseDataSGDTrainer<LossFunctionType>::SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters) :
-        SGDTrainerBase(parameters.randomSeedString),
+        SGDTrainerBase(parameters.randomSeedString, parameters.numThreads),
         _lossFunction(lossFunction),
         _parameters(parameters)
     {
     }
 
     template <typename LossFunctionType>
-    void SparseDataSGDTrainer<LossFunctionType>::DoFirstStep(const data::AutoDataVector& x, double y, double weight)
+    void SparseDataSGDTrainer<LossFunctionType>::DoFirstStep(const data::PackedDataVector& x, double y, double weight)
     {
         ResizeTo(x);
         _t = 1.0;
@@ -366,7 +410,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    void SparseDataSGDTrainer<LossFunctionType>::DoNextStep(const data::AutoDataVector& x, double y, double weight)
+    void SparseDataSGDTrainer<LossFunctionType>::DoNextStep(const data::PackedDataVector& x, double y, double weight)
     {
         ResizeTo(x);
         ++_t;
@@ -387,6 +431,60 @@ namespace trainers
         _h += 1.0 / _t;
     }
 
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::DoNextSteps(size_t fromIndex)
+    {
+        auto numExamples = _dataset.NumExamples();
+        if (_numThreads <= 1 || fromIndex >= numExamples)
+        {
+            SGDTrainerBase::DoNextSteps(fromIndex);
+            return;
+        }
+
+        // the shared vectors can't be resized once the threads start
+        for (size_t index = fromIndex; index < numExamples; ++index)
+        {
+            ResizeTo(GetDataVector(index));
+        }
+
+        // each step uses the harmonic number from before the step, which only depends on the step counter
+        auto harmonicNumbers = SGDTrainerImpl::GetHarmonicNumbers(_t, _h, numExamples - fromIndex);
+
+        // the threads race on the entries of _v and _u, and use atomics for the scalars
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        std::atomic<size_t> numStepsTaken(0);
+        std::atomic<double> a(_a);
+        std::atomic<double> c(_c);
+        utilities::ParallelFor(_numThreads, fromIndex, numExamples, [&](size_t, size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index)
+            {
+                auto x = GetDataVector(index);
+                const auto& metadata = GetMetadata(index);
+                auto step = numStepsTaken++;
+                double t = t0 + step + 1;
+
+                // apply the predictor
+                double d = x * _v;
+                double p = -(d + a.load(std::memory_order_relaxed)) / (lambda * (t - 1.0));
+
+                // get the derivative
+                double g = metadata.weight * _lossFunction.GetDerivative(p, metadata.label);
+
+                // update
+                _v.Transpose() += g * x;
+                _u.Transpose() += harmonicNumbers[step] * g * x;
+                auto newA = utilities::AtomicAdd(a, g);
+                utilities::AtomicAdd(c, newA / t);
+            }
+        });
+
+        _t = t0 + harmonicNumbers.size() - 1;
+        _h = harmonicNumbers.back();
+        _a = a;
+        _c = c;
+    }
+
     template <typename LossFunctionType>
     auto SparseDataSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -418,7 +516,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    inline void SparseDataSGDTrainer<LossFunctionType>::ResizeTo(const data::AutoDataVector& x)
+    inline void SparseDataSGDTrainer<LossFunctionType>::ResizeTo(const data::PackedDataVector& x)
     {
         auto xSize = x.PrefixLength();
         if (xSize > _v.Size())
@@ -434,7 +532,7 @@ namespace trainers
 
     template <typename LossFunctionType>
     SparseDataCenteredSGDTrainer<LossFunctionType>::SparseDataCenteredSGDTrainer(const LossFunctionType& lossFunction, math::RowVector<double> center, const SGDTrainerParameters& parameters) :
-        SGDTrainerBase(parameters.randomSeedString),
+        SGDTrainerBase(parameters.randomSeedString, parameters.numThreads),
         _lossFunction(lossFunction),
         _parameters(parameters),
         _center(std::move(center))
@@ -443,7 +541,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoFirstStep(const data::AutoDataVector& x, double y, double weight)
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoFirstStep(const data::PackedDataVector& x, double y, double weight)
     {
         ResizeTo(x);
         _t = 1.0;
@@ -463,7 +561,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoNextStep(const data::AutoDataVector& x, double y, double weight)
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoNextStep(const data::PackedDataVector& x, double y, double weight)
     {
         ResizeTo(x);
         ++_t;
@@ -490,6 +588,72 @@ namespace trainers
         _s += _r / _t;
     }
 
+    template <typename LossFunctionType>
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoNextSteps(size_t fromIndex)
+    {
+        auto numExamples = _dataset.NumExamples();
+        if (_numThreads <= 1 || fromIndex >= numExamples)
+        {
+            SGDTrainerBase::DoNextSteps(fromIndex);
+            return;
+        }
+
+        // the shared vectors can't be resized once the threads start
+        for (size_t index = fromIndex; index < numExamples; ++index)
+        {
+            ResizeTo(GetDataVector(index));
+        }
+
+        // each step uses the harmonic number from before the step, which only depends on the step counter
+        auto harmonicNumbers = SGDTrainerImpl::GetHarmonicNumbers(_t, _h, numExamples - fromIndex);
+
+        // the threads race on the entries of _v and _u, and use atomics for the scalars
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        std::atomic<size_t> numStepsTaken(0);
+        std::atomic<double> a(_a);
+        std::atomic<double> c(_c);
+        std::atomic<double> z(_z);
+        std::atomic<double> s(_s);
+        utilities::ParallelFor(_numThreads, fromIndex, numExamples, [&](size_t, size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index)
+            {
+                auto x = GetDataVector(index);
+                const auto& metadata = GetMetadata(index);
+                auto step = numStepsTaken++;
+                double t = t0 + step + 1;
+
+                // apply the predictor
+                double d = x * _v;
+                double q = x * _center.Transpose();
+                double currentA = a.load(std::memory_order_relaxed);
+                double r = currentA * _theta - z.load(std::memory_order_relaxed);
+                double p = -(d + r - currentA * q) / (lambda * (t - 1.0));
+
+                // get the derivative
+                double g = metadata.weight * _lossFunction.GetDerivative(p, metadata.label);
+
+                // apply the SparseDataSGD update
+                _v.Transpose() += g * x;
+                _u.Transpose() += harmonicNumbers[step] * g * x;
+                auto newA = utilities::AtomicAdd(a, g);
+                utilities::AtomicAdd(c, newA / t);
+
+                // next, perform the special steps needed for centering
+                auto newZ = utilities::AtomicAdd(z, g * q);
+                utilities::AtomicAdd(s, (newA * _theta - newZ) / t);
+            }
+        });
+
+        _t = t0 + harmonicNumbers.size() - 1;
+        _h = harmonicNumbers.back();
+        _a = a;
+        _c = c;
+        _z = z;
+        _r = _a * _theta - _z;
+        _s = s;
+    }
+
     template <typename LossFunctionType>
     auto SparseDataCenteredSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -520,7 +684,7 @@ namespace trainers
     }
 
     template <typename LossFunctionType>
-    inline void SparseDataCenteredSGDTrainer<LossFunctionType>::ResizeTo(const data::AutoDataVector& x)
+    inline void SparseDataCenteredSGDTrainer<LossFunctionType>::ResizeTo(const data::PackedDataVector& x)
     {
         auto xSize = x.PrefixLength();
         if (xSize > _v.Size())
@@ -95,6 +95,7 @@ namespace trainers
         auto numFeatures = _dataset.NumFeatures();
 
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        size_t bestSize0 = 0;
 
         for (size_t inputIndex = 0; inputIndex < numFeatures; ++inputIndex)
         {
@@ -129,11 +130,17 @@ namespace trainers
                 {
                     bestSplitCandidate.gain = gain;
                     bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
-                    bestSplitCandidate.ranges.SplitChildRange(0, rowIndex - range.firstIndex + 1);
                     bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                    bestSize0 = rowIndex - range.firstIndex + 1;
                 }
             }
         }
+
+        // split the range only once, since each call to SplitChildRange adds another child
+        if (bestSplitCandidate.gain > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+        }
         return bestSplitCandidate;
     }
 
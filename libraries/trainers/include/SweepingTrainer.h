@@ -33,14 +33,13 @@ namespace trainers
     {
     public:
         using EvaluatingTrainerType = EvaluatingTrainer<PredictorType>;
-        using ExampleType = data::Example<typename PredictorType::DataVectorType, data::WeightLabel>;
 
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
         SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
 
-        /// <summary> Sets the trainer's dataset. </summary>
+        /// <summary> Sets the dataset of each of the internal trainers. </summary>
         ///
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
@@ -54,7 +53,6 @@ namespace trainers
         const PredictorType& GetPredictor() const override;
 
     private:
-        data::Dataset<ExampleType> _dataset;
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
     };
 
@@ -85,7 +83,10 @@ namespace trainers
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<ExampleType>(anyDataset);
+        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        {
+            _evaluatingTrainers[i].SetDataset(anyDataset);
+        }
     }
 
     template <typename PredictorType>
@@ -25,6 +25,7 @@ namespace trainers
         {
             double regularizationParameter;
             bool permuteData = true;
+            size_t numThreads = 1; // 0 means one thread per hardware thread
         };
 
         /// <summary> Information about the current solution found by SDCA. </summary>
@@ -38,7 +39,11 @@ namespace trainers
             double DualityGap() const { return primalObjective - dualObjective; }
         };
 
-        /// <summary> </summary>
+        /// <summary>
+        /// Stochastic dual coordinate ascent. With more than one thread, each epoch splits the examples into blocks
+        /// that are optimized concurrently against private copies of the solution, and the block updates are summed
+        /// (CoCoA+, https://arxiv.org/abs/1502.03508).
+        /// </summary>
         ///
         /// <typeparam name="SolutionType"> Solution type. </typeparam>
         /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
@@ -98,9 +103,19 @@ namespace trainers
             };
             std::vector<ExampleInfo> _exampleInfo;
 
+            // the private state of one block in a parallel epoch
+            struct BlockState
+            {
+                SolutionType w;
+                SolutionType v;
+                RegularizerType regularizer;
+            };
+
             void OneTimeSetup(std::shared_ptr<const DatasetType> examples, std::string randomSeedString);
             void InitializeDuals();
             void Step(ExampleType example, ExampleInfo& exampleInfo);
+            void ParallelEpoch(const std::vector<size_t>& permutation);
+            void BlockStep(ExampleType example, ExampleInfo& exampleInfo, BlockState& state, double sigma);
 
             std::shared_ptr<const DatasetType> _examples;
             LossFunctionType _lossFunction;
@@ -117,6 +132,7 @@ namespace trainers
             double _lambda = 1.0;
             double _normalizedInverseLambda = 1.0;
             bool _permuteData = true;
+            size_t _numThreads = 1;
             bool _isInitialized = false;
         };
 
@@ -132,6 +148,8 @@ namespace trainers
 #include "Common.h"
 #include "Expression.h"
 
+#include <utilities/include/ParallelFor.h>
+
 #include <algorithm>
 #include <memory>
 #include <numeric>
@@ -175,9 +193,16 @@ namespace trainers
                 }
 
                 // process each example
-                for (size_t index : permutation)
+                if (_numThreads > 1 && permutation.size() > 1)
+                {
+                    ParallelEpoch(permutation);
+                }
+                else
                 {
-                    Step(_examples->Get(index), _exampleInfo[index]);
+                    for (size_t index : permutation)
+                    {
+                        Step(_examples->Get(index), _exampleInfo[index]);
+                    }
                 }
 
                 _areObjectivesValid = false;
@@ -213,6 +238,7 @@ namespace trainers
             _lambda = parameters.regularizationParameter;
             _normalizedInverseLambda = 1.0 / (_examples->Size() * parameters.regularizationParameter);
             _permuteData = parameters.permuteData;
+            _numThreads = utilities::GetNumThreads(parameters.numThreads);
         }
 
         template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
@@ -328,6 +354,67 @@ namespace trainers
             exampleInfo.dual = newDual;
         }
 
+        template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+        void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::ParallelEpoch(const std::vector<size_t>& permutation)
+        {
+            // with the CoCoA+ "adding" aggregation, each block's subproblem is made sigma = numBlocks times more conservative
+            auto numBlocks = std::min(_numThreads, permutation.size());
+            double sigma = static_cast<double>(numBlocks);
+            std::vector<BlockState> blocks(numBlocks);
+            utilities::ParallelFor(numBlocks, 0, permutation.size(), [&](size_t blockIndex, size_t begin, size_t end) {
+                auto& state = blocks[blockIndex];
+                auto firstExample = _examples->Get(0);
+                state.w.Resize(firstExample.input, firstExample.output);
+                state.v.Resize(firstExample.input, firstExample.output);
+                state.w = _w;
+                state.v = _v;
+                state.regularizer = _regularizer;
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto index = permutation[i];
+                    BlockStep(_examples->Get(index), _exampleInfo[index], state, sigma);
+                }
+            });
+
+            // each block's v has moved by sigma times its update
+            for (auto& state : blocks)
+            {
+                state.v -= _v;
+            }
+            for (const auto& state : blocks)
+            {
+                _v = _v * 1.0 + state.v * (1.0 / sigma);
+            }
+            _regularizer.ConjugateGradient(_v, _w);
+        }
+
+        template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+        void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::BlockStep(ExampleType example, ExampleInfo& exampleInfo, BlockState& state, double sigma)
+        {
+            const double tolerance = 1.0e-8;
+
+            auto& dual = exampleInfo.dual;
+
+            auto lipschitz = sigma * exampleInfo.norm2Squared * _normalizedInverseLambda;
+            if (lipschitz < tolerance)
+            {
+                return;
+            }
+
+            auto prediction = example.input * state.w;
+            prediction /= lipschitz;
+            prediction += dual;
+
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, prediction, example.output);
+            dual -= newDual;
+            dual *= sigma * _normalizedInverseLambda;
+
+            state.v += Transpose(example.input) * dual;
+            state.regularizer.ConjugateGradient(state.v, state.w);
+            exampleInfo.dual = newDual;
+        }
+
         template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
         SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType> MakeSDCAOptimizer(std::shared_ptr<const typename SolutionType::DatasetType> examples, LossFunctionType lossFunction, RegularizerType regularizer, SDCAOptimizerParameters parameters)
         {
@@ -106,6 +106,11 @@ int main()
     TestSDCARegressionConvergence(SquareLoss{}, MaxRegularizer{ 0 }, { .1, true }, 1.0e-4, 1.0, 1.0, 1.0);
     TestSDCARegressionConvergence(SquareLoss{}, MaxRegularizer{ 1 }, { 1, true }, 1.0e-4, 1.0, 1.0, 1.0);
 
+    // Test convergence of parallel SDCA on a synthetic regression problem
+
+    TestSDCARegressionConvergence(SquareLoss{}, L2Regularizer{}, { .1, true, 4 }, 1.0e-4, 1.0, 1.0, 1.0);
+    TestSDCARegressionConvergence(SquareLoss{}, MaxRegularizer{ 1 }, { 1, true, 4 }, 1.0e-4, 1.0, 1.0, 1.0);
+
     // Test convergence of SDCA on a synthetic classification problem
 
     TestSDCAClassificationConvergence(HingeLoss{}, L2Regularizer{}, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
@@ -113,6 +118,8 @@ int main()
     TestSDCAClassificationConvergence(SmoothedHingeLoss{}, L2Regularizer{}, { .01, true }, 1.0e-4, 1.0, 1.0, 3.0);
     TestSDCAClassificationConvergence(SquaredHingeLoss{}, L2Regularizer{}, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
 
+    TestSDCAClassificationConvergence(LogisticLoss{}, L2Regularizer{}, { .1, true, 4 }, 1.0e-4, 1.0, 1.0, 3.0);
+
     TestSDCAClassificationConvergence(HingeLoss{}, ElasticNetRegularizer{ 0 }, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
     TestSDCAClassificationConvergence(HingeLoss{}, ElasticNetRegularizer{ .5 }, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
     TestSDCAClassificationConvergence(LogisticLoss{}, ElasticNetRegularizer{ 0 }, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
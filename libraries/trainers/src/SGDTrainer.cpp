@@ -8,6 +8,10 @@
 
 #include "SGDTrainer.h"
 
+#include <utilities/include/ParallelFor.h>
+
+#include <numeric>
+
 namespace ell
 {
 namespace trainers
@@ -15,48 +19,48 @@ namespace trainers
 
     void SGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
+        _dataset = data::PackedDataset(anyDataset);
+        _order.resize(_dataset.NumExamples());
+        std::iota(_order.begin(), _order.end(), 0);
     }
 
     void SGDTrainerBase::Update()
     {
         // permute the data
-        _dataset.RandomPermute(_random);
-
-        // get example iterator
-        auto exampleIterator = _dataset.GetExampleReferenceIterator();
+        data::RandomPermute(_order, _random);
 
         // first iteration handled separately
-        if (_firstIteration && exampleIterator.IsValid())
+        size_t fromIndex = 0;
+        if (_firstIteration && _dataset.NumExamples() > 0)
         {
-            const auto& example = exampleIterator.Get();
-
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
+            auto x = GetDataVector(0);
+            double y = GetMetadata(0).label;
+            double weight = GetMetadata(0).weight;
 
             DoFirstStep(x, y, weight);
 
-            exampleIterator.Next();
+            fromIndex = 1;
             _firstIteration = false;
         }
 
-        while (exampleIterator.IsValid())
+        DoNextSteps(fromIndex);
+    }
+
+    void SGDTrainerBase::DoNextSteps(size_t fromIndex)
+    {
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
         {
             // get the Next example
-            const auto& example = exampleIterator.Get();
-
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
+            auto x = GetDataVector(index);
+            double y = GetMetadata(index).label;
+            double weight = GetMetadata(index).weight;
 
             DoNextStep(x, y, weight);
-
-            exampleIterator.Next();
         }
     }
 
-    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString)
+    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString, size_t numThreads) :
+        _numThreads(utilities::GetNumThreads(numThreads))
     {
         std::seed_seq seed(randomSeedString.begin(), randomSeedString.end());
         _random = std::default_random_engine(seed);
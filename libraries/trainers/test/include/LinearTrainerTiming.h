@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LinearTrainerTiming.h (trainers_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary> Times epochs of the linear trainers with increasing numbers of threads, and compares their training loss to the serial trainers. </summary>
+///
+/// <param name="numExamples"> The number of examples in the synthetic dataset. </param>
+/// <param name="dimension"> The dimension of the synthetic dataset. </param>
+/// <param name="numNonzeros"> The number of nonzeros in each example. </param>
+void TimeLinearTrainers(size_t numExamples, size_t dimension, size_t numNonzeros);
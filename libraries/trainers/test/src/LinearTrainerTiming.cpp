@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LinearTrainerTiming.cpp (trainers_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LinearTrainerTiming.h"
+
+#include <data/include/Dataset.h>
+
+#include <functions/include/L2Regularizer.h>
+#include <functions/include/LogLoss.h>
+
+#include <trainers/include/SDCATrainer.h>
+#include <trainers/include/SGDTrainer.h>
+
+#include <utilities/include/MillisecondTimer.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+const size_t numEpochs = 5;
+
+using TrainerType = trainers::ITrainer<predictors::LinearPredictor<double>>;
+
+// A sparse binary classification problem with a hidden linear separator
+data::AutoSupervisedDataset GetSparseClassificationDataset(size_t numExamples, size_t dimension, size_t numNonzeros)
+{
+    std::default_random_engine engine(1234);
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_int_distribution<size_t> indexDistribution(0, dimension - 1);
+
+    std::vector<double> separator(dimension);
+    std::generate(separator.begin(), separator.end(), [&]() { return normal(engine); });
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        std::vector<data::IndexValue> entries;
+        double margin = 0.5;
+        for (size_t j = 0; j < numNonzeros; ++j)
+        {
+            entries.push_back({ indexDistribution(engine), normal(engine) });
+        }
+        std::sort(entries.begin(), entries.end(), [](const data::IndexValue& a, const data::IndexValue& b) { return a.index < b.index; });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const data::IndexValue& a, const data::IndexValue& b) { return a.index == b.index; }), entries.end());
+
+        for (const auto& entry : entries)
+        {
+            margin += entry.value * separator[entry.index];
+        }
+        dataset.AddExample({ data::AutoDataVector(std::move(entries)), { 1.0, margin > 0 ? 1.0 : -1.0 } });
+    }
+    return dataset;
+}
+
+double GetAverageLoss(const data::AutoSupervisedDataset& dataset, const predictors::LinearPredictor<double>& predictor)
+{
+    functions::LogLoss lossFunction;
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        loss += lossFunction(predictor.Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    return loss / dataset.NumExamples();
+}
+
+void TimeTrainer(const std::string& name, const data::AutoSupervisedDataset& dataset, std::function<std::unique_ptr<TrainerType>(size_t)> makeTrainer, const std::vector<size_t>& threadCounts)
+{
+    double serialTime = 0;
+    for (auto numThreads : threadCounts)
+    {
+        auto trainer = makeTrainer(numThreads);
+        trainer->SetDataset(dataset.GetAnyDataset());
+
+        utilities::MillisecondTimer timer;
+        for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
+        double time = static_cast<double>(timer.Elapsed()) / numEpochs;
+        if (numThreads == 1)
+        {
+            serialTime = time;
+        }
+
+        std::cout << std::setw(22) << std::left << name << std::right
+                  << "  threads: " << std::setw(3) << numThreads
+                  << "  ms/epoch: " << std::setw(8) << std::fixed << std::setprecision(1) << time
+                  << "  speedup: " << std::setw(5) << std::setprecision(2) << (time > 0 ? serialTime / time : 0)
+                  << "  training loss: " << std::setprecision(5) << GetAverageLoss(dataset, trainer->GetPredictor()) << std::endl;
+    }
+}
+} // namespace
+
+void TimeLinearTrainers(size_t numExamples, size_t dimension, size_t numNonzeros)
+{
+    std::cout << "Creating a sparse dataset with " << numExamples << " examples of dimension " << dimension << " (" << numNonzeros << " nonzeros each)" << std::endl;
+    auto dataset = GetSparseClassificationDataset(numExamples, dimension, numNonzeros);
+
+    std::vector<size_t> threadCounts;
+    size_t maxThreads = std::max(std::thread::hardware_concurrency(), 4u);
+    for (size_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+    {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    const double regularization = 1.0e-5;
+    TimeTrainer("SparseDataSGD", dataset, [&](size_t numThreads) { return trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { regularization, "XYZ", numThreads }); }, threadCounts);
+    TimeTrainer("SDCA", dataset, [&](size_t numThreads) { return trainers::MakeSDCATrainer(functions::LogLoss(), functions::L2Regularizer(), { regularization, 1.0e-8, numEpochs, true, "XYZ", numThreads }); }, threadCounts);
+}
@@ -12,12 +12,20 @@
 #include <functions/include/LogLoss.h>
 #include <functions/include/SquaredLoss.h>
 
+#include <trainers/include/HistogramForestTrainer.h>
+#include <trainers/include/LogitBooster.h>
 #include <trainers/include/MeanCalculator.h>
 #include <trainers/include/SDCATrainer.h>
 #include <trainers/include/SGDTrainer.h>
+#include <trainers/include/SortingForestTrainer.h>
+#include <trainers/include/ThresholdFinder.h>
 
 #include <testing/include/testing.h>
 
+#include <cmath>
+#include <random>
+#include <string>
+
 using namespace ell;
 
 /// Runs all tests
@@ -117,6 +125,180 @@ void TestSGDTrainer()
     return;
 }
 
+// A sparse binary classification problem with a hidden linear separator
+data::AutoSupervisedDataset GetSparseClassificationDataset(size_t numExamples, size_t dimension, size_t numNonzeros)
+{
+    std::default_random_engine engine(1234);
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_int_distribution<size_t> indexDistribution(0, dimension - 1);
+
+    std::vector<double> separator(dimension);
+    for (auto& value : separator)
+    {
+        value = normal(engine);
+    }
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        std::vector<double> x(dimension);
+        double margin = 0.5;
+        for (size_t j = 0; j < numNonzeros; ++j)
+        {
+            auto index = indexDistribution(engine);
+            x[index] = normal(engine);
+            margin += x[index] * separator[index];
+        }
+        dataset.AddExample({ data::AutoDataVector(x), { 1.0, margin > 0 ? 1.0 : -1.0 } });
+    }
+    return dataset;
+}
+
+template <typename LossFunctionType>
+double GetAverageLoss(const data::AutoSupervisedDataset& dataset, const predictors::LinearPredictor<double>& predictor, const LossFunctionType& lossFunction)
+{
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        loss += lossFunction(predictor.Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    return loss / dataset.NumExamples();
+}
+
+template <typename TrainerType>
+double TrainAndGetLoss(TrainerType& trainer, const data::AutoSupervisedDataset& dataset, size_t numEpochs)
+{
+    trainer->SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    {
+        trainer->Update();
+    }
+    return GetAverageLoss(dataset, trainer->GetPredictor(), functions::LogLoss());
+}
+
+// Checks that the lock-free parallel SGD trainers reach (nearly) the same training loss as the serial ones
+void TestParallelSGDTrainers()
+{
+    auto dataset = GetSparseClassificationDataset(4000, 200, 10);
+    const size_t numEpochs = 10;
+
+    auto serialTrainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { 1.0e-3, "XYZ" });
+    auto parallelTrainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { 1.0e-3, "XYZ", 4 });
+    auto serialLoss = TrainAndGetLoss(serialTrainer, dataset, numEpochs);
+    auto parallelLoss = TrainAndGetLoss(parallelTrainer, dataset, numEpochs);
+    testing::ProcessTest("TestParallelSGDTrainers SparseDataSGD (serial loss " + std::to_string(serialLoss) + ", parallel loss " + std::to_string(parallelLoss) + ")", parallelLoss < 1.05 * serialLoss + 0.01);
+
+    auto mean = trainers::CalculateMean(dataset.GetAnyDataset());
+    auto serialCenteredTrainer = trainers::MakeSparseDataCenteredSGDTrainer(functions::LogLoss(), mean, { 1.0e-3, "XYZ" });
+    auto parallelCenteredTrainer = trainers::MakeSparseDataCenteredSGDTrainer(functions::LogLoss(), mean, { 1.0e-3, "XYZ", 4 });
+    serialLoss = TrainAndGetLoss(serialCenteredTrainer, dataset, numEpochs);
+    parallelLoss = TrainAndGetLoss(parallelCenteredTrainer, dataset, numEpochs);
+    testing::ProcessTest("TestParallelSGDTrainers SparseDataCenteredSGD (serial loss " + std::to_string(serialLoss) + ", parallel loss " + std::to_string(parallelLoss) + ")", parallelLoss < 1.05 * serialLoss + 0.01);
+}
+
+// Checks that parallel SDCA converges to the same optimum as serial SDCA
+void TestParallelSDCATrainer()
+{
+    auto dataset = GetSparseClassificationDataset(4000, 200, 10);
+    const size_t numEpochs = 30;
+
+    using TrainerType = trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer>;
+    auto serialTrainer = std::make_unique<TrainerType>(functions::LogLoss(), functions::L2Regularizer(), trainers::SDCATrainerParameters{ 1.0e-3, 1.0e-8, numEpochs, true, "XYZ" });
+    auto parallelTrainer = std::make_unique<TrainerType>(functions::LogLoss(), functions::L2Regularizer(), trainers::SDCATrainerParameters{ 1.0e-3, 1.0e-8, numEpochs, true, "XYZ", 4 });
+    TrainAndGetLoss(serialTrainer, dataset, numEpochs);
+    TrainAndGetLoss(parallelTrainer, dataset, numEpochs);
+
+    auto serialInfo = serialTrainer->GetPredictorInfo();
+    auto parallelInfo = parallelTrainer->GetPredictorInfo();
+    auto parallelGap = parallelInfo.primalObjective - parallelInfo.dualObjective;
+    testing::ProcessTest("TestParallelSDCATrainer duality gap", parallelGap >= -1.0e-8 && parallelGap < 1.0e-3);
+    testing::ProcessTest("TestParallelSDCATrainer primal objective", std::abs(parallelInfo.primalObjective - serialInfo.primalObjective) < 1.0e-3);
+}
+
+// A dense binary classification problem whose label depends on a few of the features
+data::AutoSupervisedDataset GetDenseClassificationDataset(size_t numExamples, size_t dimension)
+{
+    std::default_random_engine engine(1234);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        std::vector<double> x(dimension);
+        for (auto& value : x)
+        {
+            value = uniform(engine);
+        }
+        double label = (x[0] > 0.2) != (x[dimension / 2] < -0.3) ? 1.0 : -1.0;
+        dataset.AddExample({ data::AutoDataVector(x), { 1.0, label } });
+    }
+    return dataset;
+}
+
+template <typename TrainerType>
+std::vector<double> TrainAndGetForestOutputs(TrainerType& trainer, const data::AutoSupervisedDataset& dataset)
+{
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    std::vector<double> outputs;
+    const auto& forest = trainer->GetPredictor();
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        outputs.push_back(forest.Predict(dataset[i].GetDataVector().CopyAs<data::FloatDataVector>()));
+    }
+    return outputs;
+}
+
+double GetForestTrainingError(const std::vector<double>& outputs, const data::AutoSupervisedDataset& dataset)
+{
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        if (outputs[i] * dataset[i].GetMetadata().label <= 0)
+        {
+            ++numErrors;
+        }
+    }
+    return static_cast<double>(numErrors) / dataset.NumExamples();
+}
+
+// Checks that the multi-threaded forest trainers grow the same forests as the single-threaded ones
+void TestParallelForestTrainers()
+{
+    auto dataset = GetDenseClassificationDataset(2000, 32);
+
+    trainers::HistogramForestTrainerParameters histogramParameters;
+    histogramParameters.minSplitGain = 0.0;
+    histogramParameters.maxSplitsPerRound = 8;
+    histogramParameters.numRounds = 4;
+    histogramParameters.randomSeed = "XYZ";
+    histogramParameters.thresholdFinderSampleSize = 1000;
+    histogramParameters.candidatesPerInput = 8;
+
+    auto serialHistogramTrainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), histogramParameters);
+    histogramParameters.numThreads = 4;
+    auto parallelHistogramTrainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), histogramParameters);
+    auto serialOutputs = TrainAndGetForestOutputs(serialHistogramTrainer, dataset);
+    auto parallelOutputs = TrainAndGetForestOutputs(parallelHistogramTrainer, dataset);
+    testing::ProcessTest("TestParallelForestTrainers HistogramForestTrainer outputs", serialOutputs == parallelOutputs);
+    testing::ProcessTest("TestParallelForestTrainers HistogramForestTrainer training error", GetForestTrainingError(parallelOutputs, dataset) < 0.1);
+
+    trainers::SortingForestTrainerParameters sortingParameters;
+    sortingParameters.minSplitGain = 0.0;
+    sortingParameters.maxSplitsPerRound = 8;
+    sortingParameters.numRounds = 4;
+
+    auto serialSortingTrainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), sortingParameters);
+    sortingParameters.numThreads = 4;
+    auto parallelSortingTrainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), sortingParameters);
+    serialOutputs = TrainAndGetForestOutputs(serialSortingTrainer, dataset);
+    parallelOutputs = TrainAndGetForestOutputs(parallelSortingTrainer, dataset);
+    testing::ProcessTest("TestParallelForestTrainers SortingForestTrainer outputs", serialOutputs == parallelOutputs);
+    testing::ProcessTest("TestParallelForestTrainers SortingForestTrainer training error", GetForestTrainingError(parallelOutputs, dataset) < 0.1);
+}
+
 void TestMeanCalculator()
 {
     data::AutoSupervisedDataset dataset;
@@ -135,5 +317,8 @@ int main()
 {
     TestSDCATrainer();
     TestSGDTrainer();
+    TestParallelSGDTrainers();
+    TestParallelSDCATrainer();
+    TestParallelForestTrainers();
     TestMeanCalculator();
 }
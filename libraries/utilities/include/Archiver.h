@@ -135,6 +135,8 @@ namespace utilities
 #define ARCHIVABLE_TYPES_LIST      \
     ARCHIVE_TYPE_OP(bool)          \
     ARCHIVE_TYPE_OP(char)          \
+    ARCHIVE_TYPE_OP(int8_t)        \
+    ARCHIVE_TYPE_OP(uint8_t)       \
     ARCHIVE_TYPE_OP(short)         \
     ARCHIVE_TYPE_OP(int)           \
     ARCHIVE_TYPE_OP(unsigned int)  \
@@ -147,6 +149,8 @@ namespace utilities
 #define ARCHIVABLE_TYPES_LIST     \
     ARCHIVE_TYPE_OP(bool)         \
     ARCHIVE_TYPE_OP(char)         \
+    ARCHIVE_TYPE_OP(int8_t)       \
+    ARCHIVE_TYPE_OP(uint8_t)      \
     ARCHIVE_TYPE_OP(short)        \
     ARCHIVE_TYPE_OP(int)          \
     ARCHIVE_TYPE_OP(unsigned int) \
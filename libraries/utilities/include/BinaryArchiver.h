@@ -0,0 +1,359 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.h (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Archiver.h"
+#include "Exception.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// The tags that start each record of a binary archive. A record is a tag, a name, and a payload
+    /// that depends on the tag. The `end` record closes an object or an array of objects, and has no name.
+    /// </summary>
+    enum class BinaryArchiveTag : uint8_t
+    {
+        end = 0,
+        null,
+        boolValue,
+        charValue,
+        int16Value,
+        int32Value,
+        uint32Value,
+        int64Value,
+        uint64Value,
+        floatValue,
+        doubleValue,
+        string,
+        array,
+        stringArray,
+        object,
+        primitiveObject,
+        objectArray,
+        int8Value,
+        uint8Value
+    };
+
+    /// <summary>
+    /// An archiver that encodes data in a compact binary format. Arrays of fundamental types are
+    /// written as raw bytes, starting at an offset from the start of the archive that is a multiple of
+    /// `BinaryArchiver::arrayAlignment`, so they can be read straight out of a memory-mapped file.
+    /// Values are written in the byte order of the machine that writes the archive.
+    /// </summary>
+    class BinaryArchiver : public Archiver
+    {
+    public:
+        /// <summary> The alignment of the array contents, relative to the start of the archive. </summary>
+        static constexpr size_t arrayAlignment = 64;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="outputStream"> The stream to write data to. It should be opened in binary mode. </param>
+        BinaryArchiver(std::ostream& outputStream);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveValue(const char* name, const std::string& value) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveNull(const char* name) override;
+
+        void ArchiveArray(const char* name, const std::vector<std::string>& array) override;
+        void ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array) override;
+
+        void BeginArchiveObject(const char* name, const IArchivable& value) override;
+        void EndArchiveObject(const char* name, const IArchivable& value) override;
+
+    private:
+        // Serialization
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void WriteScalar(const char* name, const ValueType& value);
+
+        template <typename ValueType>
+        void WriteArray(const char* name, const std::vector<ValueType>& array);
+
+        void WriteArray(const char* name, const std::vector<bool>& array);
+
+        void WriteRecordHeader(BinaryArchiveTag tag, const char* name);
+        void WriteString(const std::string& value);
+        void WritePadding(size_t alignment);
+        void WriteBytes(const void* data, size_t size);
+
+        template <typename ValueType>
+        void WriteRaw(const ValueType& value);
+
+        std::ostream& _out;
+        size_t _position = 0;
+    };
+
+    /// <summary>
+    /// An unarchiver that reads data encoded by a BinaryArchiver. It reads from a contiguous buffer,
+    /// usually a memory-mapped file, and copies each array out of the buffer with a single `memcpy`.
+    /// </summary>
+    class BinaryUnarchiver : public Unarchiver
+    {
+    public:
+        /// <summary> Constructor that reads the whole stream into a buffer owned by the unarchiver. </summary>
+        ///
+        /// <param name="inputStream"> The stream to read data from. It should be opened in binary mode. </param>
+        /// <param name="context"> The serialization context. </param>
+        BinaryUnarchiver(std::istream& inputStream, SerializationContext context);
+
+        /// <summary> Constructor that reads from a buffer, which must outlive the unarchiver. </summary>
+        ///
+        /// <param name="data"> The start of the archive, for instance the contents of a MemoryMappedFile. </param>
+        /// <param name="size"> The size of the archive, in bytes. </param>
+        /// <param name="context"> The serialization context. </param>
+        BinaryUnarchiver(const char* data, size_t size, SerializationContext context);
+
+        /// <summary> Indicates if a property with the given name is available to be read next </summary>
+        ///
+        /// <param name="name"> The name of the property </param>
+        ///
+        /// <returns> true if a property with the given name can be read next </returns>
+        bool HasNextPropertyName(const std::string& name) override;
+
+        /// <summary> Checks if a buffer starts with the header of a binary archive. </summary>
+        ///
+        /// <param name="data"> The start of the buffer. </param>
+        /// <param name="size"> The size of the buffer, in bytes. </param>
+        ///
+        /// <returns> true if the buffer starts with a binary archive header. </returns>
+        static bool IsBinaryArchive(const char* data, size_t size);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveValue(const char* name, std::string& value) override;
+
+        bool UnarchiveNull(const char* name) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveArray(const char* name, std::vector<std::string>& array) override;
+
+        void BeginUnarchiveArray(const char* name, const std::string& typeName) override;
+        bool BeginUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArray(const char* name, const std::string& typeName) override;
+
+        ArchivedObjectInfo BeginUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObject(const char* name, IArchivable& value) override;
+        void EndUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObjectAsPrimitive(const char* name, IArchivable& value) override;
+
+    private:
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadScalar(const char* name, ValueType& value);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadArray(const char* name, std::vector<ValueType>& array);
+
+        void ReadArray(const char* name, std::vector<bool>& array);
+
+        template <typename ValueType>
+        ValueType ReadNumber(BinaryArchiveTag tag);
+
+        size_t ReadArraySize(BinaryArchiveTag elementTag);
+
+        void ReadHeader();
+        BinaryArchiveTag PeekTag() const;
+        void MatchRecordHeader(BinaryArchiveTag tag, const char* name);
+        std::string ReadString();
+        void SkipPadding(size_t alignment);
+        const char* ReadBytes(size_t size);
+
+        template <typename ValueType>
+        ValueType ReadRaw();
+
+        std::string _ownedData;
+        const char* _data = nullptr;
+        size_t _size = 0;
+        size_t _position = 0;
+    };
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    namespace BinaryArchiverImpl
+    {
+        template <typename ValueType>
+        constexpr BinaryArchiveTag GetTag()
+        {
+            static_assert(std::is_arithmetic<ValueType>::value, "Only fundamental types have binary archive tags");
+
+            // integers are matched by size rather than by name, so types like `unsigned long` get the tag of their fixed-width equivalent
+            if (std::is_same<ValueType, bool>::value)
+            {
+                return BinaryArchiveTag::boolValue;
+            }
+            if (std::is_same<ValueType, char>::value)
+            {
+                return BinaryArchiveTag::charValue;
+            }
+            if (std::is_floating_point<ValueType>::value)
+            {
+                return sizeof(ValueType) == sizeof(float) ? BinaryArchiveTag::floatValue : BinaryArchiveTag::doubleValue;
+            }
+            if (sizeof(ValueType) == 1)
+            {
+                return std::is_signed<ValueType>::value ? BinaryArchiveTag::int8Value : BinaryArchiveTag::uint8Value;
+            }
+            if (sizeof(ValueType) == 2)
+            {
+                return BinaryArchiveTag::int16Value;
+            }
+            if (sizeof(ValueType) == 4)
+            {
+                return std::is_signed<ValueType>::value ? BinaryArchiveTag::int32Value : BinaryArchiveTag::uint32Value;
+            }
+            return std::is_signed<ValueType>::value ? BinaryArchiveTag::int64Value : BinaryArchiveTag::uint64Value;
+        }
+    } // namespace BinaryArchiverImpl
+
+    //
+    // Serialization
+    //
+    template <typename ValueType>
+    void BinaryArchiver::WriteRaw(const ValueType& value)
+    {
+        WriteBytes(&value, sizeof(ValueType));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryArchiver::WriteScalar(const char* name, const ValueType& value)
+    {
+        WriteRecordHeader(BinaryArchiverImpl::GetTag<ValueType>(), name);
+        WriteRaw(value);
+    }
+
+    template <>
+    inline void BinaryArchiver::WriteScalar(const char* name, const bool& value)
+    {
+        WriteRecordHeader(BinaryArchiveTag::boolValue, name);
+        WriteRaw(static_cast<uint8_t>(value ? 1 : 0));
+    }
+
+    template <typename ValueType>
+    void BinaryArchiver::WriteArray(const char* name, const std::vector<ValueType>& array)
+    {
+        WriteRecordHeader(BinaryArchiveTag::array, name);
+        WriteRaw(BinaryArchiverImpl::GetTag<ValueType>());
+        WriteRaw(static_cast<uint64_t>(array.size()));
+        WritePadding(arrayAlignment);
+        WriteBytes(array.data(), array.size() * sizeof(ValueType));
+    }
+
+    //
+    // Deserialization
+    //
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadRaw()
+    {
+        ValueType value;
+        std::memcpy(&value, ReadBytes(sizeof(ValueType)), sizeof(ValueType));
+        return value;
+    }
+
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadNumber(BinaryArchiveTag tag)
+    {
+        switch (tag)
+        {
+        case BinaryArchiveTag::boolValue:
+            return static_cast<ValueType>(ReadRaw<uint8_t>() != 0);
+        case BinaryArchiveTag::charValue:
+            return static_cast<ValueType>(ReadRaw<char>());
+        case BinaryArchiveTag::int8Value:
+            return static_cast<ValueType>(ReadRaw<int8_t>());
+        case BinaryArchiveTag::uint8Value:
+            return static_cast<ValueType>(ReadRaw<uint8_t>());
+        case BinaryArchiveTag::int16Value:
+            return static_cast<ValueType>(ReadRaw<int16_t>());
+        case BinaryArchiveTag::int32Value:
+            return static_cast<ValueType>(ReadRaw<int32_t>());
+        case BinaryArchiveTag::uint32Value:
+            return static_cast<ValueType>(ReadRaw<uint32_t>());
+        case BinaryArchiveTag::int64Value:
+            return static_cast<ValueType>(ReadRaw<int64_t>());
+        case BinaryArchiveTag::uint64Value:
+            return static_cast<ValueType>(ReadRaw<uint64_t>());
+        case BinaryArchiveTag::floatValue:
+            return static_cast<ValueType>(ReadRaw<float>());
+        case BinaryArchiveTag::doubleValue:
+            return static_cast<ValueType>(ReadRaw<double>());
+        default:
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting a number");
+        }
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadScalar(const char* name, ValueType& value)
+    {
+        auto tag = PeekTag();
+        MatchRecordHeader(tag, name);
+        value = ReadNumber<ValueType>(tag);
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadArray(const char* name, std::vector<ValueType>& array)
+    {
+        MatchRecordHeader(BinaryArchiveTag::array, name);
+        auto elementTag = ReadRaw<BinaryArchiveTag>();
+        auto size = ReadArraySize(elementTag);
+
+        // copy the contents in one go if they were written with the same type, and convert them element by element otherwise
+        if (elementTag == BinaryArchiverImpl::GetTag<ValueType>())
+        {
+            auto contents = ReadBytes(size * sizeof(ValueType));
+            array.resize(size);
+            if (size > 0)
+            {
+                std::memcpy(static_cast<void*>(array.data()), contents, size * sizeof(ValueType));
+            }
+        }
+        else
+        {
+            array.reserve(size);
+            for (size_t index = 0; index < size; ++index)
+            {
+                array.push_back(ReadNumber<ValueType>(elementTag));
+            }
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
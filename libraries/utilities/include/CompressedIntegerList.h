@@ -67,6 +67,8 @@ namespace utilities
 
         void operator=(const CompressedIntegerList&) = delete;
 
+        CompressedIntegerList& operator=(CompressedIntegerList&&) = default;
+
         /// <summary> Returns The number of entries in the list. </summary>
         ///
         /// <returns> An size_t. </returns>
@@ -87,6 +89,15 @@ namespace utilities
         /// <param name="value"> The value. </param>
         void Append(size_t value);
 
+        /// <summary> Starts a new segment of the list. The next value appended is not encoded relative to the
+        /// previous one, so it can be smaller, and the segment can be traversed on its own. </summary>
+        void BeginSegment();
+
+        /// <summary> Returns the number of bytes used by the encoding, which is the end position of the last segment. </summary>
+        ///
+        /// <returns> The number of bytes. </returns>
+        size_t NumBytes() const { return _data.size(); }
+
         /// <summary> Deletes all of the std::vector content and sets its Size to zero. </summary>
         void Reset();
 
@@ -95,9 +106,18 @@ namespace utilities
         /// <returns> The iterator. </returns>
         Iterator GetIterator() const { return Iterator(_data.data(), _data.data() + _data.size()); }
 
+        /// <summary> Returns an `Iterator` over a segment of the list. </summary>
+        ///
+        /// <param name="beginByte"> The value of NumBytes() when the segment was begun. </param>
+        /// <param name="endByte"> The value of NumBytes() when the segment was ended. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        Iterator GetIterator(size_t beginByte, size_t endByte) const { return Iterator(_data.data() + beginByte, _data.data() + endByte); }
+
     private:
         std::vector<uint8_t> _data;
         size_t _last;
+        size_t _max;
         size_t _size;
     };
 } // namespace utilities
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -68,6 +69,41 @@ namespace utilities
     /// <returns> true if the file exists. </returns>
     bool FileExists(const std::string& filepath);
 
+    /// <summary> Returns the size of a file, and throws an exception if it doesn't exist. </summary>
+    ///
+    /// <param name="filepath"> The path. </param>
+    ///
+    /// <returns> The size of the file, in bytes. </returns>
+    uint64_t GetFileSize(const std::string& filepath);
+
+    /// <summary>
+    /// Returns the time a file was last modified, and throws an exception if it doesn't exist. The time is only meant to be
+    /// compared with other times returned by this function: its unit and epoch depend on the platform.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path. </param>
+    ///
+    /// <returns> The modification time. </returns>
+    int64_t GetFileModificationTime(const std::string& filepath);
+
+    /// <summary> Returns a path for a temporary file next to the given file, which no other process or call gets. </summary>
+    ///
+    /// <param name="filepath"> The path of the file the temporary file will replace. </param>
+    ///
+    /// <returns> The path of the temporary file. </returns>
+    std::string GetTemporaryFilePath(const std::string& filepath);
+
+    /// <summary>
+    /// Renames a file, replacing the file at the destination if there is one. On the same file system, the replacement
+    /// is atomic: a process opening the destination sees either the old file or the new one.
+    /// </summary>
+    ///
+    /// <param name="sourcePath"> The path of the file to rename. </param>
+    /// <param name="destinationPath"> The new path of the file. </param>
+    ///
+    /// <returns> true if the file was renamed. </returns>
+    bool ReplaceFile(const std::string& sourcePath, const std::string& destinationPath);
+
     /// <summary> Returns the file extension, optionally converted to lower-case. </summary>
     ///
     /// <param name="filepath"> The path. </param>
@@ -193,7 +193,8 @@ namespace utilities
         {
             _out << "\"" << name << "\": ";
         }
-        _out << value;
+        // 1-byte integers would be written as characters, so write them as numbers, which is how they are read
+        _out << std::conditional_t<std::is_integral<ValueType>::value && sizeof(ValueType) == 1, int, const ValueType&>(value);
         SetEndOfLine(endOfLine);
     }
 
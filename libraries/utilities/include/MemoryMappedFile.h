@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> A read-only view of the contents of a file, mapped into memory. The pages are loaded on demand by the OS. </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Maps a file into memory, and throws an exception if a problem occurs. </summary>
+        ///
+        /// <param name="filepath"> The path. </param>
+        MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// <summary> Move constructor. </summary>
+        MemoryMappedFile(MemoryMappedFile&& other);
+
+        /// <summary> Unmaps the file. </summary>
+        ~MemoryMappedFile();
+
+        /// <summary> Gets a pointer to the start of the mapped contents. The pointer is page-aligned. </summary>
+        ///
+        /// <returns> A pointer to the file contents, or nullptr if the file is empty. </returns>
+        const char* GetData() const { return _data; }
+
+        /// <summary> Gets the size of the file. </summary>
+        ///
+        /// <returns> The size of the file, in bytes. </returns>
+        size_t Size() const { return _size; }
+
+    private:
+        void Unmap();
+
+        const char* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _mappingHandle = nullptr;
+#endif
+    };
+} // namespace utilities
+} // namespace ell
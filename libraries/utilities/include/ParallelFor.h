@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelFor.h (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> Gets the number of threads to use when the caller asks for `numThreads` (0 means one per hardware thread). </summary>
+    ///
+    /// <param name="numThreads"> The requested number of threads, or 0 for the number of hardware threads. </param>
+    ///
+    /// <returns> The number of threads to use, which is at least 1. </returns>
+    inline size_t GetNumThreads(size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        return std::max<size_t>(numThreads, 1);
+    }
+
+    /// <summary> Atomically adds a value to an atomic floating-point variable. </summary>
+    ///
+    /// <param name="variable"> The variable to update. </param>
+    /// <param name="value"> The value to add. </param>
+    ///
+    /// <returns> The value of the variable just after the addition. </returns>
+    template <typename ValueType>
+    ValueType AtomicAdd(std::atomic<ValueType>& variable, ValueType value)
+    {
+        auto oldValue = variable.load(std::memory_order_relaxed);
+        while (!variable.compare_exchange_weak(oldValue, oldValue + value, std::memory_order_relaxed))
+        {
+        }
+        return oldValue + value;
+    }
+
+    /// <summary>
+    /// Splits the range [begin, end) into `numThreads` contiguous blocks of (nearly) equal size and calls
+    /// `function(blockIndex, blockBegin, blockEnd)` on each block. Block 0 runs on the calling thread and
+    /// the others run on their own threads. Returns when all the blocks are done, and rethrows the first
+    /// exception thrown by any block.
+    /// </summary>
+    ///
+    /// <typeparam name="FunctionType"> A callable with signature `void(size_t, size_t, size_t)`. </typeparam>
+    /// <param name="numThreads"> The number of blocks (and threads) to use. </param>
+    /// <param name="begin"> The first index of the range. </param>
+    /// <param name="end"> One past the last index of the range. </param>
+    /// <param name="function"> The function to call on each block. </param>
+    template <typename FunctionType>
+    void ParallelFor(size_t numThreads, size_t begin, size_t end, FunctionType&& function)
+    {
+        numThreads = std::max<size_t>(numThreads, 1);
+        auto count = end > begin ? end - begin : 0;
+        auto GetBlockBegin = [=](size_t blockIndex) { return begin + (count * blockIndex) / numThreads; };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(numThreads - 1);
+        for (size_t blockIndex = 1; blockIndex < numThreads; ++blockIndex)
+        {
+            futures.push_back(std::async(std::launch::async, [&function, blockIndex, blockBegin = GetBlockBegin(blockIndex), blockEnd = GetBlockBegin(blockIndex + 1)]() {
+                function(blockIndex, blockBegin, blockEnd);
+            }));
+        }
+
+        // make sure all the threads are joined before an exception leaves this function
+        std::exception_ptr exception;
+        try
+        {
+            function(size_t{ 0 }, begin, GetBlockBegin(1));
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        for (auto& future : futures)
+        {
+            try
+            {
+                future.get();
+            }
+            catch (...)
+            {
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+            }
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+} // namespace utilities
+} // namespace ell
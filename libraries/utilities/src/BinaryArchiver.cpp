@@ -0,0 +1,419 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.cpp (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryArchiver.h"
+#include "Archiver.h"
+#include "IArchivable.h"
+#include "Unused.h"
+
+#include <iterator>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // the header is the magic string, the format version, and a marker to detect archives written with another byte order
+        const char binaryArchiveMagic[4] = { 'E', 'L', 'L', 'B' };
+        const uint32_t binaryArchiveFormatVersion = 1;
+        const uint32_t binaryArchiveByteOrderMark = 0x01020304;
+        const size_t binaryArchiveHeaderSize = sizeof(binaryArchiveMagic) + sizeof(binaryArchiveFormatVersion) + sizeof(binaryArchiveByteOrderMark);
+
+        size_t GetPaddingSize(size_t position, size_t alignment)
+        {
+            return (alignment - position % alignment) % alignment;
+        }
+
+        // The number of bytes a number with the given tag takes up in the archive
+        size_t GetNumberSize(BinaryArchiveTag tag)
+        {
+            switch (tag)
+            {
+            case BinaryArchiveTag::boolValue:
+            case BinaryArchiveTag::charValue:
+            case BinaryArchiveTag::int8Value:
+            case BinaryArchiveTag::uint8Value:
+                return 1;
+            case BinaryArchiveTag::int16Value:
+                return 2;
+            case BinaryArchiveTag::int32Value:
+            case BinaryArchiveTag::uint32Value:
+            case BinaryArchiveTag::floatValue:
+                return 4;
+            case BinaryArchiveTag::int64Value:
+            case BinaryArchiveTag::uint64Value:
+            case BinaryArchiveTag::doubleValue:
+                return 8;
+            default:
+                throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting an array of numbers");
+            }
+        }
+    } // namespace
+
+    //
+    // Serialization
+    //
+    BinaryArchiver::BinaryArchiver(std::ostream& outputStream) :
+        _out(outputStream)
+    {
+        WriteBytes(binaryArchiveMagic, sizeof(binaryArchiveMagic));
+        WriteRaw(binaryArchiveFormatVersion);
+        WriteRaw(binaryArchiveByteOrderMark);
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_VALUE(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryArchiver::ArchiveValue(const char* name, const std::string& value)
+    {
+        WriteRecordHeader(BinaryArchiveTag::string, name);
+        WriteString(value);
+    }
+
+    void BinaryArchiver::ArchiveNull(const char* name)
+    {
+        WriteRecordHeader(BinaryArchiveTag::null, name);
+    }
+
+    // IArchivable
+    void BinaryArchiver::BeginArchiveObject(const char* name, const IArchivable& value)
+    {
+        // an object archived as a primitive is followed by the single unnamed value it archives
+        if (value.ArchiveAsPrimitive())
+        {
+            WriteRecordHeader(BinaryArchiveTag::primitiveObject, name);
+            return;
+        }
+
+        WriteRecordHeader(BinaryArchiveTag::object, name);
+        WriteString(GetArchivedTypeName(value));
+        WriteRaw(static_cast<int32_t>(GetArchiveVersion(value).versionNumber));
+    }
+
+    void BinaryArchiver::EndArchiveObject(const char* name, const IArchivable& value)
+    {
+        UNUSED(name);
+        if (!value.ArchiveAsPrimitive())
+        {
+            WriteRaw(BinaryArchiveTag::end);
+        }
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_ARRAY(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryArchiver::WriteArray(const char* name, const std::vector<bool>& array)
+    {
+        // std::vector<bool> is packed, so write one byte per element instead
+        WriteRecordHeader(BinaryArchiveTag::array, name);
+        WriteRaw(BinaryArchiveTag::boolValue);
+        WriteRaw(static_cast<uint64_t>(array.size()));
+        WritePadding(arrayAlignment);
+        for (bool value : array)
+        {
+            WriteRaw(static_cast<uint8_t>(value ? 1 : 0));
+        }
+    }
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::vector<std::string>& array)
+    {
+        WriteRecordHeader(BinaryArchiveTag::stringArray, name);
+        WriteRaw(static_cast<uint64_t>(array.size()));
+        for (const auto& value : array)
+        {
+            WriteString(value);
+        }
+    }
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array)
+    {
+        UNUSED(baseTypeName);
+        WriteRecordHeader(BinaryArchiveTag::objectArray, name);
+        for (const auto& item : array)
+        {
+            Archive(*item);
+        }
+        WriteRaw(BinaryArchiveTag::end);
+    }
+
+    void BinaryArchiver::WriteRecordHeader(BinaryArchiveTag tag, const char* name)
+    {
+        WriteRaw(tag);
+        WriteString(name);
+    }
+
+    void BinaryArchiver::WriteString(const std::string& value)
+    {
+        WriteRaw(static_cast<uint64_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    void BinaryArchiver::WritePadding(size_t alignment)
+    {
+        static const char zeros[arrayAlignment] = {};
+        WriteBytes(zeros, GetPaddingSize(_position, alignment));
+    }
+
+    void BinaryArchiver::WriteBytes(const void* data, size_t size)
+    {
+        _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        _position += size;
+    }
+
+    //
+    // Deserialization
+    //
+    BinaryUnarchiver::BinaryUnarchiver(std::istream& inputStream, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _ownedData(std::istreambuf_iterator<char>(inputStream), std::istreambuf_iterator<char>())
+    {
+        _data = _ownedData.data();
+        _size = _ownedData.size();
+        ReadHeader();
+    }
+
+    BinaryUnarchiver::BinaryUnarchiver(const char* data, size_t size, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _data(data),
+        _size(size)
+    {
+        ReadHeader();
+    }
+
+    bool BinaryUnarchiver::IsBinaryArchive(const char* data, size_t size)
+    {
+        return size >= binaryArchiveHeaderSize && std::memcmp(data, binaryArchiveMagic, sizeof(binaryArchiveMagic)) == 0;
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_VALUE(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryUnarchiver::UnarchiveValue(const char* name, std::string& value)
+    {
+        MatchRecordHeader(BinaryArchiveTag::string, name);
+        value = ReadString();
+    }
+
+    bool BinaryUnarchiver::UnarchiveNull(const char* name)
+    {
+        if (PeekTag() != BinaryArchiveTag::null || !HasNextPropertyName(name))
+        {
+            return false;
+        }
+        MatchRecordHeader(BinaryArchiveTag::null, name);
+        return true;
+    }
+
+    bool BinaryUnarchiver::HasNextPropertyName(const std::string& name)
+    {
+        if (_position == _size || PeekTag() == BinaryArchiveTag::end)
+        {
+            return false;
+        }
+
+        // read the name, then rewind to the start of the record
+        auto recordPosition = _position;
+        ReadRaw<BinaryArchiveTag>();
+        auto nextPropertyName = ReadString();
+        _position = recordPosition;
+        return nextPropertyName == name;
+    }
+
+    // IArchivable
+    ArchivedObjectInfo BinaryUnarchiver::BeginUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchRecordHeader(BinaryArchiveTag::object, name);
+        auto encodedTypeName = ReadString();
+        if (encodedTypeName == "")
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting a non empty object type name");
+        }
+        auto version = ReadRaw<int32_t>();
+        return { encodedTypeName, version };
+    }
+
+    void BinaryUnarchiver::UnarchiveObject(const char* name, IArchivable& value)
+    {
+        // objects archived as primitives can also be read through a std::unique_ptr, which skips UnarchiveObjectAsPrimitive
+        if (value.ArchiveAsPrimitive() && PeekTag() == BinaryArchiveTag::primitiveObject)
+        {
+            MatchRecordHeader(BinaryArchiveTag::primitiveObject, name);
+        }
+        Unarchiver::UnarchiveObject(name, value);
+    }
+
+    void BinaryUnarchiver::UnarchiveObjectAsPrimitive(const char* name, IArchivable& value)
+    {
+        UnarchiveObject(name, value);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        if (ReadRaw<BinaryArchiveTag>() != BinaryArchiveTag::end)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting the end of an object");
+        }
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_ARRAY(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryUnarchiver::ReadArray(const char* name, std::vector<bool>& array)
+    {
+        MatchRecordHeader(BinaryArchiveTag::array, name);
+        auto elementTag = ReadRaw<BinaryArchiveTag>();
+        auto size = ReadArraySize(elementTag);
+
+        array.reserve(size);
+        for (size_t index = 0; index < size; ++index)
+        {
+            array.push_back(ReadNumber<bool>(elementTag));
+        }
+    }
+
+    void BinaryUnarchiver::UnarchiveArray(const char* name, std::vector<std::string>& array)
+    {
+        MatchRecordHeader(BinaryArchiveTag::stringArray, name);
+        auto size = ReadRaw<uint64_t>();
+
+        // each string is at least its length
+        if (size > (_size - _position) / sizeof(uint64_t))
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ended unexpectedly");
+        }
+        array.reserve(static_cast<size_t>(size));
+        for (size_t index = 0; index < size; ++index)
+        {
+            array.push_back(ReadString());
+        }
+    }
+
+    void BinaryUnarchiver::BeginUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchRecordHeader(BinaryArchiveTag::objectArray, name);
+    }
+
+    bool BinaryUnarchiver::BeginUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+        return PeekTag() != BinaryArchiveTag::end;
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        if (ReadRaw<BinaryArchiveTag>() != BinaryArchiveTag::end)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting the end of an array");
+        }
+    }
+
+    void BinaryUnarchiver::ReadHeader()
+    {
+        if (!IsBinaryArchive(_data, _size))
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting the binary archive header");
+        }
+        ReadBytes(sizeof(binaryArchiveMagic));
+
+        if (ReadRaw<uint32_t>() != binaryArchiveFormatVersion)
+        {
+            throw InputException(InputExceptionErrors::versionMismatch, "Binary archive has an unsupported format version");
+        }
+
+        if (ReadRaw<uint32_t>() != binaryArchiveByteOrderMark)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive was written on a machine with a different byte order");
+        }
+    }
+
+    BinaryArchiveTag BinaryUnarchiver::PeekTag() const
+    {
+        if (_position >= _size)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ended unexpectedly");
+        }
+        return static_cast<BinaryArchiveTag>(_data[_position]);
+    }
+
+    void BinaryUnarchiver::MatchRecordHeader(BinaryArchiveTag tag, const char* name)
+    {
+        auto foundTag = ReadRaw<BinaryArchiveTag>();
+        if (foundTag != tag)
+        {
+            throw InputException(InputExceptionErrors::typeMismatch, std::string{ "Failed to match field " } + name + ", found a record of the wrong type");
+        }
+
+        // unnamed reads accept any name, like the text unarchivers
+        auto foundName = ReadString();
+        bool hasName = name != std::string("");
+        if (hasName && foundName != name)
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match field " } + name + ", instead found field '" + foundName + "'");
+        }
+    }
+
+    std::string BinaryUnarchiver::ReadString()
+    {
+        auto size = static_cast<size_t>(ReadRaw<uint64_t>());
+        auto contents = ReadBytes(size);
+        return std::string(contents, size);
+    }
+
+    size_t BinaryUnarchiver::ReadArraySize(BinaryArchiveTag elementTag)
+    {
+        // The size comes from the archive, so check that the elements fit in what's left of it before anything is
+        // allocated or read. Dividing the bytes left, rather than multiplying the size, can't overflow.
+        auto size = ReadRaw<uint64_t>();
+        SkipPadding(BinaryArchiver::arrayAlignment);
+        if (size > (_size - _position) / GetNumberSize(elementTag))
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ended unexpectedly");
+        }
+        return static_cast<size_t>(size);
+    }
+
+    void BinaryUnarchiver::SkipPadding(size_t alignment)
+    {
+        ReadBytes(GetPaddingSize(_position, alignment));
+    }
+
+    const char* BinaryUnarchiver::ReadBytes(size_t size)
+    {
+        if (size > _size - _position)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ended unexpectedly");
+        }
+        auto result = _data + _position;
+        _position += size;
+        return result;
+    }
+} // namespace utilities
+} // namespace ell
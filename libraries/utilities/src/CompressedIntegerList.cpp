@@ -9,6 +9,7 @@
 #include "CompressedIntegerList.h"
 #include "Exception.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <limits>
@@ -58,6 +59,7 @@ namespace utilities
 
     CompressedIntegerList::CompressedIntegerList() :
         _last(std::numeric_limits<size_t>::max()),
+        _max(0),
         _size(0)
     {
     }
@@ -79,7 +81,7 @@ namespace utilities
             throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Can't get max of empty list");
         }
 
-        return _last;
+        return _max;
     }
 
     /// adds an integer at the end of the list
@@ -103,6 +105,7 @@ namespace utilities
         // compute the delta
         delta = value - _last;
         _last = value;
+        _max = std::max(_max, value);
 
         // figure out how many bits we need to represent this value
         int log2bytes = 0;
@@ -135,10 +138,17 @@ namespace utilities
         ++_size;
     }
 
+    void CompressedIntegerList::BeginSegment()
+    {
+        // the first value of a segment is encoded as a delta from zero, like the first value of the list
+        _last = std::numeric_limits<size_t>::max();
+    }
+
     void CompressedIntegerList::Reset()
     {
         _data.resize(0);
         _last = std::numeric_limits<size_t>::max();
+        _max = 0;
         _size = 0;
     }
 } // namespace utilities
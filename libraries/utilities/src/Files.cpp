@@ -11,6 +11,8 @@
 #include "StringUtil.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <ios>
 #include <memory>
@@ -18,6 +20,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #else
+#include <process.h>
+
 #include <filesystem>
 namespace fs = std::filesystem;
 #endif // WIN32
@@ -142,6 +146,69 @@ namespace utilities
 #endif
     }
 
+    uint64_t GetFileSize(const std::string& filepath)
+    {
+#ifdef WIN32
+        std::error_code ec;
+        auto size = fs::file_size(fs::u8path(filepath), ec);
+        if (ec)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+        return static_cast<uint64_t>(size);
+#else
+        struct stat buf;
+        if (stat(filepath.c_str(), &buf) == -1)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+        return static_cast<uint64_t>(buf.st_size);
+#endif
+    }
+
+    int64_t GetFileModificationTime(const std::string& filepath)
+    {
+#ifdef WIN32
+        std::error_code ec;
+        auto time = fs::last_write_time(fs::u8path(filepath), ec);
+        if (ec)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the modification time of file " + filepath);
+        }
+        return static_cast<int64_t>(time.time_since_epoch().count());
+#else
+        struct stat buf;
+        if (stat(filepath.c_str(), &buf) == -1)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the modification time of file " + filepath);
+        }
+        return static_cast<int64_t>(buf.st_mtime);
+#endif
+    }
+
+    std::string GetTemporaryFilePath(const std::string& filepath)
+    {
+        static std::atomic<int> numTemporaryFiles(0);
+#ifdef WIN32
+        auto processId = _getpid();
+#else
+        auto processId = getpid();
+#endif
+        return filepath + "." + std::to_string(processId) + "." + std::to_string(numTemporaryFiles++) + ".tmp";
+    }
+
+    bool ReplaceFile(const std::string& sourcePath, const std::string& destinationPath)
+    {
+#ifdef WIN32
+        // Unlike std::rename, this replaces an existing destination on Windows too
+        std::error_code ec;
+        fs::rename(fs::u8path(sourcePath), fs::u8path(destinationPath), ec);
+        return !ec;
+#else
+        return std::rename(sourcePath.c_str(), destinationPath.c_str()) == 0;
+#endif
+    }
+
     bool DirectoryExists(const std::string& path)
     {
 #ifdef WIN32
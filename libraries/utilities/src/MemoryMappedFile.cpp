@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <filesystem>
+namespace fs = std::filesystem;
+#endif // WIN32
+
+namespace ell
+{
+namespace utilities
+{
+#ifndef WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        auto fileDescriptor = open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to open " + filepath);
+        }
+
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) != 0)
+        {
+            close(fileDescriptor);
+            throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to read the size of " + filepath);
+        }
+
+        _size = static_cast<size_t>(fileStatus.st_size);
+        if (_size > 0)
+        {
+            auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fileDescriptor);
+                throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to map " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the file is closed
+        close(fileDescriptor);
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
+    }
+#else
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        auto path = fs::u8path(filepath);
+        auto fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to open " + filepath);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            CloseHandle(fileHandle);
+            throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to read the size of " + filepath);
+        }
+
+        _size = static_cast<size_t>(fileSize.QuadPart);
+        if (_size > 0)
+        {
+            _mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            auto data = _mappingHandle != nullptr ? MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (data == nullptr)
+            {
+                if (_mappingHandle != nullptr)
+                {
+                    CloseHandle(_mappingHandle);
+                }
+                CloseHandle(fileHandle);
+                throw SystemException(SystemExceptionErrors::fileNotFound, "Unable to map " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the file is closed
+        CloseHandle(fileHandle);
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+            CloseHandle(_mappingHandle);
+        }
+    }
+#endif // WIN32
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) :
+        _data(other._data),
+        _size(other._size)
+#ifdef WIN32
+        ,
+        _mappingHandle(other._mappingHandle)
+#endif
+    {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+} // namespace utilities
+} // namespace ell
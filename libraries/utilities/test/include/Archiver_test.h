@@ -18,4 +18,9 @@ void TestJsonUnarchiver();
 
 void TestXmlArchiver();
 void TestXmlUnarchiver();
+
+void TestBinaryArchiver();
+void TestBinaryUnarchiver();
+void TestBinaryUnarchiverFromMappedFile();
+void TestBinaryUnarchiverRejectsBadArraySize();
 } // namespace ell
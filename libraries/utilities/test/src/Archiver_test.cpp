@@ -9,13 +9,17 @@
 #include "Archiver_test.h"
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MemoryMappedFile.h>
 #include <utilities/include/UniqueId.h>
 #include <utilities/include/XmlArchiver.h>
 
 #include <testing/include/testing.h>
 
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -264,6 +268,27 @@ void TestUnarchiver()
         testing::ProcessTest(name + "Deserialize vector<int> check", val[0] == 1 && val[1] == 2 && val[2] == 3);
     }
 
+    {
+        std::stringstream strstream;
+        std::vector<int8_t> arr{ -128, -1, 0, 10, 127 };
+        std::vector<uint8_t> unsignedArr{ 0, 10, 255 };
+        {
+            ArchiverType archiver(strstream);
+            archiver.Archive("arr", arr);
+            archiver.Archive("unsignedArr", unsignedArr);
+            archiver.Archive("x", int8_t{ -7 });
+        }
+
+        UnarchiverType unarchiver(strstream, context);
+        std::vector<int8_t> val;
+        std::vector<uint8_t> unsignedVal;
+        int8_t x = 0;
+        unarchiver.Unarchive("arr", val);
+        unarchiver.Unarchive("unsignedArr", unsignedVal);
+        unarchiver.Unarchive("x", x);
+        testing::ProcessTest(name + "Deserialize vector<int8_t> check", val == arr && unsignedVal == unsignedArr && x == -7);
+    }
+
     {
         std::stringstream strstream;
         {
@@ -370,4 +395,113 @@ void TestXmlUnarchiver()
 {
     TestUnarchiver<utilities::XmlArchiver, utilities::XmlUnarchiver>();
 }
+
+void TestBinaryArchiver()
+{
+    TestArchiver<utilities::BinaryArchiver>();
+}
+
+void TestBinaryUnarchiver()
+{
+    TestUnarchiver<utilities::BinaryArchiver, utilities::BinaryUnarchiver>();
+}
+
+void TestBinaryUnarchiverFromMappedFile()
+{
+    const std::string filename = "TestBinaryUnarchiverFromMappedFile.ellb";
+    std::vector<float> floatVector(1000);
+    for (size_t index = 0; index < floatVector.size(); ++index)
+    {
+        floatVector[index] = 0.5f * index;
+    }
+    std::vector<bool> boolVector{ true, false, true };
+    std::vector<std::string> stringVector{ "a", "", "abc" };
+    TestStruct testStruct{ 1, 2.2f, 3.3 };
+
+    {
+        auto stream = utilities::OpenBinaryOfstream(filename);
+        utilities::BinaryArchiver archiver(stream);
+        archiver["str"] << std::string{ "unaligned prefix" };
+        archiver["floats"] << floatVector;
+        archiver["bools"] << boolVector;
+        archiver["strings"] << stringVector;
+        archiver["s"] << testStruct;
+        archiver["count"] << size_t{ 12 };
+    }
+
+    utilities::SerializationContext context;
+    utilities::MemoryMappedFile file(filename);
+    testing::ProcessTest("MemoryMappedFile: binary archive header", utilities::BinaryUnarchiver::IsBinaryArchive(file.GetData(), file.Size()));
+
+    utilities::BinaryUnarchiver unarchiver(file.GetData(), file.Size(), context);
+    std::string str;
+    std::vector<float> newFloatVector;
+    std::vector<bool> newBoolVector;
+    std::vector<std::string> newStringVector;
+    TestStruct newTestStruct;
+    int count = 0;
+    unarchiver["str"] >> str;
+    unarchiver["floats"] >> newFloatVector;
+    unarchiver["bools"] >> newBoolVector;
+    unarchiver["strings"] >> newStringVector;
+    unarchiver["s"] >> newTestStruct;
+    unarchiver["count"] >> count; // written as size_t, read as int
+
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: string", str == "unaligned prefix");
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: float array", newFloatVector == floatVector);
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: bool array", newBoolVector == boolVector);
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: string array", newStringVector == stringVector);
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: IArchivable", newTestStruct.a == 1 && newTestStruct.b == 2.2f && newTestStruct.c == 3.3);
+    testing::ProcessTest("BinaryUnarchiver from MemoryMappedFile: converted integer", count == 12);
+
+    // the raw float contents must start at a 64-byte aligned offset in the file
+    const char* floatBytes = nullptr;
+    for (size_t offset = 0; offset + sizeof(float) * floatVector.size() <= file.Size(); ++offset)
+    {
+        if (std::memcmp(file.GetData() + offset, floatVector.data(), sizeof(float) * floatVector.size()) == 0)
+        {
+            floatBytes = file.GetData() + offset;
+            break;
+        }
+    }
+    testing::ProcessTest("BinaryArchiver array alignment", floatBytes != nullptr && (floatBytes - file.GetData()) % utilities::BinaryArchiver::arrayAlignment == 0);
+}
+
+void TestBinaryUnarchiverRejectsBadArraySize()
+{
+    std::stringstream stream;
+    {
+        utilities::BinaryArchiver archiver(stream);
+        archiver["floats"] << std::vector<float>{ 1, 2, 3, 4 };
+    }
+    auto archive = stream.str();
+
+    // The element count follows the archive header, the record's tag and name, and the element tag
+    const size_t sizeOffset = 12 + 1 + sizeof(uint64_t) + std::string("floats").size() + 1;
+    auto readWithSize = [&archive, sizeOffset](uint64_t size, auto& array) {
+        auto corrupted = archive;
+        std::memcpy(&corrupted[sizeOffset], &size, sizeof(size));
+        utilities::SerializationContext context;
+        utilities::BinaryUnarchiver unarchiver(corrupted.data(), corrupted.size(), context);
+        try
+        {
+            unarchiver["floats"] >> array;
+        }
+        catch (const utilities::DataFormatException&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    // One more element than the archive holds, a count whose size in bytes overflows, and the same counts read with
+    // conversion, which would otherwise reserve the memory before reading
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    bool ok = readWithSize(5, floats);
+    ok &= readWithSize(uint64_t{ 1 } << 62, floats);
+    ok &= readWithSize(5, doubles);
+    ok &= readWithSize(uint64_t{ 1 } << 62, doubles);
+    testing::ProcessTest("BinaryUnarchiver rejects array sizes larger than the archive", ok);
+}
 } // namespace ell
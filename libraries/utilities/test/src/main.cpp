@@ -84,6 +84,11 @@ int main(int argc, char* argv[])
         TestXmlArchiver();
         TestXmlUnarchiver();
 
+        TestBinaryArchiver();
+        TestBinaryUnarchiver();
+        TestBinaryUnarchiverFromMappedFile();
+        TestBinaryUnarchiverRejectsBadArraySize();
+
         // ObjectArchive tests
         TestGetTypeDescription();
         TestGetObjectArchive();
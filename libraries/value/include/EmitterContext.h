@@ -180,7 +180,18 @@ namespace value
         /// <summary> Creates a for loop over the memory pointed to with the given layout </summary>
         /// <param name="layout"> The layout used to describe the iteration characteristics. Only active elements are iterated over. </param>
         /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
-        void For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn);
+        /// <param name="unrollFactor"> The number of iterations of the innermost loop to emit per loop trip. Contexts that
+        /// emit code generate a loop per dimension of the layout and call `fn` once per loop body, so loop-carried state
+        /// must live in memory allocated before the loop. </param>
+        void For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int unrollFactor = 1);
+
+        /// <summary> Creates a for loop whose iterations may run concurrently </summary>
+        /// <param name="count"> The number of iterations </param>
+        /// <param name="numTasks"> The number of tasks to split the iterations among, or 0 to let the context decide </param>
+        /// <param name="capturedValues"> The values used by the loop body </param>
+        /// <param name="fn"> The function to be called for each iteration, with the iteration index and the captured values.
+        /// Contexts may emit it into a separate function, so it must only use the values it's passed, besides constants. </param>
+        void ParallelFor(int count, int numTasks, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn);
 
         /// <summary> Moves the data from one location to another </summary>
         /// <param name="source"> The source of the memory to be moved </param>
@@ -244,7 +255,9 @@ namespace value
 
         virtual Value StoreConstantDataImpl(ConstantData data) = 0;
 
-        virtual void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn) = 0;
+        virtual void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int unrollFactor) = 0;
+
+        virtual void ParallelForImpl(int count, int numTasks, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn) = 0;
 
         virtual void MoveDataImpl(Value& source, Value& destination) = 0;
 
@@ -53,7 +53,9 @@ namespace value
 
         Value StoreConstantDataImpl(ConstantData data) override;
 
-        void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn) override;
+        void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int unrollFactor) override;
+
+        void ParallelForImpl(int count, int numTasks, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn) override;
 
         void MoveDataImpl(Value& source, Value& destination) override;
 
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LoopNest.h (value)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Scalar.h"
+#include "Value.h"
+
+#include <functional>
+#include <vector>
+
+namespace ell
+{
+namespace value
+{
+    /// <summary> Refers to one of the loops of a LoopNest </summary>
+    struct LoopIndex
+    {
+        int id;
+    };
+
+    /// <summary>
+    /// A nest of loops over a rectangular iteration space, along with a schedule that describes how the loops get emitted.
+    /// The kernel is called once for every point of the iteration space. The schedule can split loops, reorder them, unroll,
+    /// vectorize or parallelize them, and copy the part of an input used inside a loop into a local buffer. Scheduling changes
+    /// the order in which the points are visited, so the kernel may only carry state between points by accumulating into
+    /// memory.
+    /// </summary>
+    /// <example>
+    /// <code>
+    /// LoopNest nest({ M, N, K });
+    /// nest.Using({ A.GetValue(), B.GetValue(), C.GetValue() });
+    /// auto k = nest.GetDimensionLoop(2);
+    /// auto kInner = nest.Split(k, 64);
+    /// nest.Cache(1, { 2, 1 }, k);
+    /// nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+    ///     Matrix A = values[0], B = values[1], C = values[2];
+    ///     C(indices[0], indices[1]) += A(indices[0], indices[2]) * B(indices[2], indices[1]);
+    /// });
+    /// </code>
+    /// </example>
+    class LoopNest
+    {
+    public:
+        /// <summary> The function called for every point of the iteration space </summary>
+        /// <param name="values"> The values passed to `Using`. Cached values are replaced by views of their local buffer,
+        /// which are indexed with the same coordinates as the original value </param>
+        /// <param name="indices"> The coordinates of the point, one per dimension of the iteration space </param>
+        using KernelFunction = std::function<void(std::vector<Value> values, std::vector<Scalar> indices)>;
+
+        /// <summary> Constructor </summary>
+        /// <param name="sizes"> The number of points along each dimension of the iteration space. Each dimension starts
+        /// out with one loop, and the loops are nested in the order of the dimensions </param>
+        LoopNest(std::vector<int> sizes);
+
+        /// <summary> Sets the values the kernel uses </summary>
+        /// <param name="values"> The values, which are passed to the kernel in the same order </param>
+        /// <returns> A reference to this instance </returns>
+        /// <remarks> Parallelized loops may be emitted into a separate function, so the kernel must only use values it's
+        /// passed, besides constants </remarks>
+        LoopNest& Using(std::vector<Value> values);
+
+        /// <summary> Gets the loop a dimension of the iteration space starts out with </summary>
+        /// <param name="dimension"> The dimension </param>
+        /// <returns> The loop over the dimension </returns>
+        LoopIndex GetDimensionLoop(int dimension) const;
+
+        /// <summary> Splits a loop into an outer loop over blocks of iterations and an inner loop within a block </summary>
+        /// <param name="loop"> The loop to split, which becomes the outer loop </param>
+        /// <param name="size"> The number of iterations of the inner loop. If it doesn't divide the number of iterations of
+        /// the loop, the last block is shorter: the kernel isn't called for points past the end of the loop's own range,
+        /// which for a loop split off from another is one block of that loop </param>
+        /// <returns> The inner loop, which is nested immediately inside the outer loop </returns>
+        LoopIndex Split(LoopIndex loop, int size);
+
+        /// <summary> Sets the order in which the loops are nested </summary>
+        /// <param name="order"> All of the loops, from the outermost to the innermost </param>
+        /// <returns> A reference to this instance </returns>
+        LoopNest& Reorder(std::vector<LoopIndex> order);
+
+        /// <summary> Unrolls a loop completely </summary>
+        /// <param name="loop"> The loop to unroll </param>
+        /// <returns> A reference to this instance </returns>
+        LoopNest& Unroll(LoopIndex loop);
+
+        /// <summary> Unrolls a loop by a given factor </summary>
+        /// <param name="loop"> The loop to unroll </param>
+        /// <param name="factor"> The number of iterations emitted per trip through the loop </param>
+        /// <returns> A reference to this instance </returns>
+        LoopNest& Unroll(LoopIndex loop, int factor);
+
+        /// <summary> Vectorizes a loop, which must be the innermost loop. The loop is emitted as straight-line code, so the
+        /// iterations for consecutive points are combined into vector instructions by the backend's vectorizer </summary>
+        /// <param name="loop"> The loop to vectorize </param>
+        /// <returns> A reference to this instance </returns>
+        LoopNest& Vectorize(LoopIndex loop);
+
+        /// <summary> Runs the iterations of a loop concurrently. At most one loop can be parallelized </summary>
+        /// <param name="loop"> The loop to parallelize </param>
+        /// <param name="numTasks"> The number of tasks to split the iterations among, or 0 to let the context decide </param>
+        /// <returns> A reference to this instance </returns>
+        LoopNest& Parallelize(LoopIndex loop, int numTasks = 0);
+
+        /// <summary> Copies the block of a value used by the loops inside a loop into a local buffer, at the start of every
+        /// iteration of the loop. The kernel then reads the buffer instead of the value </summary>
+        /// <param name="valueIndex"> The index of the value in the list passed to `Using` </param>
+        /// <param name="dimensions"> For each logical dimension of the value, the dimension of the iteration space that
+        /// indexes it </param>
+        /// <param name="loop"> The loop whose iterations copy the block </param>
+        /// <returns> A reference to this instance </returns>
+        /// <remarks> The kernel must only read the cached value </remarks>
+        LoopNest& Cache(int valueIndex, std::vector<int> dimensions, LoopIndex loop);
+
+        /// <summary> Emits the loops and calls the kernel for every point of the iteration space </summary>
+        /// <param name="kernel"> The kernel </param>
+        void Run(KernelFunction kernel) const;
+
+    private:
+        struct Loop
+        {
+            int dimension;
+            int size;
+            int stride;
+            int extent; // the number of points of the dimension in the block the loop was created to cover
+            int parent; // the loop this one was split from, or -1 for the loop a dimension starts out with
+            int unrollFactor;
+            bool isVectorized;
+            bool isParallel;
+            int numTasks;
+        };
+
+        struct CachedValue
+        {
+            int valueIndex;
+            std::vector<int> dimensions;
+            int loop;
+        };
+
+        void EmitLoop(int position, std::vector<Value> values, std::vector<Scalar> loopIndices, const KernelFunction& kernel) const;
+        std::vector<Value> CacheValues(int position, std::vector<Value> values, const std::vector<Scalar>& loopIndices) const;
+        std::vector<Scalar> GetDimensionIndices(const std::vector<Scalar>& loopIndices) const;
+        std::vector<int> GetBlockLoops(int id) const;
+        int GetCoveredSize(int dimension) const;
+        const Loop& GetLoop(LoopIndex loop) const;
+        Loop& GetLoop(LoopIndex loop);
+
+        std::vector<int> _sizes;
+        std::vector<Value> _values;
+        std::vector<Loop> _loops;
+        std::vector<int> _order;
+        std::vector<CachedValue> _cachedValues;
+    };
+
+} // namespace value
+} // namespace ell
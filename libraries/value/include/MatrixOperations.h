@@ -29,10 +29,30 @@ namespace value
     /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
     void For(Matrix matrix, std::function<void(Scalar, Scalar)> fn);
 
+    /// <summary> Computes the product of two matrices </summary>
+    /// <param name="m1"> The left-hand matrix, with dimensions M x K </param>
+    /// <param name="m2"> The right-hand matrix, with dimensions K x N </param>
+    /// <returns> A newly allocated matrix, with dimensions M x N </returns>
     Matrix GEMM(Matrix m1, Matrix m2);
 
+    /// <summary> Computes the product of two matrices into an existing matrix </summary>
+    /// <param name="m1"> The left-hand matrix, with dimensions M x K </param>
+    /// <param name="m2"> The right-hand matrix, with dimensions K x N </param>
+    /// <param name="result"> The matrix that receives the product, with dimensions M x N </param>
+    void GEMM(Matrix m1, Matrix m2, Matrix result);
+
+    /// <summary> Computes the product of a matrix and a vector </summary>
+    /// <param name="m"> The matrix, with dimensions M x N </param>
+    /// <param name="v"> The vector, with size N </param>
+    /// <returns> A newly allocated vector, with size M </returns>
     Vector GEMV(Matrix m, Vector v);
 
+    /// <summary> Computes the product of a matrix and a vector into an existing vector </summary>
+    /// <param name="m"> The matrix, with dimensions M x N </param>
+    /// <param name="v"> The vector, with size N </param>
+    /// <param name="result"> The vector that receives the product, with size M </param>
+    void GEMV(Matrix m, Vector v, Vector result);
+
     Matrix operator+(Matrix, Matrix);
     Matrix operator+(Matrix, Scalar);
 
@@ -647,7 +647,7 @@ namespace value
         source.Reset();
     }
 
-    void ComputeContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn)
+    void ComputeContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int /*unrollFactor*/)
     {
         auto maxCoordinate = layout.GetActiveSize().ToVector();
         decltype(maxCoordinate) coordinate(maxCoordinate.size());
@@ -659,6 +659,14 @@ namespace value
         } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
     }
 
+    void ComputeContext::ParallelForImpl(int count, int /*numTasks*/, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        for (int index = 0; index < count; ++index)
+        {
+            fn(index, capturedValues);
+        }
+    }
+
     Value ComputeContext::UnaryOperationImpl(ValueUnaryOperation op, Value destination)
     {
         throw LogicException(LogicExceptionErrors::notImplemented);
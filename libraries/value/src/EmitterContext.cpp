@@ -32,7 +32,7 @@ namespace value
             const auto& order = layout.GetLogicalDimensionOrder();
             const auto numDimensions = layout.NumDimensions();
 
-            Scalar result;
+            Scalar result = 0;
             for (int index = 0; index < numDimensions; ++index)
             {
                 result += increment[index] * (coordinates[order[index]] + offset[index]);
@@ -112,14 +112,34 @@ namespace value
 
     Value EmitterContext::StoreConstantData(ConstantData data) { return StoreConstantDataImpl(data); }
 
-    void EmitterContext::For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn)
+    void EmitterContext::For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int unrollFactor)
     {
+        if (unrollFactor < 1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Unroll factor must be positive");
+        }
+
         if (layout.NumElements() == 0)
         {
             return;
         }
 
-        return ForImpl(layout, fn);
+        return ForImpl(layout, fn, unrollFactor);
+    }
+
+    void EmitterContext::ParallelFor(int count, int numTasks, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        if (numTasks < 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Number of tasks must not be negative");
+        }
+
+        if (count <= 0)
+        {
+            return;
+        }
+
+        return ParallelForImpl(count, numTasks, capturedValues, fn);
     }
 
     void EmitterContext::MoveData(Value& source, Value& destination) { return MoveDataImpl(source, destination); }
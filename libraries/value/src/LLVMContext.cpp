@@ -639,16 +639,104 @@ namespace value
 
     Value LLVMContext::StoreConstantDataImpl(ConstantData data) { return _computeContext.StoreConstantData(data); }
 
-    void LLVMContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn)
+    void LLVMContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, int unrollFactor)
     {
-        auto maxCoordinate = layout.GetActiveSize().ToVector();
-        decltype(maxCoordinate) coordinate(maxCoordinate.size());
+        auto& fnEmitter = GetFnEmitter();
+        const auto maxCoordinate = layout.GetActiveSize().ToVector();
+        const auto numDimensions = static_cast<int>(maxCoordinate.size());
 
-        do
+        // The body sees the coordinates as ordinary scalars, each kept in a variable the loops store their index into
+        std::vector<Scalar> logicalCoordinates;
+        std::vector<LLVMValue> coordinateVariables(numDimensions);
+        for (int logicalDimension = 0; logicalDimension < numDimensions; ++logicalDimension)
         {
-            auto logicalCoordinates = layout.GetLogicalCoordinates(coordinate).ToVector();
-            fn(std::vector<Scalar>(logicalCoordinates.begin(), logicalCoordinates.end()));
-        } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
+            Scalar coordinate = value::Allocate(ValueType::Int32, ScalarLayout);
+            coordinateVariables[layout.GetPhysicalDimension(logicalDimension)] = ToLLVMValue(coordinate.GetValue());
+            logicalCoordinates.push_back(coordinate);
+        }
+
+        // Emits the loop over physical dimension `dimension` and, inside it, the loops over the dimensions after it.
+        // Only the innermost loop is unrolled; the iterations left over by the unroll factor are emitted after it.
+        std::function<void(int)> emitLoop = [&](int dimension) {
+            const auto size = maxCoordinate[dimension];
+            const auto isInnermost = dimension == numDimensions - 1;
+            const auto unroll = isInnermost ? std::min(unrollFactor, size) : 1;
+            const auto unrolledSize = size - (size % unroll);
+
+            auto emitBody = [&](LLVMValue index) {
+                fnEmitter.SetValueAt(coordinateVariables[dimension], 0, index);
+                if (isInnermost)
+                {
+                    fn(logicalCoordinates);
+                }
+                else
+                {
+                    emitLoop(dimension + 1);
+                }
+            };
+
+            if (unrolledSize == unroll)
+            {
+                for (int index = 0; index < unroll; ++index)
+                {
+                    emitBody(fnEmitter.Literal(index));
+                }
+            }
+            else
+            {
+                fnEmitter.For(0, unrolledSize, unroll, [&](IRFunctionEmitter&, IRLocalScalar index) {
+                    for (int offset = 0; offset < unroll; ++offset)
+                    {
+                        emitBody(offset == 0 ? index : index + offset);
+                    }
+                });
+            }
+
+            for (int index = unrolledSize; index < size; ++index)
+            {
+                emitBody(fnEmitter.Literal(index));
+            }
+        };
+
+        emitLoop(0);
+    }
+
+    void LLVMContext::ParallelForImpl(int count, int numTasks, std::vector<Value> capturedValues, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        auto& fnEmitter = GetFnEmitter();
+        std::vector<LLVMValue> llvmCapturedValues;
+        for (const auto& value : capturedValues)
+        {
+            llvmCapturedValues.push_back(ToLLVMValue(EnsureEmittable(value)));
+        }
+
+        fnEmitter.ParallelFor(0, count, 1, ParallelLoopOptions{ numTasks }, llvmCapturedValues, [&](IRFunctionEmitter& taskEmitter, IRLocalScalar index, std::vector<LLVMValue> taskCapturedValues) {
+            // If the loop is parallelized, the body is emitted into a task function that gets the captured values as arguments
+            const auto isTask = &taskEmitter != &fnEmitter;
+            if (isTask)
+            {
+                _functionStack.push(taskEmitter);
+                _promotedConstantStack.push({});
+            }
+
+            std::vector<Value> taskValues;
+            for (size_t valueIndex = 0; valueIndex < capturedValues.size(); ++valueIndex)
+            {
+                Value taskValue = capturedValues[valueIndex];
+                taskValue.SetData(Emittable{ taskCapturedValues[valueIndex] });
+                taskValues.push_back(taskValue);
+            }
+
+            Scalar taskIndex = value::Allocate(ValueType::Int32, ScalarLayout);
+            taskEmitter.SetValueAt(ToLLVMValue(taskIndex.GetValue()), 0, index);
+            fn(taskIndex, taskValues);
+
+            if (isTask)
+            {
+                _functionStack.pop();
+                _promotedConstantStack.pop();
+            }
+        });
     }
 
     void LLVMContext::MoveDataImpl(Value& source, Value& destination)
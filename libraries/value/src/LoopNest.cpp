@@ -0,0 +1,459 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LoopNest.cpp (value)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LoopNest.h"
+#include "EmitterContext.h"
+#include "ScalarOperations.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace value
+{
+    using namespace utilities;
+
+    namespace
+    {
+        Scalar Sum(const std::vector<Scalar>& terms)
+        {
+            if (terms.empty())
+            {
+                return 0;
+            }
+            if (terms.size() == 1)
+            {
+                return terms[0];
+            }
+
+            Scalar sum = terms[0] + terms[1];
+            for (size_t index = 2; index < terms.size(); ++index)
+            {
+                sum += terms[index];
+            }
+            return sum;
+        }
+
+        // Calls `fn` if each index with a bounds check is less than its size
+        void IfInBounds(const std::vector<Scalar>& indices, const std::vector<int>& sizes, const std::vector<bool>& checkBounds, int dimension, std::function<void()> fn)
+        {
+            const auto numDimensions = static_cast<int>(indices.size());
+            while (dimension < numDimensions && !checkBounds[dimension])
+            {
+                ++dimension;
+            }
+
+            if (dimension == numDimensions)
+            {
+                fn();
+            }
+            else
+            {
+                If(indices[dimension] < sizes[dimension], [&, dimension] {
+                    IfInBounds(indices, sizes, checkBounds, dimension + 1, fn);
+                });
+            }
+        }
+
+        Scalar GetElement(Value value, std::vector<Scalar> coordinates)
+        {
+            Value element = GetContext().Offset(value, coordinates);
+            element.SetLayout(ScalarLayout);
+            return element;
+        }
+    } // namespace
+
+    LoopNest::LoopNest(std::vector<int> sizes) :
+        _sizes(std::move(sizes))
+    {
+        if (_sizes.empty())
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Loop nest must have at least one dimension");
+        }
+
+        for (int dimension = 0; dimension < static_cast<int>(_sizes.size()); ++dimension)
+        {
+            if (_sizes[dimension] <= 0)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Loop nest dimensions must not be empty");
+            }
+
+            _loops.push_back({ dimension, _sizes[dimension], 1, _sizes[dimension], -1, 1, false, false, 0 });
+            _order.push_back(dimension);
+        }
+    }
+
+    LoopNest& LoopNest::Using(std::vector<Value> values)
+    {
+        _values = std::move(values);
+        return *this;
+    }
+
+    LoopIndex LoopNest::GetDimensionLoop(int dimension) const
+    {
+        if (dimension < 0 || dimension >= static_cast<int>(_sizes.size()))
+        {
+            throw InputException(InputExceptionErrors::indexOutOfRange);
+        }
+
+        return { dimension };
+    }
+
+    LoopIndex LoopNest::Split(LoopIndex loop, int size)
+    {
+        auto& outerLoop = GetLoop(loop);
+        if (size < 1 || size > outerLoop.size)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Split size must be between 1 and the number of iterations of the loop");
+        }
+
+        // The inner loop covers one block of the outer loop, which may be cut short by the end of the outer loop's own block
+        LoopIndex inner{ static_cast<int>(_loops.size()) };
+        Loop innerLoop{ outerLoop.dimension, size, outerLoop.stride, size * outerLoop.stride, loop.id, 1, false, false, 0 };
+        outerLoop.size = (outerLoop.size + size - 1) / size;
+        outerLoop.stride *= size;
+
+        _loops.push_back(innerLoop);
+        _order.insert(std::find(_order.begin(), _order.end(), loop.id) + 1, inner.id);
+        return inner;
+    }
+
+    LoopNest& LoopNest::Reorder(std::vector<LoopIndex> order)
+    {
+        std::vector<int> newOrder;
+        for (auto loop : order)
+        {
+            GetLoop(loop);
+            newOrder.push_back(loop.id);
+        }
+
+        auto sortedOrder = newOrder;
+        std::sort(sortedOrder.begin(), sortedOrder.end());
+        auto currentOrder = _order;
+        std::sort(currentOrder.begin(), currentOrder.end());
+        if (sortedOrder != currentOrder)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "The new order must contain each loop exactly once");
+        }
+
+        _order = newOrder;
+        return *this;
+    }
+
+    LoopNest& LoopNest::Unroll(LoopIndex loop)
+    {
+        auto& unrolledLoop = GetLoop(loop);
+        unrolledLoop.unrollFactor = unrolledLoop.size;
+        return *this;
+    }
+
+    LoopNest& LoopNest::Unroll(LoopIndex loop, int factor)
+    {
+        if (factor < 1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Unroll factor must be positive");
+        }
+
+        GetLoop(loop).unrollFactor = factor;
+        return *this;
+    }
+
+    LoopNest& LoopNest::Vectorize(LoopIndex loop)
+    {
+        GetLoop(loop).isVectorized = true;
+        return *this;
+    }
+
+    LoopNest& LoopNest::Parallelize(LoopIndex loop, int numTasks)
+    {
+        if (numTasks < 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Number of tasks must not be negative");
+        }
+
+        auto& parallelLoop = GetLoop(loop);
+        if (std::any_of(_loops.begin(), _loops.end(), [&parallelLoop](const Loop& other) { return other.isParallel && &other != &parallelLoop; }))
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Only one loop can be parallelized");
+        }
+
+        parallelLoop.isParallel = true;
+        parallelLoop.numTasks = numTasks;
+        return *this;
+    }
+
+    LoopNest& LoopNest::Cache(int valueIndex, std::vector<int> dimensions, LoopIndex loop)
+    {
+        GetLoop(loop);
+        if (valueIndex < 0 || valueIndex >= static_cast<int>(_values.size()))
+        {
+            throw InputException(InputExceptionErrors::indexOutOfRange, "Cached value must be one of the values passed to Using");
+        }
+
+        const auto& value = _values[valueIndex];
+        if (!value.IsConstrained() || static_cast<int>(dimensions.size()) != value.GetLayout().NumDimensions())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "Cached value must have one iteration dimension per logical dimension");
+        }
+
+        for (auto dimension : dimensions)
+        {
+            if (dimension < 0 || dimension >= static_cast<int>(_sizes.size()))
+            {
+                throw InputException(InputExceptionErrors::indexOutOfRange);
+            }
+        }
+
+        _cachedValues.push_back({ valueIndex, std::move(dimensions), loop.id });
+        return *this;
+    }
+
+    void LoopNest::Run(KernelFunction kernel) const
+    {
+        for (int position = 0; position < static_cast<int>(_order.size()) - 1; ++position)
+        {
+            if (_loops[_order[position]].isVectorized)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Only the innermost loop can be vectorized");
+            }
+        }
+
+        EmitLoop(0, _values, std::vector<Scalar>(_loops.size()), kernel);
+    }
+
+    void LoopNest::EmitLoop(int position, std::vector<Value> values, std::vector<Scalar> loopIndices, const KernelFunction& kernel) const
+    {
+        if (position == static_cast<int>(_order.size()))
+        {
+            // A split that doesn't divide its loop evenly makes the loop run past the end of its block (the whole dimension,
+            // or one block of the loop it was split from), so the point's offset within each such block is checked
+            std::vector<Scalar> offsets;
+            std::vector<int> extents;
+            for (int id = 0; id < static_cast<int>(_loops.size()); ++id)
+            {
+                auto blockLoops = GetBlockLoops(id);
+                int coveredSize = 1;
+                for (auto blockLoop : blockLoops)
+                {
+                    coveredSize += (_loops[blockLoop].size - 1) * _loops[blockLoop].stride;
+                }
+
+                if (coveredSize > _loops[id].extent)
+                {
+                    std::vector<Scalar> offsetTerms;
+                    for (auto blockLoop : blockLoops)
+                    {
+                        const auto& loop = _loops[blockLoop];
+                        offsetTerms.push_back(loop.stride == 1 ? loopIndices[blockLoop] : loopIndices[blockLoop] * loop.stride);
+                    }
+                    offsets.push_back(Sum(offsetTerms));
+                    extents.push_back(_loops[id].extent);
+                }
+            }
+
+            auto indices = GetDimensionIndices(loopIndices);
+            IfInBounds(offsets, extents, std::vector<bool>(offsets.size(), true), 0, [&] { kernel(values, indices); });
+            return;
+        }
+
+        const auto id = _order[position];
+        const auto& loop = _loops[id];
+        auto emitBody = [&](Scalar index, std::vector<Value> bodyValues, std::vector<Scalar> bodyLoopIndices) {
+            bodyLoopIndices[id] = index;
+            EmitLoop(position + 1, CacheValues(position, bodyValues, bodyLoopIndices), bodyLoopIndices, kernel);
+        };
+
+        if (loop.isParallel)
+        {
+            // The body may be emitted into a separate function, so the indices of the enclosing loops are passed to it
+            // along with the values
+            auto capturedValues = values;
+            for (int outerPosition = 0; outerPosition < position; ++outerPosition)
+            {
+                capturedValues.push_back(loopIndices[_order[outerPosition]].GetValue());
+            }
+
+            GetContext().ParallelFor(loop.size, loop.numTasks, capturedValues, [&](Scalar index, std::vector<Value> taskValues) {
+                std::vector<Value> bodyValues(taskValues.begin(), taskValues.begin() + values.size());
+                std::vector<Scalar> bodyLoopIndices(_loops.size());
+                for (int outerPosition = 0; outerPosition < position; ++outerPosition)
+                {
+                    bodyLoopIndices[_order[outerPosition]] = taskValues[values.size() + outerPosition];
+                }
+                emitBody(index, bodyValues, bodyLoopIndices);
+            });
+        }
+        else
+        {
+            GetContext().For(
+                MemoryLayout{ { loop.size } },
+                [&](std::vector<Scalar> coordinates) { emitBody(coordinates[0], values, loopIndices); },
+                loop.isVectorized ? loop.size : std::min(loop.unrollFactor, loop.size));
+        }
+    }
+
+    std::vector<Value> LoopNest::CacheValues(int position, std::vector<Value> values, const std::vector<Scalar>& loopIndices) const
+    {
+        const auto id = _order[position];
+        for (const auto& cachedValue : _cachedValues)
+        {
+            if (cachedValue.loop != id)
+            {
+                continue;
+            }
+
+            // The block starts at the point given by the enclosing loops, and spans the points visited by the loops inside
+            const auto& value = values[cachedValue.valueIndex];
+            const auto& layout = value.GetLayout();
+            const auto numValueDimensions = static_cast<int>(cachedValue.dimensions.size());
+            std::vector<Scalar> origin;
+            std::vector<int> extent;
+            std::vector<int> valueSizes;
+            std::vector<bool> checkBounds;
+            for (int valueDimension = 0; valueDimension < numValueDimensions; ++valueDimension)
+            {
+                const auto dimension = cachedValue.dimensions[valueDimension];
+                std::vector<Scalar> originTerms;
+                int blockExtent = 1;
+                for (int loopPosition = 0; loopPosition < static_cast<int>(_order.size()); ++loopPosition)
+                {
+                    const auto loopId = _order[loopPosition];
+                    const auto& loop = _loops[loopId];
+                    if (loop.dimension != dimension)
+                    {
+                        continue;
+                    }
+
+                    if (loopPosition <= position)
+                    {
+                        originTerms.push_back(loop.stride == 1 ? loopIndices[loopId] : loopIndices[loopId] * loop.stride);
+                    }
+                    else
+                    {
+                        blockExtent += (loop.size - 1) * loop.stride;
+                    }
+                }
+
+                const auto valueSize = layout.GetLogicalDimensionActiveSize(valueDimension);
+                origin.push_back(Sum(originTerms));
+                extent.push_back(std::min(blockExtent, valueSize));
+                valueSizes.push_back(valueSize);
+                checkBounds.push_back(GetCoveredSize(dimension) > valueSize);
+            }
+
+            const auto& order = layout.GetLogicalDimensionOrder();
+            std::vector<int> physicalExtent(numValueDimensions);
+            for (int physicalDimension = 0; physicalDimension < numValueDimensions; ++physicalDimension)
+            {
+                physicalExtent[physicalDimension] = extent[order[physicalDimension]];
+            }
+            MemoryLayout bufferLayout(MemoryShape{ physicalExtent }, order);
+            Value buffer = Allocate(value.GetBaseType(), bufferLayout);
+
+            GetContext().For(bufferLayout, [&](std::vector<Scalar> coordinates) {
+                std::vector<Scalar> sourceCoordinates;
+                for (int valueDimension = 0; valueDimension < numValueDimensions; ++valueDimension)
+                {
+                    sourceCoordinates.push_back(origin[valueDimension] + coordinates[valueDimension]);
+                }
+
+                IfInBounds(sourceCoordinates, valueSizes, checkBounds, 0, [&] {
+                    Scalar destination = GetElement(buffer, coordinates);
+                    destination = GetElement(value, sourceCoordinates);
+                });
+            });
+
+            // The view of the buffer is shifted back by the origin of the block, so the kernel indexes it like the value
+            std::vector<Scalar> bufferOrigin;
+            for (const auto& coordinate : origin)
+            {
+                bufferOrigin.push_back(coordinate * -1);
+            }
+            Value view = GetContext().Offset(buffer, bufferOrigin);
+            view.SetLayout(bufferLayout);
+
+            std::vector<Value> cachedValues;
+            for (int valueIndex = 0; valueIndex < static_cast<int>(values.size()); ++valueIndex)
+            {
+                cachedValues.push_back(valueIndex == cachedValue.valueIndex ? view : values[valueIndex]);
+            }
+            values = std::move(cachedValues);
+        }
+
+        return values;
+    }
+
+    std::vector<Scalar> LoopNest::GetDimensionIndices(const std::vector<Scalar>& loopIndices) const
+    {
+        const auto numDimensions = static_cast<int>(_sizes.size());
+        std::vector<std::vector<Scalar>> terms(numDimensions);
+        for (auto id : _order)
+        {
+            const auto& loop = _loops[id];
+            terms[loop.dimension].push_back(loop.stride == 1 ? loopIndices[id] : loopIndices[id] * loop.stride);
+        }
+
+        std::vector<Scalar> indices;
+        for (const auto& dimensionTerms : terms)
+        {
+            indices.push_back(Sum(dimensionTerms));
+        }
+        return indices;
+    }
+
+    std::vector<int> LoopNest::GetBlockLoops(int id) const
+    {
+        std::vector<int> blockLoops;
+        for (int other = 0; other < static_cast<int>(_loops.size()); ++other)
+        {
+            auto ancestor = other;
+            while (ancestor != -1 && ancestor != id)
+            {
+                ancestor = _loops[ancestor].parent;
+            }
+
+            if (ancestor == id)
+            {
+                blockLoops.push_back(other);
+            }
+        }
+        return blockLoops;
+    }
+
+    int LoopNest::GetCoveredSize(int dimension) const
+    {
+        int size = 1;
+        for (const auto& loop : _loops)
+        {
+            if (loop.dimension == dimension)
+            {
+                size += (loop.size - 1) * loop.stride;
+            }
+        }
+        return size;
+    }
+
+    const LoopNest::Loop& LoopNest::GetLoop(LoopIndex loop) const
+    {
+        if (loop.id < 0 || loop.id >= static_cast<int>(_loops.size()))
+        {
+            throw InputException(InputExceptionErrors::indexOutOfRange, "Loop doesn't belong to this loop nest");
+        }
+
+        return _loops[loop.id];
+    }
+
+    LoopNest::Loop& LoopNest::GetLoop(LoopIndex loop)
+    {
+        return const_cast<Loop&>(static_cast<const LoopNest&>(*this).GetLoop(loop));
+    }
+
+} // namespace value
+} // namespace ell
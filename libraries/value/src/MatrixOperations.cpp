@@ -8,8 +8,13 @@
 
 #include "MatrixOperations.h"
 #include "EmitterContext.h"
+#include "LoopNest.h"
 #include "Matrix.h"
 #include "Scalar.h"
+#include "Vector.h"
+#include "VectorOperations.h"
+
+#include <algorithm>
 
 namespace ell
 {
@@ -19,7 +24,7 @@ namespace value
 {
     Scalar Accumulate(Matrix matrix, Scalar initialValue)
     {
-        Scalar result = initialValue;
+        Scalar result = initialValue.Copy();
 
         For(matrix, [&](auto row, auto column) {
             result += matrix(row, column);
@@ -42,9 +47,85 @@ namespace value
         });
     }
 
-    Matrix GEMM(Matrix m1, Matrix m2) { throw LogicException(LogicExceptionErrors::notImplemented); }
+    Matrix GEMM(Matrix m1, Matrix m2)
+    {
+        Matrix result = Allocate(m1.Type(), MemoryLayout({ static_cast<int>(m1.Rows()), static_cast<int>(m2.Columns()) }));
+        GEMM(m1, m2, result);
+        return result;
+    }
+
+    void GEMM(Matrix m1, Matrix m2, Matrix result)
+    {
+        if (m1.Columns() != m2.Rows() || m1.Rows() != result.Rows() || m2.Columns() != result.Columns())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch);
+        }
+        if (m1.Type() != m2.Type() || m1.Type() != result.Type())
+        {
+            throw InputException(InputExceptionErrors::typeMismatch);
+        }
+
+        For(result, [&](Scalar row, Scalar column) { result(row, column) = Cast(0, result.Type()); });
+
+        const auto M = static_cast<int>(m1.Rows());
+        const auto N = static_cast<int>(m2.Columns());
+        const auto K = static_cast<int>(m1.Columns());
+
+        // Each block of columns of the result is computed from a panel of m2 that's copied into a buffer small enough to
+        // stay in cache while all of the rows are swept, and the columns within a block are emitted as vector operations
+        LoopNest nest({ M, N, K });
+        nest.Using({ m1.GetValue(), m2.GetValue(), result.GetValue() });
+        auto i = nest.GetDimensionLoop(0);
+        auto j = nest.GetDimensionLoop(1);
+        auto k = nest.GetDimensionLoop(2);
+        auto jInner = nest.Split(j, std::min(N, 8));
+        auto kInner = nest.Split(k, std::min(K, 128));
+        nest.Reorder({ j, k, i, kInner, jInner });
+        nest.Cache(1, { 2, 1 }, k);
+        nest.Vectorize(jInner);
+        nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+            Matrix A = values[0], B = values[1], C = values[2];
+            C(indices[0], indices[1]) += A(indices[0], indices[2]) * B(indices[2], indices[1]);
+        });
+    }
 
-    Vector GEMV(Matrix m, Vector v) { throw LogicException(LogicExceptionErrors::notImplemented); }
+    Vector GEMV(Matrix m, Vector v)
+    {
+        Vector result = Allocate(m.Type(), MemoryLayout({ static_cast<int>(m.Rows()) }));
+        GEMV(m, v, result);
+        return result;
+    }
+
+    void GEMV(Matrix m, Vector v, Vector result)
+    {
+        if (m.Columns() != v.Size() || m.Rows() != result.Size())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch);
+        }
+        if (m.Type() != v.GetType() || m.Type() != result.GetType())
+        {
+            throw InputException(InputExceptionErrors::typeMismatch);
+        }
+
+        For(result, [&](Scalar index) { result(index) = Cast(0, result.GetType()); });
+
+        const auto M = static_cast<int>(m.Rows());
+        const auto N = static_cast<int>(m.Columns());
+
+        // Several rows are accumulated at once, so each element of the vector is loaded once per block of rows
+        LoopNest nest({ M, N });
+        nest.Using({ m.GetValue(), v.GetValue(), result.GetValue() });
+        auto i = nest.GetDimensionLoop(0);
+        auto k = nest.GetDimensionLoop(1);
+        auto iInner = nest.Split(i, std::min(M, 4));
+        nest.Reorder({ i, k, iInner });
+        nest.Unroll(iInner);
+        nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+            Matrix A = values[0];
+            Vector x = values[1], y = values[2];
+            y(indices[0]) += A(indices[0], indices[1]) * x(indices[1]);
+        });
+    }
 
     Matrix operator+(Matrix m1, Matrix m2)
     {
@@ -19,7 +19,7 @@ namespace value
 {
     Scalar Accumulate(Tensor tensor, Scalar initialValue)
     {
-        Scalar result = initialValue;
+        Scalar result = initialValue.Copy();
 
         For(tensor, [&](auto row, auto column, auto channel) {
             result += tensor(row, column, channel);
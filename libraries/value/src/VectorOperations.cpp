@@ -24,7 +24,7 @@ namespace value
 {
     Scalar Accumulate(Vector input, Scalar initalValue)
     {
-        Scalar result = initalValue;
+        Scalar result = initalValue.Copy();
 
         For(input, [&](auto index) { result += input(index); });
 
@@ -130,7 +130,8 @@ namespace value
         }
         else
         {
-            Scalar result;
+            Scalar result = Allocate(v1.GetType(), ScalarLayout);
+            result = Cast(0, v1.GetType());
             For(v1, [&](auto index) { result += v1[index] * v2[index]; });
 
             return result;
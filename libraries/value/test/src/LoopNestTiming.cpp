@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LoopNestTiming.cpp (value_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LoopNestTiming.h"
+
+#include <value/include/EmitterContext.h>
+#include <value/include/FunctionDeclaration.h>
+#include <value/include/LLVMContext.h>
+#include <value/include/LoopNest.h>
+#include <value/include/Matrix.h>
+#include <value/include/Vector.h>
+
+#include <emitters/include/CompilerOptions.h>
+#include <emitters/include/IRExecutionEngine.h>
+#include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IROptimizer.h>
+#include <emitters/include/IRRuntime.h>
+
+#include <utilities/include/MillisecondTimer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+using namespace ell::utilities;
+using namespace ell::value;
+
+namespace
+{
+const int CblasRowMajor = 101;
+const int CblasNoTrans = 111;
+
+// Minimum time, in milliseconds, to spend running each configuration
+const int minimumTime = 250;
+
+using GEMMFunction = void(const float* A, const float* B, float* C);
+using GEMVFunction = void(const float* A, const float* x, float* y);
+
+std::vector<float> GetRandomData(size_t size)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> data(size);
+    std::generate(data.begin(), data.end(), [&engine, &distribution]() { return distribution(engine); });
+    return data;
+}
+
+// Runs the function until `minimumTime` has passed, and returns the rate at which it did floating-point operations
+double GetGFlops(double flopsPerCall, std::function<void()> fn)
+{
+    // Warm up
+    fn();
+
+    int numIterations = 0;
+    MillisecondTimer timer;
+    while (timer.Elapsed() < minimumTime)
+    {
+        fn();
+        ++numIterations;
+    }
+    auto seconds = timer.Elapsed() / 1000.0;
+    return (flopsPerCall * numIterations) / (seconds * 1.0e9);
+}
+
+bool IsEqual(const std::vector<float>& a, const std::vector<float>& b)
+{
+    const float tolerance = 1.0e-3f;
+    return std::equal(a.begin(), a.end(), b.begin(), [tolerance](float x, float y) {
+        return std::abs(x - y) <= tolerance * std::max(1.0f, std::abs(x));
+    });
+}
+
+// Optimizes the module, and compiles it. The functions emitted through the value library aren't public, so they are
+// exposed first to keep the optimizer from removing them
+std::unique_ptr<IRExecutionEngine> Compile(IRModuleEmitter& module, const std::vector<std::string>& functionNames)
+{
+    for (const auto& name : functionNames)
+    {
+        module.GetLLVMModule()->getFunction(name)->setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+
+    IROptimizer optimizer(module);
+    optimizer.AddStandardPasses();
+    module.Optimize(optimizer);
+    return std::make_unique<IRExecutionEngine>(std::move(module));
+}
+
+// The same schedule as `value::GEMM`, with the blocks of columns split among tasks
+void ParallelGEMM(Matrix A, Matrix B, Matrix C, int numTasks)
+{
+    For(C, [&](Scalar row, Scalar column) { C(row, column) = Cast(0, C.Type()); });
+
+    const auto M = static_cast<int>(A.Rows());
+    const auto N = static_cast<int>(B.Columns());
+    const auto K = static_cast<int>(A.Columns());
+
+    LoopNest nest({ M, N, K });
+    nest.Using({ A.GetValue(), B.GetValue(), C.GetValue() });
+    auto i = nest.GetDimensionLoop(0);
+    auto j = nest.GetDimensionLoop(1);
+    auto k = nest.GetDimensionLoop(2);
+    auto jInner = nest.Split(j, std::min(N, 8));
+    auto kInner = nest.Split(k, std::min(K, 128));
+    nest.Reorder({ j, k, i, kInner, jInner });
+    nest.Cache(1, { 2, 1 }, k);
+    nest.Vectorize(jInner);
+    nest.Parallelize(j, numTasks);
+    nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+        Matrix A = values[0], B = values[1], C = values[2];
+        C(indices[0], indices[1]) += A(indices[0], indices[2]) * B(indices[2], indices[1]);
+    });
+}
+} // namespace
+
+void TimeGEMM()
+{
+    const int numTasks = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "Single-precision GEMM, GFLOP/s" << std::endl;
+    std::cout << std::setw(6) << "size" << std::setw(10) << "naive" << std::setw(11) << "scheduled" << std::setw(10) << "parallel" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int size : { 64, 128, 256, 512 })
+    {
+        CompilerOptions options;
+        options.parallelize = true;
+        IRModuleEmitter module("GEMMTiming", options);
+        std::string naiveName = module.GetRuntime().GetGEMMFunction<float>(false)->getName();
+        std::string scheduledName;
+        std::string parallelName;
+        {
+            LLVMContext context(module);
+            ContextGuard guard(context);
+
+            MemoryLayout layout({ size, size });
+            auto scheduled = DeclareFunction("ScheduledGEMM")
+                                 .Parameters(Value(ValueType::Float, layout), Value(ValueType::Float, layout), Value(ValueType::Float, layout));
+            scheduled.Define([](Matrix A, Matrix B, Matrix C) { GEMM(A, B, C); });
+            scheduledName = scheduled.GetFunctionName();
+
+            auto parallel = DeclareFunction("ParallelGEMM")
+                                .Parameters(Value(ValueType::Float, layout), Value(ValueType::Float, layout), Value(ValueType::Float, layout));
+            parallel.Define([numTasks](Matrix A, Matrix B, Matrix C) { ParallelGEMM(A, B, C, numTasks); });
+            parallelName = parallel.GetFunctionName();
+        }
+
+        auto engine = Compile(module, { naiveName, scheduledName, parallelName });
+        auto naiveGEMM = engine->GetFunction<int(int, int, int, int, int, int, float, const float*, int, const float*, int, float, float*, int)>(naiveName);
+        auto scheduledGEMM = engine->GetFunction<GEMMFunction>(scheduledName);
+        auto parallelGEMM = engine->GetFunction<GEMMFunction>(parallelName);
+
+        auto A = GetRandomData(size * size);
+        auto B = GetRandomData(size * size);
+        std::vector<float> naiveC(size * size), scheduledC(size * size), parallelC(size * size);
+        auto flops = 2.0 * size * size * size;
+
+        std::cout << std::setw(6) << size;
+        std::cout << std::setw(10) << GetGFlops(flops, [&] {
+            naiveGEMM(CblasRowMajor, CblasNoTrans, CblasNoTrans, size, size, size, 1.0f, A.data(), size, B.data(), size, 0.0f, naiveC.data(), size);
+        });
+        std::cout << std::setw(11) << GetGFlops(flops, [&] { scheduledGEMM(A.data(), B.data(), scheduledC.data()); });
+        std::cout << std::setw(10) << GetGFlops(flops, [&] { parallelGEMM(A.data(), B.data(), parallelC.data()); });
+        if (!IsEqual(naiveC, scheduledC) || !IsEqual(naiveC, parallelC))
+        {
+            std::cout << "  (results differ)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void TimeGEMV()
+{
+    std::cout << "Single-precision GEMV, GFLOP/s" << std::endl;
+    std::cout << std::setw(6) << "size" << std::setw(10) << "naive" << std::setw(11) << "scheduled" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int size : { 256, 512, 1024, 2048 })
+    {
+        IRModuleEmitter module("GEMVTiming", CompilerOptions{});
+        std::string naiveName = module.GetRuntime().GetGEMVFunction<float>(false)->getName();
+        std::string scheduledName;
+        {
+            LLVMContext context(module);
+            ContextGuard guard(context);
+
+            auto scheduled = DeclareFunction("ScheduledGEMV")
+                                 .Parameters(Value(ValueType::Float, MemoryLayout({ size, size })),
+                                             Value(ValueType::Float, MemoryLayout({ size })),
+                                             Value(ValueType::Float, MemoryLayout({ size })));
+            scheduled.Define([](Matrix A, Vector x, Vector y) { GEMV(A, x, y); });
+            scheduledName = scheduled.GetFunctionName();
+        }
+
+        auto engine = Compile(module, { naiveName, scheduledName });
+        auto naiveGEMV = engine->GetFunction<int(int, int, int, int, float, const float*, int, const float*, int, float, float*, int)>(naiveName);
+        auto scheduledGEMV = engine->GetFunction<GEMVFunction>(scheduledName);
+
+        auto A = GetRandomData(size * size);
+        auto x = GetRandomData(size);
+        std::vector<float> naiveY(size), scheduledY(size);
+        auto flops = 2.0 * size * size;
+
+        std::cout << std::setw(6) << size;
+        std::cout << std::setw(10) << GetGFlops(flops, [&] {
+            naiveGEMV(CblasRowMajor, CblasNoTrans, size, size, 1.0f, A.data(), size, x.data(), 1, 0.0f, naiveY.data(), 1);
+        });
+        std::cout << std::setw(11) << GetGFlops(flops, [&] { scheduledGEMV(A.data(), x.data(), scheduledY.data()); });
+        if (!IsEqual(naiveY, scheduledY))
+        {
+            std::cout << "  (results differ)";
+        }
+        std::cout << std::endl;
+    }
+}
@@ -11,11 +11,13 @@
 #include <value/include/ComputeContext.h>
 #include <value/include/FunctionDeclaration.h>
 #include <value/include/LLVMContext.h>
+#include <value/include/LoopNest.h>
 #include <value/include/Matrix.h>
 #include <value/include/Tensor.h>
 #include <value/include/Value.h>
 #include <value/include/Vector.h>
 
+#include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRModuleEmitter.h>
 
 #include <math/include/Matrix.h>
@@ -32,6 +34,8 @@
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <string>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -1025,6 +1029,201 @@ void Dot_test()
     InvokeForContext<ComputeContext>([&](auto&) { fn(); });
 }
 
+namespace
+{
+    std::vector<std::vector<float>> MakeReferenceMatrix(int rows, int columns, int seed)
+    {
+        std::vector<std::vector<float>> matrix(rows, std::vector<float>(columns));
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                matrix[row][column] = static_cast<float>((row * seed + column * 3) % 11) - 5;
+            }
+        }
+        return matrix;
+    }
+} // namespace
+
+void GEMM_test()
+{
+    auto fn = DeclareFunction("GEMM_test").Define([]() -> void {
+        bool ok = true;
+        // Sizes that do and don't divide the blocks used by the schedule
+        for (auto [M, N, K] : std::vector<std::tuple<int, int, int>>{ { 1, 1, 1 }, { 3, 5, 7 }, { 4, 16, 128 }, { 5, 19, 131 } })
+        {
+            auto reference1 = MakeReferenceMatrix(M, K, 7);
+            auto reference2 = MakeReferenceMatrix(K, N, 5);
+            std::vector<std::vector<float>> expected(M, std::vector<float>(N));
+            for (int i = 0; i < M; ++i)
+            {
+                for (int j = 0; j < N; ++j)
+                {
+                    for (int k = 0; k < K; ++k)
+                    {
+                        expected[i][j] += reference1[i][k] * reference2[k][j];
+                    }
+                }
+            }
+
+            Matrix m1(reference1), m2(reference2), expectedMatrix(expected);
+            Matrix result = GEMM(m1, m2);
+            For(result, [&](Scalar row, Scalar column) {
+                If(result(row, column) != expectedMatrix(row, column),
+                   [&] { InvokeForContext<ComputeContext>([&](auto&) { ok = false; }); });
+            });
+        }
+        testing::ProcessTest("GEMM test", ok);
+    });
+
+    InvokeForContext<ComputeContext>([&](auto&) { fn(); });
+}
+
+void GEMV_test()
+{
+    auto fn = DeclareFunction("GEMV_test").Define([]() -> void {
+        bool ok = true;
+        for (auto [M, N] : std::vector<std::pair<int, int>>{ { 1, 1 }, { 4, 8 }, { 7, 13 } })
+        {
+            auto referenceMatrix = MakeReferenceMatrix(M, N, 7);
+            std::vector<float> referenceVector(N);
+            std::iota(referenceVector.begin(), referenceVector.end(), -2.f);
+            std::vector<float> expected(M);
+            for (int i = 0; i < M; ++i)
+            {
+                expected[i] = std::inner_product(referenceMatrix[i].begin(), referenceMatrix[i].end(), referenceVector.begin(), 0.f);
+            }
+
+            Matrix m(referenceMatrix);
+            Vector v(referenceVector), expectedVector(expected);
+            Vector result = GEMV(m, v);
+            For(result, [&](Scalar index) {
+                If(result(index) != expectedVector(index),
+                   [&] { InvokeForContext<ComputeContext>([&](auto&) { ok = false; }); });
+            });
+        }
+        testing::ProcessTest("GEMV test", ok);
+    });
+
+    InvokeForContext<ComputeContext>([&](auto&) { fn(); });
+}
+
+void LoopNest_test1()
+{
+    auto fn = DeclareFunction("LoopNest_test1").Define([]() -> void {
+        const int rows = 5, columns = 7;
+        std::vector<std::vector<int>> reference(rows, std::vector<int>(columns));
+        for (int row = 0; row < rows; ++row)
+        {
+            std::iota(reference[row].begin(), reference[row].end(), row * columns);
+        }
+
+        Matrix input(reference);
+        Matrix output = MakeMatrix<int>(rows, columns);
+
+        // Splits that don't divide the dimensions, a parallel outer loop, and a cached block of the input
+        LoopNest nest({ rows, columns });
+        nest.Using({ input.GetValue(), output.GetValue() });
+        auto row = nest.GetDimensionLoop(0);
+        auto column = nest.GetDimensionLoop(1);
+        auto columnInner = nest.Split(column, 3);
+        auto rowInner = nest.Split(row, 2);
+        nest.Reorder({ column, row, rowInner, columnInner });
+        nest.Parallelize(column, 2);
+        nest.Cache(0, { 0, 1 }, row);
+        nest.Unroll(columnInner);
+        nest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+            Matrix input = values[0], output = values[1];
+            output(indices[0], indices[1]) += input(indices[0], indices[1]) + 1;
+        });
+
+        bool ok = true;
+        For(output, [&](Scalar row, Scalar column) {
+            If(output(row, column) != input(row, column) + 1,
+               [&] { InvokeForContext<ComputeContext>([&](auto&) { ok = false; }); });
+        });
+        testing::ProcessTest("LoopNest test 1", ok);
+
+        // A split of an inner loop that doesn't divide it must stay within the block of the outer loop
+        Vector counts = MakeVector<int>(10);
+        LoopNest splitNest({ 10 });
+        splitNest.Using({ counts.GetValue() });
+        auto index = splitNest.GetDimensionLoop(0);
+        auto indexInner = splitNest.Split(index, 5);
+        splitNest.Split(indexInner, 2);
+        splitNest.Run([](std::vector<Value> values, std::vector<Scalar> indices) {
+            Vector counts = values[0];
+            counts(indices[0]) += 1;
+        });
+
+        bool splitOk = true;
+        For(counts, [&](Scalar index) {
+            If(counts(index) != 1,
+               [&] { InvokeForContext<ComputeContext>([&](auto&) { splitOk = false; }); });
+        });
+        testing::ProcessTest("LoopNest test 1 (uneven split of an inner loop)", splitOk);
+    });
+
+    InvokeForContext<ComputeContext>([&](auto&) { fn(); });
+}
+
+namespace
+{
+    // Adds a number computed from the coordinates to each element, so an element that is visited twice, or not at all,
+    // ends up with a different value than the one ComputeContext computes
+    void ForTestBody(Matrix data, int unrollFactor)
+    {
+        GetContext().For(
+            data.GetValue().GetLayout(),
+            [&](std::vector<Scalar> coordinates) {
+                data(coordinates[0], coordinates[1]) += coordinates[0] * 100 + coordinates[1] + 1;
+            },
+            unrollFactor);
+    }
+} // namespace
+
+void For_test1()
+{
+    // A 5x7 matrix stored column-major with padding, so the loops run over the dimensions in the opposite order and skip
+    // the padding. Unroll factors that don't divide the 5 rows of the innermost loop, or exceed them, leave iterations over.
+    MemoryLayout layout(MemoryShape{ 7, 5 }, MemoryShape{ 1, 2 }, DimensionOrder{ 1, 0 });
+    const auto memorySize = static_cast<size_t>(layout.GetMemorySize());
+    for (int unrollFactor : { 1, 2, 3, 8 })
+    {
+        std::vector<int> expected(memorySize);
+        {
+            ComputeContext context("For_test1");
+            ContextGuard guard(context);
+            Matrix data(Allocate(ValueType::Int32, layout));
+            ForTestBody(data, unrollFactor);
+            auto result = data.GetValue().Get<int*>();
+            expected.assign(result, result + memorySize);
+        }
+
+        std::vector<int> actual(memorySize);
+        {
+            IRModuleEmitter module("For_test1", CompilerOptions{});
+            std::string functionName;
+            {
+                LLVMContext context(module);
+                ContextGuard guard(context);
+                auto fn = DeclareFunction("For_test1_unroll" + std::to_string(unrollFactor))
+                              .Parameters(Value(ValueType::Int32, layout));
+                fn.Define([unrollFactor](Matrix data) { ForTestBody(data, unrollFactor); });
+                functionName = fn.GetFunctionName();
+            }
+
+            // The functions emitted through the value library aren't public, so the function is exposed to look it up
+            module.GetLLVMModule()->getFunction(functionName)->setLinkage(llvm::GlobalValue::ExternalLinkage);
+            IRExecutionEngine engine(std::move(module));
+            auto compiledFunction = engine.GetFunction<void(int*)>(functionName);
+            compiledFunction(actual.data());
+        }
+
+        testing::ProcessTest("For test 1 (LLVMContext matches ComputeContext, unroll factor " + std::to_string(unrollFactor) + ")", expected == actual);
+    }
+}
+
 namespace
 {
     const std::vector<float> intrinsics_data{ 0.1f, 1.2f, 2.3f, 3.4f, 4.5f, 5.6f, 6.7f, 7.8f, 8.9f, 9.10f };
@@ -40,9 +40,15 @@ int main()
             Casting_test1();
             Accumulate_test();
             Dot_test();
+            GEMM_test();
+            GEMV_test();
+            LoopNest_test1();
             Intrinsics_test1();
             Intrinsics_test2();
         }
+
+        // Runs code compiled by LLVMContext, so it sets up its own contexts
+        For_test1();
     }
     catch (const Exception& exception)
     {
@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (value_timing)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LoopNestTiming.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Unused.h>
+
+#include <iostream>
+
+using namespace ell;
+
+/// Runs all timings
+///
+int main(int argc, char** argv)
+{
+    UNUSED(argc);
+    UNUSED(argv);
+    try
+    {
+        TimeGEMM();
+        TimeGEMV();
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "ERROR, got ELL exception. Message: " << exception.GetMessage() << std::endl;
+        throw;
+    }
+
+    return 0;
+}
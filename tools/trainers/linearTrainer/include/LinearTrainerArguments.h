@@ -29,6 +29,7 @@ struct LinearTrainerArguments
     size_t maxEpochs;
     bool permute;
     std::string randomSeedString;
+    size_t numThreads;
 };
 
 /// <summary> Parsed version of LinearTrainerArguments. </summary>
@@ -55,5 +55,11 @@ void ParsedLinearTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
                      "seed",
                      "The random seed string",
                      "ABCDEFG");
+
+    parser.AddOption(numThreads,
+                     "numThreads",
+                     "nt",
+                     "The number of threads to train with, or 0 for one per hardware thread (SparseDataSGD, SparseDataCenteredSGD, and SDCA only)",
+                     1);
 }
 } // namespace ell
@@ -113,8 +113,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -132,9 +131,7 @@ int main(int argc, char* argv[])
             auto normalizer = predictors::MakeTransformationNormalizer<data::IterationPolicy::skipZeros>(coordinateTransformation);
 
             // apply normalizer to data
-            auto normalizedDataset = common::TransformDataset(mappedDataset, normalizer);
-
-            mappedDataset.Swap(normalizedDataset);
+            mappedDataset = common::TransformDataset(mappedDataset, normalizer);
         }
 
         // predictor type
@@ -145,20 +142,20 @@ int main(int argc, char* argv[])
         switch (linearTrainerArguments.algorithm)
         {
         case LinearTrainerArguments::Algorithm::SGD:
-            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads });
             break;
         case LinearTrainerArguments::Algorithm::SparseDataSGD:
-            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads });
             break;
         case LinearTrainerArguments::Algorithm::SparseDataCenteredSGD:
         {
             auto mean = trainers::CalculateMean(mappedDataset.GetAnyDataset());
-            trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads });
             break;
         }
         case LinearTrainerArguments::Algorithm::SDCA:
         {
-            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads });
             break;
         }
         default:
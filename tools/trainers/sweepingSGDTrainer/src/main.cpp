@@ -81,8 +81,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
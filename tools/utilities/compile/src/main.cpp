@@ -123,6 +123,11 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
     auto compiledMap = compiler.Compile(map);
     timer.Stop();
 
+    if (settings.sharePortMemory && compileArguments.verbose)
+    {
+        std::cout << compiler.GetPortMemoryReport() << std::endl;
+    }
+
     if (compileArguments.outputCompiledMap)
     {
         TimingOutputCollector timer(timingOutput, "Time to save compiled map", compileArguments.verbose);
@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HardwareCounters.h (profile)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ell
+{
+/// <summary>
+/// Opens the hardware performance counters (cycles, instructions, L1 data cache misses, last-level cache misses and branch
+/// misses) for the calling thread. Uses `perf_event_open`, so it only succeeds on Linux, and only if the kernel lets this
+/// process read its own counters (see `/proc/sys/kernel/perf_event_paranoid`). The counters are opened as one group, so
+/// they count over the same intervals and are read together. A counter the CPU doesn't have is left out of the group and
+/// reads as 0; `IsHardwareCounterAvailable` tells which ones those are.
+/// </summary>
+///
+/// <param name="error"> Set to the reason the counters couldn't be opened, if they couldn't. </param>
+///
+/// <returns> `true` if at least one counter was opened. </returns>
+bool OpenHardwareCounters(std::string& error);
+
+/// <summary> Closes the counters opened by `OpenHardwareCounters`. </summary>
+void CloseHardwareCounters();
+
+/// <summary> Returns whether a counter was opened by `OpenHardwareCounters`. </summary>
+///
+/// <param name="index"> The index of the counter, in the order of the fields of `HardwareCounters`. </param>
+///
+/// <returns>
+/// `true` if the counter was opened and has counted continuously since, `false` if the CPU or kernel doesn't provide it or
+/// the kernel took the group off the PMU.
+/// </returns>
+bool IsHardwareCounterAvailable(int index);
+
+/// <summary>
+/// Reads the current values of the hardware counters, in the order of the fields of `HardwareCounters`. This has the
+/// signature of the `<moduleName>_ReadHardwareCounters` function a model compiled with `profileHardwareCounters` calls.
+/// The whole group is read with a single syscall. The group is pinned to the PMU, so the values are exact counts and are
+/// never scaled. If the kernel couldn't keep the group on the PMU, the values read as 0 and `IsHardwareCounterAvailable`
+/// returns `false` for every counter from then on.
+/// </summary>
+///
+/// <param name="counters"> The array of 5 counter values to fill in. </param>
+void ReadHardwareCounters(int64_t* counters);
+} // namespace ell
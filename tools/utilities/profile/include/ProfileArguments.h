@@ -22,6 +22,7 @@ struct ProfileArguments
     std::string inputConverter;
     std::string outputFilename;
     std::string timingOutputFilename;
+    std::string traceOutputFilename;
     ProfileOutputFormat outputFormat = ProfileOutputFormat::text;
     std::string outputComment;
 
@@ -29,6 +30,8 @@ struct ProfileArguments
     int numBurnInIterations = 0;
     bool filterTrivialNodes = true;
     bool summaryOnly = false;
+    bool hardwareCounters = false;
+    MachinePeaks peaks;
 
     // TODO: something about regions
 };
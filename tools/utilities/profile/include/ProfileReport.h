@@ -15,13 +15,17 @@
 #include <model/include/IRModelProfiler.h>
 
 #include <emitters/include/IRProfiler.h>
+#include <emitters/include/IRTracer.h>
 
 using ELL_ProfileRegionInfo = ell::emitters::ProfileRegionInfo;
+using ELL_LatencyHistogram = ell::emitters::LatencyHistogram;
+using ELL_TraceEvent = ell::emitters::TraceEvent;
 using ELL_NodeInfo = ell::model::NodeInfo;
 using ELL_PerformanceCounters = ell::model::PerformanceCounters;
 
 #endif // COMPILED_ELL_PROFILER
 
+#include <cstdint>
 #include <iomanip>
 #include <ostream>
 #include <sstream>
@@ -37,9 +41,74 @@ enum class ProfileOutputFormat
     json
 };
 
+//
+// Summary of a latency histogram, in milliseconds
+//
+struct LatencyStatistics
+{
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+//
+// Hardware counter totals for a node or node type, and an estimate of the work it does in one run, for a roofline analysis
+//
+struct NodeHardwareStatistics
+{
+    bool hasCounters = false;
+
+    // Whether each counter could be opened. The value of one that couldn't is meaningless, and is reported as n/a.
+    bool hasCycles = false;
+    bool hasInstructions = false;
+    bool hasL1DataCacheMisses = false;
+    bool hasLastLevelCacheMisses = false;
+    bool hasBranchMisses = false;
+
+    int64_t cycles = 0;
+    int64_t instructions = 0;
+    int64_t l1DataCacheMisses = 0;
+    int64_t lastLevelCacheMisses = 0;
+    int64_t branchMisses = 0;
+
+    double flops = 0; // floating-point operations per run, or 0 if unknown
+    double bytes = 0; // bytes read and written per run, or 0 if unknown
+};
+
+//
+// The peak compute throughput and memory bandwidth of the machine, which place nodes on the roofline. 0 means unknown.
+//
+struct MachinePeaks
+{
+    double gflopsPerSecond = 0;
+    double gbytesPerSecond = 0;
+};
+
+//
+// The profiling information for a node or node type
+//
+struct NodeStatistics
+{
+    ELL_NodeInfo info;
+    ELL_PerformanceCounters counters;
+    LatencyStatistics latency;
+    NodeHardwareStatistics hardware = {};
+};
+
 std::string EncodeJSONString(const std::string& str);
 
+// Percentiles are reported as the top of the histogram bucket they fall into, which is within 25% of the actual value
+LatencyStatistics GetLatencyStatistics(const ELL_LatencyHistogram& histogram, double ticksPerMillisecond);
+
 void WriteUserComment(const std::string& comment, ProfileOutputFormat format, std::ostream& out);
-void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, ProfileOutputFormat format, std::ostream& out);
-void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeInfo, std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeTypeInfo, ProfileOutputFormat format, std::ostream& out);
-void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileOutputFormat format, std::ostream& out);
+void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, const LatencyStatistics& modelLatency, ProfileOutputFormat format, std::ostream& out);
+void WriteNodeStatistics(std::vector<NodeStatistics>& nodeInfo, std::vector<NodeStatistics>& nodeTypeInfo, ProfileOutputFormat format, std::ostream& out, const MachinePeaks& peaks = {});
+void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, double ticksPerMillisecond, ProfileOutputFormat format, std::ostream& out);
+
+#if !defined(COMPILED_ELL_PROFILER) || defined(ELL_TRACING)
+// Writes the events in a model's trace buffer in the Chrome trace-event format, for chrome://tracing or Perfetto.
+// `numEvents` counts all of the events recorded, so only the last `bufferSize` of them are still in the buffer.
+void WriteTraceEvents(const ELL_TraceEvent* events, int bufferSize, int64_t numEvents, double ticksPerMillisecond, std::ostream& out);
+#endif
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <random>
 #include <string>
@@ -25,6 +26,7 @@ struct ProfileArguments
     ProfileOutputFormat outputFormat;
     int numIterations;
     int numWarmUpIterations;
+    std::string traceOutputFilename; // blank or "<null>" for no trace
 };
 
 //
@@ -52,30 +54,34 @@ void WriteModelStatistics(ProfileOutputFormat format, std::ostream& out)
 {
     // get overall stats
     auto modelStats = ELL_GetModelPerformanceCounters();
-    WriteModelStatistics(modelStats, format, out);
+    auto modelLatency = GetLatencyStatistics(*ELL_GetModelLatencyHistogram(), ELL_GetProfilerTicksPerMillisecond());
+    WriteModelStatistics(modelStats, modelLatency, format, out);
 }
 
 void WriteNodeStatistics(ProfileOutputFormat format, std::ostream& out)
 {
     // Gather node statistics
-    std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>> nodeInfo;
+    auto ticksPerMillisecond = ELL_GetProfilerTicksPerMillisecond();
+    std::vector<NodeStatistics> nodeInfo;
     auto numNodes = ELL_GetNumNodes();
     for (int index = 0; index < numNodes; ++index)
     {
         auto info = ELL_GetNodeInfo(index);
         auto stats = ELL_GetNodePerformanceCounters(index);
-        nodeInfo.emplace_back(*info, *stats);
+        auto latency = GetLatencyStatistics(*ELL_GetNodeLatencyHistogram(index), ticksPerMillisecond);
+        nodeInfo.push_back({ *info, *stats, latency });
     }
 
-    std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>> nodeTypeInfo;
+    std::vector<NodeStatistics> nodeTypeInfo;
     auto numNodeTypes = ELL_GetNumNodeTypes();
     for (int index = 0; index < numNodeTypes; ++index)
     {
         auto info = ELL_GetNodeTypeInfo(index);
         auto stats = ELL_GetNodeTypePerformanceCounters(index);
-        nodeTypeInfo.emplace_back(*info, *stats);
+        auto latency = GetLatencyStatistics(*ELL_GetNodeTypeLatencyHistogram(index), ticksPerMillisecond);
+        nodeTypeInfo.push_back({ *info, *stats, latency });
     }
-    std::sort(nodeTypeInfo.begin(), nodeTypeInfo.end(), [](auto a, auto b) { return a.second.totalTime < b.second.totalTime; });
+    std::sort(nodeTypeInfo.begin(), nodeTypeInfo.end(), [](auto a, auto b) { return a.counters.totalTime < b.counters.totalTime; });
 
     WriteNodeStatistics(nodeInfo, nodeTypeInfo, format, out);
 }
@@ -93,7 +99,7 @@ void WriteRegionStatistics(ProfileOutputFormat format, std::ostream& out)
         regions.emplace_back(*info);
     }
 
-    WriteRegionStatistics(regions, format, out);
+    WriteRegionStatistics(regions, ELL_GetProfilerTicksPerMillisecond(), format, out);
 }
 
 //
@@ -138,6 +144,9 @@ void ProfileModel(const ProfileArguments& profileArguments)
 #endif
     }
     ResetProfilingInfo();
+#ifdef ELL_TRACING
+    ELL_ResetTrace();
+#endif
 
     // Now evaluate the model and record the profiling info
     for (int iter = 0; iter < profileArguments.numIterations; ++iter)
@@ -178,6 +187,16 @@ void ProfileModel(const ProfileArguments& profileArguments)
         WriteModelStatistics(format, profileOutputStream);
         profileOutputStream << "}\n";
     }
+
+#ifdef ELL_TRACING
+    const auto& traceOutputFilename = profileArguments.traceOutputFilename;
+    if (!traceOutputFilename.empty() && traceOutputFilename != "<null>")
+    {
+        std::ofstream traceOutputStream(traceOutputFilename);
+        WriteTraceEvents(ELL_GetTraceEvents(), ELL_GetTraceBufferSize(), ELL_GetNumTraceEvents(), ELL_GetProfilerTicksPerMillisecond(), traceOutputStream);
+        std::cout << "Wrote trace to " << traceOutputFilename << std::endl;
+    }
+#endif
 }
 
 int main(int argc, char* argv[])
@@ -185,15 +204,29 @@ int main(int argc, char* argv[])
     using InputType = float;
     using OutputType = float;
 
+    // Usage: profile [numIterations [numWarmUpIterations]] [--traceOutput <file>]
     int numIterations = 20;
     int numWarmUpIterations = 10;
-    if (argc > 1)
+    std::string traceOutputFilename = "trace.json";
+    std::vector<std::string> positionalArguments;
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::strcmp(argv[index], "--traceOutput") == 0 && index + 1 < argc)
+        {
+            traceOutputFilename = argv[++index];
+        }
+        else
+        {
+            positionalArguments.push_back(argv[index]);
+        }
+    }
+    if (positionalArguments.size() > 0)
     {
-        numIterations = atoi(argv[1]);
+        numIterations = atoi(positionalArguments[0].c_str());
     }
-    if (argc > 2)
+    if (positionalArguments.size() > 1)
     {
-        numWarmUpIterations = atoi(argv[2]);
+        numWarmUpIterations = atoi(positionalArguments[1].c_str());
     }
 
     std::cout << "Profiling model with " << numWarmUpIterations << " warm-up iterations and " << numIterations << " timed iterations" << std::endl;
@@ -202,6 +235,7 @@ int main(int argc, char* argv[])
     ProfileArguments profileArguments;
     profileArguments.numWarmUpIterations = numWarmUpIterations;
     profileArguments.numIterations = numIterations;
+    profileArguments.traceOutputFilename = traceOutputFilename;
     profileArguments.outputFormat = ProfileOutputFormat::text;
     ProfileModel<InputType, OutputType>(profileArguments);
 
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HardwareCounters.cpp (profile)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HardwareCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace ell
+{
+namespace
+{
+    const int numCounters = 5;
+
+#ifdef __linux__
+    // The counters are opened as one group, so they are scheduled onto the PMU together and read with one syscall.
+    // `groupIndices[index]` is the position of counter `index` in the group's read buffer, or -1 if it couldn't be opened.
+    int counterFds[numCounters] = { -1, -1, -1, -1, -1 };
+    int groupLeaderFd = -1;
+    int groupIndices[numCounters] = { -1, -1, -1, -1, -1 };
+    int numGroupCounters = 0;
+
+    // Set once a read finds that the group wasn't counting the whole time it was enabled. The readings are then incomplete,
+    // so all the counters are reported as unavailable rather than being estimated.
+    bool wasDescheduled = false;
+
+    // The layout `read` fills in for a group opened with PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+    struct GroupReadFormat
+    {
+        uint64_t numValues;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+        uint64_t values[numCounters];
+    };
+
+    int OpenCounter(uint32_t type, uint64_t config, int groupFd)
+    {
+        // The group leader is pinned, so the kernel never multiplexes the group with other events: either it is on the PMU
+        // whenever the thread runs, or it goes into an error state and reads fail. Scaling each cumulative reading by
+        // time_enabled / time_running would bias the per-node deltas, which are what the profiler reports.
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.pinned = groupFd == -1 ? 1 : 0;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Count the calling thread on whichever CPU it runs on
+        return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, groupFd, 0));
+    }
+#endif
+} // namespace
+
+#ifdef __linux__
+bool OpenHardwareCounters(std::string& error)
+{
+    CloseHardwareCounters();
+
+    // In the order of the fields of `HardwareCounters`
+    const uint64_t l1DataCacheReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const struct
+    {
+        uint32_t type;
+        uint64_t config;
+    } events[numCounters] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, l1DataCacheReadMiss },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    };
+
+    // The first counter that opens leads the group, and the rest join it. A counter the CPU doesn't have is left out.
+    int lastError = 0;
+    for (int index = 0; index < numCounters; ++index)
+    {
+        counterFds[index] = OpenCounter(events[index].type, events[index].config, groupLeaderFd);
+        if (counterFds[index] == -1)
+        {
+            lastError = errno;
+            continue;
+        }
+
+        if (groupLeaderFd == -1)
+        {
+            groupLeaderFd = counterFds[index];
+        }
+        groupIndices[index] = numGroupCounters++;
+    }
+
+    if (numGroupCounters == 0)
+    {
+        error = std::string("perf_event_open failed: ") + std::strerror(lastError);
+        if (lastError == EACCES || lastError == EPERM)
+        {
+            error += " (lower /proc/sys/kernel/perf_event_paranoid to 2 or less to allow it)";
+        }
+        return false;
+    }
+    return true;
+}
+
+void CloseHardwareCounters()
+{
+    for (int index = 0; index < numCounters; ++index)
+    {
+        if (counterFds[index] != -1)
+        {
+            close(counterFds[index]);
+            counterFds[index] = -1;
+        }
+        groupIndices[index] = -1;
+    }
+    groupLeaderFd = -1;
+    numGroupCounters = 0;
+    wasDescheduled = false;
+}
+
+bool IsHardwareCounterAvailable(int index)
+{
+    return index >= 0 && index < numCounters && groupIndices[index] != -1 && !wasDescheduled;
+}
+
+void ReadHardwareCounters(int64_t* counters)
+{
+    GroupReadFormat group = {};
+    auto expectedSize = static_cast<ssize_t>(sizeof(uint64_t) * (3 + numGroupCounters));
+    bool isValid = groupLeaderFd != -1 && read(groupLeaderFd, &group, sizeof(group)) == expectedSize;
+
+    // A pinned group that lost the PMU reads nothing. Otherwise it has counted for the whole time it was enabled.
+    if (groupLeaderFd != -1 && (!isValid || group.timeRunning == 0 || group.timeRunning < group.timeEnabled))
+    {
+        wasDescheduled = true;
+    }
+
+    for (int index = 0; index < numCounters; ++index)
+    {
+        auto groupIndex = groupIndices[index];
+        counters[index] = isValid && groupIndex != -1 ? static_cast<int64_t>(group.values[groupIndex]) : 0;
+    }
+}
+#else
+bool OpenHardwareCounters(std::string& error)
+{
+    error = "hardware counters are only supported on Linux";
+    return false;
+}
+
+void CloseHardwareCounters()
+{
+}
+
+bool IsHardwareCounterAvailable(int)
+{
+    return false;
+}
+
+void ReadHardwareCounters(int64_t* counters)
+{
+    for (int index = 0; index < numCounters; ++index)
+    {
+        counters[index] = 0;
+    }
+}
+#endif
+} // namespace ell
@@ -35,6 +35,14 @@ void ParsedProfileArguments::AddArgs(utilities::CommandLineParser& parser)
         "",
         "<cout>");
 
+    parser.AddOption(
+        traceOutputFilename,
+        "traceOutput",
+        "",
+        "File for a trace of the timed iterations in Chrome trace-event format, for chrome://tracing or Perfetto ('<cout>' for stdout, blank or '<null>' for no trace)",
+        "",
+        "<cout>");
+
     parser.AddOption(
         outputFormat,
         "format",
@@ -78,5 +86,26 @@ void ParsedProfileArguments::AddArgs(utilities::CommandLineParser& parser)
         "",
         "Print timing summary only",
         false);
+
+    parser.AddOption(
+        hardwareCounters,
+        "hardwareCounters",
+        "hw",
+        "Also count cycles, instructions, cache misses and branch misses for each node (Linux only)",
+        false);
+
+    parser.AddOption(
+        peaks.gflopsPerSecond,
+        "peakGFlops",
+        "",
+        "Peak compute throughput of the machine in GFLOP/s, to classify nodes as compute or memory bound (0 if unknown)",
+        0.0);
+
+    parser.AddOption(
+        peaks.gbytesPerSecond,
+        "peakBandwidth",
+        "",
+        "Peak memory bandwidth of the machine in GB/s, to classify nodes as compute or memory bound (0 if unknown)",
+        0.0);
 }
 } // namespace ell
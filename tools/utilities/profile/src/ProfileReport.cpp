@@ -9,6 +9,7 @@
 #include "ProfileReport.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iomanip>
 #include <ostream>
@@ -48,6 +49,167 @@ std::string EncodeJSONString(const std::string& str)
     return s.str();
 }
 
+namespace
+{
+// The buckets of a latency histogram hold the values t == b for b < 4. Above that, each power of two is split into 4
+// buckets, so bucket b starts at (4 + b % 4) << (b / 4 - 1).
+// This duplicates `emitters::GetLatencyHistogramBucketLowerBound` on purpose: this file is also copied into the compiled
+// profiler that `make_profiler` builds for a device, which links only the compiled model and not the ELL libraries.
+// Keep the two in sync.
+int64_t GetBucketLowerBound(int bucket)
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+    return static_cast<int64_t>(4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+void WriteLatencyStatistics(const LatencyStatistics& latency, ProfileOutputFormat format, const std::string& indent, std::ostream& out)
+{
+    if (format == ProfileOutputFormat::text)
+    {
+        out << "\tmin: " << latency.min << " ms\tp50: " << latency.p50 << " ms\tp90: " << latency.p90 << " ms\tp99: " << latency.p99 << " ms\tmax: " << latency.max << " ms";
+    }
+    else // json
+    {
+        out << indent << "\"latency\": {\n";
+        out << indent << "  \"min\": " << latency.min << ",\n";
+        out << indent << "  \"p50\": " << latency.p50 << ",\n";
+        out << indent << "  \"p90\": " << latency.p90 << ",\n";
+        out << indent << "  \"p99\": " << latency.p99 << ",\n";
+        out << indent << "  \"max\": " << latency.max << "\n";
+        out << indent << "}";
+    }
+}
+
+// Writes the hardware counters as IPC and misses per thousand instructions, and the roofline estimate as the node's
+// arithmetic intensity and achieved throughput. If the peaks are known, also says which roof bounds the node, and how
+// close to that roof it runs.
+void WriteHardwareStatistics(const NodeStatistics& stats, const MachinePeaks& peaks, ProfileOutputFormat format, const std::string& indent, std::ostream& out)
+{
+    const auto& hardware = stats.hardware;
+    // A derived value is n/a if one of the counters it comes from couldn't be opened
+    auto formatValue = [](bool isAvailable, auto value, const char* unavailable) {
+        std::ostringstream stream;
+        if (isAvailable)
+        {
+            stream << value;
+        }
+        else
+        {
+            stream << unavailable;
+        }
+        return stream.str();
+    };
+    auto perThousandInstructions = [&hardware](int64_t count) { return hardware.instructions > 0 ? 1000.0 * count / hardware.instructions : 0.0; };
+    auto ipc = hardware.cycles > 0 ? static_cast<double>(hardware.instructions) / hardware.cycles : 0.0;
+    bool hasIpc = hardware.hasCycles && hardware.hasInstructions;
+    bool hasL1DataCacheMpki = hardware.hasInstructions && hardware.hasL1DataCacheMisses;
+    bool hasLastLevelCacheMpki = hardware.hasInstructions && hardware.hasLastLevelCacheMisses;
+    bool hasBranchMpki = hardware.hasInstructions && hardware.hasBranchMisses;
+
+    auto secondsPerRun = stats.counters.count > 0 ? stats.counters.totalTime / stats.counters.count / 1000.0 : 0.0;
+    bool hasRoofline = hardware.flops > 0 && hardware.bytes > 0 && secondsPerRun > 0;
+    auto arithmeticIntensity = hasRoofline ? hardware.flops / hardware.bytes : 0.0;
+    auto gflopsPerSecond = hasRoofline ? hardware.flops / secondsPerRun / 1e9 : 0.0;
+    auto gbytesPerSecond = hasRoofline ? hardware.bytes / secondsPerRun / 1e9 : 0.0;
+
+    bool hasPeaks = hasRoofline && peaks.gflopsPerSecond > 0 && peaks.gbytesPerSecond > 0;
+    bool isMemoryBound = hasPeaks && arithmeticIntensity < peaks.gflopsPerSecond / peaks.gbytesPerSecond;
+    auto attainableGflopsPerSecond = hasPeaks ? std::min(peaks.gflopsPerSecond, arithmeticIntensity * peaks.gbytesPerSecond) : 0.0;
+    auto fractionOfRoofline = hasPeaks ? gflopsPerSecond / attainableGflopsPerSecond : 0.0;
+
+    if (format == ProfileOutputFormat::text)
+    {
+        if (hardware.hasCounters)
+        {
+            out << "\tIPC: " << formatValue(hasIpc, ipc, "n/a");
+            out << "\tL1D MPKI: " << formatValue(hasL1DataCacheMpki, perThousandInstructions(hardware.l1DataCacheMisses), "n/a");
+            out << "\tLLC MPKI: " << formatValue(hasLastLevelCacheMpki, perThousandInstructions(hardware.lastLevelCacheMisses), "n/a");
+            out << "\tbranch MPKI: " << formatValue(hasBranchMpki, perThousandInstructions(hardware.branchMisses), "n/a");
+        }
+        if (hasRoofline)
+        {
+            out << "\tFLOP/byte: " << arithmeticIntensity << "\tGFLOP/s: " << gflopsPerSecond << "\tGB/s: " << gbytesPerSecond;
+        }
+        if (hasPeaks)
+        {
+            out << "\t" << (isMemoryBound ? "memory" : "compute") << " bound: " << 100.0 * fractionOfRoofline << "% of roofline";
+        }
+    }
+    else // json
+    {
+        if (hardware.hasCounters)
+        {
+            out << ",\n";
+            out << indent << "\"hardware_counters\": {\n";
+            // Counters that couldn't be opened are written as null
+            out << indent << "  \"cycles\": " << formatValue(hardware.hasCycles, hardware.cycles, "null") << ",\n";
+            out << indent << "  \"instructions\": " << formatValue(hardware.hasInstructions, hardware.instructions, "null") << ",\n";
+            out << indent << "  \"l1_data_cache_misses\": " << formatValue(hardware.hasL1DataCacheMisses, hardware.l1DataCacheMisses, "null") << ",\n";
+            out << indent << "  \"last_level_cache_misses\": " << formatValue(hardware.hasLastLevelCacheMisses, hardware.lastLevelCacheMisses, "null") << ",\n";
+            out << indent << "  \"branch_misses\": " << formatValue(hardware.hasBranchMisses, hardware.branchMisses, "null") << ",\n";
+            out << indent << "  \"ipc\": " << formatValue(hasIpc, ipc, "null") << ",\n";
+            out << indent << "  \"l1_data_cache_mpki\": " << formatValue(hasL1DataCacheMpki, perThousandInstructions(hardware.l1DataCacheMisses), "null") << ",\n";
+            out << indent << "  \"last_level_cache_mpki\": " << formatValue(hasLastLevelCacheMpki, perThousandInstructions(hardware.lastLevelCacheMisses), "null") << ",\n";
+            out << indent << "  \"branch_mpki\": " << formatValue(hasBranchMpki, perThousandInstructions(hardware.branchMisses), "null") << "\n";
+            out << indent << "}";
+        }
+        if (hasRoofline)
+        {
+            out << ",\n";
+            out << indent << "\"roofline\": {\n";
+            out << indent << "  \"flops\": " << hardware.flops << ",\n";
+            out << indent << "  \"bytes\": " << hardware.bytes << ",\n";
+            out << indent << "  \"arithmetic_intensity\": " << arithmeticIntensity << ",\n";
+            out << indent << "  \"gflops_per_second\": " << gflopsPerSecond << ",\n";
+            out << indent << "  \"gbytes_per_second\": " << gbytesPerSecond;
+            if (hasPeaks)
+            {
+                out << ",\n";
+                out << indent << "  \"bound\": \"" << (isMemoryBound ? "memory" : "compute") << "\",\n";
+                out << indent << "  \"fraction_of_roofline\": " << fractionOfRoofline;
+            }
+            out << "\n";
+            out << indent << "}";
+        }
+    }
+}
+} // namespace
+
+LatencyStatistics GetLatencyStatistics(const ELL_LatencyHistogram& histogram, double ticksPerMillisecond)
+{
+    LatencyStatistics result = {};
+    if (histogram.count == 0)
+    {
+        return result;
+    }
+
+    const int numBuckets = static_cast<int>(sizeof(histogram.buckets) / sizeof(histogram.buckets[0]));
+    auto getPercentile = [&histogram, numBuckets](double percentile) {
+        auto rank = std::max(static_cast<int64_t>(1), static_cast<int64_t>(std::ceil(percentile * histogram.count)));
+        int64_t numSamples = 0;
+        for (int bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            numSamples += histogram.buckets[bucket];
+            if (numSamples >= rank)
+            {
+                auto upperBound = bucket + 1 < numBuckets ? GetBucketLowerBound(bucket + 1) - 1 : histogram.maxTicks;
+                return std::min(std::max(upperBound, histogram.minTicks), histogram.maxTicks);
+            }
+        }
+        return histogram.maxTicks;
+    };
+
+    result.min = histogram.minTicks / ticksPerMillisecond;
+    result.p50 = getPercentile(0.5) / ticksPerMillisecond;
+    result.p90 = getPercentile(0.9) / ticksPerMillisecond;
+    result.p99 = getPercentile(0.99) / ticksPerMillisecond;
+    result.max = histogram.maxTicks / ticksPerMillisecond;
+    return result;
+}
+
 void WriteUserComment(const std::string& comment, ProfileOutputFormat format, std::ostream& out)
 {
     if (format == ProfileOutputFormat::text)
@@ -60,7 +222,7 @@ void WriteUserComment(const std::string& comment, ProfileOutputFormat format, st
     }
 }
 
-void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, ProfileOutputFormat format, std::ostream& out)
+void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, const LatencyStatistics& modelLatency, ProfileOutputFormat format, std::ostream& out)
 {
     if (format == ProfileOutputFormat::text)
     {
@@ -73,7 +235,9 @@ void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, ProfileOutp
         double timePerRun = totalTime / count;
 
         out << "\nModel statistics" << std::endl;
-        out << "Total time: " << totalTime << " ms \tcount: " << count << "\t time per run: " << timePerRun << " ms" << std::endl;
+        out << "Total time: " << totalTime << " ms \tcount: " << count << "\t time per run: " << timePerRun << " ms";
+        WriteLatencyStatistics(modelLatency, format, "", out);
+        out << std::endl;
 
         out.flags(savedFlags);
     }
@@ -86,12 +250,14 @@ void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, ProfileOutp
         out << "\"model_statistics\": {\n";
         out << "  \"total_time\": " << totalTime << ",\n";
         out << "  \"average_time\": " << timePerRun << ",\n";
-        out << "  \"count\": " << count << "\n";
+        out << "  \"count\": " << count << ",\n";
+        WriteLatencyStatistics(modelLatency, format, "  ", out);
+        out << "\n";
         out << "}";
     }
 }
 
-void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeInfo, std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeTypeInfo, ProfileOutputFormat format, std::ostream& out)
+void WriteNodeStatistics(std::vector<NodeStatistics>& nodeInfo, std::vector<NodeStatistics>& nodeTypeInfo, ProfileOutputFormat format, std::ostream& out, const MachinePeaks& peaks)
 {
     // Write node statistics
     if (format == ProfileOutputFormat::text)
@@ -104,20 +270,26 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
         size_t maxTypeLength = 0;
         for (const auto& info : nodeTypeInfo)
         {
-            maxTypeLength = std::max(maxTypeLength, std::strlen((const char*)(info.first.nodeType)));
+            maxTypeLength = std::max(maxTypeLength, std::strlen((const char*)(info.info.nodeType)));
         }
 
         out << "Node statistics" << std::endl;
         for (const auto& info : nodeInfo)
         {
-            out << "Node[" << info.first.nodeName << "]:\t" << std::setw(maxTypeLength) << std::left << info.first.nodeType << "\ttime: " << info.second.totalTime << " ms\tcount: " << info.second.count << "\n";
+            out << "Node[" << info.info.nodeName << "]:\t" << std::setw(maxTypeLength) << std::left << info.info.nodeType << "\ttime: " << info.counters.totalTime << " ms\tcount: " << info.counters.count;
+            WriteLatencyStatistics(info.latency, format, "", out);
+            WriteHardwareStatistics(info, peaks, format, "", out);
+            out << "\n";
         }
 
         out << "\n\n";
         out << "Node type statistics" << std::endl;
         for (const auto& info : nodeTypeInfo)
         {
-            out << std::setw(maxTypeLength) << std::left << info.first.nodeType << "\ttime: " << info.second.totalTime << " ms \tcount: " << info.second.count << "\n";
+            out << std::setw(maxTypeLength) << std::left << info.info.nodeType << "\ttime: " << info.counters.totalTime << " ms \tcount: " << info.counters.count;
+            WriteLatencyStatistics(info.latency, format, "", out);
+            WriteHardwareStatistics(info, peaks, format, "", out);
+            out << "\n";
         }
 
         out.flags(savedFlags);
@@ -129,12 +301,15 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
         {
             out << "  {\n";
             out << "    \"name\": "
-                << "\"" << EncodeJSONString((const char*)(info.first.nodeName)) << "\",\n";
+                << "\"" << EncodeJSONString((const char*)(info.info.nodeName)) << "\",\n";
             out << "    \"type\": "
-                << "\"" << EncodeJSONString((const char*)(info.first.nodeType)) << "\",\n";
-            out << "    \"total_time\": " << info.second.totalTime << ",\n";
-            out << "    \"average_time\": " << info.second.totalTime / info.second.count << ",\n";
-            out << "    \"count\": " << info.second.count << "\n";
+                << "\"" << EncodeJSONString((const char*)(info.info.nodeType)) << "\",\n";
+            out << "    \"total_time\": " << info.counters.totalTime << ",\n";
+            out << "    \"average_time\": " << info.counters.totalTime / info.counters.count << ",\n";
+            out << "    \"count\": " << info.counters.count << ",\n";
+            WriteLatencyStatistics(info.latency, format, "    ", out);
+            WriteHardwareStatistics(info, peaks, format, "    ", out);
+            out << "\n";
             out << "  }";
             bool isLast = (&info == &nodeInfo.back());
             if (!isLast)
@@ -151,10 +326,13 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
         {
             out << "  {\n";
             out << "    \"type\": "
-                << "\"" << EncodeJSONString((const char*)(info.first.nodeType)) << "\",\n";
-            out << "    \"total_time\": " << info.second.totalTime << ",\n";
-            out << "    \"average_time\": " << info.second.totalTime / info.second.count << ",\n";
-            out << "    \"count\": " << info.second.count << "\n";
+                << "\"" << EncodeJSONString((const char*)(info.info.nodeType)) << "\",\n";
+            out << "    \"total_time\": " << info.counters.totalTime << ",\n";
+            out << "    \"average_time\": " << info.counters.totalTime / info.counters.count << ",\n";
+            out << "    \"count\": " << info.counters.count << ",\n";
+            WriteLatencyStatistics(info.latency, format, "    ", out);
+            WriteHardwareStatistics(info, peaks, format, "    ", out);
+            out << "\n";
             out << "  }";
             bool isLast = (&info == &nodeTypeInfo.back());
             if (!isLast)
@@ -167,7 +345,7 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
     }
 }
 
-void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileOutputFormat format, std::ostream& out)
+void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, double ticksPerMillisecond, ProfileOutputFormat format, std::ostream& out)
 {
     // Write region statistics
     auto numRegions = regions.size();
@@ -188,7 +366,9 @@ void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileO
             out << "\nRegion statistics" << std::endl;
             for (const auto& info : regions)
             {
-                out << "Region[" << info.name << "]:\t" << std::setw(maxNameLength) << std::left << "\ttime: " << info.totalTime << " ms\tcount: " << info.count << "\n";
+                out << "Region[" << info.name << "]:\t" << std::setw(maxNameLength) << std::left << "\ttime: " << info.totalTime << " ms\tcount: " << info.count;
+                WriteLatencyStatistics(GetLatencyStatistics(info.latency, ticksPerMillisecond), format, "", out);
+                out << "\n";
             }
 
             out << "\n\n";
@@ -205,7 +385,9 @@ void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileO
                 << "\"" << EncodeJSONString((const char*)(info.name)) << "\",\n";
             out << "    \"total_time\": " << info.totalTime << ",\n";
             out << "    \"average_time\": " << info.totalTime / info.count << ",\n";
-            out << "    \"count\": " << info.count << "\n";
+            out << "    \"count\": " << info.count << ",\n";
+            WriteLatencyStatistics(GetLatencyStatistics(info.latency, ticksPerMillisecond), format, "    ", out);
+            out << "\n";
             out << "  }";
             bool isLast = (&info == &regions.back());
             if (!isLast)
@@ -218,6 +400,59 @@ void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileO
     }
 }
 
+#if !defined(COMPILED_ELL_PROFILER) || defined(ELL_TRACING)
+void WriteTraceEvents(const ELL_TraceEvent* events, int bufferSize, int64_t numEvents, double ticksPerMillisecond, std::ostream& out)
+{
+    // Event i is stored at i % bufferSize, so copy out the ones that haven't been overwritten yet
+    std::vector<ELL_TraceEvent> trace;
+    for (auto index = std::max<int64_t>(0, numEvents - bufferSize); index < numEvents; ++index)
+    {
+        trace.push_back(events[index % bufferSize]);
+    }
+    std::sort(trace.begin(), trace.end(), [](const auto& a, const auto& b) { return a.beginTicks < b.beginTicks; });
+
+    // Timestamps are in microseconds from the first event, and threads are numbered in the order they first appear
+    const char* categoryNames[] = { "node", "task", "region" };
+    auto startTicks = trace.empty() ? 0 : trace.front().beginTicks;
+    auto ticksPerMicrosecond = ticksPerMillisecond / 1000.0;
+    std::vector<int64_t> threadIds;
+
+    auto savedFlags = out.flags();
+    auto savedPrecision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "\"displayTimeUnit\": \"ms\",\n";
+    out << "\"traceEvents\": [\n";
+    for (const auto& event : trace)
+    {
+        auto thread = std::find(threadIds.begin(), threadIds.end(), event.threadId);
+        if (thread == threadIds.end())
+        {
+            thread = threadIds.insert(threadIds.end(), event.threadId);
+        }
+        auto category = event.category >= 0 && event.category < 3 ? categoryNames[event.category] : "unknown";
+
+        out << "  {\"name\": \"" << EncodeJSONString((const char*)(event.name)) << "\", ";
+        out << "\"cat\": \"" << category << "\", ";
+        out << "\"ph\": \"X\", ";
+        out << "\"ts\": " << (event.beginTicks - startTicks) / ticksPerMicrosecond << ", ";
+        out << "\"dur\": " << (event.endTicks - event.beginTicks) / ticksPerMicrosecond << ", ";
+        out << "\"pid\": 0, ";
+        out << "\"tid\": " << (thread - threadIds.begin()) << "}";
+        bool isLast = (&event == &trace.back());
+        if (!isLast)
+        {
+            out << ",";
+        }
+        out << "\n";
+    }
+    out << "]\n";
+    out << "}\n";
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
+#endif
+
 void fun()
 {
     // this hack allows us to resolve printf which is used by compiled_model.o
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "HardwareCounters.h"
 #include "ProfileArguments.h"
 #include "ProfileReport.h"
 #include "ReplaceSourceAndSinkNodesPass.h"
@@ -33,8 +34,10 @@
 #include <utilities/include/TypeName.h>
 #include <utilities/include/Unused.h>
 
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <random>
 #include <string>
 #include <vector>
@@ -127,35 +130,155 @@ utilities::OutputStreamImpostor GetOutputStream(const std::string& filename)
     return { filename };
 }
 
+//
+// Roofline-related
+//
+size_t GetElementSize(model::Port::PortType type)
+{
+    switch (type)
+    {
+    case model::Port::PortType::smallReal:
+        return sizeof(model::ValueType<model::Port::PortType::smallReal>);
+    case model::Port::PortType::real:
+        return sizeof(model::ValueType<model::Port::PortType::real>);
+    case model::Port::PortType::integer:
+        return sizeof(model::ValueType<model::Port::PortType::integer>);
+    case model::Port::PortType::bigInt:
+        return sizeof(model::ValueType<model::Port::PortType::bigInt>);
+    case model::Port::PortType::boolean:
+        return sizeof(model::ValueType<model::Port::PortType::boolean>);
+    default:
+        return 0;
+    }
+}
+
+// Estimates the work a node does in one run from the shapes of its ports. The bytes are what the node reads from its
+// inputs and writes to its outputs, so they leave out weights the node holds itself. Matrix products and convolutions
+// count 2 FLOPs per multiply-add of the direct algorithm; every other node counts 1 FLOP per output element.
+NodeHardwareStatistics GetNodeWorkEstimate(const model::Node& node)
+{
+    NodeHardwareStatistics result;
+    double numOutputElements = 0;
+    for (auto port : node.GetInputPorts())
+    {
+        result.bytes += static_cast<double>(port->GetMemoryLayout().NumElements() * GetElementSize(port->GetType()));
+    }
+    for (auto port : node.GetOutputPorts())
+    {
+        auto numElements = port->GetMemoryLayout().NumElements();
+        result.bytes += static_cast<double>(numElements * GetElementSize(port->GetType()));
+        numOutputElements += numElements;
+    }
+
+    auto typeName = node.GetRuntimeTypeName();
+    auto filterWeights = node.GetInputPort("filterWeights");
+    if (typeName.find("MatrixMatrixMultiplyNode") == 0 || typeName.find("MatrixVectorMultiplyNode") == 0)
+    {
+        // An (m x k) by (k x n) product has m * k * n multiply-adds, which is the square root of the product of the 3 sizes
+        auto size1 = static_cast<double>(node.GetInputPort(0)->GetMemoryLayout().NumElements());
+        auto size2 = static_cast<double>(node.GetInputPort(1)->GetMemoryLayout().NumElements());
+        result.flops = 2 * std::sqrt(size1 * size2 * numOutputElements);
+    }
+    else if (typeName.find("DotProductNode") == 0)
+    {
+        result.flops = 2 * static_cast<double>(node.GetInputPort(0)->GetMemoryLayout().NumElements());
+    }
+    else if (filterWeights != nullptr && node.NumOutputPorts() == 1)
+    {
+        // Each output element of a convolution takes one filter's worth of multiply-adds, and the last output dimension is the filter
+        auto outputLayout = node.GetOutputPort(0)->GetMemoryLayout();
+        auto numFilters = outputLayout.GetActiveSize(outputLayout.NumDimensions() - 1);
+        auto filterSize = static_cast<double>(filterWeights->GetMemoryLayout().NumElements()) / std::max(numFilters, 1);
+        result.flops = 2 * numOutputElements * filterSize;
+    }
+    else
+    {
+        result.flops = numOutputElements;
+    }
+    return result;
+}
+
+// Gets the work estimates for the nodes of a compiled map, by node name, which is the node's id
+std::map<std::string, NodeHardwareStatistics> GetNodeWorkEstimates(model::IRCompiledMap& map)
+{
+    std::map<std::string, NodeHardwareStatistics> result;
+    map.GetModel().Visit([&result](const model::Node& node) {
+        result[to_string(node.GetId())] = GetNodeWorkEstimate(node);
+    });
+    return result;
+}
+
+void AddHardwareCounters(NodeHardwareStatistics& statistics, const model::HardwareCounters& counters)
+{
+    statistics.hasCounters = true;
+    statistics.hasCycles = IsHardwareCounterAvailable(0);
+    statistics.hasInstructions = IsHardwareCounterAvailable(1);
+    statistics.hasL1DataCacheMisses = IsHardwareCounterAvailable(2);
+    statistics.hasLastLevelCacheMisses = IsHardwareCounterAvailable(3);
+    statistics.hasBranchMisses = IsHardwareCounterAvailable(4);
+    statistics.cycles += counters.cycles;
+    statistics.instructions += counters.instructions;
+    statistics.l1DataCacheMisses += counters.l1DataCacheMisses;
+    statistics.lastLevelCacheMisses += counters.lastLevelCacheMisses;
+    statistics.branchMisses += counters.branchMisses;
+}
+
 void WriteModelStatistics(model::IRCompiledMap& map, ProfileOutputFormat format, std::ostream& out)
 {
     // get overall stats
     auto modelStats = map.GetModelPerformanceCounters();
-    WriteModelStatistics(modelStats, format, out);
+    auto modelLatency = GetLatencyStatistics(*map.GetModelLatencyHistogram(), map.GetProfilerTicksPerMillisecond());
+    WriteModelStatistics(modelStats, modelLatency, format, out);
 }
 
-void WriteNodeStatistics(model::IRCompiledMap& map, ProfileOutputFormat format, std::ostream& out)
+void WriteNodeStatistics(model::IRCompiledMap& map, bool hasHardwareCounters, const MachinePeaks& peaks, ProfileOutputFormat format, std::ostream& out)
 {
     // Gather node statistics
-    std::vector<std::pair<model::NodeInfo, model::PerformanceCounters>> nodeInfo;
+    auto ticksPerMillisecond = map.GetProfilerTicksPerMillisecond();
+    auto workEstimates = GetNodeWorkEstimates(map);
+    std::map<std::string, NodeHardwareStatistics> typeWorkEstimates; // the total work of the nodes of each type
+    std::map<std::string, int> typeNumNodes;
+    std::vector<NodeStatistics> nodeInfo;
     auto numNodes = map.GetNumProfiledNodes();
     for (int index = 0; index < numNodes; ++index)
     {
         auto info = map.GetNodeInfo(index);
         auto stats = map.GetNodePerformanceCounters(index);
-        nodeInfo.emplace_back(*info, *stats);
+        auto latency = GetLatencyStatistics(*map.GetNodeLatencyHistogram(index), ticksPerMillisecond);
+        auto hardware = workEstimates[info->nodeName];
+        if (hasHardwareCounters)
+        {
+            AddHardwareCounters(hardware, *map.GetNodeHardwareCounters(index));
+        }
+        nodeInfo.push_back({ *info, *stats, latency, hardware });
+
+        auto& typeWork = typeWorkEstimates[info->nodeType];
+        typeWork.flops += hardware.flops;
+        typeWork.bytes += hardware.bytes;
+        ++typeNumNodes[info->nodeType];
     }
 
-    std::vector<std::pair<model::NodeInfo, model::PerformanceCounters>> nodeTypeInfo;
+    std::vector<NodeStatistics> nodeTypeInfo;
     auto numNodeTypes = map.GetNumProfiledNodeTypes();
     for (int index = 0; index < numNodeTypes; ++index)
     {
         auto info = map.GetNodeTypeInfo(index);
         auto stats = map.GetNodeTypePerformanceCounters(index);
-        nodeTypeInfo.emplace_back(*info, *stats);
+        auto latency = GetLatencyStatistics(*map.GetNodeTypeLatencyHistogram(index), ticksPerMillisecond);
+
+        // The node type's counters count a run of each of its nodes, so its work is the average over its nodes
+        NodeHardwareStatistics hardware;
+        auto numNodesOfType = std::max(typeNumNodes[info->nodeType], 1);
+        hardware.flops = typeWorkEstimates[info->nodeType].flops / numNodesOfType;
+        hardware.bytes = typeWorkEstimates[info->nodeType].bytes / numNodesOfType;
+        if (hasHardwareCounters)
+        {
+            AddHardwareCounters(hardware, *map.GetNodeTypeHardwareCounters(index));
+        }
+        nodeTypeInfo.push_back({ *info, *stats, latency, hardware });
     }
-    std::sort(nodeTypeInfo.begin(), nodeTypeInfo.end(), [](auto a, auto b) { return a.second.totalTime < b.second.totalTime; });
-    WriteNodeStatistics(nodeInfo, nodeTypeInfo, format, out);
+    std::sort(nodeTypeInfo.begin(), nodeTypeInfo.end(), [](auto a, auto b) { return a.counters.totalTime < b.counters.totalTime; });
+    WriteNodeStatistics(nodeInfo, nodeTypeInfo, format, out, peaks);
 }
 
 void WriteRegionStatistics(model::IRCompiledMap& map, ProfileOutputFormat format, std::ostream& out)
@@ -168,7 +291,12 @@ void WriteRegionStatistics(model::IRCompiledMap& map, ProfileOutputFormat format
         auto info = map.GetRegionProfilingInfo(index);
         regions.emplace_back(*info);
     }
-    WriteRegionStatistics(regions, format, out);
+    WriteRegionStatistics(regions, map.GetProfilerTicksPerMillisecond(), format, out);
+}
+
+void WriteTrace(model::IRCompiledMap& map, std::ostream& out)
+{
+    WriteTraceEvents(map.GetTraceEvents(), map.GetTraceBufferSize(), map.GetNumTraceEvents(), map.GetProfilerTicksPerMillisecond(), out);
 }
 
 void WriteTimingDetail(std::ostream& timingOutputStream, ProfileOutputFormat format, const std::vector<std::vector<double>>& nodeTimings)
@@ -286,8 +414,10 @@ template <typename InputType, typename OutputType>
 void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, const common::MapCompilerArguments& mapCompilerArguments, const std::vector<std::string>& converterArgs)
 {
     const bool printTimingChart = profileArguments.timingOutputFilename != "";
+    const bool writeTrace = profileArguments.traceOutputFilename != "" && profileArguments.traceOutputFilename != "<null>";
     auto profileOutputStream = GetOutputStream(profileArguments.outputFilename);
     auto timingOutputStream = GetOutputStream(profileArguments.timingOutputFilename);
+    auto traceOutputStream = GetOutputStream(profileArguments.traceOutputFilename);
     const auto comment = profileArguments.outputComment;
 
     ReplaceSourceAndSinkNodes(map);
@@ -306,17 +436,44 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         return;
     }
 
+    // Open the hardware counters, falling back to timing only if they aren't available
+    bool profileHardwareCounters = false;
+    if (profileArguments.hardwareCounters)
+    {
+        std::string error;
+        profileHardwareCounters = OpenHardwareCounters(error);
+        if (!profileHardwareCounters)
+        {
+            std::cerr << "Hardware counters are unavailable, reporting timing only: " << error << std::endl;
+        }
+    }
+
     // Compile map
     model::MapCompilerOptions settings = mapCompilerArguments.GetMapCompilerOptions("");
     settings.profile = true;
+    settings.profileHardwareCounters = profileHardwareCounters;
     settings.compilerSettings.profile = true;
+    settings.compilerSettings.trace = writeTrace;
     settings.optimizerSettings.fuseLinearFunctionNodes = true;
     model::IRMapCompiler compiler(settings);
 
+    // Grab a pointer to the module before compiling transfers its ownership to the compiled map
+    llvm::Module* module = compiler.GetModule().GetLLVMModule();
+
     std::cout << "Compiling model" << std::endl;
     std::cout << "Preferred convolution method: " << static_cast<int>(settings.optimizerSettings.preferredConvolutionMethod) << std::endl;
     auto compiledMap = compiler.Compile(map);
 
+    if (profileHardwareCounters)
+    {
+        // The compiled model calls back into the profiler to read the counters at the start and end of each node
+        auto readCountersFunction = module->getFunction(settings.moduleName + "_ReadHardwareCounters");
+        if (readCountersFunction != nullptr)
+        {
+            compiledMap.GetJitter().DefineFunction(readCountersFunction, reinterpret_cast<uintptr_t>(&ReadHardwareCounters));
+        }
+    }
+
     auto numNodes = compiledMap.GetNumProfiledNodes();
     std::vector<std::vector<double>> nodeTimings(profileArguments.numIterations); // per-node timing
     for (auto& vec : nodeTimings)
@@ -326,6 +483,10 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
 
     // Warm up the system by evaluating the model some number of times
     WarmUpModel<InputType, OutputType>(compiledMap, input, profileArguments.numBurnInIterations, true);
+    if (writeTrace)
+    {
+        compiledMap.ResetTrace();
+    }
 
     // Now evaluate the model and record the profiling info
     for (int iter = 0; iter < profileArguments.numIterations; ++iter)
@@ -350,6 +511,11 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteTimingDetail(timingOutputStream, format, nodeTimings);
     }
 
+    if (writeTrace)
+    {
+        WriteTrace(compiledMap, traceOutputStream);
+    }
+
     // print profile info
     if (format == ProfileOutputFormat::text)
     {
@@ -357,7 +523,7 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         {
             WriteUserComment(comment, format, profileOutputStream);
         }
-        WriteNodeStatistics(compiledMap, format, profileOutputStream);
+        WriteNodeStatistics(compiledMap, profileHardwareCounters, profileArguments.peaks, format, profileOutputStream);
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         WriteModelStatistics(compiledMap, format, profileOutputStream);
     }
@@ -369,13 +535,18 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
             WriteUserComment(comment, format, profileOutputStream);
             profileOutputStream << ",\n";
         }
-        WriteNodeStatistics(compiledMap, format, profileOutputStream);
+        WriteNodeStatistics(compiledMap, profileHardwareCounters, profileArguments.peaks, format, profileOutputStream);
         profileOutputStream << ",\n";
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         profileOutputStream << ",\n";
         WriteModelStatistics(compiledMap, format, profileOutputStream);
         profileOutputStream << "}\n";
     }
+
+    if (profileHardwareCounters)
+    {
+        CloseHardwareCounters();
+    }
 }
 
 template <typename InputType>
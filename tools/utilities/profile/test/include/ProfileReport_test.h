@@ -0,0 +1,15 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ProfileReport_test.h (profile_test)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ell
+{
+void TestWriteTraceEventsEmpty();
+void TestWriteTraceEventsWrapAround();
+} // namespace ell
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ProfileReport_test.cpp (profile_test)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ProfileReport_test.h"
+#include "ProfileReport.h"
+
+#include <testing/include/testing.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+void TestWriteTraceEventsEmpty()
+{
+    std::ostringstream out;
+    WriteTraceEvents(nullptr, 4, 0, 1000.0, out);
+
+    std::string expected = "{\n"
+                           "\"displayTimeUnit\": \"ms\",\n"
+                           "\"traceEvents\": [\n"
+                           "]\n"
+                           "}\n";
+    testing::ProcessTest("Testing WriteTraceEvents with no events", testing::IsEqual(out.str(), expected));
+}
+
+void TestWriteTraceEventsWrapAround()
+{
+    // 6 events were recorded into a buffer of 4, so events 4 and 5 overwrote events 0 and 1. With 1000 ticks per
+    // millisecond, a tick is a microsecond.
+    const char* names[] = { "event0", "event1", "event2", "event3", "event4", "event5" };
+    const int bufferSize = 4;
+    const int numEvents = 6;
+    std::vector<ELL_TraceEvent> buffer(bufferSize);
+    for (int index = 0; index < numEvents; ++index)
+    {
+        int64_t threadId = index % 2 == 0 ? 77 : 99;
+        buffer[index % bufferSize] = { 1000 + 250 * index, 1000 + 250 * index + 100, threadId, names[index], index % 3 };
+    }
+
+    std::ostringstream out;
+    WriteTraceEvents(buffer.data(), bufferSize, numEvents, 1000.0, out);
+
+    // The surviving events are written oldest first, relative to the first of them, with threads numbered in the order
+    // they first appear
+    std::string expected = "{\n"
+                           "\"displayTimeUnit\": \"ms\",\n"
+                           "\"traceEvents\": [\n"
+                           "  {\"name\": \"event2\", \"cat\": \"region\", \"ph\": \"X\", \"ts\": 0.000, \"dur\": 100.000, \"pid\": 0, \"tid\": 0},\n"
+                           "  {\"name\": \"event3\", \"cat\": \"node\", \"ph\": \"X\", \"ts\": 250.000, \"dur\": 100.000, \"pid\": 0, \"tid\": 1},\n"
+                           "  {\"name\": \"event4\", \"cat\": \"task\", \"ph\": \"X\", \"ts\": 500.000, \"dur\": 100.000, \"pid\": 0, \"tid\": 0},\n"
+                           "  {\"name\": \"event5\", \"cat\": \"region\", \"ph\": \"X\", \"ts\": 750.000, \"dur\": 100.000, \"pid\": 0, \"tid\": 1}\n"
+                           "]\n"
+                           "}\n";
+    bool ok = testing::IsEqual(out.str(), expected);
+
+    // The stream's formatting is restored afterwards
+    out.str("");
+    out << 1.5;
+    ok &= testing::IsEqual(out.str(), std::string("1.5"));
+    testing::ProcessTest("Testing WriteTraceEvents after the buffer wraps around", ok);
+}
+} // namespace ell
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (profile_test)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ProfileReport_test.h"
+
+#include <testing/include/testing.h>
+
+#include <utilities/include/Exception.h>
+
+#include <iostream>
+
+using namespace ell;
+
+int main()
+{
+    try
+    {
+        TestWriteTraceEventsEmpty();
+        TestWriteTraceEventsWrapAround();
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "ERROR, got ELL exception. Message: " << exception.GetMessage() << std::endl;
+        throw;
+    }
+
+    if (testing::DidTestFail())
+    {
+        return 1;
+    }
+    return 0;
+}
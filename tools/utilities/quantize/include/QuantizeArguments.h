@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.h (quantize)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary> Command line arguments for the quantize executable. </summary>
+struct QuantizeArguments
+{
+    /// <summary> The number of examples used to calibrate activation ranges (0 for all of them). </summary>
+    size_t numCalibrationExamples = 0;
+
+    /// <summary> Print a log of the layers quantized. </summary>
+    bool verbose = false;
+};
+
+/// <summary> Parsed command line arguments for the quantize executable. </summary>
+struct ParsedQuantizeArguments : public QuantizeArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
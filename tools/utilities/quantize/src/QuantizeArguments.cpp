@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.cpp (quantize)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+namespace ell
+{
+void ParsedQuantizeArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        numCalibrationExamples,
+        "numCalibrationExamples",
+        "nce",
+        "Number of examples from the input data used to calibrate activation ranges (0 for all). All of them are used to measure accuracy.",
+        0);
+
+    parser.AddOption(
+        verbose,
+        "verbose",
+        "v",
+        "Print a log of the layers quantized",
+        false);
+}
+
+utilities::CommandLineParseResult ParsedQuantizeArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    return errors;
+}
+} // namespace ell
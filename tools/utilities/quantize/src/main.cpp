@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (quantize)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
+
+#include <data/include/DataVector.h>
+#include <data/include/Dataset.h>
+
+#include <common/include/DataLoadArguments.h>
+#include <common/include/DataLoaders.h>
+#include <common/include/LoadModel.h>
+#include <common/include/MapLoadArguments.h>
+#include <common/include/MapSaveArguments.h>
+
+#include <model/include/Map.h>
+#include <model/include/MapCompilerOptions.h>
+#include <model/include/ModelTransformer.h>
+
+#include <model/optimizer/include/ModelOptimizer.h>
+
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorMultiplyNode.h>
+
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/QuantizationPass.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+bool IsConvolutionalLayerNode(const model::Node& node)
+{
+    return dynamic_cast<const nodes::ConvolutionalLayerNode<float>*>(&node) != nullptr || dynamic_cast<const nodes::ConvolutionalLayerNode<double>*>(&node) != nullptr;
+}
+
+// Returns the number of bytes of weights in the quantized nodes of a model, before and after quantization
+template <typename ValueType>
+std::pair<size_t, size_t> GetQuantizedWeightSizes(const model::Model& model)
+{
+    size_t floatSize = 0;
+    size_t quantizedSize = 0;
+    auto addSizes = [&floatSize, &quantizedSize](const auto* node) {
+        floatSize += node->GetWeights().size() * sizeof(ValueType);
+        quantizedSize += node->GetWeights().size() * sizeof(int8_t) + node->GetWeightScales().size() * sizeof(ValueType);
+    };
+    for (auto node : model.GetNodesByType<nodes::QuantizedMatrixVectorMultiplyNode<ValueType>>())
+    {
+        addSizes(node);
+    }
+    for (auto node : model.GetNodesByType<nodes::QuantizedConvolutionNode<ValueType>>())
+    {
+        addSizes(node);
+    }
+    return { floatSize, quantizedSize };
+}
+
+// Returns the number of quantized nodes in a model
+template <typename ValueType>
+size_t GetNumQuantizedNodes(const model::Model& model)
+{
+    return model.GetNodesByType<nodes::QuantizedMatrixVectorMultiplyNode<ValueType>>().size() + model.GetNodesByType<nodes::QuantizedConvolutionNode<ValueType>>().size();
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        common::ParsedMapLoadArguments mapLoadArguments;
+        common::ParsedMapSaveArguments mapSaveArguments;
+        ParsedQuantizeArguments quantizeArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(mapLoadArguments);
+        commandLineParser.AddOptionSet(mapSaveArguments);
+        commandLineParser.AddOptionSet(quantizeArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        utilities::logging::ShouldLog() = quantizeArguments.verbose;
+
+        // load map, and refine it the way the compiler does before optimizing, so fully-connected layers become matrix-vector multiplies;
+        // convolutional layers are kept whole, since they are quantized as a unit
+        auto map = common::LoadMap(mapLoadArguments);
+        model::TransformContext context{ [](const model::Node& node) { return IsConvolutionalLayerNode(node) ? model::NodeAction::compile : model::NodeAction::abstain; } };
+        map.Refine(context);
+
+        // load data
+        auto dataset = common::GetDataset(dataLoadArguments);
+        if (dataset.NumExamples() == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, "No examples in " + dataLoadArguments.inputDataFilename);
+        }
+
+        // calibrate
+        auto numCalibrationExamples = quantizeArguments.numCalibrationExamples == 0 ? dataset.NumExamples() : std::min(quantizeArguments.numCalibrationExamples, dataset.NumExamples());
+        passes::QuantizationCalibrator calibrator;
+        for (size_t index = 0; index < numCalibrationExamples; ++index)
+        {
+            map.Compute<data::DoubleDataVector>(dataset.GetDataVector(index));
+            calibrator.Update(map);
+        }
+
+        // quantize
+        model::MapCompilerOptions settings;
+        model::ModelOptimizer optimizer(settings);
+        optimizer.AddPass(std::make_unique<passes::QuantizationPass>(calibrator.GetActivationRanges()));
+        model::Map quantizedMap(map);
+        quantizedMap.Optimize(optimizer);
+
+        // compare the quantized map's output with the original's
+        const auto outputSize = map.GetOutputSize();
+        double sumError = 0;
+        double maxError = 0;
+        size_t numAgreements = 0;
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            auto dataVector = dataset.GetDataVector(index);
+            auto referenceOutput = map.Compute<data::DoubleDataVector>(dataVector).ToArray(outputSize);
+            auto quantizedOutput = quantizedMap.Compute<data::DoubleDataVector>(dataVector).ToArray(outputSize);
+            for (size_t i = 0; i < outputSize; ++i)
+            {
+                auto error = std::abs(referenceOutput[i] - quantizedOutput[i]);
+                sumError += error;
+                maxError = std::max(maxError, error);
+            }
+            if (std::max_element(referenceOutput.begin(), referenceOutput.end()) - referenceOutput.begin() == std::max_element(quantizedOutput.begin(), quantizedOutput.end()) - quantizedOutput.begin())
+            {
+                ++numAgreements;
+            }
+        }
+
+        auto floatSizes = GetQuantizedWeightSizes<float>(quantizedMap.GetModel());
+        auto doubleSizes = GetQuantizedWeightSizes<double>(quantizedMap.GetModel());
+        auto numQuantizedNodes = GetNumQuantizedNodes<float>(quantizedMap.GetModel()) + GetNumQuantizedNodes<double>(quantizedMap.GetModel());
+        auto numExamples = static_cast<double>(dataset.NumExamples());
+
+        std::cout << "Calibrated on " << calibrator.NumExamples() << " examples, quantized " << numQuantizedNodes << " layers" << std::endl;
+        std::cout << "Quantized weights:\t" << floatSizes.first + doubleSizes.first << " -> " << floatSizes.second + doubleSizes.second << " bytes" << std::endl;
+        std::cout << "Mean absolute error:\t" << sumError / (numExamples * outputSize) << std::endl;
+        std::cout << "Max absolute error:\t" << maxError << std::endl;
+        std::cout << "Top-1 agreement:\t" << numAgreements / numExamples << std::endl;
+
+        // save the quantized map
+        if (mapSaveArguments.hasOutputStream)
+        {
+            common::SaveMap(quantizedMap, mapSaveArguments.outputMapStream);
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}